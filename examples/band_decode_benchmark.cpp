@@ -0,0 +1,278 @@
+/** @file   band_decode_benchmark.cpp
+ *  @brief  Compares the full frame and banded decoding of structured light
+ *          captures into a point cloud
+ *
+ *  Usage: band_decode_benchmark [band rows]
+ *
+ *  Gray code and three phase patterns are rendered onto a tilted plane seen
+ *  by a synthetic camera and saved as image files. Each sequence is decoded
+ *  with \ref dlp::StructuredLight::DecodeCaptureSequence() followed by
+ *  \ref dlp::Geometry::GeneratePointCloud(), and with
+ *  \ref dlp::StructuredLight::DecodeToPointCloud() streaming horizontal bands
+ *  of the files. The time, peak resident memory, and largest distance between
+ *  matching points of the two paths are reported. Horizontal subpixel Gray
+ *  code with stripes wider than the default band overlap checks that the
+ *  bands are decoded with both edges of every stripe.
+ *
+ *  The program returns 1 if a step fails or the clouds do NOT match.
+ */
+
+#include <dlp_sdk.hpp>
+
+#include "synthetic_scene.hpp"
+
+#include <math.h>
+#include <stdio.h>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#define FRAME_COLUMNS   2592
+#define FRAME_ROWS      1944
+#define FOCAL_LENGTH    2800.0
+
+#define CAMERA_BASELINE 150.0   // Camera is placed to the right of the projector (mm)
+#define PLANE_DISTANCE  800.0   // Distance from the projector to the plane along its optical axis (mm)
+#define MATCH_TOLERANCE 1.0e-6  // Largest distance between matching points (mm)
+
+/** @brief Returns the peak resident memory of the process in kB, 0 if unknown */
+unsigned long PeakResidentMemory(){
+    unsigned long peak = 0;
+#if defined(__linux__)
+    std::ifstream status("/proc/self/status");
+    std::string   line;
+    while(std::getline(status, line)){
+        if(line.compare(0, 6, "VmHWM:") == 0)
+            peak = dlp::String::ToNumber<unsigned long>(dlp::String::Trim(line.substr(6)));
+    }
+#endif
+    return peak;
+}
+
+/** @brief Resets the peak resident memory to the current usage if supported */
+void ResetPeakResidentMemory(){
+#if defined(__linux__)
+    std::ofstream clear_refs("/proc/self/clear_refs");
+    clear_refs << "5";
+#endif
+}
+
+/** @brief Renders the captures of every pattern projected onto the plane and
+ *         saves them as image files
+ *
+ *  Each frame is saved as soon as it is rendered so the captures are NOT
+ *  held in memory during the benchmark.
+ */
+void RenderCaptureFiles(const std::string &prefix, const synthetic_scene::Scene &scene,
+                        const dlp::Pattern::Sequence &patterns, dlp::Capture::Sequence *captures){
+    synthetic_scene::RayLookup lookup;
+    cv::RNG                    random(0x5EED);
+
+    synthetic_scene::TraceRays(scene, &lookup);
+
+    for(unsigned int iPattern = 0; iPattern < patterns.GetCount(); iPattern++){
+        dlp::Pattern pattern;
+        dlp::Image   image;
+        dlp::Capture capture;
+        cv::Mat      frame;
+
+        patterns.Get(iPattern, &pattern);
+        synthetic_scene::RenderFrame(scene, lookup, pattern, &random, &frame);
+        image.Create(frame);
+
+        capture.data_type  = dlp::Capture::DataType::IMAGE_FILE;
+        capture.image_file = prefix + dlp::Number::ToString(iPattern) + ".bmp";
+        image.Save(capture.image_file);
+        captures->Add(capture);
+    }
+}
+
+/** @brief Deletes the image files of a capture sequence */
+void RemoveCaptureFiles(const dlp::Capture::Sequence &captures){
+    for(unsigned int iCapture = 0; iCapture < captures.GetCount(); iCapture++){
+        dlp::Capture capture;
+        captures.Get(iCapture, &capture);
+        remove(capture.image_file.c_str());
+    }
+}
+
+/** @brief Times both paths for one module and prints the comparison
+ *  @retval false   A path failed or the clouds are empty or do NOT match
+ */
+bool Compare(const std::string &name, const std::string &prefix,
+             dlp::StructuredLight *module, const dlp::Parameters &settings, const unsigned int &band_rows,
+             const synthetic_scene::Scene &scene, dlp::Geometry *geometry, const unsigned int &viewport_id){
+    dlp::ReturnCode         ret;
+    dlp::Pattern::Sequence  patterns;
+    dlp::Capture::Sequence  captures;
+
+    ret = module->Setup(settings);
+    if(!ret.hasErrors()) ret = module->GeneratePatternSequence(&patterns);
+
+    if(ret.hasErrors()){
+        std::cout << name << ": could not generate the patterns: " << ret.ToString() << std::endl;
+        return false;
+    }
+
+    RenderCaptureFiles(prefix, scene, patterns, &captures);
+    patterns.Clear();
+
+    // Banded decoding runs first so that its peak is measured even if the
+    // peak can NOT be reset
+    dlp::Parameters band_settings = settings;
+    band_settings.Set(dlp::StructuredLight::Parameters::BandRows(band_rows));
+
+    dlp::Point::Cloud   band_cloud;
+    double              band_ms   = 0;
+    unsigned long       band_peak = 0;
+
+    ret = module->Setup(band_settings);
+    if(!ret.hasErrors()){
+        ResetPeakResidentMemory();
+        dlp::Time::Chronograph timer(true);
+        ret = module->DecodeToPointCloud(&captures, geometry, viewport_id, &band_cloud, nullptr);
+        band_ms   = (double) timer.Lap();
+        band_peak = PeakResidentMemory();
+    }
+
+    if(ret.hasErrors()){
+        std::cout << name << ": banded decoding failed: " << ret.ToString() << std::endl;
+        RemoveCaptureFiles(captures);
+        return false;
+    }
+
+    // Full frame decoding through the staged steps
+    dlp::Point::Cloud   frame_cloud;
+    double              frame_ms   = 0;
+    unsigned long       frame_peak = 0;
+
+    ret = module->Setup(settings);
+    if(!ret.hasErrors()){
+        ResetPeakResidentMemory();
+        dlp::Time::Chronograph timer(true);
+        dlp::DisparityMap disparity;
+        dlp::Image        depth;
+        ret = module->DecodeCaptureSequence(&captures, &disparity);
+        if(!ret.hasErrors()) ret = geometry->GeneratePointCloud(viewport_id, disparity, &frame_cloud, &depth);
+        frame_ms   = (double) timer.Lap();
+        frame_peak = PeakResidentMemory();
+    }
+
+    RemoveCaptureFiles(captures);
+
+    if(ret.hasErrors()){
+        std::cout << name << ": full frame decoding failed: " << ret.ToString() << std::endl;
+        return false;
+    }
+
+    // Compare the matching points of both clouds
+    double max_difference = 0;
+    bool   match          = (frame_cloud.GetCount() == band_cloud.GetCount());
+
+    for(unsigned long long iPoint = 0; match && (iPoint < frame_cloud.GetCount()); iPoint++){
+        dlp::Point frame;
+        dlp::Point band;
+        frame_cloud.Get(iPoint, &frame);
+        band_cloud.Get( iPoint, &band);
+
+        double difference = sqrt(((frame.x - band.x) * (frame.x - band.x)) +
+                                 ((frame.y - band.y) * (frame.y - band.y)) +
+                                 ((frame.z - band.z) * (frame.z - band.z)));
+        max_difference = std::max(max_difference, difference);
+    }
+    match = match && (frame_cloud.GetCount() > 0) && (max_difference <= MATCH_TOLERANCE);
+
+    std::cout << name
+              << ": points = "      << frame_cloud.GetCount() << " / " << band_cloud.GetCount()
+              << ", full frame = "  << frame_ms << " ms, peak " << (frame_peak / 1024) << " MB"
+              << ", banded = "      << band_ms  << " ms, peak " << (band_peak  / 1024) << " MB"
+              << ", max difference = " << max_difference << " mm"
+              << (match ? "" : " MISMATCH")
+              << std::endl;
+
+    return match;
+}
+
+int main(int argc, char *argv[])
+{
+    dlp::ReturnCode ret;
+    unsigned int    band_rows = 64;
+
+    if(argc > 1) band_rows = dlp::String::ToNumber<unsigned int>(argv[1]);
+    if(band_rows == 0) band_rows = 64;
+
+    // The projector and camera share the same resolution and focal length
+    synthetic_scene::Scene scene = synthetic_scene::TiltedPlane(FRAME_COLUMNS, FRAME_ROWS, FOCAL_LENGTH,
+                                                                FRAME_COLUMNS, FRAME_ROWS, FOCAL_LENGTH,
+                                                                CAMERA_BASELINE, PLANE_DISTANCE);
+
+    synthetic_scene::SaveCalibrations(scene, "band_benchmark_projector_calibration.xml",
+                                             "band_benchmark_camera_calibration.xml");
+
+    dlp::Calibration::Data projector_calibration;
+    dlp::Calibration::Data camera_calibration;
+    ret = projector_calibration.Load("band_benchmark_projector_calibration.xml");
+    if(!ret.hasErrors()) ret = camera_calibration.Load("band_benchmark_camera_calibration.xml");
+
+    // Both paths smooth the disparity, the bands overlap by the smoothing radius
+    dlp::Parameters geometry_settings;
+    dlp::Geometry   geometry;
+    unsigned int    viewport_id = 0;
+    geometry_settings.Set(dlp::Geometry::Parameters::SmoothDisparity(true));
+    geometry_settings.Set(dlp::Geometry::Parameters::GenerateOriginPlanesVertical(true));
+    geometry_settings.Set(dlp::Geometry::Parameters::GenerateOriginPlanesHorizontal(true));
+    geometry_settings.Set(dlp::Geometry::Parameters::GenerateOriginPlanesDiamondAngle1(false));
+    geometry_settings.Set(dlp::Geometry::Parameters::GenerateOriginPlanesDiamondAngle2(false));
+
+    if(!ret.hasErrors()) ret = geometry.Setup(geometry_settings);
+    if(!ret.hasErrors()) ret = geometry.SetOriginView(projector_calibration);
+    if(!ret.hasErrors()) ret = geometry.AddView(camera_calibration, &viewport_id);
+
+    if(ret.hasErrors()){
+        std::cout << "Could not set up the geometry: " << ret.ToString() << std::endl;
+        return 1;
+    }
+
+    dlp::Parameters settings;
+    settings.Set(dlp::StructuredLight::Parameters::PatternColor(dlp::Pattern::Color::WHITE));
+    settings.Set(dlp::StructuredLight::Parameters::PatternOrientation(dlp::Pattern::Orientation::VERTICAL));
+    settings.Set(dlp::StructuredLight::Parameters::PatternColumns(FRAME_COLUMNS));
+    settings.Set(dlp::StructuredLight::Parameters::PatternRows(FRAME_ROWS));
+
+    std::cout << "Decoding " << FRAME_COLUMNS << " x " << FRAME_ROWS
+              << " capture files in bands of " << band_rows << " rows..." << std::endl;
+
+    dlp::Parameters gray_code_settings = settings;
+    gray_code_settings.Set(dlp::GrayCode::Parameters::IncludeInverted(true));
+    gray_code_settings.Set(dlp::GrayCode::Parameters::SequenceCount(12));
+    gray_code_settings.Set(dlp::GrayCode::Parameters::PixelThreshold(5));
+
+    dlp::GrayCode gray_code;
+    bool passed = Compare("Gray code  ", "band_benchmark_gray_code_", &gray_code, gray_code_settings, band_rows,
+                          scene, &geometry, viewport_id);
+
+    // Horizontal subpixel Gray code with stripes of 32 pattern rows, twice
+    // the default band overlap
+    dlp::Parameters subpixel_settings = gray_code_settings;
+    subpixel_settings.Set(dlp::StructuredLight::Parameters::PatternOrientation(dlp::Pattern::Orientation::HORIZONTAL));
+    subpixel_settings.Set(dlp::GrayCode::Parameters::SequenceCount(6));
+    subpixel_settings.Set(dlp::GrayCode::Parameters::SubpixelSampling(16));
+
+    dlp::GrayCode gray_code_subpixel;
+    passed = Compare("Subpixel   ", "band_benchmark_subpixel_", &gray_code_subpixel, subpixel_settings, band_rows,
+                     scene, &geometry, viewport_id) && passed;
+
+    // Three phase with hybrid Gray code unwrapping
+    dlp::Parameters three_phase_settings = settings;
+    three_phase_settings.Set(dlp::ThreePhase::Parameters::Bitdepth(dlp::Pattern::Bitdepth::MONO_8BPP));
+    three_phase_settings.Set(dlp::ThreePhase::Parameters::PixelsPerPeriod(32));
+    three_phase_settings.Set(dlp::ThreePhase::Parameters::UseHybridUnwrap(true));
+
+    dlp::ThreePhase three_phase;
+    passed = Compare("Three phase", "band_benchmark_three_phase_", &three_phase, three_phase_settings, band_rows,
+                     scene, &geometry, viewport_id) && passed;
+
+    std::cout << (passed ? "PASS" : "FAIL") << ": full frame and banded point clouds match" << std::endl;
+
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,133 @@
+/** @file   buffer_pool_benchmark.cpp
+ *  @brief  Compares scan latency and frame allocations with and without a
+ *          dlp::BufferPool using the virtual projector and camera
+ *
+ *  Usage: buffer_pool_benchmark [scans] [camera_columns camera_rows]
+ *
+ *  The camera defaults to 2448 x 2048 (5 MP) to show the cost of allocating
+ *  every frame.
+ */
+
+#include <dlp_sdk.hpp>
+
+#include <iostream>
+#include <string>
+
+struct Result{
+    unsigned long long  frames;
+    unsigned long long  capture_ms;
+    unsigned long long  decode_ms;
+};
+
+Result RunScans(const unsigned long long &scans, const unsigned int &pattern_count,
+                dlp::Virtual_Projector *projector, dlp::Virtual_Cam *camera, dlp::GrayCode *gray_code){
+    Result result;
+    result.frames     = 0;
+    result.capture_ms = 0;
+    result.decode_ms  = 0;
+
+    dlp::Time::Chronograph timer(true);
+    for(unsigned long long iScan = 0; iScan < scans; iScan++){
+        dlp::Capture::Sequence  capture;
+        dlp::DisparityMap       disparity;
+
+        timer.Reset();
+        projector->StartPatternSequence(0, pattern_count, false);
+        camera->GetCaptureSequence(pattern_count, &capture);
+        result.capture_ms += timer.Lap();
+
+        gray_code->DecodeCaptureSequence(&capture, &disparity);
+        result.decode_ms  += timer.Lap();
+        result.frames     += capture.GetCount();
+
+        // Clearing the sequence returns every frame of the scan to the pool
+        capture.Clear();
+    }
+
+    return result;
+}
+
+void PrintResult(const std::string &name, const unsigned long long &scans, const Result &result,
+                 const unsigned long long &allocations){
+    std::cout << name
+              << ": capture = " << (double)result.capture_ms / scans << " ms/scan"
+              << ", decode = "  << (double)result.decode_ms  / scans << " ms/scan"
+              << ", frames = "  << result.frames
+              << ", frame allocations = " << allocations << std::endl;
+}
+
+int main(int argc, char *argv[])
+{
+    dlp::ReturnCode             ret;
+    dlp::Parameters             settings;
+    dlp::Virtual_Projector      projector;
+    dlp::Virtual_Cam            camera;
+    dlp::GrayCode               gray_code;
+    dlp::Pattern::Sequence      sequence;
+    dlp::BufferPool             pool;
+    unsigned long long          scans   = 10;
+    unsigned int                columns = 2448;
+    unsigned int                rows    = 2048;
+
+    if(argc > 1) scans   = dlp::String::ToNumber<unsigned long long>(argv[1]);
+    if(argc > 3){
+        columns = dlp::String::ToNumber<unsigned int>(argv[2]);
+        rows    = dlp::String::ToNumber<unsigned int>(argv[3]);
+    }
+    if(scans == 0) scans = 1;
+
+    // Connect the virtual projector with a short pattern period so the
+    // frame handling is not hidden by the exposure time
+    projector.Connect("0");
+    settings.Set(dlp::Virtual_Projector::Parameters::PatternPeriod_US(1000));
+    projector.Setup(settings);
+
+    camera.SetProjector(&projector);
+    camera.Connect("0");
+    settings.Clear();
+    settings.Set(dlp::Virtual_Cam::Parameters::Columns(columns));
+    settings.Set(dlp::Virtual_Cam::Parameters::Rows(rows));
+    camera.Setup(settings);
+    camera.Start();
+
+    // Generate and prepare the vertical Gray code patterns
+    settings.Clear();
+    settings.Set(dlp::StructuredLight::Parameters::PatternColor(dlp::Pattern::Color::WHITE));
+    settings.Set(dlp::StructuredLight::Parameters::PatternOrientation(dlp::Pattern::Orientation::VERTICAL));
+    settings.Set(dlp::GrayCode::Parameters::IncludeInverted(true));
+    settings.Set(dlp::GrayCode::Parameters::PixelThreshold(5));
+    settings.Set(dlp::GrayCode::Parameters::SequenceCount(10));
+
+    gray_code.SetDlpPlatform(projector);
+    ret = gray_code.Setup(settings);
+    if(!ret.hasErrors()) ret = gray_code.GeneratePatternSequence(&sequence);
+    if(!ret.hasErrors()) ret = projector.PreparePatternSequence(sequence);
+
+    if(ret.hasErrors()){
+        std::cout << "Could not prepare the patterns: " << ret.ToString() << std::endl;
+        return 0;
+    }
+
+    unsigned int pattern_count = sequence.GetCount();
+    std::cout << "Scanning " << scans << " times with " << pattern_count << " patterns at "
+              << columns << " x " << rows << "..." << std::endl;
+
+    // Every frame allocates its own memory
+    camera.SetBufferPool(nullptr);
+    Result unpooled = RunScans(scans, pattern_count, &projector, &camera, &gray_code);
+    PrintResult("Without pool", scans, unpooled, unpooled.frames);
+
+    // Frames reuse the memory of the previous scan
+    camera.SetBufferPool(&pool);
+    Result pooled = RunScans(scans, pattern_count, &projector, &camera, &gray_code);
+    dlp::BufferPool::Statistics statistics = pool.GetStatistics();
+    PrintResult("With pool   ", scans, pooled, statistics.misses);
+
+    std::cout << "Pool: hits = " << statistics.hits
+              << ", misses = "   << statistics.misses
+              << ", peak resident = " << statistics.peak_resident_bytes / (1024 * 1024) << " MiB"
+              << ", free = "     << statistics.free_bytes / (1024 * 1024) << " MiB" << std::endl;
+
+    camera.SetBufferPool(nullptr);
+    return 0;
+}
@@ -0,0 +1,183 @@
+/** @file   calibration_binary_format.cpp
+ *  @brief  Checks the binary calibration file format and compares its load
+ *          time with the XML format
+ *
+ *  Usage: calibration_binary_format [iterations]
+ *
+ *  A camera calibration is imported from XML, saved with the .dlpcal
+ *  extension, and loaded again. Every value must survive the round trip
+ *  exactly. Damaged copies of the binary file must be rejected with the
+ *  matching error and leave the loaded data untouched. The average load
+ *  time of both formats is reported.
+ */
+
+#include <dlp_sdk.hpp>
+
+#include "synthetic_scene.hpp"
+
+#include <stdio.h>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#define XML_FILENAME        "calibration_binary_format.xml"
+#define BINARY_FILENAME     "calibration_binary_format.dlpcal"
+#define DAMAGED_FILENAME    "calibration_binary_format_damaged.dlpcal"
+
+/** @brief Writes a camera calibration in the format read by \ref dlp::Calibration::Data::Load() */
+void SaveCalibrationXML(const std::string &filename){
+    cv::Mat intrinsic  = (cv::Mat_<double>(3,3) << 2412.718281828459, 0, 1295.314159265359,
+                                                    0, 2409.161803398875, 971.4142135623731,
+                                                    0, 0, 1);
+    cv::Mat distortion = (cv::Mat_<double>(5,1) << -0.1234567890123, 0.0987654321098, 1.5e-4, -2.5e-4, -0.0123456789);
+    cv::Mat extrinsic  = (cv::Mat_<double>(2,3) << 0.01, -0.1853479499956, 0.003,
+                                                    148.25, -1.125, 3.0625);
+
+    synthetic_scene::SaveCalibration(filename, true, 2592, 1944, intrinsic, distortion, extrinsic, 0.1729);
+}
+
+/** @brief Returns true if both objects contain exactly the same calibration */
+bool Equal(const dlp::Calibration::Data &first, const dlp::Calibration::Data &second){
+    cv::Mat intrinsic[2], extrinsic[2], distortion[2];
+    double  error[2];
+    unsigned int image_columns[2], image_rows[2], model_columns[2], model_rows[2];
+
+    if(first.GetData( &intrinsic[0], &extrinsic[0], &distortion[0], &error[0]).hasErrors()) return false;
+    if(second.GetData(&intrinsic[1], &extrinsic[1], &distortion[1], &error[1]).hasErrors()) return false;
+
+    first.GetImageResolution( &image_columns[0], &image_rows[0]);
+    second.GetImageResolution(&image_columns[1], &image_rows[1]);
+    first.GetModelResolution( &model_columns[0], &model_rows[0]);
+    second.GetModelResolution(&model_columns[1], &model_rows[1]);
+
+    return (first.isCamera() == second.isCamera()) &&
+           (error[0] == error[1]) &&
+           (image_columns[0] == image_columns[1]) && (image_rows[0] == image_rows[1]) &&
+           (model_columns[0] == model_columns[1]) && (model_rows[0] == model_rows[1]) &&
+           (cv::norm(intrinsic[0],  intrinsic[1],  cv::NORM_INF) == 0) &&
+           (cv::norm(extrinsic[0],  extrinsic[1],  cv::NORM_INF) == 0) &&
+           (cv::norm(distortion[0].reshape(1, 1), distortion[1].reshape(1, 1), cv::NORM_INF) == 0);
+}
+
+/** @brief Reads a whole file */
+std::vector<char> ReadFile(const std::string &filename){
+    std::ifstream file(filename.c_str(), std::ios::binary);
+    return std::vector<char>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+/** @brief Writes a whole file */
+void WriteFile(const std::string &filename, const std::vector<char> &content){
+    std::ofstream file(filename.c_str(), std::ios::binary | std::ios::trunc);
+    file.write(content.data(), content.size());
+}
+
+/** @brief Loads a damaged copy of the binary file and checks the error
+ *  @return true if the expected error was returned and the data was NOT modified
+ */
+bool CheckDamaged(const std::string &name, const std::vector<char> &content,
+                  const std::string &expected_error, const dlp::Calibration::Data &reference){
+    WriteFile(DAMAGED_FILENAME, content);
+
+    dlp::Calibration::Data data = reference;
+    dlp::ReturnCode ret = data.Load(DAMAGED_FILENAME);
+
+    bool passed = ret.ContainsError(expected_error) && Equal(data, reference);
+
+    std::cout << "  " << name << ": " << (ret.hasErrors() ? ret.GetErrors().front() : std::string("no error"))
+              << (passed ? "" : " FAILED") << std::endl;
+    return passed;
+}
+
+int main(int argc, char *argv[])
+{
+    dlp::ReturnCode ret;
+    unsigned int    iterations = 1000;
+    bool            passed     = true;
+
+    if(argc > 1) iterations = dlp::String::ToNumber<unsigned int>(argv[1]);
+    if(iterations == 0) iterations = 1;
+
+    // Import the XML calibration and convert it
+    SaveCalibrationXML(XML_FILENAME);
+
+    dlp::Calibration::Data xml_data;
+    dlp::Calibration::Data binary_data;
+
+    ret = xml_data.Load(XML_FILENAME);
+    if(!ret.hasErrors()) ret = xml_data.Save(BINARY_FILENAME);
+    if(!ret.hasErrors()) ret = binary_data.Load(BINARY_FILENAME);
+
+    if(ret.hasErrors()){
+        std::cout << "Round trip failed: " << ret.ToString() << std::endl;
+        return 0;
+    }
+
+    bool round_trip = Equal(xml_data, binary_data);
+    passed = passed && round_trip;
+    std::cout << "Round trip XML -> binary -> memory: " << (round_trip ? "identical" : "MISMATCH") << std::endl;
+
+    // Damaged copies of the binary file
+    std::vector<char> content = ReadFile(BINARY_FILENAME);
+    std::cout << "Damaged files (" << content.size() << " bytes):" << std::endl;
+
+    std::vector<char> damaged = content;
+    damaged[40] ^= 0x01;
+    passed = CheckDamaged("flipped payload bit", damaged, CALIBRATION_DATA_FILE_CHECKSUM_INVALID, binary_data) && passed;
+
+    damaged = content;
+    damaged.back() ^= 0x80;
+    passed = CheckDamaged("flipped checksum bit", damaged, CALIBRATION_DATA_FILE_CHECKSUM_INVALID, binary_data) && passed;
+
+    damaged = content;
+    damaged.resize(content.size() / 2);
+    passed = CheckDamaged("partial write", damaged, CALIBRATION_DATA_FILE_TRUNCATED, binary_data) && passed;
+
+    // The largest payload size must NOT wrap the size check around
+    damaged = content;
+    for(unsigned int iByte = 12; iByte < 16; iByte++) damaged[iByte] = (char) 0xFF;
+    passed = CheckDamaged("huge payload size", damaged, CALIBRATION_DATA_FILE_TRUNCATED, binary_data) && passed;
+
+    damaged = content;
+    damaged[0] = 'X';
+    passed = CheckDamaged("wrong identifier", damaged, CALIBRATION_DATA_FILE_INVALID, binary_data) && passed;
+
+    damaged = content;
+    damaged[8] = 2;
+    passed = CheckDamaged("newer version", damaged, CALIBRATION_DATA_FILE_VERSION_INVALID, binary_data) && passed;
+
+    damaged.clear();
+    passed = CheckDamaged("empty file", damaged, CALIBRATION_DATA_FILE_LOAD_FAILED, binary_data) && passed;
+
+    // A failed save must NOT leave a file behind
+    ret = binary_data.Save("missing_directory/calibration.dlpcal");
+    bool failed_save = ret.ContainsError(CALIBRATION_DATA_FILE_SAVE_FAILED) &&
+                       ReadFile("missing_directory/calibration.dlpcal.partial").empty();
+    passed = passed && failed_save;
+    std::cout << "Save to a missing directory: " << (ret.hasErrors() ? ret.GetErrors().front() : std::string("no error"))
+              << (failed_save ? "" : " FAILED") << std::endl;
+
+    // Load time of both formats
+    dlp::Calibration::Data data;
+    double xml_ms    = 0;
+    double binary_ms = 0;
+
+    dlp::Time::Chronograph timer(true);
+    for(unsigned int iRun = 0; iRun < iterations; iRun++) data.Load(XML_FILENAME);
+    xml_ms = (double) timer.Lap();
+
+    for(unsigned int iRun = 0; iRun < iterations; iRun++) data.Load(BINARY_FILENAME);
+    binary_ms = (double) timer.Lap();
+
+    std::cout << "Average load time of " << iterations << " runs: XML = " << (1000.0 * xml_ms / iterations)
+              << " us (" << ReadFile(XML_FILENAME).size() << " bytes), binary = " << (1000.0 * binary_ms / iterations)
+              << " us (" << content.size() << " bytes), speedup = " << ((binary_ms > 0) ? xml_ms / binary_ms : 0.0)
+              << "x" << std::endl;
+
+    remove(DAMAGED_FILENAME);
+
+    std::cout << (passed ? "All checks passed" : "Some checks FAILED") << std::endl;
+
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,245 @@
+/** @file   calibration_board_detection.cpp
+ *  @brief  Compares finding calibration boards one image at a time with the
+ *          concurrent batch methods and reports the time spent on each image
+ *
+ *  Usage: calibration_board_detection [boards]
+ *
+ *  Chessboards are rendered at random poses through a pinhole camera with a
+ *  known focal length. The images are wider than 1024 pixels, so the batch
+ *  method searches a downscaled copy first while the single image method
+ *  searches at full resolution. Both modules must find every board and
+ *  calibrate to the known focal length and principal point.
+ */
+
+#include <dlp_sdk.hpp>
+
+#include <math.h>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#define FRAME_COLUMNS   2048
+#define FRAME_ROWS      1536
+
+#define FOCAL_LENGTH    2200.0
+#define CENTER_X        1030.6
+#define CENTER_Y        761.4
+
+#define FEATURE_COLUMNS 9
+#define FEATURE_ROWS    6
+#define SQUARE_SIZE     20.0    // mm
+
+#define NOISE_SIGMA     2.0     // Sensor noise in gray levels
+
+#define MAX_RMS_ERROR       0.2     // px
+#define MAX_FOCAL_ERROR     0.005   // Fraction of the focal length
+#define MAX_CENTER_ERROR    5.0     // px
+
+unsigned int failures = 0;
+
+void Check(const std::string &name, const bool &passed, const dlp::ReturnCode &ret){
+    std::cout << (passed ? "PASS: " : "FAIL: ") << name << std::endl;
+    if(!passed){
+        if(ret.hasErrors()) std::cout << "      " << ret.ToString() << std::endl;
+        failures++;
+    }
+}
+
+/** @brief Renders a chessboard matching \ref dlp::Calibration::Camera::GenerateCalibrationBoard()
+ *
+ *  The board lies in its own x-y plane with the first feature at the origin
+ *  and is moved into the camera frame by the rotation and translation. Each
+ *  pixel averages 2x2 samples.
+ */
+dlp::Image RenderBoard(const cv::Mat &rotation, const cv::Mat &translation, std::mt19937 *generator){
+    std::normal_distribution<double> noise(0.0, NOISE_SIGMA);
+
+    const double *r = rotation.ptr<double>(0);
+    const double *t = translation.ptr<double>(0);
+
+    // Board plane normal and distance in the camera frame
+    double normal[3] = {r[2], r[5], r[8]};
+    double distance  = (normal[0] * t[0]) + (normal[1] * t[1]) + (normal[2] * t[2]);
+
+    cv::Mat frame(FRAME_ROWS, FRAME_COLUMNS, CV_8UC1);
+
+    for(unsigned int yRow = 0; yRow < FRAME_ROWS; yRow++){
+        for(unsigned int xCol = 0; xCol < FRAME_COLUMNS; xCol++){
+            double intensity = 0;
+
+            for(unsigned int iSample = 0; iSample < 4; iSample++){
+                double ray[3] = {(xCol + ((iSample % 2) ? 0.25 : -0.25) - CENTER_X) / FOCAL_LENGTH,
+                                 (yRow + ((iSample / 2) ? 0.25 : -0.25) - CENTER_Y) / FOCAL_LENGTH,
+                                 1.0};
+
+                // Intersect the ray with the board plane and move it into board coordinates
+                double scale = distance / ((normal[0] * ray[0]) + (normal[1] * ray[1]) + (normal[2] * ray[2]));
+                double p[3]  = {(scale * ray[0]) - t[0], (scale * ray[1]) - t[1], (scale * ray[2]) - t[2]};
+                double x     = ((r[0] * p[0]) + (r[3] * p[1]) + (r[6] * p[2])) / SQUARE_SIZE;
+                double y     = ((r[1] * p[0]) + (r[4] * p[1]) + (r[7] * p[2])) / SQUARE_SIZE;
+
+                // Squares span one square beyond the features and the board
+                // has a white margin of one more square
+                int square_column = (int) floor(x) + 1;
+                int square_row    = (int) floor(y) + 1;
+
+                if((scale <= 0) ||
+                   (square_column < -1) || (square_column > FEATURE_COLUMNS + 1) ||
+                   (square_row    < -1) || (square_row    > FEATURE_ROWS    + 1)){
+                    intensity += 90;    // Background
+                }
+                else if((square_column <  0) || (square_column > FEATURE_COLUMNS) ||
+                        (square_row    <  0) || (square_row    > FEATURE_ROWS)){
+                    intensity += 220;   // Margin
+                }
+                else{
+                    intensity += (((square_column + square_row) % 2) == 0) ? 30 : 220;
+                }
+            }
+
+            frame.at<unsigned char>(yRow, xCol) = cv::saturate_cast<unsigned char>((intensity / 4.0) + noise(*generator));
+        }
+    }
+
+    dlp::Image image;
+    image.Create(frame);
+    return image;
+}
+
+/** @brief Sets up a camera calibration module for the synthetic boards */
+dlp::ReturnCode SetupModule(const unsigned int &boards_required, dlp::Calibration::Camera *module){
+    dlp::Parameters settings;
+    settings.Set(dlp::Calibration::Parameters::ModelColumns(FRAME_COLUMNS));
+    settings.Set(dlp::Calibration::Parameters::ModelRows(FRAME_ROWS));
+    settings.Set(dlp::Calibration::Parameters::ImageColumns(FRAME_COLUMNS));
+    settings.Set(dlp::Calibration::Parameters::ImageRows(FRAME_ROWS));
+    settings.Set(dlp::Calibration::Parameters::BoardCount(boards_required));
+    settings.Set(dlp::Calibration::Parameters::BoardFeatureColumns(FEATURE_COLUMNS));
+    settings.Set(dlp::Calibration::Parameters::BoardFeatureColumnDistance(SQUARE_SIZE));
+    settings.Set(dlp::Calibration::Parameters::BoardFeatureColumnDistancePixels(100));
+    settings.Set(dlp::Calibration::Parameters::BoardFeatureRows(FEATURE_ROWS));
+    settings.Set(dlp::Calibration::Parameters::BoardFeatureRowDistance(SQUARE_SIZE));
+    settings.Set(dlp::Calibration::Parameters::BoardFeatureRowDistancePixels(100));
+    settings.Set(dlp::Calibration::Parameters::SetTangentDistZero(true));
+    settings.Set(dlp::Calibration::Parameters::FixSixthOrderDist(true));
+    return module->Setup(settings);
+}
+
+/** @brief Calibrates a module and checks the result against the known values */
+void CheckCalibration(const std::string &name, dlp::Calibration::Camera *module){
+    double reprojection_error = 0;
+
+    dlp::ReturnCode ret = module->Calibrate(&reprojection_error);
+    Check(name + " calibration", !ret.hasErrors(), ret);
+    if(ret.hasErrors()) return;
+
+    dlp::Calibration::Data data;
+    cv::Mat intrinsic, extrinsic, distortion;
+    double  error;
+    module->GetCalibrationData(&data);
+    data.GetData(&intrinsic, &extrinsic, &distortion, &error);
+
+    double focal_error  = std::max(fabs(intrinsic.at<double>(0,0) - FOCAL_LENGTH), fabs(intrinsic.at<double>(1,1) - FOCAL_LENGTH));
+    double center_error = std::max(fabs(intrinsic.at<double>(0,2) - CENTER_X),     fabs(intrinsic.at<double>(1,2) - CENTER_Y));
+
+    std::cout << "      RMS error = " << reprojection_error << " px, focal error = " << focal_error
+              << " px, center error = " << center_error << " px" << std::endl;
+
+    Check(name + " RMS error",    reprojection_error < MAX_RMS_ERROR,               ret);
+    Check(name + " focal length", focal_error < (MAX_FOCAL_ERROR * FOCAL_LENGTH),   ret);
+    Check(name + " center",       center_error < MAX_CENTER_ERROR,                  ret);
+}
+
+int main(int argc, char *argv[])
+{
+    dlp::ReturnCode ret;
+    std::mt19937    generator(2016);
+    unsigned int    board_count = 12;
+
+    if(argc > 1) board_count = dlp::String::ToNumber<unsigned int>(argv[1]);
+
+    std::cout << std::fixed << std::setprecision(3);
+
+    // Render the boards at random poses
+    std::cout << "Rendering " << board_count << " boards of " << FRAME_COLUMNS << " x " << FRAME_ROWS << " pixels..." << std::endl;
+
+    std::uniform_real_distribution<double> tilt(-0.5, 0.5);
+    std::uniform_real_distribution<double> offset_x(-140, 140);
+    std::uniform_real_distribution<double> offset_y(-90, 90);
+    std::uniform_real_distribution<double> depth(1100, 1400);
+
+    std::vector<cv::Mat>      rotations(board_count);
+    std::vector<cv::Mat>      translations(board_count);
+    std::vector<unsigned int> seeds(board_count);
+
+    for(unsigned int iBoard = 0; iBoard < board_count; iBoard++){
+        cv::Mat rvec   = (cv::Mat_<double>(3,1) << tilt(generator), tilt(generator), 0.2 * tilt(generator));
+        cv::Mat center = (cv::Mat_<double>(3,1) << offset_x(generator), offset_y(generator), depth(generator));
+        cv::Mat board_center = (cv::Mat_<double>(3,1) << SQUARE_SIZE * (FEATURE_COLUMNS - 1) / 2.0,
+                                                          SQUARE_SIZE * (FEATURE_ROWS    - 1) / 2.0, 0);
+        cv::Rodrigues(rvec, rotations.at(iBoard));
+        translations.at(iBoard) = center - (rotations.at(iBoard) * board_center);
+        seeds.at(iBoard)        = generator();
+    }
+
+    std::vector<dlp::Image> boards(board_count);
+    dlp::Thread::ParallelFor(0, board_count, [&](unsigned long long first, unsigned long long last){
+        for(unsigned long long iBoard = first; iBoard < last; iBoard++){
+            std::mt19937 board_generator(seeds.at(iBoard));
+            boards.at(iBoard) = RenderBoard(rotations.at(iBoard), translations.at(iBoard), &board_generator);
+        }
+    });
+
+    dlp::Calibration::Camera single;
+    dlp::Calibration::Camera batch;
+
+    ret = SetupModule(board_count, &single);
+    if(!ret.hasErrors()) ret = SetupModule(board_count, &batch);
+    Check("Setup", !ret.hasErrors(), ret);
+    if(ret.hasErrors()) return 1;
+
+    // One image at a time on this thread at full resolution
+    std::vector<double> single_times(board_count, 0);
+    unsigned int        single_found = 0;
+    auto start = std::chrono::steady_clock::now();
+    for(unsigned int iBoard = 0; iBoard < board_count; iBoard++){
+        bool found = false;
+        auto board_start = std::chrono::steady_clock::now();
+        single.AddCalibrationBoard(boards.at(iBoard), &found);
+        single_times.at(iBoard) = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - board_start).count();
+        if(found) single_found++;
+    }
+    double single_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    // All images concurrently with the coarse search
+    std::vector<bool>               batch_found;
+    std::vector<unsigned long long> batch_times;
+    start = std::chrono::steady_clock::now();
+    ret = batch.AddCalibrationBoards(boards, &batch_found, &batch_times);
+    double batch_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "Board   single [ms]   batch [ms]" << std::endl;
+    for(unsigned int iBoard = 0; iBoard < board_count; iBoard++){
+        std::cout << std::setw(5) << iBoard << std::setw(14) << single_times.at(iBoard);
+        if(iBoard < batch_times.size()) std::cout << std::setw(13) << batch_times.at(iBoard);
+        if((iBoard < batch_found.size()) && !batch_found.at(iBoard)) std::cout << "  NOT found by batch";
+        std::cout << std::endl;
+    }
+    std::cout << "Total: single = " << single_ms << " ms, batch = " << batch_ms << " ms" << std::endl;
+
+    unsigned int batch_found_count = 0;
+    for(unsigned int iBoard = 0; iBoard < batch_found.size(); iBoard++) if(batch_found.at(iBoard)) batch_found_count++;
+
+    Check("Single image method finds every board", single_found == board_count, dlp::ReturnCode());
+    Check("Batch method finds every board", !ret.hasErrors() && !ret.hasWarnings() && (batch_found_count == board_count), ret);
+    Check("Batch method returns a time for every board", batch_times.size() == board_count, ret);
+
+    CheckCalibration("Single image", &single);
+    CheckCalibration("Batch",        &batch);
+
+    std::cout << failures << " failures" << std::endl;
+    return failures;
+}
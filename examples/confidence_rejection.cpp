@@ -0,0 +1,279 @@
+/** @file   confidence_rejection.cpp
+ *  @brief  Rejects low contrast and interreflected pixels with the confidence
+ *          maps of the Gray code and three phase decoders
+ *
+ *  Usage: confidence_rejection
+ *
+ *  The synthetic camera sees the projector pixel for pixel, so every decoded
+ *  disparity should equal its camera column. The frame is split into three
+ *  horizontal bands:
+ *
+ *  - clean:            bright surface with a little sensor noise
+ *  - low modulation:   dark surface where the noise is close to the pattern contrast
+ *  - interreflection:  a nearby surface adds a blurred copy of the pattern
+ *                      which is stronger than the direct light, so the
+ *                      coarse bitplanes and the hybrid unwrap are decoded wrong
+ *
+ *  Each band reports the valid pixels, the wrong pixels (valid but more than
+ *  one column off) and the rejected pixels, without and with rejection
+ *  limits. Applying the same limits to the unfiltered map afterwards, as
+ *  \ref dlp::Geometry::GeneratePointCloud() does, must reject the same pixels.
+ *  The program returns 1 if any step fails or the rejected pixels differ.
+ */
+
+#include <dlp_sdk.hpp>
+
+#include <math.h>
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#define FRAME_COLUMNS   1024
+#define FRAME_ROWS      240
+
+#define AMBIENT_LIGHT           10.0
+#define NOISE_SIGMA             2.0
+#define CLEAN_GAIN              180.0
+#define LOW_MODULATION_GAIN     4.0
+#define INTERREFLECTION_GAIN    40.0
+#define INTERREFLECTION_GLOBAL  200.0
+#define INTERREFLECTION_RADIUS  256     // Columns averaged by the interreflection
+
+#define MINIMUM_MODULATION      20.0
+#define MINIMUM_MARGIN          5.0
+#define MAXIMUM_GLOBAL_RATIO    1.0
+#define DISPARITY_TOLERANCE     1
+
+/** @brief Renders the captures of every pattern with noise and interreflection */
+void RenderCaptures(const dlp::Pattern::Sequence &patterns, dlp::Capture::Sequence *captures){
+    std::mt19937 generator(1);
+    std::normal_distribution<double> noise(0.0, NOISE_SIGMA);
+
+    captures->Clear();
+
+    for(unsigned int iPattern = 0; iPattern < patterns.GetCount(); iPattern++){
+        dlp::Pattern pattern;
+        cv::Mat      pattern_data;
+
+        patterns.Get(iPattern, &pattern);
+        pattern.image_data.ConvertToMonochrome();
+        pattern.image_data.Unsafe_GetOpenCVData(&pattern_data);
+
+        // Vertical patterns are the same on every row, so the interreflection
+        // is a running average of the first row
+        std::vector<double> profile(FRAME_COLUMNS);
+        std::vector<double> sum(FRAME_COLUMNS + 1, 0.0);
+        for(unsigned int xCol = 0; xCol < FRAME_COLUMNS; xCol++){
+            profile.at(xCol) = pattern_data.at<unsigned char>(0, xCol) / 255.0;
+            sum.at(xCol + 1) = sum.at(xCol) + profile.at(xCol);
+        }
+
+        std::vector<double> blurred(FRAME_COLUMNS);
+        for(int xCol = 0; xCol < FRAME_COLUMNS; xCol++){
+            int first = std::max(xCol - INTERREFLECTION_RADIUS, 0);
+            int last  = std::min(xCol + INTERREFLECTION_RADIUS + 1, FRAME_COLUMNS);
+            blurred.at(xCol) = (sum.at(last) - sum.at(first)) / (last - first);
+        }
+
+        cv::Mat frame(FRAME_ROWS, FRAME_COLUMNS, CV_8UC1);
+
+        for(unsigned int yRow = 0; yRow < FRAME_ROWS; yRow++){
+            unsigned char *pixel = frame.ptr<unsigned char>(yRow);
+            unsigned int   band  = (3 * yRow) / FRAME_ROWS;
+
+            for(unsigned int xCol = 0; xCol < FRAME_COLUMNS; xCol++){
+                double value = AMBIENT_LIGHT + noise(generator);
+
+                switch(band){
+                case 0:  value += CLEAN_GAIN * profile.at(xCol);                    break;
+                case 1:  value += LOW_MODULATION_GAIN * profile.at(xCol);           break;
+                default: value += INTERREFLECTION_GAIN   * profile.at(xCol) +
+                                  INTERREFLECTION_GLOBAL * blurred.at(xCol);        break;
+                }
+
+                pixel[xCol] = (unsigned char) std::min(std::max(lround(value), 0L), 255L);
+            }
+        }
+
+        dlp::Capture capture;
+        capture.data_type = dlp::Capture::DataType::IMAGE_DATA;
+        capture.image_data.Create(frame);
+        captures->Add(capture);
+    }
+}
+
+/** @brief Returns true if a decoded pixel is within the tolerance of its column */
+bool isCorrect(const int &value, const unsigned int &xCol, const unsigned int &sampling){
+    return abs(value - (int)(xCol * sampling)) <= (int)(DISPARITY_TOLERANCE * sampling);
+}
+
+/** @brief Prints the valid, wrong, and rejected pixels of each band
+ *  @param[in]  name        Label of the line
+ *  @param[in]  unfiltered  Map decoded without limits
+ *  @param[in]  filtered    Map decoded with limits
+ */
+void PrintBands(const std::string &name, dlp::DisparityMap unfiltered, dlp::DisparityMap filtered){
+    const std::string band_names[3] = {"clean", "low modulation", "interreflection"};
+    unsigned int sampling = 1;
+    filtered.GetDisparitySampling(&sampling);
+
+    std::cout << name << std::endl;
+
+    for(unsigned int iBand = 0; iBand < 3; iBand++){
+        unsigned long long pixels          = 0;
+        unsigned long long valid           = 0;
+        unsigned long long wrong           = 0;
+        unsigned long long filtered_valid  = 0;
+        unsigned long long filtered_wrong  = 0;
+        unsigned long long rejected        = 0;
+        unsigned long long rejected_wrong  = 0;
+
+        for(     unsigned int yRow = iBand * FRAME_ROWS / 3; yRow < (iBand + 1) * FRAME_ROWS / 3; yRow++){
+            for( unsigned int xCol = 0; xCol < FRAME_COLUMNS; xCol++){
+                int  value;
+                int  filtered_value;
+                bool is_valid;
+                bool is_filtered_valid;
+
+                unfiltered.Unsafe_GetPixel(xCol, yRow, &value, &is_valid);
+                filtered.Unsafe_GetPixel(  xCol, yRow, &filtered_value, &is_filtered_valid);
+                pixels++;
+
+                is_valid          = is_valid          && (value          != dlp::DisparityMap::EMPTY_PIXEL);
+                is_filtered_valid = is_filtered_valid && (filtered_value != dlp::DisparityMap::EMPTY_PIXEL);
+
+                if(is_valid){
+                    valid++;
+                    if(!isCorrect(value, xCol, sampling)) wrong++;
+                }
+
+                if(is_filtered_valid){
+                    filtered_valid++;
+                    if(!isCorrect(filtered_value, xCol, sampling)) filtered_wrong++;
+                }
+                else if(is_valid){
+                    rejected++;
+                    if(!isCorrect(value, xCol, sampling)) rejected_wrong++;
+                }
+            }
+        }
+
+        std::cout << "  " << band_names[iBand] << ":"
+                  << " valid = "    << (100.0 * valid / pixels) << "%"
+                  << " wrong = "    << (100.0 * wrong / pixels) << "%"
+                  << " -> rejected = " << (100.0 * rejected / pixels) << "%"
+                  << " (" << (wrong ? (100.0 * rejected_wrong / wrong) : 100.0) << "% of wrong)"
+                  << " valid = "    << (100.0 * filtered_valid / pixels) << "%"
+                  << " wrong = "    << (100.0 * filtered_wrong / pixels) << "%" << std::endl;
+    }
+}
+
+/** @brief Decodes the captures without and with limits and prints the result
+ *  @retval false   A step failed or filtering afterwards rejected other pixels
+ */
+bool Compare(const std::string &name, dlp::StructuredLight *module, const dlp::Parameters &settings){
+    dlp::ReturnCode         ret;
+    dlp::Parameters         filtered_settings = settings;
+    dlp::Pattern::Sequence  patterns;
+    dlp::Capture::Sequence  captures;
+    dlp::DisparityMap       unfiltered;
+    dlp::DisparityMap       filtered;
+    dlp::DisparityMap       post_filtered;
+    dlp::ConfidenceMap      confidence;
+
+    // Decode without limits
+    ret = module->Setup(settings);
+    if(!ret.hasErrors()) ret = module->GeneratePatternSequence(&patterns);
+    if(ret.hasErrors()){
+        std::cout << name << " setup failed: " << ret.ToString() << std::endl;
+        return false;
+    }
+
+    RenderCaptures(patterns, &captures);
+
+    ret = module->DecodeCaptureSequence(&captures, &unfiltered);
+    if(!ret.hasErrors()) ret = module->GetConfidenceMap(&confidence);
+    if(ret.hasErrors()){
+        std::cout << name << " decode failed: " << ret.ToString() << std::endl;
+        return false;
+    }
+
+    // Decode with limits
+    filtered_settings.Set(dlp::StructuredLight::Parameters::MinimumModulation(MINIMUM_MODULATION));
+    filtered_settings.Set(dlp::StructuredLight::Parameters::MinimumDecisionMargin(MINIMUM_MARGIN));
+    filtered_settings.Set(dlp::StructuredLight::Parameters::MaximumGlobalRatio(MAXIMUM_GLOBAL_RATIO));
+
+    ret = module->Setup(filtered_settings);
+    if(!ret.hasErrors()) ret = module->DecodeCaptureSequence(&captures, &filtered);
+    if(ret.hasErrors()){
+        std::cout << name << " filtered decode failed: " << ret.ToString() << std::endl;
+        return false;
+    }
+
+    PrintBands(name, unfiltered, filtered);
+
+    // Filtering the unfiltered map afterwards must reject the same pixels
+    dlp::ConfidenceMap::Rejection rejection;
+    unsigned long long            rejected = 0;
+    module->GetRejection(&rejection);
+
+    post_filtered.Create(unfiltered);
+    ret = confidence.Reject(rejection, &post_filtered, &rejected);
+    if(ret.hasErrors()){
+        std::cout << "  rejection failed: " << ret.ToString() << std::endl;
+        return false;
+    }
+
+    unsigned long long mismatched = 0;
+    for(     unsigned int yRow = 0; yRow < FRAME_ROWS;    yRow++){
+        for( unsigned int xCol = 0; xCol < FRAME_COLUMNS; xCol++){
+            int value_decoded;
+            int value_post;
+            filtered.Unsafe_GetPixel(     xCol, yRow, &value_decoded);
+            post_filtered.Unsafe_GetPixel(xCol, yRow, &value_post);
+            if(value_decoded != value_post) mismatched++;
+        }
+    }
+
+    std::cout << "  filtering after decoding rejected " << rejected << " pixels, "
+              << mismatched << " pixels differ from filtering while decoding" << std::endl;
+
+    return mismatched == 0;
+}
+
+int main()
+{
+    dlp::Parameters settings;
+    settings.Set(dlp::StructuredLight::Parameters::PatternColor(dlp::Pattern::Color::WHITE));
+    settings.Set(dlp::StructuredLight::Parameters::PatternOrientation(dlp::Pattern::Orientation::VERTICAL));
+    settings.Set(dlp::StructuredLight::Parameters::PatternColumns(FRAME_COLUMNS));
+    settings.Set(dlp::StructuredLight::Parameters::PatternRows(FRAME_ROWS));
+
+    std::cout << "Limits: modulation >= " << MINIMUM_MODULATION
+              << ", margin >= "           << MINIMUM_MARGIN
+              << ", global / direct <= "  << MAXIMUM_GLOBAL_RATIO << std::endl;
+
+    // Gray code with inverted patterns
+    dlp::GrayCode   gray_code;
+    dlp::Parameters gray_code_settings = settings;
+    gray_code_settings.Set(dlp::GrayCode::Parameters::IncludeInverted(true));
+    gray_code_settings.Set(dlp::GrayCode::Parameters::SequenceCount(10));
+    gray_code_settings.Set(dlp::GrayCode::Parameters::PixelThreshold(5));
+
+    bool passed = Compare("Gray code", &gray_code, gray_code_settings);
+
+    // Three phase with hybrid Gray code unwrapping
+    dlp::ThreePhase three_phase;
+    dlp::Parameters three_phase_settings = settings;
+    three_phase_settings.Set(dlp::ThreePhase::Parameters::Bitdepth(dlp::Pattern::Bitdepth::MONO_8BPP));
+    three_phase_settings.Set(dlp::ThreePhase::Parameters::PixelsPerPeriod(32));
+    three_phase_settings.Set(dlp::ThreePhase::Parameters::UseHybridUnwrap(true));
+
+    passed = Compare("Three phase", &three_phase, three_phase_settings) && passed;
+
+    std::cout << (passed ? "PASS" : "FAIL") << ": filtering while and after decoding rejects the same pixels" << std::endl;
+
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,194 @@
+/** @file   distance_color_benchmark.cpp
+ *  @brief  Compares \ref dlp::Geometry::ConvertDistanceMapToColor() with the
+ *          per-pixel conversion it replaced
+ *
+ *  Usage: distance_color_benchmark [iterations]
+ *
+ *  A sloped distance map with empty pixels is colored by the lookup table
+ *  path and by a copy of the original per-pixel rainbow conversion. Every
+ *  pixel must have the same color. A fixed distance range must also match
+ *  the automatic range when it is the same range. The average time of both
+ *  paths is reported. Each check prints PASS or FAIL and the program returns
+ *  the number of failures.
+ */
+
+#include <dlp_sdk.hpp>
+
+#include <iostream>
+#include <string>
+
+#define MAP_COLUMNS     1280
+#define MAP_ROWS        800
+
+unsigned int failures = 0;
+
+void Check(const std::string &name, const bool &passed, const dlp::ReturnCode &ret){
+    std::cout << (passed ? "PASS: " : "FAIL: ") << name << std::endl;
+    if(!passed){
+        if(ret.hasErrors()) std::cout << "      " << ret.ToString() << std::endl;
+        failures++;
+    }
+}
+
+/** @brief Original per-pixel rainbow conversion, kept as the reference */
+void ReferenceDistanceMapToColor(const dlp::Image &distance_map, dlp::Image *color_depth){
+    double min_distance = 0;
+    double max_distance = 0;
+
+    unsigned int rows;
+    unsigned int columns;
+    distance_map.GetColumns(&columns);
+    distance_map.GetRows(&rows);
+
+    // Find the min and max distances
+    for(    unsigned int xCol = 0; xCol < columns; xCol++){
+        for(unsigned int yRow = 0; yRow < rows; yRow++){
+            double distance;
+            distance_map.Unsafe_GetPixel( xCol, yRow, &distance);
+
+            if(distance != (double)dlp::DisparityMap::EMPTY_PIXEL){
+                if(max_distance == 0 && min_distance == 0){
+                    max_distance = distance;
+                    min_distance = distance;
+                }
+                if(distance < min_distance) min_distance = distance;
+                if(distance > max_distance) max_distance = distance;
+            }
+        }
+    }
+
+    color_depth->Clear();
+    color_depth->Create(columns,rows,dlp::Image::Format::RGB_UCHAR);
+    color_depth->FillImage(dlp::PixelRGB(0,0,0));
+
+    // Convert distance to color
+    for(    unsigned int xCol = 0; xCol < columns; xCol++){
+        for(unsigned int yRow = 0; yRow < rows; yRow++){
+            double          distance;
+            dlp::PixelRGB   depth;
+            unsigned char   depth_temp;
+
+            distance_map.Unsafe_GetPixel( xCol, yRow, &distance);
+            if(distance == (double)dlp::DisparityMap::EMPTY_PIXEL) continue;
+
+            depth_temp = (unsigned char) ((max_distance - distance) * 255 / (max_distance - min_distance));
+
+            if(depth_temp < 43){
+                depth.r = depth_temp * 6;
+                depth.g = 0;
+                depth.b = depth_temp * 6;
+            }
+            if(depth_temp > 42 && depth_temp < 85){
+                depth.r = 255 - (depth_temp - 43) * 6;
+                depth.g = 0;
+                depth.b = 255;
+            }
+            if(depth_temp > 84 && depth_temp < 128){
+                depth.r = 0;
+                depth.g = (depth_temp - 85) * 6;
+                depth.b = 255;
+            }
+            if(depth_temp > 127 && depth_temp < 169){
+                depth.r = 0;
+                depth.g = 255;
+                depth.b = 255 - (depth_temp - 128) * 6;
+            }
+            if(depth_temp > 168 && depth_temp < 212){
+                depth.r = (depth_temp - 169) * 6;
+                depth.g = 255;
+                depth.b = 0;
+            }
+            if(depth_temp > 211 && depth_temp < 254){
+                depth.r = 255;
+                depth.g = 255 - (depth_temp - 212) * 6;
+                depth.b = 0;
+            }
+            if(depth_temp > 253){
+                depth.r = 255;
+                depth.g = 0;
+                depth.b = 0;
+            }
+
+            color_depth->Unsafe_SetPixel(xCol,yRow,depth);
+        }
+    }
+}
+
+/** @brief Returns the number of pixels whose colors differ */
+unsigned long long CountDifferences(const dlp::Image &first, const dlp::Image &second){
+    unsigned int columns = 0;
+    unsigned int rows    = 0;
+    first.GetColumns(&columns);
+    first.GetRows(&rows);
+
+    unsigned long long differences = 0;
+    for(     unsigned int yRow = 0; yRow < rows;    yRow++){
+        for( unsigned int xCol = 0; xCol < columns; xCol++){
+            dlp::PixelRGB a;
+            dlp::PixelRGB b;
+            first.Unsafe_GetPixel( xCol, yRow, &a);
+            second.Unsafe_GetPixel(xCol, yRow, &b);
+            if((a.r != b.r) || (a.g != b.g) || (a.b != b.b)) differences++;
+        }
+    }
+    return differences;
+}
+
+int main(int argc, char *argv[])
+{
+    dlp::ReturnCode ret;
+    unsigned int    iterations = 10;
+
+    if(argc > 1) iterations = dlp::String::ToNumber<unsigned int>(argv[1]);
+    if(iterations == 0) iterations = 1;
+
+    // Sloped surface with every 11th pixel empty. The distances include
+    // values which scale to exact table indices.
+    dlp::Image distance_map;
+    distance_map.Create(MAP_COLUMNS, MAP_ROWS, dlp::Image::Format::MONO_DOUBLE);
+    for(     unsigned int yRow = 0; yRow < MAP_ROWS;    yRow++){
+        for( unsigned int xCol = 0; xCol < MAP_COLUMNS; xCol++){
+            double distance = 400.0 + (0.37 * xCol) + (0.21 * yRow);
+            if((((yRow * MAP_COLUMNS) + xCol) % 11) == 0) distance = (double) dlp::DisparityMap::EMPTY_PIXEL;
+            distance_map.Unsafe_SetPixel(xCol, yRow, distance);
+        }
+    }
+
+    std::cout << "Coloring a " << MAP_COLUMNS << " x " << MAP_ROWS << " distance map, average of "
+              << iterations << " runs..." << std::endl;
+
+    dlp::Image color;
+    dlp::Image reference;
+    double     table_ms     = 0;
+    double     reference_ms = 0;
+
+    for(unsigned int iRun = 0; iRun < iterations; iRun++){
+        dlp::Time::Chronograph timer(true);
+        ret = dlp::Geometry::ConvertDistanceMapToColor(distance_map, &color);
+        table_ms += (double) timer.Lap();
+        if(ret.hasErrors()) break;
+
+        ReferenceDistanceMapToColor(distance_map, &reference);
+        reference_ms += (double) timer.Lap();
+    }
+
+    Check("Lookup table colors match the per-pixel conversion",
+          !ret.hasErrors() && (CountDifferences(color, reference) == 0), ret);
+
+    // The range of the map given as a fixed range
+    dlp::Image fixed;
+    double     max_distance = 400.0 + (0.37 * (MAP_COLUMNS - 1)) + (0.21 * (MAP_ROWS - 1));
+    ret = dlp::Geometry::ConvertDistanceMapToColor(distance_map, dlp::Geometry::ColorMap::RAINBOW,
+                                                   400.0 + 0.37, max_distance, &fixed);
+    Check("Fixed range equal to the map range gives the same colors",
+          !ret.hasErrors() && (CountDifferences(color, fixed) == 0), ret);
+
+    table_ms     /= iterations;
+    reference_ms /= iterations;
+
+    std::cout << "Lookup table = " << table_ms << " ms, per-pixel = " << reference_ms << " ms, speedup = "
+              << ((table_ms > 0) ? reference_ms / table_ms : 0.0) << "x" << std::endl;
+
+    std::cout << failures << " failures" << std::endl;
+    return failures;
+}
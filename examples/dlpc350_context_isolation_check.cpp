@@ -0,0 +1,168 @@
+/** @file   dlpc350_context_isolation_check.cpp
+ *  @brief  Drives two DLPC350 contexts from two threads and checks that
+ *          their command streams stay isolated
+ *
+ *  Usage: dlpc350_context_isolation_check [commands]
+ *
+ *  Each context uses its own simulated DLPC350 which acknowledges every
+ *  command. Each thread sends LED current commands with its own value,
+ *  alternating blocks of blocking and pipelined commands. Every device
+ *  must only receive the value of its own thread, and the sequence numbers
+ *  it receives must increase without gaps.
+ */
+
+#include <dlp_sdk.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define DEVICE_COUNT        2
+#define BLOCK_SIZE          50
+#define COMMAND_LED_CURRENT 0x0B01
+
+/** @brief Simulated DLPC350 which records what it receives */
+struct RecordingDevice{
+    RecordingDevice(){
+        this->value         = 0;
+        this->commands      = 0;
+        this->foreign       = 0;
+        this->gaps          = 0;
+        this->last_sequence = -1;
+    }
+
+    std::mutex          mutex;
+    std::deque<std::vector<unsigned char> > replies;
+
+    unsigned char       value;          // LED current the thread of this device sends
+    unsigned long long  commands;       // Commands received
+    unsigned long long  foreign;        // Commands which did NOT carry this device's value
+    unsigned long long  gaps;           // Sequence numbers which did NOT follow the previous one
+    int                 last_sequence;
+};
+
+RecordingDevice devices[DEVICE_COUNT];
+
+/** @brief Transport write function of one simulated device */
+template <unsigned int DEVICE>
+int Write(const unsigned char *pBuffer, int length){
+    RecordingDevice &device = devices[DEVICE];
+    std::lock_guard<std::mutex> lock(device.mutex);
+
+    hidMessageStruct msg;
+    memset(&msg, 0, sizeof(msg));
+    memcpy(&msg, pBuffer + 1, USB_MAX_PACKET_SIZE);
+
+    device.commands++;
+
+    if((msg.text.cmd     != COMMAND_LED_CURRENT) ||
+       (msg.text.data[2] != device.value) ||
+       (msg.text.data[3] != device.value) ||
+       (msg.text.data[4] != device.value))
+        device.foreign++;
+
+    if((device.last_sequence >= 0) && (msg.head.seq != ((device.last_sequence + 1) & 0xFF)))
+        device.gaps++;
+    device.last_sequence = msg.head.seq;
+
+    // Acknowledge the command
+    if(msg.head.flags.reply == 1){
+        std::vector<unsigned char> reply(USB_MAX_PACKET_SIZE + 1, 0);
+        hidMessageStruct *pReply = (hidMessageStruct*) reply.data();
+        pReply->head.flags.reply = 1;
+        pReply->head.seq         = msg.head.seq;
+        device.replies.push_back(reply);
+    }
+
+    return length;
+}
+
+/** @brief Transport read function of one simulated device */
+template <unsigned int DEVICE>
+int Read(unsigned char *pBuffer, int length, int timeout_ms){
+    RecordingDevice &device = devices[DEVICE];
+    std::lock_guard<std::mutex> lock(device.mutex);
+
+    if(device.replies.empty()) return 0;
+
+    memcpy(pBuffer, device.replies.front().data(), std::min(length, USB_MAX_PACKET_SIZE + 1));
+    device.replies.pop_front();
+    return length;
+}
+
+/** @brief Sends the commands of one thread through its own context */
+void SendCommands(DLPC350_Context *context, const unsigned int &device, const unsigned int &commands, unsigned int *failures){
+    DLPC350_ContextLock lock(context);
+
+    if(device == 0) DLPC350_USB_SetTransport(Write<0>, Read<0>);
+    else            DLPC350_USB_SetTransport(Write<1>, Read<1>);
+
+    const unsigned char value = devices[device].value;
+
+    for(unsigned int iCommand = 0; iCommand < commands; iCommand += BLOCK_SIZE){
+        bool pipelined = ((iCommand / BLOCK_SIZE) % 2) == 1;
+
+        if(pipelined) DLPC350_BeginCommandPipeline();
+
+        for(unsigned int jCommand = iCommand; (jCommand < iCommand + BLOCK_SIZE) && (jCommand < commands); jCommand++){
+            if(DLPC350_SetLedCurrents(value, value, value) < 0) (*failures)++;
+        }
+
+        if(pipelined && (DLPC350_EndCommandPipeline() < 0)) (*failures)++;
+    }
+
+    DLPC350_USB_SetTransport(NULL, NULL);
+}
+
+int main(int argc, char *argv[])
+{
+    unsigned int commands = 5000;
+    bool         passed   = true;
+
+    if(argc > 1) commands = dlp::String::ToNumber<unsigned int>(argv[1]);
+
+    std::cout << "Sending " << commands << " commands through each of " << DEVICE_COUNT << " contexts..." << std::endl;
+
+    DLPC350_Context           contexts[DEVICE_COUNT];
+    std::vector<unsigned int> failures(DEVICE_COUNT, 0);
+    std::vector<std::thread>  threads;
+
+    for(unsigned int iDevice = 0; iDevice < DEVICE_COUNT; iDevice++){
+        devices[iDevice].value = 0x11 * (iDevice + 1);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for(unsigned int iDevice = 0; iDevice < DEVICE_COUNT; iDevice++){
+        threads.push_back(std::thread(SendCommands, &contexts[iDevice], iDevice, commands, &failures.at(iDevice)));
+    }
+    for(unsigned int iThread = 0; iThread < threads.size(); iThread++){
+        threads.at(iThread).join();
+    }
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    for(unsigned int iDevice = 0; iDevice < DEVICE_COUNT; iDevice++){
+        const RecordingDevice &device = devices[iDevice];
+        bool device_passed = (device.commands == commands) &&
+                             (device.foreign  == 0) &&
+                             (device.gaps     == 0) &&
+                             (failures.at(iDevice) == 0);
+
+        std::cout << (device_passed ? "PASS: " : "FAIL: ") << "device " << iDevice
+                  << " received " << device.commands << " commands, "
+                  << device.foreign << " foreign, "
+                  << device.gaps << " sequence gaps, "
+                  << failures.at(iDevice) << " failed" << std::endl;
+
+        if(!device_passed) passed = false;
+    }
+
+    std::cout << "Time: " << ms << " ms" << std::endl;
+
+    return passed ? 0 : 1;
+}
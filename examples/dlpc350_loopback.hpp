@@ -0,0 +1,251 @@
+/** @file   dlpc350_loopback.hpp
+ *  @brief  Simulated DLPC350 USB HID device used by the examples which run
+ *          the LightCrafter 4500 code without hardware
+ *
+ *  Install the functions with DLPC350_USB_SetTransport() or
+ *  dlp::LCr4500::SetTransport(). Every command which requests a reply is
+ *  answered after the device has processed it and the reply latency has
+ *  passed. Reads return the data last written with the same command, except
+ *  for the status registers which report an initialized DLPC350 whose
+ *  sequencer runs after a start command, and the lookup table validation
+ *  which always passes.
+ */
+
+#ifndef DLP_SDK_EXAMPLES_DLPC350_LOOPBACK_HPP
+#define DLP_SDK_EXAMPLES_DLPC350_LOOPBACK_HPP
+
+#include <dlp_sdk.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace dlpc350_loopback{
+
+// USB command codes (CMD2 << 8 | CMD3) the simulated device interprets
+const unsigned short COMMAND_SOURCE_SEL     = 0x1A00;
+const unsigned short COMMAND_STATUS_HW      = 0x1A0A;
+const unsigned short COMMAND_STATUS_SYS     = 0x1A0B;
+const unsigned short COMMAND_STATUS_MAIN    = 0x1A0C;
+const unsigned short COMMAND_LUT_VALID      = 0x1A1A;
+const unsigned short COMMAND_DISP_MODE      = 0x1A1B;
+const unsigned short COMMAND_PAT_START_STOP = 0x1A24;
+const unsigned short COMMAND_MBOX_EXP_DATA  = 0x1A3E;
+const unsigned short COMMAND_EXP_PAT_CONFIG = 0x1A40;
+
+const unsigned int   REPORT_SIZE      = USB_MAX_PACKET_SIZE;
+const unsigned int   HEADER_SIZE      = 4;
+const unsigned int   REPLY_DATA_SIZE  = 16;
+
+/** @brief Reply which can be read once the device has answered */
+struct Reply{
+    std::chrono::steady_clock::time_point ready;
+    unsigned char report[REPORT_SIZE + 1];
+};
+
+/** @brief State of the simulated device shared by the transport functions */
+struct Device{
+    Device(){
+        this->latency           = std::chrono::microseconds(0);
+        this->command_time      = std::chrono::microseconds(0);
+        this->busy_until        = std::chrono::steady_clock::now();
+        this->nack              = false;
+        this->continuation_size = 0;
+        this->sequence          = 0;
+        this->reply_requested   = false;
+        this->read              = false;
+        this->command           = 0;
+        this->commands          = 0;
+    }
+
+    std::mutex                    mutex;
+    std::chrono::microseconds     latency;          // Time from processing a command until its reply arrives
+    std::chrono::microseconds     command_time;     // Time the device needs to process one command
+    std::chrono::steady_clock::time_point busy_until;
+    bool                          nack;             // Answer every command with a NACK
+
+    std::deque<Reply>             replies;
+    std::map<unsigned short, std::vector<unsigned char> > registers;
+    std::map<unsigned short, unsigned long long>          writes;
+
+    // Command which is still receiving data reports
+    unsigned int                  continuation_size;
+    unsigned char                 sequence;
+    bool                          reply_requested;
+    bool                          read;
+    unsigned short                command;
+
+    unsigned long long            commands;         // Number of commands received
+};
+
+/** @brief Returns the simulated device */
+inline Device &GetDevice(){
+    static Device device;
+    return device;
+}
+
+/** @brief Sets the timing of the simulated device and clears its state */
+inline void Reset(const unsigned int &latency_us, const unsigned int &command_time_us, const bool &nack){
+    Device &device = GetDevice();
+    std::lock_guard<std::mutex> lock(device.mutex);
+
+    device.latency           = std::chrono::microseconds(latency_us);
+    device.command_time      = std::chrono::microseconds(command_time_us);
+    device.busy_until        = std::chrono::steady_clock::now();
+    device.nack              = nack;
+    device.replies.clear();
+    device.registers.clear();
+    device.writes.clear();
+    device.continuation_size = 0;
+    device.commands          = 0;
+}
+
+/** @brief Returns the number of commands the simulated device has received */
+inline unsigned long long GetCommandCount(){
+    Device &device = GetDevice();
+    std::lock_guard<std::mutex> lock(device.mutex);
+    return device.commands;
+}
+
+/** @brief Sets the data reads of a command reply with, e.g. the operating mode at power up */
+inline void SetRegister(const unsigned short &command, const std::vector<unsigned char> &data){
+    Device &device = GetDevice();
+    std::lock_guard<std::mutex> lock(device.mutex);
+    device.registers[command] = data;
+}
+
+/** @brief Returns how often a command has been written and the first data byte of the last write */
+inline unsigned long long GetWrites(const unsigned short &command, unsigned char *value){
+    Device &device = GetDevice();
+    std::lock_guard<std::mutex> lock(device.mutex);
+
+    std::map<unsigned short, std::vector<unsigned char> >::const_iterator data = device.registers.find(command);
+    (*value) = ((data != device.registers.end()) && !data->second.empty()) ? data->second.at(0) : 0;
+
+    std::map<unsigned short, unsigned long long>::const_iterator writes = device.writes.find(command);
+    return (writes != device.writes.end()) ? writes->second : 0;
+}
+
+/** @brief Returns the data a read of the command replies with */
+inline std::vector<unsigned char> ReadRegister(const Device &device, const unsigned short &command){
+    std::vector<unsigned char> data(REPLY_DATA_SIZE, 0);
+
+    switch(command){
+    case COMMAND_STATUS_HW:
+    case COMMAND_STATUS_SYS:
+        data.at(0) = 0x01;      // Initialized, memory test passed
+        break;
+    case COMMAND_STATUS_MAIN:{
+        // Sequencer run flag follows the last start or stop command
+        std::map<unsigned short, std::vector<unsigned char> >::const_iterator start_stop = device.registers.find(COMMAND_PAT_START_STOP);
+        if((start_stop != device.registers.end()) && (start_stop->second.at(0) == 2))
+            data.at(0) = 0x02;
+        break;
+    }
+    case COMMAND_LUT_VALID:
+        data.at(0) = 0x00;      // Validation finished without errors
+        break;
+    default:{
+        std::map<unsigned short, std::vector<unsigned char> >::const_iterator value = device.registers.find(command);
+        if(value != device.registers.end())
+            std::copy(value->second.begin(), value->second.begin() + std::min(value->second.size(), data.size()), data.begin());
+        break;
+    }
+    }
+
+    return data;
+}
+
+/** @brief Processes a command once all of its reports have been written */
+inline void CompleteCommand(Device *device){
+    device->commands++;
+    device->busy_until = std::max(device->busy_until, std::chrono::steady_clock::now()) + device->command_time;
+
+    if(!device->reply_requested) return;
+
+    Reply reply;
+    memset(reply.report, 0, sizeof(reply.report));
+    reply.ready = device->busy_until + device->latency;
+
+    hidMessageStruct *pMsg = (hidMessageStruct*) reply.report;
+    pMsg->head.flags.rw    = device->read ? 1 : 0;
+    pMsg->head.flags.reply = 1;
+    pMsg->head.flags.nack  = device->nack ? 1 : 0;
+    pMsg->head.seq         = device->sequence;
+
+    if(device->read){
+        std::vector<unsigned char> data = ReadRegister(*device, device->command);
+        pMsg->head.length = data.size();
+        memcpy(pMsg->text.data, data.data(), data.size());
+    }
+
+    device->replies.push_back(reply);
+}
+
+/** @brief Transport write function, receives one report starting with the report number */
+inline int Write(const unsigned char *pBuffer, int length){
+    Device &device = GetDevice();
+    std::lock_guard<std::mutex> lock(device.mutex);
+
+    const unsigned char *report = pBuffer + 1;
+
+    // Data reports of a command longer than one report
+    if(device.continuation_size > 0){
+        device.continuation_size -= std::min(device.continuation_size, REPORT_SIZE);
+        if(device.continuation_size == 0) CompleteCommand(&device);
+        return length;
+    }
+
+    hidMessageStruct msg;
+    memset(&msg, 0, sizeof(msg));
+    memcpy(&msg, report, REPORT_SIZE);
+
+    unsigned int first_size = std::min((unsigned int) msg.head.length, REPORT_SIZE - HEADER_SIZE);
+
+    device.sequence          = msg.head.seq;
+    device.reply_requested   = (msg.head.flags.reply == 1);
+    device.read              = (msg.head.flags.rw == 1);
+    device.command           = msg.text.cmd;
+    device.continuation_size = msg.head.length - first_size;
+
+    // Writes store the data following the command code
+    if(!device.read){
+        device.writes[device.command]++;
+        if(first_size > 2)
+            device.registers[device.command].assign(&msg.text.data[2], &msg.text.data[first_size]);
+    }
+
+    if(device.continuation_size == 0) CompleteCommand(&device);
+
+    return length;
+}
+
+/** @brief Transport read function, returns the oldest reply once it has arrived */
+inline int Read(unsigned char *pBuffer, int length, int timeout_ms){
+    Device &device = GetDevice();
+    Reply reply;
+    {
+        std::lock_guard<std::mutex> lock(device.mutex);
+        if(device.replies.empty()){
+            // Nothing was requested so the read times out
+            std::this_thread::sleep_for(std::chrono::milliseconds(std::min(timeout_ms, 10)));
+            return 0;
+        }
+        reply = device.replies.front();
+        device.replies.pop_front();
+    }
+
+    std::this_thread::sleep_until(reply.ready);
+
+    memcpy(pBuffer, reply.report, std::min((unsigned int) length, REPORT_SIZE + 1));
+    return length;
+}
+
+}
+
+#endif // DLP_SDK_EXAMPLES_DLPC350_LOOPBACK_HPP
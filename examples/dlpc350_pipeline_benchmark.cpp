@@ -0,0 +1,93 @@
+/** @file   dlpc350_pipeline_benchmark.cpp
+ *  @brief  Times sending a variable exposure pattern lookup table to a
+ *          simulated DLPC350 with different command pipeline windows
+ *
+ *  Usage: dlpc350_pipeline_benchmark [entries] [ack_latency_us] [command_time_us]
+ *
+ *  A window of one waits for every acknowledgement before sending the next
+ *  command, which is how the commands were sent before they were pipelined.
+ *  Finally the device answers with NACKs to check that failures are reported,
+ *  that a failed blocking command does NOT fail the next pipeline, and that
+ *  a late acknowledgement is counted as an unmatched reply.
+ */
+
+#include <dlp_sdk.hpp>
+#include "dlpc350_loopback.hpp"
+
+#include <chrono>
+#include <iostream>
+
+int main(int argc, char *argv[])
+{
+    unsigned int entries         = 128;
+    unsigned int ack_latency_us  = 1000;
+    unsigned int command_time_us = 30;
+
+    if(argc > 1) entries         = dlp::String::ToNumber<unsigned int>(argv[1]);
+    if(argc > 2) ack_latency_us  = dlp::String::ToNumber<unsigned int>(argv[2]);
+    if(argc > 3) command_time_us = dlp::String::ToNumber<unsigned int>(argv[3]);
+
+    if(entries > MAX_VAR_EXP_PAT_LUT_ENTRIES) entries = MAX_VAR_EXP_PAT_LUT_ENTRIES;
+
+    // Replace the USB device with the simulated DLPC350
+    DLPC350_USB_SetTransport(dlpc350_loopback::Write, dlpc350_loopback::Read);
+
+    // Create the lookup table
+    DLPC350_ClearExpLut();
+    for(unsigned int iEntry = 0; iEntry < entries; iEntry++){
+        DLPC350_AddToExpLut(0, iEntry % 24, 1, 7, false, true, false, false, 10000, 10000);
+    }
+
+    std::cout << "Sending " << entries << " lookup table entries, ACK latency = " << ack_latency_us
+              << " us, command time = " << command_time_us << " us" << std::endl;
+
+    const unsigned int windows[] = {1, 4, 16, 64};
+    for(unsigned int iWindow = 0; iWindow < sizeof(windows)/sizeof(windows[0]); iWindow++){
+        dlpc350_loopback::Reset(ack_latency_us, command_time_us, false);
+        DLPC350_SetCommandPipelineWindow(windows[iWindow]);
+
+        auto start = std::chrono::steady_clock::now();
+        int  result = DLPC350_SendVarExpPatLut();
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        std::cout << "  window " << windows[iWindow] << ": " << ms << " ms, "
+                  << dlpc350_loopback::GetCommandCount() << " commands"
+                  << (result < 0 ? ", FAILED" : "") << std::endl;
+    }
+
+    // Every command is rejected so both the pipelined and the blocking path must fail
+    dlpc350_loopback::Reset(0, 0, true);
+    DLPC350_SetCommandPipelineWindow(16);
+
+    bool lut_failed     = (DLPC350_SendVarExpPatLut() < 0);
+    bool command_failed = (DLPC350_SetMode(true) < 0);
+
+    std::cout << "NACK reported by the pipelined lookup table: " << (lut_failed     ? "yes" : "NO") << std::endl;
+    std::cout << "NACK reported by a blocking command:         " << (command_failed ? "yes" : "NO") << std::endl;
+
+    // The blocking command already returned its NACK, the next pipeline must NOT fail
+    dlpc350_loopback::Reset(0, 0, false);
+    bool clean_lut_passed = (DLPC350_SendVarExpPatLut() == 0);
+
+    std::cout << "Pipeline after a NACKed blocking command:    " << (clean_lut_passed ? "passed" : "FAILED") << std::endl;
+
+    // The acknowledgement of a command failed by a reconnect arrives after
+    // the channel was reset and is read by the next command
+    dlp::DLPC350_CommandChannel &channel = DLPC350_GetContext()->Channel;
+    unsigned long long unmatched = channel.GetUnmatched();
+
+    DLPC350_BeginCommandPipeline();
+    DLPC350_SetMode(true);
+    channel.Reset();
+    DLPC350_EndCommandPipeline();
+
+    bool late_ack_passed  = (DLPC350_SetMode(true) >= 0);
+    bool late_ack_counted = (channel.GetUnmatched() == unmatched + 1);
+
+    std::cout << "Command after a late acknowledgement:        " << (late_ack_passed  ? "passed" : "FAILED") << std::endl;
+    std::cout << "Late acknowledgement counted as unmatched:   " << (late_ack_counted ? "yes"    : "NO")     << std::endl;
+
+    DLPC350_USB_SetTransport(NULL, NULL);
+
+    return (lut_failed && command_failed && clean_lut_passed && late_ack_passed && late_ack_counted) ? 0 : 1;
+}
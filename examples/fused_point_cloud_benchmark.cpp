@@ -0,0 +1,200 @@
+/** @file   fused_point_cloud_benchmark.cpp
+ *  @brief  Compares the staged and fused decoding of structured light
+ *          captures into a point cloud
+ *
+ *  Usage: fused_point_cloud_benchmark [iterations]
+ *
+ *  Gray code, subpixel Gray code, and three phase patterns are rendered onto
+ *  a tilted plane seen by a synthetic camera. Each sequence is decoded with
+ *  \ref dlp::StructuredLight::DecodeCaptureSequence() followed by
+ *  \ref dlp::Geometry::GeneratePointCloud(), and with
+ *  \ref dlp::StructuredLight::DecodeToPointCloud(). The time, throughput, and
+ *  largest distance between matching points of the two paths are reported.
+ *  The program returns 1 if a step fails or the clouds do NOT match.
+ */
+
+#include <dlp_sdk.hpp>
+
+#include "synthetic_scene.hpp"
+
+#include <math.h>
+#include <iostream>
+#include <string>
+
+#define FRAME_COLUMNS   1280
+#define FRAME_ROWS      800
+#define FOCAL_LENGTH    1400.0
+
+#define CAMERA_BASELINE 150.0   // Camera is placed to the right of the projector (mm)
+#define PLANE_DISTANCE  800.0   // Distance from the projector to the plane along its optical axis (mm)
+#define MATCH_TOLERANCE 1.0e-6  // Largest distance between matching points (mm)
+
+/** @brief Times both paths for one module and prints the comparison
+ *  @retval false   A path failed or the clouds are empty or do NOT match
+ */
+bool Compare(const std::string &name, dlp::StructuredLight *module, const dlp::Parameters &settings,
+             const synthetic_scene::Scene &scene, const unsigned int &iterations,
+             dlp::Geometry *geometry, const unsigned int &viewport_id){
+    dlp::ReturnCode         ret;
+    dlp::Pattern::Sequence  patterns;
+    dlp::Capture::Sequence  captures;
+
+    ret = module->Setup(settings);
+    if(!ret.hasErrors()) ret = module->GeneratePatternSequence(&patterns);
+
+    if(ret.hasErrors()){
+        std::cout << name << ": could not generate the patterns: " << ret.ToString() << std::endl;
+        return false;
+    }
+
+    synthetic_scene::RenderCaptures(scene, patterns, &captures);
+
+    // Staged decoding through a full frame disparity map
+    dlp::DisparityMap   disparity;
+    dlp::Point::Cloud   staged_cloud;
+    dlp::Image          staged_depth;
+    double              staged_ms = 0;
+
+    for(unsigned int iRun = 0; iRun < iterations; iRun++){
+        dlp::Time::Chronograph timer(true);
+        ret = module->DecodeCaptureSequence(&captures, &disparity);
+        if(!ret.hasErrors()) ret = geometry->GeneratePointCloud(viewport_id, disparity, &staged_cloud, &staged_depth);
+        staged_ms += (double) timer.Lap();
+        if(ret.hasErrors()) break;
+    }
+
+    if(ret.hasErrors()){
+        std::cout << name << ": staged decoding failed: " << ret.ToString() << std::endl;
+        return false;
+    }
+
+    // Fused decoding and triangulation of each tile
+    dlp::Point::Cloud   fused_cloud;
+    dlp::Image          fused_depth;
+    double              fused_ms = 0;
+
+    for(unsigned int iRun = 0; iRun < iterations; iRun++){
+        dlp::Time::Chronograph timer(true);
+        ret = module->DecodeToPointCloud(&captures, geometry, viewport_id, &fused_cloud, &fused_depth);
+        fused_ms += (double) timer.Lap();
+        if(ret.hasErrors()) break;
+    }
+
+    if(ret.hasErrors()){
+        std::cout << name << ": fused decoding failed: " << ret.ToString() << std::endl;
+        return false;
+    }
+
+    staged_ms /= iterations;
+    fused_ms  /= iterations;
+
+    // Compare the matching points of both clouds
+    double max_difference = 0;
+    bool   match          = (staged_cloud.GetCount() == fused_cloud.GetCount());
+
+    for(unsigned long long iPoint = 0; match && (iPoint < staged_cloud.GetCount()); iPoint++){
+        dlp::Point staged;
+        dlp::Point fused;
+        staged_cloud.Get(iPoint, &staged);
+        fused_cloud.Get( iPoint, &fused);
+
+        double difference = sqrt(((staged.x - fused.x) * (staged.x - fused.x)) +
+                                 ((staged.y - fused.y) * (staged.y - fused.y)) +
+                                 ((staged.z - fused.z) * (staged.z - fused.z)));
+        max_difference = std::max(max_difference, difference);
+    }
+    match = match && (staged_cloud.GetCount() > 0) && (max_difference <= MATCH_TOLERANCE);
+
+    double megapixels = (FRAME_COLUMNS * FRAME_ROWS) / 1.0e6;
+
+    std::cout << name
+              << ": points = "  << staged_cloud.GetCount() << " / " << fused_cloud.GetCount()
+              << ", staged = "  << staged_ms << " ms (" << ((staged_ms > 0) ? megapixels * 1000.0 / staged_ms : 0.0) << " Mpixel/s)"
+              << ", fused = "   << fused_ms  << " ms (" << ((fused_ms  > 0) ? megapixels * 1000.0 / fused_ms  : 0.0) << " Mpixel/s)"
+              << ", speedup = " << ((fused_ms > 0) ? staged_ms / fused_ms : 0.0) << "x"
+              << ", max difference = " << max_difference << " mm"
+              << (match ? "" : " MISMATCH")
+              << std::endl;
+
+    return match;
+}
+
+int main(int argc, char *argv[])
+{
+    dlp::ReturnCode ret;
+    unsigned int    iterations = 5;
+
+    if(argc > 1) iterations = dlp::String::ToNumber<unsigned int>(argv[1]);
+    if(iterations == 0) iterations = 1;
+
+    // The projector and camera share the same resolution and focal length
+    synthetic_scene::Scene scene = synthetic_scene::TiltedPlane(FRAME_COLUMNS, FRAME_ROWS, FOCAL_LENGTH,
+                                                                FRAME_COLUMNS, FRAME_ROWS, FOCAL_LENGTH,
+                                                                CAMERA_BASELINE, PLANE_DISTANCE);
+
+    synthetic_scene::SaveCalibrations(scene, "fused_benchmark_projector_calibration.xml",
+                                             "fused_benchmark_camera_calibration.xml");
+
+    dlp::Calibration::Data projector_calibration;
+    dlp::Calibration::Data camera_calibration;
+    ret = projector_calibration.Load("fused_benchmark_projector_calibration.xml");
+    if(!ret.hasErrors()) ret = camera_calibration.Load("fused_benchmark_camera_calibration.xml");
+
+    // The fused path does NOT smooth the disparity, so smoothing is
+    // disabled for the staged path to compare the same points
+    dlp::Parameters geometry_settings;
+    dlp::Geometry   geometry;
+    unsigned int    viewport_id = 0;
+    geometry_settings.Set(dlp::Geometry::Parameters::SmoothDisparity(false));
+    geometry_settings.Set(dlp::Geometry::Parameters::GenerateOriginPlanesVertical(true));
+    geometry_settings.Set(dlp::Geometry::Parameters::GenerateOriginPlanesHorizontal(false));
+    geometry_settings.Set(dlp::Geometry::Parameters::GenerateOriginPlanesDiamondAngle1(false));
+    geometry_settings.Set(dlp::Geometry::Parameters::GenerateOriginPlanesDiamondAngle2(false));
+
+    if(!ret.hasErrors()) ret = geometry.Setup(geometry_settings);
+    if(!ret.hasErrors()) ret = geometry.SetOriginView(projector_calibration);
+    if(!ret.hasErrors()) ret = geometry.AddView(camera_calibration, &viewport_id);
+
+    if(ret.hasErrors()){
+        std::cout << "Could not set up the geometry: " << ret.ToString() << std::endl;
+        return 1;
+    }
+
+    dlp::Parameters settings;
+    settings.Set(dlp::StructuredLight::Parameters::PatternColor(dlp::Pattern::Color::WHITE));
+    settings.Set(dlp::StructuredLight::Parameters::PatternOrientation(dlp::Pattern::Orientation::VERTICAL));
+    settings.Set(dlp::StructuredLight::Parameters::PatternColumns(FRAME_COLUMNS));
+    settings.Set(dlp::StructuredLight::Parameters::PatternRows(FRAME_ROWS));
+
+    std::cout << "Decoding " << FRAME_COLUMNS << " x " << FRAME_ROWS
+              << " captures, average of " << iterations << " runs..." << std::endl;
+
+    // Gray code with integer and subpixel disparity
+    dlp::Parameters gray_code_settings = settings;
+    gray_code_settings.Set(dlp::GrayCode::Parameters::IncludeInverted(true));
+    gray_code_settings.Set(dlp::GrayCode::Parameters::SequenceCount(11));
+    gray_code_settings.Set(dlp::GrayCode::Parameters::PixelThreshold(5));
+
+    dlp::GrayCode gray_code;
+    bool passed = Compare("Gray code         ", &gray_code, gray_code_settings,
+                          scene, iterations, &geometry, viewport_id);
+
+    gray_code_settings.Set(dlp::GrayCode::Parameters::SubpixelSampling(16));
+    dlp::GrayCode gray_code_subpixel;
+    passed = Compare("Subpixel Gray code", &gray_code_subpixel, gray_code_settings,
+                     scene, iterations, &geometry, viewport_id) && passed;
+
+    // Three phase with hybrid Gray code unwrapping
+    dlp::Parameters three_phase_settings = settings;
+    three_phase_settings.Set(dlp::ThreePhase::Parameters::Bitdepth(dlp::Pattern::Bitdepth::MONO_8BPP));
+    three_phase_settings.Set(dlp::ThreePhase::Parameters::PixelsPerPeriod(32));
+    three_phase_settings.Set(dlp::ThreePhase::Parameters::UseHybridUnwrap(true));
+
+    dlp::ThreePhase three_phase;
+    passed = Compare("Three phase       ", &three_phase, three_phase_settings,
+                     scene, iterations, &geometry, viewport_id) && passed;
+
+    std::cout << (passed ? "PASS" : "FAIL") << ": staged and fused point clouds match" << std::endl;
+
+    return passed ? 0 : 1;
+}
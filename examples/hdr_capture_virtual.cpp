@@ -0,0 +1,249 @@
+/** @file   hdr_capture_virtual.cpp
+ *  @brief  Decodes Gray code captures of dark, matte, and shiny surfaces
+ *          at a single exposure and with multi-exposure fusion
+ *
+ *  Usage: hdr_capture_virtual
+ *
+ *  The virtual camera sees the virtual projector pixel for pixel, so every
+ *  decoded disparity should equal its camera column. The scene is split into
+ *  three horizontal bands. The dark band is below the decoding threshold at
+ *  the reference exposure and the ambient light on the shiny band saturates
+ *  the unlit pixels. The valid and correct pixels of each band are reported
+ *  for one exposure and for both \ref dlp::HdrCapture fusion methods.
+ *
+ *  The saturation level of 16-bit and Mono12 captures is checked last. The
+ *  program returns 1 if a step or a check fails.
+ */
+
+#include <dlp_sdk.hpp>
+
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#define DARK_REFLECTANCE    0.015
+#define MATTE_REFLECTANCE   0.8
+#define SHINY_REFLECTANCE   15.0
+#define AMBIENT_LIGHT       20.0    // Counts added to the projected light
+
+/** @brief Prints the valid and correct pixels of each band */
+void PrintBands(const std::string &name, dlp::DisparityMap disparity_map){
+    const std::string band_names[3] = {"dark", "matte", "shiny"};
+    unsigned int columns = 0;
+    unsigned int rows    = 0;
+    disparity_map.GetColumns(&columns);
+    disparity_map.GetRows(&rows);
+
+    std::cout << name << ":";
+
+    for(unsigned int iBand = 0; iBand < 3; iBand++){
+        unsigned long long pixels  = 0;
+        unsigned long long valid   = 0;
+        unsigned long long correct = 0;
+
+        for(     unsigned int yRow = iBand * rows / 3; yRow < (iBand + 1) * rows / 3; yRow++){
+            for( unsigned int xCol = 0; xCol < columns; xCol++){
+                int value;
+                disparity_map.Unsafe_GetPixel(xCol, yRow, &value);
+                pixels++;
+
+                if((value == dlp::DisparityMap::INVALID_PIXEL) || (value == dlp::DisparityMap::EMPTY_PIXEL)) continue;
+                valid++;
+                if(value == (int) xCol) correct++;
+            }
+        }
+
+        std::cout << " " << band_names[iBand]
+                  << " valid = "   << (100.0 * valid   / pixels) << "%"
+                  << " correct = " << (100.0 * correct / pixels) << "%"
+                  << ((iBand < 2) ? "," : "");
+    }
+
+    std::cout << std::endl;
+}
+
+/** @brief Fuses two exposures of two 16-bit captures and returns the second fused pixel
+ *  @param[in]  scale       Counts of the first pattern at the short exposure
+ *  @param[in]  maximum     Largest value the camera returns
+ */
+dlp::ReturnCode FuseDeepCaptures(const dlp::Parameters &settings, const unsigned int &scale,
+                                 const unsigned int &maximum, unsigned short *fused_value){
+    std::vector<float> exposures;
+    exposures.push_back(1.0);
+    exposures.push_back(10.0);
+
+    std::vector<dlp::Capture::Sequence> sequences(exposures.size());
+    for(unsigned int iExposure = 0; iExposure < exposures.size(); iExposure++){
+        for(unsigned int iPattern = 0; iPattern < 2; iPattern++){
+            unsigned int value = (unsigned int) (scale * (iPattern + 1) * exposures.at(iExposure));
+
+            dlp::Capture capture;
+            capture.data_type = dlp::Capture::DataType::IMAGE_DATA;
+            capture.image_data.Create(8, 8, dlp::Image::Format::MONO_USHORT);
+            capture.image_data.FillImage((unsigned short) std::min(value, maximum));
+            sequences.at(iExposure).Add(capture);
+        }
+    }
+
+    dlp::ReturnCode         ret;
+    dlp::HdrCapture         hdr_fusion;
+    dlp::Capture::Sequence  fused;
+    dlp::Capture            fused_capture;
+
+    ret = hdr_fusion.Setup(settings);
+    if(!ret.hasErrors()) ret = hdr_fusion.SetExposures(exposures);
+    if(!ret.hasErrors()) ret = hdr_fusion.Fuse(sequences, &fused);
+    if(!ret.hasErrors()) ret = fused.Get(1, &fused_capture);
+    if(!ret.hasErrors()) fused_capture.image_data.Unsafe_GetPixel(0, 0, fused_value);
+
+    return ret;
+}
+
+int main()
+{
+    dlp::ReturnCode             ret;
+    dlp::Parameters             settings;
+    dlp::Virtual_Projector      projector;
+    dlp::Virtual_Cam            camera;
+    dlp::GrayCode               gray_code;
+    dlp::Pattern::Sequence      sequence;
+
+    // Connect the virtual projector and the camera looking at it
+    projector.Connect("0");
+    camera.SetProjector(&projector);
+    camera.Connect("0");
+
+    settings.Set(dlp::Virtual_Cam::Parameters::Ambient(AMBIENT_LIGHT));
+    camera.Setup(settings);
+
+    // Generate and prepare the vertical Gray code patterns
+    settings.Clear();
+    settings.Set(dlp::StructuredLight::Parameters::PatternColor(dlp::Pattern::Color::WHITE));
+    settings.Set(dlp::StructuredLight::Parameters::PatternOrientation(dlp::Pattern::Orientation::VERTICAL));
+    settings.Set(dlp::GrayCode::Parameters::IncludeInverted(true));
+    settings.Set(dlp::GrayCode::Parameters::PixelThreshold(5));
+    settings.Set(dlp::GrayCode::Parameters::SequenceCount(10));
+
+    gray_code.SetDlpPlatform(projector);
+    ret = gray_code.Setup(settings);
+    if(!ret.hasErrors()) ret = gray_code.GeneratePatternSequence(&sequence);
+    if(!ret.hasErrors()) ret = projector.PreparePatternSequence(sequence);
+
+    if(ret.hasErrors()){
+        std::cout << "Could not prepare the patterns: " << ret.ToString() << std::endl;
+        return 1;
+    }
+
+    // Dark, matte, and shiny bands
+    unsigned int columns = 0;
+    unsigned int rows    = 0;
+    camera.GetColumns(&columns);
+    camera.GetRows(&rows);
+
+    dlp::Image reflectance;
+    reflectance.Create(columns, rows, dlp::Image::Format::MONO_FLOAT);
+    for(     unsigned int yRow = 0; yRow < rows;    yRow++){
+        for( unsigned int xCol = 0; xCol < columns; xCol++){
+            float value = MATTE_REFLECTANCE;
+            if(yRow <  rows / 3)       value = DARK_REFLECTANCE;
+            if(yRow >= 2 * rows / 3)   value = SHINY_REFLECTANCE;
+            reflectance.Unsafe_SetPixel(xCol, yRow, value);
+        }
+    }
+
+    ret = camera.SetReflectance(reflectance);
+    if(!ret.hasErrors()) ret = camera.Start();
+
+    if(ret.hasErrors()){
+        std::cout << "Could not start the camera: " << ret.ToString() << std::endl;
+        return 1;
+    }
+
+    unsigned int pattern_count = sequence.GetCount();
+    std::cout << "Capturing " << pattern_count << " patterns at " << columns << " x " << rows << "..." << std::endl;
+
+    // Single exposure at the reference shutter
+    dlp::Capture::Sequence  capture;
+    dlp::DisparityMap       disparity;
+
+    projector.StartPatternSequence(0, pattern_count, false);
+    ret = camera.GetCaptureSequence(pattern_count, &capture);
+    if(!ret.hasErrors()) ret = gray_code.DecodeCaptureSequence(&capture, &disparity);
+    if(ret.hasErrors()){
+        std::cout << "Single exposure failed: " << ret.ToString() << std::endl;
+        return 1;
+    }
+    PrintBands("Single exposure  ", disparity);
+
+    // Short, reference, and long exposures
+    std::vector<float> exposures;
+    exposures.push_back(1.0);
+    exposures.push_back(16.666);
+    exposures.push_back(100.0);
+
+    dlp::HdrCapture hdr_capture;
+    hdr_capture.SetCamera(&camera);
+    hdr_capture.SetDlpPlatform(&projector);
+    hdr_capture.SetExposures(exposures);
+
+    const dlp::HdrCapture::Fusion methods[2] = {dlp::HdrCapture::Fusion::BEST_CONTRAST,
+                                                dlp::HdrCapture::Fusion::RADIANCE_WEIGHTED};
+    const std::string method_names[2] = {"Best contrast    ", "Radiance weighted"};
+
+    // Radiance is fused into 16-bit captures but keeps the 8-bit units of
+    // the camera, so the Gray code threshold must NOT be scaled
+    dlp::Parameters decode_settings;
+    gray_code.GetSetup(&decode_settings);
+    decode_settings.Set(dlp::GrayCode::Parameters::CaptureBitDepth(8));
+    gray_code.Setup(decode_settings);
+
+    bool passed = true;
+    for(unsigned int iMethod = 0; iMethod < 2; iMethod++){
+        settings.Clear();
+        settings.Set(dlp::HdrCapture::Parameters::FusionMethod(methods[iMethod]));
+        hdr_capture.Setup(settings);
+
+        dlp::Time::Chronograph timer(true);
+        capture.Clear();
+        ret = hdr_capture.CaptureSequence(0, pattern_count, &capture);
+        double capture_ms = (double) timer.Lap();
+        if(!ret.hasErrors()) ret = gray_code.DecodeCaptureSequence(&capture, &disparity);
+
+        if(ret.hasErrors()){
+            std::cout << method_names[iMethod] << " failed: " << ret.ToString() << std::endl;
+            passed = false;
+            continue;
+        }
+
+        PrintBands(method_names[iMethod], disparity);
+        std::cout << "  capture and fusion of " << exposures.size() << " exposures = " << capture_ms << " ms" << std::endl;
+    }
+
+    // 16-bit captures do NOT tell how many bits the camera fills, so the
+    // saturation level or the capture bit depth must be given
+    unsigned short fused_value = 0;
+    settings.Clear();
+    settings.Set(dlp::HdrCapture::Parameters::FusionMethod(dlp::HdrCapture::Fusion::BEST_CONTRAST));
+    ret = FuseDeepCaptures(settings, 100, 65535, &fused_value);
+    bool check = ret.ContainsError(HDR_CAPTURE_SATURATION_LEVEL_MISSING);
+    std::cout << "16-bit fusion needs a saturation level: " << (check ? "PASS" : "FAIL") << std::endl;
+    passed = passed && check;
+
+    // 16-bit captures above the 8-bit saturation level must NOT be treated
+    // as saturated
+    settings.Set(dlp::HdrCapture::Parameters::CaptureBitDepth(16));
+    ret   = FuseDeepCaptures(settings, 100, 65535, &fused_value);
+    check = !ret.hasErrors() && (fused_value == 2000);
+    std::cout << "16-bit fusion keeps the long exposure: " << (check ? "PASS" : "FAIL") << std::endl;
+    passed = passed && check;
+
+    // Mono12 captures clip at 4095, far below a 16-bit saturation level
+    settings.Set(dlp::HdrCapture::Parameters::CaptureBitDepth(12));
+    ret   = FuseDeepCaptures(settings, 300, 4095, &fused_value);
+    check = !ret.hasErrors() && (fused_value == 600);
+    std::cout << "Mono12 fusion rejects the clipped long exposure: " << (check ? "PASS" : "FAIL") << std::endl;
+    passed = passed && check;
+
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,378 @@
+/** @file   incremental_calibration_benchmark.cpp
+ *  @brief  Calibrates a synthetic camera incrementally and compares the
+ *          convergence time and accuracy with calibrating from scratch
+ *
+ *  Usage: incremental_calibration_benchmark
+ *
+ *  Chessboards are rendered at random poses through a camera with known
+ *  intrinsic and distortion values. Two of the boards are seen through a
+ *  lens with different distortion so they do NOT fit the model.
+ *
+ *  The boards are added in two steps, calibrating after each. The outlier
+ *  boards are then found from the per board reprojection errors, removed,
+ *  and the camera is calibrated again. Each calibration is done with a warm
+ *  started module and a module calibrating from scratch, and the time and
+ *  the difference to the known values are reported. Finally two independent
+ *  modules are calibrated one after the other and concurrently.
+ *
+ *  The program returns 1 if a step fails, other boards than the outliers are
+ *  removed, or the calibration after removing them is NOT within tolerance.
+ */
+
+#include <dlp_sdk.hpp>
+
+#include <math.h>
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#define FRAME_COLUMNS   1024
+#define FRAME_ROWS      768
+
+#define FOCAL_LENGTH    1100.0
+#define CENTER_X        515.3
+#define CENTER_Y        380.7
+#define DISTORTION_K1   -0.18
+#define DISTORTION_K2    0.09
+#define OUTLIER_K1      -0.05   // Radial distortion of the lens the outlier boards are seen through
+
+#define FEATURE_COLUMNS 9
+#define FEATURE_ROWS    6
+#define SQUARE_SIZE     20.0    // mm
+
+#define FIRST_BOARDS    10      // Boards added before the first calibration
+#define TOTAL_BOARDS    18
+#define OUTLIER_BOARD_1 4
+#define OUTLIER_BOARD_2 13
+#define OUTLIER_RATIO   3.0
+
+#define RMS_TOLERANCE   0.5     // Largest RMS error without the outliers (px)
+#define FOCAL_TOLERANCE 5.0     // Largest focal length error without the outliers (px)
+
+#define NOISE_SIGMA     2.0     // Sensor noise in gray levels
+
+/** @brief Normalized camera ray of every 2x2 subsample of every pixel */
+struct RayTable{
+    std::vector<float> x;
+    std::vector<float> y;
+};
+
+/** @brief Removes the radial distortion of each subsample by fixed point iteration */
+void CreateRayTable(const double &k1, const double &k2, RayTable *table){
+    const unsigned int subsamples = FRAME_COLUMNS * FRAME_ROWS * 4;
+    table->x.resize(subsamples);
+    table->y.resize(subsamples);
+
+    dlp::Thread::ParallelFor(0, FRAME_ROWS, [&](unsigned long long first, unsigned long long last){
+        for(unsigned long long yRow = first; yRow < last; yRow++){
+            for(unsigned int xCol = 0; xCol < FRAME_COLUMNS; xCol++){
+                for(unsigned int iSample = 0; iSample < 4; iSample++){
+                    double x_distorted = (xCol + ((iSample % 2) ? 0.25 : -0.25) - CENTER_X) / FOCAL_LENGTH;
+                    double y_distorted = (yRow + ((iSample / 2) ? 0.25 : -0.25) - CENTER_Y) / FOCAL_LENGTH;
+                    double x = x_distorted;
+                    double y = y_distorted;
+
+                    for(unsigned int iIteration = 0; iIteration < 20; iIteration++){
+                        double r2 = (x * x) + (y * y);
+                        double radial = 1.0 + (k1 * r2) + (k2 * r2 * r2);
+                        x = x_distorted / radial;
+                        y = y_distorted / radial;
+                    }
+
+                    unsigned int iSubsample = (((yRow * FRAME_COLUMNS) + xCol) * 4) + iSample;
+                    table->x.at(iSubsample) = (float) x;
+                    table->y.at(iSubsample) = (float) y;
+                }
+            }
+        }
+    });
+}
+
+/** @brief Renders a chessboard matching \ref dlp::Calibration::Camera::GenerateCalibrationBoard()
+ *
+ *  The board lies in its own x-y plane with the first feature at the origin
+ *  and is moved into the camera frame by the rotation and translation.
+ */
+dlp::Image RenderBoard(const RayTable &rays, const cv::Mat &rotation, const cv::Mat &translation, std::mt19937 *generator){
+    std::normal_distribution<double> noise(0.0, NOISE_SIGMA);
+
+    cv::Mat normal   = rotation.col(2);
+    double  distance = normal.dot(translation);
+    cv::Mat rotation_transpose = rotation.t();
+
+    cv::Mat frame(FRAME_ROWS, FRAME_COLUMNS, CV_8UC1);
+
+    for(unsigned int yRow = 0; yRow < FRAME_ROWS; yRow++){
+        for(unsigned int xCol = 0; xCol < FRAME_COLUMNS; xCol++){
+            double intensity = 0;
+
+            for(unsigned int iSample = 0; iSample < 4; iSample++){
+                unsigned int iSubsample = (((yRow * FRAME_COLUMNS) + xCol) * 4) + iSample;
+                cv::Mat ray = (cv::Mat_<double>(3,1) << rays.x.at(iSubsample), rays.y.at(iSubsample), 1.0);
+
+                // Intersect the ray with the board plane
+                double  scale = distance / normal.dot(ray);
+                cv::Mat point = rotation_transpose * ((scale * ray) - translation);
+                double  x     = point.at<double>(0) / SQUARE_SIZE;
+                double  y     = point.at<double>(1) / SQUARE_SIZE;
+
+                // Squares span one square beyond the features and the board
+                // has a white margin of one more square
+                int square_column = (int) floor(x) + 1;
+                int square_row    = (int) floor(y) + 1;
+
+                if((scale <= 0) ||
+                   (square_column < -1) || (square_column > FEATURE_COLUMNS + 1) ||
+                   (square_row    < -1) || (square_row    > FEATURE_ROWS    + 1)){
+                    intensity += 90;    // Background
+                }
+                else if((square_column <  0) || (square_column > FEATURE_COLUMNS) ||
+                        (square_row    <  0) || (square_row    > FEATURE_ROWS)){
+                    intensity += 220;   // Margin
+                }
+                else{
+                    intensity += (((square_column + square_row) % 2) == 0) ? 30 : 220;
+                }
+            }
+
+            frame.at<unsigned char>(yRow, xCol) = cv::saturate_cast<unsigned char>((intensity / 4.0) + noise(*generator));
+        }
+    }
+
+    dlp::Image image;
+    image.Create(frame);
+    return image;
+}
+
+/** @brief Sets up a camera calibration module for the synthetic boards */
+dlp::ReturnCode SetupModule(const bool &warm_start, const unsigned int &boards_required, dlp::Calibration::Camera *module){
+    dlp::Parameters settings;
+    settings.Set(dlp::Calibration::Parameters::ModelColumns(FRAME_COLUMNS));
+    settings.Set(dlp::Calibration::Parameters::ModelRows(FRAME_ROWS));
+    settings.Set(dlp::Calibration::Parameters::ImageColumns(FRAME_COLUMNS));
+    settings.Set(dlp::Calibration::Parameters::ImageRows(FRAME_ROWS));
+    settings.Set(dlp::Calibration::Parameters::BoardCount(boards_required));
+    settings.Set(dlp::Calibration::Parameters::BoardFeatureColumns(FEATURE_COLUMNS));
+    settings.Set(dlp::Calibration::Parameters::BoardFeatureColumnDistance(SQUARE_SIZE));
+    settings.Set(dlp::Calibration::Parameters::BoardFeatureColumnDistancePixels(100));
+    settings.Set(dlp::Calibration::Parameters::BoardFeatureRows(FEATURE_ROWS));
+    settings.Set(dlp::Calibration::Parameters::BoardFeatureRowDistance(SQUARE_SIZE));
+    settings.Set(dlp::Calibration::Parameters::BoardFeatureRowDistancePixels(100));
+    settings.Set(dlp::Calibration::Parameters::SetTangentDistZero(false));
+    settings.Set(dlp::Calibration::Parameters::FixSixthOrderDist(true));
+    settings.Set(dlp::Calibration::Parameters::WarmStart(warm_start));
+    return module->Setup(settings);
+}
+
+/** @brief Calibrates a module and prints the time and the difference to the known values
+ *  @retval false   Calibration failed or is NOT within \ref RMS_TOLERANCE and \ref FOCAL_TOLERANCE
+ */
+bool Calibrate(const std::string &name, dlp::Calibration::Camera *module){
+    double reprojection_error = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    dlp::ReturnCode ret = module->Calibrate(&reprojection_error);
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    if(ret.hasErrors()){
+        std::cout << "  " << name << ": calibration failed: " << ret.ToString() << std::endl;
+        return false;
+    }
+
+    dlp::Calibration::Data data;
+    cv::Mat intrinsic, extrinsic, distortion;
+    double  error;
+    module->GetCalibrationData(&data);
+    data.GetData(&intrinsic, &extrinsic, &distortion, &error);
+
+    unsigned int boards, required;
+    module->GetCalibrationProgress(&boards, &required);
+
+    std::cout << "  " << name << ": " << std::setw(2) << boards << " boards, "
+              << std::setw(8) << ms << " ms, RMS error = " << reprojection_error << " px"
+              << ", focal error = "  << fabs(intrinsic.at<double>(0,0) - FOCAL_LENGTH) << " / " << fabs(intrinsic.at<double>(1,1) - FOCAL_LENGTH) << " px"
+              << ", center error = " << fabs(intrinsic.at<double>(0,2) - CENTER_X)     << " / " << fabs(intrinsic.at<double>(1,2) - CENTER_Y)     << " px"
+              << ", k1 error = "     << fabs(distortion.at<double>(0) - DISTORTION_K1)
+              << std::endl;
+
+    return (reprojection_error <= RMS_TOLERANCE) &&
+           (fabs(intrinsic.at<double>(0,0) - FOCAL_LENGTH) <= FOCAL_TOLERANCE) &&
+           (fabs(intrinsic.at<double>(1,1) - FOCAL_LENGTH) <= FOCAL_TOLERANCE);
+}
+
+int main()
+{
+    dlp::ReturnCode ret;
+    std::mt19937    generator(2016);
+
+    std::cout << std::fixed << std::setprecision(4);
+
+    // Render the boards at random poses
+    std::cout << "Rendering " << TOTAL_BOARDS << " boards of " << FRAME_COLUMNS << " x " << FRAME_ROWS << " pixels..." << std::endl;
+
+    RayTable rays;
+    RayTable outlier_rays;
+    CreateRayTable(DISTORTION_K1, DISTORTION_K2, &rays);
+    CreateRayTable(OUTLIER_K1,    DISTORTION_K2, &outlier_rays);
+
+    std::uniform_real_distribution<double> tilt(-0.5, 0.5);
+    std::uniform_real_distribution<double> offset_x(-140, 140);
+    std::uniform_real_distribution<double> offset_y(-90, 90);
+    std::uniform_real_distribution<double> depth(550, 700);
+
+    std::vector<cv::Mat>      rotations(TOTAL_BOARDS);
+    std::vector<cv::Mat>      translations(TOTAL_BOARDS);
+    std::vector<unsigned int> seeds(TOTAL_BOARDS);
+
+    for(unsigned int iBoard = 0; iBoard < TOTAL_BOARDS; iBoard++){
+        cv::Mat rvec   = (cv::Mat_<double>(3,1) << tilt(generator), tilt(generator), 0.2 * tilt(generator));
+        cv::Mat center = (cv::Mat_<double>(3,1) << offset_x(generator), offset_y(generator), depth(generator));
+        cv::Mat board_center = (cv::Mat_<double>(3,1) << SQUARE_SIZE * (FEATURE_COLUMNS - 1) / 2.0,
+                                                          SQUARE_SIZE * (FEATURE_ROWS    - 1) / 2.0, 0);
+        cv::Rodrigues(rvec, rotations.at(iBoard));
+        translations.at(iBoard) = center - (rotations.at(iBoard) * board_center);
+        seeds.at(iBoard)        = generator();
+    }
+
+    std::vector<dlp::Image> boards(TOTAL_BOARDS);
+    dlp::Thread::ParallelFor(0, TOTAL_BOARDS, [&](unsigned long long first, unsigned long long last){
+        for(unsigned long long iBoard = first; iBoard < last; iBoard++){
+            std::mt19937 board_generator(seeds.at(iBoard));
+            bool outlier = (iBoard == OUTLIER_BOARD_1) || (iBoard == OUTLIER_BOARD_2);
+            boards.at(iBoard) = RenderBoard(outlier ? outlier_rays : rays, rotations.at(iBoard), translations.at(iBoard), &board_generator);
+        }
+    });
+
+    std::vector<dlp::Image> first_boards(boards.begin(), boards.begin() + FIRST_BOARDS);
+    std::vector<dlp::Image> later_boards(boards.begin() + FIRST_BOARDS, boards.end());
+
+    // The warm started module and the module calibrating from scratch see the same boards
+    dlp::Calibration::Camera warm;
+    dlp::Calibration::Camera cold;
+    std::vector<bool>        found;
+
+    ret = SetupModule(true,  FIRST_BOARDS / 2, &warm);
+    if(!ret.hasErrors()) ret = SetupModule(false, FIRST_BOARDS / 2, &cold);
+    if(ret.hasErrors()){
+        std::cout << "Could not set up the calibration: " << ret.ToString() << std::endl;
+        return 1;
+    }
+
+    // Every board must be found so the board indices match the rendered boards
+    bool passed = true;
+    ret = warm.AddCalibrationBoards(first_boards, &found);
+    passed = passed && !ret.hasErrors() && (std::count(found.begin(), found.end(), true) == FIRST_BOARDS);
+    ret = cold.AddCalibrationBoards(first_boards, &found);
+    passed = passed && !ret.hasErrors() && (std::count(found.begin(), found.end(), true) == FIRST_BOARDS);
+    if(!passed){
+        std::cout << "Could not find every board" << std::endl;
+        return 1;
+    }
+
+    // The calibrations with the outliers only have to succeed
+    std::cout << "Step 1, first " << FIRST_BOARDS << " boards including outlier board " << OUTLIER_BOARD_1 << ":" << std::endl;
+    Calibrate("warm start", &warm);
+    Calibrate("scratch   ", &cold);
+    passed = passed && warm.isCalibrationComplete() && cold.isCalibrationComplete();
+
+    ret = warm.AddCalibrationBoards(later_boards, &found);
+    passed = passed && !ret.hasErrors() && (std::count(found.begin(), found.end(), true) == (TOTAL_BOARDS - FIRST_BOARDS));
+    ret = cold.AddCalibrationBoards(later_boards, &found);
+    passed = passed && !ret.hasErrors() && (std::count(found.begin(), found.end(), true) == (TOTAL_BOARDS - FIRST_BOARDS));
+    if(!passed){
+        std::cout << "Could not find every board or calibrate the first boards" << std::endl;
+        return 1;
+    }
+
+    std::cout << "Step 2, remaining boards added including outlier board " << OUTLIER_BOARD_2 << ":" << std::endl;
+    Calibrate("warm start", &warm);
+    Calibrate("scratch   ", &cold);
+    if(!warm.isCalibrationComplete() || !cold.isCalibrationComplete()){
+        std::cout << "Could not calibrate all boards" << std::endl;
+        return 1;
+    }
+
+    // Find the outliers from the board errors and remove them from both modules
+    std::vector<double>       board_errors;
+    std::vector<unsigned int> removed_boards;
+    ret = warm.GetBoardReprojectionErrors(&board_errors);
+    ret.Add(warm.RemoveOutlierBoards(OUTLIER_RATIO, &removed_boards));
+    if(ret.hasErrors()){
+        std::cout << "Could not remove the outlier boards: " << ret.ToString() << std::endl;
+        return 1;
+    }
+
+    std::cout << "Step 3, board errors =";
+    for(unsigned int iBoard = 0; iBoard < board_errors.size(); iBoard++) std::cout << " " << std::setprecision(2) << board_errors.at(iBoard);
+    std::cout << std::setprecision(4) << " px, removed boards =";
+    for(unsigned int iBoard = 0; iBoard < removed_boards.size(); iBoard++){
+        std::cout << " " << removed_boards.at(iBoard);
+        cold.RemoveCalibrationBoard(removed_boards.at(iBoard));
+    }
+    std::cout << std::endl;
+
+    // Exactly the two outlier boards must be removed
+    std::vector<unsigned int> expected_boards;
+    expected_boards.push_back(OUTLIER_BOARD_1);
+    expected_boards.push_back(OUTLIER_BOARD_2);
+    std::sort(removed_boards.begin(), removed_boards.end());
+    bool outliers_removed = (removed_boards == expected_boards);
+    std::cout << (outliers_removed ? "PASS" : "FAIL") << ": Removed boards are the outlier boards" << std::endl;
+
+    bool within_tolerance = Calibrate("warm start", &warm);
+    within_tolerance      = Calibrate("scratch   ", &cold) && within_tolerance;
+    std::cout << (within_tolerance ? "PASS" : "FAIL") << ": Calibration without the outliers is within tolerance" << std::endl;
+    passed = passed && outliers_removed && within_tolerance;
+
+    // Two independent modules calibrated one after the other and concurrently
+    std::vector<dlp::Image> clean_boards;
+    for(unsigned int iBoard = 0; iBoard < TOTAL_BOARDS; iBoard++){
+        if((iBoard != OUTLIER_BOARD_1) && (iBoard != OUTLIER_BOARD_2)) clean_boards.push_back(boards.at(iBoard));
+    }
+
+    dlp::Calibration::Camera first_camera;
+    dlp::Calibration::Camera second_camera;
+    ret = SetupModule(false, FIRST_BOARDS / 2, &first_camera);
+    ret.Add(SetupModule(false, FIRST_BOARDS / 2, &second_camera));
+    ret.Add(first_camera.AddCalibrationBoards(clean_boards,  &found));
+    ret.Add(second_camera.AddCalibrationBoards(clean_boards, &found));
+    if(ret.hasErrors()){
+        std::cout << "Could not set up the independent modules: " << ret.ToString() << std::endl;
+        return 1;
+    }
+
+    std::vector<dlp::Calibration::Camera*> modules;
+    modules.push_back(&first_camera);
+    modules.push_back(&second_camera);
+
+    std::vector<double> errors(modules.size());
+    auto start = std::chrono::steady_clock::now();
+    for(unsigned int iModule = 0; iModule < modules.size(); iModule++) ret.Add(modules.at(iModule)->Calibrate(&errors.at(iModule)));
+    double sequential_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    ret.Add(dlp::Calibration::Camera::CalibrateConcurrently(modules, &errors));
+    double concurrent_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    if(ret.hasErrors()){
+        std::cout << "Independent calibration failed: " << ret.ToString() << std::endl;
+        return 1;
+    }
+
+    std::cout << "Two independent modules: one after the other = " << sequential_ms << " ms"
+              << ", concurrently = " << concurrent_ms << " ms"
+              << ", RMS errors = " << errors.at(0) << " / " << errors.at(1) << " px" << std::endl;
+
+    // The same module listed twice must be rejected
+    modules.at(1) = &first_camera;
+    ret = dlp::Calibration::Camera::CalibrateConcurrently(modules, &errors);
+    bool rejected = ret.ContainsError(CALIBRATION_MODULE_LISTED_TWICE);
+    std::cout << (rejected ? "PASS" : "FAIL") << ": Module listed twice is rejected" << std::endl;
+    passed = passed && rejected;
+
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,257 @@
+/** @file   lcr3000_upload_emulator.cpp
+ *  @brief  Sends pattern images with dlp::LCr3000::PatternUploader to a
+ *          local TCP server which emulates the LightCrafter 3000 packet
+ *          protocol and checks every received payload
+ *
+ *  Usage: lcr3000_upload_emulator
+ *
+ *  The emulator reassembles the packets of each LCR_CMD_DefinePatternBMP()
+ *  command and checks the packet type, command ID, continuation flags,
+ *  length, and checksum. The payloads include images of exactly one and
+ *  two full packets. Each check prints PASS or FAIL and the program returns
+ *  the number of failures. No hardware is required.
+ */
+
+#include <dlp_sdk.hpp>
+#include <dlp_platforms/lightcrafter_3000/lcr3000.hpp>
+
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+/** @brief  Command ID of LCr3000::LCR_CMD_DefinePatternBMP() */
+static const unsigned int DEFINE_PATTERN_COMMAND = 0x0401;
+
+/** @brief Emulates the packet protocol of a LightCrafter 3000 on a loopback port */
+class Emulator{
+public:
+    /** @brief Opens the listening socket on a free loopback port */
+    Emulator() : acceptor_(io_service_, asio::ip::tcp::endpoint(asio::ip::address_v4::loopback(), 0)),
+                 socket_(io_service_){
+        this->drop_after_packets_ = 0;
+        this->busy_after_packets_ = 0;
+        this->packets_            = 0;
+    }
+
+    /** @brief Returns the port to connect to */
+    unsigned short GetPort() const{
+        return this->acceptor_.local_endpoint().port();
+    }
+
+    /** @brief  Closes the connection instead of answering packet number N (0 = never) */
+    void DropAfterPackets(const unsigned int &packets){
+        this->drop_after_packets_ = packets;
+    }
+
+    /** @brief  Answers packet number N with a busy response (0 = never) */
+    void BusyAfterPackets(const unsigned int &packets){
+        this->busy_after_packets_ = packets;
+    }
+
+    /** @brief Accepts one connection and answers packets on a background thread */
+    void Start(){
+        this->thread_ = std::thread([this](){ this->Run(); });
+    }
+
+    /** @brief Waits until the client has closed the connection */
+    void Join(){
+        if(this->thread_.joinable()) this->thread_.join();
+    }
+
+    std::vector<std::vector<unsigned char>> commands;   // Reassembled command payloads
+    std::vector<std::string>                errors;     // Protocol errors found in the packets
+
+private:
+    void Run(){
+        asio::error_code error;
+        this->acceptor_.accept(this->socket_, error);
+        if(error){
+            this->errors.push_back("Accept failed: " + error.message());
+            return;
+        }
+
+        std::vector<unsigned char> payload;
+        bool continued = false;
+
+        while(true){
+            unsigned char header[HEADER_SIZE];
+            asio::read(this->socket_, asio::buffer(header, HEADER_SIZE), error);
+            if(error) break;    // The client closed the connection
+
+            const unsigned int length = header[4] | (header[5] << 8);
+            std::vector<unsigned char> data(length + CHECKSUM_SIZE);
+            asio::read(this->socket_, asio::buffer(data), error);
+            if(error){
+                this->errors.push_back("Packet data read failed: " + error.message());
+                break;
+            }
+            this->packets_++;
+
+            unsigned int sum = 0;
+            for(unsigned int iByte = 0; iByte < HEADER_SIZE; iByte++) sum += header[iByte];
+            for(unsigned int iByte = 0; iByte < length; iByte++)      sum += data[iByte];
+
+            if(data[length] != (sum & 0xFF))
+                this->errors.push_back("Packet " + dlp::Number::ToString(this->packets_) + " checksum invalid");
+            if(header[0] != dlp::LCr3000::PKT_TYPE_WRITE)
+                this->errors.push_back("Packet " + dlp::Number::ToString(this->packets_) + " is NOT a write");
+            if(((header[1] << 8) | header[2]) != DEFINE_PATTERN_COMMAND)
+                this->errors.push_back("Packet " + dlp::Number::ToString(this->packets_) + " command ID invalid");
+            if((length == 0) || (length > MAX_PACKET_SIZE))
+                this->errors.push_back("Packet " + dlp::Number::ToString(this->packets_) + " length invalid");
+
+            // Flags: 0 complete, 1 first, 2 middle, 3 last
+            const unsigned char flag = header[3];
+            if((flag > 3) || (continued != ((flag == 2) || (flag == 3))))
+                this->errors.push_back("Packet " + dlp::Number::ToString(this->packets_) + " flag " +
+                                       dlp::Number::ToString((int) flag) + " out of order");
+            if(((flag == 1) || (flag == 2)) && (length != MAX_PACKET_SIZE))
+                this->errors.push_back("Packet " + dlp::Number::ToString(this->packets_) + " is continued but NOT full");
+
+            payload.insert(payload.end(), data.begin(), data.begin() + length);
+            continued = (flag == 1) || (flag == 2);
+            if(!continued){
+                this->commands.push_back(payload);
+                payload.clear();
+            }
+
+            if(this->packets_ == this->drop_after_packets_) break;
+
+            unsigned char response[HEADER_SIZE + CHECKSUM_SIZE] = {0};
+            response[0] = (this->packets_ == this->busy_after_packets_) ? dlp::LCr3000::PKT_TYPE_BUSY :
+                                                                          dlp::LCr3000::PKT_TYPE_WRITE_RESP;
+            response[1] = header[1];
+            response[2] = header[2];
+            response[HEADER_SIZE] = (response[0] + response[1] + response[2]) & 0xFF;
+
+            asio::write(this->socket_, asio::buffer(response), error);
+            if(error) break;
+        }
+
+        this->socket_.close(error);
+    }
+
+    asio::io_service        io_service_;
+    asio::ip::tcp::acceptor acceptor_;
+    asio::ip::tcp::socket   socket_;
+    std::thread             thread_;
+
+    unsigned int drop_after_packets_;
+    unsigned int busy_after_packets_;
+    unsigned int packets_;
+};
+
+/** @brief Returns a repeatable payload whose bytes depend on the image number */
+std::vector<unsigned char> CreateImage(const unsigned int &number, const unsigned long &size){
+    std::vector<unsigned char> image(size);
+    for(unsigned long iByte = 0; iByte < size; iByte++)
+        image[iByte] = ((iByte * 2654435761u) >> 24) ^ (number * 37);
+    return image;
+}
+
+/** @brief Sends the images through a PatternUploader connected to the emulator */
+dlp::ReturnCode Upload(Emulator *emulator, const std::vector<std::vector<unsigned char>> &images,
+                       unsigned long long *bytes_sent){
+    dlp::ReturnCode ret;
+
+    asio::io_service      io_service;
+    asio::ip::tcp::socket socket(io_service);
+
+    emulator->Start();
+
+    asio::error_code error;
+    socket.connect(asio::ip::tcp::endpoint(asio::ip::address_v4::loopback(), emulator->GetPort()), error);
+    if(error){
+        emulator->Join();
+        return ret.AddError(LCR3000_IMAGE_UPLOAD_FAILED);
+    }
+
+    {
+        dlp::LCr3000::PatternUploader uploader(io_service, &socket);
+        for(unsigned int iImage = 0; iImage < images.size(); iImage++)
+            uploader.Queue(iImage, images.at(iImage));
+
+        ret = uploader.Finish();
+        (*bytes_sent) = uploader.GetBytesSent();
+    }
+
+    socket.close(error);
+    emulator->Join();
+
+    return ret;
+}
+
+unsigned int failures = 0;
+
+void Check(const std::string &name, const bool &passed){
+    std::cout << (passed ? "PASS: " : "FAIL: ") << name << std::endl;
+    if(!passed) failures++;
+}
+
+int main()
+{
+    dlp::ReturnCode ret;
+
+    // The pattern number adds one byte to each payload
+    std::vector<std::vector<unsigned char>> images;
+    images.push_back(CreateImage(0, EIGHT_BPP_PTN_SIZE));
+    images.push_back(CreateImage(1, MAX_PACKET_SIZE - 1));
+    images.push_back(CreateImage(2, 2 * MAX_PACKET_SIZE - 1));
+    images.push_back(CreateImage(3, ONE_BPP_PTN_SIZE));
+    for(unsigned int iImage = 4; iImage < 12; iImage++)
+        images.push_back(CreateImage(iImage, TWO_BPP_PTN_SIZE));
+
+    // Every payload arrives complete and in order
+    {
+        Emulator emulator;
+        unsigned long long bytes_sent = 0;
+        ret = Upload(&emulator, images, &bytes_sent);
+
+        Check("Upload finishes without errors", !ret.hasErrors());
+        Check("Emulator found no protocol errors", emulator.errors.empty());
+        for(unsigned int iError = 0; iError < emulator.errors.size(); iError++)
+            std::cout << "      " << emulator.errors.at(iError) << std::endl;
+
+        Check("Emulator received every image", emulator.commands.size() == images.size());
+
+        unsigned long long expected_bytes = 0;
+        bool payloads_match = emulator.commands.size() == images.size();
+        for(unsigned int iImage = 0; payloads_match && (iImage < images.size()); iImage++){
+            const std::vector<unsigned char> &received = emulator.commands.at(iImage);
+            const std::vector<unsigned char> &image    = images.at(iImage);
+
+            payloads_match = (received.size() == image.size() + 1) &&
+                             (received.at(0) == iImage) &&
+                             std::equal(image.begin(), image.end(), received.begin() + 1);
+
+            unsigned long long packets = (image.size() + 1 + MAX_PACKET_SIZE - 1) / MAX_PACKET_SIZE;
+            expected_bytes += image.size() + 1 + packets * (HEADER_SIZE + CHECKSUM_SIZE);
+        }
+        Check("Payloads match the pattern number and image", payloads_match);
+        Check("Bytes sent equals the packet bytes (" + dlp::Number::ToString(bytes_sent) + ")",
+              bytes_sent == expected_bytes);
+    }
+
+    // A busy response rejects the upload
+    {
+        Emulator emulator;
+        emulator.BusyAfterPackets(3);
+        unsigned long long bytes_sent = 0;
+        ret = Upload(&emulator, images, &bytes_sent);
+        Check("Busy response fails the upload", ret.ContainsError(LCR3000_IMAGE_UPLOAD_FAILED));
+    }
+
+    // A dropped connection fails the upload instead of waiting forever
+    {
+        Emulator emulator;
+        emulator.DropAfterPackets(10);
+        unsigned long long bytes_sent = 0;
+        ret = Upload(&emulator, images, &bytes_sent);
+        Check("Dropped connection fails the upload", ret.ContainsError(LCR3000_IMAGE_UPLOAD_FAILED));
+    }
+
+    std::cout << failures << " failures" << std::endl;
+    return failures;
+}
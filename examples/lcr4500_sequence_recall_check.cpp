@@ -0,0 +1,149 @@
+/** @file   lcr4500_sequence_recall_check.cpp
+ *  @brief  Checks that stored LightCrafter 4500 sequences are created on the
+ *          host and that recalling the active sequence only restarts it
+ *
+ *  Usage: lcr4500_sequence_recall_check
+ *
+ *  Commands are sent to the loopback DLPC350 in dlpc350_loopback.hpp. The
+ *  check counts the lookup table uploads, the pattern configurations, and
+ *  the validations the simulated device receives. Each check prints PASS or
+ *  FAIL and the program returns the number of failures.
+ */
+
+#include <dlp_sdk.hpp>
+#include "dlpc350_loopback.hpp"
+
+#include <iostream>
+#include <string>
+
+unsigned int failures = 0;
+
+void Check(const std::string &name, const bool &passed, const dlp::ReturnCode &ret){
+    std::cout << (passed ? "PASS: " : "FAIL: ") << name << std::endl;
+    if(!passed){
+        if(ret.hasErrors()) std::cout << "      " << ret.ToString() << std::endl;
+        failures++;
+    }
+}
+
+/** @brief Number of lookup table writes the simulated DLPC350 has received */
+struct LutWrites{
+    LutWrites(){
+        unsigned char value;
+        this->entries     = dlpc350_loopback::GetWrites(dlpc350_loopback::COMMAND_MBOX_EXP_DATA,  &value);
+        this->configs     = dlpc350_loopback::GetWrites(dlpc350_loopback::COMMAND_EXP_PAT_CONFIG, &value);
+        this->validations = dlpc350_loopback::GetWrites(dlpc350_loopback::COMMAND_LUT_VALID,      &value);
+        this->starts      = dlpc350_loopback::GetWrites(dlpc350_loopback::COMMAND_PAT_START_STOP, &value);
+    }
+
+    /** @brief Returns true if no lookup table was uploaded or validated since the earlier count */
+    bool NoUploadSince(const LutWrites &earlier) const{
+        return (this->entries     == earlier.entries) &&
+               (this->configs     == earlier.configs) &&
+               (this->validations == earlier.validations);
+    }
+
+    /** @brief Returns true if a lookup table was uploaded and validated since the earlier count */
+    bool UploadSince(const LutWrites &earlier) const{
+        return (this->entries     > earlier.entries) &&
+               (this->configs     > earlier.configs) &&
+               (this->validations > earlier.validations);
+    }
+
+    unsigned long long entries;
+    unsigned long long configs;
+    unsigned long long validations;
+    unsigned long long starts;
+};
+
+int main()
+{
+    dlp::ReturnCode ret;
+    dlp::LCr4500    projector;
+    dlp::Parameters settings;
+
+    // The DLPC350 powers up in pattern sequence mode
+    dlpc350_loopback::Reset(0, 0, false);
+    dlpc350_loopback::SetRegister(dlpc350_loopback::COMMAND_DISP_MODE, std::vector<unsigned char>(1, dlp::LCr4500::OperatingMode::PATTERN_SEQUENCE));
+
+    projector.SetTransport(dlpc350_loopback::Write, dlpc350_loopback::Read);
+    ret = projector.Connect("0");
+    Check("connect to the simulated DLPC350", !ret.hasErrors(), ret);
+    if(ret.hasErrors()) return 1;
+
+    settings.Set(dlp::LCr4500::Parameters::ReadyTimeout(500));
+    ret = projector.Setup(settings);
+    Check("setup", !ret.hasErrors(), ret);
+    if(ret.hasErrors()) return 1;
+
+    // Sequence of patterns stored in three flash images, more than the
+    // DLPC350 buffers, so the image load times are checked before uploading
+    dlp::Pattern::Sequence sequence;
+    for(unsigned int iPattern = 0; iPattern < 6; iPattern++){
+        dlp::Pattern pattern;
+        pattern.data_type = dlp::Pattern::DataType::PARAMETERS;
+        pattern.bitdepth  = dlp::Pattern::Bitdepth::MONO_1BPP;
+        pattern.color     = dlp::Pattern::Color::WHITE;
+        pattern.exposure  = 10000;
+        pattern.period    = 10000;
+        pattern.parameters.Set(dlp::LCr4500::Parameters::PatternNumber(iPattern % 2));
+        pattern.parameters.Set(dlp::LCr4500::Parameters::PatternImageIndex(iPattern / 2));
+        sequence.Add(pattern);
+    }
+
+    ret = projector.PreparePatternSequence(sequence);
+    Check("prepare a flash image sequence", !ret.hasErrors(), ret);
+    if(ret.hasErrors()) return 1;
+
+    // Storing creates the lookup tables on the host only
+    unsigned int       preview_id = 0;
+    unsigned int       scan_id    = 0;
+    unsigned long long commands   = dlpc350_loopback::GetCommandCount();
+
+    ret = projector.StoreSequence(0, 1, true, &preview_id);
+    if(!ret.hasErrors()) ret = projector.StoreSequence(0, 6, false, &scan_id);
+    Check("store a preview and a scan sequence", !ret.hasErrors() && (preview_id != scan_id), ret);
+    Check("storing sends no commands to the DLPC350", dlpc350_loopback::GetCommandCount() == commands, ret);
+
+    // Storing a range again returns the same lookup table
+    unsigned int stored_again = scan_id + 1;
+    ret = projector.StoreSequence(0, 6, false, &stored_again);
+    Check("storing a range again returns its identifier without commands",
+          !ret.hasErrors() && (stored_again == scan_id) && (dlpc350_loopback::GetCommandCount() == commands), ret);
+
+    // The first recall uploads and validates the lookup table
+    LutWrites before_preview;
+    ret = projector.RecallSequence(preview_id);
+    LutWrites after_preview;
+    Check("first recall of the preview uploads and validates it", !ret.hasErrors() && after_preview.UploadSince(before_preview), ret);
+
+    // Recalling the active sequence only restarts it
+    ret = projector.RecallSequence(preview_id);
+    LutWrites after_preview_again;
+    Check("recalling the active preview skips the upload and validation",
+          !ret.hasErrors() && after_preview_again.NoUploadSince(after_preview) && (after_preview_again.starts > after_preview.starts), ret);
+
+    // Switching to the other sequence uploads it
+    ret = projector.RecallSequence(scan_id);
+    LutWrites after_scan;
+    Check("recalling the scan uploads and validates it", !ret.hasErrors() && after_scan.UploadSince(after_preview_again), ret);
+
+    ret = projector.RecallSequence(scan_id);
+    LutWrites after_scan_again;
+    Check("recalling the active scan skips the upload and validation", !ret.hasErrors() && after_scan_again.NoUploadSince(after_scan), ret);
+
+    // A prepared range started by index uses the stored lookup table
+    ret = projector.StartPatternSequence(0, 6, false);
+    LutWrites after_start;
+    Check("starting the active range by index skips the upload and validation", !ret.hasErrors() && after_start.NoUploadSince(after_scan_again), ret);
+
+    // Unknown identifiers are rejected
+    ret = projector.RecallSequence(scan_id + preview_id + 1);
+    Check("unknown sequence identifier is rejected", ret.ContainsError(LCR4500_SEQUENCE_ID_INVALID), ret);
+
+    projector.Disconnect();
+
+    std::cout << failures << " failures" << std::endl;
+
+    return failures;
+}
@@ -0,0 +1,110 @@
+/** @file   lcr4500_setup_benchmark.cpp
+ *  @brief  Times dlp::LCr4500::Setup() and dlp::Parameters file loading
+ *          with a large settings list
+ *
+ *  Usage: lcr4500_setup_benchmark [iterations] [other_entries]
+ *
+ *  The LightCrafter 4500 is replaced by the loopback DLPC350 in
+ *  dlpc350_loopback.hpp without latency, so the time is spent on the
+ *  settings lookups and on building the commands. The settings list also
+ *  holds entries of other modules, as a combined configuration file does.
+ */
+
+#include <dlp_sdk.hpp>
+#include "dlpc350_loopback.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <string>
+
+int main(int argc, char *argv[])
+{
+    dlp::ReturnCode ret;
+    dlp::LCr4500    projector;
+    dlp::Parameters settings;
+    unsigned int    iterations    = 1000;
+    unsigned int    other_entries = 300;
+
+    if(argc > 1) iterations    = dlp::String::ToNumber<unsigned int>(argv[1]);
+    if(argc > 2) other_entries = dlp::String::ToNumber<unsigned int>(argv[2]);
+
+    // Connect to the simulated DLPC350
+    dlpc350_loopback::Reset(0, 0, false);
+    projector.SetTransport(dlpc350_loopback::Write, dlpc350_loopback::Read);
+    ret = projector.Connect("0");
+    if(ret.hasErrors()){
+        std::cout << "Could not connect to the simulated DLPC350: " << ret.ToString() << std::endl;
+        return 1;
+    }
+
+    // Settings of other modules
+    for(unsigned int iEntry = 0; iEntry < other_entries; iEntry++){
+        settings.Set("OTHER_MODULE_PARAMETER_" + dlp::Number::ToString(iEntry), iEntry);
+    }
+
+    // LightCrafter 4500 settings which are sent to the DLPC350
+    settings.Set(dlp::LCr4500::Parameters::PowerStandyMode(dlp::LCr4500::PowerStandbyMode::NORMAL));
+    settings.Set(dlp::LCr4500::Parameters::ImageFlipShortAxis(dlp::LCr4500::ImageFlip::NORMAL));
+    settings.Set(dlp::LCr4500::Parameters::ImageFlipLongAxis(dlp::LCr4500::ImageFlip::NORMAL));
+    settings.Set(dlp::LCr4500::Parameters::LED_SequenceAutomatic(true));
+    settings.Set(dlp::LCr4500::Parameters::LED_InvertPWM(false));
+    settings.Set(dlp::LCr4500::Parameters::LED_CurrentRed(105));
+    settings.Set(dlp::LCr4500::Parameters::LED_CurrentGreen(134));
+    settings.Set(dlp::LCr4500::Parameters::LED_CurrentBlue(135));
+    settings.Set(dlp::LCr4500::Parameters::LED_DelayRisingRed(187));
+    settings.Set(dlp::LCr4500::Parameters::LED_DelayFallingRed(187));
+    settings.Set(dlp::LCr4500::Parameters::TriggerIn1Delay(0));
+    settings.Set(dlp::LCr4500::Parameters::TriggerOut1Invert(false));
+    settings.Set(dlp::LCr4500::Parameters::TriggerOut1DelayRising(187));
+    settings.Set(dlp::LCr4500::Parameters::TriggerOut2Invert(false));
+    settings.Set(dlp::LCr4500::Parameters::TriggerOut2DelayRising(187));
+    settings.Set(dlp::LCr4500::Parameters::ReadyTimeout(1000));
+
+    std::cout << "Settings list with " << settings.GetCount() << " entries" << std::endl;
+
+    // Time the setup
+    unsigned long long commands_start = dlpc350_loopback::GetCommandCount();
+    auto start = std::chrono::steady_clock::now();
+    for(unsigned int iSetup = 0; iSetup < iterations; iSetup++){
+        ret = projector.Setup(settings);
+        if(ret.hasErrors()){
+            std::cout << "Setup failed: " << ret.ToString() << std::endl;
+            projector.Disconnect();
+            return 1;
+        }
+    }
+    double setup_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "LCr4500::Setup():  " << iterations << " calls, " << setup_ms << " ms, "
+              << (setup_ms * 1000.0 / iterations) << " us per call, "
+              << ((dlpc350_loopback::GetCommandCount() - commands_start) / iterations) << " DLPC350 commands per call" << std::endl;
+
+    // Time loading the same list from a file
+    const std::string filename = "lcr4500_setup_benchmark_settings.txt";
+    ret = settings.Save(filename);
+    if(ret.hasErrors()){
+        std::cout << "Could not save the settings: " << ret.ToString() << std::endl;
+        projector.Disconnect();
+        return 1;
+    }
+
+    start = std::chrono::steady_clock::now();
+    for(unsigned int iLoad = 0; iLoad < iterations; iLoad++){
+        dlp::Parameters loaded;
+        ret = loaded.Load(filename);
+        if(ret.hasErrors() || ret.hasWarnings() || (loaded.GetCount() != settings.GetCount())){
+            std::cout << "Load failed: " << loaded.GetCount() << " of " << settings.GetCount()
+                      << " entries loaded " << ret.ToString() << std::endl;
+            projector.Disconnect();
+            return 1;
+        }
+    }
+    double load_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "Parameters::Load(): " << iterations << " calls, " << load_ms << " ms, "
+              << (load_ms * 1000.0 / iterations) << " us per call" << std::endl;
+
+    projector.Disconnect();
+
+    return 0;
+}
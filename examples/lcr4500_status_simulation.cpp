@@ -0,0 +1,216 @@
+/** @file   lcr4500_status_simulation.cpp
+ *  @brief  Runs the LightCrafter 4500 commands which wait for the DLPC350
+ *          against a simulated DLPC350 whose status changes a few polls
+ *          after each command
+ *
+ *  Usage: lcr4500_status_simulation
+ *
+ *  Commands are sent to the loopback DLPC350 in dlpc350_loopback.hpp and
+ *  the status is polled through dlp::LCr4500::SetStatusReader(). Each check
+ *  prints PASS or FAIL and the program returns the number of failures.
+ */
+
+#include <dlp_sdk.hpp>
+#include "dlpc350_loopback.hpp"
+
+#include <iostream>
+#include <string>
+
+/** @brief Follows the writes of one command and applies the last value once enough polls have passed */
+struct SimulatedRegister{
+    SimulatedRegister(const unsigned short &command, const unsigned char &initial){
+        this->command   = command;
+        this->writes    = 0;
+        this->value     = initial;
+        this->effective = initial;
+        this->polls     = 0;
+    }
+
+    /** @brief Returns the value the DLPC350 reports at this poll */
+    unsigned char Poll(const unsigned int &settle_polls){
+        unsigned char      written = 0;
+        unsigned long long writes  = dlpc350_loopback::GetWrites(this->command, &written);
+
+        if(writes != this->writes){
+            this->writes = writes;
+            this->value  = written;
+            this->polls  = 0;
+        }
+        else{
+            this->polls++;
+        }
+
+        if(this->polls >= settle_polls) this->effective = this->value;
+
+        return this->effective;
+    }
+
+    /** @brief Returns true once the last write has taken effect */
+    bool Settled(const unsigned int &settle_polls) const{
+        return this->polls >= settle_polls;
+    }
+
+    unsigned short     command;
+    unsigned long long writes;
+    unsigned char      value;
+    unsigned char      effective;
+    unsigned int       polls;
+};
+
+/** @brief Simulated DLPC350 status */
+struct Simulation{
+    Simulation() : source(dlpc350_loopback::COMMAND_SOURCE_SEL, 0),
+                   mode(dlpc350_loopback::COMMAND_DISP_MODE, dlp::LCr4500::OperatingMode::PATTERN_SEQUENCE),
+                   start_stop(dlpc350_loopback::COMMAND_PAT_START_STOP, dlp::LCr4500::Pattern::DisplayControl::STOP),
+                   validate(dlpc350_loopback::COMMAND_LUT_VALID, 0){
+        this->settle_polls = 3;
+        this->initialized  = true;
+        this->read_fails   = false;
+        this->finish_early = false;
+        this->polls        = 0;
+    }
+
+    unsigned int        settle_polls;   // Polls until a command has taken effect
+    bool                initialized;    // Hardware status reports that initialization finished
+    bool                read_fails;     // Every status read fails
+    bool                finish_early;   // A started sequence has finished before the first poll
+    unsigned long long  polls;
+
+    SimulatedRegister   source;
+    SimulatedRegister   mode;
+    SimulatedRegister   start_stop;
+    SimulatedRegister   validate;
+};
+
+Simulation simulation;
+
+dlp::LCr4500::StatusReader CreateStatusReader(){
+    dlp::LCr4500::StatusReader reader;
+
+    reader.GetStatus = [](unsigned char *hardware, unsigned char *system, unsigned char *main) -> int {
+        simulation.polls++;
+        if(simulation.read_fails) return -1;
+
+        // The DLPC350 is busy while the input source changes
+        simulation.source.Poll(simulation.settle_polls);
+        bool ready   = simulation.initialized && simulation.source.Settled(simulation.settle_polls);
+        bool running = (simulation.start_stop.Poll(simulation.settle_polls) == dlp::LCr4500::Pattern::DisplayControl::START) &&
+                       !simulation.finish_early;
+
+        (*hardware) = ready   ? 0x01 : 0x00;
+        (*system)   = 0x01;
+        (*main)     = running ? 0x02 : 0x00;
+        return 0;
+    };
+
+    reader.GetMode = [](bool *mode) -> int {
+        simulation.polls++;
+        if(simulation.read_fails) return -1;
+
+        (*mode) = (simulation.mode.Poll(simulation.settle_polls) == dlp::LCr4500::OperatingMode::PATTERN_SEQUENCE);
+        return 0;
+    };
+
+    reader.CheckPatLutValidate = [](bool *ready, unsigned int *status) -> int {
+        simulation.polls++;
+        if(simulation.read_fails) return -1;
+
+        simulation.validate.Poll(simulation.settle_polls);
+        (*ready)  = simulation.validate.Settled(simulation.settle_polls);
+        (*status) = 0;
+        return 0;
+    };
+
+    return reader;
+}
+
+unsigned int failures = 0;
+
+void Check(const std::string &name, const bool &passed, const dlp::ReturnCode &ret){
+    std::cout << (passed ? "PASS: " : "FAIL: ") << name
+              << " (" << simulation.polls << " polls)" << std::endl;
+    if(!passed){
+        std::cout << "      " << ret.ToString() << std::endl;
+        failures++;
+    }
+    simulation.polls = 0;
+}
+
+bool ContainsError(const dlp::ReturnCode &ret, const std::string &error){
+    return ret.ToString().find(error) != std::string::npos;
+}
+
+int main()
+{
+    dlp::ReturnCode ret;
+    dlp::LCr4500    projector;
+    dlp::Parameters settings;
+
+    // The DLPC350 powers up in pattern sequence mode
+    dlpc350_loopback::Reset(0, 0, false);
+    dlpc350_loopback::SetRegister(dlpc350_loopback::COMMAND_DISP_MODE, std::vector<unsigned char>(1, dlp::LCr4500::OperatingMode::PATTERN_SEQUENCE));
+
+    projector.SetTransport(dlpc350_loopback::Write, dlpc350_loopback::Read);
+    projector.SetStatusReader(CreateStatusReader());
+
+    ret = projector.Connect("0");
+    Check("connect to the simulated DLPC350", !ret.hasErrors(), ret);
+
+    // Switching to the test pattern changes the mode and the input source
+    settings.Set(dlp::LCr4500::Parameters::ReadyTimeout(500));
+    settings.Set(dlp::LCr4500::Parameters::VideoTestPattern(dlp::LCr4500::Video::TestPattern::CHECKERBOARD));
+    ret = projector.Setup(settings);
+    Check("setup waits for video mode and the input source", !ret.hasErrors(), ret);
+
+    // Sequence of patterns stored in flash
+    dlp::Pattern::Sequence sequence;
+    for(unsigned int iPattern = 0; iPattern < 3; iPattern++){
+        dlp::Pattern pattern;
+        pattern.data_type = dlp::Pattern::DataType::PARAMETERS;
+        pattern.bitdepth  = dlp::Pattern::Bitdepth::MONO_1BPP;
+        pattern.color     = dlp::Pattern::Color::WHITE;
+        pattern.exposure  = 10000;
+        pattern.period    = 10000;
+        pattern.parameters.Set(dlp::LCr4500::Parameters::PatternNumber(iPattern));
+        pattern.parameters.Set(dlp::LCr4500::Parameters::PatternImageIndex(0));
+        sequence.Add(pattern);
+    }
+
+    ret = projector.PreparePatternSequence(sequence);
+    Check("prepare a flash image sequence", !ret.hasErrors(), ret);
+
+    ret = projector.StartPatternSequence(0, 3, true);
+    Check("repeating sequence waits for validation and for the sequencer to run", !ret.hasErrors(), ret);
+
+    ret = projector.StopPatternSequence();
+    Check("stop waits for the sequencer to stop", !ret.hasErrors(), ret);
+
+    // A short sequence which does NOT repeat has stopped before it is polled
+    simulation.finish_early = true;
+    ret = projector.StartPatternSequence(0, 1, false);
+    Check("non-repeating sequence which finished early", !ret.hasErrors(), ret);
+    simulation.finish_early = false;
+
+    // A DLPC350 which does NOT become ready
+    settings.Clear();
+    settings.Set(dlp::LCr4500::Parameters::ReadyTimeout(50));
+    projector.Setup(settings);
+
+    simulation.initialized = false;
+    settings.Set(dlp::LCr4500::Parameters::VideoTestPattern(dlp::LCr4500::Video::TestPattern::CHECKERBOARD));
+    ret = projector.Setup(settings);
+    Check("ready timeout is reported", ContainsError(ret, LCR4500_READY_TIMEOUT), ret);
+    simulation.initialized = true;
+
+    // Status which can NOT be read
+    simulation.read_fails = true;
+    ret = projector.StopPatternSequence();
+    Check("status read failure is reported", ContainsError(ret, LCR4500_GET_STATUS_FAILED), ret);
+    simulation.read_fails = false;
+
+    projector.Disconnect();
+
+    std::cout << failures << " checks failed" << std::endl;
+
+    return failures;
+}
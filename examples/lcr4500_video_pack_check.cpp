@@ -0,0 +1,180 @@
+/** @file   lcr4500_video_pack_check.cpp
+ *  @brief  Packs a pattern sequence into LightCrafter 4500 video frames,
+ *          unpacks the frames and compares every pattern with its source
+ *
+ *  Usage: lcr4500_video_pack_check
+ *
+ *  The sequence mixes monochrome and RGB patterns of several bit depths so
+ *  patterns share frames and new frames are started part way through. The
+ *  source images use the full 0 to 255 range, so the unpacked pixels must
+ *  equal the source pixels clamped to the maximum of each bit depth. Each
+ *  check prints PASS or FAIL and the program returns the number of failures.
+ *  No hardware is required.
+ */
+
+#include <dlp_sdk.hpp>
+
+#include <iostream>
+#include <string>
+
+unsigned int failures = 0;
+
+void Check(const std::string &name, const bool &passed, const dlp::ReturnCode &ret){
+    std::cout << (passed ? "PASS: " : "FAIL: ") << name << std::endl;
+    if(!passed){
+        if(ret.hasErrors()) std::cout << "      " << ret.ToString() << std::endl;
+        failures++;
+    }
+}
+
+/** @brief Returns a repeatable pixel value which covers the full 0 to 255 range */
+unsigned char SourcePixel(const unsigned int &id, const unsigned int &channel,
+                          const unsigned int &xCol, const unsigned int &yRow){
+    unsigned int value = (xCol * 7919) ^ (yRow * 104729) ^ (id * 31) ^ (channel * 97);
+    value = value * 2654435761u;
+    return (value >> 24) & 0xFF;
+}
+
+/** @brief Returns the number of bits per channel of a pattern bit depth */
+unsigned int ChannelBits(const dlp::Pattern::Bitdepth &bitdepth){
+    switch(bitdepth){
+    case dlp::Pattern::Bitdepth::MONO_1BPP: return 1;
+    case dlp::Pattern::Bitdepth::MONO_2BPP: return 2;
+    case dlp::Pattern::Bitdepth::MONO_3BPP: return 3;
+    case dlp::Pattern::Bitdepth::MONO_4BPP: return 4;
+    case dlp::Pattern::Bitdepth::MONO_5BPP: return 5;
+    case dlp::Pattern::Bitdepth::MONO_6BPP: return 6;
+    case dlp::Pattern::Bitdepth::MONO_7BPP: return 7;
+    case dlp::Pattern::Bitdepth::MONO_8BPP: return 8;
+    case dlp::Pattern::Bitdepth::RGB_3BPP:  return 1;
+    case dlp::Pattern::Bitdepth::RGB_6BPP:  return 2;
+    case dlp::Pattern::Bitdepth::RGB_9BPP:  return 3;
+    case dlp::Pattern::Bitdepth::RGB_12BPP: return 4;
+    case dlp::Pattern::Bitdepth::RGB_15BPP: return 5;
+    case dlp::Pattern::Bitdepth::RGB_18BPP: return 6;
+    case dlp::Pattern::Bitdepth::RGB_21BPP: return 7;
+    case dlp::Pattern::Bitdepth::RGB_24BPP: return 8;
+    default:                                return 0;
+    }
+}
+
+/** @brief Adds an image pattern filled with \ref SourcePixel() values */
+void AddPattern(const dlp::Pattern::Bitdepth &bitdepth, const dlp::Pattern::Color &color,
+                const unsigned int &columns, const unsigned int &rows,
+                dlp::Pattern::Sequence *sequence){
+    const unsigned int channels = (color == dlp::Pattern::Color::RGB) ? 3 : 1;
+
+    dlp::Pattern pattern;
+    pattern.id        = sequence->GetCount();
+    pattern.bitdepth  = bitdepth;
+    pattern.color     = color;
+    pattern.exposure  = 10000;
+    pattern.period    = 10000;
+    pattern.data_type = dlp::Pattern::DataType::IMAGE_DATA;
+    pattern.image_data.Create(columns, rows, (channels == 3) ? dlp::Image::Format::RGB_UCHAR :
+                                                               dlp::Image::Format::MONO_UCHAR);
+
+    cv::Mat data;
+    pattern.image_data.Unsafe_GetOpenCVData(&data);
+    for(unsigned int yRow = 0; yRow < rows; yRow++){
+        unsigned char *pixel = data.ptr<unsigned char>(yRow);
+        for(unsigned int xCol = 0; xCol < columns; xCol++){
+            for(unsigned int iChannel = 0; iChannel < channels; iChannel++){
+                pixel[channels*xCol + iChannel] = SourcePixel(pattern.id, iChannel, xCol, yRow);
+            }
+        }
+    }
+
+    sequence->Add(pattern);
+}
+
+/** @brief Returns the number of pixels which differ from the clamped source values */
+unsigned long long CountMismatches(const dlp::Pattern &source, const dlp::Pattern &unpacked,
+                                   const unsigned int &columns, const unsigned int &rows){
+    const unsigned int channels  = (source.color == dlp::Pattern::Color::RGB) ? 3 : 1;
+    const unsigned int max_value = (1 << ChannelBits(source.bitdepth)) - 1;
+
+    dlp::Image image = unpacked.image_data;
+    cv::Mat    data;
+    image.Unsafe_GetOpenCVData(&data);
+    if((data.cols != (int) columns) || (data.rows != (int) rows) || (data.channels() != (int) channels))
+        return (unsigned long long) columns * rows;
+
+    unsigned long long mismatches = 0;
+    for(unsigned int yRow = 0; yRow < rows; yRow++){
+        const unsigned char *pixel = data.ptr<unsigned char>(yRow);
+        for(unsigned int xCol = 0; xCol < columns; xCol++){
+            for(unsigned int iChannel = 0; iChannel < channels; iChannel++){
+                unsigned int expected = SourcePixel(source.id, iChannel, xCol, yRow);
+                if(expected > max_value) expected = max_value;
+                if(pixel[channels*xCol + iChannel] != expected) mismatches++;
+            }
+        }
+    }
+
+    return mismatches;
+}
+
+int main()
+{
+    dlp::ReturnCode ret;
+
+    const unsigned int columns = 912;
+    const unsigned int rows    = 1140;
+
+    // Patterns share frames until one does not fit and a new frame starts
+    dlp::Pattern::Sequence source;
+    for(unsigned int iPat = 0; iPat < 5; iPat++)
+        AddPattern(dlp::Pattern::Bitdepth::MONO_1BPP, dlp::Pattern::Color::WHITE, columns, rows, &source);
+    AddPattern(dlp::Pattern::Bitdepth::MONO_2BPP,  dlp::Pattern::Color::WHITE, columns, rows, &source);
+    AddPattern(dlp::Pattern::Bitdepth::RGB_6BPP,   dlp::Pattern::Color::RGB,   columns, rows, &source);
+    AddPattern(dlp::Pattern::Bitdepth::MONO_8BPP,  dlp::Pattern::Color::WHITE, columns, rows, &source);
+    AddPattern(dlp::Pattern::Bitdepth::MONO_8BPP,  dlp::Pattern::Color::WHITE, columns, rows, &source);
+    AddPattern(dlp::Pattern::Bitdepth::RGB_24BPP,  dlp::Pattern::Color::RGB,   columns, rows, &source);
+    AddPattern(dlp::Pattern::Bitdepth::MONO_5BPP,  dlp::Pattern::Color::WHITE, columns, rows, &source);
+    AddPattern(dlp::Pattern::Bitdepth::RGB_12BPP,  dlp::Pattern::Color::RGB,   columns, rows, &source);
+    AddPattern(dlp::Pattern::Bitdepth::MONO_7BPP,  dlp::Pattern::Color::WHITE, columns, rows, &source);
+    AddPattern(dlp::Pattern::Bitdepth::MONO_3BPP,  dlp::Pattern::Color::WHITE, columns, rows, &source);
+
+    std::vector<dlp::Image> frames;
+    dlp::Pattern::Sequence  frame_sequence;
+    ret = dlp::LCr4500::PackVideoFrames(source, columns, rows, &frames, &frame_sequence);
+    Check("PackVideoFrames", !ret.hasErrors(), ret);
+    if(ret.hasErrors()) return failures;
+
+    std::cout << "      " << source.GetCount() << " patterns packed into " << frames.size() << " frames" << std::endl;
+    Check("Frame sequence has one entry per pattern", frame_sequence.GetCount() == source.GetCount(), ret);
+    Check("Patterns were split across several frames", frames.size() > 1, ret);
+
+    dlp::Pattern::Sequence unpacked;
+    ret = dlp::LCr4500::UnpackVideoFrames(frames, frame_sequence, &unpacked);
+    Check("UnpackVideoFrames", !ret.hasErrors(), ret);
+    if(ret.hasErrors()) return failures;
+
+    Check("Unpacked sequence has one entry per pattern", unpacked.GetCount() == source.GetCount(), ret);
+
+    for(unsigned int iPat = 0; (iPat < source.GetCount()) && (iPat < unpacked.GetCount()); iPat++){
+        dlp::Pattern source_pattern;
+        dlp::Pattern unpacked_pattern;
+        source.Get(iPat, &source_pattern);
+        unpacked.Get(iPat, &unpacked_pattern);
+
+        unsigned long long mismatches = CountMismatches(source_pattern, unpacked_pattern, columns, rows);
+
+        Check("Pattern " + dlp::Number::ToString(iPat) + " matches its clamped source (" +
+              dlp::Number::ToString(mismatches) + " mismatched values)",
+              (mismatches == 0) &&
+              (unpacked_pattern.bitdepth == source_pattern.bitdepth) &&
+              (unpacked_pattern.color    == source_pattern.color), ret);
+    }
+
+    // A frame which is NOT columns x rows must be rejected
+    dlp::Pattern::Sequence wrong_size;
+    AddPattern(dlp::Pattern::Bitdepth::MONO_1BPP, dlp::Pattern::Color::WHITE, columns / 2, rows, &wrong_size);
+    ret = dlp::LCr4500::PackVideoFrames(wrong_size, columns, rows, &frames, &frame_sequence);
+    Check("Pattern with the wrong resolution is rejected",
+          ret.ToString().find(LCR4500_IMAGE_RESOLUTION_INVALID) != std::string::npos, dlp::ReturnCode());
+
+    std::cout << failures << " failures" << std::endl;
+    return failures;
+}
@@ -0,0 +1,162 @@
+/** @file   multi_view_merge_check.cpp
+ *  @brief  Checks that merging the point clouds of several view ports only
+ *          removes duplicate points where the views overlap
+ *
+ *  Usage: multi_view_merge_check
+ *
+ *  Vertical and horizontal Gray code patterns are rendered onto a tilted
+ *  plane and decoded. The same camera is added twice to \ref dlp::Geometry so
+ *  both view ports see the same points. With disjoint regions of interest the
+ *  views do NOT overlap and the merge must keep every point. Without regions
+ *  every point is seen by both views and the merge must keep the points of
+ *  the first view port only. Each check prints PASS or FAIL and the program
+ *  returns the number of failures.
+ */
+
+#include <dlp_sdk.hpp>
+
+#include "synthetic_scene.hpp"
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#define PROJECTOR_COLUMNS   640
+#define PROJECTOR_ROWS      480
+#define PROJECTOR_FOCAL     800.0
+
+#define CAMERA_COLUMNS      640
+#define CAMERA_ROWS         480
+#define CAMERA_FOCAL        900.0
+
+#define CAMERA_BASELINE     150.0   // Camera is placed to the right of the projector (mm)
+#define PLANE_DISTANCE      600.0   // Distance from the projector to the plane along its optical axis (mm)
+#define MERGE_VOXEL_SIZE    2.0     // About three camera pixels on the plane (mm)
+
+#define REGION_COLUMNS      280     // Columns of each region, leaving a gap of 80 columns between them
+
+unsigned int failures = 0;
+
+void Check(const std::string &name, const bool &passed, const dlp::ReturnCode &ret){
+    std::cout << (passed ? "PASS: " : "FAIL: ") << name << std::endl;
+    if(!passed){
+        if(ret.hasErrors()) std::cout << "      " << ret.ToString() << std::endl;
+        failures++;
+    }
+}
+
+/** @brief Renders and decodes the Gray code patterns of one orientation */
+dlp::ReturnCode Decode(const synthetic_scene::Scene &scene, const dlp::Pattern::Orientation &orientation,
+                       dlp::DisparityMap *disparity){
+    dlp::ReturnCode         ret;
+    dlp::Parameters         settings;
+    dlp::GrayCode           gray_code;
+    dlp::Pattern::Sequence  patterns;
+    dlp::Capture::Sequence  captures;
+
+    settings.Set(dlp::StructuredLight::Parameters::PatternColor(dlp::Pattern::Color::WHITE));
+    settings.Set(dlp::StructuredLight::Parameters::PatternOrientation(orientation));
+    settings.Set(dlp::StructuredLight::Parameters::PatternColumns(PROJECTOR_COLUMNS));
+    settings.Set(dlp::StructuredLight::Parameters::PatternRows(PROJECTOR_ROWS));
+    settings.Set(dlp::GrayCode::Parameters::IncludeInverted(true));
+    settings.Set(dlp::GrayCode::Parameters::SequenceCount(9));
+    settings.Set(dlp::GrayCode::Parameters::PixelThreshold(5));
+
+    ret = gray_code.Setup(settings);
+    if(!ret.hasErrors()) ret = gray_code.GeneratePatternSequence(&patterns);
+    if(ret.hasErrors()) return ret;
+
+    synthetic_scene::RenderCaptures(scene, patterns, &captures);
+    return gray_code.DecodeCaptureSequence(&captures, disparity);
+}
+
+/** @brief Counts the points triangulated from a view port */
+unsigned long long CountView(const std::vector<dlp::Geometry::PointSource> &sources, const unsigned int &viewport_id){
+    unsigned long long count = 0;
+    for(unsigned long long iPoint = 0; iPoint < sources.size(); iPoint++){
+        if(sources.at(iPoint).viewport_id == viewport_id) count++;
+    }
+    return count;
+}
+
+int main()
+{
+    dlp::ReturnCode ret;
+
+    synthetic_scene::Scene scene = synthetic_scene::TiltedPlane(PROJECTOR_COLUMNS, PROJECTOR_ROWS, PROJECTOR_FOCAL,
+                                                                CAMERA_COLUMNS,    CAMERA_ROWS,    CAMERA_FOCAL,
+                                                                CAMERA_BASELINE,   PLANE_DISTANCE);
+
+    synthetic_scene::SaveCalibrations(scene, "multi_view_projector_calibration.xml",
+                                             "multi_view_camera_calibration.xml");
+
+    dlp::Calibration::Data projector_calibration;
+    dlp::Calibration::Data camera_calibration;
+    ret = projector_calibration.Load("multi_view_projector_calibration.xml");
+    if(!ret.hasErrors()) ret = camera_calibration.Load("multi_view_camera_calibration.xml");
+
+    // The same camera is both view ports
+    dlp::Geometry   geometry;
+    unsigned int    viewport_id = 0;
+    if(!ret.hasErrors()) ret = geometry.SetOriginView(projector_calibration);
+    if(!ret.hasErrors()) ret = geometry.AddView(camera_calibration, &viewport_id);
+    if(!ret.hasErrors()) ret = geometry.AddView(camera_calibration, &viewport_id);
+
+    Check("Geometry is set up with two view ports", !ret.hasErrors(), ret);
+    if(ret.hasErrors()) return failures;
+
+    dlp::DisparityMap vertical;
+    dlp::DisparityMap horizontal;
+    ret = Decode(scene, dlp::Pattern::Orientation::VERTICAL, &vertical);
+    if(!ret.hasErrors()) ret = Decode(scene, dlp::Pattern::Orientation::HORIZONTAL, &horizontal);
+
+    Check("Captures of both orientations are decoded", !ret.hasErrors(), ret);
+    if(ret.hasErrors()) return failures;
+
+    std::vector<dlp::DisparityMap> disparity_1(2, vertical);
+    std::vector<dlp::DisparityMap> disparity_2(2, horizontal);
+
+    // Disjoint regions of interest, so no voxel holds points of both views
+    dlp::RegionOfInterest left;
+    dlp::RegionOfInterest right;
+    left.SetRectangle( 0,                                   0, REGION_COLUMNS, CAMERA_ROWS);
+    right.SetRectangle(CAMERA_COLUMNS - REGION_COLUMNS,     0, REGION_COLUMNS, CAMERA_ROWS);
+
+    ret = geometry.SetRegionOfInterest(0, left);
+    if(!ret.hasErrors()) ret = geometry.SetRegionOfInterest(1, right);
+
+    dlp::Point::Cloud                       all_points;
+    dlp::Point::Cloud                       merged;
+    std::vector<dlp::Geometry::PointSource> all_sources;
+    std::vector<dlp::Geometry::PointSource> merged_sources;
+
+    if(!ret.hasErrors()) ret = geometry.GeneratePointCloud(disparity_1, disparity_2, 0.0, &all_points, &all_sources);
+    if(!ret.hasErrors()) ret = geometry.GeneratePointCloud(disparity_1, disparity_2, MERGE_VOXEL_SIZE, &merged, &merged_sources);
+
+    std::cout << "Separate views: " << CountView(all_sources, 0) << " + " << CountView(all_sources, 1)
+              << " points, merged = " << merged.GetCount() << std::endl;
+
+    Check("Both separate views have points",
+          !ret.hasErrors() && (CountView(all_sources, 0) > 0) && (CountView(all_sources, 1) > 0), ret);
+    Check("Merging separate views keeps every point",
+          !ret.hasErrors() && (merged.GetCount() == all_points.GetCount()) &&
+          (CountView(merged_sources, 0) == CountView(all_sources, 0)) &&
+          (CountView(merged_sources, 1) == CountView(all_sources, 1)), ret);
+
+    // Both views see every point
+    ret = geometry.SetRegionOfInterest(0, dlp::RegionOfInterest());
+    if(!ret.hasErrors()) ret = geometry.SetRegionOfInterest(1, dlp::RegionOfInterest());
+    if(!ret.hasErrors()) ret = geometry.GeneratePointCloud(disparity_1, disparity_2, 0.0, &all_points, &all_sources);
+    if(!ret.hasErrors()) ret = geometry.GeneratePointCloud(disparity_1, disparity_2, MERGE_VOXEL_SIZE, &merged, &merged_sources);
+
+    std::cout << "Overlapping views: " << CountView(all_sources, 0) << " + " << CountView(all_sources, 1)
+              << " points, merged = " << merged.GetCount() << std::endl;
+
+    Check("Merging overlapping views keeps the first view at full resolution",
+          !ret.hasErrors() && (CountView(all_sources, 0) > 0) &&
+          (merged.GetCount() == CountView(all_sources, 0)) &&
+          (CountView(merged_sources, 0) == merged.GetCount()), ret);
+
+    std::cout << failures << " failures" << std::endl;
+    return failures;
+}
@@ -0,0 +1,297 @@
+/** @file   pattern_generation_benchmark.cpp
+ *  @brief  Times structured light pattern generation and checks that the
+ *          generated images match a pixel by pixel reference generator
+ *
+ *  Usage: pattern_generation_benchmark [columns rows]
+ *
+ *  The reference generators below set every pixel with
+ *  dlp::Image::Unsafe_SetPixel in the same way the modules did before the
+ *  stripe profiles were broadcast with row copies. Each configuration is
+ *  generated three times: by the reference, by the module with an empty
+ *  pattern cache, and by the module after a second Setup() which should
+ *  be served from the cache. The second Setup() changes the decode-only
+ *  pixel threshold, which must NOT change the cache key.
+ */
+
+#include <dlp_sdk.hpp>
+
+#include <math.h>
+#include <string.h>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/** @brief Returns the index of the stripe profile used by a pixel */
+unsigned int ProfileIndex(const dlp::Pattern::Orientation &orientation, const unsigned int &rows,
+                          const unsigned int &xCol, const unsigned int &yRow){
+    switch(orientation){
+    case dlp::Pattern::Orientation::VERTICAL:        return xCol;
+    case dlp::Pattern::Orientation::HORIZONTAL:      return yRow;
+    case dlp::Pattern::Orientation::DIAMOND_ANGLE_2: return ((rows - yRow)/2) + xCol;
+    case dlp::Pattern::Orientation::DIAMOND_ANGLE_1: return (yRow/2) + xCol;
+    default:                                         return 0;
+    }
+}
+
+/** @brief Returns the stripe resolution used by both modules */
+unsigned int Resolution(const dlp::Pattern::Orientation &orientation, const unsigned int &columns, const unsigned int &rows){
+    switch(orientation){
+    case dlp::Pattern::Orientation::HORIZONTAL:      return rows;
+    case dlp::Pattern::Orientation::DIAMOND_ANGLE_1:
+    case dlp::Pattern::Orientation::DIAMOND_ANGLE_2: return columns + (rows/2);
+    default:                                         return columns;
+    }
+}
+
+/** @brief Creates an image pixel by pixel from a stripe profile */
+dlp::Image ReferenceImage(const std::vector<unsigned char> &profile, const unsigned int &offset,
+                          const dlp::Pattern::Orientation &orientation, const unsigned int &columns, const unsigned int &rows){
+    dlp::Image image;
+    image.Create(columns, rows, dlp::Image::Format::MONO_UCHAR);
+
+    for(     unsigned int yRow = 0; yRow < rows;    yRow++){
+        for( unsigned int xCol = 0; xCol < columns; xCol++){
+            image.Unsafe_SetPixel(xCol, yRow, profile.at(ProfileIndex(orientation, rows, xCol, yRow) + offset));
+        }
+    }
+    return image;
+}
+
+/** @brief Generates the Gray code images of a pixel measurement sequence */
+std::vector<dlp::Image> ReferenceGrayCode(const dlp::Pattern::Orientation &orientation, const bool &include_inverted,
+                                          const unsigned int &columns, const unsigned int &rows){
+    std::vector<dlp::Image> images;
+
+    unsigned int resolution        = Resolution(orientation, columns, rows);
+    unsigned int maximum_patterns  = (unsigned int)ceil(log2((double)resolution));
+    unsigned int maximum_disparity = 1ul << maximum_patterns;
+    unsigned int offset            = (maximum_disparity - resolution) / 2;
+
+    if(!include_inverted){
+        std::vector<unsigned char> white(1, 255);
+        std::vector<unsigned char> black(1, 0);
+        images.push_back(ReferenceImage(white, 0, dlp::Pattern::Orientation::INVALID, columns, rows));
+        images.push_back(ReferenceImage(black, 0, dlp::Pattern::Orientation::INVALID, columns, rows));
+    }
+
+    for(unsigned int iPattern = 0; iPattern < maximum_patterns; iPattern++){
+        std::vector<unsigned char> profile(maximum_disparity);
+        std::vector<unsigned char> profile_inverted(maximum_disparity);
+
+        for(unsigned int iPoint = 0; iPoint < maximum_disparity; iPoint++){
+            unsigned int gray = iPoint ^ (iPoint >> 1);
+            profile.at(iPoint)          = 255 * ((gray >> (maximum_patterns - 1 - iPattern)) & 1);
+            profile_inverted.at(iPoint) = 255 - profile.at(iPoint);
+        }
+
+        images.push_back(ReferenceImage(profile, offset, orientation, columns, rows));
+        if(include_inverted)
+            images.push_back(ReferenceImage(profile_inverted, offset, orientation, columns, rows));
+    }
+
+    return images;
+}
+
+/** @brief Generates the three sinusoidal images of an 8-bit three phase sequence */
+std::vector<dlp::Image> ReferenceThreePhase(const dlp::Pattern::Orientation &orientation, const double &frequency,
+                                            const unsigned int &columns, const unsigned int &rows){
+    std::vector<unsigned char> sine_phase_value_0;
+    std::vector<unsigned char> sine_phase_value_p120;
+    std::vector<unsigned char> sine_phase_value_n120;
+
+    unsigned int resolution = Resolution(orientation, columns, rows);
+    float maximum_value     = 255;
+    float period_pixels     = ((float)resolution) / frequency;
+    float angular_frequency = 2 * THREE_PHASE_PI / period_pixels;
+    float amplitude         = maximum_value/2;
+    float offset            = amplitude;
+
+    for(unsigned int iPoint = 0; iPoint < resolution; iPoint++){
+        sine_phase_value_0.push_back(    lroundf( amplitude * sin(  angular_frequency * ((float)iPoint) ) + offset ) );
+        sine_phase_value_p120.push_back( lroundf( amplitude * sin( (angular_frequency * ((float)iPoint) ) + THREE_PHASE_TWO_THIRDS_PI) + offset ) );
+        sine_phase_value_n120.push_back( lroundf( amplitude * sin( (angular_frequency * ((float)iPoint) ) - THREE_PHASE_TWO_THIRDS_PI) + offset ) );
+    }
+
+    std::vector<dlp::Image> images;
+    images.push_back(ReferenceImage(sine_phase_value_0,    0, orientation, columns, rows));
+    images.push_back(ReferenceImage(sine_phase_value_p120, 0, orientation, columns, rows));
+    images.push_back(ReferenceImage(sine_phase_value_n120, 0, orientation, columns, rows));
+    return images;
+}
+
+/** @brief Returns true if the first images of the sequence equal the reference images */
+bool Matches(const dlp::Pattern::Sequence &sequence, std::vector<dlp::Image> &reference){
+    if(sequence.GetCount() < reference.size()) return false;
+
+    for(unsigned int iImage = 0; iImage < reference.size(); iImage++){
+        dlp::Pattern pattern;
+        cv::Mat      generated;
+        cv::Mat      expected;
+
+        sequence.Get(iImage, &pattern);
+        pattern.image_data.Unsafe_GetOpenCVData(&generated);
+        reference.at(iImage).Unsafe_GetOpenCVData(&expected);
+
+        if((generated.rows != expected.rows) || (generated.cols != expected.cols) ||
+           (generated.type() != expected.type()))
+            return false;
+
+        for(int yRow = 0; yRow < expected.rows; yRow++){
+            if(memcmp(generated.ptr<unsigned char>(yRow), expected.ptr<unsigned char>(yRow), expected.cols) != 0)
+                return false;
+        }
+    }
+    return true;
+}
+
+/** @brief Generates a sequence twice with the module and once with the reference */
+bool Compare(const std::string &name, dlp::StructuredLight *module, const dlp::Parameters &settings,
+             std::vector<dlp::Image> (*reference)(void*), void *reference_arguments){
+    dlp::Pattern::Sequence  cold;
+    dlp::Pattern::Sequence  cached;
+    dlp::Time::Chronograph  timer(true);
+
+    dlp::StructuredLight::ClearPatternCache();
+
+    timer.Reset();
+    std::vector<dlp::Image> expected = reference(reference_arguments);
+    unsigned long long reference_ms = timer.Lap();
+
+    module->Setup(settings);
+    timer.Reset();
+    module->GeneratePatternSequence(&cold);
+    unsigned long long cold_ms = timer.Lap();
+
+    // Decode-only settings reuse the cached sequence
+    dlp::Parameters decode_settings = settings;
+    decode_settings.Set(dlp::GrayCode::Parameters::PixelThreshold(10));
+
+    dlp::StructuredLight::PatternCacheStatistics before;
+    dlp::StructuredLight::PatternCacheStatistics after;
+    dlp::StructuredLight::GetPatternCacheStatistics(&before);
+
+    module->Setup(decode_settings);
+    timer.Reset();
+    module->GeneratePatternSequence(&cached);
+    unsigned long long cached_ms = timer.Lap();
+
+    dlp::StructuredLight::GetPatternCacheStatistics(&after);
+    bool cache_hit = (after.hits > before.hits) && (after.misses == before.misses);
+
+    bool match = Matches(cold, expected) && Matches(cached, expected) && cache_hit;
+
+    std::cout << name
+              << ": reference = " << reference_ms << " ms"
+              << ", rows = "      << cold_ms      << " ms"
+              << ", cached = "    << cached_ms    << " ms"
+              << ", patterns = "  << cold.GetCount()
+              << (cache_hit ? "" : ", cache MISSED")
+              << (match ? ", bit exact" : ", MISMATCH") << std::endl;
+    return match;
+}
+
+struct GrayCodeArguments{
+    dlp::Pattern::Orientation orientation;
+    bool                      include_inverted;
+    unsigned int              columns;
+    unsigned int              rows;
+};
+
+std::vector<dlp::Image> GrayCodeReference(void *arguments){
+    GrayCodeArguments *gray_code = (GrayCodeArguments*) arguments;
+    return ReferenceGrayCode(gray_code->orientation, gray_code->include_inverted, gray_code->columns, gray_code->rows);
+}
+
+struct ThreePhaseArguments{
+    dlp::Pattern::Orientation orientation;
+    double                    frequency;
+    unsigned int              columns;
+    unsigned int              rows;
+};
+
+std::vector<dlp::Image> ThreePhaseReference(void *arguments){
+    ThreePhaseArguments *three_phase = (ThreePhaseArguments*) arguments;
+    return ReferenceThreePhase(three_phase->orientation, three_phase->frequency, three_phase->columns, three_phase->rows);
+}
+
+int main(int argc, char *argv[])
+{
+    unsigned int columns = 1920;
+    unsigned int rows    = 1080;
+    bool         passed  = true;
+
+    if(argc > 2){
+        columns = dlp::String::ToNumber<unsigned int>(argv[1]);
+        rows    = dlp::String::ToNumber<unsigned int>(argv[2]);
+    }
+
+    std::cout << "Generating patterns at " << columns << " x " << rows << "..." << std::endl;
+
+    std::vector<dlp::Pattern::Orientation> orientations;
+    orientations.push_back(dlp::Pattern::Orientation::VERTICAL);
+    orientations.push_back(dlp::Pattern::Orientation::HORIZONTAL);
+    orientations.push_back(dlp::Pattern::Orientation::DIAMOND_ANGLE_1);
+    orientations.push_back(dlp::Pattern::Orientation::DIAMOND_ANGLE_2);
+
+    // Gray code pixel measurement sequences with and without inverted patterns
+    for(unsigned int iOrientation = 0; iOrientation < orientations.size(); iOrientation++){
+        for(unsigned int iInverted = 0; iInverted < 2; iInverted++){
+            GrayCodeArguments arguments;
+            arguments.orientation      = orientations.at(iOrientation);
+            arguments.include_inverted = (iInverted == 0);
+            arguments.columns          = columns;
+            arguments.rows             = rows;
+
+            unsigned int resolution = Resolution(arguments.orientation, columns, rows);
+
+            dlp::GrayCode   gray_code;
+            dlp::Parameters settings;
+            settings.Set(dlp::StructuredLight::Parameters::PatternRows(rows));
+            settings.Set(dlp::StructuredLight::Parameters::PatternColumns(columns));
+            settings.Set(dlp::StructuredLight::Parameters::PatternColor(dlp::Pattern::Color::WHITE));
+            settings.Set(dlp::StructuredLight::Parameters::PatternOrientation(arguments.orientation));
+            settings.Set(dlp::GrayCode::Parameters::IncludeInverted(arguments.include_inverted));
+            settings.Set(dlp::GrayCode::Parameters::PixelThreshold(5));
+            settings.Set(dlp::GrayCode::Parameters::SequenceCount((unsigned int)ceil(log2((double)resolution))));
+
+            std::string name = "GrayCode   " + dlp::Number::ToString(arguments.orientation) +
+                               (arguments.include_inverted ? " inverted" : " albedo");
+            passed &= Compare(name, &gray_code, settings, GrayCodeReference, &arguments);
+        }
+    }
+
+    // Three phase sinusoids, the hybrid Gray code patterns are generated by dlp::GrayCode
+    for(unsigned int iOrientation = 0; iOrientation < orientations.size(); iOrientation++){
+        ThreePhaseArguments arguments;
+        arguments.orientation = orientations.at(iOrientation);
+        arguments.columns     = columns;
+        arguments.rows        = rows;
+
+        unsigned int resolution = Resolution(arguments.orientation, columns, rows);
+        arguments.frequency     = (float) resolution / 32;
+
+        dlp::ThreePhase three_phase;
+        dlp::Parameters settings;
+        settings.Set(dlp::StructuredLight::Parameters::PatternRows(rows));
+        settings.Set(dlp::StructuredLight::Parameters::PatternColumns(columns));
+        settings.Set(dlp::StructuredLight::Parameters::PatternColor(dlp::Pattern::Color::WHITE));
+        settings.Set(dlp::StructuredLight::Parameters::PatternOrientation(arguments.orientation));
+        settings.Set(dlp::ThreePhase::Parameters::Bitdepth(dlp::Pattern::Bitdepth::MONO_8BPP));
+        settings.Set(dlp::ThreePhase::Parameters::PixelsPerPeriod(32));
+        settings.Set(dlp::ThreePhase::Parameters::UseHybridUnwrap(true));
+        settings.Set(dlp::GrayCode::Parameters::IncludeInverted(true));
+        settings.Set(dlp::GrayCode::Parameters::PixelThreshold(5));
+
+        std::string name = "ThreePhase " + dlp::Number::ToString(arguments.orientation);
+        passed &= Compare(name, &three_phase, settings, ThreePhaseReference, &arguments);
+    }
+
+    dlp::StructuredLight::PatternCacheStatistics statistics;
+    dlp::StructuredLight::GetPatternCacheStatistics(&statistics);
+    std::cout << "Pattern cache: hits = " << statistics.hits
+              << ", misses = "            << statistics.misses << std::endl;
+
+    std::cout << (passed ? "All sequences are bit exact" : "Some sequences do NOT match the reference") << std::endl;
+
+    return passed ? 0 : 1;
+}
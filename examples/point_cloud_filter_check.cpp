@@ -0,0 +1,192 @@
+/** @file   point_cloud_filter_check.cpp
+ *  @brief  Checks the point cloud voxel and outlier filters on a known cloud
+ *          and times them against brute force reference implementations
+ *
+ *  Usage: point_cloud_filter_check [iterations]
+ *
+ *  The cloud is a lattice of points one unit apart plus isolated outliers far
+ *  from the lattice and from each other. The voxel counts are known from the
+ *  lattice size. The radius filter must return the same points as a search
+ *  of every pair of points, and both outlier filters must remove every
+ *  outlier. Each check prints PASS or FAIL and the program returns the number
+ *  of failures.
+ */
+
+#include <dlp_sdk.hpp>
+
+#include <math.h>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+#define LATTICE_COLUMNS     40
+#define LATTICE_ROWS        40
+#define LATTICE_LAYERS      10
+#define OUTLIER_COUNT       20
+
+#define VOXEL_SIZE          2.0     // Each voxel holds 2 x 2 x 2 lattice points
+#define RADIUS              1.5     // Finds the face and edge neighbors of a lattice point
+#define MIN_NEIGHBORS       4
+
+unsigned int failures = 0;
+
+void Check(const std::string &name, const bool &passed, const dlp::ReturnCode &ret){
+    std::cout << (passed ? "PASS: " : "FAIL: ") << name << std::endl;
+    if(!passed){
+        if(ret.hasErrors()) std::cout << "      " << ret.ToString() << std::endl;
+        failures++;
+    }
+}
+
+/** @brief Returns true if the index list contains none of the outliers */
+bool OutliersRemoved(const std::vector<unsigned long long> &indices, const unsigned long long &lattice_count){
+    for(unsigned long long iIndex = 0; iIndex < indices.size(); iIndex++){
+        if(indices.at(iIndex) >= lattice_count) return false;
+    }
+    return true;
+}
+
+/** @brief Counts the occupied voxels with an ordered map of voxel coordinates */
+unsigned long long ReferenceVoxelCount(const dlp::Point::Cloud &cloud, const double &voxel_size){
+    std::map< std::vector<long long>, unsigned long long > voxels;
+    dlp::Point min;
+
+    for(unsigned long long iPoint = 0; iPoint < cloud.GetCount(); iPoint++){
+        dlp::Point point;
+        cloud.Get(iPoint, &point);
+        if((iPoint == 0) || (point.x < min.x)) min.x = point.x;
+        if((iPoint == 0) || (point.y < min.y)) min.y = point.y;
+        if((iPoint == 0) || (point.z < min.z)) min.z = point.z;
+    }
+
+    for(unsigned long long iPoint = 0; iPoint < cloud.GetCount(); iPoint++){
+        dlp::Point point;
+        cloud.Get(iPoint, &point);
+
+        std::vector<long long> key(3);
+        key[0] = (long long) floor((point.x - min.x) / voxel_size);
+        key[1] = (long long) floor((point.y - min.y) / voxel_size);
+        key[2] = (long long) floor((point.z - min.z) / voxel_size);
+        voxels[key]++;
+    }
+
+    return voxels.size();
+}
+
+/** @brief Keeps the points with at least min_neighbors others within radius by testing every pair */
+void ReferenceRadiusOutliers(const dlp::Point::Cloud &cloud, const double &radius, const unsigned int &min_neighbors,
+                             std::vector<unsigned long long> *indices){
+    std::vector<dlp::Point> points(cloud.GetCount());
+    for(unsigned long long iPoint = 0; iPoint < points.size(); iPoint++) cloud.Get(iPoint, &points.at(iPoint));
+
+    indices->clear();
+    for(unsigned long long iPoint = 0; iPoint < points.size(); iPoint++){
+        unsigned int neighbors = 0;
+        for(unsigned long long iOther = 0; iOther < points.size(); iOther++){
+            if(iOther == iPoint) continue;
+            double dx = points[iPoint].x - points[iOther].x;
+            double dy = points[iPoint].y - points[iOther].y;
+            double dz = points[iPoint].z - points[iOther].z;
+            if(dx*dx + dy*dy + dz*dz <= radius*radius) neighbors++;
+        }
+        if(neighbors >= min_neighbors) indices->push_back(iPoint);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    dlp::ReturnCode     ret;
+    dlp::Point::Cloud   cloud;
+    unsigned int        iterations = 5;
+
+    if(argc > 1) iterations = dlp::String::ToNumber<unsigned int>(argv[1]);
+    if(iterations == 0) iterations = 1;
+
+    // Lattice followed by the outliers, so every index at or above the
+    // lattice count is an outlier
+    for(         unsigned int zLayer = 0; zLayer < LATTICE_LAYERS;  zLayer++){
+        for(     unsigned int yRow   = 0; yRow   < LATTICE_ROWS;    yRow++){
+            for( unsigned int xCol   = 0; xCol   < LATTICE_COLUMNS; xCol++){
+                cloud.Add(dlp::Point(xCol, yRow, zLayer));
+            }
+        }
+    }
+    const unsigned long long lattice_count = cloud.GetCount();
+
+    for(unsigned int iOutlier = 0; iOutlier < OUTLIER_COUNT; iOutlier++)
+        cloud.Add(dlp::Point(100.0 + (25.0 * iOutlier), 100.0, 100.0));
+
+    std::cout << "Filtering " << cloud.GetCount() << " points, average of " << iterations << " runs..." << std::endl;
+
+    // Every voxel of the lattice holds 8 points and every outlier has its own voxel
+    const unsigned long long expected_voxels = ((LATTICE_COLUMNS + 1) / 2) * ((LATTICE_ROWS + 1) / 2) *
+                                               ((LATTICE_LAYERS  + 1) / 2) + OUTLIER_COUNT;
+
+    dlp::Point::Cloud downsampled;
+    double downsample_ms = 0;
+    for(unsigned int iRun = 0; iRun < iterations; iRun++){
+        dlp::Time::Chronograph timer(true);
+        ret = cloud.DownsampleVoxelGrid(VOXEL_SIZE, &downsampled);
+        downsample_ms += (double) timer.Lap();
+    }
+
+    dlp::Point centroid;
+    if(!ret.hasErrors()) ret = downsampled.Get(0, &centroid);
+    Check("Voxel grid keeps one point per occupied voxel", !ret.hasErrors() && (downsampled.GetCount() == expected_voxels), ret);
+    Check("Voxel grid returns the centroid of the first voxel",
+          !ret.hasErrors() && (centroid.x == 0.5) && (centroid.y == 0.5) && (centroid.z == 0.5), ret);
+
+    std::vector<unsigned long long> subsampled;
+    double subsample_ms = 0;
+    for(unsigned int iRun = 0; iRun < iterations; iRun++){
+        dlp::Time::Chronograph timer(true);
+        ret = cloud.SubsampleUniform(VOXEL_SIZE, &subsampled);
+        subsample_ms += (double) timer.Lap();
+    }
+    Check("Uniform subsampling keeps one point per occupied voxel", !ret.hasErrors() && (subsampled.size() == expected_voxels), ret);
+
+    dlp::Time::Chronograph reference_timer(true);
+    unsigned long long reference_voxels = ReferenceVoxelCount(cloud, VOXEL_SIZE);
+    double reference_voxel_ms = (double) reference_timer.Lap();
+    Check("Voxel count matches the ordered map reference", reference_voxels == downsampled.GetCount(), ret);
+
+    // Radius outliers
+    std::vector<unsigned long long> radius_kept;
+    double radius_ms = 0;
+    for(unsigned int iRun = 0; iRun < iterations; iRun++){
+        dlp::Time::Chronograph timer(true);
+        ret = cloud.FilterRadiusOutliers(RADIUS, MIN_NEIGHBORS, &radius_kept);
+        radius_ms += (double) timer.Lap();
+    }
+
+    reference_timer.Reset();
+    std::vector<unsigned long long> reference_kept;
+    ReferenceRadiusOutliers(cloud, RADIUS, MIN_NEIGHBORS, &reference_kept);
+    double reference_radius_ms = (double) reference_timer.Lap();
+
+    Check("Radius filter removes every outlier", !ret.hasErrors() && OutliersRemoved(radius_kept, lattice_count), ret);
+    Check("Radius filter keeps every lattice point", !ret.hasErrors() && (radius_kept.size() == lattice_count), ret);
+    Check("Radius filter matches the search of every pair", radius_kept == reference_kept, ret);
+
+    // Statistical outliers, the outliers have no neighbor within the search radius
+    std::vector<unsigned long long> statistical_kept;
+    double statistical_ms = 0;
+    for(unsigned int iRun = 0; iRun < iterations; iRun++){
+        dlp::Time::Chronograph timer(true);
+        ret = cloud.FilterStatisticalOutliers(8, 1.0, 2.0, &statistical_kept);
+        statistical_ms += (double) timer.Lap();
+    }
+    Check("Statistical filter removes every outlier",
+          !ret.hasErrors() && !statistical_kept.empty() && OutliersRemoved(statistical_kept, lattice_count), ret);
+
+    std::cout << "Voxel grid = "           << downsample_ms  / iterations << " ms"
+              << ", uniform subsample = "  << subsample_ms   / iterations << " ms"
+              << ", ordered map = "        << reference_voxel_ms          << " ms" << std::endl;
+    std::cout << "Radius filter = "        << radius_ms      / iterations << " ms"
+              << ", every pair = "         << reference_radius_ms         << " ms"
+              << ", statistical filter = " << statistical_ms / iterations << " ms" << std::endl;
+
+    std::cout << failures << " failures" << std::endl;
+    return failures;
+}
@@ -33,6 +33,7 @@ int main(){
     dlp::CmdLine::Print("s/S = Save point cloud xyz file");
     dlp::CmdLine::Print("a/A = Auto-rotate the point cloud");
     dlp::CmdLine::Print("c/C = Turn point cloud color on/off");
+    dlp::CmdLine::Print("l/L = Turn level-of-detail for large clouds on/off");
     dlp::CmdLine::Print("\nPress ESC key to close the viewer");
     dlp::CmdLine::Print();
     dlp::CmdLine::PressEnterToContinue("Press ENTER to open the viewer...");
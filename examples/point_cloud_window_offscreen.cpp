@@ -0,0 +1,206 @@
+/** @file   point_cloud_window_offscreen.cpp
+ *  @brief  Runs the dlp::Point::Cloud::Window render loop in an offscreen
+ *          EGL pbuffer and checks the upload and level-of-detail statistics
+ *
+ *  Usage: point_cloud_window_offscreen
+ *
+ *  No display is required. With Mesa the pbuffer is created on the
+ *  surfaceless platform and rendered by llvmpipe when no GPU is available
+ *  (force it with LIBGL_ALWAYS_SOFTWARE=1). Each
+ *  check prints PASS or FAIL and the program returns the number of failures.
+ */
+
+#include <dlp_sdk.hpp>
+
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <GLFW/glfw3.h>     // Platform OpenGL header
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+
+/** @brief Offscreen EGL pbuffer used as the window's OpenGL context */
+struct Pbuffer{
+    Pbuffer(){
+        this->display = EGL_NO_DISPLAY;
+        this->surface = EGL_NO_SURFACE;
+        this->context = EGL_NO_CONTEXT;
+    }
+
+    bool Create(unsigned int width, unsigned int height){
+        // Prefer the Mesa surfaceless platform, which needs no window system
+        const char *extensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+        PFNEGLGETPLATFORMDISPLAYEXTPROC get_platform_display =
+                (PFNEGLGETPLATFORMDISPLAYEXTPROC) eglGetProcAddress("eglGetPlatformDisplayEXT");
+
+        if(extensions && get_platform_display && std::strstr(extensions, "EGL_MESA_platform_surfaceless"))
+            this->display = get_platform_display(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL);
+        else
+            this->display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+
+        if((this->display == EGL_NO_DISPLAY) || !eglInitialize(this->display, NULL, NULL))
+            return false;
+
+        const EGLint config_attributes[] = { EGL_SURFACE_TYPE,    EGL_PBUFFER_BIT,
+                                             EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+                                             EGL_RED_SIZE,   8,
+                                             EGL_GREEN_SIZE, 8,
+                                             EGL_BLUE_SIZE,  8,
+                                             EGL_DEPTH_SIZE, 16,
+                                             EGL_NONE };
+        EGLConfig config;
+        EGLint    configs = 0;
+        if(!eglChooseConfig(this->display, config_attributes, &config, 1, &configs) || (configs == 0))
+            return false;
+
+        const EGLint surface_attributes[] = { EGL_WIDTH,  (EGLint) width,
+                                              EGL_HEIGHT, (EGLint) height,
+                                              EGL_NONE };
+        this->surface = eglCreatePbufferSurface(this->display, config, surface_attributes);
+        if(this->surface == EGL_NO_SURFACE) return false;
+
+        // The viewer uses the fixed function pipeline, so desktop OpenGL is required
+        if(!eglBindAPI(EGL_OPENGL_API)) return false;
+
+        this->context = eglCreateContext(this->display, config, EGL_NO_CONTEXT, NULL);
+        if(this->context == EGL_NO_CONTEXT) return false;
+
+        if(!eglMakeCurrent(this->display, this->surface, this->surface, this->context))
+            return false;
+
+        std::cout << "      OpenGL " << glGetString(GL_VERSION) << " / " << glGetString(GL_RENDERER) << std::endl;
+        return true;
+    }
+
+    void Destroy(){
+        if(this->display == EGL_NO_DISPLAY) return;
+        eglMakeCurrent(this->display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        if(this->context != EGL_NO_CONTEXT) eglDestroyContext(this->display, this->context);
+        if(this->surface != EGL_NO_SURFACE) eglDestroySurface(this->display, this->surface);
+        eglTerminate(this->display);
+        this->display = EGL_NO_DISPLAY;
+        this->surface = EGL_NO_SURFACE;
+        this->context = EGL_NO_CONTEXT;
+    }
+
+    EGLDisplay display;
+    EGLSurface surface;
+    EGLContext context;
+};
+
+/** @brief Returns a cloud of uniformly spread points with a skewed depth */
+dlp::Point::Cloud CreateCloud(const unsigned long long &count){
+    std::mt19937 generator(1);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+
+    dlp::Point::Cloud cloud;
+    for(unsigned long long iPoint = 0; iPoint < count; iPoint++){
+        double x = 100 * uniform(generator);
+        double y = 100 * uniform(generator);
+        double z = 500 +  50 * uniform(generator) * uniform(generator);
+        cloud.Add(dlp::Point(x, y, z));
+    }
+    return cloud;
+}
+
+/** @brief Waits until the render loop has uploaded a cloud since the statistics were reset */
+dlp::Point::Cloud::Window::Statistics WaitForUpload(dlp::Point::Cloud::Window *window){
+    dlp::Point::Cloud::Window::Statistics statistics = window->GetStatistics();
+    for(unsigned int iWait = 0; (iWait < 3000) && (statistics.uploads == 0); iWait++){
+        dlp::Time::Sleep::Milliseconds(10);
+        statistics = window->GetStatistics();
+    }
+    return statistics;
+}
+
+/** @brief Resets the statistics and waits until the render loop has drawn a few frames */
+dlp::Point::Cloud::Window::Statistics WaitForFrames(dlp::Point::Cloud::Window *window){
+    window->ResetStatistics();
+
+    dlp::Point::Cloud::Window::Statistics statistics = window->GetStatistics();
+    for(unsigned int iWait = 0; (iWait < 3000) && (statistics.frames < 3); iWait++){
+        dlp::Time::Sleep::Milliseconds(10);
+        statistics = window->GetStatistics();
+    }
+    return statistics;
+}
+
+unsigned int failures = 0;
+
+void Check(const std::string &name, const bool &passed){
+    std::cout << (passed ? "PASS: " : "FAIL: ") << name << std::endl;
+    if(!passed) failures++;
+}
+
+int main()
+{
+    dlp::ReturnCode ret;
+
+    const unsigned long long large_count  = 3000000;
+    const unsigned long long small_count  = 1000;
+    const unsigned long long point_budget = 2000000;
+
+    Pbuffer pbuffer;
+
+    dlp::Point::Cloud::Window::Context context;
+    context.Create         = [&pbuffer](unsigned int width, unsigned int height){ return pbuffer.Create(width, height); };
+    context.GetProcAddress = [](const char *name){ return (dlp::Point::Cloud::Window::Context::Function) eglGetProcAddress(name); };
+    context.SwapBuffers    = [&pbuffer](){ eglSwapBuffers(pbuffer.display, pbuffer.surface); };
+    context.Destroy        = [&pbuffer](){ pbuffer.Destroy(); };
+
+    dlp::Point::Cloud::Window window;
+    window.SetContext(context);
+    window.SetPointBudget(point_budget);
+    window.SetDebugEnable(true);
+
+    ret = window.Open("Offscreen point cloud", 256, 256);
+    Check("Offscreen window opens", !ret.hasErrors() && window.isOpen());
+    if(!window.isOpen()) return failures;
+
+    // A cloud larger than the budget is drawn at a coarser level-of-detail
+    dlp::Point::Cloud large_cloud = CreateCloud(large_count);
+    window.ResetStatistics();
+    window.Update(large_cloud);
+
+    dlp::Point::Cloud::Window::Statistics statistics = WaitForUpload(&window);
+    std::cout << "      Uploaded " << statistics.points_uploaded << " points in "
+              << statistics.upload_time_ms << " ms" << std::endl;
+    Check("Large cloud is uploaded", (statistics.uploads == 1) && (statistics.points_uploaded == large_count));
+
+    statistics = WaitForFrames(&window);
+    std::cout << "      " << statistics.frames << " frames, "
+              << statistics.frame_time_total_ms / std::max(statistics.frames, 1ull) << " ms per frame, level "
+              << statistics.lod_level << ", " << statistics.points_drawn << " points drawn" << std::endl;
+    Check("Frames are drawn", statistics.frames >= 3);
+    Check("Large cloud is NOT uploaded again", statistics.uploads == 0);
+    Check("Large cloud is drawn within the point budget",
+          (statistics.points_drawn > 0) && (statistics.points_drawn <= point_budget));
+    Check("Large cloud uses a coarser level-of-detail", statistics.lod_level > 0);
+
+    // Raising the budget draws every point from the same vertex buffer
+    window.SetPointBudget(large_count);
+    statistics = WaitForFrames(&window);
+    Check("Raised budget draws every point", statistics.points_drawn == large_count);
+    Check("Raised budget does NOT upload again", statistics.uploads == 0);
+
+    // A small cloud is drawn completely at a single level
+    dlp::Point::Cloud small_cloud = CreateCloud(small_count);
+    window.ResetStatistics();
+    ret = window.Update(small_cloud);
+    Check("Shader program is used", !ret.ContainsWarning(POINT_CLOUD_WINDOW_SHADERS_FAILED));
+
+    statistics = WaitForUpload(&window);
+    Check("Small cloud is uploaded", (statistics.uploads == 1) && (statistics.points_uploaded == small_count));
+
+    statistics = WaitForFrames(&window);
+    Check("Small cloud is drawn completely", (statistics.points_drawn == small_count) && (statistics.lod_level == 0));
+
+    window.Close();
+    Check("Offscreen window closes", !window.isOpen());
+
+    std::cout << failures << " failures" << std::endl;
+    return failures;
+}
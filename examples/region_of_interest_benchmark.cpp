@@ -0,0 +1,198 @@
+/** @file   region_of_interest_benchmark.cpp
+ *  @brief  Times Gray code decoding and point cloud generation restricted
+ *          to regions of interest covering different fractions of the frame
+ *
+ *  Usage: region_of_interest_benchmark [iterations]
+ *
+ *  The camera sees the patterns on the tilted plane of synthetic_scene.hpp,
+ *  which covers the center of its view. Centered
+ *  rectangles and a circular mask select part of the frame. Every region is
+ *  decoded and triangulated the same number of times and the speedup is
+ *  reported against the whole frame. The program returns 1 if a step fails
+ *  or a region produces no points or more points than it covers.
+ */
+
+#include <dlp_sdk.hpp>
+
+#include "synthetic_scene.hpp"
+
+#include <math.h>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#define FRAME_COLUMNS   1280
+#define FRAME_ROWS      800
+#define FOCAL_LENGTH    1400.0
+#define BASELINE        150.0
+#define PLANE_DISTANCE  1000.0
+
+struct Result{
+    double              decode_ms;
+    double              cloud_ms;
+    unsigned long long  points;
+    bool                failed;
+};
+
+/** @brief Decodes and triangulates the captures within a region */
+Result Run(const dlp::RegionOfInterest &region, const unsigned int &iterations,
+           dlp::GrayCode *gray_code, dlp::Geometry *geometry, const unsigned int &viewport_id,
+           dlp::Capture::Sequence *captures){
+    Result              result = {0, 0, 0, false};
+    dlp::DisparityMap   disparity;
+    dlp::Point::Cloud   cloud;
+    dlp::Image          depth;
+
+    gray_code->SetRegionOfInterest(region);
+    geometry->SetRegionOfInterest(viewport_id, region);
+
+    for(unsigned int iRun = 0; iRun < iterations; iRun++){
+        dlp::ReturnCode ret;
+        dlp::Time::Chronograph timer(true);
+        ret = gray_code->DecodeCaptureSequence(captures, &disparity);
+        result.decode_ms += (double) timer.Lap();
+        if(!ret.hasErrors()) ret = geometry->GeneratePointCloud(viewport_id, disparity, &cloud, &depth);
+        result.cloud_ms  += (double) timer.Lap();
+
+        if(ret.hasErrors()){
+            std::cout << "Decoding failed: " << ret.ToString() << std::endl;
+            result.failed = true;
+            break;
+        }
+    }
+
+    result.decode_ms /= iterations;
+    result.cloud_ms  /= iterations;
+    result.points     = cloud.GetCount();
+    return result;
+}
+
+/** @brief Prints the result and returns true if the region produced points within its area
+ *  @param[in]  area    Pixels covered by the region
+ */
+bool PrintResult(const std::string &name, const unsigned long long &area, const Result &result, const Result &full_frame){
+    double fraction   = (double) area / (FRAME_COLUMNS * FRAME_ROWS);
+    double total      = result.decode_ms + result.cloud_ms;
+    double total_full = full_frame.decode_ms + full_frame.cloud_ms;
+
+    std::cout << name
+              << ": area = "        << 100.0 * fraction << "%"
+              << ", decode = "      << result.decode_ms << " ms"
+              << ", point cloud = " << result.cloud_ms << " ms"
+              << ", points = "      << result.points
+              << ", speedup = "     << ((total > 0) ? total_full / total : 0.0) << "x"
+              << std::endl;
+
+    return !result.failed && (result.points > 0) && (result.points <= area);
+}
+
+int main(int argc, char *argv[])
+{
+    dlp::ReturnCode             ret;
+    dlp::Parameters             settings;
+    dlp::GrayCode               gray_code;
+    dlp::Pattern::Sequence      patterns;
+    unsigned int                iterations = 5;
+
+    if(argc > 1) iterations = dlp::String::ToNumber<unsigned int>(argv[1]);
+    if(iterations == 0) iterations = 1;
+
+    settings.Set(dlp::StructuredLight::Parameters::PatternColor(dlp::Pattern::Color::WHITE));
+    settings.Set(dlp::StructuredLight::Parameters::PatternOrientation(dlp::Pattern::Orientation::VERTICAL));
+    settings.Set(dlp::StructuredLight::Parameters::PatternColumns(FRAME_COLUMNS));
+    settings.Set(dlp::StructuredLight::Parameters::PatternRows(FRAME_ROWS));
+    settings.Set(dlp::GrayCode::Parameters::IncludeInverted(true));
+    settings.Set(dlp::GrayCode::Parameters::SequenceCount(11));
+    settings.Set(dlp::GrayCode::Parameters::PixelThreshold(5));
+
+    ret = gray_code.Setup(settings);
+    if(!ret.hasErrors()) ret = gray_code.GeneratePatternSequence(&patterns);
+
+    if(ret.hasErrors()){
+        std::cout << "Could not generate the patterns: " << ret.ToString() << std::endl;
+        return 1;
+    }
+
+    // The camera is beside the projector with the same optics and turned
+    // toward the plane. With parallel optical axes every ray would be
+    // parallel to the plane of its decoded column and nothing triangulates.
+    synthetic_scene::Scene scene = synthetic_scene::TiltedPlane(FRAME_COLUMNS, FRAME_ROWS, FOCAL_LENGTH,
+                                                                FRAME_COLUMNS, FRAME_ROWS, FOCAL_LENGTH,
+                                                                BASELINE, PLANE_DISTANCE);
+
+    dlp::Capture::Sequence captures;
+    synthetic_scene::RenderCaptures(scene, patterns, &captures);
+    synthetic_scene::SaveCalibrations(scene, "roi_benchmark_projector_calibration.xml",
+                                             "roi_benchmark_camera_calibration.xml");
+
+    dlp::Calibration::Data projector_calibration;
+    dlp::Calibration::Data camera_calibration;
+    ret = projector_calibration.Load("roi_benchmark_projector_calibration.xml");
+    if(!ret.hasErrors()) ret = camera_calibration.Load("roi_benchmark_camera_calibration.xml");
+
+    dlp::Parameters geometry_settings;
+    dlp::Geometry   geometry;
+    unsigned int    viewport_id = 0;
+    geometry_settings.Set(dlp::Geometry::Parameters::GenerateOriginPlanesHorizontal(false));
+    geometry_settings.Set(dlp::Geometry::Parameters::GenerateOriginPlanesDiamondAngle1(false));
+    geometry_settings.Set(dlp::Geometry::Parameters::GenerateOriginPlanesDiamondAngle2(false));
+
+    if(!ret.hasErrors()) ret = geometry.Setup(geometry_settings);
+    if(!ret.hasErrors()) ret = geometry.SetOriginView(projector_calibration);
+    if(!ret.hasErrors()) ret = geometry.AddView(camera_calibration, &viewport_id);
+
+    if(ret.hasErrors()){
+        std::cout << "Could not set up the geometry: " << ret.ToString() << std::endl;
+        return 1;
+    }
+
+    std::cout << "Decoding " << patterns.GetCount() << " patterns at " << FRAME_COLUMNS << " x " << FRAME_ROWS
+              << ", average of " << iterations << " runs..." << std::endl;
+
+    Result full_frame = Run(dlp::RegionOfInterest(), iterations, &gray_code, &geometry, viewport_id, &captures);
+    bool passed = PrintResult("Full frame", (unsigned long long) FRAME_COLUMNS * FRAME_ROWS, full_frame, full_frame);
+
+    // Centered rectangles
+    const double fractions[] = {0.5, 0.25, 0.1, 0.05, 0.01};
+    for(unsigned int iFraction = 0; iFraction < sizeof(fractions)/sizeof(fractions[0]); iFraction++){
+        double       scale   = sqrt(fractions[iFraction]);
+        unsigned int columns = (unsigned int) (FRAME_COLUMNS * scale);
+        unsigned int rows    = (unsigned int) (FRAME_ROWS    * scale);
+
+        dlp::RegionOfInterest region((FRAME_COLUMNS - columns) / 2, (FRAME_ROWS - rows) / 2, columns, rows);
+
+        passed = PrintResult(" Rectangle", (unsigned long long) columns * rows,
+                             Run(region, iterations, &gray_code, &geometry, viewport_id, &captures), full_frame) && passed;
+    }
+
+    // Circular mask, its bounding box is decoded and the corners are skipped
+    dlp::Image  mask;
+    unsigned long long mask_pixels = 0;
+    double      radius = FRAME_ROWS / 4.0;
+    mask.Create(FRAME_COLUMNS, FRAME_ROWS, dlp::Image::Format::MONO_UCHAR);
+    mask.FillImage((unsigned char) 0);
+    for(     unsigned int yRow = 0; yRow < FRAME_ROWS;    yRow++){
+        for( unsigned int xCol = 0; xCol < FRAME_COLUMNS; xCol++){
+            double x = xCol - (FRAME_COLUMNS / 2.0);
+            double y = yRow - (FRAME_ROWS    / 2.0);
+            if(((x*x) + (y*y)) <= (radius*radius)){
+                mask.Unsafe_SetPixel(xCol, yRow, (unsigned char) 255);
+                mask_pixels++;
+            }
+        }
+    }
+
+    dlp::RegionOfInterest circle;
+    ret = circle.SetMask(mask);
+    if(ret.hasErrors()){
+        std::cout << "Could not set the mask: " << ret.ToString() << std::endl;
+        return 1;
+    }
+
+    passed = PrintResult("    Circle", mask_pixels,
+                         Run(circle, iterations, &gray_code, &geometry, viewport_id, &captures), full_frame) && passed;
+
+    std::cout << (passed ? "PASS" : "FAIL") << ": every region is decoded within its area" << std::endl;
+
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,141 @@
+/** @file   scan_scheduler_throughput.cpp
+ *  @brief  Compares back-to-back scanning with the pipelined dlp::ScanScheduler
+ *          using the virtual projector and camera
+ *
+ *  Usage: scan_scheduler_throughput [scans] [camera_calibration.xml projector_calibration.xml]
+ *
+ *  Without calibration files the scans stop after decoding.
+ */
+
+#include <dlp_sdk.hpp>
+
+#include <iostream>
+#include <string>
+
+void PrintStage(const std::string &name, const dlp::ScanScheduler::StageStatistics &stage){
+    std::cout << "  " << name
+              << ": count = "       << stage.count
+              << ", average = "     << (stage.count ? stage.busy_ms / stage.count : 0) << " ms"
+              << ", max = "         << stage.max_ms << " ms"
+              << ", starved = "     << stage.starved_ms << " ms"
+              << ", blocked = "     << stage.blocked_ms << " ms" << std::endl;
+}
+
+int main(int argc, char *argv[])
+{
+    dlp::ReturnCode             ret;
+    dlp::Parameters             settings;
+    dlp::Virtual_Projector      projector;
+    dlp::Virtual_Cam            camera;
+    dlp::GrayCode               gray_code;
+    dlp::Geometry               geometry;
+    dlp::Pattern::Sequence      sequence;
+    bool                        use_geometry = false;
+    unsigned int                viewport_id  = 0;
+    unsigned long long          scans        = 10;
+
+    if(argc > 1) scans = dlp::String::ToNumber<unsigned long long>(argv[1]);
+
+    // Connect the virtual projector and the camera looking at it
+    projector.Connect("0");
+    settings.Set(dlp::Virtual_Projector::Parameters::PatternPeriod_US(8333));
+    projector.Setup(settings);
+
+    camera.SetProjector(&projector);
+    camera.Connect("0");
+
+    // Load the calibration to triangulate the scans
+    if(argc > 3){
+        dlp::Calibration::Data camera_calibration;
+        dlp::Calibration::Data projector_calibration;
+        unsigned int columns = 0;
+        unsigned int rows    = 0;
+
+        ret = camera_calibration.Load(argv[2]);
+        if(!ret.hasErrors()) ret = projector_calibration.Load(argv[3]);
+        if(!ret.hasErrors()) ret = geometry.SetOriginView(projector_calibration);
+        if(!ret.hasErrors()) ret = geometry.AddView(camera_calibration, &viewport_id);
+
+        if(ret.hasErrors()){
+            std::cout << "Could not load the calibration: " << ret.ToString() << std::endl;
+            return 0;
+        }
+
+        // The camera resolution must match its calibration
+        camera_calibration.GetModelResolution(&columns, &rows);
+        settings.Clear();
+        settings.Set(dlp::Virtual_Cam::Parameters::Columns(columns));
+        settings.Set(dlp::Virtual_Cam::Parameters::Rows(rows));
+        camera.Setup(settings);
+        use_geometry = true;
+    }
+
+    camera.Start();
+
+    // Generate and prepare the vertical Gray code patterns
+    settings.Clear();
+    settings.Set(dlp::StructuredLight::Parameters::PatternColor(dlp::Pattern::Color::WHITE));
+    settings.Set(dlp::StructuredLight::Parameters::PatternOrientation(dlp::Pattern::Orientation::VERTICAL));
+    settings.Set(dlp::GrayCode::Parameters::IncludeInverted(true));
+    settings.Set(dlp::GrayCode::Parameters::PixelThreshold(5));
+    settings.Set(dlp::GrayCode::Parameters::SequenceCount(10));
+
+    gray_code.SetDlpPlatform(projector);
+    ret = gray_code.Setup(settings);
+    if(!ret.hasErrors()) ret = gray_code.GeneratePatternSequence(&sequence);
+    if(!ret.hasErrors()) ret = projector.PreparePatternSequence(sequence);
+
+    if(ret.hasErrors()){
+        std::cout << "Could not prepare the patterns: " << ret.ToString() << std::endl;
+        return 0;
+    }
+
+    unsigned int pattern_count = sequence.GetCount();
+    std::cout << "Scanning with " << pattern_count << " patterns per scan..." << std::endl;
+
+    // Capture, decode and triangulate each scan before starting the next
+    dlp::Time::Chronograph timer(true);
+    for(unsigned long long iScan = 0; iScan < scans; iScan++){
+        dlp::Capture::Sequence  capture;
+        dlp::DisparityMap       disparity;
+        dlp::Point::Cloud       cloud;
+        dlp::Image              depth_map;
+
+        projector.StartPatternSequence(0, pattern_count, false);
+        camera.GetCaptureSequence(pattern_count, &capture);
+        gray_code.DecodeCaptureSequence(&capture, &disparity);
+        if(use_geometry) geometry.GeneratePointCloud(viewport_id, disparity, &cloud, &depth_map);
+    }
+    unsigned long long sequential_ms = timer.Lap();
+    std::cout << "Sequential: " << scans << " scans in " << sequential_ms << " ms ("
+              << (1000.0 * scans / sequential_ms) << " scans/s)" << std::endl;
+
+    // Overlap capture, decode and triangulation
+    dlp::ScanScheduler scheduler;
+    scheduler.SetCamera(&camera);
+    scheduler.SetDlpPlatform(&projector);
+    scheduler.AddStructuredLight(&gray_code, 0, pattern_count);
+    if(use_geometry) scheduler.SetGeometry(&geometry, viewport_id);
+
+    ret = scheduler.Start(scans);
+    if(ret.hasErrors()){
+        std::cout << "Could not start the scan scheduler: " << ret.ToString() << std::endl;
+        return 0;
+    }
+
+    dlp::ScanScheduler::Scan scan;
+    while(!scheduler.GetScan(&scan).hasErrors()){
+        if(scan.ret.hasErrors())
+            std::cout << "Scan " << scan.index << " failed: " << scan.ret.ToString() << std::endl;
+    }
+
+    dlp::ScanScheduler::Statistics statistics = scheduler.GetStatistics();
+    std::cout << "Pipelined:  " << statistics.scans << " scans in " << statistics.elapsed_ms << " ms ("
+              << statistics.scans_per_second << " scans/s, average latency "
+              << statistics.latency_average_ms << " ms)" << std::endl;
+    PrintStage("capture    ", statistics.capture);
+    PrintStage("decode     ", statistics.decode);
+    PrintStage("triangulate", statistics.triangulate);
+
+    return 0;
+}
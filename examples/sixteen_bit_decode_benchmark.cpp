@@ -0,0 +1,181 @@
+/** @file   sixteen_bit_decode_benchmark.cpp
+ *  @brief  Compares Gray code decoding of 8-bit and 12-bit captures of the
+ *          same synthetic scene
+ *
+ *  Usage: sixteen_bit_decode_benchmark [noise_counts] [iterations]
+ *
+ *  The scene reflectance falls from 100% at the top of the image to 2% at
+ *  the bottom. Each pattern is rendered once in 12-bit camera counts with
+ *  Gaussian noise and then quantized to 8 bits, so both decodes see the
+ *  same photons. The decoded disparity is compared against a noise free
+ *  full reflectance reference. Both depths use the same 8-bit pixel
+ *  threshold, which is scaled to the 12-bit captures.
+ */
+
+#include <dlp_sdk.hpp>
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+struct Result{
+    unsigned long long  valid;
+    unsigned long long  correct;
+    double              decode_ms;
+};
+
+/** @brief Renders the captures of every pattern at both depths */
+void RenderCaptures(const dlp::Pattern::Sequence &patterns, const double &noise, const bool &ideal,
+                    dlp::Capture::Sequence *captures_8, dlp::Capture::Sequence *captures_12){
+    cv::RNG random(0x5EED);
+
+    for(unsigned int iPattern = 0; iPattern < patterns.GetCount(); iPattern++){
+        dlp::Pattern pattern;
+        cv::Mat      pattern_data;
+
+        patterns.Get(iPattern, &pattern);
+        pattern.image_data.ConvertToMonochrome();
+        pattern.image_data.Unsafe_GetOpenCVData(&pattern_data);
+
+        cv::Mat frame_8( pattern_data.rows, pattern_data.cols, CV_8UC1);
+        cv::Mat frame_12(pattern_data.rows, pattern_data.cols, CV_16UC1);
+
+        for(int yRow = 0; yRow < pattern_data.rows; yRow++){
+            // Reflectance of this row of the scene
+            double reflectance = ideal ? 1.0 : 1.0 - (0.98 * yRow) / pattern_data.rows;
+
+            const unsigned char *pixel_pattern = pattern_data.ptr<unsigned char>(yRow);
+            unsigned char       *pixel_8       = frame_8.ptr<unsigned char>(yRow);
+            unsigned short      *pixel_12      = frame_12.ptr<unsigned short>(yRow);
+
+            for(int xCol = 0; xCol < pattern_data.cols; xCol++){
+                // Off pixels still leak 5% of the light plus a small ambient level
+                double illumination = (pixel_pattern[xCol] > 127) ? 1.0 : 0.05;
+                double counts       = 40.0 + (reflectance * illumination * 3800.0);
+                if(!ideal) counts  += random.gaussian(noise);
+
+                counts = std::min(std::max(counts, 0.0), 4095.0);
+                pixel_12[xCol] = (unsigned short)(counts + 0.5);
+                pixel_8[xCol]  = (unsigned char)std::min(255.0, (counts / 16.0) + 0.5);
+            }
+        }
+
+        dlp::Capture capture;
+        capture.data_type = dlp::Capture::DataType::IMAGE_DATA;
+        capture.image_data.Create(frame_8);
+        captures_8->Add(capture);
+
+        capture.image_data.Create(frame_12);
+        captures_12->Add(capture);
+    }
+}
+
+/** @brief Decodes a capture sequence and compares it with the reference */
+Result Decode(const unsigned int &bit_depth, const unsigned int &iterations, dlp::Parameters settings,
+              dlp::GrayCode *gray_code, dlp::Capture::Sequence *captures, dlp::DisparityMap *reference){
+    Result            result;
+    dlp::DisparityMap disparity;
+
+    settings.Set(dlp::GrayCode::Parameters::CaptureBitDepth(bit_depth));
+    gray_code->Setup(settings);
+
+    dlp::Time::Chronograph timer(true);
+    for(unsigned int iDecode = 0; iDecode < iterations; iDecode++)
+        gray_code->DecodeCaptureSequence(captures, &disparity);
+    result.decode_ms = (double)timer.Lap() / iterations;
+
+    unsigned int columns;
+    unsigned int rows;
+    disparity.GetColumns(&columns);
+    disparity.GetRows(&rows);
+
+    result.valid   = 0;
+    result.correct = 0;
+    for(     unsigned int yRow = 0; yRow < rows;    yRow++){
+        for( unsigned int xCol = 0; xCol < columns; xCol++){
+            int  value;
+            int  expected;
+            bool valid;
+            bool expected_valid;
+            disparity.Unsafe_GetPixel(xCol, yRow, &value, &valid);
+            reference->Unsafe_GetPixel(xCol, yRow, &expected, &expected_valid);
+
+            if(!valid) continue;
+            result.valid++;
+            if(expected_valid && (value == expected)) result.correct++;
+        }
+    }
+
+    return result;
+}
+
+void PrintResult(const std::string &name, const unsigned long long &pixels, const Result &result){
+    std::cout << name
+              << ": decode = " << result.decode_ms << " ms"
+              << ", valid = "  << (100.0 * result.valid) / pixels << "%"
+              << ", correct = " << ((result.valid > 0) ? (100.0 * result.correct) / result.valid : 0.0) << "% of valid"
+              << std::endl;
+}
+
+int main(int argc, char *argv[])
+{
+    dlp::ReturnCode             ret;
+    dlp::Parameters             settings;
+    dlp::Virtual_Projector      projector;
+    dlp::GrayCode               gray_code;
+    dlp::Pattern::Sequence      patterns;
+    double                      noise      = 12.0;
+    unsigned int                iterations = 5;
+
+    if(argc > 1) noise      = dlp::String::ToNumber<double>(argv[1]);
+    if(argc > 2) iterations = dlp::String::ToNumber<unsigned int>(argv[2]);
+    if(iterations == 0) iterations = 1;
+
+    projector.Connect("0");
+
+    // Vertical Gray code with inverted patterns
+    settings.Set(dlp::StructuredLight::Parameters::PatternColor(dlp::Pattern::Color::WHITE));
+    settings.Set(dlp::StructuredLight::Parameters::PatternOrientation(dlp::Pattern::Orientation::VERTICAL));
+    settings.Set(dlp::GrayCode::Parameters::IncludeInverted(true));
+    settings.Set(dlp::GrayCode::Parameters::SequenceCount(10));
+    settings.Set(dlp::GrayCode::Parameters::PixelThreshold(5));
+
+    gray_code.SetDlpPlatform(projector);
+    ret = gray_code.Setup(settings);
+    if(!ret.hasErrors()) ret = gray_code.GeneratePatternSequence(&patterns);
+
+    if(ret.hasErrors()){
+        std::cout << "Could not generate the patterns: " << ret.ToString() << std::endl;
+        return 0;
+    }
+
+    dlp::Capture::Sequence  ideal_8;
+    dlp::Capture::Sequence  ideal_12;
+    dlp::Capture::Sequence  captures_8;
+    dlp::Capture::Sequence  captures_12;
+    RenderCaptures(patterns, noise, true,  &ideal_8,    &ideal_12);
+    RenderCaptures(patterns, noise, false, &captures_8, &captures_12);
+
+    // The reference is decoded from noise free captures of a white scene
+    dlp::DisparityMap reference;
+    gray_code.Setup(settings);
+    ret = gray_code.DecodeCaptureSequence(&ideal_8, &reference);
+    if(ret.hasErrors()){
+        std::cout << "Could not decode the reference: " << ret.ToString() << std::endl;
+        return 0;
+    }
+
+    unsigned int columns;
+    unsigned int rows;
+    reference.GetColumns(&columns);
+    reference.GetRows(&rows);
+    unsigned long long pixels = (unsigned long long)columns * rows;
+
+    std::cout << "Decoding " << patterns.GetCount() << " patterns at " << columns << " x " << rows
+              << " with " << noise << " counts of 12-bit noise..." << std::endl;
+
+    PrintResult(" 8-bit", pixels, Decode(8,  iterations, settings, &gray_code, &captures_8,  &reference));
+    PrintResult("12-bit", pixels, Decode(12, iterations, settings, &gray_code, &captures_12, &reference));
+
+    return 0;
+}
@@ -0,0 +1,197 @@
+/** @file   subpixel_gray_code_plane.cpp
+ *  @brief  Compares the flatness of a tilted plane reconstructed from
+ *          integer and subpixel Gray code disparity maps
+ *
+ *  Usage: subpixel_gray_code_plane [sequence_count] [subpixel_sampling] [noise]
+ *
+ *  A synthetic projector and camera calibration is written to XML files and
+ *  loaded into \ref dlp::Geometry. The Gray code patterns are rendered onto a
+ *  tilted plane by tracing several rays through every camera pixel, so the
+ *  captures contain the partially lit pixels found along real stripe edges.
+ *  Both disparity maps are converted to point clouds and the RMS distance of
+ *  the points from a least squares plane is reported. The program returns
+ *  0 only if the subpixel plane is flatter than the integer plane.
+ */
+
+#include <dlp_sdk.hpp>
+
+#include "synthetic_scene.hpp"
+
+#include <math.h>
+#include <iostream>
+#include <string>
+
+#define PROJECTOR_COLUMNS   640
+#define PROJECTOR_ROWS      480
+#define PROJECTOR_FOCAL     800.0
+
+#define CAMERA_COLUMNS      640
+#define CAMERA_ROWS         480
+#define CAMERA_FOCAL        900.0
+
+#define CAMERA_BASELINE     150.0   // Camera is placed to the right of the projector (mm)
+#define PLANE_DISTANCE      600.0   // Distance from the projector to the plane along its optical axis (mm)
+#define RAYS_PER_AXIS       4       // Rays traced along each axis of a camera pixel
+
+/** @brief Fits z = a*x + b*y + c to the cloud and returns the RMS point to plane distance */
+double PlaneFitRMS(const dlp::Point::Cloud &cloud){
+    unsigned long long count = cloud.GetCount();
+    if(count < 3) return 0;
+
+    // Normal equations of the least squares fit, centered for precision
+    double mean[3] = {0, 0, 0};
+    for(unsigned long long iPoint = 0; iPoint < count; iPoint++){
+        dlp::Point point;
+        cloud.Get(iPoint, &point);
+        mean[0] += point.x;
+        mean[1] += point.y;
+        mean[2] += point.z;
+    }
+    for(int iAxis = 0; iAxis < 3; iAxis++) mean[iAxis] /= count;
+
+    double sxx = 0, sxy = 0, syy = 0, sxz = 0, syz = 0;
+    for(unsigned long long iPoint = 0; iPoint < count; iPoint++){
+        dlp::Point point;
+        cloud.Get(iPoint, &point);
+        double x = point.x - mean[0];
+        double y = point.y - mean[1];
+        double z = point.z - mean[2];
+        sxx += x*x; sxy += x*y; syy += y*y;
+        sxz += x*z; syz += y*z;
+    }
+
+    double determinant = (sxx * syy) - (sxy * sxy);
+    if(determinant == 0) return 0;
+
+    double a = ((sxz * syy) - (syz * sxy)) / determinant;
+    double b = ((syz * sxx) - (sxz * sxy)) / determinant;
+    double scale = sqrt((a*a) + (b*b) + 1.0);
+
+    double sum = 0;
+    for(unsigned long long iPoint = 0; iPoint < count; iPoint++){
+        dlp::Point point;
+        cloud.Get(iPoint, &point);
+        double distance = ((a * (point.x - mean[0])) + (b * (point.y - mean[1])) - (point.z - mean[2])) / scale;
+        sum += distance * distance;
+    }
+
+    return sqrt(sum / count);
+}
+
+/** @brief Decodes the captures, generates the point cloud, and prints its flatness
+ *  @retval false   Decoding or the point cloud failed
+ */
+bool Reconstruct(const std::string &name, const unsigned int &subpixel_sampling,
+                 dlp::Parameters settings, dlp::Capture::Sequence *captures,
+                 dlp::Geometry *geometry, const unsigned int &viewport_id, double *plane_rms){
+    dlp::ReturnCode     ret;
+    dlp::GrayCode       gray_code;
+    dlp::DisparityMap   disparity;
+    dlp::Point::Cloud   cloud;
+    dlp::Image          depth;
+
+    settings.Set(dlp::GrayCode::Parameters::SubpixelSampling(subpixel_sampling));
+
+    dlp::Time::Chronograph timer(true);
+    ret = gray_code.Setup(settings);
+    if(!ret.hasErrors()) ret = gray_code.DecodeCaptureSequence(captures, &disparity);
+    double decode_ms = (double) timer.Lap();
+    if(!ret.hasErrors()) ret = geometry->GeneratePointCloud(viewport_id, disparity, &cloud, &depth);
+    double cloud_ms  = (double) timer.Lap();
+
+    if(ret.hasErrors()){
+        std::cout << name << ": " << ret.ToString() << std::endl;
+        return false;
+    }
+
+    (*plane_rms) = PlaneFitRMS(cloud);
+    std::cout << name
+              << ": points = "     << cloud.GetCount()
+              << ", plane RMS = "  << (*plane_rms) << " mm"
+              << ", decode = "     << decode_ms << " ms"
+              << ", point cloud = " << cloud_ms << " ms"
+              << std::endl;
+
+    return cloud.GetCount() > 0;
+}
+
+int main(int argc, char *argv[])
+{
+    dlp::ReturnCode             ret;
+    dlp::Parameters             settings;
+    dlp::GrayCode               gray_code;
+    dlp::Pattern::Sequence      patterns;
+    unsigned int                sequence_count    = 8;
+    unsigned int                subpixel_sampling = 16;
+    double                      noise             = 2.0;
+
+    if(argc > 1) sequence_count    = dlp::String::ToNumber<unsigned int>(argv[1]);
+    if(argc > 2) subpixel_sampling = dlp::String::ToNumber<unsigned int>(argv[2]);
+    if(argc > 3) noise             = dlp::String::ToNumber<double>(argv[3]);
+
+    synthetic_scene::Scene scene = synthetic_scene::TiltedPlane(PROJECTOR_COLUMNS, PROJECTOR_ROWS, PROJECTOR_FOCAL,
+                                                                CAMERA_COLUMNS,    CAMERA_ROWS,    CAMERA_FOCAL,
+                                                                CAMERA_BASELINE,   PLANE_DISTANCE);
+    scene.rays_per_axis = RAYS_PER_AXIS;
+    scene.noise         = noise;
+
+    synthetic_scene::SaveCalibrations(scene, "subpixel_plane_projector_calibration.xml",
+                                             "subpixel_plane_camera_calibration.xml");
+
+    dlp::Calibration::Data projector_calibration;
+    dlp::Calibration::Data camera_calibration;
+    ret = projector_calibration.Load("subpixel_plane_projector_calibration.xml");
+    if(!ret.hasErrors()) ret = camera_calibration.Load("subpixel_plane_camera_calibration.xml");
+
+    // Only vertical planes are needed. Smoothing is disabled so the
+    // comparison shows the decoded disparity alone.
+    dlp::Parameters geometry_settings;
+    dlp::Geometry   geometry;
+    unsigned int    viewport_id = 0;
+    geometry_settings.Set(dlp::Geometry::Parameters::SmoothDisparity(false));
+    geometry_settings.Set(dlp::Geometry::Parameters::GenerateOriginPlanesVertical(true));
+    geometry_settings.Set(dlp::Geometry::Parameters::GenerateOriginPlanesHorizontal(false));
+    geometry_settings.Set(dlp::Geometry::Parameters::GenerateOriginPlanesDiamondAngle1(false));
+    geometry_settings.Set(dlp::Geometry::Parameters::GenerateOriginPlanesDiamondAngle2(false));
+
+    if(!ret.hasErrors()) ret = geometry.Setup(geometry_settings);
+    if(!ret.hasErrors()) ret = geometry.SetOriginView(projector_calibration);
+    if(!ret.hasErrors()) ret = geometry.AddView(camera_calibration, &viewport_id);
+
+    if(ret.hasErrors()){
+        std::cout << "Could not set up the geometry: " << ret.ToString() << std::endl;
+        return 1;
+    }
+
+    settings.Set(dlp::StructuredLight::Parameters::PatternColor(dlp::Pattern::Color::WHITE));
+    settings.Set(dlp::StructuredLight::Parameters::PatternOrientation(dlp::Pattern::Orientation::VERTICAL));
+    settings.Set(dlp::StructuredLight::Parameters::PatternColumns(PROJECTOR_COLUMNS));
+    settings.Set(dlp::StructuredLight::Parameters::PatternRows(PROJECTOR_ROWS));
+    settings.Set(dlp::GrayCode::Parameters::IncludeInverted(true));
+    settings.Set(dlp::GrayCode::Parameters::SequenceCount(sequence_count));
+    settings.Set(dlp::GrayCode::Parameters::PixelThreshold(5));
+
+    ret = gray_code.Setup(settings);
+    if(!ret.hasErrors()) ret = gray_code.GeneratePatternSequence(&patterns);
+
+    if(ret.hasErrors()){
+        std::cout << "Could not generate the patterns: " << ret.ToString() << std::endl;
+        return 1;
+    }
+
+    dlp::Capture::Sequence captures;
+    synthetic_scene::RenderCaptures(scene, patterns, &captures);
+
+    std::cout << "Reconstructing a tilted plane from " << patterns.GetCount() << " patterns with "
+              << noise << " counts of noise..." << std::endl;
+
+    double integer_rms  = 0;
+    double subpixel_rms = 0;
+    bool   passed = Reconstruct("Integer ", 1,                 settings, &captures, &geometry, viewport_id, &integer_rms);
+    passed = Reconstruct("Subpixel", subpixel_sampling, settings, &captures, &geometry, viewport_id, &subpixel_rms) && passed;
+    passed = passed && (subpixel_rms < integer_rms);
+
+    std::cout << (passed ? "PASS" : "FAIL") << ": subpixel plane is flatter than the integer plane" << std::endl;
+
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,248 @@
+/** @file   synthetic_scene.hpp
+ *  @brief  Synthetic projector and camera calibrations and captures of a
+ *          tilted plane used by the examples which run the structured light
+ *          and geometry modules without hardware
+ *
+ *  The projector is the world origin looking down +z. The camera sits to its
+ *  right and is turned to look at the center of a plane which is tilted about
+ *  both axes. Both devices are ideal pinhole models without distortion.
+ */
+
+#ifndef DLP_SDK_EXAMPLES_SYNTHETIC_SCENE_HPP
+#define DLP_SDK_EXAMPLES_SYNTHETIC_SCENE_HPP
+
+#include <dlp_sdk.hpp>
+
+#include <math.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace synthetic_scene{
+
+/** @brief Projector, camera, and plane of a synthetic scan */
+struct Scene{
+    unsigned int projector_columns;
+    unsigned int projector_rows;
+    double       projector_focal;       // Focal length in pixels
+
+    unsigned int camera_columns;
+    unsigned int camera_rows;
+    double       camera_focal;          // Focal length in pixels
+
+    cv::Mat      camera_rvec;           // Rodrigues rotation from world to camera coordinates
+    cv::Mat      camera_tvec;           // Translation from world to camera coordinates
+    cv::Mat      camera_rotation;       // Rotation matrix of camera_rvec
+    cv::Mat      camera_center;         // Camera position in world coordinates (mm)
+
+    cv::Mat      plane_point;           // Point on the plane in world coordinates (mm)
+    cv::Mat      plane_normal;          // Unit normal of the plane
+
+    unsigned int rays_per_axis;         // Rays traced along each axis of a camera pixel
+    double       noise;                 // Standard deviation of the capture noise in counts
+};
+
+/** @brief Returns a scene with the camera baseline mm to the right of the
+ *         projector, looking at the center of a plane plane_distance mm away
+ *
+ *  One ray is traced through the center of every camera pixel and no noise
+ *  is added. Change rays_per_axis and noise to render partially lit pixels.
+ */
+inline Scene TiltedPlane(const unsigned int &projector_columns, const unsigned int &projector_rows,
+                         const double &projector_focal,
+                         const unsigned int &camera_columns,    const unsigned int &camera_rows,
+                         const double &camera_focal,
+                         const double &baseline, const double &plane_distance){
+    Scene scene;
+    scene.projector_columns = projector_columns;
+    scene.projector_rows    = projector_rows;
+    scene.projector_focal   = projector_focal;
+    scene.camera_columns    = camera_columns;
+    scene.camera_rows       = camera_rows;
+    scene.camera_focal      = camera_focal;
+
+    double angle          = atan2(baseline, plane_distance);
+    scene.camera_rvec     = (cv::Mat_<double>(3,1) << 0, angle, 0);
+    scene.camera_center   = (cv::Mat_<double>(3,1) << baseline, 0, 0);
+    cv::Rodrigues(scene.camera_rvec, scene.camera_rotation);
+    scene.camera_tvec     = -scene.camera_rotation * scene.camera_center;
+
+    // Plane through the center of the view, tilted about both axes
+    scene.plane_point  = (cv::Mat_<double>(3,1) << 0, 0, plane_distance);
+    scene.plane_normal = (cv::Mat_<double>(3,1) << 0.35, -0.2, -1.0);
+    scene.plane_normal = scene.plane_normal / cv::norm(scene.plane_normal);
+
+    scene.rays_per_axis = 1;
+    scene.noise         = 0;
+
+    return scene;
+}
+
+/** @brief Writes calibration data in the format read by \ref dlp::Calibration::Data::Load() */
+inline void SaveCalibration(const std::string &filename, const bool &camera,
+                            const unsigned int &columns, const unsigned int &rows,
+                            const cv::Mat &intrinsic, const cv::Mat &distortion, const cv::Mat &extrinsic,
+                            const double &reprojection_error){
+    cv::FileStorage file(filename, cv::FileStorage::WRITE);
+    file << "DLP_CALIBRATION_DATA"  << true;
+    file << "calibration_complete"  << true;
+    file << "calibration_of_camera" << camera;
+    file << "image_columns"         << (int) columns;
+    file << "image_rows"            << (int) rows;
+    file << "model_columns"         << (int) columns;
+    file << "model_rows"            << (int) rows;
+    file << "reprojection_error"    << reprojection_error;
+    file << "intrinsic"             << intrinsic;
+    file << "distortion"            << distortion;
+    file << "extrinsic"             << extrinsic;
+    file.release();
+}
+
+/** @brief Writes the calibration of an ideal pinhole model centered on the image */
+inline void SaveCalibration(const std::string &filename, const bool &camera,
+                            const unsigned int &columns, const unsigned int &rows, const double &focal,
+                            const cv::Mat &rvec, const cv::Mat &tvec){
+    cv::Mat intrinsic  = (cv::Mat_<double>(3,3) << focal, 0, (columns - 1) / 2.0,
+                                                    0, focal, (rows - 1) / 2.0,
+                                                    0, 0, 1);
+    cv::Mat distortion = cv::Mat::zeros(1, 5, CV_64FC1);
+    cv::Mat extrinsic(2, 3, CV_64FC1);
+
+    for(int iAxis = 0; iAxis < 3; iAxis++){
+        extrinsic.at<double>(dlp::Calibration::Data::EXTRINSIC_ROW_ROTATION,    iAxis) = rvec.at<double>(iAxis);
+        extrinsic.at<double>(dlp::Calibration::Data::EXTRINSIC_ROW_TRANSLATION, iAxis) = tvec.at<double>(iAxis);
+    }
+
+    SaveCalibration(filename, camera, columns, rows, intrinsic, distortion, extrinsic, 0.0);
+}
+
+/** @brief Writes the projector and camera calibrations of a scene */
+inline void SaveCalibrations(const Scene &scene, const std::string &projector_filename,
+                             const std::string &camera_filename){
+    cv::Mat zero = cv::Mat::zeros(3, 1, CV_64FC1);
+
+    SaveCalibration(projector_filename, false, scene.projector_columns, scene.projector_rows,
+                    scene.projector_focal, zero, zero);
+    SaveCalibration(camera_filename,    true,  scene.camera_columns,    scene.camera_rows,
+                    scene.camera_focal, scene.camera_rvec, scene.camera_tvec);
+}
+
+/** @brief Projector pixel seen by every ray traced from the camera */
+struct RayLookup{
+    std::vector<int> column;            // -1 if the ray does NOT see the projector image
+    std::vector<int> row;
+};
+
+/** @brief Traces the rays of every camera pixel to the plane and into the projector
+ *
+ *  The projector pixels are the same for every pattern, so the lookup is
+ *  found once and shared by \ref RenderFrame() calls.
+ */
+inline void TraceRays(const Scene &scene, RayLookup *lookup){
+    const unsigned int rays_per_pixel = scene.rays_per_axis * scene.rays_per_axis;
+
+    lookup->column.assign((unsigned long long) scene.camera_columns * scene.camera_rows * rays_per_pixel, -1);
+    lookup->row.assign(lookup->column.size(), -1);
+
+    cv::Mat rotation_transpose = scene.camera_rotation.t();
+    double  center_offset      = cv::Mat(scene.plane_normal.t() * (scene.plane_point - scene.camera_center)).at<double>(0);
+
+    unsigned long long iRay = 0;
+    for(     unsigned int yRow = 0; yRow < scene.camera_rows;    yRow++){
+        for( unsigned int xCol = 0; xCol < scene.camera_columns; xCol++){
+            for(     unsigned int ySub = 0; ySub < scene.rays_per_axis; ySub++){
+                for( unsigned int xSub = 0; xSub < scene.rays_per_axis; xSub++, iRay++){
+                    double x = xCol - 0.5 + (xSub + 0.5) / scene.rays_per_axis;
+                    double y = yRow - 0.5 + (ySub + 0.5) / scene.rays_per_axis;
+
+                    cv::Mat ray = (cv::Mat_<double>(3,1) << (x - (scene.camera_columns - 1) / 2.0) / scene.camera_focal,
+                                                            (y - (scene.camera_rows    - 1) / 2.0) / scene.camera_focal,
+                                                            1.0);
+                    ray = rotation_transpose * ray;
+
+                    double  distance = center_offset / cv::Mat(scene.plane_normal.t() * ray).at<double>(0);
+                    cv::Mat point    = scene.camera_center + distance * ray;
+
+                    // The projector is at the world origin looking down +z
+                    double z = point.at<double>(2);
+                    if(z <= 0) continue;
+
+                    long column = lround((scene.projector_focal * point.at<double>(0) / z) + (scene.projector_columns - 1) / 2.0);
+                    long row    = lround((scene.projector_focal * point.at<double>(1) / z) + (scene.projector_rows    - 1) / 2.0);
+
+                    if((column < 0) || (column >= (long) scene.projector_columns) ||
+                       (row    < 0) || (row    >= (long) scene.projector_rows)) continue;
+
+                    lookup->column.at(iRay) = (int) column;
+                    lookup->row.at(iRay)    = (int) row;
+                }
+            }
+        }
+    }
+}
+
+/** @brief Renders the camera frame of one pattern projected onto the plane
+ *
+ *  Each camera pixel averages the projector pixels seen by its rays. Rays
+ *  which do NOT see the projector image stay dark. The noise is drawn from
+ *  random so a sequence of frames gets independent noise.
+ */
+inline void RenderFrame(const Scene &scene, const RayLookup &lookup, const dlp::Pattern &pattern,
+                        cv::RNG *random, cv::Mat *frame){
+    const unsigned int rays_per_pixel = scene.rays_per_axis * scene.rays_per_axis;
+
+    dlp::Image   monochrome;
+    cv::Mat      pattern_data;
+
+    monochrome.Create(pattern.image_data);
+    monochrome.ConvertToMonochrome();
+    monochrome.Unsafe_GetOpenCVData(&pattern_data);
+
+    frame->create(scene.camera_rows, scene.camera_columns, CV_8UC1);
+
+    unsigned long long iRay = 0;
+    for(unsigned int yRow = 0; yRow < scene.camera_rows; yRow++){
+        unsigned char *pixel = frame->ptr<unsigned char>(yRow);
+
+        for(unsigned int xCol = 0; xCol < scene.camera_columns; xCol++){
+            double illumination = 0;
+            for(unsigned int iSub = 0; iSub < rays_per_pixel; iSub++, iRay++){
+                if(lookup.column.at(iRay) < 0) continue;
+                illumination += pattern_data.at<unsigned char>(lookup.row.at(iRay), lookup.column.at(iRay)) / 255.0;
+            }
+            illumination = illumination / rays_per_pixel;
+
+            // Off pixels still leak 5% of the light plus a small ambient level
+            double counts = 10.0 + (200.0 * (0.05 + (0.95 * illumination)));
+            if(scene.noise > 0) counts += random->gaussian(scene.noise);
+
+            pixel[xCol] = (unsigned char) std::min(std::max(counts + 0.5, 0.0), 255.0);
+        }
+    }
+}
+
+/** @brief Renders the captures of every pattern projected onto the plane */
+inline void RenderCaptures(const Scene &scene, const dlp::Pattern::Sequence &patterns,
+                           dlp::Capture::Sequence *captures){
+    RayLookup lookup;
+    cv::RNG   random(0x5EED);
+
+    TraceRays(scene, &lookup);
+
+    for(unsigned int iPattern = 0; iPattern < patterns.GetCount(); iPattern++){
+        dlp::Pattern pattern;
+        dlp::Capture capture;
+        cv::Mat      frame;
+
+        patterns.Get(iPattern, &pattern);
+        RenderFrame(scene, lookup, pattern, &random, &frame);
+
+        capture.data_type = dlp::Capture::DataType::IMAGE_DATA;
+        capture.image_data.Create(frame);
+        captures->Add(capture);
+    }
+}
+
+}
+
+#endif // DLP_SDK_EXAMPLES_SYNTHETIC_SCENE_HPP
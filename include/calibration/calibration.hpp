@@ -22,6 +22,7 @@
 #include <common/image/image.hpp>               // Adds dlp::Image
 #include <common/parameters.hpp>                // Adds dlp::Parameter
 #include <camera/camera.hpp>                    // Adds dlp::Camera
+#include <common/capture/capture.hpp>           // Adds dlp::Capture::Sequence
 #include <dlp_platforms/dlp_platform.hpp>       // Adds dlp::DLP_Platform
 
 // OpenCV header files
@@ -53,6 +54,9 @@
 #define CALIBRATION_DATA_FILE_SAVE_FAILED                   "CALIBRATION_DATA_FILE_SAVE_FAILED"
 #define CALIBRATION_DATA_FILE_LOAD_FAILED                   "CALIBRATION_DATA_FILE_LOAD_FAILED"
 #define CALIBRATION_DATA_FILE_INVALID                       "CALIBRATION_DATA_FILE_INVALID"
+#define CALIBRATION_DATA_FILE_VERSION_INVALID               "CALIBRATION_DATA_FILE_VERSION_INVALID"
+#define CALIBRATION_DATA_FILE_CHECKSUM_INVALID              "CALIBRATION_DATA_FILE_CHECKSUM_INVALID"
+#define CALIBRATION_DATA_FILE_TRUNCATED                     "CALIBRATION_DATA_FILE_TRUNCATED"
 
 #define CALIBRATION_NOT_SETUP                               "CALIBRATION_NOT_SETUP"
 #define CALIBRATION_NOT_COMPLETE                            "CALIBRATION_NOT_COMPLETE"
@@ -65,6 +69,8 @@
 #define CALIBRATION_NULL_POINTER_CALIBRATION_IMAGE          "CALIBRATION_NULL_POINTER_CALIBRATION_IMAGE"
 #define CALIBRATION_NULL_POINTER_REPROJECTION_ERROR         "CALIBRATION_NULL_POINTER_REPROJECTION_ERROR"
 #define CALIBRATION_NULL_POINTER_PROJECTED_BOARD            "CALIBRATION_NULL_POINTER_PROJECTED_BOARD"
+#define CALIBRATION_NULL_POINTER_BOARD_ERRORS               "CALIBRATION_NULL_POINTER_BOARD_ERRORS"
+#define CALIBRATION_NULL_POINTER_MODULE                     "CALIBRATION_NULL_POINTER_MODULE"
 
 #define CALIBRATION_PARAMETERS_MODEL_SIZE_MISSING                         "CALIBRATION_PARAMETERS_MODEL_SIZE_MISSING"
 #define CALIBRATION_PARAMETERS_IMAGE_SIZE_MISSING                         "CALIBRATION_PARAMETERS_IMAGE_SIZE_MISSING"
@@ -101,9 +107,15 @@
 #define CALIBRATION_IMAGE_RESOLUTION_MISMATCH       "CALIBRATION_IMAGE_RESOLUTION_MISMATCH"
 #define CALIBRATION_IMAGE_CONVERT_TO_MONO_FAILED    "CALIBRATION_IMAGE_CONVERT_TO_MONO_FAILED"
 #define CALIBRATION_IMAGE_VECTOR_SIZE_MISMATCH      "CALIBRATION_IMAGE_VECTOR_SIZE_MISMATCH"
+#define CALIBRATION_IMAGE_LIST_EMPTY                "CALIBRATION_IMAGE_LIST_EMPTY"
+#define CALIBRATION_IMAGE_FILE_LOAD_FAILED          "CALIBRATION_IMAGE_FILE_LOAD_FAILED"
 
 #define CALIBRATION_BOARD_NOT_DETECTED              "CALIBRATION_BOARD_NOT_DETECTED"
 #define CALIBRATION_NO_BOARDS_ADDED                 "CALIBRATION_NO_BOARDS_ADDED"
+#define CALIBRATION_BOARD_INDEX_INVALID             "CALIBRATION_BOARD_INDEX_INVALID"
+#define CALIBRATION_BOARD_ERRORS_MISSING            "CALIBRATION_BOARD_ERRORS_MISSING"
+#define CALIBRATION_OUTLIER_RATIO_INVALID           "CALIBRATION_OUTLIER_RATIO_INVALID"
+#define CALIBRATION_MODULE_LISTED_TWICE             "CALIBRATION_MODULE_LISTED_TWICE"
 
 #define CALIBRATION_CAMERA_CALIBRATION_MISSING                  "CALIBRATION_CAMERA_CALIBRATION_MISSING"
 #define CALIBRATION_CAMERA_CALIBRATION_HOMOGRAPHIES_MISSING     "CALIBRATION_CAMERA_CALIBRATION_HOMOGRAPHIES_MISSING"
@@ -162,6 +174,7 @@ public:
         DLP_NEW_PARAMETERS_ENTRY(SetTangentDistZero, "CALIBRATION_PARAMETERS_SET_TANGENT_DIST_TO_ZERO", bool, false);
         DLP_NEW_PARAMETERS_ENTRY(FixSixthOrderDist,  "CALIBRATION_PARAMETERS_FIX_SIXTH_ORDER_DIST",     bool, false);
         DLP_NEW_PARAMETERS_ENTRY(FixAspectRatio,     "CALIBRATION_PARAMETERS_FIX_ASPECT_RATIO",         bool,  true);
+        DLP_NEW_PARAMETERS_ENTRY(WarmStart,          "CALIBRATION_PARAMETERS_WARM_START",               bool, false);
     };
 
     /** @class Data
@@ -169,7 +182,8 @@ public:
      *         intrinsic/extrinsic parameters.
      *
      *  In addition to containing calibration data, this class can save and load the
-     *  data using XML files using \ref Data::Save() and \ref Data::Load().
+     *  data using XML files or compact binary files using \ref Data::Save() and
+     *  \ref Data::Load(). The format is selected by the file extension.
      *
      *  This calibration data object contains the information required to generate
      *  the geometrical rays of a model for the system geometry. See \ref dlp::Geometry for
@@ -207,6 +221,11 @@ public:
         ReturnCode Load(const std::string &filename);
 
     private:
+        ReturnCode SaveXML(const std::string &filename) const;
+        ReturnCode LoadXML(const std::string &filename);
+        ReturnCode SaveBinary(const std::string &filename) const;
+        ReturnCode LoadBinary(const std::string &filename);
+
         bool calibration_complete_;         /**< Boolean flag to mark that calibration object is completed calibration data */
         bool calibration_of_camera_;        /**< Boolean flag to mark if the calibration object is a camera. If false the data is for a projector */
 
@@ -246,6 +265,13 @@ public:
      *     - This calibration data can be saved for later use
      *     - If calibration data needs to be updated, it can be loaded into the module by using \ref dlp::Calibration::Camera::SetCalibrationData() . The camera calibration module still needs to be setup.
      *
+     *  Calibration can also be refined incrementally:
+     *  - Boards can be added after calibrating or removed with \ref dlp::Calibration::Camera::RemoveCalibrationBoard()
+     *  - \ref dlp::Calibration::Camera::GetBoardReprojectionErrors() returns the error of each board from the last calibration
+     *    and \ref dlp::Calibration::Camera::RemoveOutlierBoards() removes the boards which do NOT fit the model
+     *  - If \ref dlp::Calibration::Parameters::WarmStart is set, calibrating again starts from the previous intrinsic and distortion estimate
+     *  - Independent modules can be calibrated concurrently with \ref dlp::Calibration::Camera::CalibrateConcurrently()
+     *
      */
     class Camera: public dlp::Module{
     public:
@@ -276,19 +302,38 @@ public:
         // Add calibration board methods
         ReturnCode AddCalibrationBoard(const dlp::Image   &board_image,   bool *success);
 
+        // Detect several calibration boards concurrently
+        ReturnCode AddCalibrationBoards(const std::vector<dlp::Image>     &board_images,
+                                        std::vector<bool>                 *success,
+                                        std::vector<unsigned long long>   *detection_times_ms = nullptr);
+        ReturnCode AddCalibrationBoards(const dlp::Capture::Sequence      &board_captures,
+                                        std::vector<bool>                 *success,
+                                        std::vector<unsigned long long>   *detection_times_ms = nullptr);
+
         // Update extrinsic data with single calibration board
         //ReturnCode UpdateExtrinsicsWithCalibrationBoard(const dlp::Image &board_image, bool *success);
 
         // Method to remove most recent calibration board added
         ReturnCode RemoveLastCalibrationBoard();
 
+        // Method to remove any calibration board by the order it was added
+        ReturnCode RemoveCalibrationBoard(const unsigned int &board_index);
+
+        // Per board errors of the last calibration and outlier removal
+        ReturnCode GetBoardReprojectionErrors(std::vector<double> *board_errors) const;
+        ReturnCode RemoveOutlierBoards(const double &error_ratio, std::vector<unsigned int> *removed_boards);
+
 
         // Calibrate methods
         ReturnCode Calibrate(double *reprojection_error);
-        ReturnCode Calibrate(double *reprojection_error,
-                            const bool &update_intrinsic,
-                            const bool &update_distortion,
-                            const bool &update_extrinsic);
+        virtual ReturnCode Calibrate(double *reprojection_error,
+                                     const bool &update_intrinsic,
+                                     const bool &update_distortion,
+                                     const bool &update_extrinsic);
+
+        // Calibrate independent modules on separate threads
+        static ReturnCode CalibrateConcurrently(const std::vector<Camera*> &modules,
+                                                std::vector<double>        *reprojection_errors);
 
 
     protected:
@@ -316,11 +361,15 @@ public:
 
         Parameters::SetTangentDistZero  zero_tangent_distortion_;       /**< See \ref dlp::Calibration::Camera::Setup() */
         Parameters::FixSixthOrderDist   fix_sixth_order_distortion_;    /**< See \ref dlp::Calibration::Camera::Setup() */
+        Parameters::WarmStart           warm_start_;                    /**< See \ref dlp::Calibration::Camera::Setup() */
 
         bool camera_set_;           /**< Boolean flag to track if SetCamera() was used  */
         Data calibration_data_;     /**< Member to store calibration data for model     */
         unsigned int board_number_successes_;   /**< Number of calibration boards successfully added for calibration */
 
+        bool warm_start_valid_;             /**< True if the stored intrinsic and distortion can seed the next calibration */
+        std::vector<double> board_errors_;  /**< RMS reprojection error of each board from the last calibration in the order the boards were added */
+
 
         std::vector<cv::Point3f> calibration_board_feature_points_xyz_; /**<
             Stores the physical x, y, z position of the calibration board features
@@ -337,6 +386,18 @@ public:
         // which is the camera pixel location of the feature.
         std::vector<std::vector<cv::Point2f>> image_points_xy_;
 
+        // Finds and refines the board features in a monochrome image. Safe to call from several threads.
+        // The downscaled coarse search is only used by the batch methods.
+        bool DetectBoardFeatures(const cv::Mat &board_image_mono, std::vector<cv::Point2f> *board_feature_locations_xy, const bool &coarse_search) const;
+
+        // Stores the RMS reprojection error of each board after a calibration
+        void StoreBoardErrors(const std::vector<std::vector<cv::Point3f>> &object_points,
+                              const std::vector<std::vector<cv::Point2f>> &image_points,
+                              const cv::Mat &intrinsic,
+                              const cv::Mat &distortion,
+                              const std::vector<cv::Mat> &rotation_vector,
+                              const std::vector<cv::Mat> &translation_vector);
+
     private:
         DISALLOW_COPY_AND_ASSIGN(Camera);
     };
@@ -396,6 +457,14 @@ public:
                                                          dlp::Image *board_image_projected,
                                                                bool *success);
 
+        // Separate and detect several projected boards concurrently
+        ReturnCode RemovePrinted_AddProjectedBoards(const std::vector<dlp::Image>   &projector_all_on,
+                                                    const std::vector<dlp::Image>   &projector_all_off,
+                                                    const std::vector<dlp::Image>   &board_images_printed_and_projected,
+                                                    std::vector<dlp::Image>         *board_images_projected,
+                                                    std::vector<bool>               *success,
+                                                    std::vector<unsigned long long> *detection_times_ms = nullptr);
+
         // Update extrinsic data with single calibration board
         ReturnCode RemovePrinted_UpdateExtrinsicsWithProjectedBoard(const dlp::Image &projector_all_on,
                                                                     const dlp::Image &projector_all_off,
@@ -436,6 +505,12 @@ public:
 
         DLP_Platform::Mirror   projector_mirror_type_; /**< Member to track DLP_Platform mirror type for calibration_board_feature_points_xyz_ generation */
 
+        // Thresholds the projected board out of the combination image. Safe to call from several threads.
+        ReturnCode RemovePrintedBoard(const dlp::Image &projector_all_on,
+                                      const dlp::Image &projector_all_off,
+                                      const dlp::Image &board_image_printed_and_projected,
+                                            dlp::Image *board_image_projected) const;
+
     private:
         DISALLOW_COPY_AND_ASSIGN(Projector);
     };
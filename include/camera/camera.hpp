@@ -11,6 +11,7 @@
 #include <common/other.hpp>                     // Adds dlp::CmdLine, Time, File, String, Number namespaces
 #include <common/returncode.hpp>                // Adds dlp::ReturnCode
 #include <common/image/image.hpp>               // Adds dlp::Image
+#include <common/buffer_pool.hpp>               // Adds dlp::BufferPool
 #include <common/parameters.hpp>                // Adds dlp::Parameter
 #include <camera/camera.hpp>                    // Adds dlp::Camera
 #include <common/capture/capture.hpp>           // Adds dlp::Capture and dlp::Capture::Sequence
@@ -61,6 +62,11 @@ public:
     };
 
 
+    Camera();
+
+    void        SetBufferPool(BufferPool *pool);
+    BufferPool* GetBufferPool() const;
+
     // Define by subclass
     virtual ReturnCode Connect(const std::string &id = "0") = 0;
     virtual ReturnCode Disconnect() = 0;
@@ -89,6 +95,9 @@ public:
 
     static void StartLiveView(dlp::Camera &camera, std::string title, std::atomic_bool &continue_view, const unsigned int &delay_ms = 16);
     static void StartBufferedView(  dlp::Camera &camera, std::string title, std::atomic_bool &continue_view, const unsigned int &delay_ms = 16);
+
+protected:
+    std::atomic<BufferPool*> buffer_pool_;  // Pool for frame memory, NULL to let OpenCV allocate each frame
 };
 
 /** @}*/
@@ -62,7 +62,7 @@ public:
         unsigned int            max_count;          /**< Stores the maximum size of the image bugger */
         std::atomic_bool        store_capture;      /**< Boolean flag to determine if recent images should be stored in the buffer  */
         std::atomic_bool        continue_capture;   /**< Boolean flag for capture thread to continue capture or to close the thread */
-        std::queue<cv::Mat>     queue;              /**< Image buffer queue */
+        std::queue<dlp::Image>  queue;              /**< Image buffer queue */
         std::atomic_flag        lock;               /**< Atomic flag so that different threads do not attempt to access data simultaneously */
     };
 
@@ -89,6 +89,8 @@ public:
         RAW8,      /*!< 8 bit raw data output of camera sensor         */
         MONO8,     /*!< 8 bit mono(grayscale) output of camera sensor  */
         RGB8,      /*!< R=G=B=8 bits RGB color output of camera sensor */
+        MONO12,    /*!< 12 bit packed mono output, unpacked to \ref dlp::Image::Format::MONO_USHORT */
+        MONO16,    /*!< 16 bit mono output as \ref dlp::Image::Format::MONO_USHORT */
         INVALID
     };
 
@@ -162,6 +164,8 @@ public:
     ReturnCode GetExposure(float* ret_exposure) const;
 
 private:
+    ReturnCode ConvertFrame(void *frame, Image *ret_frame);
+
     // Members to document whether camera is connected or started
     bool is_connected_;
     bool is_started_;
@@ -0,0 +1,110 @@
+/** @file      virtual_cam.hpp
+ *  @brief     Camera stand-in which captures the images of a virtual projector
+ *  @copyright 2016 Texas Instruments Incorporated - http://www.ti.com/ ALL RIGHTS RESERVED
+ */
+
+#ifndef DLP_SDK_VIRTUAL_CAM_HPP
+#define DLP_SDK_VIRTUAL_CAM_HPP
+
+// DLP Structured Light SDK header files
+#include <common/debug.hpp>                     // Adds dlp::Debug
+#include <common/other.hpp>                     // Adds dlp::CmdLine, Time, File, String, Number namespaces
+#include <common/returncode.hpp>                // Adds dlp::ReturnCode
+#include <common/image/image.hpp>               // Adds dlp::Image
+#include <common/parameters.hpp>                // Adds dlp::Parameter
+#include <camera/camera.hpp>                    // Adds dlp::Camera
+#include <common/capture/capture.hpp>           // Adds dlp::Capture and dlp::Capture::Sequence
+#include <dlp_platforms/virtual_projector/virtual_projector.hpp>   // Adds dlp::Virtual_Projector
+
+// C++ standard header files
+#include <chrono>                               // Adds std::chrono::steady_clock
+#include <string>                               // Adds std::string
+
+#define VIRTUAL_CAM_PROJECTOR_NOT_SET           "VIRTUAL_CAM_PROJECTOR_NOT_SET"
+#define VIRTUAL_CAM_NULL_POINTER                "VIRTUAL_CAM_NULL_POINTER"
+#define VIRTUAL_CAM_REFLECTANCE_INVALID         "VIRTUAL_CAM_REFLECTANCE_INVALID"
+
+namespace dlp {
+
+/** @class Virtual_Cam
+ *  @brief Camera stand-in which captures what a \ref dlp::Virtual_Projector
+ *         displays
+ *
+ *  Frames are resampled to the camera resolution. Capture sequences behave
+ *  like a camera triggered by the projector: each frame is returned once
+ *  its pattern period has ended, so the capture takes as long as it would
+ *  with hardware.
+ *
+ *  \ref Parameters::Ambient is added to the projected light, which is then
+ *  scaled by the shutter time over \ref Parameters::ReferenceShutter_MS and
+ *  by the scene reflectance set with \ref SetReflectance(). Frames saturate at
+ *  the maximum pixel value. This synthesizes the saturated and underexposed
+ *  frames of shiny and dark parts.
+ */
+class Virtual_Cam : public Camera
+{
+public:
+
+    class Parameters{
+    public:
+        DLP_NEW_PARAMETERS_ENTRY(Rows,      "VIRTUAL_CAM_PARAMETERS_ROWS",      unsigned int, 0);
+        DLP_NEW_PARAMETERS_ENTRY(Columns,   "VIRTUAL_CAM_PARAMETERS_COLUMNS",   unsigned int, 0);
+        DLP_NEW_PARAMETERS_ENTRY(ReferenceShutter_MS, "VIRTUAL_CAM_PARAMETERS_REFERENCE_SHUTTER_MS", float, 16.666);
+        DLP_NEW_PARAMETERS_ENTRY(Ambient,   "VIRTUAL_CAM_PARAMETERS_AMBIENT",   float,        0.0);
+    };
+
+    Virtual_Cam();
+    ~Virtual_Cam();
+
+    ReturnCode SetProjector(const dlp::Virtual_Projector *projector);
+    ReturnCode SetReflectance(const dlp::Image &reflectance);
+    void       ClearReflectance();
+
+    // Define pure virtual functions
+    ReturnCode Connect(const std::string &id = "0");
+    ReturnCode Disconnect();
+    ReturnCode Setup(const dlp::Parameters &settings);
+    ReturnCode GetSetup(dlp::Parameters *settings)const;
+    ReturnCode Start();
+    ReturnCode Stop();
+    ReturnCode GetFrame(Image* ret_frame);
+    ReturnCode GetFrameBuffered(Image* ret_frame);
+    ReturnCode GetCaptureSequence(const unsigned int &arg_number_captures,
+                                  Capture::Sequence* ret_capture_sequence);
+
+    bool isConnected() const;
+    bool isStarted() const;
+
+    ReturnCode GetID(std::string* ret_id) const;
+    ReturnCode GetRows(unsigned int* ret_rows) const;
+    ReturnCode GetColumns(unsigned int* ret_columns) const;
+
+    ReturnCode GetFrameRate(float* ret_framerate) const;
+    ReturnCode GetExposure(float* ret_exposure) const;
+
+private:
+    ReturnCode Expose(const dlp::Image &projected, dlp::Image *ret_frame) const;
+    ReturnCode Resample(const dlp::Image &projected, dlp::Image *ret_frame) const;
+
+    bool is_connected_;
+    bool is_started_;
+
+    std::string camera_id_;
+
+    const dlp::Virtual_Projector *projector_;
+
+    Parameters::Rows                    rows_;
+    Parameters::Columns                 columns_;
+    Camera::Parameters::FrameRate_HZ    frame_rate_;
+    Camera::Parameters::Shutter_MS      shutter_;
+    Parameters::ReferenceShutter_MS     reference_shutter_;
+    Parameters::Ambient                 ambient_;
+
+    cv::Mat reflectance_;
+
+    std::chrono::steady_clock::time_point last_frame_;
+};
+
+}
+
+#endif // DLP_SDK_VIRTUAL_CAM_HPP
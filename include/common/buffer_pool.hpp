@@ -0,0 +1,77 @@
+/** @file       buffer_pool.hpp
+ *  @ingroup    Common
+ *  @brief      Defines the BufferPool class which recycles frame memory
+ *  @copyright  2016 Texas Instruments Incorporated - http://www.ti.com/ ALL RIGHTS RESERVED
+ */
+
+#ifndef DLP_SDK_BUFFER_POOL_HPP
+#define DLP_SDK_BUFFER_POOL_HPP
+
+#include <common/returncode.hpp>
+#include <common/other.hpp>
+
+#include <cstddef>
+#include <memory>
+
+#define BUFFER_POOL_SIZE_INVALID                "BUFFER_POOL_SIZE_INVALID"
+#define BUFFER_POOL_ALLOCATION_FAILED           "BUFFER_POOL_ALLOCATION_FAILED"
+#define BUFFER_POOL_NULL_POINTER_ARGUMENT       "BUFFER_POOL_NULL_POINTER_ARGUMENT"
+
+/** @brief  Contains all DLP SDK classes, functions, etc. */
+namespace dlp{
+
+/** @class      BufferPool
+ *  @ingroup    Common
+ *  @brief      Size-bucketed pool of memory blocks for image and frame data
+ *
+ *  Requests are rounded up to a size bucket (within 1/8 of the requested
+ *  size) so frames of the same resolution and format share blocks. A block
+ *  is leased through a std::shared_ptr and goes back to its bucket when the
+ *  last copy of the lease is released. Since \ref dlp::Image copies share
+ *  their lease, clearing a \ref dlp::Capture::Sequence returns every frame
+ *  of that scan at once, unless a copy of a frame is still held elsewhere.
+ *
+ *  Leases stay valid if the pool is destroyed first. Their blocks are then
+ *  freed instead of recycled.
+ *
+ *  All methods are thread safe.
+ */
+class BufferPool{
+public:
+
+    /** @brief  Pool usage counters */
+    struct Statistics{
+        unsigned long long  hits;                   //!< Leases served from a free block
+        unsigned long long  misses;                 //!< Leases which allocated a new block
+        unsigned long long  returns;                //!< Blocks returned to the pool
+        unsigned long long  discards;               //!< Returned blocks freed because of the free bytes limit
+        size_t              leased_bytes;           //!< Bytes currently leased
+        size_t              free_bytes;             //!< Bytes waiting in the pool
+        size_t              resident_bytes;         //!< Leased and free bytes
+        size_t              peak_resident_bytes;    //!< Largest resident bytes since construction or \ref ResetStatistics()
+    };
+
+    BufferPool();
+    BufferPool(const size_t &max_free_bytes);
+    ~BufferPool();
+
+    ReturnCode Acquire(const size_t &bytes, std::shared_ptr<unsigned char> *ret_buffer);
+
+    void SetMaximumFreeBytes(const size_t &bytes);
+    void Trim();
+
+    Statistics GetStatistics() const;
+    void ResetStatistics();
+
+    static size_t GetBucketSize(const size_t &bytes);
+
+private:
+    DISALLOW_COPY_AND_ASSIGN(BufferPool);
+
+    struct State;
+    std::shared_ptr<State> state_;
+};
+
+}
+
+#endif // DLP_SDK_BUFFER_POOL_HPP
@@ -0,0 +1,82 @@
+/*! @file       capture_band_reader.hpp
+ *  @ingroup    group_Common
+ *  @brief      Defines \ref dlp::CaptureBandReader which streams rows of every
+ *              capture of a \ref dlp::Capture::Sequence
+ *  @copyright  2016 Texas Instruments Incorporated - http://www.ti.com/ ALL RIGHTS RESERVED
+ */
+
+#ifndef DLP_SDK_CAPTURE_BAND_READER_HPP
+#define DLP_SDK_CAPTURE_BAND_READER_HPP
+
+// DLP Structured Light SDK header files
+#include <common/returncode.hpp>                // Adds dlp::ReturnCode
+#include <common/image/image.hpp>               // Adds dlp::Image
+#include <common/capture/capture.hpp>           // Adds dlp::Capture
+
+// C++ standard header files
+#include <cstdio>                               // Adds FILE
+#include <vector>                               // Adds std::vector
+
+#include <opencv2/opencv.hpp>
+
+#define CAPTURE_BAND_READER_NOT_OPEN            "CAPTURE_BAND_READER_NOT_OPEN"
+#define CAPTURE_BAND_READER_NULL_POINTER        "CAPTURE_BAND_READER_NULL_POINTER"
+#define CAPTURE_BAND_READER_SIZE_INVALID        "CAPTURE_BAND_READER_SIZE_INVALID"
+#define CAPTURE_BAND_READER_FORMAT_INVALID      "CAPTURE_BAND_READER_FORMAT_INVALID"
+#define CAPTURE_BAND_READER_BAND_INVALID        "CAPTURE_BAND_READER_BAND_INVALID"
+#define CAPTURE_BAND_READER_SPILL_FAILED        "CAPTURE_BAND_READER_SPILL_FAILED"
+
+/** @brief  Contains all DLP SDK classes, functions, etc. */
+namespace dlp{
+
+/** @class      CaptureBandReader
+ *  @ingroup    group_Common
+ *  @brief      Returns the same rows of every capture of a sequence as
+ *              monochrome data without holding every frame in memory
+ *
+ *  \ref dlp::Capture::DataType::IMAGE_DATA captures are referenced and only
+ *  color captures are converted, one band at a time.
+ *  \ref dlp::Capture::DataType::IMAGE_FILE captures are loaded one at a time
+ *  and their monochrome rows are written to a temporary file, which is read
+ *  back band by band and deleted by \ref Close(). Apart from the frame being
+ *  loaded, memory use is bounded by the band size times the capture count.
+ */
+class CaptureBandReader{
+public:
+    CaptureBandReader();
+    ~CaptureBandReader();
+
+    ReturnCode Open(const Capture::Sequence &sequence,
+                    const unsigned int &first,
+                    const unsigned int &count);
+    void Close();
+    bool isOpen() const;
+
+    unsigned int GetCount() const;
+    unsigned int GetColumns() const;
+    unsigned int GetRows() const;
+    bool isSixteenBit() const;
+
+    ReturnCode Read(const cv::Rect &band, std::vector<cv::Mat> *frames);
+
+private:
+    // Not copyable since the temporary file is owned
+    CaptureBandReader(const CaptureBandReader &);
+    CaptureBandReader& operator=(const CaptureBandReader &);
+
+    ReturnCode CheckFrame(const int &columns, const int &rows, const int &type, const bool &first);
+
+    std::vector<cv::Mat>    frames_;        /**< Referenced capture data, empty for spilled captures */
+    std::vector<long long>  spill_offset_;  /**< Byte offset of each spilled capture, -1 if referenced */
+    std::vector<cv::Mat>    buffers_;       /**< Band memory reused by every \ref Read() */
+    std::FILE              *spill_;
+
+    unsigned int columns_;
+    unsigned int rows_;
+    int          type_;                     /**< Monochrome OpenCV type of every capture */
+    bool         open_;
+};
+
+}
+
+#endif // DLP_SDK_CAPTURE_BAND_READER_HPP
@@ -0,0 +1,103 @@
+/** @file       confidence_map.hpp
+ *  @ingroup    Common
+ *  @brief      Defines the ConfidenceMap class which stores how reliably each
+ *              pixel of a \ref dlp::DisparityMap was decoded
+ *  @copyright  2016 Texas Instruments Incorporated - http://www.ti.com/ ALL RIGHTS RESERVED
+ */
+
+#ifndef DLP_SDK_CONFIDENCE_MAP_HPP
+#define DLP_SDK_CONFIDENCE_MAP_HPP
+
+#include <common/returncode.hpp>
+#include <common/image/image.hpp>
+#include <common/disparity_map.hpp>
+
+#include <opencv2/opencv.hpp>
+
+#define CONFIDENCE_MAP_EMPTY                    "CONFIDENCE_MAP_EMPTY"
+#define CONFIDENCE_MAP_NULL_POINTER_ARGUMENT    "CONFIDENCE_MAP_NULL_POINTER_ARGUMENT"
+#define CONFIDENCE_MAP_RESOLUTION_INVALID       "CONFIDENCE_MAP_RESOLUTION_INVALID"
+
+/** @brief  Contains all DLP SDK classes, functions, etc. */
+namespace dlp{
+
+/** @class      ConfidenceMap
+ *  @ingroup    Common
+ *  @brief      Per pixel contrast measurements of a decoded \ref dlp::Capture::Sequence
+ *
+ *  Every measurement is in the units of the captured pixels, so 12-bit
+ *  captures have values 16 times larger than 8-bit captures.
+ *
+ *  - Modulation is the direct illumination, i.e. the difference between the
+ *    pixel lit and unlit by the pattern.
+ *  - Global is the illumination which does NOT come straight from the
+ *    projector such as ambient light, interreflections and subsurface
+ *    scattering. It is split from the direct light with the high frequency
+ *    method of Nayar et al, where a pixel unlit by a fine pattern still
+ *    receives half of the global light.
+ *  - Margin is the smallest difference between a capture and its reference
+ *    of any bit decision made for the pixel.
+ *
+ *  Pixels which were NOT decoded have zero in every measurement.
+ *  \ref dlp::StructuredLight modules reject pixels with a
+ *  \ref dlp::ConfidenceMap::Rejection while decoding and
+ *  \ref dlp::Geometry::GeneratePointCloud() can filter by one.
+ */
+class ConfidenceMap{
+public:
+
+    /** @brief  Limits a pixel must meet to be kept, limits set to zero are NOT checked */
+    struct Rejection{
+        Rejection();
+
+        bool isEnabled() const;
+
+        /** @brief Returns true if the measurements of a pixel meet every limit */
+        inline bool isAccepted(const float &modulation, const float &global, const float &margin) const{
+            if((this->minimum_modulation   > 0) && (modulation < this->minimum_modulation))  return false;
+            if((this->minimum_margin       > 0) && (margin     < this->minimum_margin))      return false;
+            if((this->maximum_global_ratio > 0) && (global > this->maximum_global_ratio * modulation)) return false;
+            return true;
+        }
+
+        float minimum_modulation;       /**< Smallest direct illumination */
+        float minimum_margin;           /**< Smallest bit decision margin */
+        float maximum_global_ratio;     /**< Largest ratio of global to direct illumination */
+    };
+
+    ConfidenceMap();
+    ~ConfidenceMap();
+
+    ReturnCode Create(const unsigned int &columns, const unsigned int &rows);
+    ReturnCode Create(const ConfidenceMap &map);
+    void Clear();
+    bool isEmpty() const;
+
+    ReturnCode GetColumns(unsigned int *columns) const;
+    ReturnCode GetRows(unsigned int *rows) const;
+
+    ReturnCode GetModulation(dlp::Image *modulation) const;
+    ReturnCode GetGlobal(dlp::Image *global) const;
+    ReturnCode GetMargin(dlp::Image *margin) const;
+
+    ReturnCode Unsafe_GetOpenCVData(cv::Mat *modulation, cv::Mat *global, cv::Mat *margin);
+
+    ReturnCode Reject(const Rejection &rejection,
+                      dlp::DisparityMap *disparity_map,
+                      unsigned long long *ret_rejected = nullptr) const;
+
+    static unsigned long long Unsafe_Reject(const Rejection &rejection,
+                                            const cv::Mat &modulation,
+                                            const cv::Mat &global,
+                                            const cv::Mat &margin,
+                                            cv::Mat *disparity);
+
+private:
+    cv::Mat modulation_;    /**< CV_32FC1 direct illumination */
+    cv::Mat global_;        /**< CV_32FC1 global illumination */
+    cv::Mat margin_;        /**< CV_32FC1 smallest bit decision margin */
+};
+
+}
+
+#endif // DLP_SDK_CONFIDENCE_MAP_HPP
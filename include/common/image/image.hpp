@@ -10,9 +10,12 @@
 #include <common/returncode.hpp>
 #include <common/debug.hpp>
 #include <common/other.hpp>
+#include <common/buffer_pool.hpp>
 
 #include <opencv2/opencv.hpp>
 
+#include <memory>
+
 #define IMAGE_FORMAT_UNKNOWN                    "IMAGE_FORMAT_UNKNOWN"
 #define IMAGE_FORMAT_NOT_MONO                   "IMAGE_FORMAT_NOT_MONO"
 #define IMAGE_EMPTY                             "IMAGE_EMPTY"
@@ -33,6 +36,7 @@
 #define IMAGE_NULL_POINTER_ARGUMENT_RET_VAL     "IMAGE_NULL_POINTER_ARGUMENT_RET_VAL"
 #define IMAGE_ALREADY_MONOCHROME                "IMAGE_ALREADY_MONOCHROME"
 #define IMAGE_ALREADY_RGB                       "IMAGE_ALREADY_RGB"
+#define IMAGE_PACKED_STEP_INVALID               "IMAGE_PACKED_STEP_INVALID"
 #define IMAGE_WINDOW_NAME_TAKEN                 "IMAGE_WINDOW_NAME_TAKEN"
 #define IMAGE_WINDOW_NOT_OPEN                   "IMAGE_WINDOW_NOT_OPEN"
 #define IMAGE_WINDOW_NULL_POINTER_KEY_RETURN    "IMAGE_WINDOW_NULL_POINTER_KEY_RETURN"
@@ -70,9 +74,16 @@ public:
         MONO_FLOAT,         /*!< monochrome float                           */
         MONO_DOUBLE,        /*!< monochrome double                          */
         RGB_UCHAR,          /*!< color (red, green, blue) unsigned char     */
+        MONO_USHORT,        /*!< monochrome unsigned short (10 to 16 bit)   */
         INVALID             /*!< invalid format or image has not been setup */
     };
 
+    /** @brief  Packed camera pixel layouts which unpack to \ref Format::MONO_USHORT */
+    enum class Packing{
+        MONO12_PACKED,      /*!< GigE Vision Mono12Packed, 2 pixels in 3 bytes: p0[11:4], p1[3:0] p0[3:0], p1[11:4] */
+        MONO12P             /*!< GenICam Mono12p, 2 pixels in 3 bytes LSB first: p0[7:0], p1[3:0] p0[11:8], p1[11:4] */
+    };
+
     /** @class      Window
      *  @ingroup    Common
      *  @brief      Displays a \ref dlp::Image with an OpenCV window
@@ -124,6 +135,15 @@ public:
     ReturnCode  Create(const Image &src_image );
     ReturnCode  Create(const cv::Mat &src_data );
 
+    ReturnCode  Create(const unsigned int &columns, const unsigned int &rows,
+                       const Format &format, BufferPool *pool);
+    ReturnCode  Create(const unsigned int &columns, const unsigned int &rows,
+                       const Format &format, void *data, const size_t &step, BufferPool *pool);
+    ReturnCode  Create(const cv::Mat &src_data, BufferPool *pool);
+
+    ReturnCode  CreateFromPacked(const unsigned int &columns, const unsigned int &rows,
+                                 const Packing &packing, const void *data, const size_t &step, BufferPool *pool);
+
     void Clear();
 
     bool isEmpty()const;
@@ -147,6 +167,7 @@ public:
     ReturnCode  GetMean( char          *ret_val) const;
     ReturnCode  GetMean( unsigned char *ret_val) const;
     ReturnCode  GetMean( PixelRGB      *ret_val) const;
+    ReturnCode  GetMean( unsigned short *ret_val) const;
     ReturnCode  GetMean( int           *ret_val) const;
     ReturnCode  GetMean( float         *ret_val) const;
     ReturnCode  GetMean( double        *ret_val) const;
@@ -154,12 +175,14 @@ public:
     ReturnCode  GetPixel( const unsigned int &x, const unsigned int &y,           char *ret_val) const;
     ReturnCode  GetPixel( const unsigned int &x, const unsigned int &y,  unsigned char *ret_val) const;
     ReturnCode  GetPixel( const unsigned int &x, const unsigned int &y,       PixelRGB *ret_val) const;
+    ReturnCode  GetPixel( const unsigned int &x, const unsigned int &y, unsigned short *ret_val) const;
     ReturnCode  GetPixel( const unsigned int &x, const unsigned int &y,            int *ret_val) const;
     ReturnCode  GetPixel( const unsigned int &x, const unsigned int &y,          float *ret_val) const;
     ReturnCode  GetPixel( const unsigned int &x, const unsigned int &y,         double *ret_val) const;
     void Unsafe_GetPixel( const unsigned int &x, const unsigned int &y,           char *ret_val) const;
     void Unsafe_GetPixel( const unsigned int &x, const unsigned int &y,  unsigned char *ret_val) const;
     void Unsafe_GetPixel( const unsigned int &x, const unsigned int &y,       PixelRGB *ret_val) const;
+    void Unsafe_GetPixel( const unsigned int &x, const unsigned int &y, unsigned short *ret_val) const;
     void Unsafe_GetPixel( const unsigned int &x, const unsigned int &y,            int *ret_val) const;
     void Unsafe_GetPixel( const unsigned int &x, const unsigned int &y,          float *ret_val) const;
     void Unsafe_GetPixel( const unsigned int &x, const unsigned int &y,         double *ret_val) const;
@@ -167,12 +190,14 @@ public:
     ReturnCode  SetPixel( const unsigned int &x, const unsigned int &y,           char arg_val);
     ReturnCode  SetPixel( const unsigned int &x, const unsigned int &y,  unsigned char arg_val);
     ReturnCode  SetPixel( const unsigned int &x, const unsigned int &y,       PixelRGB arg_val);
+    ReturnCode  SetPixel( const unsigned int &x, const unsigned int &y, unsigned short arg_val);
     ReturnCode  SetPixel( const unsigned int &x, const unsigned int &y,            int arg_val);
     ReturnCode  SetPixel( const unsigned int &x, const unsigned int &y,          float arg_val);
     ReturnCode  SetPixel( const unsigned int &x, const unsigned int &y,         double arg_val);
     void Unsafe_SetPixel( const unsigned int &x, const unsigned int &y,           char arg_val);
     void Unsafe_SetPixel( const unsigned int &x, const unsigned int &y,  unsigned char arg_val);
     void Unsafe_SetPixel( const unsigned int &x, const unsigned int &y,       PixelRGB arg_val);
+    void Unsafe_SetPixel( const unsigned int &x, const unsigned int &y, unsigned short arg_val);
     void Unsafe_SetPixel( const unsigned int &x, const unsigned int &y,            int arg_val);
     void Unsafe_SetPixel( const unsigned int &x, const unsigned int &y,          float arg_val);
     void Unsafe_SetPixel( const unsigned int &x, const unsigned int &y,         double arg_val);
@@ -180,6 +205,7 @@ public:
     ReturnCode  FillImage( unsigned char arg_val);
     ReturnCode  FillImage(          char arg_val);
     ReturnCode  FillImage(     PixelRGB arg_val);
+    ReturnCode  FillImage(unsigned short arg_val);
     ReturnCode  FillImage(           int arg_val);
     ReturnCode  FillImage(         float arg_val);
     ReturnCode  FillImage(        double arg_val);
@@ -193,6 +219,8 @@ protected:
     cv::Mat data_;
     Format  format_;
     bool    empty_;
+
+    std::shared_ptr<unsigned char> buffer_;     // Pooled memory behind data_, empty when OpenCV owns the data
 };
 
 namespace Number{
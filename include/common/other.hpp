@@ -15,6 +15,7 @@
 #include <cstdlib>
 #include <limits>   // for std::numeric_limits
 #include <iomanip>  // for setprecision()
+#include <functional>
 
 #define NUM_TO_STRING_PRECISION     16
 #define FILE_DOES_NOT_EXIST         "FILE_DOES_NOT_EXIST"
@@ -77,6 +78,17 @@ namespace Time{
         void Seconds(unsigned int time);
     }
 
+    /** @brief  Result of a single check passed to \ref dlp::Time::WaitUntil() */
+    enum class PollResult{
+        READY,          /**< Condition met, stop waiting            */
+        NOT_READY,      /**< Condition NOT met yet, check again     */
+        FAILED          /**< Check could NOT be made, stop waiting  */
+    };
+
+    PollResult WaitUntil(const std::function<PollResult()> &check,
+                         const unsigned long long &timeout_us,
+                         unsigned long long *elapsed_us = nullptr);
+
     /** @class Chronograph
      *  @brief  Measures time between laps and total time in milliseconds
      *  @ingroup group_Common
@@ -99,6 +111,18 @@ namespace Time{
     };
 }
 
+/** @brief  Contains helpers to split work across the available CPU cores
+ *  @ingroup group_Common
+ */
+namespace Thread{
+    unsigned int GetCount();
+
+    void ParallelFor(const unsigned long long &begin,
+                     const unsigned long long &end,
+                     const std::function<void(unsigned long long, unsigned long long)> &function,
+                     const unsigned long long &min_chunk = 1);
+}
+
 /** @brief  Contains common functions related to files
  *  @ingroup group_Common
  */
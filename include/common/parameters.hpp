@@ -14,6 +14,7 @@
 #include <iostream>
 #include <string>
 #include <vector>
+#include <unordered_map>
 
 #define PARAMETERS_EMPTY                        "PARAMETERS_EMPTY"
 #define PARAMETERS_SOURCE_EMPTY                 "PARAMETERS_SOURCE_EMPTY"
@@ -62,7 +63,9 @@ public:
     class Entry{
     public:
         void Set(const T &value){
-            this->value_ = value;
+            this->value_         = value;
+            this->value_cached_  = false;
+            this->source_cached_ = false;
         }
 
         T Get() const{
@@ -77,16 +80,32 @@ public:
             return this->name_;
         }
 
+        /** @brief Returns the value as a string
+         *  \note  The string is cached until the value changes
+         */
         std::string GetEntryValue() const{
-            return dlp::Number::ToString(this->value_);
+            if(!this->value_cached_){
+                this->value_string_ = dlp::Number::ToString(this->value_);
+                this->value_cached_ = true;
+            }
+            return this->value_string_;
         }
 
         std::string GetEntryDefault() const{
             return dlp::Number::ToString(this->default_);
         }
 
+        /** @brief Converts the string to the entry type and stores it
+         *  \note  The conversion is skipped if the string matches the one
+         *         the current value was converted from
+         */
         void SetEntryValue(const std::string &value){
-            this->value_ = dlp::String::ToNumber<T>(value);
+            if(this->source_cached_ && (value == this->source_string_)) return;
+
+            this->value_         = dlp::String::ToNumber<T>(value);
+            this->value_cached_  = false;
+            this->source_string_ = value;
+            this->source_cached_ = true;
         }
 
 
@@ -106,12 +125,20 @@ public:
             this->name_     = name;
             this->value_    = default_value;
             this->default_  = default_value;
+
+            this->value_cached_  = false;
+            this->source_cached_ = false;
         }
 
     private:
         std::string name_;
         T value_;
         T default_;
+
+        mutable std::string value_string_;
+        mutable bool        value_cached_  = false;
+        std::string         source_string_;
+        bool                source_cached_ = false;
     };
 
 
@@ -124,14 +151,22 @@ public:
     template <typename T>
     ReturnCode Get(Entry<T> *option) const{
         ReturnCode ret;
-        std::string return_value;
+        unsigned int index;
 
         // Check that point is NOT null
         if(!option) return ret.AddError(PARAMETERS_NULL_POINTER);
 
-        ret = this->Get(option->GetEntryName(),option->GetEntryDefault(),&return_value);
+        // Check that the entry has a name
+        if(option->GetEntryName().empty()) return ret.AddError(PARAMETERS_NO_NAME);
 
-        option->SetEntryValue(return_value);
+        if(this->Find(option->GetEntryName(),&index)){
+            option->SetEntryValue(this->values_[index]);
+        }
+        else{
+            // The parameter was NOT found, load the default value
+            option->Set(option->GetDefault());
+            ret.AddError(PARAMETERS_NOT_FOUND);
+        }
 
         return ret;
     }
@@ -204,8 +239,17 @@ public:
     std::string ToString();
 
     private:
+        static bool        isNormalizedName(const std::string &name);
+        static std::string NormalizeName(const std::string &name);
+
+        bool Find(const std::string &name, unsigned int *ret_index) const;
+        void Insert(const std::string &normalized_name, const std::string &value, const bool &update_current);
+
         std::vector<std::string> names_;
         std::vector<std::string> values_;
+
+        // Maps the upper case, trimmed name to its position in names_ and values_
+        std::unordered_map<std::string,unsigned int> index_;
 };
 
 }
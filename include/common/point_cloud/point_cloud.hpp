@@ -14,6 +14,10 @@
 #include <string>
 #include <vector>
 #include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
 
 #define POINT_CLOUD_EMPTY                   "POINT_CLOUD_EMPTY"
 #define POINT_CLOUD_INDEX_OUT_OF_RANGE      "POINT_CLOUD_INDEX_OUT_OF_RANGE"
@@ -25,6 +29,10 @@
 #define POINT_CLOUD_FILE_DOES_NOT_EXIST     "POINT_CLOUD_FILE_DOES_NOT_EXIST"
 #define POINT_CLOUD_FILE_OPEN_FAILED        "POINT_CLOUD_FILE_OPEN_FAILED"
 #define POINT_CLOUD_FILE_MISSING_DIMENSION  "POINT_CLOUD_FILE_MISSING_DIMENSION"
+#define POINT_CLOUD_VOXEL_SIZE_INVALID      "POINT_CLOUD_VOXEL_SIZE_INVALID"
+#define POINT_CLOUD_VOXEL_GRID_TOO_LARGE    "POINT_CLOUD_VOXEL_GRID_TOO_LARGE"
+#define POINT_CLOUD_NEIGHBOR_COUNT_INVALID  "POINT_CLOUD_NEIGHBOR_COUNT_INVALID"
+#define POINT_CLOUD_WINDOW_SHADERS_FAILED   "POINT_CLOUD_WINDOW_SHADERS_FAILED"
 
 /** @brief  Contains all DLP SDK classes, functions, etc. */
 namespace dlp{
@@ -57,38 +65,95 @@ public:
         ReturnCode SaveXYZ(const std::string &filename, const unsigned char &delimiter = ' ')const;
         ReturnCode LoadXYZ(const std::string &filename, const unsigned char &delimiter = ' ');
 
+        ReturnCode Extract(const std::vector<unsigned long long> &indices, Cloud *ret_cloud) const;
+
+        ReturnCode DownsampleVoxelGrid(const double &voxel_size, Cloud *ret_cloud) const;
+
+        ReturnCode SubsampleUniform(const double &voxel_size, std::vector<unsigned long long> *ret_indices) const;
+        ReturnCode SubsampleUniform(const double &voxel_size, Cloud *ret_cloud) const;
+
+        ReturnCode FilterRadiusOutliers(const double &radius, const unsigned int &min_neighbors,
+                                        std::vector<unsigned long long> *ret_indices) const;
+        ReturnCode FilterRadiusOutliers(const double &radius, const unsigned int &min_neighbors,
+                                        Cloud *ret_cloud) const;
+
+        ReturnCode FilterStatisticalOutliers(const unsigned int &neighbors, const double &std_dev_multiplier,
+                                             const double &search_radius,
+                                             std::vector<unsigned long long> *ret_indices) const;
+        ReturnCode FilterStatisticalOutliers(const unsigned int &neighbors, const double &std_dev_multiplier,
+                                             const double &search_radius,
+                                             Cloud *ret_cloud) const;
 
 
         /** @class  Window
          *  @brief   Displays a point cloud using GLFW interface
+         *
+         *  Points are drawn from an OpenGL vertex buffer and colored by depth
+         *  in a shader. Clouds larger than the point budget are drawn at a
+         *  voxel based level-of-detail.
          */
         class Window{
         public:
+
+            /** @brief  Render loop counters */
+            struct Statistics{
+                unsigned long long frames;              //!< Frames drawn
+                double             frame_time_ms;       //!< Duration of the last frame
+                double             frame_time_total_ms; //!< Duration of all frames
+                unsigned long long uploads;             //!< Clouds uploaded to the vertex buffer
+                double             upload_time_ms;      //!< Duration of the last upload
+                unsigned long long points_uploaded;     //!< Points in the last uploaded cloud
+                unsigned long long points_drawn;        //!< Points drawn in the last frame
+                unsigned int       lod_level;           //!< Level-of-detail of the last frame
+            };
+
+            /** @brief  OpenGL context used instead of a GLFW window, e.g. an
+             *          offscreen EGL pbuffer. The functions are called on
+             *          the render loop thread and keyboard and mouse input
+             *          is ignored.
+             */
+            struct Context{
+                typedef void (*Function)();
+                std::function<bool(unsigned int, unsigned int)> Create;         //!< Creates a width x height context and makes it current
+                std::function<Function(const char*)>            GetProcAddress; //!< Returns an OpenGL entry point of the current context
+                std::function<void()>                           SwapBuffers;    //!< Finishes the frame
+                std::function<void()>                           Destroy;        //!< Releases the context
+            };
+
             Window();
             ~Window();
 
             ReturnCode Open(const std::string &title, const unsigned int &width = 0, const unsigned int &height = 0); // Sized empty window
             ReturnCode Update(const dlp::Point::Cloud &cloud);
 
+            void SetPointBudget(const unsigned long long &points);
+            void SetContext(const Context &context);
+
+            Statistics GetStatistics();
+            void ResetStatistics();
+
             bool isOpen();
             void Close();
+
+            void SetDebugEnable(const bool &enable);
+            void SetDebugOutput(std::ostream* output);
         private:
+            struct Buffer;
+            static void PrepareBuffer(const std::vector<dlp::Point> &points,
+                                      const unsigned long long &lod_min_points,
+                                      Buffer *buffer);
             void Loop(std::string title, bool fullscreen, unsigned int width, unsigned int height);
             std::atomic_bool is_open_;
-            std::atomic_flag lock_data_access_;// = ATOMIC_FLAG_INIT;
-            std::atomic_flag close_window_;// = ATOMIC_FLAG_INIT;
-            std::vector<dlp::Point>    points_xyz_;
-            std::vector<dlp::Point>    points_xyz_original_;
-            std::vector<dlp::PixelRGB> points_rgb_;
-            double x_min;
-            double x_max;
-            double y_min;
-            double y_max;
-            double z_min;
-            double z_max;
-            double x_ave;
-            double y_ave;
-            double z_ave;
+            std::atomic_bool close_window_;
+            std::atomic_bool shaders_failed_;
+            std::thread      loop_thread_;
+            std::mutex              buffer_mutex_;
+            std::shared_ptr<Buffer> buffer_pending_;
+            std::atomic<unsigned long long> point_budget_;
+            std::mutex statistics_mutex_;
+            Statistics statistics_;
+            Context    context_;
+            dlp::Debug debug_;
         };
 
     private:
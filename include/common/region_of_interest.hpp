@@ -0,0 +1,70 @@
+/** @file       region_of_interest.hpp
+ *  @ingroup    Common
+ *  @brief      Defines the RegionOfInterest class which restricts decoding and
+ *              triangulation to part of a camera frame
+ *  @copyright  2016 Texas Instruments Incorporated - http://www.ti.com/ ALL RIGHTS RESERVED
+ */
+
+#ifndef DLP_SDK_REGION_OF_INTEREST_HPP
+#define DLP_SDK_REGION_OF_INTEREST_HPP
+
+#include <common/returncode.hpp>
+#include <common/other.hpp>
+#include <common/image/image.hpp>
+#include <common/disparity_map.hpp>
+
+#include <opencv2/opencv.hpp>
+
+#define REGION_OF_INTEREST_SIZE_INVALID             "REGION_OF_INTEREST_SIZE_INVALID"
+#define REGION_OF_INTEREST_MASK_EMPTY               "REGION_OF_INTEREST_MASK_EMPTY"
+#define REGION_OF_INTEREST_MASK_RESOLUTION_INVALID  "REGION_OF_INTEREST_MASK_RESOLUTION_INVALID"
+#define REGION_OF_INTEREST_OUTSIDE_FRAME            "REGION_OF_INTEREST_OUTSIDE_FRAME"
+#define REGION_OF_INTEREST_NULL_POINTER_ARGUMENT    "REGION_OF_INTEREST_NULL_POINTER_ARGUMENT"
+
+/** @brief  Contains all DLP SDK classes, functions, etc. */
+namespace dlp{
+
+/** @class      RegionOfInterest
+ *  @ingroup    Common
+ *  @brief      Rectangle and/or binary mask of the camera pixels to process
+ *
+ *  An empty object selects the whole frame. When both a rectangle and a mask
+ *  are set only the pixels inside the rectangle that are also set in the mask
+ *  are processed. All coordinates are in full frame pixels.
+ *
+ *  \ref dlp::StructuredLight modules only decode the bounding box of the
+ *  selected pixels and \ref dlp::Geometry only smooths and triangulates it.
+ *  Their outputs keep the full frame resolution and every pixel outside the
+ *  region is marked invalid.
+ */
+class RegionOfInterest{
+public:
+    RegionOfInterest();
+    RegionOfInterest(const unsigned int &x, const unsigned int &y,
+                     const unsigned int &columns, const unsigned int &rows);
+
+    void Clear();
+    bool isEmpty() const;
+
+    ReturnCode SetRectangle(const unsigned int &x, const unsigned int &y,
+                            const unsigned int &columns, const unsigned int &rows);
+    ReturnCode SetMask(const dlp::Image &mask);
+    ReturnCode SetMask(dlp::DisparityMap &previous_scan);
+
+    ReturnCode GetBounds(const unsigned int &image_columns,
+                         const unsigned int &image_rows,
+                         cv::Rect *bounds) const;
+    ReturnCode GetMask(const cv::Rect &bounds, cv::Mat *mask) const;
+
+private:
+    ReturnCode SetMaskData(const cv::Mat &mask);
+
+    bool        rectangle_set_;
+    cv::Rect    rectangle_;         /**< Selected rectangle in full frame pixels */
+    cv::Mat     mask_;              /**< CV_8UC1 full frame mask, nonzero pixels are processed */
+    cv::Rect    mask_bounds_;       /**< Bounding box of the nonzero mask pixels */
+};
+
+}
+
+#endif // DLP_SDK_REGION_OF_INTEREST_HPP
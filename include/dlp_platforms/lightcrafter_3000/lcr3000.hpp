@@ -18,6 +18,14 @@
 
 #include <stdint.h>
 
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
 #define ASIO_STANDALONE
 #include <asio.hpp>
 
@@ -58,6 +66,9 @@
 
 #define LCR3000_PATTERN_SEQUENCE_APPENDED_WITH_BLACK_PATTERNS   "LCR3000_PATTERN_SEQUENCE_APPENDED_WITH_BLACK_PATTERNS"
 #define LCR3000_IMAGE_RESOLUTION_INVALID    "LCR3000_IMAGE_RESOLUTION_INVALID"
+#define LCR3000_IMAGE_FORMAT_INVALID        "LCR3000_IMAGE_FORMAT_INVALID"
+#define LCR3000_IMAGE_INDEX_INVALID         "LCR3000_IMAGE_INDEX_INVALID"
+#define LCR3000_IMAGE_UPLOAD_FAILED         "LCR3000_IMAGE_UPLOAD_FAILED"
 
 
 namespace dlp{
@@ -360,6 +371,64 @@ namespace dlp{
             unsigned int image_bitplanes_;
         };
 
+        /** @brief  Sends pattern BMP images to the LightCrafter 3000 with
+         *          asynchronous asio operations on a background thread
+         *
+         *  Images are queued as soon as they are encoded and transmitted
+         *  in order using the LightCrafter 3000 packet protocol, so the
+         *  next image can be encoded while the previous one is sent. The
+         *  socket must NOT be used by other commands until \ref Finish()
+         *  returns.
+         */
+        class PatternUploader{
+        public:
+            PatternUploader(asio::io_service &io_service, asio::ip::tcp::socket *socket);
+            ~PatternUploader();
+
+            void       Queue(const LCR_PatternCount_t &pattern_number, const std::vector<unsigned char> &bmp);
+            ReturnCode Finish();
+
+            unsigned long long GetBytesSent() const;
+
+        private:
+            DISALLOW_COPY_AND_ASSIGN(PatternUploader);
+
+            void SendNextCommand();
+            void SendNextPacket();
+            void ReceiveResponseHeader();
+            void ReceiveResponseData();
+            void Fail(const std::string &error);
+
+            asio::io_service          &io_service_;
+            asio::ip::tcp::socket     *socket_;
+            std::unique_ptr<asio::io_service::work> work_;
+            std::thread                thread_;
+
+            // Only used by the asio thread
+            std::deque<std::shared_ptr<std::vector<unsigned char>>> commands_;  // Command payloads waiting to be sent
+            std::shared_ptr<std::vector<unsigned char>>             command_;   // Payload of the command being sent
+            unsigned long               command_sent_;          // Payload bytes already packetized
+            bool                        command_continued_;     // A packet of the current command has been sent
+            bool                        sending_;
+            bool                        failed_;
+            std::vector<unsigned char>  packet_;
+            std::vector<unsigned char>  response_;
+
+            std::mutex              mutex_;
+            std::condition_variable finished_;
+            unsigned long long      commands_queued_;
+            unsigned long long      commands_completed_;
+            std::string             error_;
+
+            std::atomic<unsigned long long> bytes_sent_;
+        };
+
+        static ReturnCode EncodePatternImageBMP(const dlp::Pattern::Sequence &sequence,
+                                                const unsigned int           &image_index,
+                                                const unsigned int           &columns,
+                                                const unsigned int           &rows,
+                                                std::vector<unsigned char>   *bmp);
+
 
 
         LCr3000();
@@ -421,6 +490,7 @@ namespace dlp{
         ReturnCode LCR_CMD_GetPatternSeqSetting(LCR_PatternSeqSetting_t *Setting);
 
         ReturnCode LCR_CMD_DefinePatternBMP(LCR_PatternCount_t PatternNum, char const *fileNameWithPath);
+        ReturnCode LCR_CMD_DefinePatternBMP(LCR_PatternCount_t PatternNum, const std::vector<unsigned char> &bmp);
 
         ReturnCode LCR_CMD_ReadPattern(LCR_PatternCount_t PatternNum, char *fileName);
 
@@ -501,6 +571,7 @@ namespace dlp{
         int LCR_CMD_PKT_GetData(uint8_t *data, unsigned long int size);
         uint32_t LCR_CMD_PKT_GetInt(unsigned int size);
         int LCR_CMD_PKT_PutFile(char const *fileName);
+        int LCR_CMD_PKT_PutBuffer(const std::vector<unsigned char> &buffer);
         int LCR_CMD_PKT_GetFile(char const *fileName,uint32_t size);
         int LCR_CMD_PKT_SendCommand();
 
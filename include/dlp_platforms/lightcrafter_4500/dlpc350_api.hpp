@@ -303,5 +303,8 @@ int DLPC350_OpenMailbox(int MboxNum);
 int DLPC350_CloseMailbox(void);
 int DLPC350_SetVarExpMboxAddr(int Addr);
 int DLPC350_MailboxSetAddr(int Addr);
+int DLPC350_BeginCommandPipeline(void);
+int DLPC350_EndCommandPipeline(void);
+void DLPC350_SetCommandPipelineWindow(unsigned int window);
 
 #endif // API_H
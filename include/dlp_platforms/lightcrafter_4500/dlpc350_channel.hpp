@@ -0,0 +1,72 @@
+/** @file       dlpc350_channel.hpp
+ *  @brief      Contains definitions for the pipelined DLPC350 USB HID command channel
+ *  @copyright  2016 Texas Instruments Incorporated - http://www.ti.com/ ALL RIGHTS RESERVED
+ */
+
+#ifndef DLP_DLPC350_CHANNEL_HPP
+#define DLP_DLPC350_CHANNEL_HPP
+
+#include <deque>
+#include <future>
+#include <vector>
+
+/** @brief  Contains all DLP SDK classes, functions, etc. */
+namespace dlp{
+
+/** @class  DLPC350_CommandChannel
+ *  @ingroup group_DLP_Platforms
+ *  @brief  Sends DLPC350 HID commands without waiting for each acknowledgement
+ *
+ *  Commands are written to the USB interface as soon as they are submitted.
+ *  Acknowledgements are collected later and matched to their command by the
+ *  sequence number in the message header. Acknowledgements are read when
+ *  the number of outstanding commands reaches the window size, when a
+ *  command's future is waited on, or when \ref DLPC350_CommandChannel::Flush()
+ *  is called.
+ *
+ *  The result of each command is the number of bytes written, -1 if the
+ *  USB transfer failed or timed out, or -2 if the DLPC350 replied with a NACK.
+ *
+ *  \note   Like the rest of the DLPC350 API this class is NOT thread safe and
+ *          the channel must outlive the futures it returns.
+ */
+class DLPC350_CommandChannel{
+public:
+    static const unsigned int WINDOW_DEFAULT = 16;
+    static const unsigned int WINDOW_MAXIMUM = 128;    /**< Must be less than the 256 sequence numbers */
+
+    DLPC350_CommandChannel();
+    ~DLPC350_CommandChannel();
+
+    std::shared_future<int> Submit(const std::vector<unsigned char> &packets,
+                                   const unsigned char &sequence,
+                                   const bool &ack_required);
+    void Drain();
+    int  Flush();
+    void Reset();
+
+    void               SetWindow(const unsigned int &window);
+    unsigned int       GetWindow() const;
+    unsigned int       GetOutstanding() const;
+    unsigned long long GetUnmatched() const;
+
+private:
+    struct Command{
+        unsigned char     sequence;
+        int               bytes_written;
+        std::promise<int> result;
+    };
+
+    bool ReadAck();
+    void Complete(const unsigned int &index, const int &result);
+    void FailOutstanding(const int &result);
+
+    std::deque<Command> outstanding_;
+    unsigned int        window_;
+    int                 status_;    // First failure since the last Flush()
+    unsigned long long  unmatched_; // Replies which did NOT belong to an outstanding command
+};
+
+}
+
+#endif // DLP_DLPC350_CHANNEL_HPP
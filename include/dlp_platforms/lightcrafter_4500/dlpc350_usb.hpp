@@ -41,16 +41,87 @@
 #ifndef DLPC350_USB_H
 #define DLPC350_USB_H
 
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <dlp_platforms/lightcrafter_4500/common.hpp>
+#include <dlp_platforms/lightcrafter_4500/dlpc350_channel.hpp>
+
 #define USB_MIN_PACKET_SIZE 64
 #define USB_MAX_PACKET_SIZE 64
 
 #define MY_VID 0x0451
 #define MY_PID 0x6401
 
+#define USB_READ_TIMEOUT_MS 2000
+
+typedef int (*DLPC350_USB_WriteFunction)(const unsigned char *pBuffer, int length);
+typedef int (*DLPC350_USB_ReadFunction)(unsigned char *pBuffer, int length, int timeout_ms);
+
+struct hid_device_;
+
+/**
+ * State of one DLPC350 connection. Every DLPC350_USB_* and DLPC350_* call
+ * uses the context selected for the calling thread with DLPC350_ContextLock,
+ * or a process wide default context when none is selected.
+ */
+struct DLPC350_Context
+{
+    DLPC350_Context();
+    ~DLPC350_Context();
+
+    hid_device_ *DeviceHandle;
+    std::string  DevicePath;
+    int          USBConnected;
+    bool         HidInitialized;
+
+    DLPC350_USB_WriteFunction TransportWrite;
+    DLPC350_USB_ReadFunction  TransportRead;
+
+    //In/Out buffers equal to HID endpoint size + 1
+    //First byte is for Windows internal use and it is always 0
+    unsigned char OutputBuffer[USB_MAX_PACKET_SIZE+1];
+    unsigned char InputBuffer[USB_MAX_PACKET_SIZE+1];
+
+    unsigned char     SeqNum;
+    unsigned long int PatLut[MAX_PAT_LUT_ENTRIES];
+    unsigned int      PatLutIndex;
+    unsigned long int ExpLut[MAX_VAR_EXP_PAT_LUT_ENTRIES*3];
+    unsigned int      ExpLutIndex;
+
+    dlp::DLPC350_CommandChannel Channel;
+    unsigned int                PipelineDepth;
+
+    std::recursive_mutex Mutex;
+};
+
+/**
+ * Locks a context and selects it for the calling thread until destroyed.
+ * Locks may be nested; the previously selected context is restored.
+ */
+class DLPC350_ContextLock
+{
+public:
+    explicit DLPC350_ContextLock(DLPC350_Context *context);
+    ~DLPC350_ContextLock();
+
+private:
+    std::unique_lock<std::recursive_mutex> lock_;
+    DLPC350_Context *previous_;
+};
+
+DLPC350_Context *DLPC350_GetContext();
+
 int DLPC350_USB_Open(void);
+int DLPC350_USB_OpenDevice(const char *id);
+int DLPC350_USB_Enumerate(std::vector<std::string> *serials, std::vector<std::string> *paths);
 int DLPC350_USB_IsConnected();
 int DLPC350_USB_Write();
 int DLPC350_USB_Read();
+int DLPC350_USB_WritePacket(const unsigned char *pBuffer);
+int DLPC350_USB_ReadPacket(unsigned char *pBuffer);
+void DLPC350_USB_SetTransport(DLPC350_USB_WriteFunction write, DLPC350_USB_ReadFunction read);
 int DLPC350_USB_Close();
 int DLPC350_USB_Init();
 int DLPC350_USB_Exit();
@@ -7,7 +7,13 @@
 #define DLP_LCR4500_HPP
 
 #include <atomic>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include <common/returncode.hpp>
 #include <common/other.hpp>
@@ -94,6 +100,7 @@
 #define LCR4500_READ_FLASH_LOAD_TIMING_FAILED               "LCR4500_READ_FLASH_LOAD_TIMING_FAILED"
 
 #define LCR4500_GET_STATUS_FAILED                           "LCR4500_GET_STATUS_FAILED"
+#define LCR4500_READY_TIMEOUT                               "LCR4500_READY_TIMEOUT"
 #define LCR4500_GET_OPERATING_MODE_FAILED                   "LCR4500_GET_OPERATING_MODE_FAILED"
 
 #define LCR4500_SEQUENCE_VALIDATION_FAILED                      "LCR4500_SEQUENCE_VALIDATION_FAILED"
@@ -119,7 +126,20 @@
 
 
 #define LCR4500_INVALID_ID  "LCR4500_INVALID_ID"
+#define LCR4500_SEQUENCE_ID_INVALID                         "LCR4500_SEQUENCE_ID_INVALID"
+#define LCR4500_NULL_POINTER_ARGUMENT                       "LCR4500_NULL_POINTER_ARGUMENT"
 
+#define LCR4500_VIDEO_FRAMES_EMPTY                          "LCR4500_VIDEO_FRAMES_EMPTY"
+#define LCR4500_VIDEO_FRAME_SEQUENCE_INVALID                "LCR4500_VIDEO_FRAME_SEQUENCE_INVALID"
+#define LCR4500_VIDEO_FRAME_PERIOD_EXCEEDED                 "LCR4500_VIDEO_FRAME_PERIOD_EXCEEDED"
+#define LCR4500_VIDEO_OUTPUT_FAILED                         "LCR4500_VIDEO_OUTPUT_FAILED"
+#define LCR4500_VIDEO_OUTPUT_NOT_OPEN                       "LCR4500_VIDEO_OUTPUT_NOT_OPEN"
+
+
+struct DLPC350_Context;
+
+typedef int (*DLPC350_USB_WriteFunction)(const unsigned char *pBuffer, int length);
+typedef int (*DLPC350_USB_ReadFunction)(unsigned char *pBuffer, int length, int timeout_ms);
 
 /** @brief  Contains all DLP SDK classes, functions, etc. */
 namespace dlp{
@@ -292,8 +312,8 @@ public:
         /** @class Source
          *  @brief Object for setting the input source of the pattern in the sequence.
          *
-         *  DLP SDK does not currently support using a source other than flash images.
-         *  A setting of true uses video port input, false sets flash image input.
+         *  Flash image sequences are created with \ref LCr4500::PreparePatternSequence()
+         *  and video port sequences with \ref LCr4500::PrepareVideoPatternSequence().
          */
         class Source{
         public:
@@ -610,6 +630,57 @@ public:
         DLP_NEW_PARAMETERS_ENTRY(PatternSequenceRepeat,     "LCR4500_PARAMETERS_PATTERN_SEQUENCE_REPEAT",   bool,   false);
 
         DLP_NEW_PARAMETERS_ENTRY(VerifyImageLoadTimeCount,  "LCR4500_PARAMETERS_VERIFY_IMAGE_LOAD_COUNT", unsigned int, 1);
+
+        DLP_NEW_PARAMETERS_ENTRY(ReadyTimeout,              "LCR4500_PARAMETERS_READY_TIMEOUT_MS",  unsigned int, 1000);
+
+        DLP_NEW_PARAMETERS_ENTRY(VideoFramePeriod,          "LCR4500_PARAMETERS_VIDEO_FRAME_PERIOD_US", unsigned int, 16667);
+    };
+
+    /** @class      VideoOutput
+     *  @brief      Streams frames created by \ref LCr4500::PrepareVideoPatternSequence()
+     *              to the LightCrafter 4500 video port through a fullscreen GLFW window
+     *
+     *  One frame is shown per VSYNC. The frames must reach the DLPC350 in the
+     *  order they were packed, so \ref Display() should be called before the
+     *  sequence is started.
+     */
+    class VideoOutput{
+    public:
+        VideoOutput();
+        ~VideoOutput();
+
+        ReturnCode Open(const unsigned int &monitor, const unsigned int &columns, const unsigned int &rows);
+        ReturnCode Display(const std::vector<dlp::Image> &frames, const bool &repeat);
+
+        unsigned long long GetFrameCount() const;
+
+        bool isOpen() const;
+        void Close();
+    private:
+        DISALLOW_COPY_AND_ASSIGN(VideoOutput);
+
+        void Loop(unsigned int monitor, std::promise<bool> *opened);
+
+        std::thread         loop_;
+        std::atomic_bool    is_open_;
+        std::atomic_bool    close_window_;
+        std::atomic<unsigned long long> frame_count_;
+
+        std::mutex          frames_mutex_;
+        std::vector<std::vector<unsigned char>> frames_;    // Bottom-up RGB rows for glDrawPixels
+        unsigned int        columns_;
+        unsigned int        rows_;
+        unsigned int        frame_index_;
+        bool                repeat_;
+    };
+
+    /** @brief  Functions used to poll the DLPC350 while waiting for a command
+     *          to take effect. Members which are empty use the DLPC350 API.
+     */
+    struct StatusReader{
+        std::function<int(unsigned char*, unsigned char*, unsigned char*)> GetStatus;           /**< Same as DLPC350_GetStatus() */
+        std::function<int(bool*)>                                          GetMode;             /**< Same as DLPC350_GetMode() */
+        std::function<int(bool*, unsigned int*)>                           CheckPatLutValidate; /**< Same as DLPC350_CheckPatLutValidate() */
     };
 
     LCr4500();
@@ -619,6 +690,11 @@ public:
     ReturnCode Disconnect();
     bool       isConnected() const;
 
+    static ReturnCode GetUSBDevices(std::vector<std::string> *serials, std::vector<std::string> *paths);
+
+    void SetTransport(DLPC350_USB_WriteFunction write, DLPC350_USB_ReadFunction read);
+    void SetStatusReader(const StatusReader &reader);
+
     ReturnCode Setup(const dlp::Parameters &settings);
     ReturnCode GetSetup(dlp::Parameters* settings)const;
 
@@ -626,10 +702,16 @@ public:
     ReturnCode ProjectSolidBlackPattern();
 
     ReturnCode PreparePatternSequence(const dlp::Pattern::Sequence &pattern_sequence);
+    ReturnCode PrepareVideoPatternSequence(const dlp::Pattern::Sequence &pattern_sequence, std::vector<dlp::Image> *frames);
     ReturnCode StartPatternSequence(const unsigned int &start, const unsigned int &patterns, const bool &repeat);
     ReturnCode DisplayPatternInSequence(const unsigned int &pattern_index, const bool &repeat);
     ReturnCode StopPatternSequence();
 
+    // Pattern lookup table bank
+    ReturnCode StoreSequence(const unsigned int &start, const unsigned int &patterns, const bool &repeat, unsigned int *sequence_id);
+    ReturnCode RecallSequence(const unsigned int &sequence_id);
+    void       ClearSequenceBank();
+
 
     // LightCrafter 4500 Specific methods
     ReturnCode PatternSettingsValid(dlp::Pattern &arg_pattern);
@@ -645,20 +727,51 @@ public:
 
     ReturnCode GetImageLoadTime(const unsigned int &index, const unsigned int &load_count, double *max_microseconds);
 
-    bool StartPatternImageStorage(const unsigned char &bitplane_position,
-                                  const unsigned char &mono_bpp,
-                                        unsigned char &ret_pattern_number);
+    static bool StartPatternImageStorage(const unsigned char &bitplane_position,
+                                         const unsigned char &mono_bpp,
+                                               unsigned char &ret_pattern_number);
+
+    static ReturnCode PackVideoFrames(const dlp::Pattern::Sequence &pattern_sequence,
+                                      const unsigned int           &columns,
+                                      const unsigned int           &rows,
+                                      std::vector<dlp::Image>      *frames,
+                                      dlp::Pattern::Sequence       *frame_sequence);
+    static ReturnCode UnpackVideoFrames(const std::vector<dlp::Image> &frames,
+                                        const dlp::Pattern::Sequence  &frame_sequence,
+                                        dlp::Pattern::Sequence        *pattern_sequence);
 
     bool FirmwareUploadInProgress();
 
     long long GetFirmwareUploadPercentComplete();
     long long GetFirmwareFlashEraseComplete();
 
+    unsigned long long GetSequenceSwitchTime() const;
+
 private:
 
-    unsigned int previous_sequence_start_;
-    unsigned int previous_sequence_patterns_;
-    bool         previous_sequence_repeat_;
+    /** @brief  Pattern and image lookup tables created from a pattern sequence
+     *          which are ready to be sent to the DLPC350
+     */
+    struct SequenceLut{
+        unsigned int start;                         /**< First prepared pattern used to create the tables */
+        unsigned int patterns;                      /**< Number of prepared patterns used to create the tables */
+        bool         repeat;                        /**< Sequence repeats after completing */
+        Pattern::Source::Enum source;               /**< Patterns are read from flash images or the video port */
+        unsigned int pattern_count;                 /**< Number of triggered patterns in the sequence */
+        std::vector<LCR4500_LUT_Entry> pattern_lut;
+        std::vector<unsigned char>     image_lut;
+        unsigned long long             hash;        /**< Hash of the table contents */
+    };
+
+    /** @brief  Part of the prepared sequence and the stored lookup table it created */
+    struct SequenceLutKey{
+        unsigned int start;
+        unsigned int patterns;
+        bool         repeat;
+        unsigned int sequence_id;   /**< Index in the sequence bank */
+    };
+
+    static unsigned long long HashSequenceLut(const SequenceLut &lut);
 
     // Pattern Sequence related methods
     static int DlpPatternColorToLCr4500Led(const dlp::Pattern::Color &color);
@@ -670,6 +783,14 @@ private:
 
     ReturnCode SavePatternIntImageAsRGBfile(Image &image_int, const std::string &filename);
     ReturnCode CreateSendStartSequenceLut(const dlp::Pattern::Sequence &arg_pattern_sequence);
+    ReturnCode CreateSequenceLut(const dlp::Pattern::Sequence &arg_pattern_sequence, SequenceLut *lut);
+    ReturnCode SendStartSequenceLut(const SequenceLut &lut);
+
+    // Methods which poll the DLPC350 until a command has taken effect
+    ReturnCode WaitForStatus(const std::string &step);
+    ReturnCode WaitForOperatingMode(const bool &mode);
+    ReturnCode WaitForSequencer(const bool &running, const std::string &step);
+    ReturnCode WaitForSequenceValidation(unsigned int *sequence_validation);
 
     // Setting members
     Parameters::DLPC350_Firmware            dlpc350_firmware_;
@@ -724,6 +845,8 @@ private:
     Parameters::TriggerOut2DelayRising  trigger_out_2_rising_;
 
     Parameters::VerifyImageLoadTimeCount    verify_image_load_;
+    Parameters::ReadyTimeout                ready_timeout_;
+    Parameters::VideoFramePeriod            video_frame_period_;
 
     FlashDevice myFlashDevice;
     std::string firmwarePath;
@@ -737,12 +860,24 @@ private:
     std::atomic <long long> firmware_upload_percent_erased_;
     std::atomic <long long> firmware_upload_percent_complete_;
 
+    std::shared_ptr<DLPC350_Context> dlpc350_context_;  // USB connection and DLPC350 API state of this device
+
     unsigned char status_hw_;
     unsigned char status_sys_;
     unsigned char status_main_;
 
+    StatusReader  status_reader_;
+
+    unsigned long long sequence_switch_time_us_;
+
+    std::vector<SequenceLut>    sequence_lut_bank_;
+    std::vector<SequenceLutKey> sequence_lut_keys_;     // Every range stored, including ones sharing a table
+    bool                     sequence_lut_active_;      // DLPC350 holds a validated LUT from this object
+    unsigned long long       sequence_lut_active_hash_;
+
     bool pattern_sequence_prepared_;
     dlp::Pattern::Sequence   pattern_sequence_;
+    Pattern::Source::Enum    pattern_sequence_source_;
 };
 
 namespace String{
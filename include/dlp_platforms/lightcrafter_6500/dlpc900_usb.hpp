@@ -40,13 +40,65 @@
 #ifndef DLPC900_USB_H
 #define DLPC900_USB_H
 
+#include <mutex>
+#include <string>
+#include <vector>
+
 #define USB_MIN_PACKET_SIZE 64
 #define USB_MAX_PACKET_SIZE 64
 
 #define MY_VID 0x0451
 #define MY_PID 0xC900
 
+struct hid_device_;
+
+/**
+ * State of one DLPC900 connection. Every DLPC900_USB_* and DLPC900_* call
+ * uses the context selected for the calling thread with DLPC900_ContextLock,
+ * or a process wide default context when none is selected.
+ */
+struct DLPC900_Context
+{
+    DLPC900_Context();
+    ~DLPC900_Context();
+
+    hid_device_ *DeviceHandle;
+    std::string  DevicePath;
+    int          USBConnected;
+    bool         HidInitialized;
+
+    //In/Out buffers equal to HID endpoint size + 1
+    //First byte is for Windows internal use and it is always 0
+    unsigned char OutputBuffer[USB_MAX_PACKET_SIZE+1];
+    unsigned char InputBuffer[USB_MAX_PACKET_SIZE+1];
+
+    unsigned char SeqNum;
+    unsigned char PatLut[12][512];
+    unsigned int  PatLutIndex;
+
+    std::recursive_mutex Mutex;
+};
+
+/**
+ * Locks a context and selects it for the calling thread until destroyed.
+ * Locks may be nested; the previously selected context is restored.
+ */
+class DLPC900_ContextLock
+{
+public:
+    explicit DLPC900_ContextLock(DLPC900_Context *context);
+    ~DLPC900_ContextLock();
+
+private:
+    std::unique_lock<std::recursive_mutex> lock_;
+    DLPC900_Context *previous_;
+};
+
+DLPC900_Context *DLPC900_GetContext();
+
 int DLPC900_USB_Open(void);
+int DLPC900_USB_OpenDevice(const char *id);
+int DLPC900_USB_Enumerate(std::vector<std::string> *serials, std::vector<std::string> *paths);
 int DLPC900_USB_IsConnected();
 int DLPC900_USB_Write();
 int DLPC900_USB_Read();
@@ -7,7 +7,9 @@
 #define DLP_LCR6500_HPP
 
 #include <atomic>
+#include <memory>
 #include <string>
+#include <vector>
 
 #include <common/returncode.hpp>
 #include <common/other.hpp>
@@ -124,6 +126,7 @@
 
 
 
+struct DLPC900_Context;
 
 /** @brief  Contains all DLP SDK classes, functions, etc. */
 namespace dlp{
@@ -542,6 +545,23 @@ the pattern sequence from the beginning */
     bool       UploadImages_InProgress();
     float      UploadImages_PercentComplete();
 
+    /** @brief  Counters of the DLPC900 image memory cache used by
+     *          \ref LCr6500::StartPatternSequence() and \ref LCr6500::DisplayPatternInSequence()
+     */
+    struct ImageCacheStatistics{
+        unsigned long long hits;                /**< Images already resident in a DLPC900 image slot */
+        unsigned long long misses;              /**< Images uploaded because they were NOT resident */
+        unsigned long long evictions;           /**< Resident images replaced to free a slot */
+        unsigned long long compressions;        /**< Composite images compressed */
+        unsigned long long compressions_reused; /**< Composite images whose previous compression was reused */
+        unsigned long long bytes_uploaded;      /**< Compressed image bytes sent over USB */
+        unsigned long long bytes_saved;         /**< Compressed image bytes NOT sent because of cache hits */
+    };
+
+    void GetImageCacheStatistics(ImageCacheStatistics *statistics);
+    void ResetImageCacheStatistics();
+    void ClearImageCache();
+
     bool StartPatternImageStorage(const unsigned char &bitplane_position,
                                   const unsigned char &mono_bpp,
                                         unsigned char &ret_pattern_number);
@@ -553,9 +573,11 @@ private:
 
     ReturnCode ConvertSequenceToLut(const dlp::Pattern::Sequence &pattern_sequence, std::vector<LCR6500_LUT_Entry> &sequence_LUT);
     ReturnCode SendLutWithImages(const std::vector<LCR6500_LUT_Entry> &dlpc900_lut , const bool &repeat);
-    ReturnCode UploadPrestoredCompressedImages(const unsigned char &start_index, const unsigned char &last_index);
+    ReturnCode AssignImageSlots(const std::vector<LCR6500_LUT_Entry> &dlpc900_lut, std::vector<int> *image_slots, std::vector<unsigned int> *missing_images);
+    ReturnCode UploadPrestoredCompressedImages(const std::vector<unsigned int> &image_indices, const std::vector<int> &image_slots);
     ReturnCode UploadCompressedImage(const unsigned char &fw_image_index, unsigned char *compressed_image_byte_array, const int &compressed_image_data_size);
     ReturnCode SavePatternIntImageAsRGBfile(Image &image_int, const std::string &filename);
+    static ReturnCode HashImageFile(const std::string &image_file, unsigned long long *hash);
 
     // Pattern Sequence related methods
     static int DlpPatternColorToLCr6500Led(const dlp::Pattern::Color &color);
@@ -633,6 +655,8 @@ private:
 
     bool        firmware_upload_restart_needed;
 
+    std::shared_ptr<DLPC900_Context> dlpc900_context_;  // USB connection and DLPC900 API state of this device
+
 
     std::atomic_flag        firmware_upload_in_progress = ATOMIC_FLAG_INIT;
     std::atomic <long long> firmware_upload_percent_erased_;
@@ -644,10 +668,20 @@ private:
     std::atomic<long long>  image_upload_total_data_size_;
     std::atomic<long long>  image_upload_total_data_size_sent_;
     std::atomic<float>      image_upload_percent_complete_;
-    int image_previous_first_;
-    int image_previous_last_;
+
+    /** @brief  Image held in one of the DLPC900 pattern on-the-fly image slots */
+    struct ImageSlot{
+        bool               resident;    /**< Slot holds a completely uploaded image */
+        unsigned long long hash;        /**< Hash of the composite image in the slot */
+        unsigned long long last_use;    /**< Value of image_slot_use_count_ when the slot was last used */
+    };
+
+    std::vector<ImageSlot>  image_slots_;
+    unsigned long long      image_slot_use_count_;
+    ImageCacheStatistics    image_cache_statistics_;
 
     std::vector<COMPRESSED_BITMAPIMAGES> compressed_images_;
+    std::vector<unsigned long long>      compressed_image_hashes_;  // Hash of the composite image file for each compressed image
     COMPRESSED_BITMAPIMAGES pattern_image_white_;
     COMPRESSED_BITMAPIMAGES pattern_image_black_;
 
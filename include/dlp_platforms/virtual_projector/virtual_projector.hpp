@@ -0,0 +1,101 @@
+/** @file   virtual_projector.hpp
+ *  @brief  Contains definitions for the DLP SDK virtual projector used in
+ *          place of DLP Platform hardware
+ *  @copyright  2016 Texas Instruments Incorporated - http://www.ti.com/ ALL RIGHTS RESERVED
+ */
+
+#ifndef DLP_SDK_VIRTUAL_PROJECTOR_HPP
+#define DLP_SDK_VIRTUAL_PROJECTOR_HPP
+
+#include <common/returncode.hpp>
+#include <common/debug.hpp>
+#include <common/other.hpp>
+#include <common/image/image.hpp>
+#include <common/pattern/pattern.hpp>
+#include <common/parameters.hpp>
+#include <dlp_platforms/dlp_platform.hpp>
+
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#define VIRTUAL_PROJECTOR_NOT_CONNECTED             "VIRTUAL_PROJECTOR_NOT_CONNECTED"
+#define VIRTUAL_PROJECTOR_PLATFORM_INVALID          "VIRTUAL_PROJECTOR_PLATFORM_INVALID"
+#define VIRTUAL_PROJECTOR_PATTERN_PERIOD_INVALID    "VIRTUAL_PROJECTOR_PATTERN_PERIOD_INVALID"
+#define VIRTUAL_PROJECTOR_PATTERN_TYPE_INVALID      "VIRTUAL_PROJECTOR_PATTERN_TYPE_INVALID"
+#define VIRTUAL_PROJECTOR_PATTERN_INDEX_INVALID     "VIRTUAL_PROJECTOR_PATTERN_INDEX_INVALID"
+#define VIRTUAL_PROJECTOR_SEQUENCE_NOT_STARTED      "VIRTUAL_PROJECTOR_SEQUENCE_NOT_STARTED"
+
+/** @brief  Contains all DLP SDK classes, functions, etc. */
+namespace dlp{
+
+/** @class      Virtual_Projector
+ *  @ingroup    DLP_Platforms
+ *  @brief      Software stand-in for a DLP Platform
+ *
+ *  The virtual projector keeps the prepared pattern images in memory and
+ *  tracks which pattern would be displayed from the time the sequence was
+ *  started and the pattern period. A \ref dlp::Virtual_Cam observing it
+ *  captures those images, so scanning pipelines can be run and timed
+ *  without hardware.
+ */
+class Virtual_Projector: public dlp::DLP_Platform{
+public:
+
+    class Parameters{
+    public:
+        DLP_NEW_PARAMETERS_ENTRY(PatternPeriod_US, "VIRTUAL_PROJECTOR_PARAMETERS_PATTERN_PERIOD_US", unsigned int, 8333);
+    };
+
+    Virtual_Projector();
+    ~Virtual_Projector();
+
+    ReturnCode Connect(std::string id);
+    ReturnCode Disconnect();
+    bool       isConnected() const;
+
+    ReturnCode Setup(const dlp::Parameters &settings);
+    ReturnCode GetSetup(dlp::Parameters *settings) const;
+
+    ReturnCode ProjectSolidWhitePattern();
+    ReturnCode ProjectSolidBlackPattern();
+
+    ReturnCode PreparePatternSequence(const dlp::Pattern::Sequence &pattern_sequence);
+    ReturnCode StartPatternSequence(const unsigned int &start, const unsigned int &patterns, const bool &repeat);
+    ReturnCode DisplayPatternInSequence(const unsigned int &pattern_index, const bool &repeat);
+    ReturnCode StopPatternSequence();
+
+    ReturnCode GetDisplayedImage(dlp::Image *ret_image) const;
+    ReturnCode GetSequenceImage(const unsigned int &offset,
+                                dlp::Image *ret_image,
+                                std::chrono::steady_clock::time_point *ret_display_end) const;
+
+private:
+    enum class Display{
+        BLACK,
+        WHITE,
+        PATTERN,
+        SEQUENCE
+    };
+
+    bool is_connected_;
+
+    Parameters::PatternPeriod_US    pattern_period_;
+    DLP_Platform::Parameters::Platform  emulated_platform_;
+
+    mutable std::mutex      display_mutex_;
+    Display                 display_;
+    unsigned int            display_start_;
+    unsigned int            display_count_;
+    bool                    display_repeat_;
+    std::chrono::steady_clock::time_point display_time_;
+
+    std::vector<dlp::Image> pattern_images_;
+    dlp::Image              black_image_;
+    dlp::Image              white_image_;
+};
+
+}
+
+#endif // DLP_SDK_VIRTUAL_PROJECTOR_HPP
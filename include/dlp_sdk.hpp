@@ -24,15 +24,20 @@
 #include <common/returncode.hpp>
 #include <common/debug.hpp>
 #include <common/other.hpp>
+#include <common/buffer_pool.hpp>
 #include <common/image/image.hpp>
 #include <common/parameters.hpp>
 #include <common/capture/capture.hpp>
+#include <common/capture/capture_band_reader.hpp>
 #include <common/pattern/pattern.hpp>
+#include <common/region_of_interest.hpp>
+#include <common/confidence_map.hpp>
 #include <common/point_cloud/point_cloud.hpp>
 #include <common/module.hpp>
 
 #include <camera/camera.hpp>
 #include <camera/opencv_cam/opencv_cam.hpp>
+#include <camera/virtual_cam/virtual_cam.hpp>
 #include <camera/pg_flycap2/pg_flycap2_c.hpp>
 
 #include <structured_light/structured_light.hpp>
@@ -40,12 +45,15 @@
 #include <structured_light/three_phase/three_phase.hpp>
 
 #include <dlp_platforms/dlp_platform.hpp>
+#include <dlp_platforms/virtual_projector/virtual_projector.hpp>
 // #include <dlp_platforms/lightcrafter_3000/lcr3000.hpp>
 #include <dlp_platforms/lightcrafter_4500/lcr4500.hpp>
 // #include <dlp_platforms/lightcrafter_6500/lcr6500.hpp>
 
 #include <calibration/calibration.hpp>
 #include <geometry/geometry.hpp>
+#include <scanner/hdr_capture.hpp>
+#include <scanner/scan_scheduler.hpp>
 
 //new added 
 #include <dlp_platforms/lightcrafter_4500/common.hpp>
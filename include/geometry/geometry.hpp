@@ -3,6 +3,9 @@
  *  @copyright  2016 Texas Instruments Incorporated - http://www.ti.com/ ALL RIGHTS RESERVED
  */
 
+#ifndef DLP_SDK_GEOMETRY_HPP
+#define DLP_SDK_GEOMETRY_HPP
+
 #include <common/debug.hpp>
 #include <common/returncode.hpp>
 #include <common/image/image.hpp>
@@ -10,6 +13,8 @@
 #include <common/pattern/pattern.hpp>
 #include <common/point_cloud/point_cloud.hpp>
 #include <common/disparity_map.hpp>
+#include <common/region_of_interest.hpp>
+#include <common/confidence_map.hpp>
 #include <common/module.hpp>
 #include <calibration/calibration.hpp>
 
@@ -36,6 +41,8 @@
 #define GEOMETRY_SETTINGS_EMPTY                             "GEOMETRY_SETTINGS_EMPTY"
 #define GEOMETRY_POINT_CLOUD_EMPTY                          "GEOMETRY_POINT_CLOUD_EMPTY"
 #define GEOMETRY_PLANE_ORIENTATION_INVALID                  "GEOMETRY_PLANE_ORIENTATION_INVALID"
+#define GEOMETRY_VIEWPORT_DISPARITY_COUNT_INVALID           "GEOMETRY_VIEWPORT_DISPARITY_COUNT_INVALID"
+#define GEOMETRY_COLOR_MAP_INVALID                          "GEOMETRY_COLOR_MAP_INVALID"
 
 #define GEOMETRY_TAN_2  -2.18503986326152
 
@@ -67,6 +74,14 @@ public:
         INVALID
     };
 
+    /** @brief Color scales for \ref dlp::Geometry::ConvertDistanceMapToColor() */
+    enum class ColorMap{
+        RAINBOW,        /*!< near is red, far is magenta to black   */
+        JET,            /*!< near is red, far is blue               */
+        GRAYSCALE,      /*!< near is white, far is black            */
+        INVALID
+    };
+
     class Parameters{
     public:
         DLP_NEW_PARAMETERS_ENTRY(ScaleXYZ,              "GEOMETRY_PARAMETERS_SCALE_XYZ", double, 1.0);
@@ -106,6 +121,13 @@ public:
         double d;
     };
 
+    /** @brief Camera pixel a point cloud point was triangulated from */
+    struct PointSource{
+        unsigned int viewport_id;
+        unsigned int column;
+        unsigned int row;
+    };
+
     /** @class ViewPoint
      *  @brief Contains the camera or projector XYZ position in space and its optical rays and planes
      * */
@@ -122,6 +144,9 @@ public:
         std::vector<PlaneEquation> plane_rows;
         std::vector<PlaneEquation> plane_diamond_angle_1;
         std::vector<PlaneEquation> plane_diamond_angle_2;
+
+        // Camera pixels which are smoothed and triangulated
+        dlp::RegionOfInterest region;
     };
 
     Geometry();
@@ -139,6 +164,9 @@ public:
 
     ReturnCode GetNumberOfViews(unsigned int *viewports);
 
+    ReturnCode SetRegionOfInterest(const unsigned int &viewport_id,
+                                   const dlp::RegionOfInterest &region);
+
     // Origin_x is the decoded value from the vertical patterns
     // Origin_y is the decoded value from the horizontal patterns
     // Viewport x & y are the camera pixel location
@@ -164,6 +192,12 @@ public:
                                             const unsigned int &viewport_x, const unsigned int &viewport_y,
                                             Point *ret_xyz);
 
+    void Unsafe_Find3dPlaneLineIntersection(const double &origin_plane,
+                                            dlp::Pattern::Orientation orientation,
+                                            const unsigned int &viewport_id,
+                                            const unsigned int &viewport_x, const unsigned int &viewport_y,
+                                            Point *ret_xyz);
+
 
 
     ReturnCode GeneratePointCloud(const unsigned int  &viewport_id,
@@ -172,13 +206,71 @@ public:
                                     dlp::Point::Cloud   *ret_cloud,
                                     dlp::Image          *ret_distancemap);
 
+    ReturnCode GeneratePointCloud(const unsigned int  &viewport_id,
+                                    dlp::DisparityMap   &disparity_1,
+                                    dlp::DisparityMap   &disparity_2,
+                                    dlp::Point::Cloud   *ret_cloud,
+                                    dlp::Image          *ret_distancemap,
+                                    std::vector<PointSource> *ret_sources);
+
+    ReturnCode GeneratePointCloud(std::vector<dlp::DisparityMap> &disparity_1,
+                                  std::vector<dlp::DisparityMap> &disparity_2,
+                                  const double                   &merge_voxel_size,
+                                  dlp::Point::Cloud              *ret_cloud,
+                                  std::vector<PointSource>       *ret_sources,
+                                  std::vector<dlp::Image>        *ret_distancemaps = nullptr);
+
 
     ReturnCode GeneratePointCloud(  const unsigned int  &viewport_id,
                                     dlp::DisparityMap   &disparity,
                                     dlp::Point::Cloud   *ret_cloud,
                                     dlp::Image          *ret_distancemap);
 
+    ReturnCode GeneratePointCloud(const unsigned int                  &viewport_id,
+                                  dlp::DisparityMap                   &disparity,
+                                  const dlp::ConfidenceMap            &confidence,
+                                  const dlp::ConfidenceMap::Rejection &rejection,
+                                  dlp::Point::Cloud                   *ret_cloud,
+                                  dlp::Image                          *ret_distancemap);
+
+    ReturnCode GeneratePointCloud(const unsigned int                  &viewport_id,
+                                  dlp::DisparityMap                   &disparity_1,
+                                  const dlp::ConfidenceMap            &confidence_1,
+                                  dlp::DisparityMap                   &disparity_2,
+                                  const dlp::ConfidenceMap            &confidence_2,
+                                  const dlp::ConfidenceMap::Rejection &rejection,
+                                  dlp::Point::Cloud                   *ret_cloud,
+                                  dlp::Image                          *ret_distancemap);
+
+    ReturnCode GetViewportResolution(const unsigned int &viewport_id,
+                                     unsigned int *columns,
+                                     unsigned int *rows) const;
+
+    void Unsafe_GeneratePointCloudTile(const unsigned int  &viewport_id,
+                                       const dlp::Pattern::Orientation &orientation,
+                                       const unsigned int  &disparity_sampling,
+                                       const cv::Rect      &tile,
+                                       const cv::Mat       &disparity,
+                                       std::vector<dlp::Point> *ret_points,
+                                       dlp::Image          *ret_distancemap);
+
+    unsigned int GetSmoothingRadius(const dlp::Pattern::Orientation &orientation) const;
+
+    void Unsafe_GeneratePointCloudBand(const unsigned int  &viewport_id,
+                                       const dlp::Pattern::Orientation &orientation,
+                                       const unsigned int  &disparity_sampling,
+                                       const cv::Rect      &band,
+                                       const cv::Rect      &core,
+                                       const cv::Mat       &disparity,
+                                       std::vector<dlp::Point> *ret_points,
+                                       dlp::Image          *ret_distancemap);
+
     static ReturnCode ConvertDistanceMapToColor(const dlp::Image &distance_map, dlp::Image *color_depth);
+    static ReturnCode ConvertDistanceMapToColor(const dlp::Image &distance_map,
+                                                const ColorMap   &color_map,
+                                                const double     &range_min,
+                                                const double     &range_max,
+                                                dlp::Image       *color_depth);
 
 
     static ReturnCode CalculateFlatness(const dlp::Point::Cloud &cloud, double *flatness);
@@ -239,6 +331,26 @@ private:
 
     static PlaneEquation FitPlane(const cv::Mat &points);
 
+    const std::vector<PlaneEquation>& GetOriginPlanes(const dlp::Pattern::Orientation &orientation) const;
+    bool GetPlaneSampling(const dlp::Pattern::Orientation &orientation,
+                          unsigned int *sampling,
+                          unsigned int *plane_count) const;
+
+    static void ConvertDisparityToPlaneIndex(const cv::Mat &disparity, const cv::Mat &mask,
+                                             const double &plane_scale, cv::Mat *plane_index);
+    static void SmoothPlaneIndex(const unsigned int &geometry_sampling, cv::Mat *plane_index);
+    void Unsafe_TriangulatePlaneIndex(const unsigned int &viewport_id,
+                                      const dlp::Pattern::Orientation &orientation,
+                                      const unsigned int &plane_count,
+                                      const cv::Rect &tile,
+                                      const cv::Mat &plane_index,
+                                      std::vector<dlp::Point> *ret_points,
+                                      dlp::Image *ret_distancemap);
+    void Unsafe_IntersectViewportRay(const PlaneEquation &plane_eq,
+                                     const unsigned int &viewport_id,
+                                     const unsigned int &viewport_x, const unsigned int &viewport_y,
+                                     Point *ret_xyz);
+
 };
 
 namespace Number{
@@ -252,3 +364,5 @@ template <> dlp::Geometry::PositiveDirectionY ToNumber( const std::string &text,
 }
 
 }
+
+#endif // DLP_SDK_GEOMETRY_HPP
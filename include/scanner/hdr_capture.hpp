@@ -0,0 +1,127 @@
+/** @file   hdr_capture.hpp
+ *  @brief  Contains definitions for the DLP SDK multi-exposure capture fusion
+ *  @copyright  2016 Texas Instruments Incorporated - http://www.ti.com/ ALL RIGHTS RESERVED
+ */
+
+#ifndef DLP_SDK_HDR_CAPTURE_HPP
+#define DLP_SDK_HDR_CAPTURE_HPP
+
+#include <common/returncode.hpp>
+#include <common/debug.hpp>
+#include <common/other.hpp>
+#include <common/image/image.hpp>
+#include <common/parameters.hpp>
+#include <common/capture/capture.hpp>
+#include <common/module.hpp>
+#include <camera/camera.hpp>
+#include <dlp_platforms/dlp_platform.hpp>
+
+#include <string>
+#include <vector>
+
+#define HDR_CAPTURE_NULL_POINTER_ARGUMENT       "HDR_CAPTURE_NULL_POINTER_ARGUMENT"
+#define HDR_CAPTURE_CAMERA_NOT_SET              "HDR_CAPTURE_CAMERA_NOT_SET"
+#define HDR_CAPTURE_DLP_PLATFORM_NOT_SET        "HDR_CAPTURE_DLP_PLATFORM_NOT_SET"
+#define HDR_CAPTURE_EXPOSURES_MISSING           "HDR_CAPTURE_EXPOSURES_MISSING"
+#define HDR_CAPTURE_EXPOSURE_INVALID            "HDR_CAPTURE_EXPOSURE_INVALID"
+#define HDR_CAPTURE_FUSION_INVALID              "HDR_CAPTURE_FUSION_INVALID"
+#define HDR_CAPTURE_SEQUENCE_COUNT_INVALID      "HDR_CAPTURE_SEQUENCE_COUNT_INVALID"
+#define HDR_CAPTURE_SEQUENCE_SIZE_INVALID       "HDR_CAPTURE_SEQUENCE_SIZE_INVALID"
+#define HDR_CAPTURE_DATA_TYPE_INVALID           "HDR_CAPTURE_DATA_TYPE_INVALID"
+#define HDR_CAPTURE_IMAGE_SIZE_INVALID          "HDR_CAPTURE_IMAGE_SIZE_INVALID"
+#define HDR_CAPTURE_IMAGE_FORMAT_INVALID        "HDR_CAPTURE_IMAGE_FORMAT_INVALID"
+#define HDR_CAPTURE_CAPTURE_BIT_DEPTH_INVALID   "HDR_CAPTURE_CAPTURE_BIT_DEPTH_INVALID"
+#define HDR_CAPTURE_SATURATION_LEVEL_MISSING    "HDR_CAPTURE_SATURATION_LEVEL_MISSING"
+
+#define HDR_CAPTURE_SATURATION_LEVEL_8BIT       250
+
+/** @brief  Contains all DLP SDK classes, functions, etc. */
+namespace dlp{
+
+/** @class      HdrCapture
+ *  @brief      Captures a pattern sequence at several camera exposures and
+ *              fuses them into one sequence for decoding
+ *
+ *  Shiny parts saturate at exposures long enough for dark parts to exceed the
+ *  decoding threshold. The sequence is captured once per exposure by setting
+ *  \ref dlp::Camera::Parameters::Shutter_MS and the captures are fused per
+ *  pixel before they are passed to \ref dlp::StructuredLight::DecodeCaptureSequence().
+ *
+ *  Every capture of a pixel is taken from the same exposures so the
+ *  comparisons between patterns made by the decoders remain valid.
+ *  \ref Fusion::BEST_CONTRAST keeps the capture depth and selects, for each
+ *  pixel, the exposure whose sequence has the largest difference between its
+ *  brightest and darkest capture without reaching
+ *  \ref Parameters::SaturationLevel. \ref Fusion::RADIANCE_WEIGHTED averages
+ *  the unsaturated captures of every exposure weighted by their exposure time
+ *  and returns \ref dlp::Image::Format::MONO_USHORT captures scaled to the
+ *  longest exposure, so decoding thresholds are given in its units.
+ *
+ *  A \ref Parameters::SaturationLevel of 0 selects the level from the depth
+ *  of the captures, \ref HDR_CAPTURE_SATURATION_LEVEL_8BIT for
+ *  \ref dlp::Image::Format::MONO_UCHAR. A 16-bit container does NOT tell how
+ *  many bits the camera fills, e.g. Mono12 tops out at 4095, so
+ *  \ref dlp::Image::Format::MONO_USHORT captures need
+ *  \ref Parameters::CaptureBitDepth and the 8-bit level is shifted up to it.
+ *
+ *  Rows are fused in parallel and the inner loops run over contiguous pixels
+ *  so the compiler can vectorize them.
+ */
+class HdrCapture: public dlp::Module{
+public:
+
+    enum class Fusion{
+        BEST_CONTRAST,      /*!< Select the unsaturated exposure with the most contrast for each pixel  */
+        RADIANCE_WEIGHTED,  /*!< Merge the unsaturated exposures into 16-bit radiance                   */
+        INVALID
+    };
+
+    class Parameters{
+    public:
+        DLP_NEW_PARAMETERS_ENTRY(FusionMethod,      "HDR_CAPTURE_PARAMETERS_FUSION_METHOD",     Fusion,       Fusion::BEST_CONTRAST);
+        DLP_NEW_PARAMETERS_ENTRY(SaturationLevel,   "HDR_CAPTURE_PARAMETERS_SATURATION_LEVEL",  unsigned int, 0);
+        DLP_NEW_PARAMETERS_ENTRY(BlackLevel,        "HDR_CAPTURE_PARAMETERS_BLACK_LEVEL",       unsigned int, 0);
+        DLP_NEW_PARAMETERS_ENTRY(CaptureBitDepth,   "HDR_CAPTURE_PARAMETERS_CAPTURE_BIT_DEPTH", unsigned int, 0);
+    };
+
+    HdrCapture();
+    ~HdrCapture();
+
+    ReturnCode Setup(const dlp::Parameters &settings);
+    ReturnCode GetSetup(dlp::Parameters *settings) const;
+
+    ReturnCode SetCamera(dlp::Camera *camera);
+    ReturnCode SetDlpPlatform(dlp::DLP_Platform *projector);
+    ReturnCode SetExposures(const std::vector<float> &shutter_ms);
+    void       GetExposures(std::vector<float> *shutter_ms) const;
+
+    ReturnCode CaptureSequence(const unsigned int &pattern_start,
+                               const unsigned int &pattern_count,
+                               Capture::Sequence *ret_capture_sequence);
+
+    ReturnCode Fuse(const std::vector<Capture::Sequence> &exposure_sequences,
+                    Capture::Sequence *ret_capture_sequence) const;
+
+private:
+    Parameters::FusionMethod    fusion_method_;
+    Parameters::SaturationLevel saturation_level_;
+    Parameters::BlackLevel      black_level_;
+    Parameters::CaptureBitDepth capture_bit_depth_;
+
+    std::vector<float>  exposures_;
+
+    dlp::Camera        *camera_;
+    dlp::DLP_Platform  *projector_;
+};
+
+namespace Number{
+template <> std::string ToString<dlp::HdrCapture::Fusion>( dlp::HdrCapture::Fusion fusion );
+}
+
+namespace String{
+template <> dlp::HdrCapture::Fusion ToNumber( const std::string &text, unsigned int base );
+}
+
+}
+
+#endif // DLP_SDK_HDR_CAPTURE_HPP
@@ -0,0 +1,192 @@
+/** @file   scan_scheduler.hpp
+ *  @brief  Contains definitions for the DLP SDK pipelined scan scheduler
+ *  @copyright  2016 Texas Instruments Incorporated - http://www.ti.com/ ALL RIGHTS RESERVED
+ */
+
+#ifndef DLP_SDK_SCAN_SCHEDULER_HPP
+#define DLP_SDK_SCAN_SCHEDULER_HPP
+
+#include <common/returncode.hpp>
+#include <common/debug.hpp>
+#include <common/other.hpp>
+#include <common/image/image.hpp>
+#include <common/parameters.hpp>
+#include <common/capture/capture.hpp>
+#include <common/disparity_map.hpp>
+#include <common/point_cloud/point_cloud.hpp>
+#include <common/module.hpp>
+#include <camera/camera.hpp>
+#include <dlp_platforms/dlp_platform.hpp>
+#include <structured_light/structured_light.hpp>
+#include <geometry/geometry.hpp>
+#include <scanner/hdr_capture.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#define SCAN_SCHEDULER_NULL_POINTER_ARGUMENT    "SCAN_SCHEDULER_NULL_POINTER_ARGUMENT"
+#define SCAN_SCHEDULER_QUEUE_DEPTH_INVALID      "SCAN_SCHEDULER_QUEUE_DEPTH_INVALID"
+#define SCAN_SCHEDULER_CAMERA_NOT_SET           "SCAN_SCHEDULER_CAMERA_NOT_SET"
+#define SCAN_SCHEDULER_DLP_PLATFORM_NOT_SET     "SCAN_SCHEDULER_DLP_PLATFORM_NOT_SET"
+#define SCAN_SCHEDULER_STRUCTURED_LIGHT_NOT_SET "SCAN_SCHEDULER_STRUCTURED_LIGHT_NOT_SET"
+#define SCAN_SCHEDULER_TOO_MANY_MODULES         "SCAN_SCHEDULER_TOO_MANY_MODULES"
+#define SCAN_SCHEDULER_PATTERN_COUNT_INVALID    "SCAN_SCHEDULER_PATTERN_COUNT_INVALID"
+#define SCAN_SCHEDULER_ALREADY_RUNNING          "SCAN_SCHEDULER_ALREADY_RUNNING"
+#define SCAN_SCHEDULER_NO_MORE_SCANS            "SCAN_SCHEDULER_NO_MORE_SCANS"
+
+/** @brief  Contains all DLP SDK classes, functions, etc. */
+namespace dlp{
+
+/** @class      ScanScheduler
+ *  @brief      Runs repeated structured light scans as a three stage pipeline
+ *
+ *  Each scan passes through a capture stage (project the patterns and grab
+ *  the camera frames), a decode stage (\ref dlp::StructuredLight::DecodeCaptureSequence)
+ *  and a triangulation stage (\ref dlp::Geometry::GeneratePointCloud). Every
+ *  stage runs on its own thread and hands scans to the next through a
+ *  bounded queue, so scan N+1 is captured while scan N is decoded and scan
+ *  N-1 is triangulated. When a queue is full the stage in front of it waits,
+ *  which stops the projector and camera from running ahead of the CPU.
+ *
+ *  Up to two structured light modules may be added; their disparity maps are
+ *  passed to \ref dlp::Geometry::GeneratePointCloud in the order they were
+ *  added. Without a geometry object the scans only contain disparity maps.
+ *
+ *  With a \ref dlp::HdrCapture object the capture stage captures every
+ *  module's patterns at each of its exposures and fuses them before decoding.
+ *
+ *  Each stage uses its modules from a single thread, but the modules must
+ *  not be used elsewhere while the scheduler is running.
+ */
+class ScanScheduler: public dlp::Module{
+public:
+
+    class Parameters{
+    public:
+        DLP_NEW_PARAMETERS_ENTRY(QueueDepth,   "SCAN_SCHEDULER_PARAMETERS_QUEUE_DEPTH",   unsigned int, 1);
+        DLP_NEW_PARAMETERS_ENTRY(KeepCaptures, "SCAN_SCHEDULER_PARAMETERS_KEEP_CAPTURES", bool,     false);
+    };
+
+    /** @brief  Result of one scan */
+    struct Scan{
+        unsigned long long              index;          //!< Scan number counted from \ref Start()
+        ReturnCode                      ret;            //!< Errors of the stage which failed
+        std::vector<Capture::Sequence>  captures;       //!< Captures of each module, empty unless KeepCaptures is set
+        std::vector<dlp::DisparityMap>  disparity_maps; //!< Disparity map of each module
+        dlp::Point::Cloud               cloud;          //!< Empty without a geometry object
+        dlp::Image                      depth_map;      //!< Empty without a geometry object
+        double                          latency_ms;     //!< Time from capture start to triangulation end
+        std::chrono::steady_clock::time_point start;    //!< Time the capture stage started the scan
+    };
+
+    /** @brief  Timing of one pipeline stage */
+    struct StageStatistics{
+        unsigned long long  count;          //!< Scans processed
+        double              busy_ms;        //!< Time spent processing scans
+        double              last_ms;        //!< Processing time of the last scan
+        double              max_ms;         //!< Longest processing time
+        double              starved_ms;     //!< Time spent waiting for a scan from the previous stage
+        double              blocked_ms;     //!< Time spent waiting for room in the next stage (backpressure)
+    };
+
+    /** @brief  Timing of the whole pipeline */
+    struct Statistics{
+        StageStatistics     capture;
+        StageStatistics     decode;
+        StageStatistics     triangulate;
+        unsigned long long  scans;                  //!< Scans completed
+        double              elapsed_ms;             //!< Time since \ref Start()
+        double              scans_per_second;       //!< Completed scans over elapsed time
+        double              latency_last_ms;        //!< Latency of the last completed scan
+        double              latency_average_ms;     //!< Average latency of the completed scans
+    };
+
+    ScanScheduler();
+    ~ScanScheduler();
+
+    ReturnCode Setup(const dlp::Parameters &settings);
+    ReturnCode GetSetup(dlp::Parameters *settings) const;
+
+    ReturnCode SetCamera(dlp::Camera *camera);
+    ReturnCode SetDlpPlatform(dlp::DLP_Platform *projector);
+    ReturnCode AddStructuredLight(dlp::StructuredLight *module,
+                                  const unsigned int &pattern_start,
+                                  const unsigned int &pattern_count);
+    ReturnCode SetGeometry(dlp::Geometry *geometry, const unsigned int &viewport_id);
+    ReturnCode SetHdrCapture(dlp::HdrCapture *hdr_capture);
+    void       ClearModules();
+
+    ReturnCode Start(const unsigned long long &scans = 0);
+    ReturnCode GetScan(Scan *ret_scan);
+    ReturnCode Stop();
+    bool       isRunning() const;
+
+    Statistics GetStatistics() const;
+
+private:
+
+    /** @brief  Bounded queue of scans between two stages */
+    class StageQueue{
+    public:
+        StageQueue();
+        void Open(const unsigned int &depth);
+        void Close();
+        void Abort();
+        bool Push(std::shared_ptr<Scan> scan, double *ret_blocked_ms);
+        bool Pop(std::shared_ptr<Scan> *ret_scan, double *ret_starved_ms);
+    private:
+        std::mutex                          mutex_;
+        std::condition_variable             not_full_;
+        std::condition_variable             not_empty_;
+        std::deque<std::shared_ptr<Scan>>   scans_;
+        unsigned int                        depth_;
+        bool                                closed_;
+    };
+
+    struct ModuleEntry{
+        dlp::StructuredLight   *module;
+        unsigned int            pattern_start;
+        unsigned int            pattern_count;
+    };
+
+    void CaptureLoop(unsigned long long scans);
+    void DecodeLoop();
+    void TriangulateLoop();
+    void Record(StageStatistics *stage, const double &busy_ms, const double &starved_ms, const double &blocked_ms);
+
+    Parameters::QueueDepth      queue_depth_;
+    Parameters::KeepCaptures    keep_captures_;
+
+    dlp::Camera                *camera_;
+    dlp::DLP_Platform          *projector_;
+    dlp::Geometry              *geometry_;
+    dlp::HdrCapture            *hdr_capture_;
+    unsigned int                viewport_id_;
+    std::vector<ModuleEntry>    modules_;
+
+    StageQueue  decode_queue_;
+    StageQueue  triangulate_queue_;
+    StageQueue  result_queue_;
+
+    std::thread capture_thread_;
+    std::thread decode_thread_;
+    std::thread triangulate_thread_;
+
+    std::atomic_bool    running_;
+    std::atomic_bool    stop_;
+
+    mutable std::mutex  statistics_mutex_;
+    Statistics          statistics_;
+    double              latency_total_ms_;
+    std::chrono::steady_clock::time_point start_time_;
+};
+
+}
+
+#endif // DLP_SDK_SCAN_SCHEDULER_HPP
@@ -16,6 +16,8 @@
 
 #define GRAY_CODE_PIXEL_THRESHOLD_MISSING "GRAY_CODE_PIXEL_THRESHOLD_MISSING"
 #define GRAY_CODE_REGIONS_REQUIRE_SUB_PIXELS    "GRAY_CODE_REGIONS_REQUIRE_SUB_PIXELS"
+#define GRAY_CODE_SUBPIXEL_SAMPLING_INVALID     "GRAY_CODE_SUBPIXEL_SAMPLING_INVALID"
+#define GRAY_CODE_CAPTURE_BIT_DEPTH_INVALID     "GRAY_CODE_CAPTURE_BIT_DEPTH_INVALID"
 
 /** @brief  Contains all DLP SDK classes, functions, etc. */
 namespace dlp{
@@ -34,6 +36,8 @@ public:
         DLP_NEW_PARAMETERS_ENTRY( IncludeInverted,    "GRAY_CODE_PARAMETERS_PATTERN_INCLUDE_INVERTED",         bool, true);
         DLP_NEW_PARAMETERS_ENTRY(  PixelThreshold,          "GRAY_CODE_PARAMETERS_PIXEL_THRESHOLD", unsigned int,    5);
         DLP_NEW_PARAMETERS_ENTRY( MeasureRegions,  "GRAY_CODE_PARAMETERS_MEASURE_REGIONS", float, 0.0);
+        DLP_NEW_PARAMETERS_ENTRY( SubpixelSampling, "GRAY_CODE_PARAMETERS_SUBPIXEL_SAMPLING", unsigned int, 1);
+        DLP_NEW_PARAMETERS_ENTRY( CaptureBitDepth,  "GRAY_CODE_PARAMETERS_CAPTURE_BIT_DEPTH",  unsigned int, 0);
     };
 
     GrayCode();
@@ -44,12 +48,42 @@ public:
 
     ReturnCode GeneratePatternSequence(Pattern::Sequence *pattern_sequence);
     ReturnCode DecodeCaptureSequence(Capture::Sequence *capture_sequence,dlp::DisparityMap *disparity_map);
+    ReturnCode DecodeToPointCloud(Capture::Sequence  *capture_sequence,
+                                  dlp::Geometry      *geometry,
+                                  const unsigned int &viewport_id,
+                                  dlp::Point::Cloud  *ret_cloud,
+                                  dlp::Image         *ret_distancemap);
 
 private:
+    // ThreePhase decodes its hybrid Gray code tiles with this module
+    friend class ThreePhase;
+
+    ReturnCode LoadCaptures(Capture::Sequence *capture_sequence,
+                            std::vector<dlp::Image> *images,
+                            std::vector<cv::Mat> *captures,
+                            unsigned int *image_columns,
+                            unsigned int *image_rows,
+                            bool *sixteen_bit,
+                            cv::Rect *region,
+                            cv::Mat *region_mask);
+
+    void DecodeTile(const std::vector<cv::Mat> &captures,
+                    const bool &sixteen_bit,
+                    const cv::Mat &region_mask,
+                    const cv::Rect &tile,
+                    cv::Mat *disparity,
+                    TileConfidence *confidence) const;
+
+    bool isSubpixel() const;
+    unsigned int GetDisparitySampling() const;
+    unsigned int GetPixelThreshold(const bool &sixteen_bit) const;
+
     Parameters::SequenceCount   sequence_count_;
     Parameters::IncludeInverted include_inverted_;
     Parameters::PixelThreshold  pixel_threshold_;
     Parameters::MeasureRegions  measure_regions_;
+    Parameters::SubpixelSampling subpixel_sampling_;
+    Parameters::CaptureBitDepth  capture_bit_depth_;
 
     unsigned int region_size_;
     unsigned int maximum_patterns_;
@@ -12,11 +12,20 @@
 #include <common/image/image.hpp>
 #include <common/parameters.hpp>
 #include <common/capture/capture.hpp>
+#include <common/capture/capture_band_reader.hpp>
 #include <common/pattern/pattern.hpp>
 #include <common/disparity_map.hpp>
+#include <common/region_of_interest.hpp>
+#include <common/confidence_map.hpp>
+#include <common/point_cloud/point_cloud.hpp>
+#include <geometry/geometry.hpp>
 #include <common/module.hpp>
 #include <dlp_platforms/dlp_platform.hpp>
 
+#include <functional>
+#include <string>
+#include <vector>
+
 #define STRUCTURED_LIGHT_NOT_SETUP                                      "STRUCTURED_LIGHT_NOT_SETUP"
 #define STRUCTURED_LIGHT_PATTERN_SEQUENCE_NULL                          "STRUCTURED_LIGHT_PATTERN_SEQUENCE_NULL"
 #define STRUCTURED_LIGHT_CAPTURE_SEQUENCE_EMPTY                         "STRUCTURED_LIGHT_CAPTURE_SEQUENCE_EMPTY"
@@ -33,6 +42,13 @@
 #define STRUCTURED_LIGHT_SETTINGS_SEQUENCE_COUNT_MISSING                "STRUCTURED_LIGHT_SETTINGS_SEQUENCE_COUNT_MISSING"
 #define STRUCTURED_LIGHT_NULL_POINTER_ARGUMENT                          "STRUCTURED_LIGHT_NULL_POINTER_ARGUMENT"
 #define STRUCTURED_LIGHT_DATA_TYPE_INVALID                              "STRUCTURED_LIGHT_DATA_TYPE_INVALID"
+#define STRUCTURED_LIGHT_CAPTURE_FORMAT_INVALID                         "STRUCTURED_LIGHT_CAPTURE_FORMAT_INVALID"
+#define STRUCTURED_LIGHT_GEOMETRY_RESOLUTION_INVALID                    "STRUCTURED_LIGHT_GEOMETRY_RESOLUTION_INVALID"
+#define STRUCTURED_LIGHT_CONFIDENCE_MAP_EMPTY                           "STRUCTURED_LIGHT_CONFIDENCE_MAP_EMPTY"
+
+/** @brief  Camera rows or columns decoded and triangulated together by
+ *          \ref dlp::StructuredLight::DecodeToPointCloud() */
+#define STRUCTURED_LIGHT_FUSED_TILE_LINES   32
 
 /** @brief Contains all DLP SDK classes, functions, etc. */
 namespace dlp{
@@ -54,6 +70,11 @@ public:
         DLP_NEW_PARAMETERS_ENTRY(PatternRows,        "STRUCTURED_LIGHT_PARAMETERS_PATTERN_ROWS",        unsigned int, 0);
         DLP_NEW_PARAMETERS_ENTRY(PatternColumns,     "STRUCTURED_LIGHT_PARAMETERS_PATTERN_COLUMNS",     unsigned int, 0);
         DLP_NEW_PARAMETERS_ENTRY(PatternOrientation, "STRUCTURED_LIGHT_PARAMETERS_PATTERN_ORIENTATION", dlp::Pattern::Orientation, dlp::Pattern::Orientation::VERTICAL);
+        DLP_NEW_PARAMETERS_ENTRY(MinimumModulation,     "STRUCTURED_LIGHT_PARAMETERS_MINIMUM_MODULATION",      float, 0.0);
+        DLP_NEW_PARAMETERS_ENTRY(MinimumDecisionMargin, "STRUCTURED_LIGHT_PARAMETERS_MINIMUM_DECISION_MARGIN", float, 0.0);
+        DLP_NEW_PARAMETERS_ENTRY(MaximumGlobalRatio,    "STRUCTURED_LIGHT_PARAMETERS_MAXIMUM_GLOBAL_RATIO",    float, 0.0);
+        DLP_NEW_PARAMETERS_ENTRY(BandRows,              "STRUCTURED_LIGHT_PARAMETERS_BAND_ROWS",               unsigned int, 0);
+        DLP_NEW_PARAMETERS_ENTRY(BandOverlap,           "STRUCTURED_LIGHT_PARAMETERS_BAND_OVERLAP",            unsigned int, 16);
     };
 
     StructuredLight();
@@ -62,21 +83,126 @@ public:
     virtual ReturnCode GeneratePatternSequence(Pattern::Sequence *pattern_sequence) = 0;
     virtual ReturnCode DecodeCaptureSequence(Capture::Sequence *capture_sequence,dlp::DisparityMap *disparity_map) = 0;
 
+    virtual ReturnCode DecodeToPointCloud(Capture::Sequence  *capture_sequence,
+                                          dlp::Geometry      *geometry,
+                                          const unsigned int &viewport_id,
+                                          dlp::Point::Cloud  *ret_cloud,
+                                          dlp::Image         *ret_distancemap);
+
     ReturnCode SetDlpPlatform( const dlp::DLP_Platform &platform );
 
     unsigned int GetTotalPatternCount();
 
+    void SetRegionOfInterest(const dlp::RegionOfInterest &region);
+    void GetRegionOfInterest(dlp::RegionOfInterest *region) const;
+
+    ReturnCode GetConfidenceMap(dlp::ConfidenceMap *confidence_map) const;
+    void GetRejection(dlp::ConfidenceMap::Rejection *rejection) const;
+
+    /** @brief  Counters of the generated \ref dlp::Pattern::Sequence cache */
+    struct PatternCacheStatistics{
+        unsigned long long hits;        /**< Sequences returned from the cache */
+        unsigned long long misses;      /**< Sequences generated because they were NOT cached */
+        unsigned long long evictions;   /**< Sequences removed to stay within the cache size */
+    };
+
+    static void SetPatternCacheSize(const unsigned int &sequences);
+    static void ClearPatternCache();
+    static void GetPatternCacheStatistics(PatternCacheStatistics *statistics);
+    static void ResetPatternCacheStatistics();
+
 protected:
+    static bool GetCachedPatternSequence(const std::string &key, Pattern::Sequence *sequence);
+    static void CachePatternSequence(const std::string &key, const Pattern::Sequence &sequence);
+
+    static ReturnCode GenerateStripeImage(const std::vector<unsigned char> &profile,
+                                          const unsigned int &offset,
+                                          const unsigned int &columns,
+                                          const unsigned int &rows,
+                                          const dlp::Pattern::Orientation &orientation,
+                                          dlp::Image *image);
+
+    ReturnCode LoadCaptureImages(Capture::Sequence       *capture_sequence,
+                                 const unsigned int      &count,
+                                 std::vector<dlp::Image> *images,
+                                 unsigned int            *image_columns,
+                                 unsigned int            *image_rows,
+                                 dlp::Image::Format      *image_format,
+                                 cv::Rect                *region,
+                                 cv::Mat                 *region_mask);
+
+    /** @brief  Decodes one tile of the region of interest into CV_32SC1 disparity values */
+    typedef std::function<void(const cv::Rect &tile, cv::Mat *disparity)> TileDecoder;
+
+    /** @brief  Decodes monochrome bands of every capture into CV_32SC1 disparity values */
+    typedef std::function<void(const std::vector<cv::Mat> &captures,
+                               const bool &sixteen_bit,
+                               const cv::Mat &band_mask,
+                               cv::Mat *disparity)> BandDecoder;
+
+    bool isBanded() const;
+    void SetupBands(const dlp::Parameters &settings);
+    void GetBandSetup(dlp::Parameters *settings) const;
+
+    ReturnCode DecodeBandsToPointCloud(Capture::Sequence    *capture_sequence,
+                                       const BandDecoder    &decode_band,
+                                       const unsigned int   &disparity_sampling,
+                                       const unsigned int   &stripe_rows,
+                                       dlp::Geometry        *geometry,
+                                       const unsigned int   &viewport_id,
+                                       dlp::Point::Cloud    *ret_cloud,
+                                       dlp::Image           *ret_distancemap);
+
+    ReturnCode DecodeTilesToPointCloud(const TileDecoder    &decode_tile,
+                                       const cv::Rect       &region,
+                                       const unsigned int   &image_columns,
+                                       const unsigned int   &image_rows,
+                                       const unsigned int   &disparity_sampling,
+                                       dlp::Geometry        *geometry,
+                                       const unsigned int   &viewport_id,
+                                       dlp::Point::Cloud    *ret_cloud,
+                                       dlp::Image           *ret_distancemap);
+
+    /** @brief  CV_32FC1 \ref dlp::ConfidenceMap measurements of a decoded tile */
+    struct TileConfidence{
+        cv::Mat modulation;
+        cv::Mat global;
+        cv::Mat margin;
+    };
+
+    void SetupRejection(const dlp::Parameters &settings);
+    void GetRejectionSetup(dlp::Parameters *settings) const;
+    bool isRejectionEnabled() const;
+    ReturnCode StoreConfidence(const cv::Rect &bounds,
+                               const unsigned int &image_columns,
+                               const unsigned int &image_rows,
+                               const TileConfidence &confidence);
+
+    static void ApplyRegionMask(const cv::Mat &mask, cv::Mat *disparity);
+    static ReturnCode ExpandRegion(const cv::Rect &bounds,
+                                   const unsigned int &image_columns,
+                                   const unsigned int &image_rows,
+                                   dlp::DisparityMap *disparity_map);
+
     bool                                is_decoded_;
     bool                                projector_set_;
     unsigned int                        sequence_count_total_;
 
     dlp::DisparityMap                   disparity_map_;
+    dlp::RegionOfInterest               region_of_interest_;
+    dlp::ConfidenceMap                  confidence_map_;
 
     Parameters::PatternColor        pattern_color_;
     Parameters::PatternRows         pattern_rows_;
     Parameters::PatternColumns      pattern_columns_;
     Parameters::PatternOrientation  pattern_orientation_;
+
+    Parameters::MinimumModulation       minimum_modulation_;
+    Parameters::MinimumDecisionMargin   minimum_decision_margin_;
+    Parameters::MaximumGlobalRatio      maximum_global_ratio_;
+
+    Parameters::BandRows                band_rows_;
+    Parameters::BandOverlap             band_overlap_;
 };
 
 }
@@ -55,9 +55,34 @@ public:
 
     ReturnCode GeneratePatternSequence(Pattern::Sequence *pattern_sequence);
     ReturnCode DecodeCaptureSequence(Capture::Sequence *capture_sequence,dlp::DisparityMap *disparity_map);
+    ReturnCode DecodeToPointCloud(Capture::Sequence  *capture_sequence,
+                                  dlp::Geometry      *geometry,
+                                  const unsigned int &viewport_id,
+                                  dlp::Point::Cloud  *ret_cloud,
+                                  dlp::Image         *ret_distancemap);
 
 private:
 
+    /** @brief Region of interest of the loaded captures */
+    struct CaptureData{
+        std::vector<dlp::Image> phase_images;
+        std::vector<cv::Mat>    phase;
+        bool                    phase_sixteen_bit;
+
+        std::vector<dlp::Image> gray_code_images;
+        std::vector<cv::Mat>    gray_code;
+        bool                    gray_code_sixteen_bit;
+
+        unsigned int image_columns;
+        unsigned int image_rows;
+        cv::Rect     region;
+        cv::Mat      region_mask;
+    };
+
+    ReturnCode LoadCaptures(Capture::Sequence *capture_sequence, CaptureData *data);
+    void DecodeTile(const CaptureData &data, const cv::Rect &tile,
+                    cv::Mat *disparity, TileConfidence *confidence) const;
+
     Parameters::Frequency       frequency_;
     Parameters::PixelsPerPeriod pixels_per_period_;
     Parameters::Bitdepth        bitdepth_;
@@ -69,6 +94,7 @@ private:
     dlp::GrayCode::Parameters::MeasureRegions  hybrid_region_count_;
     dlp::GrayCode::Parameters::IncludeInverted hybrid_include_inverted_;
     dlp::GrayCode::Parameters::PixelThreshold  hybrid_pixel_threshold_;
+    dlp::GrayCode::Parameters::CaptureBitDepth hybrid_capture_bit_depth_;
 
     float phase_counts_;
     float maximum_value_;
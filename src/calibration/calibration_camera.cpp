@@ -19,6 +19,12 @@
 // C++ standard header files
 #include <vector>                               // Adds std:vector
 #include <string>                               // Adds std::string
+#include <cmath>                                // Adds std::ceil
+#include <algorithm>                            // Adds std::max
+#include <functional>                           // Adds std::greater
+
+// Images wider than this are first searched for the calibration board at a reduced resolution
+#define CALIBRATION_BOARD_COARSE_SEARCH_COLUMNS     1024
 
 /** @brief  Contains all DLP SDK classes, functions, etc. */
 namespace dlp{
@@ -65,6 +71,7 @@ void Calibration::Camera::ClearAll(){
     this->board_row_distance_.Set(0);
     this->board_row_distance_in_pixels_.Set(0);
     this->zero_tangent_distortion_.Set(false);
+    this->warm_start_.Set(false);
     this->is_setup_     = false;
     this->camera_set_   = false;
     this->calibration_board_feature_points_xyz_.clear();
@@ -91,6 +98,10 @@ void Calibration::Camera::ClearCalibrationData(){
     // Reset boolean values
     this->calibration_data_.Clear();
 
+    // The cleared data can NOT seed the next calibration
+    this->warm_start_valid_ = false;
+    this->board_errors_.clear();
+
     this->debug_.Msg("Calibration data cleared");
 }
 
@@ -110,6 +121,7 @@ void Calibration::Camera::ClearCalibrationImagePoints(){
     // Clear the point vectors
     this->object_points_xyz_.clear();
     this->image_points_xy_.clear();
+    this->board_errors_.clear();
 
     // Clear the homography data
     for(unsigned int iBoard = 0; iBoard < this->calibration_data_.homography_.size(); iBoard++){
@@ -191,6 +203,7 @@ ReturnCode Calibration::Camera::GetSetup(dlp::Parameters *settings) const{
     settings->Set(this->board_row_distance_in_pixels_);
     settings->Set(this->zero_tangent_distortion_);
     settings->Set(this->fix_sixth_order_distortion_);
+    settings->Set(this->warm_start_);
 
     this->debug_.Msg("Camera calibration setup saved to dlp::Parameters object");
 
@@ -327,6 +340,8 @@ ReturnCode Calibration::Camera::GetCalibrationData( dlp::Calibration::Data *data
  *  ret = camera_calibration.SetCalibrationData(calibration_data);
  *  @endcode
  *  \note       Useful for updating calibration data if previously completed
+ *  \note       If \ref dlp::Calibration::Parameters::WarmStart is set the next
+ *              \ref Calibrate() starts from the intrinsic and distortion of this data
  *
  */
 ReturnCode Calibration::Camera::SetCalibrationData( dlp::Calibration::Data &data ){
@@ -342,6 +357,7 @@ ReturnCode Calibration::Camera::SetCalibrationData( dlp::Calibration::Data &data
 
     // Copy the calibration data
     this->calibration_data_ = data;
+    this->warm_start_valid_ = true;
 
     this->debug_.Msg("Calibration data set");
 
@@ -473,6 +489,10 @@ ReturnCode Calibration::Camera::SetCamera(const dlp::Camera &camera){
  * CALIBRATION_PARAMETERS_FIX_SIXTH_ORDER_DIST  =   0
  * @endcode
  *
+ * \ref dlp::Calibration::Parameters::WarmStart is optional. If it is set,
+ * calibrating again after adding or removing boards starts from the previous
+ * intrinsic and distortion estimate.
+ *
  * The following code would then be used to load the settings:
  * @code
  *
@@ -626,6 +646,10 @@ ReturnCode Calibration::Camera::Setup(const dlp::Parameters &settings){
         return ret.AddError(CALIBRATION_PARAMETERS_SIXTH_ORDER_DISTORTION_MISSING);
     this->debug_.Msg("Calibration sixth order distortion = " + this->fix_sixth_order_distortion_.GetEntryValue());
 
+    // Get the warm start setting (not required)
+    settings.Get(&this->warm_start_);
+    this->debug_.Msg("Calibration warm start = " + this->warm_start_.GetEntryValue());
+
     // Check for errors
     if(ret.hasErrors()) return ret;
 
@@ -787,27 +811,14 @@ ReturnCode Calibration::Camera::AddCalibrationBoard(const dlp::Image &calib_imag
 
     // Convert dlp::Image to cv::Mat
     cv::Mat calibration_image_cv;
-    temp_calibration_image.GetOpenCVData(&calibration_image_cv);
+    temp_calibration_image.Unsafe_GetOpenCVData(&calibration_image_cv);
 
     // Look for the chessboard (checkerboard corners
     this->debug_.Msg("Looking for chessboard corners in calibration image...");
     std::vector<cv::Point2f> board_feature_locations_xy;
-    cv::Size board_feature_size(this->board_columns_.Get(),this->board_rows_.Get());
-    if (cv::findChessboardCorners(calibration_image_cv,
-                                  board_feature_size,
-                                  board_feature_locations_xy,
-                                  CV_CALIB_CB_ADAPTIVE_THRESH | CV_CALIB_CB_FILTER_QUADS )){
-
-        this->debug_.Msg("Chessboard corners found");
-        this->debug_.Msg("Refining corner locations...");
-
-        // Board was found. Refine the corner positions
-        // NOTE : Many of these arguments would be good parameter settings for calibration
-        cv::cornerSubPix(calibration_image_cv,
-                         board_feature_locations_xy,
-                         cv::Size(11, 11),
-                         cv::Size(-1, -1),
-                         cv::TermCriteria(CV_TERMCRIT_EPS | CV_TERMCRIT_ITER, 30, 0.1));
+    if (this->DetectBoardFeatures(calibration_image_cv, &board_feature_locations_xy, false)){
+
+        this->debug_.Msg("Chessboard corners found and refined");
 
         // Return success as true and increment counter
         (*success) = true;
@@ -831,6 +842,224 @@ ReturnCode Calibration::Camera::AddCalibrationBoard(const dlp::Image &calib_imag
     return ret;
 }
 
+/** @brief      Finds the calibration board feature points and refines them to subpixel accuracy
+ *
+ *  If coarse_search is true, large images are searched at a reduced resolution
+ *  first. The coarse corner locations are scaled back up and refined on the full
+ *  resolution image. If the coarse search fails the full resolution image is
+ *  searched instead. If coarse_search is false the board is found exactly as
+ *  the single image methods always have.
+ *
+ *  @param[in]  board_image_mono            Monochrome image of the calibration board
+ *  @param[out] board_feature_locations_xy  Pointer to return the refined feature points
+ *  @param[in]  coarse_search               If true, images wider than 1024 pixels are searched downscaled first
+ *  \note       Only reads settings so several threads may call this at once
+ */
+bool Calibration::Camera::DetectBoardFeatures(const cv::Mat &board_image_mono, std::vector<cv::Point2f> *board_feature_locations_xy, const bool &coarse_search) const{
+    if(!board_feature_locations_xy) return false;
+
+    cv::Size board_feature_size(this->board_columns_.Get(),this->board_rows_.Get());
+    int      search_flags = CV_CALIB_CB_ADAPTIVE_THRESH | CV_CALIB_CB_FILTER_QUADS;
+    double   scale        = 1.0;
+    bool     found        = false;
+
+    board_feature_locations_xy->clear();
+
+    // Coarse search on a downscaled copy of large images
+    if(coarse_search && (board_image_mono.cols > CALIBRATION_BOARD_COARSE_SEARCH_COLUMNS)){
+        cv::Mat board_image_coarse;
+        scale = (double) board_image_mono.cols / CALIBRATION_BOARD_COARSE_SEARCH_COLUMNS;
+        cv::resize(board_image_mono, board_image_coarse, cv::Size(), 1.0 / scale, 1.0 / scale, cv::INTER_AREA);
+
+        found = cv::findChessboardCorners(board_image_coarse,
+                                          board_feature_size,
+                                          (*board_feature_locations_xy),
+                                          search_flags);
+
+        if(found){
+            // Move the corners to full resolution pixel coordinates
+            for(unsigned int iPoint = 0; iPoint < board_feature_locations_xy->size(); iPoint++){
+                cv::Point2f &corner = board_feature_locations_xy->at(iPoint);
+                corner.x = (float) ((corner.x + 0.5) * scale - 0.5);
+                corner.y = (float) ((corner.y + 0.5) * scale - 0.5);
+            }
+        }
+        else{
+            scale = 1.0;
+        }
+    }
+
+    // Full resolution search
+    if(!found){
+        found = cv::findChessboardCorners(board_image_mono,
+                                          board_feature_size,
+                                          (*board_feature_locations_xy),
+                                          search_flags);
+    }
+
+    if(!found) return false;
+
+    // Board was found. Refine the corner positions. The search window must
+    // cover the error introduced by the coarse search.
+    // NOTE : Many of these arguments would be good parameter settings for calibration
+    int window = std::max(11, (int) std::ceil(2 * scale));
+    cv::cornerSubPix(board_image_mono,
+                     (*board_feature_locations_xy),
+                     cv::Size(window, window),
+                     cv::Size(-1, -1),
+                     cv::TermCriteria(CV_TERMCRIT_EPS | CV_TERMCRIT_ITER, 30, 0.1));
+
+    return true;
+}
+
+/** @brief      Analyzes several calibration board images concurrently and adds the
+ *              feature points of each board found
+ *  \note       Boards are added in the order of the supplied images so the homographies
+ *              still match those of a \ref dlp::Calibration::Projector fed the same order
+ *  @param[in]  board_images        Calibration board images
+ *  @param[out] success             Returns true for each image whose board was found
+ *  @param[out] detection_times_ms  Optional pointer to return the time spent on each image
+ *  @retval     CALIBRATION_NOT_SETUP               Calibration has not been setup
+ *  @retval     CALIBRATION_NULL_POINTER_SUCCESS    Pointer argument is NULL
+ *  @retval     CALIBRATION_IMAGE_EMPTY             One or more of the supplied images is empty
+ *  @retval     CALIBRATION_IMAGE_LIST_EMPTY        No images were supplied
+ *  @retval     CALIBRATION_BOARD_NOT_DETECTED      No boards were found (warning if only some were NOT found)
+ */
+ReturnCode Calibration::Camera::AddCalibrationBoards(const std::vector<dlp::Image>   &board_images,
+                                                     std::vector<bool>               *success,
+                                                     std::vector<unsigned long long> *detection_times_ms){
+    ReturnCode ret;
+    dlp::Capture::Sequence board_captures;
+
+    // Wrap the images so both batch methods share the same code
+    for(unsigned int iImage = 0; iImage < board_images.size(); iImage++){
+        dlp::Capture capture;
+        capture.data_type  = dlp::Capture::DataType::IMAGE_DATA;
+        capture.image_data = board_images.at(iImage);
+
+        // Empty images are NOT accepted by the sequence and would shift the success indices
+        if(board_captures.Add(capture).hasErrors())
+            return ret.AddError(CALIBRATION_IMAGE_EMPTY);
+    }
+
+    return this->AddCalibrationBoards(board_captures, success, detection_times_ms);
+}
+
+/** @brief      Analyzes a sequence of calibration board captures concurrently and adds
+ *              the feature points of each board found
+ *  \note       Captures stored as image files are loaded by the worker threads
+ *  @param[in]  board_captures      Calibration board captures
+ *  @param[out] success             Returns true for each capture whose board was found
+ *  @param[out] detection_times_ms  Optional pointer to return the time spent on each capture
+ *  @retval     CALIBRATION_NOT_SETUP               Calibration has not been setup
+ *  @retval     CALIBRATION_NULL_POINTER_SUCCESS    Pointer argument is NULL
+ *  @retval     CALIBRATION_IMAGE_LIST_EMPTY        No captures were supplied
+ *  @retval     CALIBRATION_BOARD_NOT_DETECTED      No boards were found (warning if only some were NOT found)
+ */
+ReturnCode Calibration::Camera::AddCalibrationBoards(const dlp::Capture::Sequence    &board_captures,
+                                                     std::vector<bool>               *success,
+                                                     std::vector<unsigned long long> *detection_times_ms){
+    ReturnCode ret;
+
+    this->debug_.Msg("Adding calibration boards...");
+
+    // Check that the calibration object has been setup
+    if(!this->isSetup())
+        return ret.AddError(CALIBRATION_NOT_SETUP);
+
+    // Check that the pointer is not NULL
+    if(!success) return ret.AddError(CALIBRATION_NULL_POINTER_SUCCESS);
+
+    unsigned int board_count = board_captures.GetCount();
+    if(board_count == 0)
+        return ret.AddError(CALIBRATION_IMAGE_LIST_EMPTY);
+
+    std::vector<std::vector<cv::Point2f>> board_features(board_count);
+    std::vector<ReturnCode>               board_results(board_count);
+    std::vector<unsigned long long>       board_times(board_count, 0);
+
+    // Loads, converts, and searches a single board
+    auto detect_board = [&](const unsigned int &board_index) -> ReturnCode{
+        ReturnCode   board_ret;
+        dlp::Capture capture;
+        dlp::Image   board_image;
+
+        board_captures.Get(board_index, &capture);
+
+        // The image data is shared, ConvertToMonochrome() replaces rather than modifies it
+        if(capture.data_type == dlp::Capture::DataType::IMAGE_FILE){
+            if(board_image.Load(capture.image_file).hasErrors())
+                return board_ret.AddError(CALIBRATION_IMAGE_FILE_LOAD_FAILED);
+        }
+        else{
+            board_image = capture.image_data;
+        }
+
+        if(board_image.isEmpty())
+            return board_ret.AddError(CALIBRATION_IMAGE_EMPTY);
+
+        // Check the image resolution
+        unsigned int rows = 0;
+        unsigned int cols = 0;
+        board_image.GetRows(&rows);
+        board_image.GetColumns(&cols);
+
+        if((rows != this->image_rows_.Get()) ||
+           (cols != this->image_columns_.Get()))
+            return board_ret.AddError(CALIBRATION_IMAGE_RESOLUTION_INVALID);
+
+        if(board_image.ConvertToMonochrome().hasErrors())
+            return board_ret.AddError(CALIBRATION_IMAGE_CONVERT_TO_MONO_FAILED);
+
+        cv::Mat board_image_cv;
+        board_image.Unsafe_GetOpenCVData(&board_image_cv);
+
+        if(!this->DetectBoardFeatures(board_image_cv, &board_features.at(board_index), true))
+            return board_ret.AddError(CALIBRATION_BOARD_NOT_DETECTED);
+
+        return board_ret;
+    };
+
+    // Each board is processed on its own thread
+    this->debug_.Msg("Looking for chessboard corners in " + dlp::Number::ToString(board_count) + " images...");
+    dlp::Thread::ParallelFor(0, board_count, [&](unsigned long long first, unsigned long long last){
+        for(unsigned long long iBoard = first; iBoard < last; iBoard++){
+            dlp::Time::Chronograph timer(true);
+            board_results.at(iBoard) = detect_board(iBoard);
+            board_times.at(iBoard)   = timer.Lap();
+        }
+    });
+
+    // Add the boards in order
+    unsigned int board_found_count = 0;
+    success->assign(board_count, false);
+
+    for(unsigned int iBoard = 0; iBoard < board_count; iBoard++){
+        if(board_results.at(iBoard).hasErrors()){
+            this->debug_.Msg("Board " + dlp::Number::ToString(iBoard) + " NOT added after " + dlp::Number::ToString(board_times.at(iBoard)) + " ms: " + board_results.at(iBoard).ToString());
+            continue;
+        }
+
+        this->debug_.Msg("Board " + dlp::Number::ToString(iBoard) + " found in " + dlp::Number::ToString(board_times.at(iBoard)) + " ms");
+
+        success->at(iBoard) = true;
+        board_found_count++;
+        this->board_number_successes_++;
+
+        this->image_points_xy_.push_back(board_features.at(iBoard));
+        this->object_points_xyz_.push_back(this->calibration_board_feature_points_xyz_);
+    }
+
+    if(detection_times_ms) (*detection_times_ms) = board_times;
+
+    this->debug_.Msg(dlp::Number::ToString(board_found_count) + " of " + dlp::Number::ToString(board_count) + " calibration boards added");
+
+    if(board_found_count == 0)                  ret.AddError(CALIBRATION_BOARD_NOT_DETECTED);
+    else if(board_found_count < board_count)    ret.AddWarning(CALIBRATION_BOARD_NOT_DETECTED);
+
+    return ret;
+}
+
 /** @brief  Removes to most recently added calibration board feature points
  *  \note   If a Capture::Sequence or image file list was last added only the
  *          last image from the sequence or list will be removed.
@@ -848,6 +1077,13 @@ ReturnCode Calibration::Camera::RemoveLastCalibrationBoard(){
         // Remove the most recently added image points and object points
         this->object_points_xyz_.pop_back();
         this->image_points_xy_.pop_back();
+
+        // Remove the results of a previous calibration for the board
+        if(this->board_errors_.size() > this->image_points_xy_.size())
+            this->board_errors_.resize(this->image_points_xy_.size());
+
+        if(this->calibration_data_.homography_.size() > this->image_points_xy_.size())
+            this->calibration_data_.homography_.resize(this->image_points_xy_.size());
     }
     else{
         ret.AddError(CALIBRATION_NO_BOARDS_ADDED);
@@ -856,6 +1092,113 @@ ReturnCode Calibration::Camera::RemoveLastCalibrationBoard(){
     return ret;
 }
 
+/** @brief  Removes the feature points of one calibration board
+ *  @param[in]  board_index     Index of the board in the order the boards were added
+ *  @retval     CALIBRATION_BOARD_INDEX_INVALID     No board with this index exists
+ *
+ *  The board error and homography of the board from a previous calibration
+ *  are removed as well so the remaining boards keep their results. The
+ *  boards of a projector calibration are matched to the camera homographies
+ *  by index, so a board must be removed from both modules.
+ */
+ReturnCode Calibration::Camera::RemoveCalibrationBoard(const unsigned int &board_index){
+    ReturnCode ret;
+
+    if(board_index >= this->image_points_xy_.size())
+        return ret.AddError(CALIBRATION_BOARD_INDEX_INVALID);
+
+    this->debug_.Msg("Removing calibration board " + dlp::Number::ToString(board_index) + "...");
+
+    this->board_number_successes_--;
+    this->object_points_xyz_.erase(this->object_points_xyz_.begin() + board_index);
+    this->image_points_xy_.erase(  this->image_points_xy_.begin()   + board_index);
+
+    if(board_index < this->board_errors_.size())
+        this->board_errors_.erase(this->board_errors_.begin() + board_index);
+
+    if(board_index < this->calibration_data_.homography_.size())
+        this->calibration_data_.homography_.erase(this->calibration_data_.homography_.begin() + board_index);
+
+    return ret;
+}
+
+/** @brief      Retrieves the RMS reprojection error of each board from the last calibration
+ *  @param[out] board_errors    Errors in pixels in the order the boards were added
+ *  @retval     CALIBRATION_NULL_POINTER_BOARD_ERRORS   Input argument is NULL
+ *  @retval     CALIBRATION_BOARD_ERRORS_MISSING        No calibration has been performed
+ *
+ *  Boards added after the last calibration do NOT have an error yet.
+ */
+ReturnCode Calibration::Camera::GetBoardReprojectionErrors(std::vector<double> *board_errors) const{
+    ReturnCode ret;
+
+    if(!board_errors)
+        return ret.AddError(CALIBRATION_NULL_POINTER_BOARD_ERRORS);
+
+    if(this->board_errors_.empty())
+        return ret.AddError(CALIBRATION_BOARD_ERRORS_MISSING);
+
+    (*board_errors) = this->board_errors_;
+
+    return ret;
+}
+
+/** @brief      Removes the boards which fit the last calibration much worse than the others
+ *  @param[in]  error_ratio     Boards with an error above this multiple of the median board error are removed, must be greater than 1
+ *  @param[out] removed_boards  Indices of the removed boards in descending order, may be NULL
+ *  @retval     CALIBRATION_OUTLIER_RATIO_INVALID       Ratio is NOT greater than 1
+ *  @retval     CALIBRATION_BOARD_ERRORS_MISSING        No calibration has been performed
+ *
+ *  The worst boards are removed first and at least the number of boards
+ *  required by \ref Setup() are kept. The indices are in descending order so
+ *  the same boards can be removed from a paired module one at a time with
+ *  \ref RemoveCalibrationBoard(). Calibrate again to update the model.
+ */
+ReturnCode Calibration::Camera::RemoveOutlierBoards(const double &error_ratio, std::vector<unsigned int> *removed_boards){
+    ReturnCode ret;
+
+    if(error_ratio <= 1.0)
+        return ret.AddError(CALIBRATION_OUTLIER_RATIO_INVALID);
+
+    if(this->board_errors_.empty())
+        return ret.AddError(CALIBRATION_BOARD_ERRORS_MISSING);
+
+    if(removed_boards) removed_boards->clear();
+
+    // Find the median board error
+    std::vector<double> sorted_errors = this->board_errors_;
+    std::nth_element(sorted_errors.begin(), sorted_errors.begin() + (sorted_errors.size() / 2), sorted_errors.end());
+    double threshold = error_ratio * sorted_errors.at(sorted_errors.size() / 2);
+
+    // Order the outliers from the worst board
+    std::vector<unsigned int> outliers;
+    for(unsigned int iBoard = 0; iBoard < this->board_errors_.size(); iBoard++){
+        if(this->board_errors_.at(iBoard) > threshold) outliers.push_back(iBoard);
+    }
+
+    std::sort(outliers.begin(), outliers.end(), [&](const unsigned int &first, const unsigned int &second){
+        return this->board_errors_.at(first) > this->board_errors_.at(second);
+    });
+
+    // Keep enough boards to calibrate
+    unsigned int removable = 0;
+    if(this->image_points_xy_.size() > this->board_number_required_.Get())
+        removable = this->image_points_xy_.size() - this->board_number_required_.Get();
+    if(outliers.size() > removable) outliers.resize(removable);
+
+    // Remove from the highest index so the others do NOT move
+    std::sort(outliers.begin(), outliers.end(), std::greater<unsigned int>());
+    for(unsigned int iOutlier = 0; iOutlier < outliers.size(); iOutlier++){
+        this->debug_.Msg("Board " + dlp::Number::ToString(outliers.at(iOutlier)) + " is an outlier with error " +
+                         dlp::Number::ToString(this->board_errors_.at(outliers.at(iOutlier))));
+        this->RemoveCalibrationBoard(outliers.at(iOutlier));
+    }
+
+    if(removed_boards) (*removed_boards) = outliers;
+
+    return ret;
+}
+
 
 
 /** @brief Calibrates the camera using OpenCV
@@ -882,6 +1225,11 @@ ReturnCode Calibration::Camera::Calibrate(double *reprojection_error){
  *  @retval     CALIBRATION_NOT_SETUP                           Calibration has not been setup
  *  @retval     CALIBRATION_NOT_COMPLETE                        Calibration has not been completed
  *  @retval     CALIBRATION_NULL_POINTER_REPROJECTION_ERROR     Input argument is NULL
+ *
+ *  All added boards are used. If \ref dlp::Calibration::Parameters::WarmStart
+ *  is set and a previous estimate exists, the solver starts from the stored
+ *  intrinsic and distortion instead of a fresh estimate. The error of each
+ *  board is kept for \ref GetBoardReprojectionErrors().
  */
 ReturnCode Calibration::Camera::Calibrate(double *reprojection_error,
                                          const bool &update_intrinsic,
@@ -913,11 +1261,16 @@ ReturnCode Calibration::Camera::Calibrate(double *reprojection_error,
         cv_calibration_flags += CV_CALIB_FIX_K3;
     }
 
+    // Start from the previous estimate if it is stored and updated
+    if(this->warm_start_.Get() && this->warm_start_valid_ && update_intrinsic && update_distortion){
+        this->debug_.Msg("Start from the previous intrinsic and distortion estimate");
+        cv_calibration_flags += CV_CALIB_USE_INTRINSIC_GUESS;
+    }
+
     // Determine which calibration data should be updated
     cv::Mat intrinsic;
     cv::Mat distortion;
     cv::Mat extrinsic;
-    cv::Mat homography;
 
     if(update_intrinsic){
         this->debug_.Msg("Update stored intrinsic calibration data");
@@ -946,9 +1299,6 @@ ReturnCode Calibration::Camera::Calibrate(double *reprojection_error,
         extrinsic.setTo(cv::Scalar(0));
     }
 
-    homography.create( 3, 3, CV_64FC1);
-    homography.setTo(cv::Scalar(0));
-
 
     // Calibrate the camera
     double               reproj_error;
@@ -973,6 +1323,11 @@ ReturnCode Calibration::Camera::Calibrate(double *reprojection_error,
     this->calibration_data_.reprojection_error_ = reproj_error;
     (*reprojection_error) = reproj_error;
 
+    // Keep the error of each board and the estimate for the next calibration
+    this->StoreBoardErrors(this->object_points_xyz_, this->image_points_xy_,
+                           intrinsic, distortion, rotation_vector, translation_vector);
+    if(update_intrinsic && update_distortion) this->warm_start_valid_ = true;
+
     // Copy the rotation and translation vector to the extrinsic calibration data object.
     // Only copy the vectors from the first pattern board.
     cv::transpose(rotation_vector.at(0),    extrinsic.row(dlp::Calibration::Data::EXTRINSIC_ROW_ROTATION));
@@ -987,44 +1342,44 @@ ReturnCode Calibration::Camera::Calibrate(double *reprojection_error,
 
     // Calculate the homography for each calibration image
     this->debug_.Msg("Calculating calibration board homographies...");
-    for(unsigned int iBoard=0; iBoard<this->image_points_xy_.size();iBoard++){
 
-        // Undistort the image points using the new calibration information
-        cv::Mat image_points_xy_distorted = cv::Mat(this->image_points_xy_.at(iBoard));
-        cv::Mat image_points_xy_undistorted( this->board_columns_.Get() * this->board_rows_.Get(), 1, CV_32FC2);
+    // Convert the 3d calibration board points to a 2d point (ignore z)
+    std::vector<cv::Point2f> calibration_board_feature_points_xy;
+    for(unsigned int j = 0; j < this->calibration_board_feature_points_xyz_.size();j++){
+        cv::Point2f calibration_board_feature_point_xy;
 
-        cv::undistortPoints(image_points_xy_distorted,       // chessboard corners coordinate x, y in camera pixels
-                            image_points_xy_undistorted,     // returned normalized undistorted chessboard corner coordinates in x, y (unitless)
-                            this->calibration_data_.intrinsic_,     // pixels  // always use the calibration objects data even is update was not selected for undistortion
-                            this->calibration_data_.distortion_);   // pixels  // always use the calibration objects data even is update was not selected for undistortion
+        // Remove z component
+        calibration_board_feature_point_xy.x = this->calibration_board_feature_points_xyz_.at(j).x;
+        calibration_board_feature_point_xy.y = this->calibration_board_feature_points_xyz_.at(j).y;
 
-        // Convert the 3d calibration board points to a 2d point (ignore z)
-        std::vector<cv::Point2f> calibration_board_feature_points_xy;
-        for(unsigned int j = 0; j < this->calibration_board_feature_points_xyz_.size();j++){
-            cv::Point2f calibration_board_feature_point_xy;
+        // Save 2 dimensional point
+        calibration_board_feature_points_xy.push_back(calibration_board_feature_point_xy);
+    }
 
-            // Remove z component
-            calibration_board_feature_point_xy.x = this->calibration_board_feature_points_xyz_.at(j).x;
-            calibration_board_feature_point_xy.y = this->calibration_board_feature_points_xyz_.at(j).y;
+    // The boards are independent so each is processed on its own thread
+    std::vector<cv::Mat> homographies(this->image_points_xy_.size());
+    dlp::Thread::ParallelFor(0, this->image_points_xy_.size(), [&](unsigned long long first, unsigned long long last){
+        for(unsigned long long iBoard = first; iBoard < last; iBoard++){
 
-            // Save 2 dimensional point
-            calibration_board_feature_points_xy.push_back(calibration_board_feature_point_xy);
-        }
+            // Undistort the image points using the new calibration information
+            cv::Mat image_points_xy_distorted = cv::Mat(this->image_points_xy_.at(iBoard));
+            cv::Mat image_points_xy_undistorted( this->board_columns_.Get() * this->board_rows_.Get(), 1, CV_32FC2);
 
-        // Clear the homography matrix
-        homography.create(DLP_CV_HOMOGRAPHY_SETUP);
-        homography.setTo(cv::Scalar(0));
+            cv::undistortPoints(image_points_xy_distorted,       // chessboard corners coordinate x, y in camera pixels
+                                image_points_xy_undistorted,     // returned normalized undistorted chessboard corner coordinates in x, y (unitless)
+                                this->calibration_data_.intrinsic_,     // pixels  // always use the calibration objects data even is update was not selected for undistortion
+                                this->calibration_data_.distortion_);   // pixels  // always use the calibration objects data even is update was not selected for undistortion
 
-        // Find the homography to convert the undistorted image's calibration board feature point
-        // locations in pixels to the actual feature point's locaiton in space
-        homography = cv::findHomography(image_points_xy_undistorted,                 // pixels
-                                        calibration_board_feature_points_xy);   // x,y position (z=0 for our calibration image so it is not needed here)
-
-        // Update the extrinsic data
-        if(update_extrinsic){
-            this->calibration_data_.homography_.push_back(homography.clone());
+            // Find the homography to convert the undistorted image's calibration board feature point
+            // locations in pixels to the actual feature point's locaiton in space
+            homographies.at(iBoard) = cv::findHomography(image_points_xy_undistorted,                 // pixels
+                                                         calibration_board_feature_points_xy);   // x,y position (z=0 for our calibration image so it is not needed here)
         }
-        homography.release();
+    });
+
+    // Update the extrinsic data, replacing the homographies of a previous calibration
+    if(update_extrinsic){
+        this->calibration_data_.homography_ = homographies;
     }
 
     this->debug_.Msg("Calibration board homographies calculated");
@@ -1036,4 +1391,85 @@ ReturnCode Calibration::Camera::Calibrate(double *reprojection_error,
     return ret;
 }
 
+/** @brief      Stores the RMS reprojection error of each board after a calibration
+ *  @param[in]  object_points       Board feature locations in space of each board
+ *  @param[in]  image_points        Observed feature locations of each board
+ *  @param[in]  intrinsic           Calibrated intrinsic matrix
+ *  @param[in]  distortion          Calibrated distortion coefficients
+ *  @param[in]  rotation_vector     Rotation of each board returned by the calibration
+ *  @param[in]  translation_vector  Translation of each board returned by the calibration
+ */
+void Calibration::Camera::StoreBoardErrors(const std::vector<std::vector<cv::Point3f>> &object_points,
+                                           const std::vector<std::vector<cv::Point2f>> &image_points,
+                                           const cv::Mat &intrinsic,
+                                           const cv::Mat &distortion,
+                                           const std::vector<cv::Mat> &rotation_vector,
+                                           const std::vector<cv::Mat> &translation_vector){
+    this->board_errors_.assign(image_points.size(), 0.0);
+
+    dlp::Thread::ParallelFor(0, image_points.size(), [&](unsigned long long first, unsigned long long last){
+        for(unsigned long long iBoard = first; iBoard < last; iBoard++){
+            std::vector<cv::Point2f> projected_points;
+            cv::projectPoints(object_points.at(iBoard), rotation_vector.at(iBoard), translation_vector.at(iBoard),
+                              intrinsic, distortion, projected_points);
+
+            double squared_error = 0;
+            for(unsigned int iPoint = 0; iPoint < projected_points.size(); iPoint++){
+                cv::Point2f difference = projected_points.at(iPoint) - image_points.at(iBoard).at(iPoint);
+                squared_error += (difference.x * difference.x) + (difference.y * difference.y);
+            }
+
+            if(!projected_points.empty())
+                this->board_errors_.at(iBoard) = std::sqrt(squared_error / projected_points.size());
+        }
+    });
+}
+
+/** @brief      Calibrates several independent modules at the same time
+ *  @param[in]  modules                 Camera and projector calibration modules, each may be listed only once
+ *  @param[out] reprojection_errors     Reprojection error of each module
+ *  @retval     CALIBRATION_NULL_POINTER_REPROJECTION_ERROR     Input argument is NULL
+ *  @retval     CALIBRATION_NULL_POINTER_MODULE                 A module is NULL
+ *  @retval     CALIBRATION_MODULE_LISTED_TWICE                 A module is listed more than once
+ *
+ *  Each module is calibrated with \ref Calibrate() on its own thread and the
+ *  errors of all modules are returned. A projector calibration needs the
+ *  finished calibration of its camera, so a camera and the projector it is
+ *  used to calibrate can NOT be solved together. Independent cameras, or
+ *  projectors whose camera calibration was already set, can be.
+ */
+ReturnCode Calibration::Camera::CalibrateConcurrently(const std::vector<Camera*> &modules,
+                                                      std::vector<double>        *reprojection_errors){
+    ReturnCode ret;
+
+    if(!reprojection_errors)
+        return ret.AddError(CALIBRATION_NULL_POINTER_REPROJECTION_ERROR);
+
+    for(unsigned int iModule = 0; iModule < modules.size(); iModule++){
+        if(!modules.at(iModule))
+            return ret.AddError(CALIBRATION_NULL_POINTER_MODULE);
+
+        // The same module would be calibrated on two threads at once
+        for(unsigned int iOther = 0; iOther < iModule; iOther++){
+            if(modules.at(iOther) == modules.at(iModule))
+                return ret.AddError(CALIBRATION_MODULE_LISTED_TWICE);
+        }
+    }
+
+    std::vector<ReturnCode> module_results(modules.size());
+    reprojection_errors->assign(modules.size(), 0.0);
+
+    dlp::Thread::ParallelFor(0, modules.size(), [&](unsigned long long first, unsigned long long last){
+        for(unsigned long long iModule = first; iModule < last; iModule++){
+            module_results.at(iModule) = modules.at(iModule)->Calibrate(&reprojection_errors->at(iModule), true, true, true);
+        }
+    });
+
+    for(unsigned int iModule = 0; iModule < modules.size(); iModule++){
+        ret.Add(module_results.at(iModule));
+    }
+
+    return ret;
+}
+
 }
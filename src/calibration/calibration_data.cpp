@@ -16,10 +16,158 @@
 // C++ standard header files
 #include <vector>                               // Adds std:vector
 #include <string>                               // Adds std::string
+#include <cstdint>                              // Adds uint32_t, uint64_t
+#include <cstdio>                               // Adds fopen, rename
+#include <cstring>                              // Adds memcpy, memcmp
+
+// File mapping and flushing
+#if defined(_WIN32)
+#include <windows.h>
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 /** @brief  Contains all DLP SDK classes, functions, etc. */
 namespace dlp{
 
+// Binary calibration file layout, see Calibration::Data::SaveBinary()
+#define BINARY_FILE_EXTENSION       ".DLPCAL"
+#define BINARY_FILE_IDENTIFIER      "DLPCALIB"
+#define BINARY_IDENTIFIER_SIZE      8
+#define BINARY_FORMAT_VERSION       1
+#define BINARY_HEADER_SIZE          16
+#define BINARY_PAYLOAD_SIZE         ((6 * 4) + (21 * 8))
+#define BINARY_CHECKSUM_SIZE        4
+#define BINARY_FILE_SIZE            (BINARY_HEADER_SIZE + BINARY_PAYLOAD_SIZE + BINARY_CHECKSUM_SIZE)
+
+/** @brief  Returns true if the filename ends with the upper case extension */
+static bool HasExtension(const std::string &filename, const std::string &extension){
+    std::string upper = dlp::String::ToUpperCase(filename);
+    return (upper.size() >= extension.size()) &&
+           (upper.compare(upper.size() - extension.size(), extension.size(), extension) == 0);
+}
+
+/** @brief  Writes a 32-bit value little endian */
+static void PutUInt32(unsigned char *destination, const uint32_t &value){
+    for(unsigned int iByte = 0; iByte < 4; iByte++)
+        destination[iByte] = (unsigned char) (value >> (8 * iByte));
+}
+
+/** @brief  Reads a little endian 32-bit value */
+static uint32_t GetUInt32(const unsigned char *source){
+    uint32_t value = 0;
+    for(unsigned int iByte = 0; iByte < 4; iByte++)
+        value |= ((uint32_t) source[iByte]) << (8 * iByte);
+    return value;
+}
+
+/** @brief  Writes an IEEE 754 double little endian */
+static void PutDouble(unsigned char *destination, const double &value){
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    for(unsigned int iByte = 0; iByte < 8; iByte++)
+        destination[iByte] = (unsigned char) (bits >> (8 * iByte));
+}
+
+/** @brief  Reads a little endian IEEE 754 double */
+static double GetDouble(const unsigned char *source){
+    uint64_t bits = 0;
+    for(unsigned int iByte = 0; iByte < 8; iByte++)
+        bits |= ((uint64_t) source[iByte]) << (8 * iByte);
+
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+/** @brief  Returns the CRC-32 (IEEE 802.3) of the data */
+static uint32_t Crc32(const unsigned char *data, const size_t &size){
+    uint32_t crc = 0xFFFFFFFF;
+    for(size_t iByte = 0; iByte < size; iByte++){
+        crc ^= data[iByte];
+        for(unsigned int iBit = 0; iBit < 8; iBit++)
+            crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+    }
+    return ~crc;
+}
+
+/** @brief  Read only memory mapping of a whole file which is released when
+ *          the object is destroyed */
+class MappedFile{
+public:
+    MappedFile(): data(nullptr), size(0){
+#if defined(_WIN32)
+        this->file_    = INVALID_HANDLE_VALUE;
+        this->mapping_ = NULL;
+#else
+        this->descriptor_ = -1;
+#endif
+    }
+
+    ~MappedFile(){
+#if defined(_WIN32)
+        if(this->data)                             UnmapViewOfFile(this->data);
+        if(this->mapping_)                         CloseHandle(this->mapping_);
+        if(this->file_ != INVALID_HANDLE_VALUE)    CloseHandle(this->file_);
+#else
+        if(this->data)                  munmap((void*) this->data, this->size);
+        if(this->descriptor_ >= 0)      close(this->descriptor_);
+#endif
+    }
+
+    /** @brief Maps the file, returns false if it could not be opened or is empty */
+    bool Open(const std::string &filename){
+#if defined(_WIN32)
+        this->file_ = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+                                  OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+        if(this->file_ == INVALID_HANDLE_VALUE) return false;
+
+        LARGE_INTEGER file_size;
+        if(!GetFileSizeEx(this->file_, &file_size) || (file_size.QuadPart == 0)) return false;
+
+        this->mapping_ = CreateFileMappingA(this->file_, NULL, PAGE_READONLY, 0, 0, NULL);
+        if(!this->mapping_) return false;
+
+        this->data = (const unsigned char*) MapViewOfFile(this->mapping_, FILE_MAP_READ, 0, 0, 0);
+        if(!this->data) return false;
+
+        this->size = (size_t) file_size.QuadPart;
+#else
+        this->descriptor_ = open(filename.c_str(), O_RDONLY);
+        if(this->descriptor_ < 0) return false;
+
+        struct stat file_status;
+        if((fstat(this->descriptor_, &file_status) != 0) || (file_status.st_size <= 0)) return false;
+
+        void *mapping = mmap(nullptr, (size_t) file_status.st_size, PROT_READ, MAP_PRIVATE, this->descriptor_, 0);
+        if(mapping == MAP_FAILED) return false;
+
+        this->data = (const unsigned char*) mapping;
+        this->size = (size_t) file_status.st_size;
+#endif
+        return true;
+    }
+
+    const unsigned char *data;
+    size_t               size;
+
+private:
+    MappedFile(const MappedFile &);
+    MappedFile & operator=(const MappedFile &);
+
+#if defined(_WIN32)
+    HANDLE file_;
+    HANDLE mapping_;
+#else
+    int descriptor_;
+#endif
+};
+
+
 /** @brief  Constructs empty object and allocates memory for calibration data */
 Calibration::Data::Data(){
     // Set the default values
@@ -256,26 +404,60 @@ ReturnCode Calibration::Data::GetModelResolution(unsigned int *columns, unsigned
     return ret;
 }
 
-/** @brief      Saves calibration data to XML file
+/** @brief      Saves calibration data to an XML or binary file
  *  @warning    Overwrites preexisting files
  *  @warning    Modifying the saved files is NOT recommended
  *  @param[in]  filename  Name of file to save calibration to
  *  @retval     CALIBRATION_DATA_FILE_SAVE_FAILED           Could not open or create file to save calibraiton data
- *  @retval     CALIBRATION_DATA_FILE_EXTENSION_INVALID     Filename argument did not have .xml extension
+ *  @retval     CALIBRATION_DATA_FILE_EXTENSION_INVALID     Filename argument did not have .xml or .dlpcal extension
  *  @retval     CALIBRATION_DATA_NOT_COMPLETE               Object did not have complete calibration data
+ *
+ *  Files with the .dlpcal extension are written in the binary format
+ *  described in \ref SaveBinary(). All other files must have the .xml
+ *  extension and are written with cv::FileStorage.
  */
 ReturnCode Calibration::Data::Save(const std::string &filename){
     ReturnCode ret;
 
     // If data is not complete return error
-    if(!this->isComplete()) ret.AddError(CALIBRATION_DATA_NOT_COMPLETE);
+    if(!this->isComplete())
+        return ret.AddError(CALIBRATION_DATA_NOT_COMPLETE);
+
+    if(HasExtension(filename, BINARY_FILE_EXTENSION))
+        return this->SaveBinary(filename);
+
+    return this->SaveXML(filename);
+}
+
+/** @brief      Loads calibration data from an XML or binary file
+ *  @param[in]  filename  Name of file to load calibration data from
+ *  @retval     CALIBRATION_DATA_FILE_LOAD_FAILED           Could not open file to load calibraiton data
+ *  @retval     CALIBRATION_DATA_FILE_INVALID               File is not a calibration data file
+ *  @retval     CALIBRATION_DATA_FILE_VERSION_INVALID       Binary file was written by a newer format version
+ *  @retval     CALIBRATION_DATA_FILE_CHECKSUM_INVALID      Binary file content does NOT match its checksum
+ *  @retval     CALIBRATION_DATA_FILE_TRUNCATED             Binary file is shorter than its header states
+ *  @retval     CALIBRATION_DATA_FILE_EXTENSION_INVALID     Filename argument did not have .xml or .dlpcal extension
+ *
+ *  The object is NOT modified if the file can NOT be loaded.
+ */
+ReturnCode Calibration::Data::Load(const std::string &filename){
+    if(HasExtension(filename, BINARY_FILE_EXTENSION))
+        return this->LoadBinary(filename);
+
+    return this->LoadXML(filename);
+}
+
+/** @brief      Saves calibration data to XML file
+ *  @param[in]  filename  Name of file to save calibration to
+ *  @retval     CALIBRATION_DATA_FILE_SAVE_FAILED           Could not open or create file to save calibraiton data
+ *  @retval     CALIBRATION_DATA_FILE_EXTENSION_INVALID     Filename argument did not have .xml extension
+ */
+ReturnCode Calibration::Data::SaveXML(const std::string &filename) const{
+    ReturnCode ret;
 
     // Check that file has .xml extension
     if( dlp::String::ToUpperCase(filename).rfind(".XML") == std::string::npos)
-        ret.AddError(CALIBRATION_DATA_FILE_EXTENSION_INVALID);
-
-    // Check for errors
-    if(ret.hasErrors()) return ret;
+        return ret.AddError(CALIBRATION_DATA_FILE_EXTENSION_INVALID);
 
     // Open XML file
     cv::FileStorage file(filename,cv::FileStorage::WRITE);
@@ -312,7 +494,7 @@ ReturnCode Calibration::Data::Save(const std::string &filename){
  *  @retval     CALIBRATION_DATA_FILE_INVALID               File did not contain "DLP_CALIBRATION_DATA" flag
  *  @retval     CALIBRATION_DATA_FILE_EXTENSION_INVALID     Filename argument did not have .xml extension
  */
-ReturnCode Calibration::Data::Load(const std::string &filename){
+ReturnCode Calibration::Data::LoadXML(const std::string &filename){
     ReturnCode ret;
 
     // Check that file has .xml extension
@@ -329,7 +511,7 @@ ReturnCode Calibration::Data::Load(const std::string &filename){
 
 
     // Write calibration data to file
-    bool is_dlp_calibration_data;
+    bool is_dlp_calibration_data = false;
     file["DLP_CALIBRATION_DATA"] >> is_dlp_calibration_data;
 
     // Check that this is a dlp claibraiton data file
@@ -366,4 +548,174 @@ ReturnCode Calibration::Data::Load(const std::string &filename){
     return ret;
 }
 
+/** @brief      Saves calibration data to a binary file
+ *  @param[in]  filename  Name of file to save calibration to
+ *  @retval     CALIBRATION_DATA_FILE_SAVE_FAILED   Could not write the file or the calibration matrices have the wrong size
+ *
+ *  All values are stored little endian:
+ *  - 8 byte identifier "DLPCALIB"
+ *  - 32-bit format version and 32-bit payload size
+ *  - Payload: camera flag, image columns and rows, model columns and rows,
+ *    and a reserved word as 32-bit integers, followed by the reprojection
+ *    error, the 3x3 intrinsic, 5 distortion, and 2x3 extrinsic values as
+ *    64-bit doubles in row order
+ *  - CRC-32 of all preceding bytes
+ *
+ *  The file is written next to the destination and renamed over it once it
+ *  is flushed to disk, so a failed write never leaves a partial file behind.
+ */
+ReturnCode Calibration::Data::SaveBinary(const std::string &filename) const{
+    ReturnCode ret;
+
+    // Check the sizes of the calibration matrices
+    if((this->intrinsic_.total()  != 9) ||
+       (this->distortion_.total() != 5) ||
+       (this->extrinsic_.total()  != 6))
+        return ret.AddError(CALIBRATION_DATA_FILE_SAVE_FAILED);
+
+    std::vector<unsigned char> buffer(BINARY_FILE_SIZE, 0);
+    unsigned char *header  = buffer.data();
+    unsigned char *payload = header + BINARY_HEADER_SIZE;
+
+    memcpy(header, BINARY_FILE_IDENTIFIER, BINARY_IDENTIFIER_SIZE);
+    PutUInt32(header + BINARY_IDENTIFIER_SIZE,     BINARY_FORMAT_VERSION);
+    PutUInt32(header + BINARY_IDENTIFIER_SIZE + 4, BINARY_PAYLOAD_SIZE);
+
+    PutUInt32(payload,      this->calibration_of_camera_ ? 1 : 0);
+    PutUInt32(payload +  4, this->image_columns_);
+    PutUInt32(payload +  8, this->image_rows_);
+    PutUInt32(payload + 12, this->model_columns_);
+    PutUInt32(payload + 16, this->model_rows_);
+    PutUInt32(payload + 20, 0);
+
+    unsigned char *value = payload + 24;
+    PutDouble(value, this->reprojection_error_);
+    value += 8;
+
+    // The matrices are converted to doubles in row order
+    const cv::Mat *matrices[3] = { &this->intrinsic_, &this->distortion_, &this->extrinsic_ };
+    for(unsigned int iMatrix = 0; iMatrix < 3; iMatrix++){
+        cv::Mat values;
+        matrices[iMatrix]->convertTo(values, CV_64F);
+        values = values.reshape(1, 1);
+
+        for(int iValue = 0; iValue < values.cols; iValue++){
+            PutDouble(value, values.at<double>(iValue));
+            value += 8;
+        }
+    }
+
+    PutUInt32(payload + BINARY_PAYLOAD_SIZE, Crc32(header, BINARY_HEADER_SIZE + BINARY_PAYLOAD_SIZE));
+
+    // Write and flush a temporary file
+    const std::string temporary = filename + ".partial";
+
+    FILE *file = fopen(temporary.c_str(), "wb");
+    if(!file)
+        return ret.AddError(CALIBRATION_DATA_FILE_SAVE_FAILED);
+
+    bool written = (fwrite(buffer.data(), 1, buffer.size(), file) == buffer.size());
+    written = written && (fflush(file) == 0);
+#if defined(_WIN32)
+    written = written && (_commit(_fileno(file)) == 0);
+#else
+    written = written && (fsync(fileno(file)) == 0);
+#endif
+    written = (fclose(file) == 0) && written;
+
+    // Replace the destination in one step
+    if(written){
+#if defined(_WIN32)
+        written = (MoveFileExA(temporary.c_str(), filename.c_str(),
+                               MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0);
+#else
+        written = (rename(temporary.c_str(), filename.c_str()) == 0);
+#endif
+    }
+
+    if(!written){
+        remove(temporary.c_str());
+        return ret.AddError(CALIBRATION_DATA_FILE_SAVE_FAILED);
+    }
+
+    return ret;
+}
+
+/** @brief      Loads calibration data from a binary file
+ *  @param[in]  filename  Name of file to load calibration data from
+ *  @retval     CALIBRATION_DATA_FILE_LOAD_FAILED           Could not open or map the file
+ *  @retval     CALIBRATION_DATA_FILE_INVALID               File does NOT start with the binary identifier
+ *  @retval     CALIBRATION_DATA_FILE_VERSION_INVALID       File was written by a newer format version
+ *  @retval     CALIBRATION_DATA_FILE_TRUNCATED             File is shorter than its header states
+ *  @retval     CALIBRATION_DATA_FILE_CHECKSUM_INVALID      File content does NOT match its checksum
+ *
+ *  The file is memory mapped and checked before any value is copied. A
+ *  payload larger than the version 1 payload is accepted so that later
+ *  versions may append values, the checksum always covers all of it.
+ */
+ReturnCode Calibration::Data::LoadBinary(const std::string &filename){
+    ReturnCode ret;
+
+    MappedFile file;
+    if(!file.Open(filename))
+        return ret.AddError(CALIBRATION_DATA_FILE_LOAD_FAILED);
+
+    const unsigned char *header = file.data;
+
+    // Check the identifier and version
+    if((file.size < BINARY_HEADER_SIZE) ||
+       (memcmp(header, BINARY_FILE_IDENTIFIER, BINARY_IDENTIFIER_SIZE) != 0))
+        return ret.AddError(CALIBRATION_DATA_FILE_INVALID);
+
+    unsigned long version      = GetUInt32(header + BINARY_IDENTIFIER_SIZE);
+    size_t        payload_size = GetUInt32(header + BINARY_IDENTIFIER_SIZE + 4);
+
+    if((version == 0) || (version > BINARY_FORMAT_VERSION))
+        return ret.AddError(CALIBRATION_DATA_FILE_VERSION_INVALID);
+
+    if(payload_size < BINARY_PAYLOAD_SIZE)
+        return ret.AddError(CALIBRATION_DATA_FILE_INVALID);
+
+    // Check the size and checksum. The payload size is compared with the
+    // space left after the header and checksum so the sum can NOT overflow.
+    if((file.size < (BINARY_HEADER_SIZE + BINARY_CHECKSUM_SIZE)) ||
+       (payload_size > (file.size - BINARY_HEADER_SIZE - BINARY_CHECKSUM_SIZE)))
+        return ret.AddError(CALIBRATION_DATA_FILE_TRUNCATED);
+
+    const unsigned char *payload = header + BINARY_HEADER_SIZE;
+
+    if(GetUInt32(payload + payload_size) != Crc32(header, BINARY_HEADER_SIZE + payload_size))
+        return ret.AddError(CALIBRATION_DATA_FILE_CHECKSUM_INVALID);
+
+    // Copy the calibration data
+    this->calibration_of_camera_ = (GetUInt32(payload) != 0);
+    this->image_columns_         =  GetUInt32(payload +  4);
+    this->image_rows_            =  GetUInt32(payload +  8);
+    this->model_columns_         =  GetUInt32(payload + 12);
+    this->model_rows_            =  GetUInt32(payload + 16);
+
+    const unsigned char *value = payload + 24;
+    this->reprojection_error_ = GetDouble(value);
+    value += 8;
+
+    this->intrinsic_.create(  DLP_CV_INTRINSIC_SETUP  );
+    this->distortion_.create( DLP_CV_DISTORTION_SETUP );
+    this->extrinsic_.create(  DLP_CV_EXTRINSIC_SETUP  );
+
+    cv::Mat *matrices[3] = { &this->intrinsic_, &this->distortion_, &this->extrinsic_ };
+    for(unsigned int iMatrix = 0; iMatrix < 3; iMatrix++){
+        for(    int yRow = 0; yRow < matrices[iMatrix]->rows; yRow++){
+            for(int xCol = 0; xCol < matrices[iMatrix]->cols; xCol++){
+                matrices[iMatrix]->at<double>(yRow, xCol) = GetDouble(value);
+                value += 8;
+            }
+        }
+    }
+
+    // Mark the calibration data as complete
+    this->calibration_complete_ = true;
+
+    return ret;
+}
+
 } // End namespace dlp
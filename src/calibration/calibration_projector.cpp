@@ -5,6 +5,7 @@
 
 // DLP Structured Light SDK header files
 #include <common/debug.hpp>                     // Adds dlp::Debug
+#include <common/other.hpp>                     // Adds dlp::Thread and dlp::Time namespaces
 #include <common/returncode.hpp>                // Adds dlp::ReturnCode
 #include <common/image/image.hpp>               // Adds dlp::Image
 #include <common/parameters.hpp>                // Adds dlp::Parameter
@@ -18,6 +19,7 @@
 // C++ standard header files
 #include <vector>                               // Adds std:vector
 #include <string>                               // Adds std::string
+#include <algorithm>                            // Adds std::min
 
 /** @brief  Contains all DLP SDK classes, functions, etc. */
 namespace dlp{
@@ -58,6 +60,7 @@ void Calibration::Projector::ClearAll(){
     this->board_row_distance_in_pixels_.Set(0);
     this->zero_tangent_distortion_.Set(false);
     this->fix_sixth_order_distortion_.Set(false);
+    this->warm_start_.Set(false);
     this->is_setup_      = false;
     this->camera_set_    = false;
     this->projecter_set_ = false;
@@ -82,6 +85,10 @@ void Calibration::Projector::ClearCalibrationData(){
     this->calibration_data_.Clear();
     this->camera_calibration_data_.Clear();
 
+    // The cleared data can NOT seed the next calibration
+    this->warm_start_valid_ = false;
+    this->board_errors_.clear();
+
     this->debug_.Msg("Calibration data cleared");
 }
 
@@ -391,6 +398,10 @@ ReturnCode Calibration::Projector::Setup(const dlp::Parameters &settings){
     }
     this->debug_.Msg("Calibration fix aspect ratio = " + this->fix_aspect_ratio_.GetEntryValue());
 
+    // Get the warm start setting (not required)
+    settings.Get(&this->warm_start_);
+    this->debug_.Msg("Calibration warm start = " + this->warm_start_.GetEntryValue());
+
 
     // Check for errors
     if(ret.hasErrors()) return ret;
@@ -503,34 +514,25 @@ ReturnCode Calibration::Projector::GenerateCalibrationBoard( dlp::Image *calibra
 
 
 
-/** @brief  Separates the projected calibration board from the printed calibration board
- *          image and analyzes the projected calibration board for the feature points
- *  @param[in]  projector_all_on                  \ref dlp::Image object of when projector is projection full-on white pattern
- *  @param[in]  projector_all_off                 \ref dlp::Image object of when projector is projecting black/blank pattern
+/** @brief  Separates the projected calibration board from the printed calibration board image
+ *  @param[in]  projector_all_on                    \ref dlp::Image object of when projector is projection full-on white pattern
+ *  @param[in]  projector_all_off                   \ref dlp::Image object of when projector is projecting black/blank pattern
  *  @param[in]  board_image_printed_and_projected   \ref dlp::Image object of the projected calibration board on top of the printed calibration board
- *  @param[out] board_image_projected               Returned \ref dlp::Image object of the projected calibration board and is analyzed for calibration board feature points
- *  @param[out] success                             Method returns true if the calibration board feature points were found
- *  @retval     CALIBRATION_NOT_SETUP                       Calibration has not been setup
+ *  @param[out] board_image_projected               Returned \ref dlp::Image object of the projected calibration board
+ *  \note       Only reads settings so several threads may call this at once
  *  @retval     CALIBRATION_PRINTED_IMAGE_EMPTY             Supplied printed calibriaton board image is empty
  *  @retval     CALIBRATION_COMBO_IMAGE_EMPTY               Supplied printed and projected (combination) calibration board image is empty
- *  @retval     CALIBRATION_NULL_POINTER_SUCCESS            Pointer argument is NULL
  *  @retval     CALIBRATION_NULL_POINTER_PROJECTED_BOARD    Pointer argument is NULL
  *  @retval     CALIBRATION_IMAGE_RESOLUTION_MISMATCH       The supplied printed and combo calibration images do NOT have the same resolution
  *  @retval     CALIBRATION_IMAGE_RESOLUTION_INVALID        Supplied image resolution does not match the resolution saved during \ref Setup()
  *  @retval     CALIBRATION_IMAGE_CONVERT_TO_MONO_FAILED    Converting one or both of the supplied images to monochrome failed
- *  @retval     CALIBRATION_BOARD_NOT_DETECTED              Method did NOT find the calibration board feature points
  */
-ReturnCode Calibration::Projector::RemovePrinted_AddProjectedBoard(const Image &projector_all_on,
-                                                                   const Image &projector_all_off,
-                                                                   const Image &board_image_printed_and_projected,
-                                                                         Image *board_image_projected,
-                                                                          bool *success){
-
+ReturnCode Calibration::Projector::RemovePrintedBoard(const Image &projector_all_on,
+                                                      const Image &projector_all_off,
+                                                      const Image &board_image_printed_and_projected,
+                                                            Image *board_image_projected) const{
     ReturnCode ret;
 
-    // Check that calibration has been setup
-    if(!this->isSetup()) return ret.AddError(CALIBRATION_NOT_SETUP);
-
     // Check that the images are not empty
     if(projector_all_on.isEmpty())
         ret.AddError(CALIBRATION_PRINTED_IMAGE_EMPTY);
@@ -541,7 +543,6 @@ ReturnCode Calibration::Projector::RemovePrinted_AddProjectedBoard(const Image &
 
     // Check pointers
     if(!board_image_projected) ret.AddError(CALIBRATION_NULL_POINTER_PROJECTED_BOARD);
-    if(!success)               ret.AddError(CALIBRATION_NULL_POINTER_SUCCESS);
 
     // Check for errors
     if(ret.hasErrors()) return ret;
@@ -639,33 +640,66 @@ ReturnCode Calibration::Projector::RemovePrinted_AddProjectedBoard(const Image &
         }
     }
 
+    // Release the copied images
+    all_on.Clear();
+    all_off.Clear();
+    combo.Clear();
+
+    return ret;
+}
+
+/** @brief  Separates the projected calibration board from the printed calibration board
+ *          image and analyzes the projected calibration board for the feature points
+ *  @param[in]  projector_all_on                  \ref dlp::Image object of when projector is projection full-on white pattern
+ *  @param[in]  projector_all_off                 \ref dlp::Image object of when projector is projecting black/blank pattern
+ *  @param[in]  board_image_printed_and_projected   \ref dlp::Image object of the projected calibration board on top of the printed calibration board
+ *  @param[out] board_image_projected               Returned \ref dlp::Image object of the projected calibration board and is analyzed for calibration board feature points
+ *  @param[out] success                             Method returns true if the calibration board feature points were found
+ *  @retval     CALIBRATION_NOT_SETUP                       Calibration has not been setup
+ *  @retval     CALIBRATION_PRINTED_IMAGE_EMPTY             Supplied printed calibriaton board image is empty
+ *  @retval     CALIBRATION_COMBO_IMAGE_EMPTY               Supplied printed and projected (combination) calibration board image is empty
+ *  @retval     CALIBRATION_NULL_POINTER_SUCCESS            Pointer argument is NULL
+ *  @retval     CALIBRATION_NULL_POINTER_PROJECTED_BOARD    Pointer argument is NULL
+ *  @retval     CALIBRATION_IMAGE_RESOLUTION_MISMATCH       The supplied printed and combo calibration images do NOT have the same resolution
+ *  @retval     CALIBRATION_IMAGE_RESOLUTION_INVALID        Supplied image resolution does not match the resolution saved during \ref Setup()
+ *  @retval     CALIBRATION_IMAGE_CONVERT_TO_MONO_FAILED    Converting one or both of the supplied images to monochrome failed
+ *  @retval     CALIBRATION_BOARD_NOT_DETECTED              Method did NOT find the calibration board feature points
+ */
+ReturnCode Calibration::Projector::RemovePrinted_AddProjectedBoard(const Image &projector_all_on,
+                                                                   const Image &projector_all_off,
+                                                                   const Image &board_image_printed_and_projected,
+                                                                         Image *board_image_projected,
+                                                                          bool *success){
+
+    ReturnCode ret;
+
+    // Check that calibration has been setup
+    if(!this->isSetup()) return ret.AddError(CALIBRATION_NOT_SETUP);
+
+    // Check pointers
+    if(!success) return ret.AddError(CALIBRATION_NULL_POINTER_SUCCESS);
+
+    // Separate the projected board from the printed board
+    ret = this->RemovePrintedBoard(projector_all_on,
+                                   projector_all_off,
+                                   board_image_printed_and_projected,
+                                   board_image_projected);
+
+    // Check for errors
+    if(ret.hasErrors()) return ret;
+
     // Create a cv::Mat for the projected calibration image to be stored
     cv::Mat cv_projected;
 
     // Get the OpenCV data
     board_image_projected->GetOpenCVData(&cv_projected);
 
-    // Look for minimum threshold value
-    std::vector<cv::Point2f> board_feature_locations_xy;
-    cv::Size board_feature_size(this->board_columns_.Get(),this->board_rows_.Get());
-
     // Look for the projected chessboard corners
     this->debug_.Msg("Looking for chessboard corners in calibration image...");
-    if (cv::findChessboardCorners(cv_projected,
-                                  board_feature_size,
-                                  board_feature_locations_xy,
-                                  CV_CALIB_CB_ADAPTIVE_THRESH | CV_CALIB_CB_FILTER_QUADS )){
-
-        this->debug_.Msg("Chessboard corners found");
-        this->debug_.Msg("Refining corner locations...");
-
-        // Board was found. Refine the corner positions
-        // NOTE : Many of these arguments would be good parameter settings for calibration
-        cv::cornerSubPix(cv_projected,
-                         board_feature_locations_xy,
-                         cv::Size(11, 11),
-                         cv::Size(-1, -1),
-                         cv::TermCriteria(CV_TERMCRIT_EPS | CV_TERMCRIT_ITER, 30, 0.1));
+    std::vector<cv::Point2f> board_feature_locations_xy;
+    if (this->DetectBoardFeatures(cv_projected, &board_feature_locations_xy, false)){
+
+        this->debug_.Msg("Chessboard corners found and refined");
 
         // Return success as true and increment counter
         (*success) = true;
@@ -684,14 +718,115 @@ ReturnCode Calibration::Projector::RemovePrinted_AddProjectedBoard(const Image &
     }
 
     // Release cv::Mat objects
-    all_on.Clear();
-    all_off.Clear();
-    combo.Clear();
     cv_projected.release();
 
     return ret;
 }
 
+/** @brief  Separates and analyzes several projected calibration boards concurrently
+ *          and adds the feature points of each board found
+ *  \note   Boards are added in the order supplied so they match the boards added
+ *          to the camera calibration
+ *  @param[in]  projector_all_on                    Images of the projector showing a full-on white pattern
+ *  @param[in]  projector_all_off                   Images of the projector showing a black/blank pattern
+ *  @param[in]  board_images_printed_and_projected  Images of the projected calibration board on top of the printed calibration board
+ *  @param[out] board_images_projected              Returns the separated projected calibration board for each set
+ *  @param[out] success                             Returns true for each set whose board was found
+ *  @param[out] detection_times_ms                  Optional pointer to return the time spent on each set
+ *  @retval     CALIBRATION_NOT_SETUP                       Calibration has not been setup
+ *  @retval     CALIBRATION_NULL_POINTER_SUCCESS            Pointer argument is NULL
+ *  @retval     CALIBRATION_NULL_POINTER_PROJECTED_BOARD    Pointer argument is NULL
+ *  @retval     CALIBRATION_IMAGE_LIST_EMPTY                No images were supplied
+ *  @retval     CALIBRATION_IMAGE_VECTOR_SIZE_MISMATCH      The image vectors are NOT the same length
+ *  @retval     CALIBRATION_BOARD_NOT_DETECTED              No boards were found (warning if only some were NOT found)
+ */
+ReturnCode Calibration::Projector::RemovePrinted_AddProjectedBoards(const std::vector<dlp::Image>   &projector_all_on,
+                                                                    const std::vector<dlp::Image>   &projector_all_off,
+                                                                    const std::vector<dlp::Image>   &board_images_printed_and_projected,
+                                                                    std::vector<dlp::Image>         *board_images_projected,
+                                                                    std::vector<bool>               *success,
+                                                                    std::vector<unsigned long long> *detection_times_ms){
+    ReturnCode ret;
+
+    // Check that calibration has been setup
+    if(!this->isSetup()) return ret.AddError(CALIBRATION_NOT_SETUP);
+
+    // Check pointers
+    if(!board_images_projected) ret.AddError(CALIBRATION_NULL_POINTER_PROJECTED_BOARD);
+    if(!success)                ret.AddError(CALIBRATION_NULL_POINTER_SUCCESS);
+
+    // Check for errors
+    if(ret.hasErrors()) return ret;
+
+    unsigned int board_count = board_images_printed_and_projected.size();
+
+    if(board_count == 0)
+        return ret.AddError(CALIBRATION_IMAGE_LIST_EMPTY);
+
+    if((projector_all_on.size()  != board_count) ||
+       (projector_all_off.size() != board_count))
+        return ret.AddError(CALIBRATION_IMAGE_VECTOR_SIZE_MISMATCH);
+
+    std::vector<std::vector<cv::Point2f>> board_features(board_count);
+    std::vector<ReturnCode>               board_results(board_count);
+    std::vector<unsigned long long>       board_times(board_count, 0);
+
+    board_images_projected->clear();
+    board_images_projected->resize(board_count);
+
+    // Each board is separated and searched on its own thread
+    this->debug_.Msg("Looking for chessboard corners in " + dlp::Number::ToString(board_count) + " images...");
+    dlp::Thread::ParallelFor(0, board_count, [&](unsigned long long first, unsigned long long last){
+        for(unsigned long long iBoard = first; iBoard < last; iBoard++){
+            dlp::Time::Chronograph timer(true);
+
+            board_results.at(iBoard) = this->RemovePrintedBoard(projector_all_on.at(iBoard),
+                                                                projector_all_off.at(iBoard),
+                                                                board_images_printed_and_projected.at(iBoard),
+                                                                &board_images_projected->at(iBoard));
+
+            if(!board_results.at(iBoard).hasErrors()){
+                cv::Mat cv_projected;
+                board_images_projected->at(iBoard).Unsafe_GetOpenCVData(&cv_projected);
+
+                if(!this->DetectBoardFeatures(cv_projected, &board_features.at(iBoard), true))
+                    board_results.at(iBoard).AddError(CALIBRATION_BOARD_NOT_DETECTED);
+            }
+
+            board_times.at(iBoard) = timer.Lap();
+        }
+    });
+
+    // Add the boards in order
+    unsigned int board_found_count = 0;
+    success->assign(board_count, false);
+
+    for(unsigned int iBoard = 0; iBoard < board_count; iBoard++){
+        if(board_results.at(iBoard).hasErrors()){
+            this->debug_.Msg("Board " + dlp::Number::ToString(iBoard) + " NOT added after " + dlp::Number::ToString(board_times.at(iBoard)) + " ms: " + board_results.at(iBoard).ToString());
+            continue;
+        }
+
+        this->debug_.Msg("Board " + dlp::Number::ToString(iBoard) + " found in " + dlp::Number::ToString(board_times.at(iBoard)) + " ms");
+
+        success->at(iBoard) = true;
+        board_found_count++;
+        this->board_number_successes_++;
+
+        this->image_points_xy_.push_back(board_features.at(iBoard));
+        this->object_points_xyz_.push_back(this->calibration_board_feature_points_xyz_);
+    }
+
+    if(detection_times_ms) (*detection_times_ms) = board_times;
+
+    this->debug_.Msg(dlp::Number::ToString(board_found_count) + " of " + dlp::Number::ToString(board_count) + " calibration boards added");
+
+    if(board_found_count == 0)                  ret.AddError(CALIBRATION_BOARD_NOT_DETECTED);
+    else if(board_found_count < board_count)    ret.AddWarning(CALIBRATION_BOARD_NOT_DETECTED);
+
+    return ret;
+}
+
 
 /** @brief Calibrates the projector using OpenCV routines as an inverse camera. Updates all calibraiton data.
  *  \note Reference http://docs.opencv.org/modules/calib3d/doc/camera_calibration_and_3d_reconstruction.html
@@ -720,6 +855,11 @@ ReturnCode Calibration::Projector::Calibrate(double *reprojection_error){
  *  @retval     CALIBRATION_NULL_POINTER_REPROJECTION_ERROR     Input argument is NULL
  *  @retval     CALIBRATION_CAMERA_CALIBRATION_MISSING                  Camera calibraition has not been added using Calibration::Projector::SetCameraCalibration()
  *  @retval     CALIBRATION_CAMERA_CALIBRATION_HOMOGRAPHIES_MISSING     The supplied camera calibration does not have enough homography matrices to transform the observed projected feature points into real space
+ *
+ *  Every added board with a matching camera homography is used. If
+ *  \ref dlp::Calibration::Parameters::WarmStart is set and a previous
+ *  estimate exists, the solver starts from the stored intrinsic and
+ *  distortion instead of the focal length estimate.
  */
 ReturnCode Calibration::Projector::Calibrate(double    *reprojection_error,
                                             const bool &update_intrinsic,
@@ -747,6 +887,14 @@ ReturnCode Calibration::Projector::Calibrate(double    *reprojection_error,
     if(this->board_number_successes_ < this->board_number_required_.Get())
         return ret.AddError(CALIBRATION_NOT_COMPLETE);
 
+    // Use each board which has a camera homography
+    const unsigned int board_count = std::min(this->image_points_xy_.size(),
+                                              this->camera_calibration_data_.homography_.size());
+
+    // Start from the previous estimate if it is stored and updated
+    const bool warm_start = this->warm_start_.Get() && this->warm_start_valid_ &&
+                            update_intrinsic && update_distortion;
+
     // Create calibration flags
     int cv_calibration_flags = CV_CALIB_USE_INTRINSIC_GUESS;
 
@@ -795,60 +943,64 @@ ReturnCode Calibration::Projector::Calibrate(double    *reprojection_error,
     }
 
     // Clear the calibration parameters
-    intrinsic.setTo(  cv::Scalar(0) );
-    distortion.setTo( cv::Scalar(0) );
     extrinsic.setTo(  cv::Scalar(0) );
 
-    // Convert focal length in mm to pixels
-    float focal_length_pixels = this->estimated_focal_length_mm_/ (this->effective_pixel_size_um_/1000);
-    float focal_point_x = (this->effective_model_width_  / 2) + ( (this->effective_model_width_  / 2) * (this->offset_horizontal_.Get() / 100));
-    float focal_point_y = (this->effective_model_height_ / 2) + ( (this->effective_model_height_ / 2) * (this->offset_vertical_.Get()   / 100));
-
-    if(focal_point_x <= 0) focal_point_x = 0;
-    if(focal_point_y <= 0) focal_point_y = 0;
-
-    if(focal_point_x >= this->effective_model_width_)  focal_point_x = this->effective_model_width_ - 1;
-    if(focal_point_y >= this->effective_model_height_) focal_point_y = this->effective_model_height_ - 1;
-
-    // Load guess values for intrinsic parameters
-    intrinsic.setTo(cv::Scalar(0.0));
-    intrinsic.at<double>(0,0) = (double) focal_length_pixels;
-    intrinsic.at<double>(1,1) = (double) focal_length_pixels;
-    intrinsic.at<double>(0,2) = (double) focal_point_x;
-    intrinsic.at<double>(1,2) = (double) focal_point_y;
-    intrinsic.at<double>(2,2) = (double) 1.0;
+    if(warm_start){
+        // The stored intrinsic and distortion are the guess values
+        this->debug_.Msg("Start from the previous intrinsic and distortion estimate");
+    }
+    else{
+        intrinsic.setTo(  cv::Scalar(0) );
+        distortion.setTo( cv::Scalar(0) );
+
+        // Convert focal length in mm to pixels
+        float focal_length_pixels = this->estimated_focal_length_mm_/ (this->effective_pixel_size_um_/1000);
+        float focal_point_x = (this->effective_model_width_  / 2) + ( (this->effective_model_width_  / 2) * (this->offset_horizontal_.Get() / 100));
+        float focal_point_y = (this->effective_model_height_ / 2) + ( (this->effective_model_height_ / 2) * (this->offset_vertical_.Get()   / 100));
+
+        if(focal_point_x <= 0) focal_point_x = 0;
+        if(focal_point_y <= 0) focal_point_y = 0;
+
+        if(focal_point_x >= this->effective_model_width_)  focal_point_x = this->effective_model_width_ - 1;
+        if(focal_point_y >= this->effective_model_height_) focal_point_y = this->effective_model_height_ - 1;
+
+        // Load guess values for intrinsic parameters
+        intrinsic.setTo(cv::Scalar(0.0));
+        intrinsic.at<double>(0,0) = (double) focal_length_pixels;
+        intrinsic.at<double>(1,1) = (double) focal_length_pixels;
+        intrinsic.at<double>(0,2) = (double) focal_point_x;
+        intrinsic.at<double>(1,2) = (double) focal_point_y;
+        intrinsic.at<double>(2,2) = (double) 1.0;
+    }
 
     // Convert the observed feature locations in the camera images to real x,y,z coordinates
-    // using the homography matrices from the camera calibration
-    std::vector<std::vector<cv::Point2f>> image_feature_points_xy;
-
-    for(unsigned int iBoard = 0; iBoard < this->board_number_required_.Get(); iBoard++){
-        cv::Mat image_points_xy_undistorted( this->board_columns_.Get() * this->board_rows_.Get(), 1, CV_32FC2);
-        cv::Mat image_points_xy_transformed( this->board_columns_.Get() * this->board_rows_.Get(), 1, CV_32FC2);
-
-        // Undistort the projectors image points with the camera calibration
-        cv::undistortPoints(cv::Mat(this->image_points_xy_.at(iBoard)),        // camera pixels                     // source
-                            image_points_xy_undistorted,                            // returns normalized camera pixels            // destination
-                            this->camera_calibration_data_.intrinsic_.clone(),           // pixels
-                            this->camera_calibration_data_.distortion_.clone());         // pixels
-
-        // Transform the projectors undistorted image points with the camera's homography
-        cv::perspectiveTransform(image_points_xy_undistorted,     // camera pixels
-                                 image_points_xy_transformed,   // mm in space (assuming checkerboard is z = 0
-                                 this->camera_calibration_data_.homography_.at(iBoard).clone()); // camera pixels
-
-        // Convert cv::Mat to vector of vectors
-        std::vector<cv::Point2f> image_feature_point_xy;
-        for(int iRow = 0; iRow < image_points_xy_transformed.rows; iRow++){
-            image_feature_point_xy.push_back(image_points_xy_transformed.at<cv::Point2f>(iRow));
+    // using the homography matrices from the camera calibration. The boards are
+    // independent so each is processed on its own thread.
+    std::vector<std::vector<cv::Point2f>> image_feature_points_xy(board_count);
+
+    dlp::Thread::ParallelFor(0, board_count, [&](unsigned long long first, unsigned long long last){
+        for(unsigned long long iBoard = first; iBoard < last; iBoard++){
+            cv::Mat image_points_xy_undistorted( this->board_columns_.Get() * this->board_rows_.Get(), 1, CV_32FC2);
+            cv::Mat image_points_xy_transformed( this->board_columns_.Get() * this->board_rows_.Get(), 1, CV_32FC2);
+
+            // Undistort the projectors image points with the camera calibration
+            cv::undistortPoints(cv::Mat(this->image_points_xy_.at(iBoard)),        // camera pixels                     // source
+                                image_points_xy_undistorted,                            // returns normalized camera pixels            // destination
+                                this->camera_calibration_data_.intrinsic_,              // pixels
+                                this->camera_calibration_data_.distortion_);            // pixels
+
+            // Transform the projectors undistorted image points with the camera's homography
+            cv::perspectiveTransform(image_points_xy_undistorted,     // camera pixels
+                                     image_points_xy_transformed,   // mm in space (assuming checkerboard is z = 0
+                                     this->camera_calibration_data_.homography_.at(iBoard)); // camera pixels
+
+            // Convert cv::Mat to vector of vectors
+            std::vector<cv::Point2f> &image_feature_point_xy = image_feature_points_xy.at(iBoard);
+            for(int iRow = 0; iRow < image_points_xy_transformed.rows; iRow++){
+                image_feature_point_xy.push_back(image_points_xy_transformed.at<cv::Point2f>(iRow));
+            }
         }
-
-        image_feature_points_xy.push_back(image_feature_point_xy);
-
-        // Release memory
-        image_points_xy_undistorted.release();
-        image_points_xy_transformed.release();
-    }
+    });
 
 
     // Convert xyz to xy for object points and xy to xyz for image points
@@ -859,7 +1011,7 @@ ReturnCode Calibration::Projector::Calibrate(double    *reprojection_error,
     dmd_feature_points_xy.clear();
     projected_feature_points_xyz.clear();
 
-    for( unsigned int iBoard = 0; iBoard < this->board_number_required_.Get(); iBoard++){
+    for( unsigned int iBoard = 0; iBoard < board_count; iBoard++){
         std::vector<cv::Point2f> dmd_feature_point_xy;
         std::vector<cv::Point3f> image_points_temp;
         for( unsigned int iPoint = 0; iPoint < image_feature_points_xy.at(iBoard).size();iPoint++){
@@ -913,6 +1065,11 @@ ReturnCode Calibration::Projector::Calibrate(double    *reprojection_error,
      (*reprojection_error) = reproj_error;
     this->calibration_data_.reprojection_error_ = reproj_error;
 
+    // Keep the error of each board and the estimate for the next calibration
+    this->StoreBoardErrors(projected_feature_points_xyz, dmd_feature_points_xy,
+                           intrinsic, distortion, rotation_vector, translation_vector);
+    if(update_intrinsic && update_distortion) this->warm_start_valid_ = true;
+
     // Copy the rotation and translation vector to the
     // extrinsic calibration data object
     // Only copys the vectors from the first pattern board
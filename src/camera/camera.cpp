@@ -21,6 +21,28 @@
 
 namespace dlp{
 
+/** @brief  Constructs the base camera without a \ref dlp::BufferPool */
+Camera::Camera(){
+    this->buffer_pool_ = nullptr;
+}
+
+/** @brief  Sets the pool the camera leases frame memory from
+ *  @param[in]  pool    Pool to use, or NULL to allocate each frame with OpenCV.
+ *                      The pool must NOT be destroyed while the camera uses it.
+ *
+ *  Frames already captured keep their memory. Frames from a pool return to
+ *  it when every \ref dlp::Image copy of them is cleared, for example when
+ *  the \ref dlp::Capture::Sequence of a finished scan is cleared.
+ */
+void Camera::SetBufferPool(BufferPool *pool){
+    this->buffer_pool_ = pool;
+}
+
+/** @brief  Returns the pool set with \ref SetBufferPool(), or NULL */
+BufferPool* Camera::GetBufferPool() const{
+    return this->buffer_pool_;
+}
+
 /** @brief      Opens \ref dlp::Image::Window of the most recent frame in a camera buffer
  *  @param[in] title            String title of the live view window
  *  @param[in] camera           \ref dlp::Camera object to retrieve frames from
@@ -50,7 +50,7 @@ OpenCV_Cam::~OpenCV_Cam(){
     this->debug_.Msg("Clearing buffer...");
     while(!this->image_buffer_.queue.empty()){
         // Destroy the image structure contents of the oldest stored frame
-        this->image_buffer_.queue.front().release();
+        this->image_buffer_.queue.front().Clear();
         this->image_buffer_.queue.pop();
     }
 
@@ -326,9 +326,12 @@ void OpenCV_Cam::CaptureThread()
     this->capture_thread_running_ = true;
 
     // Check that the callback has not been requested to stop
+    // Reuse the frame across reads so OpenCV can decode into the same memory.
+    // Each stored frame is copied, into the camera's buffer pool if it has one.
+    cv::Mat new_frame;
+
     bool continue_thread = true;
     while(continue_thread){
-        cv::Mat new_frame;
         bool read_success = false;
 
         // Always grab the frame from the camera if open
@@ -347,12 +350,14 @@ void OpenCV_Cam::CaptureThread()
             if(read_success){
 
                 // Save the new image to the queue
-                this->image_buffer_.queue.push(new_frame.clone());
+                dlp::Image stored_frame;
+                if(stored_frame.Create(new_frame, this->buffer_pool_.load()).hasErrors() == false)
+                    this->image_buffer_.queue.push(stored_frame);
 
                 // Check that the queue has not exceeded its maximum length
                 if(this->image_buffer_.queue.size() > this->image_buffer_.max_count){
                     // Queue has exceeded the maximum size so remove the oldest frame
-                    this->image_buffer_.queue.front().release();
+                    this->image_buffer_.queue.front().Clear();
                     this->image_buffer_.queue.pop();
                 }
             }
@@ -397,7 +402,7 @@ ReturnCode OpenCV_Cam::Start(){
         // Clear the image queue
         while(!this->image_buffer_.queue.empty()){
             // Destroy the image structure contents of the oldest stored frame
-            this->image_buffer_.queue.front().release();
+            this->image_buffer_.queue.front().Clear();
             this->image_buffer_.queue.pop();
         }
 
@@ -454,11 +459,11 @@ ReturnCode OpenCV_Cam::GetFrameBuffered(Image* ret_frame){
 
     // Check that there are images
     if(!this->image_buffer_.queue.empty()){
-        // Grab the oldest frame
-        ret = ret_frame->Create(this->image_buffer_.queue.front());
+        // Hand over the oldest frame. It leaves the buffer so it does NOT need to be copied.
+        (*ret_frame) = this->image_buffer_.queue.front();
 
         // Remove the oldest frame from buffer
-        this->image_buffer_.queue.front().release();
+        this->image_buffer_.queue.front().Clear();
         this->image_buffer_.queue.pop();
     }
     else{
@@ -485,8 +490,10 @@ ReturnCode OpenCV_Cam::GetFrame(Image *ret_frame)
 
     // Check that there are images
     if(!this->image_buffer_.queue.empty()){
-        // Grab the newest frame
-        ret = ret_frame->Create(this->image_buffer_.queue.back());
+        // Copy the newest frame since it stays in the buffer
+        cv::Mat newest_frame;
+        this->image_buffer_.queue.back().Unsafe_GetOpenCVData(&newest_frame);
+        ret = ret_frame->Create(newest_frame, this->buffer_pool_.load());
     }
     else{
         ret.AddError(OPENCV_CAM_IMAGE_BUFFER_EMPTY);
@@ -548,8 +555,8 @@ ReturnCode OpenCV_Cam::GetCaptureSequence(const unsigned int &arg_number_capture
     // Grab arg_num_Captures number of frames from the camera
     for (unsigned int i = 0; i < arg_number_captures; i++)
     {
-        // Grab a frame from the camera
-        ret = this->GetFrame(&new_image);
+        // Take the frames from the buffer in capture order
+        ret = this->GetFrameBuffered(&new_image);
 
         if (ret.hasErrors())
         {
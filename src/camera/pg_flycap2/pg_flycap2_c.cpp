@@ -17,6 +17,7 @@
 #include <queue>                                // Adds std::queue
 #include <atomic>                               // Adds std::atomic_bool
 #include <thread>                               // Adds std::thread
+#include <vector>                               // Adds std::vector
 
 // Point Grey Research FlyCapture 2 Header files
 #include <C/FlyCapture2_C.h>
@@ -31,10 +32,22 @@ struct PG_FlyCapImageBuffer{
     unsigned int            max_count;
     bool                    store_capture;
     std::queue<fc2Image>    queue;
+    std::vector<fc2Image>   spare;      // Frames taken off the queue whose memory is reused by the callback
+    fc2Image                formatted;  // Conversion target reused by every GetFrame call
     std::atomic_flag        lock;
     std::atomic_flag        stop;
 };
 
+/** @brief  Moves a frame off the queue into the spare frames, or destroys it
+ *          when there are already enough spare frames
+ */
+static void RecycleFrame(PG_FlyCapImageBuffer *image_buffer, fc2Image *frame){
+    if(image_buffer->spare.size() < image_buffer->max_count)
+        image_buffer->spare.push_back(*frame);
+    else
+        fc2DestroyImage(frame);
+}
+
 /** @brief  Constructor for PG_FlyCap2_C object
  */
 PG_FlyCap2_C::PG_FlyCap2_C(){
@@ -51,6 +64,8 @@ PG_FlyCap2_C::PG_FlyCap2_C(){
 	PG_FlyCapImageBuffer *temp = (PG_FlyCapImageBuffer *)this->image_buffer_;
 	temp->lock.clear();
 	temp->stop.clear();
+    temp->max_count = this->image_queue_max_frames_.Get();
+    fc2CreateImage(&temp->formatted);
 
     this->height_.Set(0);
     this->width_.Set(0);
@@ -77,6 +92,12 @@ PG_FlyCap2_C::~PG_FlyCap2_C(){
     this->debug_.Msg("Disconnecting...");
     this->Disconnect();
 
+    // Release the reused frames once the callback can no longer take them
+    for(unsigned int iFrame = 0; iFrame < image_buffer->spare.size(); iFrame++)
+        fc2DestroyImage(&image_buffer->spare.at(iFrame));
+    image_buffer->spare.clear();
+    fc2DestroyImage(&image_buffer->formatted);
+
     this->debug_.Msg("Deallocating memory...");
     delete (PG_FlyCapImageBuffer*)this->image_buffer_;
     delete (fc2Context*)this->camera_context_;
@@ -251,6 +272,12 @@ ReturnCode PG_FlyCap2_C::Setup(const dlp::Parameters &settings)
     case PixelFormat::RGB8:
         format7_settings_new.pixelFormat = FC2_PIXEL_FORMAT_RGB8;
         break;
+    case PixelFormat::MONO12:
+        format7_settings_new.pixelFormat = FC2_PIXEL_FORMAT_MONO12;
+        break;
+    case PixelFormat::MONO16:
+        format7_settings_new.pixelFormat = FC2_PIXEL_FORMAT_MONO16;
+        break;
     default:
         this->debug_.Msg("Invalid pixel format, camera NOT setup!");
         ret.AddError(PG_FLYCAP_C_INVALID_PIXEL_FORMAT);
@@ -980,8 +1007,15 @@ void OnImageGrabbed(fc2Image *image, void *pCallbackData)
         while (image_buffer->lock.test_and_set()) {}
 
         if(image_buffer->store_capture){
-            // Create memory for the new image and copy the data from the pointer
-            fc2CreateImage(&image_copy);
+            // Reuse a spare frame, which already has memory for the image,
+            // or create a new one and copy the data from the pointer
+            if(!image_buffer->spare.empty()){
+                image_copy = image_buffer->spare.back();
+                image_buffer->spare.pop_back();
+            }
+            else{
+                fc2CreateImage(&image_copy);
+            }
             fc2ConvertImage(image, &image_copy);
 
             // Save the new image to the queue
@@ -990,7 +1024,7 @@ void OnImageGrabbed(fc2Image *image, void *pCallbackData)
             // Check that the queue has not exceeded its maximum length
             if(image_buffer->queue.size() > image_buffer->max_count){
                 // Queue has exceeded the maximum size so remove the oldest frame
-                fc2DestroyImage(&image_buffer->queue.front());
+                RecycleFrame(image_buffer, &image_buffer->queue.front());
                 image_buffer->queue.pop();
             }
         }
@@ -1036,16 +1070,16 @@ ReturnCode PG_FlyCap2_C::Start()
         // Tell capture callback to store images
         image_buffer->store_capture = true;
 
+        // Save the maximum queue size
+        image_buffer->max_count = this->image_queue_max_frames_.Get();
+
         // Clear the image queue
         while(!image_buffer->queue.empty()){
-            // Destroy the image structure contents of the oldest stored frame
-            camera_error = fc2DestroyImage(&image_buffer->queue.front());
+            // Keep the memory of the oldest stored frame for the next captures
+            RecycleFrame(image_buffer, &image_buffer->queue.front());
             image_buffer->queue.pop();
         }
 
-        // Save the maximum queue size
-        image_buffer->max_count = this->image_queue_max_frames_.Get();
-
         // Clear the lock
         image_buffer->lock.clear();
         image_buffer->stop.clear();
@@ -1113,7 +1147,6 @@ ReturnCode PG_FlyCap2_C::Stop()
 ReturnCode PG_FlyCap2_C::GetFrameBuffered(Image* ret_frame){
     ReturnCode ret;
     PG_FlyCapImageBuffer* image_buffer = (PG_FlyCapImageBuffer*)this->image_buffer_;
-    fc2Image pg_image_formatted;
 
     // Make sure that a new frame isn't being added to the queue
     while (image_buffer->lock.test_and_set()) {}
@@ -1121,38 +1154,11 @@ ReturnCode PG_FlyCap2_C::GetFrameBuffered(Image* ret_frame){
     // Check that there are images
     if(!image_buffer->queue.empty()){
 
-        fc2CreateImage(&pg_image_formatted);
-
-        // Retreive the oldest image and convert fc2Image image to dlp::Image
-        if(this->pixel_format_.Get() != PG_FlyCap2_C::PixelFormat::RGB8){
-            // Convert the original data from the camera (e.g. RAW8)
-            // to useable data to interpret
-            fc2ConvertImageTo(FC2_PIXEL_FORMAT_MONO8,
-                              &image_buffer->queue.front(),   // Oldest frame from camera
-                              &pg_image_formatted);
-
-            // Convert the fc2Image to dlp::Image
-            ret = ret_frame->Create(pg_image_formatted.cols,
-                                    pg_image_formatted.rows,
-                                    Image::Format::MONO_UCHAR,
-                                    pg_image_formatted.pData);
-        }
-        else{
-            // Convert the original data from the camera (e.g. RAW8)
-            // to useable data to interpret
-            fc2ConvertImageTo(FC2_PIXEL_FORMAT_RGB,
-                              &image_buffer->queue.front(),   // Oldest frame from camera
-                              &pg_image_formatted);
-
-            // Convert the fc2Image to dlp::Image
-            ret = ret_frame->Create(pg_image_formatted.cols,
-                                    pg_image_formatted.rows,
-                                    Image::Format::RGB_UCHAR,
-                                    pg_image_formatted.pData);
-        }
+        // Convert the oldest frame from camera to dlp::Image
+        ret = this->ConvertFrame(&image_buffer->queue.front(), ret_frame);
 
-        fc2DestroyImage(&image_buffer->queue.front());
-        fc2DestroyImage(&pg_image_formatted);
+        // Keep the frame's memory for the capture callback
+        RecycleFrame(image_buffer, &image_buffer->queue.front());
         image_buffer->queue.pop();
     }
     else{
@@ -1175,45 +1181,14 @@ ReturnCode PG_FlyCap2_C::GetFrame(Image *ret_frame)
 {
     ReturnCode ret;
     PG_FlyCapImageBuffer* image_buffer = (PG_FlyCapImageBuffer*)this->image_buffer_;
-    fc2Image pg_image_formatted;
 
     // Make sure that a new frame isn't being added to the queue
     while (image_buffer->lock.test_and_set()) {}
 
     // Check that there are images
     if(!image_buffer->queue.empty()){
-
-        fc2CreateImage(&pg_image_formatted);
-
-        // Retreive the oldest image and convert fc2Image image to dlp::Image
-        if(this->pixel_format_.Get() != PG_FlyCap2_C::PixelFormat::RGB8){            
-            // Convert the original data from the camera (e.g. RAW8)
-            // to useable data to interpret
-            fc2ConvertImageTo(FC2_PIXEL_FORMAT_MONO8,
-                              &image_buffer->queue.back(),   // Newest frame from camera
-                              &pg_image_formatted);
-
-            // Convert the fc2Image to dlp::Image
-            ret = ret_frame->Create(pg_image_formatted.cols,
-                                    pg_image_formatted.rows,
-                                    Image::Format::MONO_UCHAR,
-                                    pg_image_formatted.pData);
-        }
-        else{
-            // Convert the original data from the camera (e.g. RAW8)
-            // to useable data to interpret
-            fc2ConvertImageTo(FC2_PIXEL_FORMAT_RGB,
-                              &image_buffer->queue.back(),   // Newest frame from camera
-                              &pg_image_formatted);
-
-            // Convert the fc2Image to dlp::Image
-            ret = ret_frame->Create(pg_image_formatted.cols,
-                                    pg_image_formatted.rows,
-                                    Image::Format::RGB_UCHAR,
-                                    pg_image_formatted.pData);
-        }
-
-        fc2DestroyImage(&pg_image_formatted);
+        // Convert the newest frame from camera to dlp::Image
+        ret = this->ConvertFrame(&image_buffer->queue.back(), ret_frame);
     }
     else{
         ret.AddError(PG_FLYCAP_C_IMAGE_BUFFER_EMPTY);
@@ -1225,6 +1200,69 @@ ReturnCode PG_FlyCap2_C::GetFrame(Image *ret_frame)
     return ret;
 }
 
+/** @brief  Converts a stored camera frame to a \ref dlp::Image
+ *
+ *  The conversion reuses the same fc2Image for every frame, and the
+ *  result is copied into the camera's \ref dlp::BufferPool if one is set.
+ *  Call with the image buffer locked.
+ */
+ReturnCode PG_FlyCap2_C::ConvertFrame(void *frame, Image *ret_frame){
+    ReturnCode ret;
+    PG_FlyCapImageBuffer* image_buffer = (PG_FlyCapImageBuffer*)this->image_buffer_;
+    fc2Image* pg_image_formatted = &image_buffer->formatted;
+
+    if(this->pixel_format_.Get() == PG_FlyCap2_C::PixelFormat::MONO12){
+        // Unpack the 12-bit data straight from the camera's frame
+        fc2Image* pg_image = (fc2Image*)frame;
+        ret = ret_frame->CreateFromPacked(pg_image->cols,
+                                          pg_image->rows,
+                                          Image::Packing::MONO12_PACKED,
+                                          pg_image->pData,
+                                          pg_image->stride,
+                                          this->buffer_pool_.load());
+    }
+    else if(this->pixel_format_.Get() == PG_FlyCap2_C::PixelFormat::MONO16){
+        // Keep the full depth of the camera's data
+        fc2ConvertImageTo(FC2_PIXEL_FORMAT_MONO16, (fc2Image*)frame, pg_image_formatted);
+
+        // Convert the fc2Image to dlp::Image
+        ret = ret_frame->Create(pg_image_formatted->cols,
+                                pg_image_formatted->rows,
+                                Image::Format::MONO_USHORT,
+                                pg_image_formatted->pData,
+                                pg_image_formatted->stride,
+                                this->buffer_pool_.load());
+    }
+    else if(this->pixel_format_.Get() != PG_FlyCap2_C::PixelFormat::RGB8){
+        // Convert the original data from the camera (e.g. RAW8)
+        // to useable data to interpret
+        fc2ConvertImageTo(FC2_PIXEL_FORMAT_MONO8, (fc2Image*)frame, pg_image_formatted);
+
+        // Convert the fc2Image to dlp::Image
+        ret = ret_frame->Create(pg_image_formatted->cols,
+                                pg_image_formatted->rows,
+                                Image::Format::MONO_UCHAR,
+                                pg_image_formatted->pData,
+                                pg_image_formatted->stride,
+                                this->buffer_pool_.load());
+    }
+    else{
+        // Convert the original data from the camera (e.g. RAW8)
+        // to useable data to interpret
+        fc2ConvertImageTo(FC2_PIXEL_FORMAT_RGB, (fc2Image*)frame, pg_image_formatted);
+
+        // Convert the fc2Image to dlp::Image
+        ret = ret_frame->Create(pg_image_formatted->cols,
+                                pg_image_formatted->rows,
+                                Image::Format::RGB_UCHAR,
+                                pg_image_formatted->pData,
+                                pg_image_formatted->stride,
+                                this->buffer_pool_.load());
+    }
+
+    return ret;
+}
+
 
 /**
  * @brief           Return a capture sequence with specified number of image \ref dlp::Image captures
@@ -1281,8 +1319,8 @@ ReturnCode PG_FlyCap2_C::GetCaptureSequence(const unsigned int &arg_number_captu
     // Grab arg_num_Captures number of frames from the camera
     for (unsigned int i = 0; i < arg_number_captures; i++)
     {
-        // Grab a frame from the camera
-        ret = this->GetFrame(&pg_image);
+        // Take the frames from the buffer in capture order
+        ret = this->GetFrameBuffered(&pg_image);
 
         if (ret.hasErrors())
         {
@@ -1406,6 +1444,8 @@ template <> std::string ToString<dlp::PG_FlyCap2_C::PixelFormat>( dlp::PG_FlyCap
     case dlp::PG_FlyCap2_C::PixelFormat::RAW8:      return "RAW8";
     case dlp::PG_FlyCap2_C::PixelFormat::MONO8:     return "MONO8";
     case dlp::PG_FlyCap2_C::PixelFormat::RGB8:      return "RGB8";
+    case dlp::PG_FlyCap2_C::PixelFormat::MONO12:    return "MONO12";
+    case dlp::PG_FlyCap2_C::PixelFormat::MONO16:    return "MONO16";
     case dlp::PG_FlyCap2_C::PixelFormat::INVALID:   return "INVALID";
     }
     return "INVALID";
@@ -1424,6 +1464,12 @@ template <> dlp::PG_FlyCap2_C::PixelFormat ToNumber( const std::string &text, un
     else if (text.compare("RGB8") == 0){
         return dlp::PG_FlyCap2_C::PixelFormat::RGB8;
     }
+    else if (text.compare("MONO12") == 0){
+        return dlp::PG_FlyCap2_C::PixelFormat::MONO12;
+    }
+    else if (text.compare("MONO16") == 0){
+        return dlp::PG_FlyCap2_C::PixelFormat::MONO16;
+    }
     else{
         return dlp::PG_FlyCap2_C::PixelFormat::INVALID;
     }
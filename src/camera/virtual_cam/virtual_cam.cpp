@@ -0,0 +1,391 @@
+/** @file   virtual_cam.cpp
+ *  @brief  Contains methods for \ref dlp::Virtual_Cam class
+ *  @copyright 2016 Texas Instruments Incorporated - http://www.ti.com/ ALL RIGHTS RESERVED
+ */
+
+// DLP Structured Light SDK header files
+#include <common/debug.hpp>                     // Adds dlp::Debug
+#include <common/other.hpp>                     // Adds dlp::CmdLine, Time, File, String, Number namespaces
+#include <common/returncode.hpp>                // Adds dlp::ReturnCode
+#include <common/image/image.hpp>               // Adds dlp::Image
+#include <common/parameters.hpp>                // Adds dlp::Parameter
+#include <camera/camera.hpp>                    // Adds dlp::Camera
+#include <camera/virtual_cam/virtual_cam.hpp>   // Adds dlp::Virtual_Cam
+
+// OpenCV header files
+#include <opencv2/opencv.hpp>                   // Adds cv::resize
+
+// C++ standard header files
+#include <chrono>                               // Adds std::chrono::steady_clock
+#include <thread>                               // Adds std::this_thread::sleep_until
+#include <string>                               // Adds std::string
+
+/** @brief Contains all DLP SDK classes, functions, etc. */
+namespace dlp{
+
+Virtual_Cam::Virtual_Cam(){
+    this->debug_.SetName("VIRTUAL_CAM_DEBUG(" + dlp::Number::ToString(this)+ "): ");
+    this->is_connected_ = false;
+    this->is_setup_     = false;
+    this->is_started_   = false;
+    this->projector_    = nullptr;
+    this->last_frame_   = std::chrono::steady_clock::now();
+}
+
+Virtual_Cam::~Virtual_Cam(){
+    this->Disconnect();
+}
+
+/** @brief  Sets the virtual projector the camera is looking at
+ *  @retval VIRTUAL_CAM_NULL_POINTER    Projector pointer is NULL
+ */
+ReturnCode Virtual_Cam::SetProjector(const dlp::Virtual_Projector *projector){
+    ReturnCode ret;
+
+    if(!projector)
+        return ret.AddError(VIRTUAL_CAM_NULL_POINTER);
+
+    this->projector_ = projector;
+    return ret;
+}
+
+/** @brief  Sets the reflectance of the scene seen by each camera pixel
+ *  @param[in]  reflectance \ref dlp::Image::Format::MONO_FLOAT or \ref dlp::Image::Format::MONO_DOUBLE
+ *                          map which is resampled to the camera resolution
+ *  @retval VIRTUAL_CAM_REFLECTANCE_INVALID Reflectance is empty, NOT floating point, or negative
+ *
+ *  A reflectance of one captures the projected intensity at the reference
+ *  shutter time. Must NOT be called while capturing.
+ */
+ReturnCode Virtual_Cam::SetReflectance(const dlp::Image &reflectance){
+    ReturnCode ret;
+
+    dlp::Image::Format format;
+    reflectance.GetDataFormat(&format);
+
+    if(reflectance.isEmpty() ||
+       ((format != dlp::Image::Format::MONO_FLOAT) && (format != dlp::Image::Format::MONO_DOUBLE)))
+        return ret.AddError(VIRTUAL_CAM_REFLECTANCE_INVALID);
+
+    dlp::Image reflectance_image = reflectance;
+    cv::Mat    reflectance_data;
+    reflectance_image.Unsafe_GetOpenCVData(&reflectance_data);
+
+    double minimum;
+    cv::minMaxLoc(reflectance_data, &minimum);
+    if(minimum < 0)
+        return ret.AddError(VIRTUAL_CAM_REFLECTANCE_INVALID);
+
+    reflectance_data.convertTo(this->reflectance_, CV_32FC1);
+    return ret;
+}
+
+/** @brief  Removes the reflectance so every pixel reflects all projected light */
+void Virtual_Cam::ClearReflectance(){
+    this->reflectance_.release();
+}
+
+/** @brief  Connects the camera to its projector
+ *  @retval CAMERA_ALREADY_CONNECTED        Camera has already been connected
+ *  @retval VIRTUAL_CAM_PROJECTOR_NOT_SET   \ref SetProjector() was NOT called
+ */
+ReturnCode Virtual_Cam::Connect(const std::string &id){
+    ReturnCode ret;
+
+    if(this->isConnected())
+        return ret.AddError(CAMERA_ALREADY_CONNECTED);
+
+    if(!this->projector_)
+        return ret.AddError(VIRTUAL_CAM_PROJECTOR_NOT_SET);
+
+    this->camera_id_    = id;
+    this->is_connected_ = true;
+    this->is_setup_     = true;
+
+    return ret;
+}
+
+ReturnCode Virtual_Cam::Disconnect(){
+    ReturnCode ret;
+    this->is_started_   = false;
+    this->is_connected_ = false;
+    return ret;
+}
+
+/** @brief  Sets the camera resolution and frame rate
+ *  @retval CAMERA_FRAME_RATE_INVALID   Frame rate is NOT greater than zero
+ */
+ReturnCode Virtual_Cam::Setup(const dlp::Parameters &settings){
+    ReturnCode ret;
+
+    if(settings.Contains(this->rows_))    settings.Get(&this->rows_);
+    if(settings.Contains(this->columns_)) settings.Get(&this->columns_);
+    if(settings.Contains(this->shutter_)) settings.Get(&this->shutter_);
+
+    if(settings.Contains(this->reference_shutter_)){
+        settings.Get(&this->reference_shutter_);
+        if(!(this->reference_shutter_.Get() > 0))
+            return ret.AddError(CAMERA_EXPOSURE_INVALID);
+    }
+
+    if(settings.Contains(this->ambient_)) settings.Get(&this->ambient_);
+
+    if(settings.Contains(this->frame_rate_)){
+        settings.Get(&this->frame_rate_);
+        if(!(this->frame_rate_.Get() > 0))
+            return ret.AddError(CAMERA_FRAME_RATE_INVALID);
+    }
+
+    this->is_setup_ = true;
+    return ret;
+}
+
+ReturnCode Virtual_Cam::GetSetup(dlp::Parameters *settings) const{
+    ReturnCode ret;
+
+    if(!settings)
+        return ret.AddError(VIRTUAL_CAM_NULL_POINTER);
+
+    settings->Set(this->rows_);
+    settings->Set(this->columns_);
+    settings->Set(this->frame_rate_);
+    settings->Set(this->shutter_);
+    settings->Set(this->reference_shutter_);
+    settings->Set(this->ambient_);
+
+    return ret;
+}
+
+ReturnCode Virtual_Cam::Start(){
+    ReturnCode ret;
+
+    if(!this->isConnected())
+        return ret.AddError(CAMERA_NOT_CONNECTED);
+
+    this->is_started_ = true;
+    this->last_frame_ = std::chrono::steady_clock::now();
+    return ret;
+}
+
+ReturnCode Virtual_Cam::Stop(){
+    ReturnCode ret;
+
+    if(!this->isConnected())
+        return ret.AddError(CAMERA_NOT_CONNECTED);
+
+    this->is_started_ = false;
+    return ret;
+}
+
+/** @brief  Waits for the next frame period and captures what the projector
+ *          currently displays
+ *  @retval CAMERA_NOT_STARTED  \ref Start() was NOT called
+ */
+ReturnCode Virtual_Cam::GetFrame(Image *ret_frame){
+    ReturnCode ret;
+
+    if(!ret_frame)
+        return ret.AddError(VIRTUAL_CAM_NULL_POINTER);
+
+    if(!this->isStarted())
+        return ret.AddError(CAMERA_NOT_STARTED);
+
+    // Pace the frames at the camera frame rate
+    this->last_frame_ += std::chrono::microseconds((unsigned long long)(1000000.0 / this->frame_rate_.Get()));
+    std::this_thread::sleep_until(this->last_frame_);
+
+    dlp::Image projected;
+    ret = this->projector_->GetDisplayedImage(&projected);
+    if(ret.hasErrors()) return ret;
+
+    return this->Expose(projected, ret_frame);
+}
+
+ReturnCode Virtual_Cam::GetFrameBuffered(Image *ret_frame){
+    return this->GetFrame(ret_frame);
+}
+
+/** @brief  Captures the patterns of the sequence the projector has started
+ *  @retval CAMERA_NOT_STARTED          \ref Start() was NOT called
+ *  @retval CAMERA_FRAME_GRAB_FAILED    The projector is NOT displaying a long enough sequence
+ */
+ReturnCode Virtual_Cam::GetCaptureSequence(const unsigned int &arg_number_captures, Capture::Sequence* ret_capture_sequence){
+    ReturnCode ret;
+
+    if(!ret_capture_sequence)
+        return ret.AddError(VIRTUAL_CAM_NULL_POINTER);
+
+    if(!this->isStarted())
+        return ret.AddError(CAMERA_NOT_STARTED);
+
+    for(unsigned int iCapture = 0; iCapture < arg_number_captures; iCapture++){
+        dlp::Image projected;
+        std::chrono::steady_clock::time_point display_end;
+
+        // Each frame is complete once its pattern stops being displayed
+        if(this->projector_->GetSequenceImage(iCapture, &projected, &display_end).hasErrors())
+            return ret.AddError(CAMERA_FRAME_GRAB_FAILED);
+
+        std::this_thread::sleep_until(display_end);
+
+        dlp::Capture capture;
+        capture.camera_id  = 0;
+        capture.pattern_id = iCapture;
+        capture.data_type  = dlp::Capture::DataType::IMAGE_DATA;
+
+        ret = this->Expose(projected, &capture.image_data);
+        if(ret.hasErrors()) return ret;
+
+        if(ret_capture_sequence->Add(capture).hasErrors())
+            return ret.AddError(CAMERA_FRAME_GRAB_FAILED);
+    }
+
+    this->last_frame_ = std::chrono::steady_clock::now();
+
+    return ret;
+}
+
+bool Virtual_Cam::isConnected() const{
+    return this->is_connected_;
+}
+
+bool Virtual_Cam::isStarted() const{
+    return this->is_started_;
+}
+
+ReturnCode Virtual_Cam::GetID(std::string *ret_id) const{
+    ReturnCode ret;
+
+    if(!ret_id)
+        return ret.AddError(VIRTUAL_CAM_NULL_POINTER);
+
+    *ret_id = this->camera_id_;
+    return ret;
+}
+
+/** @brief  Returns the camera rows, which are the projector rows unless set */
+ReturnCode Virtual_Cam::GetRows(unsigned int *ret_rows) const{
+    ReturnCode ret;
+
+    if(!ret_rows)
+        return ret.AddError(VIRTUAL_CAM_NULL_POINTER);
+
+    if(this->rows_.Get() > 0)  *ret_rows = this->rows_.Get();
+    else if(this->projector_)  ret = this->projector_->GetRows(ret_rows);
+    else                       ret.AddError(VIRTUAL_CAM_PROJECTOR_NOT_SET);
+
+    return ret;
+}
+
+/** @brief  Returns the camera columns, which are the projector columns unless set */
+ReturnCode Virtual_Cam::GetColumns(unsigned int *ret_columns) const{
+    ReturnCode ret;
+
+    if(!ret_columns)
+        return ret.AddError(VIRTUAL_CAM_NULL_POINTER);
+
+    if(this->columns_.Get() > 0) *ret_columns = this->columns_.Get();
+    else if(this->projector_)    ret = this->projector_->GetColumns(ret_columns);
+    else                         ret.AddError(VIRTUAL_CAM_PROJECTOR_NOT_SET);
+
+    return ret;
+}
+
+ReturnCode Virtual_Cam::GetFrameRate(float *ret_framerate) const{
+    ReturnCode ret;
+
+    if(!ret_framerate)
+        return ret.AddError(VIRTUAL_CAM_NULL_POINTER);
+
+    *ret_framerate = this->frame_rate_.Get();
+    return ret;
+}
+
+ReturnCode Virtual_Cam::GetExposure(float *ret_exposure) const{
+    ReturnCode ret;
+
+    if(!ret_exposure)
+        return ret.AddError(VIRTUAL_CAM_NULL_POINTER);
+
+    *ret_exposure = this->shutter_.Get();
+    return ret;
+}
+
+/** @brief  Resamples a projected image to the camera resolution and applies
+ *          the exposure and scene reflectance
+ */
+ReturnCode Virtual_Cam::Expose(const dlp::Image &projected, dlp::Image *ret_frame) const{
+    ReturnCode ret;
+
+    ret = this->Resample(projected, ret_frame);
+    if(ret.hasErrors()) return ret;
+
+    // Frames at the reference shutter without ambient light or a reflectance
+    // are the projected image
+    float gain    = this->shutter_.Get() / this->reference_shutter_.Get();
+    float ambient = this->ambient_.Get();
+    if((gain == 1.0f) && (ambient == 0.0f) && this->reflectance_.empty())
+        return ret;
+
+    cv::Mat frame;
+    cv::Mat exposed;
+    ret_frame->Unsafe_GetOpenCVData(&frame);
+    frame.convertTo(exposed, CV_MAKETYPE(CV_32F, frame.channels()), gain, ambient * gain);
+
+    if(!this->reflectance_.empty()){
+        cv::Mat reflectance = this->reflectance_;
+        if(reflectance.size() != frame.size())
+            cv::resize(this->reflectance_, reflectance, frame.size(), 0, 0, cv::INTER_LINEAR);
+
+        if(frame.channels() > 1){
+            std::vector<cv::Mat> channels(frame.channels(), reflectance);
+            cv::merge(channels, reflectance);
+        }
+
+        cv::multiply(exposed, reflectance, exposed);
+    }
+
+    // Writes into the frame buffer and saturates at the maximum pixel value
+    exposed.convertTo(frame, frame.type());
+
+    return ret;
+}
+
+/** @brief  Resamples a projected image to the camera resolution */
+ReturnCode Virtual_Cam::Resample(const dlp::Image &projected, dlp::Image *ret_frame) const{
+    ReturnCode ret;
+
+    unsigned int rows    = 0;
+    unsigned int columns = 0;
+    unsigned int projected_rows    = 0;
+    unsigned int projected_columns = 0;
+
+    this->GetRows(&rows);
+    this->GetColumns(&columns);
+    projected.GetRows(&projected_rows);
+    projected.GetColumns(&projected_columns);
+
+    // Read the projected image without copying it. The projector never
+    // modifies a stored pattern.
+    dlp::Image source_image = projected;
+    cv::Mat    source;
+    source_image.Unsafe_GetOpenCVData(&source);
+
+    if((rows == projected_rows) && (columns == projected_columns))
+        return ret_frame->Create(source, this->buffer_pool_.load());
+
+    dlp::Image::Format format;
+    projected.GetDataFormat(&format);
+
+    ret = ret_frame->Create(columns, rows, format, this->buffer_pool_.load());
+    if(ret.hasErrors()) return ret;
+
+    // The frame already has the output size so resize writes into it directly
+    cv::Mat resampled;
+    ret_frame->Unsafe_GetOpenCVData(&resampled);
+    cv::resize(source, resampled, cv::Size(columns, rows), 0, 0, cv::INTER_NEAREST);
+
+    return ret;
+}
+
+}
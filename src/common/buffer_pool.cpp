@@ -0,0 +1,194 @@
+/** @file   buffer_pool.cpp
+ *  @brief  Contains methods for the \ref dlp::BufferPool class
+ *  @copyright  2016 Texas Instruments Incorporated - http://www.ti.com/ ALL RIGHTS RESERVED
+ */
+
+#include <common/returncode.hpp>
+#include <common/buffer_pool.hpp>
+
+#include <algorithm>
+#include <limits>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <vector>
+
+/** @brief  Contains all DLP SDK classes, functions, etc. */
+namespace dlp{
+
+/** @brief  Free blocks and counters shared by the pool and its leases */
+struct BufferPool::State{
+    std::mutex                                      mutex;
+    std::map<size_t, std::vector<unsigned char*>>   free_blocks;
+    size_t                                          max_free_bytes;
+    BufferPool::Statistics                          statistics;
+
+    State(){
+        this->max_free_bytes = std::numeric_limits<size_t>::max();
+        this->statistics     = BufferPool::Statistics();
+    }
+
+    ~State(){
+        this->FreeAll();
+    }
+
+    void FreeAll(){
+        for(auto &bucket : this->free_blocks){
+            for(unsigned char *block : bucket.second) delete[] block;
+        }
+        this->free_blocks.clear();
+        this->statistics.resident_bytes -= this->statistics.free_bytes;
+        this->statistics.free_bytes      = 0;
+    }
+
+    void Return(unsigned char *block, const size_t &bucket){
+        std::lock_guard<std::mutex> lock(this->mutex);
+
+        this->statistics.returns++;
+        this->statistics.leased_bytes -= bucket;
+
+        if(this->statistics.free_bytes + bucket > this->max_free_bytes){
+            this->statistics.discards++;
+            this->statistics.resident_bytes -= bucket;
+            delete[] block;
+            return;
+        }
+
+        this->free_blocks[bucket].push_back(block);
+        this->statistics.free_bytes += bucket;
+    }
+};
+
+BufferPool::BufferPool(){
+    this->state_ = std::make_shared<State>();
+}
+
+/** @brief  Constructs a pool that keeps at most max_free_bytes of unleased blocks */
+BufferPool::BufferPool(const size_t &max_free_bytes){
+    this->state_ = std::make_shared<State>();
+    this->state_->max_free_bytes = max_free_bytes;
+}
+
+/** @brief  Frees the unleased blocks. Outstanding leases free their blocks when released. */
+BufferPool::~BufferPool(){
+    std::lock_guard<std::mutex> lock(this->state_->mutex);
+    this->state_->FreeAll();
+}
+
+/** @brief  Returns the number of bytes actually reserved for a request
+ *
+ *  Requests up to 4 KiB use a single bucket. Larger requests round up to
+ *  the next multiple of 1/8 of their highest power of two, which limits
+ *  the wasted space to 12.5%.
+ */
+size_t BufferPool::GetBucketSize(const size_t &bytes){
+    const size_t minimum = 4096;
+    if(bytes <= minimum) return minimum;
+
+    size_t power = minimum;
+    while((power << 1) <= bytes) power <<= 1;
+
+    size_t step = power >> 3;
+    return ((bytes + step - 1) / step) * step;
+}
+
+/** @brief  Leases a block of at least the requested size
+ *  @param[in]  bytes       Number of bytes required
+ *  @param[out] ret_buffer  Lease to the block. Releasing the last copy returns the block to the pool.
+ *  @retval BUFFER_POOL_SIZE_INVALID            Zero bytes requested
+ *  @retval BUFFER_POOL_ALLOCATION_FAILED       No free block and a new one could NOT be allocated
+ */
+ReturnCode BufferPool::Acquire(const size_t &bytes, std::shared_ptr<unsigned char> *ret_buffer){
+    ReturnCode ret;
+
+    if(!ret_buffer)
+        return ret.AddError(BUFFER_POOL_NULL_POINTER_ARGUMENT);
+
+    if(bytes == 0)
+        return ret.AddError(BUFFER_POOL_SIZE_INVALID);
+
+    size_t          bucket = GetBucketSize(bytes);
+    unsigned char  *block  = nullptr;
+
+    {
+        std::lock_guard<std::mutex> lock(this->state_->mutex);
+        Statistics &statistics = this->state_->statistics;
+
+        auto free_blocks = this->state_->free_blocks.find(bucket);
+        if((free_blocks != this->state_->free_blocks.end()) && !free_blocks->second.empty()){
+            block = free_blocks->second.back();
+            free_blocks->second.pop_back();
+            statistics.hits++;
+            statistics.free_bytes -= bucket;
+        }
+        else{
+            block = new (std::nothrow) unsigned char[bucket];
+            if(!block) return ret.AddError(BUFFER_POOL_ALLOCATION_FAILED);
+
+            statistics.misses++;
+            statistics.resident_bytes     += bucket;
+            statistics.peak_resident_bytes = std::max(statistics.peak_resident_bytes, statistics.resident_bytes);
+        }
+
+        statistics.leased_bytes += bucket;
+    }
+
+    // The lease only holds a weak reference so it can outlive the pool
+    std::weak_ptr<State> state = this->state_;
+    ret_buffer->reset(block, [state, bucket](unsigned char *block_to_return){
+        std::shared_ptr<State> pool = state.lock();
+        if(pool) pool->Return(block_to_return, bucket);
+        else     delete[] block_to_return;
+    });
+
+    return ret;
+}
+
+/** @brief  Limits the bytes kept for reuse. Excess blocks are freed when returned. */
+void BufferPool::SetMaximumFreeBytes(const size_t &bytes){
+    std::lock_guard<std::mutex> lock(this->state_->mutex);
+    this->state_->max_free_bytes = bytes;
+
+    // Free the largest blocks first until the limit is met
+    auto &free_blocks = this->state_->free_blocks;
+    Statistics &statistics = this->state_->statistics;
+    while((statistics.free_bytes > bytes) && !free_blocks.empty()){
+        auto largest = std::prev(free_blocks.end());
+        if(largest->second.empty()){
+            free_blocks.erase(largest);
+            continue;
+        }
+        delete[] largest->second.back();
+        largest->second.pop_back();
+        statistics.free_bytes     -= largest->first;
+        statistics.resident_bytes -= largest->first;
+        statistics.discards++;
+    }
+}
+
+/** @brief  Frees all unleased blocks */
+void BufferPool::Trim(){
+    std::lock_guard<std::mutex> lock(this->state_->mutex);
+    this->state_->FreeAll();
+}
+
+/** @brief  Returns the pool usage counters */
+BufferPool::Statistics BufferPool::GetStatistics() const{
+    std::lock_guard<std::mutex> lock(this->state_->mutex);
+    return this->state_->statistics;
+}
+
+/** @brief  Zeros the counters. Byte totals are kept and the peak restarts at the current resident bytes. */
+void BufferPool::ResetStatistics(){
+    std::lock_guard<std::mutex> lock(this->state_->mutex);
+    Statistics &statistics = this->state_->statistics;
+    statistics.hits     = 0;
+    statistics.misses   = 0;
+    statistics.returns  = 0;
+    statistics.discards = 0;
+    statistics.peak_resident_bytes = statistics.resident_bytes;
+}
+
+}
@@ -0,0 +1,305 @@
+/**
+ * @file    capture_band_reader.cpp
+ * @ingroup group_Common
+ * @brief   Contains \ref dlp::CaptureBandReader methods
+ * @copyright 2016 Texas Instruments Incorporated - http://www.ti.com/ ALL RIGHTS RESERVED
+ */
+
+// Spill files of large sequences exceed 2 GB, use a 64-bit off_t for fseeko
+#if !defined(_WIN32) && !defined(_FILE_OFFSET_BITS)
+#define _FILE_OFFSET_BITS 64
+#endif
+
+// DLP Structured Light SDK header files
+#include <common/other.hpp>                     // Adds dlp::File
+#include <common/returncode.hpp>                // Adds dlp::ReturnCode
+#include <common/image/image.hpp>               // Adds dlp::Image
+#include <common/capture/capture.hpp>           // Adds dlp::Capture
+#include <common/capture/capture_band_reader.hpp>
+
+// C++ standard header files
+#include <cstdio>                               // Adds std::tmpfile, std::fread, std::fwrite, FILE
+#include <vector>                               // Adds std::vector
+
+#if !defined(_WIN32)
+#include <sys/types.h>                          // Adds off_t
+#endif
+
+/** @brief  Moves to a 64-bit byte offset of the file, returns 0 if successful */
+static int SpillSeek(FILE *file, const long long &offset, const int &origin){
+#if defined(_WIN32)
+    return _fseeki64(file, offset, origin);
+#else
+    return fseeko(file, (off_t) offset, origin);
+#endif
+}
+
+/** @brief  Returns the 64-bit byte offset of the file, -1 if unknown */
+static long long SpillTell(FILE *file){
+#if defined(_WIN32)
+    return _ftelli64(file);
+#else
+    return (long long) ftello(file);
+#endif
+}
+
+namespace dlp{
+
+/** @brief  Constructs a closed reader */
+CaptureBandReader::CaptureBandReader(){
+    this->spill_ = NULL;
+    this->open_  = false;
+    this->Close();
+}
+
+/** @brief  Releases the captures and deletes the temporary file */
+CaptureBandReader::~CaptureBandReader(){
+    this->Close();
+}
+
+/** @brief  Releases the captures and deletes the temporary file */
+void CaptureBandReader::Close(){
+    if(this->spill_) std::fclose(this->spill_);
+    this->spill_ = NULL;
+
+    this->frames_.clear();
+    this->spill_offset_.clear();
+    this->buffers_.clear();
+
+    this->columns_ = 0;
+    this->rows_    = 0;
+    this->type_    = CV_8UC1;
+    this->open_    = false;
+}
+
+/** @brief  Returns true if \ref Open() succeeded */
+bool CaptureBandReader::isOpen() const{
+    return this->open_;
+}
+
+/** @brief  Returns the number of captures returned by \ref Read() */
+unsigned int CaptureBandReader::GetCount() const{
+    return this->spill_offset_.size();
+}
+
+/** @brief  Returns the columns of the captures */
+unsigned int CaptureBandReader::GetColumns() const{
+    return this->columns_;
+}
+
+/** @brief  Returns the rows of the captures */
+unsigned int CaptureBandReader::GetRows() const{
+    return this->rows_;
+}
+
+/** @brief  Returns true if the captures are \ref dlp::Image::Format::MONO_USHORT */
+bool CaptureBandReader::isSixteenBit() const{
+    return (this->type_ == CV_16UC1);
+}
+
+/** @brief  Checks that a monochrome capture matches the first capture */
+ReturnCode CaptureBandReader::CheckFrame(const int &columns, const int &rows, const int &type, const bool &first){
+    ReturnCode ret;
+
+    if((type != CV_8UC1) && (type != CV_16UC1))
+        return ret.AddError(CAPTURE_BAND_READER_FORMAT_INVALID);
+
+    if(first){
+        this->columns_ = columns;
+        this->rows_    = rows;
+        this->type_    = type;
+        return ret;
+    }
+
+    if(((unsigned int) columns != this->columns_) ||
+       ((unsigned int) rows    != this->rows_))
+        return ret.AddError(CAPTURE_BAND_READER_SIZE_INVALID);
+
+    // Color captures are converted to 8-bit data, so mixing them with
+    // 16-bit captures is also caught here
+    if(type != this->type_)
+        return ret.AddError(CAPTURE_BAND_READER_FORMAT_INVALID);
+
+    return ret;
+}
+
+/** @brief  Prepares captures of a sequence to be read in bands
+ *  @param[in]  sequence    Sequence to read, it must NOT change until \ref Close()
+ *  @param[in]  first       Index of the first capture to read
+ *  @param[in]  count       Number of captures to read
+ *  @retval CAPTURE_SEQUENCE_INDEX_OUT_OF_RANGE     Sequence has fewer captures than requested
+ *  @retval CAPTURE_TYPE_INVALID                    Capture has neither image data nor a file
+ *  @retval FILE_DOES_NOT_EXIST                     Capture file does NOT exist
+ *  @retval CAPTURE_BAND_READER_SIZE_INVALID        Captures do NOT have the same resolution
+ *  @retval CAPTURE_BAND_READER_FORMAT_INVALID      Captures are NOT all 8-bit or all 16-bit
+ *  @retval CAPTURE_BAND_READER_SPILL_FAILED        Temporary file could NOT be written
+ */
+ReturnCode CaptureBandReader::Open(const Capture::Sequence &sequence,
+                                   const unsigned int &first,
+                                   const unsigned int &count){
+    ReturnCode ret;
+
+    this->Close();
+
+    if((count == 0) || ((first + count) > sequence.GetCount()))
+        return ret.AddError(CAPTURE_SEQUENCE_INDEX_OUT_OF_RANGE);
+
+    for(unsigned int iCapture = 0; iCapture < count; iCapture++){
+        dlp::Capture capture;
+        cv::Mat      data;
+
+        ret = sequence.Get(first + iCapture, &capture);
+        if(ret.hasErrors()){
+            this->Close();
+            return ret;
+        }
+
+        switch(capture.data_type){
+        case dlp::Capture::DataType::IMAGE_DATA:
+        {
+            if(capture.image_data.isEmpty()){
+                this->Close();
+                return ret.AddError(IMAGE_EMPTY);
+            }
+
+            // Reference the data, color captures are converted by Read()
+            capture.image_data.Unsafe_GetOpenCVData(&data);
+
+            int mono_type = (data.channels() == 1) ? data.type() : CV_8UC1;
+            ret = this->CheckFrame(data.cols, data.rows, mono_type, iCapture == 0);
+            if(ret.hasErrors()){
+                this->Close();
+                return ret;
+            }
+
+            this->frames_.push_back(data);
+            this->spill_offset_.push_back(-1);
+            break;
+        }
+        case dlp::Capture::DataType::IMAGE_FILE:
+        {
+            if(!dlp::File::Exists(capture.image_file)){
+                this->Close();
+                return ret.AddError(FILE_DOES_NOT_EXIST);
+            }
+
+            // Only this capture is held in memory while it is spilled
+            dlp::Image image;
+            ret = image.Load(capture.image_file);
+            if(!ret.hasErrors()) image.ConvertToMonochrome();
+            if(!ret.hasErrors()) ret = image.Unsafe_GetOpenCVData(&data);
+            if(!ret.hasErrors()) ret = this->CheckFrame(data.cols, data.rows, data.type(), iCapture == 0);
+            if(ret.hasErrors()){
+                this->Close();
+                return ret;
+            }
+
+            if(!this->spill_) this->spill_ = std::tmpfile();
+            if(!this->spill_){
+                this->Close();
+                return ret.AddError(CAPTURE_BAND_READER_SPILL_FAILED);
+            }
+
+            // Spilled captures are stored one after another without padding
+            long long offset    = -1;
+            size_t    row_bytes = data.cols * data.elemSize();
+
+            if(SpillSeek(this->spill_, 0, SEEK_END) == 0) offset = SpillTell(this->spill_);
+            if(offset < 0){
+                this->Close();
+                return ret.AddError(CAPTURE_BAND_READER_SPILL_FAILED);
+            }
+
+            for(int yRow = 0; yRow < data.rows; yRow++){
+                if(std::fwrite(data.ptr(yRow), 1, row_bytes, this->spill_) != row_bytes){
+                    this->Close();
+                    return ret.AddError(CAPTURE_BAND_READER_SPILL_FAILED);
+                }
+            }
+
+            this->frames_.push_back(cv::Mat());
+            this->spill_offset_.push_back(offset);
+            break;
+        }
+        case dlp::Capture::DataType::INVALID:
+        default:
+            this->Close();
+            return ret.AddError(CAPTURE_TYPE_INVALID);
+        }
+    }
+
+    if(this->spill_) std::fflush(this->spill_);
+
+    this->buffers_.resize(count);
+    this->open_ = true;
+
+    return ret;
+}
+
+/** @brief  Returns the same band of every capture
+ *  @param[in]  band    Rectangle to return in capture pixels
+ *  @param[out] frames  Return pointer for one monochrome band per capture
+ *  @retval CAPTURE_BAND_READER_NOT_OPEN        \ref Open() has NOT succeeded
+ *  @retval CAPTURE_BAND_READER_NULL_POINTER    Return argument is NULL
+ *  @retval CAPTURE_BAND_READER_BAND_INVALID    Band is empty or outside of the captures
+ *  @retval CAPTURE_BAND_READER_SPILL_FAILED    Temporary file could NOT be read
+ *
+ *  Monochrome image data captures are returned without copying. Every
+ *  other band is stored in memory owned by the reader, which is overwritten
+ *  by the next call, so the frames must NOT be modified or kept.
+ */
+ReturnCode CaptureBandReader::Read(const cv::Rect &band, std::vector<cv::Mat> *frames){
+    ReturnCode ret;
+
+    if(!this->open_)
+        return ret.AddError(CAPTURE_BAND_READER_NOT_OPEN);
+
+    if(!frames)
+        return ret.AddError(CAPTURE_BAND_READER_NULL_POINTER);
+
+    if((band.width <= 0) || (band.height <= 0) || (band.x < 0) || (band.y < 0) ||
+       ((unsigned int)(band.x + band.width)  > this->columns_) ||
+       ((unsigned int)(band.y + band.height) > this->rows_))
+        return ret.AddError(CAPTURE_BAND_READER_BAND_INVALID);
+
+    frames->resize(this->frames_.size());
+
+    for(unsigned int iCapture = 0; iCapture < this->frames_.size(); iCapture++){
+        cv::Mat &buffer = this->buffers_.at(iCapture);
+
+        if(this->spill_offset_.at(iCapture) < 0){
+            cv::Mat data = this->frames_.at(iCapture)(band);
+
+            if(data.channels() == 1){
+                frames->at(iCapture) = data;
+                continue;
+            }
+
+            // Convert only the band of color captures
+            dlp::Image color(data);
+            color.ConvertToMonochrome();
+            color.Unsafe_GetOpenCVData(&buffer);
+        }
+        else{
+            // Read each row of the band from the temporary file
+            size_t element   = CV_ELEM_SIZE(this->type_);
+            size_t row_bytes = band.width * element;
+            buffer.create(band.height, band.width, this->type_);
+
+            for(int yRow = 0; yRow < band.height; yRow++){
+                long long offset = this->spill_offset_.at(iCapture) +
+                                   ((((long long)(band.y + yRow) * this->columns_) + band.x) * element);
+
+                if((SpillSeek(this->spill_, offset, SEEK_SET) != 0) ||
+                   (std::fread(buffer.ptr(yRow), 1, row_bytes, this->spill_) != row_bytes))
+                    return ret.AddError(CAPTURE_BAND_READER_SPILL_FAILED);
+            }
+        }
+
+        frames->at(iCapture) = buffer;
+    }
+
+    return ret;
+}
+
+}
@@ -0,0 +1,264 @@
+/** @file       confidence_map.cpp
+ *  @ingroup    Common
+ *  @brief      Contains methods for \ref dlp::ConfidenceMap
+ *  @copyright  2016 Texas Instruments Incorporated - http://www.ti.com/ ALL RIGHTS RESERVED
+ */
+
+#include <common/returncode.hpp>
+#include <common/image/image.hpp>
+#include <common/disparity_map.hpp>
+#include <common/confidence_map.hpp>
+
+/** @brief  Contains all DLP SDK classes, functions, etc. */
+namespace dlp{
+
+/** @brief  Constructs limits which accept every pixel */
+ConfidenceMap::Rejection::Rejection(){
+    this->minimum_modulation   = 0;
+    this->minimum_margin       = 0;
+    this->maximum_global_ratio = 0;
+}
+
+/** @brief  Returns true if any limit is set */
+bool ConfidenceMap::Rejection::isEnabled() const{
+    return (this->minimum_modulation   > 0) ||
+           (this->minimum_margin       > 0) ||
+           (this->maximum_global_ratio > 0);
+}
+
+/** @brief  Constructs an empty object */
+ConfidenceMap::ConfidenceMap(){
+    this->Clear();
+}
+
+/** @brief  Destroys object and releases the measurements */
+ConfidenceMap::~ConfidenceMap(){
+    this->Clear();
+}
+
+/** @brief  Allocates the measurements and sets them to zero
+ *  @param[in]  columns     %Number of columns
+ *  @param[in]  rows        %Number of rows
+ *  @retval CONFIDENCE_MAP_RESOLUTION_INVALID   The resolution has no area
+ */
+ReturnCode ConfidenceMap::Create(const unsigned int &columns, const unsigned int &rows){
+    ReturnCode ret;
+
+    if((columns == 0) || (rows == 0))
+        return ret.AddError(CONFIDENCE_MAP_RESOLUTION_INVALID);
+
+    this->modulation_ = cv::Mat::zeros(rows, columns, CV_32FC1);
+    this->global_     = cv::Mat::zeros(rows, columns, CV_32FC1);
+    this->margin_     = cv::Mat::zeros(rows, columns, CV_32FC1);
+
+    return ret;
+}
+
+/** @brief  Copies the measurements of another object
+ *  @param[in]  map     Object to copy
+ *  @retval CONFIDENCE_MAP_EMPTY    Supplied map is empty
+ */
+ReturnCode ConfidenceMap::Create(const ConfidenceMap &map){
+    ReturnCode ret;
+
+    if(map.isEmpty())
+        return ret.AddError(CONFIDENCE_MAP_EMPTY);
+
+    this->modulation_ = map.modulation_.clone();
+    this->global_     = map.global_.clone();
+    this->margin_     = map.margin_.clone();
+
+    return ret;
+}
+
+/** @brief  Releases the measurements */
+void ConfidenceMap::Clear(){
+    this->modulation_.release();
+    this->global_.release();
+    this->margin_.release();
+}
+
+/** @brief  Returns true if the map has no measurements */
+bool ConfidenceMap::isEmpty() const{
+    return this->modulation_.empty();
+}
+
+/** @brief  Retrieves %number of columns
+ *  @param[out] columns     Pointer for return value
+ *  @retval CONFIDENCE_MAP_EMPTY                    Map has NOT been created
+ *  @retval CONFIDENCE_MAP_NULL_POINTER_ARGUMENT    Return argument NULL
+ */
+ReturnCode ConfidenceMap::GetColumns(unsigned int *columns) const{
+    ReturnCode ret;
+
+    if(this->isEmpty())
+        return ret.AddError(CONFIDENCE_MAP_EMPTY);
+
+    if(!columns)
+        return ret.AddError(CONFIDENCE_MAP_NULL_POINTER_ARGUMENT);
+
+    (*columns) = this->modulation_.cols;
+
+    return ret;
+}
+
+/** @brief  Retrieves %number of rows
+ *  @param[out] rows        Pointer for return value
+ *  @retval CONFIDENCE_MAP_EMPTY                    Map has NOT been created
+ *  @retval CONFIDENCE_MAP_NULL_POINTER_ARGUMENT    Return argument NULL
+ */
+ReturnCode ConfidenceMap::GetRows(unsigned int *rows) const{
+    ReturnCode ret;
+
+    if(this->isEmpty())
+        return ret.AddError(CONFIDENCE_MAP_EMPTY);
+
+    if(!rows)
+        return ret.AddError(CONFIDENCE_MAP_NULL_POINTER_ARGUMENT);
+
+    (*rows) = this->modulation_.rows;
+
+    return ret;
+}
+
+/** @brief  Copies a measurement into a \ref dlp::Image::Format::MONO_FLOAT image */
+static ReturnCode CopyMeasurement(const cv::Mat &measurement, dlp::Image *image){
+    ReturnCode ret;
+
+    if(measurement.empty())
+        return ret.AddError(CONFIDENCE_MAP_EMPTY);
+
+    if(!image)
+        return ret.AddError(CONFIDENCE_MAP_NULL_POINTER_ARGUMENT);
+
+    image->Clear();
+    return image->Create(measurement);
+}
+
+/** @brief  Retrieves the direct illumination of each pixel
+ *  @param[out] modulation  Return pointer for a \ref dlp::Image::Format::MONO_FLOAT image
+ *  @retval CONFIDENCE_MAP_EMPTY                    Map has NOT been created
+ *  @retval CONFIDENCE_MAP_NULL_POINTER_ARGUMENT    Return argument NULL
+ */
+ReturnCode ConfidenceMap::GetModulation(dlp::Image *modulation) const{
+    return CopyMeasurement(this->modulation_, modulation);
+}
+
+/** @brief  Retrieves the global illumination of each pixel
+ *  @param[out] global      Return pointer for a \ref dlp::Image::Format::MONO_FLOAT image
+ *  @retval CONFIDENCE_MAP_EMPTY                    Map has NOT been created
+ *  @retval CONFIDENCE_MAP_NULL_POINTER_ARGUMENT    Return argument NULL
+ */
+ReturnCode ConfidenceMap::GetGlobal(dlp::Image *global) const{
+    return CopyMeasurement(this->global_, global);
+}
+
+/** @brief  Retrieves the smallest bit decision margin of each pixel
+ *  @param[out] margin      Return pointer for a \ref dlp::Image::Format::MONO_FLOAT image
+ *  @retval CONFIDENCE_MAP_EMPTY                    Map has NOT been created
+ *  @retval CONFIDENCE_MAP_NULL_POINTER_ARGUMENT    Return argument NULL
+ */
+ReturnCode ConfidenceMap::GetMargin(dlp::Image *margin) const{
+    return CopyMeasurement(this->margin_, margin);
+}
+
+/** @brief  References the CV_32FC1 measurements without copying them
+ *  @param[out] modulation  Return pointer for the direct illumination
+ *  @param[out] global      Return pointer for the global illumination
+ *  @param[out] margin      Return pointer for the bit decision margins
+ *  @retval CONFIDENCE_MAP_EMPTY                    Map has NOT been created
+ *  @retval CONFIDENCE_MAP_NULL_POINTER_ARGUMENT    Return argument NULL
+ */
+ReturnCode ConfidenceMap::Unsafe_GetOpenCVData(cv::Mat *modulation, cv::Mat *global, cv::Mat *margin){
+    ReturnCode ret;
+
+    if(this->isEmpty())
+        return ret.AddError(CONFIDENCE_MAP_EMPTY);
+
+    if(!modulation || !global || !margin)
+        return ret.AddError(CONFIDENCE_MAP_NULL_POINTER_ARGUMENT);
+
+    (*modulation) = this->modulation_;
+    (*global)     = this->global_;
+    (*margin)     = this->margin_;
+
+    return ret;
+}
+
+/** @brief  Marks the pixels of a \ref dlp::DisparityMap which fail the limits invalid
+ *  @param[in]      rejection       Limits each pixel must meet
+ *  @param[in,out]  disparity_map   Map decoded from the same captures as this object
+ *  @param[out]     ret_rejected    Return pointer for the number of pixels rejected, may be NULL
+ *  @retval CONFIDENCE_MAP_EMPTY                    Map has NOT been created
+ *  @retval CONFIDENCE_MAP_NULL_POINTER_ARGUMENT    Disparity map is NULL
+ *  @retval CONFIDENCE_MAP_RESOLUTION_INVALID       Disparity map resolution does NOT match
+ *
+ *  Pixels which are already invalid are NOT counted.
+ */
+ReturnCode ConfidenceMap::Reject(const Rejection &rejection,
+                                 dlp::DisparityMap *disparity_map,
+                                 unsigned long long *ret_rejected) const{
+    ReturnCode ret;
+
+    if(ret_rejected) (*ret_rejected) = 0;
+
+    if(this->isEmpty())
+        return ret.AddError(CONFIDENCE_MAP_EMPTY);
+
+    if(!disparity_map)
+        return ret.AddError(CONFIDENCE_MAP_NULL_POINTER_ARGUMENT);
+
+    cv::Mat disparity;
+    ret = disparity_map->Unsafe_GetOpenCVData(&disparity);
+    if(ret.hasErrors())
+        return ret;
+
+    if((disparity.cols != this->modulation_.cols) ||
+       (disparity.rows != this->modulation_.rows))
+        return ret.AddError(CONFIDENCE_MAP_RESOLUTION_INVALID);
+
+    unsigned long long rejected = Unsafe_Reject(rejection, this->modulation_, this->global_,
+                                                this->margin_, &disparity);
+    if(ret_rejected) (*ret_rejected) = rejected;
+
+    return ret;
+}
+
+/** @brief  Marks the CV_32SC1 disparity values which fail the limits invalid
+ *  @param[in]      rejection   Limits each pixel must meet
+ *  @param[in]      modulation  CV_32FC1 direct illumination
+ *  @param[in]      global      CV_32FC1 global illumination
+ *  @param[in]      margin      CV_32FC1 bit decision margins
+ *  @param[in,out]  disparity   Disparity data with the same size as the measurements
+ *  @return Number of pixels rejected
+ */
+unsigned long long ConfidenceMap::Unsafe_Reject(const Rejection &rejection,
+                                                const cv::Mat &modulation,
+                                                const cv::Mat &global,
+                                                const cv::Mat &margin,
+                                                cv::Mat *disparity){
+    unsigned long long rejected = 0;
+
+    if(!rejection.isEnabled()) return rejected;
+
+    for(int yRow = 0; yRow < disparity->rows; yRow++){
+        const float *pixel_modulation = modulation.ptr<float>(yRow);
+        const float *pixel_global     = global.ptr<float>(yRow);
+        const float *pixel_margin     = margin.ptr<float>(yRow);
+        int         *pixel_disparity  = disparity->ptr<int>(yRow);
+
+        for(int xCol = 0; xCol < disparity->cols; xCol++){
+            if((pixel_disparity[xCol] == dlp::DisparityMap::INVALID_PIXEL) ||
+               (pixel_disparity[xCol] == dlp::DisparityMap::EMPTY_PIXEL)) continue;
+
+            if(!rejection.isAccepted(pixel_modulation[xCol], pixel_global[xCol], pixel_margin[xCol])){
+                pixel_disparity[xCol] = dlp::DisparityMap::INVALID_PIXEL;
+                rejected++;
+            }
+        }
+    }
+
+    return rejected;
+}
+
+}
@@ -76,6 +76,9 @@ ReturnCode Image::ConvertFormatDLPtoOpenCV(const Format &dlp_format, int* opencv
     case Format::MONO_CHAR:
         (*opencv_format) = CV_8SC1;
         break;
+    case Format::MONO_USHORT:
+        (*opencv_format) = CV_16UC1;
+        break;
     case Format::MONO_INT:
         (*opencv_format) = CV_32S;
         break;
@@ -114,6 +117,9 @@ ReturnCode Image::ConvertFormatOpenCVtoDLP(const int &cv_format, Format* dlp_for
     case CV_8SC1:
         (*dlp_format) = Format::MONO_CHAR;
         break;
+    case CV_16UC1:
+        (*dlp_format) = Format::MONO_USHORT;
+        break;
     case CV_32S:
         (*dlp_format) = Format::MONO_INT;
         break;
@@ -406,8 +412,10 @@ ReturnCode Image::Create( const dlp::Image &src_image ){
     if(src_image.isEmpty())
         return ret.AddError(IMAGE_INPUT_EMPTY);
 
-    cv::Mat data;
-    src_image.GetOpenCVData(&data);
+    // Hold the source data so it survives Clear() when src_image is this
+    // object. Create(cv::Mat) makes the only copy.
+    cv::Mat data = src_image.data_;
+    std::shared_ptr<unsigned char> buffer = src_image.buffer_;
 
     // Create the new image
     ret = this->Create(data);
@@ -418,6 +426,187 @@ ReturnCode Image::Create( const dlp::Image &src_image ){
     return ret;
 }
 
+/** @brief      Allocates memory for object from a \ref dlp::BufferPool
+ *  @warning    This method clears any previous data stored in the object
+ *  @param[in]  columns                 Number of columns
+ *  @param[in]  rows                    Number of rows
+ *  @param[in]  format                  \ref dlp::Image::Format of image pixels
+ *  @param[in]  pool                    Pool to lease the memory from. If NULL the memory is allocated by OpenCV.
+ *  @retval     IMAGE_CREATION_FAILED   Memory allocation failed
+ *  @retval     IMAGE_FORMAT_UNKNOWN    Supplied \ref dlp::Image::Format is invalid
+ *
+ *  The memory returns to the pool when this object and all copies of it
+ *  are cleared or destroyed.
+ */
+ReturnCode Image::Create(const unsigned int &columns, const unsigned int &rows,
+                         const Format &format, BufferPool *pool){
+    ReturnCode ret;
+    int        cv_format   = 0;
+
+    if(!pool) return this->Create(columns, rows, format);
+
+    // Convert the DLP image format to OpenCV format
+    ret = this->ConvertFormatDLPtoOpenCV(format, &cv_format);
+
+    // Check the the format is valid
+    if(ret.hasErrors())
+        return ret;
+
+    if((columns == 0) || (rows == 0))
+        return ret.AddError(IMAGE_CREATION_FAILED);
+
+    // Clear the image if it's already been created
+    this->Clear();
+
+    // Lease the image data
+    std::shared_ptr<unsigned char> buffer;
+    size_t step = columns * CV_ELEM_SIZE(cv_format);
+    if(pool->Acquire(step * rows, &buffer).hasErrors())
+        return ret.AddError(IMAGE_CREATION_FAILED);
+
+    this->data_     = cv::Mat(rows, columns, cv_format, buffer.get(), step);
+    this->buffer_   = buffer;
+    this->format_   = format;       // Set the Image::Format
+    this->empty_    = false;        // Set empty to false since the image has data
+
+    return ret;
+}
+
+/** @brief Copies data from pointer into memory leased from a \ref dlp::BufferPool
+ *  @warning This method clears any previous data stored in the object.
+ *  @param[in]  columns                             Number of columns
+ *  @param[in]  rows                                Number of rows
+ *  @param[in]  format                              dlp::Image::Format of image pixels
+ *  @param[in]  data                                Pointer to image data
+ *  @param[in]  step                                Number of bytes each source row occupies (this value should include any padding bytes)
+ *  @param[in]  pool                                Pool to lease the memory from. If NULL the memory is allocated by OpenCV.
+ *  @retval     IMAGE_FORMAT_UNKNOWN                Supplied \ref dlp::Image::Format is invalid
+ *  @retval     IMAGE_CREATION_FAILED               Memory allocation failed
+ *  @retval     IMAGE_NULL_POINTER_ARGUMENT_DATA    Input argument NULL
+ */
+ReturnCode Image::Create(const unsigned int &columns, const unsigned int &rows,
+                         const Format &format, void *data, const size_t &step, BufferPool *pool){
+    ReturnCode ret;
+    int        cv_format   = 0;
+
+    if(!pool) return this->Create(columns, rows, format, data, step);
+
+    // Convert the DLP3D ImageFormat to OpenCV format
+    ret = this->ConvertFormatDLPtoOpenCV(format, &cv_format);
+
+    // Check the the format is valid
+    if(ret.hasErrors())
+        return ret;
+
+    // Check that pointer is NOT NULL
+    if(!data) return ret.AddError(IMAGE_NULL_POINTER_ARGUMENT_DATA);
+
+    return this->Create(cv::Mat(rows, columns, cv_format, data, step), pool);
+}
+
+/** @brief Copies data from cv::Mat object into memory leased from a \ref dlp::BufferPool
+ *  @warning This method clears any previous data stored in the object.
+ *  @param[in] src_data             cv::Mat object to copy image data from
+ *  @param[in] pool                 Pool to lease the memory from. If NULL the memory is allocated by OpenCV.
+ *  @retval IMAGE_INPUT_EMPTY       Supplied cv::Mat object is empty
+ *  @retval IMAGE_FORMAT_UNKNOWN    Supplied cv::Mat is in an unsupported format
+ */
+ReturnCode Image::Create(const cv::Mat &src_data, BufferPool *pool){
+    ReturnCode  ret;
+
+    if(!pool) return this->Create(src_data);
+
+    // Check that the cv::Mat argument has data
+    if(src_data.empty() == true)
+        return ret.AddError(IMAGE_INPUT_EMPTY);
+
+    // Convert the DLP3D ImageFormat to OpenCV format
+    Format format;
+    ret = ConvertFormatOpenCVtoDLP(src_data.type(),&format);
+
+    // Check the the format is valid
+    if(ret.hasErrors())
+        return ret;
+
+    // Hold the source in case it is this object's data
+    cv::Mat source = src_data;
+    std::shared_ptr<unsigned char> buffer = this->buffer_;
+
+    ret = this->Create(source.cols, source.rows, format, pool);
+    if(ret.hasErrors())
+        return ret;
+
+    // Copy into the leased memory. The sizes match so copyTo does NOT reallocate.
+    source.copyTo(this->data_);
+
+    return ret;
+}
+
+/** @brief Unpacks 12-bit camera data into a \ref Format::MONO_USHORT image
+ *  @warning This method clears any previous data stored in the object.
+ *  @param[in]  columns                             Number of columns
+ *  @param[in]  rows                                Number of rows
+ *  @param[in]  packing                             \ref dlp::Image::Packing of the source pixels
+ *  @param[in]  data                                Pointer to the packed data
+ *  @param[in]  step                                Number of bytes each packed row occupies. Zero for rows without padding.
+ *  @param[in]  pool                                Pool to lease the memory from. If NULL the memory is allocated by OpenCV.
+ *  @retval     IMAGE_NULL_POINTER_ARGUMENT_DATA    Input argument NULL
+ *  @retval     IMAGE_PACKED_STEP_INVALID           Step is smaller than a packed row
+ *  @retval     IMAGE_CREATION_FAILED               Memory allocation failed
+ *
+ *  The pixels keep their 12-bit range of 0 to 4095. Each row must start on
+ *  a byte boundary, which is always true for an even number of columns.
+ */
+ReturnCode Image::CreateFromPacked(const unsigned int &columns, const unsigned int &rows,
+                                   const Packing &packing, const void *data, const size_t &step, BufferPool *pool){
+    ReturnCode ret;
+
+    // Check that pointer is NOT NULL
+    if(!data) return ret.AddError(IMAGE_NULL_POINTER_ARGUMENT_DATA);
+
+    // Each pair of pixels uses three bytes
+    size_t packed_step = (((size_t)columns * 3) + 1) / 2;
+    size_t row_step    = (step == 0) ? packed_step : step;
+    if(row_step < packed_step)
+        return ret.AddError(IMAGE_PACKED_STEP_INVALID);
+
+    ret = this->Create(columns, rows, Format::MONO_USHORT, pool);
+    if(ret.hasErrors())
+        return ret;
+
+    const unsigned char *source = (const unsigned char*) data;
+    const unsigned int   pairs  = columns / 2;
+    const bool           lsb    = (packing == Packing::MONO12P);
+
+    dlp::Thread::ParallelFor(0, rows, [&](unsigned long long first, unsigned long long last){
+        for(unsigned long long yRow = first; yRow < last; yRow++){
+            const unsigned char *packed = source + (yRow * row_step);
+            unsigned short      *pixels = this->data_.ptr<unsigned short>(yRow);
+
+            for(unsigned int iPair = 0; iPair < pairs; iPair++){
+                const unsigned char *bytes = packed + (3 * iPair);
+                if(lsb){
+                    pixels[2*iPair]     = (unsigned short)(bytes[0] | ((bytes[1] & 0x0F) << 8));
+                    pixels[2*iPair + 1] = (unsigned short)((bytes[1] >> 4) | (bytes[2] << 4));
+                }
+                else{
+                    pixels[2*iPair]     = (unsigned short)((bytes[0] << 4) | (bytes[1] & 0x0F));
+                    pixels[2*iPair + 1] = (unsigned short)((bytes[2] << 4) | (bytes[1] >> 4));
+                }
+            }
+
+            // An odd last pixel only uses the first two bytes of its group
+            if(columns % 2){
+                const unsigned char *bytes = packed + (3 * pairs);
+                if(lsb) pixels[columns - 1] = (unsigned short)(bytes[0] | ((bytes[1] & 0x0F) << 8));
+                else    pixels[columns - 1] = (unsigned short)((bytes[0] << 4) | (bytes[1] & 0x0F));
+            }
+        }
+    }, 16);
+
+    return ret;
+}
+
 /** @brief      Loads image file into dlp::Image object
  *  @warning    This method clears any previous data stored in the object
  *  @param[in]  filename                name of file of image file
@@ -482,6 +671,7 @@ void Image::Clear(){
 
     // Release any image data
     this->data_.release();
+    this->buffer_.reset();
 
     // Set empty_ to true
     this->empty_ = true;
@@ -875,6 +1065,37 @@ ReturnCode Image::GetMean(int *ret_val) const{
     return ret;
 }
 
+/**
+ * @brief Retrieves the average pixel value of the image
+ * @param[out]  ret_val     Pointer for return value
+ * @retval      IMAGE_NULL_POINTER_ARGUMENT_RET_VAL Return argument NULL
+ * @retval      IMAGE_EMPTY                         Image has NOT been created
+ * @retval      IMAGE_STORED_IN_DIFFERENT_FORMAT    Attempting to retrieve pixel value in format other than the object's set \ref dlp::Image::Format
+ */
+ReturnCode Image::GetMean(unsigned short *ret_val) const{
+    ReturnCode ret;
+
+    // Check that pointer exists
+    if(!ret_val)
+        return ret.AddError(IMAGE_NULL_POINTER_ARGUMENT_RET_VAL);
+
+    // Set pointer to zero in case image is empty
+    (*ret_val) = 0;
+
+    // Check that image has data
+    if(this->isEmpty())
+        return ret.AddError(IMAGE_EMPTY);
+
+    // Check the format
+    if( this->format_ != Format::MONO_USHORT )
+        return ret.AddError(IMAGE_STORED_IN_DIFFERENT_FORMAT);
+
+    // Set ret pointer to correct value
+    (*ret_val) = cv::mean(this->data_).val[0];
+
+    return ret;
+}
+
 /**
  * @brief Retrieves the average pixel value of the image
  * @param[out]  ret_val     Pointer for return value
@@ -1128,6 +1349,45 @@ ReturnCode Image::GetPixel(const unsigned int &x, const unsigned int &y, int *re
     return ret;
 }
 
+/**
+ * @brief Retrieves pixel value from specific coordinate
+ * @param[in]   x           Column coordinate of desired pixel
+ * @param[in]   y           Row coordinate of desired pixel
+ * @param[out]  ret_val     Pointer for return value
+ * @retval      IMAGE_NULL_POINTER_ARGUMENT_RET_VAL Return argument NULL
+ * @retval      IMAGE_EMPTY                         Image has NOT been created
+ * @retval      IMAGE_PIXEL_OUT_OF_RANGE            Supplied coordinates are NOT valid
+ * @retval      IMAGE_STORED_IN_DIFFERENT_FORMAT    Attempting to retrieve pixel value in format other than the object's set \ref dlp::Image::Format
+ */
+ReturnCode Image::GetPixel(const unsigned int &x, const unsigned int &y, unsigned short *ret_val) const{
+    ReturnCode ret;
+
+    // Check that pointer exists
+    if(!ret_val)
+        return ret.AddError(IMAGE_NULL_POINTER_ARGUMENT_RET_VAL);
+
+    // Set pointer to zero in case image is empty
+    (*ret_val) = 0;
+
+    // Check that image has data
+    if(this->isEmpty())
+        return ret.AddError(IMAGE_EMPTY);
+
+    // Check the pixel location
+    if(x >= (unsigned int) this->data_.cols ||
+       y >= (unsigned int) this->data_.rows)
+        return ret.AddError(IMAGE_PIXEL_OUT_OF_RANGE);
+
+    // Check the format
+    if( this->format_ != Format::MONO_USHORT )
+        return ret.AddError(IMAGE_STORED_IN_DIFFERENT_FORMAT);
+
+    // Set ret pointer to correct value
+    (*ret_val) = this->data_.at<unsigned short>(y,x);
+
+    return ret;
+}
+
 /**
  * @brief Retrieves pixel value from specific coordinate
  * @param[in]   x           Column coordinate of desired pixel
@@ -1341,6 +1601,38 @@ ReturnCode Image::SetPixel( const unsigned int &x, const unsigned int &y, int ar
     return ret;
 }
 
+/**
+ * @brief Sets the pixel value at the specified coordinate
+ * @param[in]   x           Column coordinate of desired pixel
+ * @param[in]   y           Row coordinate of desired pixel
+ * @param[in]   arg_val     Value to store in pixel
+ * @retval      IMAGE_EMPTY                         Image has NOT been created
+ * @retval      IMAGE_PIXEL_OUT_OF_RANGE            Supplied coordinates are NOT valid
+ * @retval      IMAGE_STORED_IN_DIFFERENT_FORMAT    Attempting to store pixel value in format other than the object's set \ref dlp::Image::Format
+ */
+ReturnCode Image::SetPixel( const unsigned int &x, const unsigned int &y, unsigned short arg_val){
+    ReturnCode ret;
+
+    // Check that image has data
+    if(this->isEmpty())
+        return ret.AddError(IMAGE_EMPTY);
+
+    // Check the pixel location
+    if(x >= (unsigned int) this->data_.cols ||
+       y >= (unsigned int) this->data_.rows)
+        return ret.AddError(IMAGE_PIXEL_OUT_OF_RANGE);
+
+
+    // Check the format
+    if( this->format_ != Format::MONO_USHORT )
+        return ret.AddError(IMAGE_STORED_IN_DIFFERENT_FORMAT);
+
+    // Store the pixel value
+    this->data_.at<unsigned short>(y,x) = arg_val;
+
+    return ret;
+}
+
 /**
  * @brief Sets the pixel value at the specified coordinate
  * @param[in]   x           Column coordinate of desired pixel
@@ -1468,6 +1760,20 @@ void Image::Unsafe_GetPixel(const unsigned int &x, const unsigned int &y, int *r
     return;
 }
 
+/**
+ * @brief Retrieves pixel value from specific coordinate
+ * @warning NO error checking is performed and attempting to access an empty image or out of range pixel will crash the program!* @param[in]   x           Column coordinate of desired pixel
+ * @param[in]   y           Row coordinate of desired pixel
+ * @param[out]  ret_val     Pointer for return value
+ */
+void Image::Unsafe_GetPixel(const unsigned int &x, const unsigned int &y, unsigned short *ret_val) const{
+
+    // Set ret pointer to correct value
+    (*ret_val) = this->data_.at<unsigned short>(y,x);
+
+    return;
+}
+
 /**
  * @brief Retrieves pixel value from specific coordinate
  * @warning NO error checking is performed and attempting to access an empty image or out of range pixel will crash the program!* @param[in]   x           Column coordinate of desired pixel
@@ -1563,6 +1869,21 @@ void Image::Unsafe_SetPixel( const unsigned int &x, const unsigned int &y, int a
     return;
 }
 
+/**
+ * @brief Sets the pixel value at the specified coordinate
+ * @warning NO error checking is performed and attempting to access an empty image or out of range pixel will crash the program!
+ * @param[in]   x           Column coordinate of desired pixel
+ * @param[in]   y           Row coordinate of desired pixel
+ * @param[in]   arg_val     Value to store in pixel
+ */
+void Image::Unsafe_SetPixel( const unsigned int &x, const unsigned int &y, unsigned short arg_val){
+
+    // Store the pixel value
+    this->data_.at<unsigned short>(y,x) = arg_val;
+
+    return;
+}
+
 /**
  * @brief Sets the pixel value at the specified coordinate
  * @warning NO error checking is performed and attempting to access an empty image or out of range pixel will crash the program!
@@ -1663,6 +1984,29 @@ ReturnCode Image::FillImage( int arg_val){
     return ret;
 }
 
+/**
+ * @brief Sets all pixels to specified value
+ * @param[in]   arg_val     Value to store in image pixels
+ * @retval      IMAGE_EMPTY                         Image has NOT been created
+ * @retval      IMAGE_STORED_IN_DIFFERENT_FORMAT    Attempting to fill image with value in format other than the object's set \ref dlp::Image::Format
+ */
+ReturnCode Image::FillImage( unsigned short arg_val){
+    ReturnCode ret;
+
+    // Check that image has data
+    if(this->isEmpty())
+        return ret.AddError(IMAGE_EMPTY);
+
+    // Check the format
+    if( this->format_ != Format::MONO_USHORT )
+        return ret.AddError(IMAGE_STORED_IN_DIFFERENT_FORMAT);
+
+    // Fill image to specified value
+    this->data_.setTo(cv::Scalar(arg_val));
+
+    return ret;
+}
+
 /**
  * @brief Sets all pixels to specified value
  * @param[in]   arg_val     Value to store in image pixels
@@ -1755,6 +2099,7 @@ ReturnCode Image::ConvertToMonochrome(){
 
         // Clear the current image data
         this->data_.release();
+        this->buffer_.reset();
 
         // Save the monochrome data
         this->data_ = temp;
@@ -1794,6 +2139,7 @@ ReturnCode Image::ConvertToRGB(){
 
         // Clear the current image data
         this->data_.release();
+        this->buffer_.reset();
 
         // Save the monochrome data
         this->data_ = temp;
@@ -1848,6 +2194,7 @@ template <> std::string ToString<dlp::Image::Format>( dlp::Image::Format format)
     switch (format) {
     case dlp::Image::Format::MONO_UCHAR:    return "MONO_UCHAR";
     case dlp::Image::Format::MONO_CHAR:     return "MONO_CHAR";
+    case dlp::Image::Format::MONO_USHORT:   return "MONO_USHORT";
     case dlp::Image::Format::MONO_INT:      return "MONO_INT";
     case dlp::Image::Format::MONO_FLOAT:    return "MONO_FLOAT";
     case dlp::Image::Format::MONO_DOUBLE:   return "MONO_DOUBLE";
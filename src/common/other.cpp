@@ -34,6 +34,63 @@ void CmdLine::PressEnterToContinue(const std::string &msg){
     std::cin.ignore( std::numeric_limits<std::streamsize>::max(), '\n' );
 }
 
+/** @brief Returns the number of worker threads used by \ref Thread::ParallelFor()
+ *  \note   Falls back to a single thread if the hardware concurrency is unknown
+ *  @ingroup Common
+ */
+unsigned int Thread::GetCount(){
+    unsigned int count = std::thread::hardware_concurrency();
+    if(count == 0) count = 1;
+    return count;
+}
+
+/** @brief      Splits the range [begin, end) into contiguous chunks and calls
+ *              the supplied function once per chunk from separate threads
+ *  \note      The last chunk runs on the calling thread. The method returns
+ *              after every chunk has completed.
+ *  @param[in]  begin       First index of the range
+ *  @param[in]  end         One past the last index of the range
+ *  @param[in]  function    Called as function(chunk_begin, chunk_end)
+ *  @param[in]  min_chunk   Minimum number of indices per chunk
+ *  @ingroup    Common
+ */
+void Thread::ParallelFor(const unsigned long long &begin,
+                         const unsigned long long &end,
+                         const std::function<void(unsigned long long, unsigned long long)> &function,
+                         const unsigned long long &min_chunk){
+    if(end <= begin) return;
+
+    unsigned long long range  = end - begin;
+    unsigned long long chunks = Thread::GetCount();
+
+    // Do not create chunks smaller than requested
+    if(min_chunk > 1) chunks = std::min(chunks, (range + min_chunk - 1) / min_chunk);
+    chunks = std::min(chunks, range);
+    if(chunks <= 1){
+        function(begin, end);
+        return;
+    }
+
+    unsigned long long chunk_size = (range + chunks - 1) / chunks;
+    std::vector<std::thread> workers;
+
+    for(unsigned long long chunk_begin = begin; chunk_begin < end; chunk_begin += chunk_size){
+        unsigned long long chunk_end = std::min(end, chunk_begin + chunk_size);
+
+        if(chunk_end == end){
+            // Run the final chunk on this thread
+            function(chunk_begin, chunk_end);
+        }
+        else{
+            workers.push_back(std::thread(function, chunk_begin, chunk_end));
+        }
+    }
+
+    for(unsigned int iWorker = 0; iWorker < workers.size(); iWorker++){
+        workers.at(iWorker).join();
+    }
+}
+
 /** @brief Returns true if the file exists
  *  @ingroup Common
  */
@@ -118,6 +175,48 @@ void Time::Sleep::Seconds(unsigned int time){
     std::this_thread::sleep_for(timespan);
 }
 
+/** @brief      Repeatedly calls a check until it reports ready, fails, or the timeout passes
+ *
+ *  The first check is made immediately. The pause between checks starts at
+ *  50 microseconds and doubles up to 5 milliseconds, so a condition that is
+ *  already met costs nothing and a slow one is NOT polled continuously.
+ *
+ *  @param[in]  check       Function returning the current state of the condition
+ *  @param[in]  timeout_us  Maximum time to wait in microseconds
+ *  @param[out] elapsed_us  Optional pointer to return the time spent waiting
+ *  @retval     PollResult::READY       The check reported ready
+ *  @retval     PollResult::NOT_READY   The timeout passed before the check reported ready
+ *  @retval     PollResult::FAILED      The check reported a failure
+ *  @ingroup    Common
+ */
+Time::PollResult Time::WaitUntil(const std::function<PollResult()> &check,
+                                 const unsigned long long &timeout_us,
+                                 unsigned long long *elapsed_us){
+    const std::chrono::steady_clock::time_point start    = std::chrono::steady_clock::now();
+    const std::chrono::steady_clock::time_point deadline = start + std::chrono::microseconds(timeout_us);
+    std::chrono::microseconds backoff(50);
+    PollResult result;
+
+    while(true){
+        result = check();
+        if(result != PollResult::NOT_READY) break;
+
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        if(now >= deadline) break;
+
+        // Never sleep past the deadline
+        std::chrono::microseconds remaining = std::chrono::duration_cast<std::chrono::microseconds>(deadline - now);
+        std::this_thread::sleep_for(std::min(backoff, remaining));
+
+        backoff = std::min(backoff * 2, std::chrono::microseconds(5000));
+    }
+
+    if(elapsed_us)
+        (*elapsed_us) = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+    return result;
+}
+
 
 /** @brief Constructs object in a NON-started state */
 Time::Chronograph::Chronograph(){
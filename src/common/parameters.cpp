@@ -7,6 +7,7 @@
 #include <string>
 #include <vector>
 #include <fstream>
+#include <sstream>
 
 #include <common/debug.hpp>
 #include <common/returncode.hpp>
@@ -49,16 +50,26 @@ namespace dlp{
 //    return this->Contains(setting.GetEntryName());
 //}
 
-/** @brief      Creates or updates a list entry
+/** @brief Returns true for the characters removed from the ends of names and values */
+static bool isTrimCharacter(const char &character){
+    return ((character == ' ') || (character == '\t') || (character == '\r'));
+}
+
+/** @brief Returns the string between begin and end without leading and trailing whitespace */
+static std::string TrimRange(const char *begin, const char *end){
+    while((begin < end) && isTrimCharacter(*begin))     begin++;
+    while((end > begin) && isTrimCharacter(*(end - 1))) end--;
+    return std::string(begin, end);
+}
+
+/** @brief      Checks an entry name and value before they are added to the list
  *  @param[in]  name    Name of entry
- *  @param[in]  value   String value to save in entry
- *  \note       The method converts the name to upper case and removes all whitespace. The value is NOT modified in any way.
+ *  @param[in]  value   String value of entry
  *  @retval     PARAMETERS_NO_NAME              Supplied entry name string is empty
  *  @retval     PARAMETERS_ILLEGAL_CHARACTER    Either the name and value, or both, contain an = character
  */
-ReturnCode Parameters::Set(const std::string &name, const std::string &value){
+static ReturnCode CheckEntry(const std::string &name, const std::string &value){
     ReturnCode ret;
-    int  parameter_index = 0;
 
     // Check that the string is NOT empty
     if(name.empty())
@@ -69,18 +80,85 @@ ReturnCode Parameters::Set(const std::string &name, const std::string &value){
        (value.find_first_of("=") != std::string::npos))
         ret.AddError(PARAMETERS_ILLEGAL_CHARACTER);
 
-    if(ret.hasErrors()) return ret;
+    return ret;
+}
 
-    // Does this parameter already exist in the vector?
-    if(this->Contains( dlp::String::Trim(dlp::String::ToUpperCase(name)), &parameter_index)){
-        // The name was correct, update the value
-        this->values_.at(parameter_index) = dlp::String::Trim(value);
+/** @brief Returns true if the name is already upper case without leading or trailing whitespace */
+bool Parameters::isNormalizedName(const std::string &name){
+    if(name.empty()) return true;
+
+    if(isTrimCharacter(name.front()) || isTrimCharacter(name.back())) return false;
+
+    for(std::string::const_iterator character = name.begin(); character != name.end(); ++character){
+        if((*character >= 'a') && (*character <= 'z')) return false;
+    }
+
+    return true;
+}
+
+/** @brief Returns the name in upper case without leading or trailing whitespace */
+std::string Parameters::NormalizeName(const std::string &name){
+    std::string ret = TrimRange(name.data(), name.data() + name.size());
+
+    for(std::string::iterator character = ret.begin(); character != ret.end(); ++character){
+        if((*character >= 'a') && (*character <= 'z')) *character = *character - 'a' + 'A';
+    }
+
+    return ret;
+}
+
+/** @brief      Looks up an entry in the hash index
+ *  @param[in]  name        Entry name, normalized here if needed
+ *  @param[out] ret_index   Pointer to return position in the list
+ */
+bool Parameters::Find(const std::string &name, unsigned int *ret_index) const{
+    std::unordered_map<std::string,unsigned int>::const_iterator entry;
+
+    // Entry names are normally already upper case so avoid the copy
+    if(Parameters::isNormalizedName(name)) entry = this->index_.find(name);
+    else                                   entry = this->index_.find(Parameters::NormalizeName(name));
+
+    if(entry == this->index_.end()) return false;
+
+    if(ret_index) (*ret_index) = entry->second;
+    return true;
+}
+
+/** @brief      Adds or updates an entry whose name is already normalized
+ *  @param[in]  normalized_name Upper case, trimmed entry name
+ *  @param[in]  value           Trimmed entry value
+ *  @param[in]  update_current  If false, an existing entry is left unchanged
+ */
+void Parameters::Insert(const std::string &normalized_name, const std::string &value, const bool &update_current){
+    std::unordered_map<std::string,unsigned int>::iterator entry = this->index_.find(normalized_name);
+
+    if(entry != this->index_.end()){
+        if(update_current) this->values_[entry->second] = value;
     }
     else{
-        // The parameter was NOT found so it is new
-        this->names_.push_back(  dlp::String::Trim(dlp::String::ToUpperCase(name)));
-        this->values_.push_back( dlp::String::Trim(value));
+        this->index_.insert(std::make_pair(normalized_name, (unsigned int) this->names_.size()));
+        this->names_.push_back(normalized_name);
+        this->values_.push_back(value);
     }
+}
+
+/** @brief      Creates or updates a list entry
+ *  @param[in]  name    Name of entry
+ *  @param[in]  value   String value to save in entry
+ *  \note       The method converts the name to upper case and removes all whitespace. The value is NOT modified in any way.
+ *  @retval     PARAMETERS_NO_NAME              Supplied entry name string is empty
+ *  @retval     PARAMETERS_ILLEGAL_CHARACTER    Either the name and value, or both, contain an = character
+ */
+ReturnCode Parameters::Set(const std::string &name, const std::string &value){
+    ReturnCode ret = CheckEntry(name, value);
+
+    if(ret.hasErrors()) return ret;
+
+    // Add the parameter or update its value if it already exists
+    if(Parameters::isNormalizedName(name))
+        this->Insert(name, TrimRange(value.data(), value.data() + value.size()), true);
+    else
+        this->Insert(Parameters::NormalizeName(name), TrimRange(value.data(), value.data() + value.size()), true);
 
     return ret;
 }
@@ -95,7 +173,7 @@ ReturnCode Parameters::Set(const std::string &name, const std::string &value){
  */
 ReturnCode Parameters::Get(const std::string &name, const std::string &default_value, std::string* value) const{
     ReturnCode ret;
-    int  parameter_index = 0;
+    unsigned int parameter_index = 0;
 
     // Check that the string is NOT empty
     if(name.empty() == true) ret.AddError(PARAMETERS_NO_NAME);
@@ -108,7 +186,7 @@ ReturnCode Parameters::Get(const std::string &name, const std::string &default_v
 
 
     // Does this parameter already exist in the vector?
-    if(this->Contains(dlp::String::Trim(dlp::String::ToUpperCase(name)), &parameter_index)){
+    if(this->Find(name, &parameter_index)){
         // The name was correct, update the value
         (*value) = this->values_.at(parameter_index);
     }
@@ -159,13 +237,19 @@ ReturnCode Parameters::Remove( const std::string &name ){
         return ret.AddError(PARAMETERS_NO_NAME);
 
 
-    int  parameter_index = 0;
+    unsigned int parameter_index = 0;
 
     // Does this parameter already exist in the vector?
-    if(this->Contains(dlp::String::Trim(dlp::String::ToUpperCase(name)), &parameter_index)){
+    if(this->Find(name, &parameter_index)){
         // The name was correct, remove the parameter
+        this->index_.erase(this->names_.at(parameter_index));
         this->names_.erase(  this->names_.begin()  + parameter_index);
         this->values_.erase( this->values_.begin() + parameter_index);
+
+        // Entries after the removed one have moved down
+        for(unsigned int kParameter = parameter_index; kParameter < this->names_.size(); kParameter++){
+            this->index_[this->names_.at(kParameter)] = kParameter;
+        }
     }
     else{
         // The parameter was NOT found, return error code
@@ -186,18 +270,12 @@ bool Parameters::Contains(const std::string &name) const{
  *  @param[out] ret_index   Pointer to return index value
  */
 bool Parameters::Contains(const std::string &name, int *ret_index) const{
-    bool ret = false;
-    int  parameter_count = this->names_.size();
+    unsigned int parameter_index = 0;
 
-    // Does this parameter already exist in the vector?
-    for( int kParameter = 0; kParameter < parameter_count; kParameter++){
-        // Is this the correct parameter?
-        if(this->names_.at(kParameter).compare(dlp::String::Trim(dlp::String::ToUpperCase(name))) == 0){
-            ret          = true;
-            if(ret_index) (*ret_index) = kParameter;
-        }
-    }
-    return ret;
+    if(!this->Find(name, &parameter_index)) return false;
+
+    if(ret_index) (*ret_index) = parameter_index;
+    return true;
 }
 
 /** @brief      Saves the list to a text file
@@ -240,6 +318,7 @@ ReturnCode Parameters::Save(const std::string &filename) const{
  *  @retval PARAMETERS_FILE_DOES_NOT_EXIST  Supplied file does NOT exist.
  *  @retval PARAMETERS_FILE_OPEN_FAILED     Failed to load file.
  *  @retval PARAMETERS_MISSING_VALUE        One or more entries in file did NOT contain a value and were NOT added to the list (only a warning)
+ *  @retval PARAMETERS_ILLEGAL_CHARACTER    One or more values in file contained an = character and were NOT added to the list (only a warning)
  */
 ReturnCode Parameters::Load(const std::string &filename){
     return (this->Load(filename,true));
@@ -251,6 +330,7 @@ ReturnCode Parameters::Load(const std::string &filename){
  *  @retval PARAMETERS_FILE_DOES_NOT_EXIST  Supplied file does NOT exist.
  *  @retval PARAMETERS_FILE_OPEN_FAILED     Failed to load file.
  *  @retval PARAMETERS_MISSING_VALUE        One or more entries in file did NOT contain a value and were NOT added to the list (only a warning)
+ *  @retval PARAMETERS_ILLEGAL_CHARACTER    One or more values in file contained an = character and were NOT added to the list (only a warning)
  */
 ReturnCode Parameters::Load(const std::string &filename, const bool &update_current){
     ReturnCode ret;
@@ -259,77 +339,83 @@ ReturnCode Parameters::Load(const std::string &filename, const bool &update_curr
     if(!dlp::File::Exists(filename))
         return ret.AddError(PARAMETERS_FILE_DOES_NOT_EXIST);
 
-
     // Open the file to read
-    std::string     line;
-	std::string		tempStr;
-    std::string     param_name;
-    std::string     param_value;
-    std::ifstream   param_file(filename.c_str());
+    std::ifstream param_file(filename.c_str(), std::ios::in | std::ios::binary);
 
     // Check that the file opened
     if(!param_file.is_open())
         return ret.AddError(PARAMETERS_FILE_OPEN_FAILED);
 
-	while ( true )
-    {
-		if (!std::getline (param_file,line,'\n')) {
-			break;
-		}
-		
-		if(!line.empty()) {
-		
-		tempStr = dlp::String::Trim(line);
-				   
-		// Check for comment character
-		if(!tempStr.empty() && (tempStr.at(0) != '#')){
-
-				// Find the = delimiter
-				std::size_t delimiter = line.find_first_of("=");
-
-				// Check that the delimiter exists
-				if(delimiter != std::string::npos){
-
-					// Copy the name
-					param_name = dlp::String::ToUpperCase(dlp::String::Trim(line.substr(0,delimiter-1)));
-
-					// Copy the value
-					param_value = dlp::String::Trim(line.substr(delimiter+1));
-
-					// Check that name and value are NOT empty
-					if((!param_name.empty())&&(!param_value.empty())){
-
-						// Should values be updated if already present?
-						if(update_current || !(this->Contains(param_name))){
-							// Add the parameter
-							this->Set(param_name,param_value);
-						}
-					}
-					else{
-						// Parameter is missing value
-						std::string error_string = PARAMETERS_MISSING_VALUE;
-						error_string += ": ";
-						error_string += param_name;
-						ret.AddWarning(error_string);
-					}
-				}
-				else{
-					// Parameter is missing value
-					std::string error_string = PARAMETERS_MISSING_VALUE;
-					error_string += ": ";
-					error_string += param_name;
-					ret.AddWarning(error_string);
-				}
-			}
-		}
-    }
-    
+    // Read the whole file at once and parse it in place
+    std::stringstream file_buffer;
+    file_buffer << param_file.rdbuf();
+
     if(param_file.bad())
-		return ret.AddError(PARAMETERS_FILE_PROCESSING_FAILED);
-	
-	param_file.close();
-	
-	return ret;
+        return ret.AddError(PARAMETERS_FILE_PROCESSING_FAILED);
+
+    param_file.close();
+
+    const std::string contents = file_buffer.str();
+    const char *position = contents.data();
+    const char *file_end = contents.data() + contents.size();
+
+    while(position < file_end){
+        // Find the end of the line
+        const char *line_end = position;
+        while((line_end < file_end) && (*line_end != '\n')) line_end++;
+
+        // Skip leading whitespace
+        const char *line_begin = position;
+        while((line_begin < line_end) && isTrimCharacter(*line_begin)) line_begin++;
+
+        position = line_end + 1;
+
+        // Skip empty lines and comments
+        if((line_begin == line_end) || (*line_begin == '#')) continue;
+
+        // Find the = delimiter
+        const char *delimiter = line_begin;
+        while((delimiter < line_end) && (*delimiter != '=')) delimiter++;
+
+        std::string param_name = NormalizeName(TrimRange(line_begin, delimiter));
+
+        // Check that the delimiter exists
+        if(delimiter == line_end){
+            // Parameter is missing value
+            std::string error_string = PARAMETERS_MISSING_VALUE;
+            error_string += ": ";
+            error_string += param_name;
+            ret.AddWarning(error_string);
+            continue;
+        }
+
+        std::string param_value = TrimRange(delimiter + 1, line_end);
+
+        // Check that name and value are NOT empty
+        if(param_name.empty() || param_value.empty()){
+            // Parameter is missing value
+            std::string error_string = PARAMETERS_MISSING_VALUE;
+            error_string += ": ";
+            error_string += param_name;
+            ret.AddWarning(error_string);
+            continue;
+        }
+
+        // Apply the same checks as Set() and report failures as warnings
+        ReturnCode entry_ret = CheckEntry(param_name, param_value);
+        if(entry_ret.hasErrors()){
+            std::vector<std::string> entry_errors = entry_ret.GetErrors();
+            for(unsigned int iError = 0; iError < entry_errors.size(); iError++){
+                ret.AddWarning(entry_errors.at(iError) + ": " + param_name);
+            }
+            continue;
+        }
+
+        // Add the parameter
+        this->Insert(param_name, param_value, update_current);
+    }
+
+    return ret;
 }
 
 /** @brief  Loads all entries from source into list
@@ -358,21 +444,9 @@ ReturnCode Parameters::Load(const Parameters &source, const bool &update_current
     // Return if any errors have occurred
     if(ret.hasErrors()) return ret;
 
-    std::string param_name;
-    std::string param_value;
-
+    // Source names and values are already normalized
     for(int kParam = 0; kParam < source_count; kParam++){
-        // Get the name of parameter to be updated
-        source.GetName(kParam, &param_name);
-
-        // Get the value of the parameter
-        source.Get(param_name, "default", &param_value);
-
-        // Should values be updated if already present?
-        if(update_current || !(this->Contains(param_name))){
-            // Add the parameter
-            this->Set(param_name,param_value);
-        }
+        this->Insert(source.names_.at(kParam), source.values_.at(kParam), update_current);
     }
 
     return ret;
@@ -393,6 +467,7 @@ unsigned int Parameters::GetCount() const{
 void Parameters::Clear(){
     this->names_.clear();
     this->values_.clear();
+    this->index_.clear();
     return;
 }
 
@@ -20,6 +20,9 @@
 #include <sstream>
 #include <fstream>
 #include <thread>
+#include <unordered_map>
+#include <algorithm>
+#include <cmath>
 
 /** @brief  Contains all DLP SDK classes, functions, etc. */
 namespace dlp{
@@ -49,6 +52,193 @@ Point::Point(const PointType &x_in, const Point::PointType &y_in, const PointTyp
 }
 
 
+/** @brief  Number of bits used per axis when packing voxel coordinates into a key */
+#define POINT_CLOUD_VOXEL_KEY_BITS  21
+#define POINT_CLOUD_VOXEL_KEY_MAX   ((1ull << POINT_CLOUD_VOXEL_KEY_BITS) - 1)
+
+/** @class  VoxelHash
+ *  @brief  Spatial hash of point indices used by the \ref dlp::Point::Cloud filters
+ *
+ *  Each point is assigned to a cubic voxel. The voxel coordinates are packed into
+ *  a 63-bit key and the point indices are grouped per voxel with a counting sort,
+ *  so building the hash and looking up a voxel are both linear/constant time.
+ */
+class VoxelHash{
+public:
+    /** @brief Builds the hash for the supplied points
+     *  @retval POINT_CLOUD_VOXEL_SIZE_INVALID      Voxel size is NOT greater than zero
+     *  @retval POINT_CLOUD_VOXEL_GRID_TOO_LARGE    Voxel size is too small for the extent of the cloud
+     */
+    ReturnCode Build(const std::vector<dlp::Point> &points, const double &voxel_size){
+        ReturnCode ret;
+
+        if(!(voxel_size > 0.0))
+            return ret.AddError(POINT_CLOUD_VOXEL_SIZE_INVALID);
+
+        this->size_ = voxel_size;
+        unsigned long long count = points.size();
+
+        // Find the cloud bounds with one partial result per thread
+        unsigned int threads = dlp::Thread::GetCount();
+        std::vector<dlp::Point> mins(threads, points.front());
+        std::vector<dlp::Point> maxs(threads, points.front());
+        unsigned long long chunk = (count + threads - 1) / threads;
+
+        dlp::Thread::ParallelFor(0, threads, [&](unsigned long long first, unsigned long long last){
+            for(unsigned long long iThread = first; iThread < last; iThread++){
+                unsigned long long begin = iThread * chunk;
+                unsigned long long end   = std::min(count, begin + chunk);
+                for(unsigned long long iPoint = begin; iPoint < end; iPoint++){
+                    const dlp::Point &point = points[iPoint];
+                    if(point.x < mins[iThread].x) mins[iThread].x = point.x;
+                    if(point.y < mins[iThread].y) mins[iThread].y = point.y;
+                    if(point.z < mins[iThread].z) mins[iThread].z = point.z;
+                    if(point.x > maxs[iThread].x) maxs[iThread].x = point.x;
+                    if(point.y > maxs[iThread].y) maxs[iThread].y = point.y;
+                    if(point.z > maxs[iThread].z) maxs[iThread].z = point.z;
+                }
+            }
+        });
+
+        dlp::Point min = mins.front();
+        dlp::Point max = maxs.front();
+        for(unsigned int iThread = 1; iThread < threads; iThread++){
+            min.x = std::min(min.x, mins[iThread].x);
+            min.y = std::min(min.y, mins[iThread].y);
+            min.z = std::min(min.z, mins[iThread].z);
+            max.x = std::max(max.x, maxs[iThread].x);
+            max.y = std::max(max.y, maxs[iThread].y);
+            max.z = std::max(max.z, maxs[iThread].z);
+        }
+        this->min_ = min;
+
+        // Check that the voxel coordinates fit in the key
+        if(((max.x - min.x) / voxel_size >= POINT_CLOUD_VOXEL_KEY_MAX) ||
+           ((max.y - min.y) / voxel_size >= POINT_CLOUD_VOXEL_KEY_MAX) ||
+           ((max.z - min.z) / voxel_size >= POINT_CLOUD_VOXEL_KEY_MAX))
+            return ret.AddError(POINT_CLOUD_VOXEL_GRID_TOO_LARGE);
+
+        // Calculate the voxel key of every point
+        std::vector<unsigned long long> keys(count);
+        dlp::Thread::ParallelFor(0, count, [&](unsigned long long first, unsigned long long last){
+            for(unsigned long long iPoint = first; iPoint < last; iPoint++){
+                keys[iPoint] = this->GetKey(points[iPoint]);
+            }
+        });
+
+        // Assign a voxel index to each key in order of first appearance
+        std::vector<unsigned long long> point_voxel(count);
+        this->lookup_.clear();
+        this->lookup_.reserve(count / 4 + 1);
+        this->keys_.clear();
+        for(unsigned long long iPoint = 0; iPoint < count; iPoint++){
+            auto inserted = this->lookup_.insert(std::make_pair(keys[iPoint], (unsigned long long) this->keys_.size()));
+            if(inserted.second) this->keys_.push_back(keys[iPoint]);
+            point_voxel[iPoint] = inserted.first->second;
+        }
+
+        // Group the point indices by voxel with a counting sort
+        this->start_.assign(this->keys_.size() + 1, 0);
+        for(unsigned long long iPoint = 0; iPoint < count; iPoint++){
+            this->start_[point_voxel[iPoint] + 1]++;
+        }
+        for(unsigned long long iVoxel = 0; iVoxel < this->keys_.size(); iVoxel++){
+            this->start_[iVoxel + 1] += this->start_[iVoxel];
+        }
+
+        std::vector<unsigned long long> fill(this->start_.begin(), this->start_.end() - 1);
+        this->indices_.resize(count);
+        for(unsigned long long iPoint = 0; iPoint < count; iPoint++){
+            this->indices_[fill[point_voxel[iPoint]]++] = iPoint;
+        }
+
+        return ret;
+    }
+
+    unsigned long long GetVoxelCount() const{
+        return this->keys_.size();
+    }
+
+    /** @brief Returns the range of point indices stored in the voxel */
+    void GetVoxelPoints(const unsigned long long &voxel,
+                        const unsigned long long **first,
+                        const unsigned long long **last) const{
+        (*first) = this->indices_.data() + this->start_[voxel];
+        (*last)  = this->indices_.data() + this->start_[voxel + 1];
+    }
+
+    /** @brief Calls function(point_index) for every point in the 3x3x3 voxel block around
+     *         the point until the function returns false
+     */
+    template <typename Function>
+    void ForEachNeighbor(const dlp::Point &point, Function function) const{
+        unsigned long long key = this->GetKey(point);
+        long long x = (long long) ( key        & POINT_CLOUD_VOXEL_KEY_MAX);
+        long long y = (long long) ((key >> POINT_CLOUD_VOXEL_KEY_BITS)     & POINT_CLOUD_VOXEL_KEY_MAX);
+        long long z = (long long) ((key >> (2*POINT_CLOUD_VOXEL_KEY_BITS)) & POINT_CLOUD_VOXEL_KEY_MAX);
+
+        // Visit the point's own voxel first, then the face, edge, and corner neighbors
+        for(unsigned int iOffset = 0; iOffset < 27; iOffset++){
+            long long dx = NEIGHBOR_OFFSETS[iOffset][0];
+            long long dy = NEIGHBOR_OFFSETS[iOffset][1];
+            long long dz = NEIGHBOR_OFFSETS[iOffset][2];
+
+            if((x + dx < 0) || (y + dy < 0) || (z + dz < 0)) continue;
+
+            auto found = this->lookup_.find(PackKey(x + dx, y + dy, z + dz));
+            if(found == this->lookup_.end()) continue;
+
+            const unsigned long long *first;
+            const unsigned long long *last;
+            this->GetVoxelPoints(found->second, &first, &last);
+            for(const unsigned long long *index = first; index != last; index++){
+                if(!function(*index)) return;
+            }
+        }
+    }
+
+    /** @brief Returns the center of the voxel */
+    dlp::Point GetVoxelCenter(const unsigned long long &voxel) const{
+        unsigned long long key = this->keys_[voxel];
+        return dlp::Point(this->min_.x + (( key        & POINT_CLOUD_VOXEL_KEY_MAX) + 0.5) * this->size_,
+                          this->min_.y + (((key >> POINT_CLOUD_VOXEL_KEY_BITS)     & POINT_CLOUD_VOXEL_KEY_MAX) + 0.5) * this->size_,
+                          this->min_.z + (((key >> (2*POINT_CLOUD_VOXEL_KEY_BITS)) & POINT_CLOUD_VOXEL_KEY_MAX) + 0.5) * this->size_);
+    }
+
+private:
+    static const int NEIGHBOR_OFFSETS[27][3];
+
+    static unsigned long long PackKey(const long long &x, const long long &y, const long long &z){
+        return  ((unsigned long long) x) |
+               (((unsigned long long) y) << POINT_CLOUD_VOXEL_KEY_BITS) |
+               (((unsigned long long) z) << (2*POINT_CLOUD_VOXEL_KEY_BITS));
+    }
+
+    unsigned long long GetKey(const dlp::Point &point) const{
+        return PackKey((long long) ((point.x - this->min_.x) / this->size_),
+                       (long long) ((point.y - this->min_.y) / this->size_),
+                       (long long) ((point.z - this->min_.z) / this->size_));
+    }
+
+    double      size_;
+    dlp::Point  min_;
+
+    std::unordered_map<unsigned long long, unsigned long long> lookup_;   // voxel key to voxel index
+    std::vector<unsigned long long> keys_;      // voxel index to voxel key
+    std::vector<unsigned long long> start_;     // voxel index to first entry in indices_
+    std::vector<unsigned long long> indices_;   // point indices grouped by voxel
+};
+
+const int VoxelHash::NEIGHBOR_OFFSETS[27][3] = {
+    { 0, 0, 0},
+    {-1, 0, 0}, { 1, 0, 0}, { 0,-1, 0}, { 0, 1, 0}, { 0, 0,-1}, { 0, 0, 1},
+    {-1,-1, 0}, { 1,-1, 0}, {-1, 1, 0}, { 1, 1, 0},
+    {-1, 0,-1}, { 1, 0,-1}, {-1, 0, 1}, { 1, 0, 1},
+    { 0,-1,-1}, { 0, 1,-1}, { 0,-1, 1}, { 0, 1, 1},
+    {-1,-1,-1}, { 1,-1,-1}, {-1, 1,-1}, { 1, 1,-1},
+    {-1,-1, 1}, { 1,-1, 1}, {-1, 1, 1}, { 1, 1, 1}
+};
+
 /** @brief  Constructs empty point cloud*/
 Point::Cloud::Cloud(){    
     this->Clear();
@@ -117,6 +307,353 @@ ReturnCode Point::Cloud::Remove(unsigned long long index){
     return ret;
 }
 
+/** @brief  Copies the points at the supplied indices into a new point cloud
+ *  @param[in]  indices     Point indices in this point cloud
+ *  @param[out] ret_cloud   Pointer to return \ref dlp::Point::Cloud
+ *  @retval POINT_CLOUD_NULL_POINTER_ARGUMENT   Return argument NULL
+ *  @retval POINT_CLOUD_INDEX_OUT_OF_RANGE      A requested point does NOT exist
+ */
+ReturnCode Point::Cloud::Extract(const std::vector<unsigned long long> &indices, Cloud *ret_cloud) const{
+    ReturnCode ret;
+
+    if(!ret_cloud)
+        return ret.AddError(POINT_CLOUD_NULL_POINTER_ARGUMENT);
+
+    std::vector<dlp::Point> extracted(indices.size());
+    for(unsigned long long iIndex = 0; iIndex < indices.size(); iIndex++){
+        if(indices[iIndex] >= this->points_.size())
+            return ret.AddError(POINT_CLOUD_INDEX_OUT_OF_RANGE);
+        extracted[iIndex] = this->points_[indices[iIndex]];
+    }
+
+    ret_cloud->points_.swap(extracted);
+
+    return ret;
+}
+
+/** @brief  Replaces all points within each voxel of a cubic grid with their centroid
+ *  @param[in]  voxel_size  Edge length of the voxels in point cloud units
+ *  @param[out] ret_cloud   Pointer to return downsampled \ref dlp::Point::Cloud
+ *  @retval POINT_CLOUD_EMPTY                   Point cloud has NO data
+ *  @retval POINT_CLOUD_NULL_POINTER_ARGUMENT   Return argument NULL
+ *  @retval POINT_CLOUD_VOXEL_SIZE_INVALID      Voxel size is NOT greater than zero
+ *  @retval POINT_CLOUD_VOXEL_GRID_TOO_LARGE    Voxel size is too small for the extent of the cloud
+ */
+ReturnCode Point::Cloud::DownsampleVoxelGrid(const double &voxel_size, Cloud *ret_cloud) const{
+    ReturnCode ret;
+
+    if(this->GetCount() == 0)
+        return ret.AddError(POINT_CLOUD_EMPTY);
+
+    if(!ret_cloud)
+        return ret.AddError(POINT_CLOUD_NULL_POINTER_ARGUMENT);
+
+    VoxelHash voxels;
+    ret = voxels.Build(this->points_, voxel_size);
+    if(ret.hasErrors()) return ret;
+
+    // Average the points of each voxel
+    std::vector<dlp::Point> downsampled(voxels.GetVoxelCount());
+    dlp::Thread::ParallelFor(0, voxels.GetVoxelCount(), [&](unsigned long long first, unsigned long long last){
+        for(unsigned long long iVoxel = first; iVoxel < last; iVoxel++){
+            const unsigned long long *begin;
+            const unsigned long long *end;
+            voxels.GetVoxelPoints(iVoxel, &begin, &end);
+
+            dlp::Point centroid;
+            for(const unsigned long long *index = begin; index != end; index++){
+                const dlp::Point &point = this->points_[*index];
+                centroid.x        += point.x;
+                centroid.y        += point.y;
+                centroid.z        += point.z;
+                centroid.distance += point.distance;
+            }
+
+            double count = (double) (end - begin);
+            centroid.x        /= count;
+            centroid.y        /= count;
+            centroid.z        /= count;
+            centroid.distance /= count;
+
+            downsampled[iVoxel] = centroid;
+        }
+    }, 1024);
+
+    ret_cloud->points_.swap(downsampled);
+
+    return ret;
+}
+
+/** @brief  Selects one point per voxel of a cubic grid, the point closest to the voxel center
+ *  @param[in]  voxel_size  Edge length of the voxels in point cloud units
+ *  @param[out] ret_indices Pointer to return the indices of the selected points in ascending order
+ *  @retval POINT_CLOUD_EMPTY                   Point cloud has NO data
+ *  @retval POINT_CLOUD_NULL_POINTER_ARGUMENT   Return argument NULL
+ *  @retval POINT_CLOUD_VOXEL_SIZE_INVALID      Voxel size is NOT greater than zero
+ *  @retval POINT_CLOUD_VOXEL_GRID_TOO_LARGE    Voxel size is too small for the extent of the cloud
+ */
+ReturnCode Point::Cloud::SubsampleUniform(const double &voxel_size, std::vector<unsigned long long> *ret_indices) const{
+    ReturnCode ret;
+
+    if(this->GetCount() == 0)
+        return ret.AddError(POINT_CLOUD_EMPTY);
+
+    if(!ret_indices)
+        return ret.AddError(POINT_CLOUD_NULL_POINTER_ARGUMENT);
+
+    VoxelHash voxels;
+    ret = voxels.Build(this->points_, voxel_size);
+    if(ret.hasErrors()) return ret;
+
+    std::vector<unsigned long long> selected(voxels.GetVoxelCount());
+    dlp::Thread::ParallelFor(0, voxels.GetVoxelCount(), [&](unsigned long long first, unsigned long long last){
+        for(unsigned long long iVoxel = first; iVoxel < last; iVoxel++){
+            const unsigned long long *begin;
+            const unsigned long long *end;
+            voxels.GetVoxelPoints(iVoxel, &begin, &end);
+
+            dlp::Point center = voxels.GetVoxelCenter(iVoxel);
+            double closest = std::numeric_limits<double>::max();
+            for(const unsigned long long *index = begin; index != end; index++){
+                const dlp::Point &point = this->points_[*index];
+                double dx = point.x - center.x;
+                double dy = point.y - center.y;
+                double dz = point.z - center.z;
+                double distance = dx*dx + dy*dy + dz*dz;
+                if(distance < closest){
+                    closest = distance;
+                    selected[iVoxel] = *index;
+                }
+            }
+        }
+    }, 1024);
+
+    // Keep the original point order
+    std::sort(selected.begin(), selected.end());
+    ret_indices->swap(selected);
+
+    return ret;
+}
+
+/** @brief  Selects one point per voxel of a cubic grid, the point closest to the voxel center
+ *  @param[in]  voxel_size  Edge length of the voxels in point cloud units
+ *  @param[out] ret_cloud   Pointer to return subsampled \ref dlp::Point::Cloud
+ */
+ReturnCode Point::Cloud::SubsampleUniform(const double &voxel_size, Cloud *ret_cloud) const{
+    ReturnCode ret;
+    std::vector<unsigned long long> indices;
+
+    if(!ret_cloud)
+        return ret.AddError(POINT_CLOUD_NULL_POINTER_ARGUMENT);
+
+    ret = this->SubsampleUniform(voxel_size, &indices);
+    if(ret.hasErrors()) return ret;
+
+    return this->Extract(indices, ret_cloud);
+}
+
+/** @brief  Selects the points that have at least min_neighbors other points within radius
+ *  @param[in]  radius          Search radius in point cloud units
+ *  @param[in]  min_neighbors   Minimum number of neighbors for a point to be kept
+ *  @param[out] ret_indices     Pointer to return the indices of the kept points in ascending order
+ *  @retval POINT_CLOUD_EMPTY                   Point cloud has NO data
+ *  @retval POINT_CLOUD_NULL_POINTER_ARGUMENT   Return argument NULL
+ *  @retval POINT_CLOUD_VOXEL_SIZE_INVALID      Radius is NOT greater than zero
+ *  @retval POINT_CLOUD_VOXEL_GRID_TOO_LARGE    Radius is too small for the extent of the cloud
+ */
+ReturnCode Point::Cloud::FilterRadiusOutliers(const double &radius, const unsigned int &min_neighbors,
+                                              std::vector<unsigned long long> *ret_indices) const{
+    ReturnCode ret;
+
+    if(this->GetCount() == 0)
+        return ret.AddError(POINT_CLOUD_EMPTY);
+
+    if(!ret_indices)
+        return ret.AddError(POINT_CLOUD_NULL_POINTER_ARGUMENT);
+
+    // Voxels the size of the radius guarantee all neighbors are in the adjacent voxels
+    VoxelHash voxels;
+    ret = voxels.Build(this->points_, radius);
+    if(ret.hasErrors()) return ret;
+
+    double radius_squared = radius * radius;
+    std::vector<unsigned char> keep(this->points_.size(), 0);
+
+    dlp::Thread::ParallelFor(0, this->points_.size(), [&](unsigned long long first, unsigned long long last){
+        for(unsigned long long iPoint = first; iPoint < last; iPoint++){
+            const dlp::Point &point = this->points_[iPoint];
+            unsigned int neighbors = 0;
+
+            voxels.ForEachNeighbor(point, [&](const unsigned long long &index){
+                if(index == iPoint) return true;
+
+                const dlp::Point &other = this->points_[index];
+                double dx = point.x - other.x;
+                double dy = point.y - other.y;
+                double dz = point.z - other.z;
+                if(dx*dx + dy*dy + dz*dz <= radius_squared) neighbors++;
+
+                // Stop searching once enough neighbors are found
+                return (neighbors < min_neighbors);
+            });
+
+            keep[iPoint] = (neighbors >= min_neighbors);
+        }
+    }, 1024);
+
+    ret_indices->clear();
+    for(unsigned long long iPoint = 0; iPoint < keep.size(); iPoint++){
+        if(keep[iPoint]) ret_indices->push_back(iPoint);
+    }
+
+    return ret;
+}
+
+/** @brief  Removes the points that have fewer than min_neighbors other points within radius
+ *  @param[in]  radius          Search radius in point cloud units
+ *  @param[in]  min_neighbors   Minimum number of neighbors for a point to be kept
+ *  @param[out] ret_cloud       Pointer to return filtered \ref dlp::Point::Cloud
+ */
+ReturnCode Point::Cloud::FilterRadiusOutliers(const double &radius, const unsigned int &min_neighbors,
+                                              Cloud *ret_cloud) const{
+    ReturnCode ret;
+    std::vector<unsigned long long> indices;
+
+    if(!ret_cloud)
+        return ret.AddError(POINT_CLOUD_NULL_POINTER_ARGUMENT);
+
+    ret = this->FilterRadiusOutliers(radius, min_neighbors, &indices);
+    if(ret.hasErrors()) return ret;
+
+    return this->Extract(indices, ret_cloud);
+}
+
+/** @brief  Selects the points whose mean distance to their nearest neighbors is
+ *          within std_dev_multiplier standard deviations of the cloud average
+ *
+ *  Neighbors are only searched within search_radius. Points without any neighbor
+ *  inside the search radius are always rejected.
+ *
+ *  @param[in]  neighbors           Number of nearest neighbors used for the mean distance
+ *  @param[in]  std_dev_multiplier  Number of standard deviations above the average that are kept
+ *  @param[in]  search_radius       Maximum neighbor distance in point cloud units
+ *  @param[out] ret_indices         Pointer to return the indices of the kept points in ascending order
+ *  @retval POINT_CLOUD_EMPTY                   Point cloud has NO data
+ *  @retval POINT_CLOUD_NULL_POINTER_ARGUMENT   Return argument NULL
+ *  @retval POINT_CLOUD_NEIGHBOR_COUNT_INVALID  Neighbor count is zero
+ *  @retval POINT_CLOUD_VOXEL_SIZE_INVALID      Search radius is NOT greater than zero
+ *  @retval POINT_CLOUD_VOXEL_GRID_TOO_LARGE    Search radius is too small for the extent of the cloud
+ */
+ReturnCode Point::Cloud::FilterStatisticalOutliers(const unsigned int &neighbors, const double &std_dev_multiplier,
+                                                   const double &search_radius,
+                                                   std::vector<unsigned long long> *ret_indices) const{
+    ReturnCode ret;
+
+    if(this->GetCount() == 0)
+        return ret.AddError(POINT_CLOUD_EMPTY);
+
+    if(!ret_indices)
+        return ret.AddError(POINT_CLOUD_NULL_POINTER_ARGUMENT);
+
+    if(neighbors == 0)
+        return ret.AddError(POINT_CLOUD_NEIGHBOR_COUNT_INVALID);
+
+    VoxelHash voxels;
+    ret = voxels.Build(this->points_, search_radius);
+    if(ret.hasErrors()) return ret;
+
+    double radius_squared = search_radius * search_radius;
+    std::vector<double> mean_distance(this->points_.size(), -1.0);
+
+    dlp::Thread::ParallelFor(0, this->points_.size(), [&](unsigned long long first, unsigned long long last){
+        std::vector<double> nearest;
+        nearest.reserve(neighbors + 1);
+
+        for(unsigned long long iPoint = first; iPoint < last; iPoint++){
+            const dlp::Point &point = this->points_[iPoint];
+            nearest.clear();
+
+            // Keep the squared distances of the closest neighbors in a max heap
+            voxels.ForEachNeighbor(point, [&](const unsigned long long &index){
+                if(index == iPoint) return true;
+
+                const dlp::Point &other = this->points_[index];
+                double dx = point.x - other.x;
+                double dy = point.y - other.y;
+                double dz = point.z - other.z;
+                double distance = dx*dx + dy*dy + dz*dz;
+                if(distance > radius_squared) return true;
+
+                if(nearest.size() < neighbors){
+                    nearest.push_back(distance);
+                    std::push_heap(nearest.begin(), nearest.end());
+                }
+                else if(distance < nearest.front()){
+                    std::pop_heap(nearest.begin(), nearest.end());
+                    nearest.back() = distance;
+                    std::push_heap(nearest.begin(), nearest.end());
+                }
+                return true;
+            });
+
+            if(nearest.size() > 0){
+                double sum = 0;
+                for(unsigned int iNeighbor = 0; iNeighbor < nearest.size(); iNeighbor++){
+                    sum += std::sqrt(nearest[iNeighbor]);
+                }
+                mean_distance[iPoint] = sum / nearest.size();
+            }
+        }
+    }, 1024);
+
+    // Calculate the average and standard deviation of the mean distances
+    double sum          = 0;
+    double sum_squared  = 0;
+    unsigned long long valid = 0;
+    for(unsigned long long iPoint = 0; iPoint < mean_distance.size(); iPoint++){
+        if(mean_distance[iPoint] < 0) continue;
+        sum         += mean_distance[iPoint];
+        sum_squared += mean_distance[iPoint] * mean_distance[iPoint];
+        valid++;
+    }
+
+    ret_indices->clear();
+    if(valid == 0) return ret;
+
+    double average   = sum / valid;
+    double variance  = (sum_squared / valid) - (average * average);
+    double threshold = average + std_dev_multiplier * std::sqrt(std::max(variance, 0.0));
+
+    for(unsigned long long iPoint = 0; iPoint < mean_distance.size(); iPoint++){
+        if((mean_distance[iPoint] >= 0) && (mean_distance[iPoint] <= threshold))
+            ret_indices->push_back(iPoint);
+    }
+
+    return ret;
+}
+
+/** @brief  Removes the points whose mean distance to their nearest neighbors is
+ *          more than std_dev_multiplier standard deviations above the cloud average
+ *  @param[in]  neighbors           Number of nearest neighbors used for the mean distance
+ *  @param[in]  std_dev_multiplier  Number of standard deviations above the average that are kept
+ *  @param[in]  search_radius       Maximum neighbor distance in point cloud units
+ *  @param[out] ret_cloud           Pointer to return filtered \ref dlp::Point::Cloud
+ */
+ReturnCode Point::Cloud::FilterStatisticalOutliers(const unsigned int &neighbors, const double &std_dev_multiplier,
+                                                   const double &search_radius,
+                                                   Cloud *ret_cloud) const{
+    ReturnCode ret;
+    std::vector<unsigned long long> indices;
+
+    if(!ret_cloud)
+        return ret.AddError(POINT_CLOUD_NULL_POINTER_ARGUMENT);
+
+    ret = this->FilterStatisticalOutliers(neighbors, std_dev_multiplier, search_radius, &indices);
+    if(ret.hasErrors()) return ret;
+
+    return this->Extract(indices, ret_cloud);
+}
+
 /** @brief  Saves point cloud data to a file and separates x, y,
  *          and z with the supplied delimiter
  *  @param[in] filename     Output file name
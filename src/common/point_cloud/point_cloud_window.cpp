@@ -19,6 +19,36 @@
 #include <fstream>
 #include <thread>
 #include <functional>
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+
+// OpenGL 1.5/2.0 tokens which are missing from the OpenGL 1.1 headers
+#ifndef GL_ARRAY_BUFFER
+#define GL_ARRAY_BUFFER         0x8892
+#endif
+#ifndef GL_STATIC_DRAW
+#define GL_STATIC_DRAW          0x88E4
+#endif
+#ifndef GL_FRAGMENT_SHADER
+#define GL_FRAGMENT_SHADER      0x8B30
+#endif
+#ifndef GL_VERTEX_SHADER
+#define GL_VERTEX_SHADER        0x8B31
+#endif
+#ifndef GL_COMPILE_STATUS
+#define GL_COMPILE_STATUS       0x8B81
+#endif
+#ifndef GL_LINK_STATUS
+#define GL_LINK_STATUS          0x8B82
+#endif
+
+/** @brief  Default number of points drawn per frame before the viewer falls
+ *          back to a coarser level-of-detail */
+#define POINT_CLOUD_WINDOW_POINT_BUDGET     2000000
+
+/** @brief  Bits per axis of the finest level-of-detail voxel grid */
+#define POINT_CLOUD_WINDOW_LOD_BITS         10
 
 /** @brief  Contains all DLP SDK classes, functions, etc. */
 namespace dlp{
@@ -37,16 +67,358 @@ static void key_callback(GLFWwindow* window, int key, int scancode, int action,
     mods++;
 }
 
+/** @brief  Vertex data prepared by \ref dlp::Point::Cloud::Window::Update and
+ *          handed to the render loop for upload
+ */
+struct Point::Cloud::Window::Buffer{
+    std::vector<GLfloat>            vertices;   // x, y, z of every point, centered, scaled, and ordered by level-of-detail
+    std::vector<unsigned long long> lod_counts; // Number of vertices drawn at each level-of-detail
+    std::vector<dlp::Point>         original;   // Unmodified points for saving
+    GLfloat z_min;                              // Depth range of the scaled points for the color map
+    GLfloat z_max;
+};
+
+/** @brief  OpenGL 1.5/2.0 entry points used by the viewer
+ *
+ *  These are loaded at runtime through GLFW, or the offscreen context, since
+ *  the platform OpenGL headers and libraries may only expose OpenGL 1.1.
+ */
+struct GL_Functions{
+    typedef void   (APIENTRY *GenBuffers)(GLsizei, GLuint*);
+    typedef void   (APIENTRY *DeleteBuffers)(GLsizei, const GLuint*);
+    typedef void   (APIENTRY *BindBuffer)(GLenum, GLuint);
+    typedef void   (APIENTRY *BufferData)(GLenum, std::ptrdiff_t, const void*, GLenum);
+    typedef GLuint (APIENTRY *CreateShader)(GLenum);
+    typedef void   (APIENTRY *DeleteShader)(GLuint);
+    typedef void   (APIENTRY *ShaderSource)(GLuint, GLsizei, const char* const*, const GLint*);
+    typedef void   (APIENTRY *CompileShader)(GLuint);
+    typedef void   (APIENTRY *GetShaderiv)(GLuint, GLenum, GLint*);
+    typedef void   (APIENTRY *GetShaderInfoLog)(GLuint, GLsizei, GLsizei*, char*);
+    typedef GLuint (APIENTRY *CreateProgram)(void);
+    typedef void   (APIENTRY *DeleteProgram)(GLuint);
+    typedef void   (APIENTRY *AttachShader)(GLuint, GLuint);
+    typedef void   (APIENTRY *LinkProgram)(GLuint);
+    typedef void   (APIENTRY *GetProgramiv)(GLuint, GLenum, GLint*);
+    typedef void   (APIENTRY *GetProgramInfoLog)(GLuint, GLsizei, GLsizei*, char*);
+    typedef void   (APIENTRY *UseProgram)(GLuint);
+    typedef GLint  (APIENTRY *GetUniformLocation)(GLuint, const char*);
+    typedef void   (APIENTRY *Uniform1f)(GLint, GLfloat);
+    typedef void   (APIENTRY *Uniform1i)(GLint, GLint);
+
+    GenBuffers          glGenBuffers;
+    DeleteBuffers       glDeleteBuffers;
+    BindBuffer          glBindBuffer;
+    BufferData          glBufferData;
+    CreateShader        glCreateShader;
+    DeleteShader        glDeleteShader;
+    ShaderSource        glShaderSource;
+    CompileShader       glCompileShader;
+    GetShaderiv         glGetShaderiv;
+    GetShaderInfoLog    glGetShaderInfoLog;
+    CreateProgram       glCreateProgram;
+    DeleteProgram       glDeleteProgram;
+    AttachShader        glAttachShader;
+    LinkProgram         glLinkProgram;
+    GetProgramiv        glGetProgramiv;
+    GetProgramInfoLog   glGetProgramInfoLog;
+    UseProgram          glUseProgram;
+    GetUniformLocation  glGetUniformLocation;
+    Uniform1f           glUniform1f;
+    Uniform1i           glUniform1i;
+
+    /** @brief  Loads the entry points from the current OpenGL context
+     *  @param[in]  get_proc_address    Returns the address of an OpenGL function
+     *  @retval true    All functions were found
+     *  @retval false   The context does NOT support vertex buffers and shaders
+     */
+    bool Load(const std::function<Point::Cloud::Window::Context::Function(const char*)> &get_proc_address){
+        this->glGenBuffers          = (GenBuffers)         get_proc_address("glGenBuffers");
+        this->glDeleteBuffers       = (DeleteBuffers)      get_proc_address("glDeleteBuffers");
+        this->glBindBuffer          = (BindBuffer)         get_proc_address("glBindBuffer");
+        this->glBufferData          = (BufferData)         get_proc_address("glBufferData");
+        this->glCreateShader        = (CreateShader)       get_proc_address("glCreateShader");
+        this->glDeleteShader        = (DeleteShader)       get_proc_address("glDeleteShader");
+        this->glShaderSource        = (ShaderSource)       get_proc_address("glShaderSource");
+        this->glCompileShader       = (CompileShader)      get_proc_address("glCompileShader");
+        this->glGetShaderiv         = (GetShaderiv)        get_proc_address("glGetShaderiv");
+        this->glGetShaderInfoLog    = (GetShaderInfoLog)   get_proc_address("glGetShaderInfoLog");
+        this->glCreateProgram       = (CreateProgram)      get_proc_address("glCreateProgram");
+        this->glDeleteProgram       = (DeleteProgram)      get_proc_address("glDeleteProgram");
+        this->glAttachShader        = (AttachShader)       get_proc_address("glAttachShader");
+        this->glLinkProgram         = (LinkProgram)        get_proc_address("glLinkProgram");
+        this->glGetProgramiv        = (GetProgramiv)       get_proc_address("glGetProgramiv");
+        this->glGetProgramInfoLog   = (GetProgramInfoLog)  get_proc_address("glGetProgramInfoLog");
+        this->glUseProgram          = (UseProgram)         get_proc_address("glUseProgram");
+        this->glGetUniformLocation  = (GetUniformLocation) get_proc_address("glGetUniformLocation");
+        this->glUniform1f           = (Uniform1f)          get_proc_address("glUniform1f");
+        this->glUniform1i           = (Uniform1i)          get_proc_address("glUniform1i");
+
+        return  this->glGenBuffers     && this->glDeleteBuffers   && this->glBindBuffer       &&
+                this->glBufferData     && this->glCreateShader    && this->glDeleteShader     &&
+                this->glShaderSource   && this->glCompileShader   && this->glGetShaderiv      &&
+                this->glGetShaderInfoLog && this->glCreateProgram && this->glDeleteProgram    &&
+                this->glAttachShader   && this->glLinkProgram     && this->glGetProgramiv     &&
+                this->glGetProgramInfoLog &&
+                this->glUseProgram     && this->glGetUniformLocation && this->glUniform1f     &&
+                this->glUniform1i;
+    }
+};
+
+/** @brief  Transforms the points and colors them by depth with the same
+ *          blue-cyan-green-yellow-red map the viewer used on the CPU.
+ *          GLSL 1.20 keeps it usable on legacy and software (Mesa llvmpipe)
+ *          contexts.
+ */
+static const char *point_vertex_shader =
+        "#version 120\n"
+        "uniform float z_min;\n"
+        "uniform float z_max;\n"
+        "uniform int   display_color;\n"
+        "varying vec3  color;\n"
+        "void main(){\n"
+        "    gl_Position = gl_ModelViewProjectionMatrix * gl_Vertex;\n"
+        "    color = vec3(1.0, 1.0, 1.0);\n"
+        "    if(display_color != 0){\n"
+        "        float depth = (z_max - gl_Vertex.z) / (z_max - z_min);\n"
+        "        if(depth < 0.25)      color = vec3(0.0, 4.0 * depth, 1.0);\n"
+        "        else if(depth < 0.5)  color = vec3(0.0, 1.0, 1.0 + 4.0 * (0.25 - depth));\n"
+        "        else if(depth < 0.75) color = vec3(4.0 * (depth - 0.5), 1.0, 0.0);\n"
+        "        else                  color = vec3(1.0, 1.0 + 4.0 * (0.75 - depth), 0.0);\n"
+        "        color = clamp(color, 0.0, 1.0);\n"
+        "    }\n"
+        "}\n";
+
+static const char *point_fragment_shader =
+        "#version 120\n"
+        "varying vec3 color;\n"
+        "void main(){\n"
+        "    gl_FragColor = vec4(color, 1.0);\n"
+        "}\n";
+
+/** @brief  Compiles and links the point shader program
+ *  @param[out] ret_log Returns the compiler or linker log if the program failed
+ *  @retval 0   Compiling or linking failed
+ */
+static GLuint CreatePointProgram(const GL_Functions &gl, std::string *ret_log){
+    const char *sources[2] = { point_vertex_shader, point_fragment_shader };
+    const char *names[2]   = { "vertex",            "fragment" };
+    GLenum      types[2]   = { GL_VERTEX_SHADER,    GL_FRAGMENT_SHADER };
+    GLuint      shaders[2] = { 0, 0 };
+    GLint       status     = 0;
+    char        log[512]   = "";
+
+    for(unsigned int iShader = 0; iShader < 2; iShader++){
+        shaders[iShader] = gl.glCreateShader(types[iShader]);
+        gl.glShaderSource(shaders[iShader], 1, &sources[iShader], NULL);
+        gl.glCompileShader(shaders[iShader]);
+        gl.glGetShaderiv(shaders[iShader], GL_COMPILE_STATUS, &status);
+
+        if(status != GL_TRUE){
+            gl.glGetShaderInfoLog(shaders[iShader], sizeof(log), NULL, log);
+            (*ret_log) = std::string(names[iShader]) + " shader compile failed: " + log;
+            for(unsigned int iDelete = 0; iDelete <= iShader; iDelete++) gl.glDeleteShader(shaders[iDelete]);
+            return 0;
+        }
+    }
+
+    GLuint program = gl.glCreateProgram();
+    gl.glAttachShader(program, shaders[0]);
+    gl.glAttachShader(program, shaders[1]);
+    gl.glLinkProgram(program);
+    gl.glGetProgramiv(program, GL_LINK_STATUS, &status);
+
+    // The program keeps the shaders alive while they are attached
+    gl.glDeleteShader(shaders[0]);
+    gl.glDeleteShader(shaders[1]);
+
+    if(status != GL_TRUE){
+        gl.glGetProgramInfoLog(program, sizeof(log), NULL, log);
+        (*ret_log) = std::string("shader program link failed: ") + log;
+        gl.glDeleteProgram(program);
+        return 0;
+    }
+
+    return program;
+}
+
+/** @brief  Returns the number of vertices to draw so that no more than
+ *          point_budget points are drawn while using the finest possible
+ *          level-of-detail. The coarsest level is always drawn.
+ */
+static unsigned long long GetDrawCount(const std::vector<unsigned long long> &lod_counts,
+                                       const unsigned long long &point_budget,
+                                       unsigned int *ret_level){
+    unsigned int level = 0;
+    for(unsigned int iLevel = 1; iLevel < lod_counts.size(); iLevel++){
+        if(lod_counts.at(iLevel) > point_budget) break;
+        level = iLevel;
+    }
+    if(ret_level) *ret_level = level;
+    return lod_counts.empty() ? 0 : lod_counts.at(level);
+}
+
+/** @brief  Centers and scales the points and orders them by level-of-detail
+ *
+ *  Clouds with no more than lod_min_points points keep their order and have a
+ *  single level. Larger clouds are sorted along a Z-order curve of a 2^10
+ *  voxel grid spanning the cloud. The first point of every voxel at grid level
+ *  k (2^k voxels per axis) is assigned to level k unless it already represents
+ *  a coarser voxel. Writing the points level by level means that drawing the
+ *  first lod_counts[k] vertices shows one point per occupied level k voxel.
+ */
+void Point::Cloud::Window::PrepareBuffer(const std::vector<dlp::Point> &points,
+                                         const unsigned long long &lod_min_points,
+                                         Buffer *buffer){
+    const unsigned long long count = points.size();
+
+    // Find the cloud bounds and sums with one partial result per thread
+    unsigned int threads = dlp::Thread::GetCount();
+    std::vector<dlp::Point> mins(threads, points.front());
+    std::vector<dlp::Point> maxs(threads, points.front());
+    std::vector<dlp::Point> sums(threads, dlp::Point());
+    unsigned long long chunk = (count + threads - 1) / threads;
+
+    dlp::Thread::ParallelFor(0, threads, [&](unsigned long long first, unsigned long long last){
+        for(unsigned long long iThread = first; iThread < last; iThread++){
+            unsigned long long begin = iThread * chunk;
+            unsigned long long end   = std::min(count, begin + chunk);
+            for(unsigned long long iPoint = begin; iPoint < end; iPoint++){
+                const dlp::Point &point = points[iPoint];
+                if(point.x < mins[iThread].x) mins[iThread].x = point.x;
+                if(point.y < mins[iThread].y) mins[iThread].y = point.y;
+                if(point.z < mins[iThread].z) mins[iThread].z = point.z;
+                if(point.x > maxs[iThread].x) maxs[iThread].x = point.x;
+                if(point.y > maxs[iThread].y) maxs[iThread].y = point.y;
+                if(point.z > maxs[iThread].z) maxs[iThread].z = point.z;
+                sums[iThread].x += point.x;
+                sums[iThread].y += point.y;
+                sums[iThread].z += point.z;
+            }
+        }
+    });
+
+    dlp::Point min = mins.front();
+    dlp::Point max = maxs.front();
+    dlp::Point ave = sums.front();
+    for(unsigned int iThread = 1; iThread < threads; iThread++){
+        min.x = std::min(min.x, mins[iThread].x);
+        min.y = std::min(min.y, mins[iThread].y);
+        min.z = std::min(min.z, mins[iThread].z);
+        max.x = std::max(max.x, maxs[iThread].x);
+        max.y = std::max(max.y, maxs[iThread].y);
+        max.z = std::max(max.z, maxs[iThread].z);
+        ave.x += sums[iThread].x;
+        ave.y += sums[iThread].y;
+        ave.z += sums[iThread].z;
+    }
+    ave.x = ave.x / count;
+    ave.y = ave.y / count;
+    ave.z = ave.z / count;
+
+    // The points are centered and divided by the maximum depth
+    double scale = (max.z != 0.0) ? max.z : 1.0;
+    buffer->z_min = (GLfloat)((min.z - ave.z) / scale);
+    buffer->z_max = (GLfloat)((max.z - ave.z) / scale);
+    if(!(buffer->z_max > buffer->z_min)) buffer->z_max = buffer->z_min + 1.0f;
+
+    buffer->vertices.resize(3 * count);
+    buffer->lod_counts.clear();
+
+    // Small clouds are drawn completely so they keep their original order
+    if(count <= lod_min_points){
+        dlp::Thread::ParallelFor(0, count, [&](unsigned long long first, unsigned long long last){
+            for(unsigned long long iPoint = first; iPoint < last; iPoint++){
+                buffer->vertices[3*iPoint + 0] = (GLfloat)((points[iPoint].x - ave.x) / scale);
+                buffer->vertices[3*iPoint + 1] = (GLfloat)((points[iPoint].y - ave.y) / scale);
+                buffer->vertices[3*iPoint + 2] = (GLfloat)((points[iPoint].z - ave.z) / scale);
+            }
+        }, 4096);
+        buffer->lod_counts.push_back(count);
+        return;
+    }
+
+    // Calculate the Z-order (Morton) code of every point on the finest grid
+    const unsigned int       bits  = POINT_CLOUD_WINDOW_LOD_BITS;
+    const unsigned long long cells = 1ull << bits;
+    double extent = std::max(max.x - min.x, std::max(max.y - min.y, max.z - min.z));
+    double to_cell = (extent > 0.0) ? ((cells - 1) / extent) : 0.0;
+
+    std::vector<std::pair<unsigned long long, unsigned long long>> codes(count);
+    dlp::Thread::ParallelFor(0, count, [&](unsigned long long first, unsigned long long last){
+        for(unsigned long long iPoint = first; iPoint < last; iPoint++){
+            unsigned long long cell[3] = { (unsigned long long)((points[iPoint].x - min.x) * to_cell),
+                                           (unsigned long long)((points[iPoint].y - min.y) * to_cell),
+                                           (unsigned long long)((points[iPoint].z - min.z) * to_cell) };
+            unsigned long long code = 0;
+            for(unsigned int iBit = 0; iBit < bits; iBit++){
+                for(unsigned int iAxis = 0; iAxis < 3; iAxis++){
+                    code |= ((cell[iAxis] >> iBit) & 1ull) << (3*iBit + (2 - iAxis));
+                }
+            }
+            codes[iPoint] = std::make_pair(code, iPoint);
+        }
+    }, 4096);
+
+    std::sort(codes.begin(), codes.end());
+
+    // Points sharing a level k voxel are adjacent after sorting, so the level
+    // of a point follows from the highest bit in which it differs from the
+    // previous point. Points in an already occupied finest voxel get bits + 1.
+    const unsigned int levels = bits + 2;
+    std::vector<unsigned char>      point_level(count);
+    std::vector<unsigned long long> level_start(levels + 1, 0);
+
+    for(unsigned long long iPoint = 0; iPoint < count; iPoint++){
+        unsigned int level = 0;
+        if(iPoint > 0){
+            unsigned long long difference = codes[iPoint].first ^ codes[iPoint-1].first;
+            if(difference == 0){
+                level = bits + 1;
+            }
+            else{
+                unsigned int high_bit = 0;
+                while(difference >>= 1) high_bit++;
+                level = bits - (high_bit / 3);
+            }
+        }
+        point_level[iPoint] = (unsigned char) level;
+        level_start[level + 1]++;
+    }
+
+    for(unsigned int iLevel = 0; iLevel < levels; iLevel++){
+        level_start[iLevel + 1] += level_start[iLevel];
+        buffer->lod_counts.push_back(level_start[iLevel + 1]);
+    }
+
+    // Write the vertices level by level
+    for(unsigned long long iPoint = 0; iPoint < count; iPoint++){
+        unsigned long long iVertex = level_start[point_level[iPoint]]++;
+        const dlp::Point &point = points[codes[iPoint].second];
+        buffer->vertices[3*iVertex + 0] = (GLfloat)((point.x - ave.x) / scale);
+        buffer->vertices[3*iVertex + 1] = (GLfloat)((point.y - ave.y) / scale);
+        buffer->vertices[3*iVertex + 2] = (GLfloat)((point.z - ave.z) / scale);
+    }
+}
+
 void Point::Cloud::Window::Loop(std::string title, bool fullscreen, unsigned int width, unsigned int height){
-    GLFWwindow *glfw_window;
+    GLFWwindow *glfw_window = NULL;
+
+    // Render into the supplied context instead of a GLFW window
+    const bool offscreen = (bool) this->context_.Create;
 
-    if (!dlp::GLFW_Library::Init()){
+    if(offscreen){
+        if(!this->context_.Create(width, height)){
+            this->is_open_ = false;
+            std::cout << "Point cloud viewer context failed..." << std::endl;
+            return;
+        }
+    }
+    else if (!dlp::GLFW_Library::Init()){
         this->is_open_ = false;
         std::cout << "GLFW Init failed..." << std::endl;
         return;
     }
-
-    if(fullscreen){
+    else if(fullscreen){
         // Get primary screen information
         GLFWmonitor*        primary_window      = glfwGetPrimaryMonitor();
         const GLFWvidmode*  primary_window_mode = glfwGetVideoMode( primary_window );
@@ -59,7 +431,7 @@ void Point::Cloud::Window::Loop(std::string title, bool fullscreen, unsigned int
     }
 
     // Check that the window opened successfully
-    if (!glfw_window){
+    if (!offscreen && !glfw_window){
         dlp::GLFW_Library::Terminate();
         this->is_open_ = false;
         std::cout << "GLFW Window failed..." << std::endl;
@@ -69,10 +441,40 @@ void Point::Cloud::Window::Loop(std::string title, bool fullscreen, unsigned int
     // Mark that window opened
     this->is_open_ = true;
 
-
     // Create the OpenGL contect and assign the key callback function
-    glfwMakeContextCurrent(glfw_window);
-    glfwSetKeyCallback(glfw_window, key_callback);
+    if(!offscreen){
+        glfwMakeContextCurrent(glfw_window);
+        glfwSetKeyCallback(glfw_window, key_callback);
+    }
+
+    // Load the vertex buffer and shader functions. Without them the points
+    // are drawn uncolored from client memory
+    GL_Functions gl;
+    bool   use_vbo       = offscreen ? gl.Load(this->context_.GetProcAddress) : gl.Load(glfwGetProcAddress);
+    GLuint point_program = 0;
+    GLuint point_vbo     = 0;
+    GLint  uniform_z_min = -1;
+    GLint  uniform_z_max = -1;
+    GLint  uniform_color = -1;
+
+    std::string shader_log = "OpenGL context does NOT support vertex buffers and shaders";
+    if(use_vbo) point_program = CreatePointProgram(gl, &shader_log);
+    if(point_program == 0){
+        use_vbo = false;
+        this->shaders_failed_ = true;
+        this->debug_.Msg("Point cloud " + shader_log);
+        this->debug_.Msg("Drawing without vertex buffers...");
+    }
+    else{
+        gl.glGenBuffers(1, &point_vbo);
+        uniform_z_min = gl.glGetUniformLocation(point_program, "z_min");
+        uniform_z_max = gl.glGetUniformLocation(point_program, "z_max");
+        uniform_color = gl.glGetUniformLocation(point_program, "display_color");
+    }
+
+    // Cloud currently displayed. Its vertices stay in system memory only when
+    // vertex buffers are unavailable
+    std::shared_ptr<Buffer> displayed;
 
     float window_ratio  = 0;
     int   window_width  = 0;
@@ -92,26 +494,62 @@ void Point::Cloud::Window::Loop(std::string title, bool fullscreen, unsigned int
     bool close_window = false;
     bool display_color = true;
     bool auto_rotate = true;
+    bool use_lod = true;
     float rotate_sign = 1.0;
 
-    // Create the OpenGL current
-    glfwMakeContextCurrent(glfw_window);
-    glfwSetKeyCallback(glfw_window, key_callback);
-
     glEnable(GL_DEPTH_TEST);
+    glEnableClientState(GL_VERTEX_ARRAY);
 
-    while(!glfwWindowShouldClose(glfw_window) || close_window){
+    std::chrono::steady_clock::time_point frame_start = std::chrono::steady_clock::now();
 
-        // Lock the atomic flag while updating the OpenGL context
-        while(this->lock_data_access_.test_and_set()) {}
+    while(!close_window && (offscreen || !glfwWindowShouldClose(glfw_window))){
 
         // Check if the window should close
-        if(this->close_window_.test_and_set()) glfwSetWindowShouldClose(glfw_window,GL_TRUE);
-        this->close_window_.clear();
+        if(this->close_window_){
+            if(offscreen) break;
+            glfwSetWindowShouldClose(glfw_window,GL_TRUE);
+        }
+
+        // Take the newest cloud if one was handed off. The lock only guards
+        // the pointer swap so Update() never waits for a frame to finish
+        std::shared_ptr<Buffer> pending;
+        if(this->buffer_mutex_.try_lock()){
+            pending.swap(this->buffer_pending_);
+            this->buffer_mutex_.unlock();
+        }
+
+        if(pending){
+            std::chrono::steady_clock::time_point upload_start = std::chrono::steady_clock::now();
+
+            if(use_vbo){
+                // Upload the vertices and release the system memory copy
+                gl.glBindBuffer(GL_ARRAY_BUFFER, point_vbo);
+                gl.glBufferData(GL_ARRAY_BUFFER,
+                                pending->vertices.size() * sizeof(GLfloat),
+                                pending->vertices.data(),
+                                GL_STATIC_DRAW);
+                gl.glBindBuffer(GL_ARRAY_BUFFER, 0);
+                std::vector<GLfloat>().swap(pending->vertices);
+            }
+
+            double upload_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - upload_start).count();
+
+            std::lock_guard<std::mutex> lock(this->statistics_mutex_);
+            this->statistics_.uploads++;
+            this->statistics_.upload_time_ms   = upload_ms;
+            this->statistics_.points_uploaded  = pending->lod_counts.back();
+            displayed = pending;
+        }
 
         // Get the screen buffer size so that the point cloud and adjust
         // the OpenGL viewpoints so the every is displayed properly
-        glfwGetFramebufferSize(glfw_window, &window_width, &window_height);
+        if(offscreen){
+            window_width  = width;
+            window_height = height;
+        }
+        else{
+            glfwGetFramebufferSize(glfw_window, &window_width, &window_height);
+        }
 
         // Calculate the aspect ratio
         window_ratio = float(window_width) / float(window_height);
@@ -121,80 +559,89 @@ void Point::Cloud::Window::Loop(std::string title, bool fullscreen, unsigned int
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
         glMatrixMode(GL_PROJECTION);
         glLoadIdentity();
-        glOrtho(-window_ratio, window_ratio,
-                -1.f,1.f,
-                 1000*(this->z_min-this->z_ave)/ this->z_max,
-                 1000*(this->z_max-this->z_ave)/ this->z_max);
+        if(displayed){
+            glOrtho(-window_ratio, window_ratio,
+                    -1.f,1.f,
+                     1000*displayed->z_min,
+                     1000*displayed->z_max);
+        }
         glMatrixMode(GL_MODELVIEW);
         glLoadIdentity();
 
-        // Get the mouse position in the screen
-        glfwGetCursorPos(glfw_window,&xpos,&ypos);
-
-        // If the left button is held down, adjust the rotation of the cloud
-        if(glfwGetMouseButton(glfw_window,GLFW_MOUSE_BUTTON_LEFT) &&
-                ((xpos != mouseX) || (ypos != mouseY)))
-        {
-            auto_rotate = false;
-            cameraAngleY -= (xpos - mouseX)*0.5;//*(1/scale);
-            cameraAngleX -= (ypos - mouseY)*0.5;//*(1/scale);
-
-            if(cameraAngleX > 360) cameraAngleX = 0;
-            if(cameraAngleY > 360) cameraAngleY = 0;
-            if(cameraAngleX < 0) cameraAngleX = 360;
-            if(cameraAngleY < 0) cameraAngleY = 360;
-        }   // If the right mouse button is held down, adjust the position of camera
-        else if(glfwGetMouseButton(glfw_window,GLFW_MOUSE_BUTTON_RIGHT) &&
-                ((xpos != mouseX) || (ypos != mouseY))) {
-            auto_rotate = false;
-            cameraMoveX += (xpos - mouseX)*(1/scale)/window_width*2;
-            cameraMoveY -= (ypos - mouseY)*(1/scale)/window_height*2;
-        }   // If the middle mouse button is held down, adjust the zoom of camera
-        else if(glfwGetMouseButton(glfw_window,GLFW_MOUSE_BUTTON_MIDDLE) &&
-                ((xpos != mouseX) || (ypos != mouseY))) {
-            auto_rotate = false;
-            scale -= (ypos - mouseY)*0.125;
-            if(scale < 0) scale = 0;
-        }
-        else if(glfwGetKey(glfw_window,GLFW_KEY_R)){
-            cameraAngleY = 180;
-            cameraAngleX = 20;
-            cameraAngleZ = 0;
-            scale = 4.0;
-        }
-        else if(glfwGetKey(glfw_window,GLFW_KEY_C)){
-            display_color = !display_color;
-            dlp::Time::Sleep::Milliseconds(250);
-        }
-        else if(glfwGetKey(glfw_window,GLFW_KEY_A)){
-            auto_rotate = !auto_rotate;
-            dlp::Time::Sleep::Milliseconds(250);
-        }
-        else if(glfwGetKey(glfw_window,GLFW_KEY_S)){
-            // Copy the point cloud data
-            dlp::Point::Cloud temp;
-            temp.points_ = this->points_xyz_original_; // Saves the original non-modified point cloud
-
-            // Start the thread to save the file
-            dlp::Time::Chronograph timer;
-            std::string file_time = dlp::Number::ToString(timer.Reset());
-            std::thread save_cloud(SavePointCloud,temp,"output/scan_data/" + file_time + "_point_cloud_viewer.xyz", ' ');
-            save_cloud.detach();
-
-            // Add delay to debounce key press
-            dlp::Time::Sleep::Milliseconds(250);
-        }
-        else if(glfwGetKey(glfw_window,GLFW_KEY_O)){
+        // Keyboard and mouse input is only available in a GLFW window
+        if(!offscreen){
+            // Get the mouse position in the screen
+            glfwGetCursorPos(glfw_window,&xpos,&ypos);
+
+            // If the left button is held down, adjust the rotation of the cloud
+            if(glfwGetMouseButton(glfw_window,GLFW_MOUSE_BUTTON_LEFT) &&
+                    ((xpos != mouseX) || (ypos != mouseY)))
+            {
+                auto_rotate = false;
+                cameraAngleY -= (xpos - mouseX)*0.5;//*(1/scale);
+                cameraAngleX -= (ypos - mouseY)*0.5;//*(1/scale);
+
+                if(cameraAngleX > 360) cameraAngleX = 0;
+                if(cameraAngleY > 360) cameraAngleY = 0;
+                if(cameraAngleX < 0) cameraAngleX = 360;
+                if(cameraAngleY < 0) cameraAngleY = 360;
+            }   // If the right mouse button is held down, adjust the position of camera
+            else if(glfwGetMouseButton(glfw_window,GLFW_MOUSE_BUTTON_RIGHT) &&
+                    ((xpos != mouseX) || (ypos != mouseY))) {
+                auto_rotate = false;
+                cameraMoveX += (xpos - mouseX)*(1/scale)/window_width*2;
+                cameraMoveY -= (ypos - mouseY)*(1/scale)/window_height*2;
+            }   // If the middle mouse button is held down, adjust the zoom of camera
+            else if(glfwGetMouseButton(glfw_window,GLFW_MOUSE_BUTTON_MIDDLE) &&
+                    ((xpos != mouseX) || (ypos != mouseY))) {
+                auto_rotate = false;
+                scale -= (ypos - mouseY)*0.125;
+                if(scale < 0) scale = 0;
+            }
+            else if(glfwGetKey(glfw_window,GLFW_KEY_R)){
+                cameraAngleY = 180;
+                cameraAngleX = 20;
+                cameraAngleZ = 0;
+                scale = 4.0;
+            }
+            else if(glfwGetKey(glfw_window,GLFW_KEY_C)){
+                display_color = !display_color;
+                dlp::Time::Sleep::Milliseconds(250);
+            }
+            else if(glfwGetKey(glfw_window,GLFW_KEY_A)){
+                auto_rotate = !auto_rotate;
+                dlp::Time::Sleep::Milliseconds(250);
+            }
+            else if(glfwGetKey(glfw_window,GLFW_KEY_L)){
+                use_lod = !use_lod;
+                dlp::Time::Sleep::Milliseconds(250);
+            }
+            else if(glfwGetKey(glfw_window,GLFW_KEY_S) && displayed){
+                // Copy the point cloud data
+                dlp::Point::Cloud temp;
+                temp.points_ = displayed->original; // Saves the original non-modified point cloud
+
+                // Start the thread to save the file
+                dlp::Time::Chronograph timer;
+                std::string file_time = dlp::Number::ToString(timer.Reset());
+                std::thread save_cloud(SavePointCloud,temp,"output/scan_data/" + file_time + "_point_cloud_viewer.xyz", ' ');
+                save_cloud.detach();
+
+                // Add delay to debounce key press
+                dlp::Time::Sleep::Milliseconds(250);
+            }
+            else if(glfwGetKey(glfw_window,GLFW_KEY_O)){
 
-            auto_rotate = false;
-            scale -= 0.1;
-            if(scale < 0) scale = 0;
-        }
-        else if(glfwGetKey(glfw_window,GLFW_KEY_I)){
+                auto_rotate = false;
+                scale -= 0.1;
+                if(scale < 0) scale = 0;
+            }
+            else if(glfwGetKey(glfw_window,GLFW_KEY_I)){
 
-            auto_rotate = false;
-            scale += 0.1;
-            if(scale < 0) scale = 0;
+                auto_rotate = false;
+                scale += 0.1;
+                if(scale < 0) scale = 0;
+            }
         }
 
         if(auto_rotate){
@@ -213,7 +660,7 @@ void Point::Cloud::Window::Loop(std::string title, bool fullscreen, unsigned int
         }
 
         // Check if the escape button has been clicked
-        if(glfwGetKey(glfw_window,GLFW_KEY_ESCAPE)) close_window = true;//glfwSetWindowShouldClose(glfw_window, GL_TRUE);
+        if(!offscreen && glfwGetKey(glfw_window,GLFW_KEY_ESCAPE)) close_window = true;//glfwSetWindowShouldClose(glfw_window, GL_TRUE);
 
         // Update the previous mouse position variables
         mouseX = xpos;
@@ -227,47 +674,78 @@ void Point::Cloud::Window::Loop(std::string title, bool fullscreen, unsigned int
         glRotatef( cameraAngleZ, 0.f, 0.f, 1.f);
         glPointSize(1.5);
 
-        // Add all points from the cloud to the OpenGL context
-        glBegin(GL_POINTS);
-        for(unsigned long long iPoint = 0; iPoint < this->points_xyz_.size(); iPoint++){
-
-            if(display_color){
-                glColor3f(  float(this->points_rgb_.at(iPoint).r)/255,
-                            float(this->points_rgb_.at(iPoint).g)/255,
-                            float(this->points_rgb_.at(iPoint).b)/255);
+        // Draw the finest level-of-detail which fits the point budget
+        unsigned long long draw_count = 0;
+        unsigned int       draw_level = 0;
+        if(displayed){
+            if(use_lod) draw_count = GetDrawCount(displayed->lod_counts, this->point_budget_, &draw_level);
+            else        draw_count = displayed->lod_counts.back();
+
+            if(use_vbo){
+                gl.glUseProgram(point_program);
+                gl.glUniform1f(uniform_z_min, displayed->z_min);
+                gl.glUniform1f(uniform_z_max, displayed->z_max);
+                gl.glUniform1i(uniform_color, display_color ? 1 : 0);
+                gl.glBindBuffer(GL_ARRAY_BUFFER, point_vbo);
+                glVertexPointer(3, GL_FLOAT, 0, NULL);
+                glDrawArrays(GL_POINTS, 0, (GLsizei) draw_count);
+                gl.glBindBuffer(GL_ARRAY_BUFFER, 0);
+                gl.glUseProgram(0);
             }
             else{
                 glColor3f(1.0,1.0,1.0);
+                glVertexPointer(3, GL_FLOAT, 0, displayed->vertices.data());
+                glDrawArrays(GL_POINTS, 0, (GLsizei) draw_count);
             }
-
-            glVertex3f( this->points_xyz_.at(iPoint).x,
-                        this->points_xyz_.at(iPoint).y,
-                        this->points_xyz_.at(iPoint).z);
         }
-        glEnd();
 
         // Update the window display
-        glfwSwapBuffers(glfw_window);
-        glfwPollEvents();
+        if(offscreen){
+            this->context_.SwapBuffers();
+        }
+        else{
+            glfwSwapBuffers(glfw_window);
+            glfwPollEvents();
+        }
+
+        // Record the time between frames
+        std::chrono::steady_clock::time_point frame_end = std::chrono::steady_clock::now();
+        double frame_ms = std::chrono::duration<double, std::milli>(frame_end - frame_start).count();
+        frame_start = frame_end;
+
+        std::lock_guard<std::mutex> lock(this->statistics_mutex_);
+        this->statistics_.frames++;
+        this->statistics_.frame_time_ms          = frame_ms;
+        this->statistics_.frame_time_total_ms   += frame_ms;
+        this->statistics_.points_drawn           = draw_count;
+        this->statistics_.lod_level              = draw_level;
+    }
 
-        // Clear the atomic flag so the data can be updated
-        this->lock_data_access_.clear();
+    glDisableClientState(GL_VERTEX_ARRAY);
+    if(use_vbo){
+        gl.glDeleteBuffers(1, &point_vbo);
+        gl.glDeleteProgram(point_program);
+    }
+
+    if(offscreen){
+        this->context_.Destroy();
+        this->is_open_ = false;
+        return;
     }
+
     glfwDestroyWindow(glfw_window);
     this->is_open_ = false;
 
-    // Clear the atomic flag so the data can be updated
-    this->lock_data_access_.clear();
-
     dlp::GLFW_Library::Terminate();
 }
 
 Point::Cloud::Window::Window(){
-    this->is_open_ = false;
-	this->close_window_.clear();
-	this->lock_data_access_.clear();
-    this->points_xyz_.clear();
-    this->points_rgb_.clear();
+    this->is_open_      = false;
+    this->close_window_ = false;
+    this->point_budget_ = POINT_CLOUD_WINDOW_POINT_BUDGET;
+    this->shaders_failed_ = false;
+    this->ResetStatistics();
+    this->debug_.SetName("POINT_CLOUD_WINDOW_DEBUG(" + dlp::Number::ToString(this)+ "): ");
 }
 
 Point::Cloud::Window::~Window(){
@@ -278,17 +756,20 @@ ReturnCode Point::Cloud::Window::Open(const std::string &title, const unsigned i
     ReturnCode ret;
 
     if(!this->isOpen()){
-        this->is_open_ = true;
+        // Release a loop which was closed with the escape key
+        if(this->loop_thread_.joinable()) this->loop_thread_.join();
+
+        this->is_open_        = true;
+        this->close_window_   = false;
+        this->shaders_failed_ = false;
 
         // If width or height equal 0 open fullscreen
         if((width == 0) || (height == 0)){
-            std::thread window_loop(&Point::Cloud::Window::Loop, this, title, true, 0 , 0);
-            window_loop.detach();
+            this->loop_thread_ = std::thread(&Point::Cloud::Window::Loop, this, title, true, 0 , 0);
         }
         else{
             // Open the window to a specific size
-            std::thread window_loop(&Point::Cloud::Window::Loop, this, title, false, width, height);
-            window_loop.detach();
+            this->loop_thread_ = std::thread(&Point::Cloud::Window::Loop, this, title, false, width, height);
         }
 
         // Wait 50ms and check that window opened
@@ -300,6 +781,17 @@ ReturnCode Point::Cloud::Window::Open(const std::string &title, const unsigned i
     return ret;
 }
 
+/** @brief  Prepares the point cloud for display and hands it to the window
+ *
+ *  The points are centered, scaled, and ordered by level-of-detail on the
+ *  calling thread. The render loop uploads the newest prepared cloud to a
+ *  vertex buffer at the start of its next frame, so this call never waits for
+ *  a frame to be drawn. Clouds replaced before they were uploaded are dropped.
+ *
+ *  @retval POINT_CLOUD_GLFW_WINDOW_FAILED      Window is NOT open
+ *  @retval POINT_CLOUD_EMPTY                   Point cloud has no points
+ *  @retval POINT_CLOUD_WINDOW_SHADERS_FAILED   The shader program failed and the points are drawn uncolored from system memory (only a warning)
+ */
 ReturnCode Point::Cloud::Window::Update(const dlp::Point::Cloud &cloud){
     ReturnCode ret;
 
@@ -311,105 +803,92 @@ ReturnCode Point::Cloud::Window::Update(const dlp::Point::Cloud &cloud){
     if(cloud.GetCount() == 0)
         return ret.AddError(POINT_CLOUD_EMPTY);
 
-    // Set the flag to copy the data
-    while(this->lock_data_access_.test_and_set()) {}
-
-    // Clear the old data
-    this->points_xyz_.clear();
-    this->points_rgb_.clear();
-
-    // Copy the data
-    this->points_xyz_original_ = cloud.points_;
-    this->points_xyz_          = cloud.points_;
-
-    // Grab the first point to start the min max calculations
-    this->x_min = this->points_xyz_.at(0).x;
-    this->x_max = this->points_xyz_.at(0).x;
-    this->y_min = this->points_xyz_.at(0).y;
-    this->y_max = this->points_xyz_.at(0).y;
-    this->z_min = this->points_xyz_.at(0).z;
-    this->z_max = this->points_xyz_.at(0).z;
-    this->x_ave = 0;
-    this->y_ave = 0;
-    this->z_ave = 0;
-
-    // Find the minimum, maximum, and average
-    for(unsigned long long iPoint = 0; iPoint < this->points_xyz_.size(); iPoint++){
-        if(this->points_xyz_.at(iPoint).x < this->x_min) this->x_min = this->points_xyz_.at(iPoint).x;
-        if(this->points_xyz_.at(iPoint).x > this->x_max) this->x_max = this->points_xyz_.at(iPoint).x;
-        if(this->points_xyz_.at(iPoint).y < this->y_min) this->y_min = this->points_xyz_.at(iPoint).y;
-        if(this->points_xyz_.at(iPoint).y > this->y_max) this->y_max = this->points_xyz_.at(iPoint).y;
-        if(this->points_xyz_.at(iPoint).z < this->z_min) this->z_min = this->points_xyz_.at(iPoint).z;
-        if(this->points_xyz_.at(iPoint).z > this->z_max) this->z_max = this->points_xyz_.at(iPoint).z;
-        this->x_ave += this->points_xyz_.at(iPoint).x;
-        this->y_ave += this->points_xyz_.at(iPoint).y;
-        this->z_ave += this->points_xyz_.at(iPoint).z;
-    }
-    this->x_ave = this->x_ave / this->points_xyz_.size();
-    this->y_ave = this->y_ave / this->points_xyz_.size();
-    this->z_ave = this->z_ave / this->points_xyz_.size();
-
-    // Create the point colors based on z-depth
-    for(unsigned long long iPoint = 0; iPoint < this->points_xyz_.size(); iPoint++){
-        float depth_temp = ((this->z_max - this->points_xyz_.at(iPoint).z) / (this->z_max - this->z_min));
-        float red   = 1.0;
-        float green = 1.0;
-        float blue  = 1.0;
-
-        if (depth_temp < (0.0 + 0.25 * 1.0)) {
-            red = 0;
-            green = 4 * (depth_temp - 0.0) / 1.0;
-        } else if (depth_temp < (0.0 + 0.5 * 1.0)) {
-            red = 0;
-            blue = 1 + 4 * (0.0 + 0.25 * 1.0 - depth_temp) / 1.0;
-        } else if (depth_temp < (0.0 + 0.75 * 1.0)) {
-            red = 4 * (depth_temp - 0.0 - 0.5 * 1.0) / 1.0;
-            blue = 0;
-        } else {
-            green = 1 + 4 * (0.0 + 0.75 * 1.0 - depth_temp) / 1.0;
-            blue = 0;
-        }
-        this->points_rgb_.push_back(dlp::PixelRGB((unsigned char)(255*red),
-                                                  (unsigned char)(255*green),
-                                                  (unsigned char)(255*blue)));
-
-        // Center and scale the cloud points
-        this->points_xyz_.at(iPoint).x = (this->points_xyz_.at(iPoint).x - this->x_ave)/ this->z_max;
-        this->points_xyz_.at(iPoint).y = (this->points_xyz_.at(iPoint).y - this->y_ave)/ this->z_max;
-        this->points_xyz_.at(iPoint).z = (this->points_xyz_.at(iPoint).z - this->z_ave)/ this->z_max;
-    }
+    // Prepare the vertices without holding any lock
+    std::shared_ptr<Buffer> buffer = std::make_shared<Buffer>();
+    buffer->original = cloud.points_;
+    PrepareBuffer(buffer->original, this->point_budget_, buffer.get());
 
-    this->lock_data_access_.clear();
+    // Hand off the new cloud
+    std::lock_guard<std::mutex> lock(this->buffer_mutex_);
+    this->buffer_pending_ = buffer;
+
+    if(this->shaders_failed_) ret.AddWarning(POINT_CLOUD_WINDOW_SHADERS_FAILED);
 
     return ret;
 }
 
-bool Point::Cloud::Window::isOpen(){
-    return this->is_open_;
+/** @brief      Enables debug messages of the render loop, e.g. the shader compiler log
+ *  \note       Call before \ref Open()
+ */
+void Point::Cloud::Window::SetDebugEnable(const bool &enable){
+    this->debug_.SetEnable(enable);
 }
 
-void Point::Cloud::Window::Close(){
-    if(this->isOpen()){
-        // Tell window to close
-        while(this->close_window_.test_and_set()){}
-
-        // Wait for window loop to finish processing
-        while(this->lock_data_access_.test_and_set()){}
+/** @brief      Sets the stream for debug messages of the render loop
+ *  \note       Call before \ref Open()
+ */
+void Point::Cloud::Window::SetDebugOutput(std::ostream* output){
+    this->debug_.SetOutput(output);
+}
 
-        // Clear all window data
-        this->is_open_ = false;
-        this->points_xyz_.clear();
-        this->points_rgb_.clear();
-        this->lock_data_access_.clear();
-    }
+/** @brief  Sets the maximum number of points drawn per frame
+ *  @param[in]  points  Clouds larger than this are drawn at the finest
+ *                      level-of-detail that fits. Applies to the current
+ *                      cloud immediately; clouds updated later use it to
+ *                      decide whether a level-of-detail ordering is built.
+ */
+void Point::Cloud::Window::SetPointBudget(const unsigned long long &points){
+    this->point_budget_ = (points > 0) ? points : 1;
 }
 
+/** @brief  Renders into another OpenGL context instead of a GLFW window
+ *  @param[in]  context     Functions which create, swap, and release the
+ *                          context, e.g. an offscreen EGL pbuffer. If
+ *                          Context::Create is empty a GLFW window is used.
+ *                          All other members are required when it is set.
+ *  \note       Ignored while the window is open. The context is used by the
+ *              next call to \ref Open().
+ */
+void Point::Cloud::Window::SetContext(const Context &context){
+    if(this->isOpen()) return;
+    this->context_ = context;
+}
 
+/** @brief  Returns the frame and upload counters of the render loop */
+Point::Cloud::Window::Statistics Point::Cloud::Window::GetStatistics(){
+    std::lock_guard<std::mutex> lock(this->statistics_mutex_);
+    return this->statistics_;
+}
 
+/** @brief  Clears the frame and upload counters */
+void Point::Cloud::Window::ResetStatistics(){
+    std::lock_guard<std::mutex> lock(this->statistics_mutex_);
+    this->statistics_.frames              = 0;
+    this->statistics_.frame_time_ms       = 0;
+    this->statistics_.frame_time_total_ms = 0;
+    this->statistics_.uploads             = 0;
+    this->statistics_.upload_time_ms      = 0;
+    this->statistics_.points_uploaded     = 0;
+    this->statistics_.points_drawn        = 0;
+    this->statistics_.lod_level           = 0;
+}
 
+bool Point::Cloud::Window::isOpen(){
+    return this->is_open_;
 }
 
+void Point::Cloud::Window::Close(){
+    // Tell window to close and wait for window loop to finish processing
+    this->close_window_ = true;
+    if(this->loop_thread_.joinable()) this->loop_thread_.join();
+
+    // Clear all window data
+    this->is_open_ = false;
+    std::lock_guard<std::mutex> lock(this->buffer_mutex_);
+    this->buffer_pending_.reset();
+}
 
 
 
 
+}
@@ -0,0 +1,207 @@
+/** @file       region_of_interest.cpp
+ *  @ingroup    Common
+ *  @brief      Contains methods for \ref dlp::RegionOfInterest
+ *  @copyright  2016 Texas Instruments Incorporated - http://www.ti.com/ ALL RIGHTS RESERVED
+ */
+
+#include <common/returncode.hpp>
+#include <common/image/image.hpp>
+#include <common/disparity_map.hpp>
+#include <common/region_of_interest.hpp>
+
+#include <algorithm>
+
+/** @brief  Contains all DLP SDK classes, functions, etc. */
+namespace dlp{
+
+/** @brief  Constructs an empty object which selects the whole frame */
+RegionOfInterest::RegionOfInterest(){
+    this->Clear();
+}
+
+/** @brief  Constructs an object which selects a rectangle
+ *  @param[in]  x       First column of the rectangle
+ *  @param[in]  y       First row of the rectangle
+ *  @param[in]  columns Width of the rectangle
+ *  @param[in]  rows    Height of the rectangle
+ */
+RegionOfInterest::RegionOfInterest(const unsigned int &x, const unsigned int &y,
+                                   const unsigned int &columns, const unsigned int &rows){
+    this->Clear();
+    this->SetRectangle(x, y, columns, rows);
+}
+
+/** @brief  Removes the rectangle and mask so the whole frame is selected */
+void RegionOfInterest::Clear(){
+    this->rectangle_set_ = false;
+    this->rectangle_     = cv::Rect();
+    this->mask_.release();
+    this->mask_bounds_   = cv::Rect();
+}
+
+/** @brief  Returns true if neither a rectangle nor a mask is set */
+bool RegionOfInterest::isEmpty() const{
+    return (!this->rectangle_set_ && this->mask_.empty());
+}
+
+/** @brief  Selects a rectangle of the frame
+ *  @param[in]  x       First column of the rectangle
+ *  @param[in]  y       First row of the rectangle
+ *  @param[in]  columns Width of the rectangle
+ *  @param[in]  rows    Height of the rectangle
+ *  @retval REGION_OF_INTEREST_SIZE_INVALID The rectangle has no area
+ */
+ReturnCode RegionOfInterest::SetRectangle(const unsigned int &x, const unsigned int &y,
+                                          const unsigned int &columns, const unsigned int &rows){
+    ReturnCode ret;
+
+    if((columns == 0) || (rows == 0))
+        return ret.AddError(REGION_OF_INTEREST_SIZE_INVALID);
+
+    this->rectangle_     = cv::Rect(x, y, columns, rows);
+    this->rectangle_set_ = true;
+
+    return ret;
+}
+
+/** @brief  Selects the nonzero pixels of a full frame image
+ *  @param[in]  mask    Image with the camera resolution, color images are converted to monochrome
+ *  @retval REGION_OF_INTEREST_MASK_EMPTY   The mask is empty or has no pixels set
+ */
+ReturnCode RegionOfInterest::SetMask(const dlp::Image &mask){
+    ReturnCode ret;
+
+    if(mask.isEmpty())
+        return ret.AddError(REGION_OF_INTEREST_MASK_EMPTY);
+
+    dlp::Image mask_mono;
+    ret = mask_mono.Create(mask);
+    if(ret.hasErrors())
+        return ret;
+
+    mask_mono.ConvertToMonochrome();
+
+    cv::Mat mask_data;
+    mask_mono.Unsafe_GetOpenCVData(&mask_data);
+
+    cv::Mat mask_binary;
+    cv::compare(mask_data, 0, mask_binary, cv::CMP_NE);
+
+    return this->SetMaskData(mask_binary);
+}
+
+/** @brief  Selects the pixels which were decoded in a previous scan
+ *  @param[in]  previous_scan   Full frame \ref dlp::DisparityMap
+ *  @retval REGION_OF_INTEREST_MASK_EMPTY   The map is empty or has no valid pixels
+ */
+ReturnCode RegionOfInterest::SetMask(dlp::DisparityMap &previous_scan){
+    ReturnCode ret;
+
+    if(previous_scan.isEmpty())
+        return ret.AddError(REGION_OF_INTEREST_MASK_EMPTY);
+
+    cv::Mat disparity_data;
+    previous_scan.Unsafe_GetOpenCVData(&disparity_data);
+
+    cv::Mat mask_binary(disparity_data.rows, disparity_data.cols, CV_8UC1);
+
+    for(int yRow = 0; yRow < disparity_data.rows; yRow++){
+        const int     *pixel_disparity = disparity_data.ptr<int>(yRow);
+        unsigned char *pixel_mask      = mask_binary.ptr<unsigned char>(yRow);
+
+        for(int xCol = 0; xCol < disparity_data.cols; xCol++){
+            bool valid = (pixel_disparity[xCol] != dlp::DisparityMap::INVALID_PIXEL) &&
+                         (pixel_disparity[xCol] != dlp::DisparityMap::EMPTY_PIXEL);
+            pixel_mask[xCol] = valid ? 255 : 0;
+        }
+    }
+
+    return this->SetMaskData(mask_binary);
+}
+
+/** @brief  Stores a binary mask and finds the bounding box of its set pixels */
+ReturnCode RegionOfInterest::SetMaskData(const cv::Mat &mask){
+    ReturnCode ret;
+
+    int column_min = mask.cols;
+    int column_max = -1;
+    int row_min    = mask.rows;
+    int row_max    = -1;
+
+    for(int yRow = 0; yRow < mask.rows; yRow++){
+        const unsigned char *pixel_mask = mask.ptr<unsigned char>(yRow);
+
+        for(int xCol = 0; xCol < mask.cols; xCol++){
+            if(pixel_mask[xCol] == 0) continue;
+
+            column_min = std::min(column_min, xCol);
+            column_max = std::max(column_max, xCol);
+            row_min    = std::min(row_min, yRow);
+            row_max    = yRow;
+        }
+    }
+
+    if(column_max < 0)
+        return ret.AddError(REGION_OF_INTEREST_MASK_EMPTY);
+
+    this->mask_        = mask;
+    this->mask_bounds_ = cv::Rect(column_min, row_min, column_max - column_min + 1, row_max - row_min + 1);
+
+    return ret;
+}
+
+/** @brief  Returns the bounding box of the selected pixels in a frame
+ *  @param[in]  image_columns   Width of the frame
+ *  @param[in]  image_rows      Height of the frame
+ *  @param[out] bounds          Return pointer for the bounding box, the whole frame if the object is empty
+ *  @retval REGION_OF_INTEREST_NULL_POINTER_ARGUMENT    Return argument is NULL
+ *  @retval REGION_OF_INTEREST_MASK_RESOLUTION_INVALID  The mask resolution does NOT match the frame
+ *  @retval REGION_OF_INTEREST_OUTSIDE_FRAME            No selected pixels are within the frame
+ */
+ReturnCode RegionOfInterest::GetBounds(const unsigned int &image_columns,
+                                       const unsigned int &image_rows,
+                                       cv::Rect *bounds) const{
+    ReturnCode ret;
+
+    if(!bounds)
+        return ret.AddError(REGION_OF_INTEREST_NULL_POINTER_ARGUMENT);
+
+    *bounds = cv::Rect(0, 0, image_columns, image_rows);
+
+    if(this->rectangle_set_)
+        *bounds = *bounds & this->rectangle_;
+
+    if(!this->mask_.empty()){
+        if(((unsigned int) this->mask_.cols != image_columns) ||
+           ((unsigned int) this->mask_.rows != image_rows))
+            return ret.AddError(REGION_OF_INTEREST_MASK_RESOLUTION_INVALID);
+
+        *bounds = *bounds & this->mask_bounds_;
+    }
+
+    if(bounds->area() == 0)
+        return ret.AddError(REGION_OF_INTEREST_OUTSIDE_FRAME);
+
+    return ret;
+}
+
+/** @brief  Returns the mask pixels within a bounding box without copying them
+ *  @param[in]  bounds  Bounding box from \ref GetBounds()
+ *  @param[out] mask    Return pointer for the CV_8UC1 mask, empty if every pixel in the bounds is selected
+ *  @retval REGION_OF_INTEREST_NULL_POINTER_ARGUMENT    Return argument is NULL
+ */
+ReturnCode RegionOfInterest::GetMask(const cv::Rect &bounds, cv::Mat *mask) const{
+    ReturnCode ret;
+
+    if(!mask)
+        return ret.AddError(REGION_OF_INTEREST_NULL_POINTER_ARGUMENT);
+
+    if(this->mask_.empty())
+        mask->release();
+    else
+        *mask = this->mask_(bounds);
+
+    return ret;
+}
+
+}
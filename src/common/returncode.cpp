@@ -286,7 +286,7 @@ std::string ReturnCode::ToString() const{
 
     if(warnings > 0){
         for(unsigned int iWarning = 0; iWarning < warnings; iWarning++){
-            ret += "\nWARNING: " + this->errors_.at(iWarning);
+            ret += "\nWARNING: " + this->warnings_.at(iWarning);
         }
     }
 
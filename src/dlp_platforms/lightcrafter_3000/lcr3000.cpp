@@ -511,76 +511,32 @@ ReturnCode LCr3000::StartPatternSequence(const unsigned int &start, const unsign
     if((patterns*sequence_bitdepth)>96)
         return ret.AddError(PATTERN_SEQUENCE_TOO_LONG);
 
-    std::vector<std::string> image_names;
-
     if((start    != this->previous_sequence_start_)    ||
        (patterns != this->previous_sequence_patterns_) ||
        (repeat   != this->previous_sequence_repeat_)){
 
-    ImageBuffer image_buffer;
-    image_buffer.Clear();
+    // Check that LCr3000 is connected
+    if(!this->isConnected())
+        return ret.AddError(LCR3000_NOT_CONNECTED);
 
     unsigned int columns = 0;
     unsigned int rows = 0;
-    unsigned int images = 0;
 
     this->GetColumns(&columns);
     this->GetRows(&rows);
 
-
-    for(unsigned int iPattern = 0; iPattern < patterns; iPattern++){
-        dlp::Pattern temp;
-
-        ret = sequence.Get(iPattern,&temp);
-        if(ret.hasErrors()) return ret;
-
-        if(iPattern % 8 == 0) images++;
-
-        for(unsigned int xCol = 0; xCol < columns; xCol++){
-            for(unsigned int yRow = 0; yRow < rows; yRow++){
-
-                // Grab the pixel value
-                unsigned char value;
-                temp.image_data.Unsafe_GetPixel(xCol,yRow, &value);
-
-                if((sequence_bitdepth == 5) || (sequence_bitdepth == 7)){
-                    image_buffer.Add(xCol,
-                                     yRow,
-                                     iPattern*(sequence_bitdepth+1),
-                                     (sequence_bitdepth+1),
-                                     value << 1);
-                }
-                else{
-                    image_buffer.Add(xCol,
-                                     yRow,
-                                     iPattern*sequence_bitdepth,
-                                     sequence_bitdepth,
-                                     value);
-
-                }
-            }
-        }
-    }
-
-
-    // Save all 12 8-bit images
-    image_buffer.SaveImages("lcr3000_sequence_images_", image_names);
-
-    // Check that LCr3000 is connected
-    if(!this->isConnected())
-        return ret.AddError(LCR3000_NOT_CONNECTED);
-
     // Set the mode to pattern sequence
     ret = this->LCR_CMD_SetDisplayMode(dlp::LCr3000::DISP_MODE_PTN_SEQ);
     if(ret.hasErrors()) return ret;
 
     // Setup the sequence for 12 8-bit patterns to upload the image data
+    const unsigned int upload_images = 12;
 
     // Setup the sequence settings
     dlp::LCr3000::LCR_PatternSeqSetting_t sequence_settings;
 
         sequence_settings.BitDepth = 8;
-        sequence_settings.NumPatterns = image_names.size();
+        sequence_settings.NumPatterns = upload_images;
         sequence_settings.PatternType = dlp::LCr3000::PTN_TYPE_NORMAL;
         sequence_settings.InputTriggerType = dlp::LCr3000::TRIGGER_TYPE_AUTO;   // These settings are temporary
         sequence_settings.InputTriggerDelay = 0;                                // These settings are temporary
@@ -592,15 +548,28 @@ ReturnCode LCr3000::StartPatternSequence(const unsigned int &start, const unsign
         ret = this->LCR_CMD_SetPatternSeqSetting(&sequence_settings);
         if(ret.hasErrors()) return ret;
 
-        // Upload the BMP files
-        if(patterns > 1){
-            //for(unsigned int iBMP = 0;iBMP < images;iBMP++){
-            for(unsigned int iBMP = 0;iBMP < image_names.size();iBMP++){
-                this->LCR_CMD_DefinePatternBMP(iBMP,image_names.at(iBMP).c_str());
+        // Encode each 8-bit image in memory while the previous image is sent
+        {
+            PatternUploader uploader(this->io_service, this->LCR_PKT_Socket);
+
+            std::vector<unsigned char> bmp;
+            unsigned int images = (patterns > 1) ? upload_images : 1;
+
+            for(unsigned int iBMP = 0; iBMP < images; iBMP++){
+                ret = LCr3000::EncodePatternImageBMP(sequence, iBMP, columns, rows, &bmp);
+                if(ret.hasErrors()){
+                    uploader.Finish();
+                    return ret;
+                }
+
+                uploader.Queue(iBMP, bmp);
             }
-        }
-        else{
-            this->LCR_CMD_DefinePatternBMP(0,image_names.at(0).c_str());
+
+            ret = uploader.Finish();
+            if(ret.hasErrors()) return ret;
+
+            this->debug_.Msg("Uploaded " + dlp::Number::ToString(images) + " images with " +
+                             dlp::Number::ToString(uploader.GetBytesSent()) + " bytes");
         }
 
 
@@ -1146,6 +1115,25 @@ ReturnCode LCr3000::LCR_CMD_DefinePatternBMP(LCR_PatternCount_t PatternNum, char
     return ret;
 }
 
+ReturnCode LCr3000::LCR_CMD_DefinePatternBMP(LCR_PatternCount_t PatternNum, const std::vector<unsigned char> &bmp){
+    ReturnCode ret;
+    /* Generate packet from a BMP held in memory */
+    LCR_CMD_PKT_CommandInit(LCR_CMD_PKT_TYPE_WRITE, 0x0401);
+    LCR_CMD_PKT_PutInt((int)PatternNum, 1);
+
+    if(LCR_CMD_PKT_PutBuffer(bmp)){
+        ret.AddError(LCR3000_SEND_COMMAND_FAILED);
+        return ret;
+    }
+
+    if(LCR_CMD_PKT_SendCommand()){
+        ret.AddError(LCR3000_SEND_COMMAND_FAILED);
+        return ret;
+    }
+
+    return ret;
+}
+
 ReturnCode LCr3000::LCR_CMD_ReadPattern(LCR_PatternCount_t PatternNum, char *fileName){
     ReturnCode ret;
 
@@ -1515,6 +1503,13 @@ int LCr3000::LCR_CMD_PKT_PutFile(char const *fileName){
     return error;
 }
 
+int LCr3000::LCR_CMD_PKT_PutBuffer(const std::vector<unsigned char> &buffer){
+    if(buffer.empty())
+        return 0;
+
+    return LCR_CMD_PKT_PutData((uint8_t*) buffer.data(), buffer.size());
+}
+
 int LCr3000::LCR_CMD_PKT_GetFile(char const *fileName,uint32_t size){
     FILE *fp;
     int ret = 0;
@@ -0,0 +1,409 @@
+/** \file       lcr3000_upload.cpp
+ *  @brief      Contains methods to encode and upload pattern images to the DLP LightCrafter 3000
+ *  \copyright  2016 Texas Instruments Incorporated - http://www.ti.com/ ALL RIGHTS RESERVED
+ */
+
+#define ASIO_STANDALONE
+#include <string>
+#include <vector>
+#include <cstring>
+#include <asio.hpp>
+
+#include <common/returncode.hpp>
+#include <common/image/image.hpp>
+#include <common/pattern/pattern.hpp>
+#include "dlp_platforms/lightcrafter_3000/lcr3000.hpp"
+#include "dlp_platforms/lightcrafter_3000/lcr3000_definitions.hpp"
+
+namespace dlp{
+
+/** @brief  Command ID of LCr3000::LCR_CMD_DefinePatternBMP() */
+static const uint16_t LCR3000_DEFINE_PATTERN_COMMAND = 0x0401;
+
+/** @brief  Size of the BMP file and info headers */
+static const unsigned int BMP_HEADER_SIZE  = 54;
+
+/** @brief  Size of the 256 entry grayscale BMP palette */
+static const unsigned int BMP_PALETTE_SIZE = 256 * 4;
+
+/** @brief  Writes a little endian value into a byte buffer */
+static void PutLittleEndian(unsigned char *buffer, const unsigned int &value, const unsigned int &size){
+    for(unsigned int iByte = 0; iByte < size; iByte++){
+        buffer[iByte] = (value >> (8*iByte)) & 0xFF;
+    }
+}
+
+/** @brief      Encodes one of the twelve 8-bit images uploaded for a pattern sequence as an in-memory BMP
+ *
+ *  The LightCrafter 3000 stores 96 bitplanes as twelve 8-bit images.
+ *  Pattern N uses the bitplanes starting at N times its bit depth, with
+ *  5 and 7 bit patterns stored as 6 and 8 bit values. Only the patterns
+ *  which overlap the requested image are read, so images can be encoded
+ *  one at a time while previous images are uploaded.
+ *
+ *  The BMP is an uncompressed 8-bit grayscale bitmap identical to the
+ *  file written by \ref dlp::Image::Save().
+ *
+ * @param[in]   sequence        Image data patterns with equal bit depths
+ * @param[in]   image_index     8-bit image to encode (0-11)
+ * @param[in]   columns         Image width in pixels
+ * @param[in]   rows            Image height in pixels
+ * @param[out]  bmp             Pointer to return the BMP file contents
+ *
+ * @retval  LCR3000_NULL_PTR                    Return argument is NULL
+ * @retval  LCR3000_IMAGE_INDEX_INVALID         The image index is greater than 11
+ * @retval  PATTERN_BITDEPTH_INVALID            A pattern is NOT monochrome
+ * @retval  PATTERN_SEQUENCE_TOO_LONG           The patterns need more than 96 bitplanes
+ * @retval  LCR3000_IMAGE_RESOLUTION_INVALID    A pattern image is NOT columns x rows
+ * @retval  LCR3000_IMAGE_FORMAT_INVALID        A pattern image could NOT be converted to monochrome
+ */
+ReturnCode LCr3000::EncodePatternImageBMP(const dlp::Pattern::Sequence &sequence,
+                                          const unsigned int           &image_index,
+                                          const unsigned int           &columns,
+                                          const unsigned int           &rows,
+                                          std::vector<unsigned char>   *bmp){
+    ReturnCode ret;
+
+    const unsigned int total_bitplanes = 96;
+    const unsigned int image_bitplanes = 8;
+
+    if(!bmp)
+        return ret.AddError(LCR3000_NULL_PTR);
+
+    if(image_index >= (total_bitplanes / image_bitplanes))
+        return ret.AddError(LCR3000_IMAGE_INDEX_INVALID);
+
+    // Rows are padded to a multiple of 4 bytes
+    const unsigned int row_stride  = (columns + 3) & ~3;
+    const unsigned int data_offset = BMP_HEADER_SIZE + BMP_PALETTE_SIZE;
+    const unsigned int data_size   = row_stride * rows;
+
+    bmp->assign(data_offset + data_size, 0);
+    unsigned char *header = bmp->data();
+
+    // File header
+    header[0] = 'B';
+    header[1] = 'M';
+    PutLittleEndian(&header[2],  data_offset + data_size, 4);
+    PutLittleEndian(&header[10], data_offset, 4);
+
+    // Info header, a positive height stores the rows bottom-up
+    PutLittleEndian(&header[14], 40, 4);
+    PutLittleEndian(&header[18], columns, 4);
+    PutLittleEndian(&header[22], rows, 4);
+    PutLittleEndian(&header[26], 1, 2);
+    PutLittleEndian(&header[28], 8, 2);
+    PutLittleEndian(&header[34], data_size, 4);
+    PutLittleEndian(&header[46], 256, 4);
+
+    // Grayscale palette
+    for(unsigned int iColor = 0; iColor < 256; iColor++){
+        header[BMP_HEADER_SIZE + 4*iColor + 0] = iColor;
+        header[BMP_HEADER_SIZE + 4*iColor + 1] = iColor;
+        header[BMP_HEADER_SIZE + 4*iColor + 2] = iColor;
+    }
+
+    unsigned char *pixels = bmp->data() + data_offset;
+
+    const int image_first_bitplane = image_index * image_bitplanes;
+
+    for(unsigned int iPattern = 0; iPattern < sequence.GetCount(); iPattern++){
+        dlp::Pattern pattern;
+        sequence.Get(iPattern, &pattern);
+
+        // 5 and 7 bit patterns are stored as 6 and 8 bit values
+        unsigned int bitdepth = LCr3000::ConvertDlpPatternBitdepthToLCr3000Bitdetph(pattern.bitdepth);
+        if(bitdepth == 0)
+            return ret.AddError(PATTERN_BITDEPTH_INVALID);
+
+        unsigned int value_shift      = 0;
+        unsigned int storage_bitdepth = bitdepth;
+        if((bitdepth == 5) || (bitdepth == 7)){
+            value_shift      = 1;
+            storage_bitdepth = bitdepth + 1;
+        }
+
+        int pattern_first_bitplane = iPattern * storage_bitdepth;
+        if((pattern_first_bitplane + storage_bitdepth) > total_bitplanes)
+            return ret.AddError(PATTERN_SEQUENCE_TOO_LONG);
+
+        // Skip patterns which are NOT stored in this image
+        if((pattern_first_bitplane >= (int)(image_first_bitplane + image_bitplanes)) ||
+           ((pattern_first_bitplane + (int)storage_bitdepth) <= image_first_bitplane))
+            continue;
+
+        // Check the pattern image
+        unsigned int image_columns = 0;
+        unsigned int image_rows    = 0;
+        pattern.image_data.GetColumns(&image_columns);
+        pattern.image_data.GetRows(&image_rows);
+        if((image_columns != columns) || (image_rows != rows))
+            return ret.AddError(LCR3000_IMAGE_RESOLUTION_INVALID);
+
+        dlp::Image::Format image_format;
+        pattern.image_data.GetDataFormat(&image_format);
+        if(image_format != dlp::Image::Format::MONO_UCHAR){
+            // Convert a copy so the prepared sequence is NOT modified
+            dlp::Image mono_image;
+            mono_image.Create(pattern.image_data);
+            mono_image.ConvertToMonochrome();
+            pattern.image_data = mono_image;
+
+            pattern.image_data.GetDataFormat(&image_format);
+            if(image_format != dlp::Image::Format::MONO_UCHAR)
+                return ret.AddError(LCR3000_IMAGE_FORMAT_INVALID);
+        }
+
+        cv::Mat pattern_data;
+        pattern.image_data.Unsafe_GetOpenCVData(&pattern_data);
+
+        const unsigned int value_mask = (1 << storage_bitdepth) - 1;
+        const int          shift      = pattern_first_bitplane - image_first_bitplane;
+
+        for(unsigned int yRow = 0; yRow < rows; yRow++){
+            const unsigned char *pattern_row = pattern_data.ptr<unsigned char>(yRow);
+            unsigned char       *bmp_row     = pixels + row_stride * (rows - 1 - yRow);
+
+            for(unsigned int xCol = 0; xCol < columns; xCol++){
+                unsigned int value = (((unsigned int) pattern_row[xCol]) << value_shift) & value_mask;
+
+                if(shift >= 0) bmp_row[xCol] |= (value <<  shift) & 0xFF;
+                else           bmp_row[xCol] |= (value >> -shift) & 0xFF;
+            }
+        }
+    }
+
+    return ret;
+}
+
+/** @brief      Starts the asio thread used to send images
+ * @param[in]   io_service  Service which owns the socket
+ * @param[in]   socket      Connected LightCrafter 3000 socket
+ */
+LCr3000::PatternUploader::PatternUploader(asio::io_service &io_service, asio::ip::tcp::socket *socket)
+    : io_service_(io_service){
+    this->socket_             = socket;
+    this->command_sent_       = 0;
+    this->command_continued_  = false;
+    this->sending_            = false;
+    this->failed_             = false;
+    this->commands_queued_    = 0;
+    this->commands_completed_ = 0;
+    this->bytes_sent_         = 0;
+
+    // Keep the service running until Finish() is called
+    this->io_service_.reset();
+    this->work_.reset(new asio::io_service::work(this->io_service_));
+    this->thread_ = std::thread([this](){ this->io_service_.run(); });
+}
+
+/** @brief  Waits for the queued images and stops the asio thread */
+LCr3000::PatternUploader::~PatternUploader(){
+    this->Finish();
+}
+
+/** @brief      Queues a BMP image to be stored as a pattern image
+ *
+ *  Returns immediately, the image is sent after the previously queued images.
+ *
+ * @param[in]   pattern_number  Pattern image number sent with \ref LCr3000::LCR_CMD_DefinePatternBMP()
+ * @param[in]   bmp             BMP file contents
+ */
+void LCr3000::PatternUploader::Queue(const LCR_PatternCount_t &pattern_number, const std::vector<unsigned char> &bmp){
+    std::shared_ptr<std::vector<unsigned char>> payload = std::make_shared<std::vector<unsigned char>>();
+
+    payload->reserve(bmp.size() + 1);
+    payload->push_back(pattern_number & 0xFF);
+    payload->insert(payload->end(), bmp.begin(), bmp.end());
+
+    {
+        std::lock_guard<std::mutex> lock(this->mutex_);
+        this->commands_queued_++;
+    }
+
+    this->io_service_.post([this, payload](){
+        // Images queued after a failure are dropped
+        if(this->failed_) return;
+
+        this->commands_.push_back(payload);
+        if(!this->sending_) this->SendNextCommand();
+    });
+}
+
+/** @brief      Waits until all queued images have been sent or an upload fails
+ * @retval      LCR3000_IMAGE_UPLOAD_FAILED     An image could NOT be sent or was rejected by the LightCrafter 3000
+ */
+ReturnCode LCr3000::PatternUploader::Finish(){
+    ReturnCode ret;
+
+    if(!this->thread_.joinable())
+        return ret;
+
+    std::string error;
+    {
+        std::unique_lock<std::mutex> lock(this->mutex_);
+        this->finished_.wait(lock, [this](){
+            return (!this->error_.empty()) || (this->commands_completed_ == this->commands_queued_);
+        });
+        error = this->error_;
+    }
+
+    // The service returns once no operations are pending
+    this->work_.reset();
+    this->thread_.join();
+
+    if(!error.empty())
+        ret.AddError(LCR3000_IMAGE_UPLOAD_FAILED);
+
+    return ret;
+}
+
+/** @brief  Returns the number of packet bytes written to the socket */
+unsigned long long LCr3000::PatternUploader::GetBytesSent() const{
+    return this->bytes_sent_;
+}
+
+/** @brief  Starts sending the next queued command */
+void LCr3000::PatternUploader::SendNextCommand(){
+    if(this->commands_.empty()){
+        this->sending_ = false;
+        return;
+    }
+
+    this->command_ = this->commands_.front();
+    this->commands_.pop_front();
+
+    this->command_sent_      = 0;
+    this->command_continued_ = false;
+    this->sending_           = true;
+
+    this->SendNextPacket();
+}
+
+/** @brief  Sends the next packet of the current command
+ *
+ *  Uses the same header, continuation flags, and checksum as
+ *  LCr3000::LCR_CMD_PKT_SendPacket().
+ */
+void LCr3000::PatternUploader::SendNextPacket(){
+    unsigned long remaining = this->command_->size() - this->command_sent_;
+    unsigned long length    = remaining;
+    if(length > MAX_PACKET_SIZE) length = MAX_PACKET_SIZE;
+
+    bool more = remaining > length;
+
+    uint8_t flag = 0;
+    if(this->command_continued_) flag = more ? 2 : 3;
+    else                         flag = more ? 1 : 0;
+
+    this->packet_.resize(HEADER_SIZE + length + CHECKSUM_SIZE);
+    this->packet_[0] = PKT_TYPE_WRITE;
+    this->packet_[1] = (LCR3000_DEFINE_PATTERN_COMMAND >> 8) & 0xFF;
+    this->packet_[2] = (LCR3000_DEFINE_PATTERN_COMMAND)      & 0xFF;
+    this->packet_[3] = flag;
+    this->packet_[4] = length & 0xFF;
+    this->packet_[5] = (length >> 8) & 0xFF;
+
+    std::memcpy(&this->packet_[HEADER_SIZE], this->command_->data() + this->command_sent_, length);
+
+    unsigned int sum = 0;
+    for(unsigned long iByte = 0; iByte < HEADER_SIZE + length; iByte++)
+        sum += this->packet_[iByte];
+    this->packet_[HEADER_SIZE + length] = sum & 0xFF;
+
+    this->command_sent_     += length;
+    this->command_continued_ = true;
+
+    asio::async_write(*this->socket_, asio::buffer(this->packet_),
+                      [this](const asio::error_code &error, std::size_t bytes){
+        if(error){
+            this->Fail("Packet write failed: " + error.message());
+            return;
+        }
+
+        this->bytes_sent_ += bytes;
+        this->ReceiveResponseHeader();
+    });
+}
+
+/** @brief  Reads the header of the response to the last packet */
+void LCr3000::PatternUploader::ReceiveResponseHeader(){
+    this->response_.resize(HEADER_SIZE);
+
+    asio::async_read(*this->socket_, asio::buffer(this->response_),
+                     [this](const asio::error_code &error, std::size_t){
+        if(error){
+            this->Fail("Response header read failed: " + error.message());
+            return;
+        }
+
+        this->ReceiveResponseData();
+    });
+}
+
+/** @brief  Reads and checks the response data and checksum, then sends the next packet */
+void LCr3000::PatternUploader::ReceiveResponseData(){
+    unsigned int length = this->response_[4] | (this->response_[5] << 8);
+
+    this->response_.resize(HEADER_SIZE + length + CHECKSUM_SIZE);
+
+    asio::async_read(*this->socket_, asio::buffer(&this->response_[HEADER_SIZE], length + CHECKSUM_SIZE),
+                     [this, length](const asio::error_code &error, std::size_t){
+        if(error){
+            this->Fail("Response data read failed: " + error.message());
+            return;
+        }
+
+        unsigned int sum = 0;
+        for(unsigned int iByte = 0; iByte < HEADER_SIZE + length; iByte++)
+            sum += this->response_[iByte];
+
+        if(this->response_[HEADER_SIZE + length] != (sum & 0xFF)){
+            this->Fail("Response checksum invalid");
+            return;
+        }
+
+        // Busy and error responses reject the packet
+        if(this->response_[0] != PKT_TYPE_WRITE_RESP){
+            this->Fail("Packet rejected with response type " + dlp::Number::ToString((int)this->response_[0]));
+            return;
+        }
+
+        // Each response must be a complete packet
+        if((this->response_[3] != 0) && (this->response_[3] != 1)){
+            this->Fail("Response flag invalid");
+            return;
+        }
+
+        if(this->command_sent_ < this->command_->size()){
+            this->SendNextPacket();
+            return;
+        }
+
+        // The command is complete
+        this->command_.reset();
+        {
+            std::lock_guard<std::mutex> lock(this->mutex_);
+            this->commands_completed_++;
+        }
+        this->finished_.notify_all();
+
+        this->SendNextCommand();
+    });
+}
+
+/** @brief  Stops sending and reports the error to Finish() */
+void LCr3000::PatternUploader::Fail(const std::string &error){
+    this->failed_ = true;
+    this->commands_.clear();
+    this->command_.reset();
+    this->sending_ = false;
+
+    {
+        std::lock_guard<std::mutex> lock(this->mutex_);
+        if(this->error_.empty()) this->error_ = error;
+    }
+    this->finished_.notify_all();
+}
+
+}
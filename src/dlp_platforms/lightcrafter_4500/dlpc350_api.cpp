@@ -45,9 +45,20 @@
 #include <dlp_platforms/lightcrafter_4500/common.hpp>
 #include <dlp_platforms/lightcrafter_4500/dlpc350_api.hpp>
 #include <dlp_platforms/lightcrafter_4500/dlpc350_usb.hpp>
+#include <dlp_platforms/lightcrafter_4500/dlpc350_channel.hpp>
 
-extern unsigned char g_OutputBuffer[];
-extern unsigned char g_InputBuffer[];
+#include <vector>
+
+/* Device state is kept in the DLPC350_Context selected for the calling thread */
+#define g_OutputBuffer  (DLPC350_GetContext()->OutputBuffer)
+#define g_InputBuffer   (DLPC350_GetContext()->InputBuffer)
+#define g_SeqNum        (DLPC350_GetContext()->SeqNum)
+#define g_PatLut        (DLPC350_GetContext()->PatLut)
+#define g_PatLutIndex   (DLPC350_GetContext()->PatLutIndex)
+#define g_ExpLut        (DLPC350_GetContext()->ExpLut)
+#define g_ExpLutIndex   (DLPC350_GetContext()->ExpLutIndex)
+#define g_Channel       (DLPC350_GetContext()->Channel)
+#define g_PipelineDepth (DLPC350_GetContext()->PipelineDepth)
 
 CmdFormat CmdList[255] =
 {
@@ -134,14 +145,7 @@ CmdFormat CmdList[255] =
     {   0x00,  0x30,  0x01   }     //BL_PROG_MODE,
 };
 
-static unsigned char g_SeqNum=0;
-static unsigned long int g_PatLut[MAX_PAT_LUT_ENTRIES] = {0};
-static unsigned int g_PatLutIndex = 0;
-static unsigned long int g_ExpLut[MAX_VAR_EXP_PAT_LUT_ENTRIES*3] = {0};
-static unsigned int g_ExpLutIndex = 0;
-
 /* Local functions */
-static int DLPC350_Write(bool ackRequired);
 static int DLPC350_Read();
 static int DLPC350_ContinueRead();
 static int DLPC350_SendMsg(hidMessageStruct *pMsg, bool ackRequired);
@@ -151,32 +155,55 @@ static int DLPC350_PrepMemReadCmd(unsigned int addr);
 static int DLPC350_PrepWriteCmd(hidMessageStruct *pMsg, DLPC350_CMD cmd);
 
 
-static int DLPC350_Write(bool ackRequired)
+int DLPC350_BeginCommandPipeline(void)
+/**
+ * Until the matching DLPC350_EndCommandPipeline() call, commands which require an ACK are sent
+ * without waiting for it. The ACKs are collected in the background of later commands and any
+ * failure is reported by DLPC350_EndCommandPipeline(). Calls may be nested.
+ * Failures of commands sent before the outermost call were already returned by those
+ * commands and are NOT reported again.
+ *
+ * @return  0 = PASS
+ *
+ */
 {
-    int ret_val;
-    hidMessageStruct *pMsg;
+    // Blocking commands also record their failures in the channel status
+    if(g_PipelineDepth == 0)
+        g_Channel.Flush();
 
-    if(ackRequired)
-    {
-        pMsg = (hidMessageStruct *)g_InputBuffer;
-        if((ret_val = DLPC350_USB_Write()) > 0)
-        {
-            //Check for ACK or NACK response
-            if(DLPC350_USB_Read() > 0)
-            {
-                if(pMsg->head.flags.nack == 1)
-                    return -2;
-                else
-                    return ret_val;
-            }
-        }
-    }
-    else
-    {
-       ret_val = DLPC350_USB_Write();
-    }
+    g_PipelineDepth++;
+    return 0;
+}
 
-    return ret_val;
+int DLPC350_EndCommandPipeline(void)
+/**
+ * Waits for the ACK of every command sent since DLPC350_BeginCommandPipeline().
+ *
+ * @return  0 = PASS
+ *          -1 = a command could not be sent or was not acknowledged
+ *          -2 = nack from target
+ *
+ */
+{
+    if(g_PipelineDepth > 0)
+        g_PipelineDepth--;
+
+    // Nested pipelines report their errors at the outermost end
+    if(g_PipelineDepth > 0)
+        return 0;
+
+    return g_Channel.Flush();
+}
+
+void DLPC350_SetCommandPipelineWindow(unsigned int window)
+/**
+ * Sets the maximum number of commands which may wait for an ACK while pipelining.
+ *
+ * @param   window - I - number of commands (1 to 128)
+ *
+ */
+{
+    g_Channel.SetWindow(window);
 }
 
 static int DLPC350_Read()
@@ -192,6 +219,10 @@ static int DLPC350_Read()
 {
     int ret_val;
     hidMessageStruct *pMsg = (hidMessageStruct *)g_InputBuffer;
+
+    // The reply must NOT be confused with the ACK of a pipelined command
+    g_Channel.Drain();
+
     if(DLPC350_USB_Write() > 0)
     {
         ret_val =  DLPC350_USB_Read();
@@ -218,48 +249,43 @@ static int DLPC350_SendMsg(hidMessageStruct *pMsg, bool ackRequired)
  *
  */
 {
+    const int packetSize = USB_MAX_PACKET_SIZE+1;
     int maxDataSize = USB_MAX_PACKET_SIZE-sizeof(pMsg->head);
     int dataBytesSent = MIN(pMsg->head.length, maxDataSize);    //Send all data or max possible
+    std::vector<unsigned char> packets;
+
+    // Outstanding ACKs can NOT arrive from a device which is no longer connected
+    if(!DLPC350_USB_IsConnected())
+    {
+        g_Channel.Reset();
+        return -1;
+    }
 
     // Default the DLPC350_PrepWriteCmd() update write message for ACK
     // if user not expecting adjust accordingly
     if(!ackRequired)
         pMsg->head.flags.reply = 0;
 
-    g_OutputBuffer[0]=0; // First byte is the report number
-    memcpy(&g_OutputBuffer[1], pMsg, (sizeof(pMsg->head) + dataBytesSent));
+    // First packet contains the header. First byte is the report number
+    packets.resize(packetSize, 0);
+    memcpy(&packets[1], pMsg, (sizeof(pMsg->head) + dataBytesSent));
 
-    //Single packet transaction
-    if(dataBytesSent >= pMsg->head.length)
-    {
-        if(DLPC350_Write(ackRequired) < 0)
-            return -1;
-    }
-    else
+    // Remaining packets contain only data. The ACK is sent after the last packet
+    while(dataBytesSent < pMsg->head.length)
     {
-        //Send ACK request only for the last packet
-        if(DLPC350_Write(0) < 0)
-            return -1;
+        packets.resize(packets.size()+packetSize, 0);
+        memcpy(&packets[packets.size()-packetSize+1], &pMsg->text.data[dataBytesSent], USB_MAX_PACKET_SIZE);
 
-        while(dataBytesSent < pMsg->head.length)
-        {
-            memcpy(&g_OutputBuffer[1], &pMsg->text.data[dataBytesSent], USB_MAX_PACKET_SIZE);
+        dataBytesSent += USB_MAX_PACKET_SIZE;
+    }
 
-            if((dataBytesSent+USB_MAX_PACKET_SIZE) >= (pMsg->head.length))
-            {
-                //last packet request for ACK
-                if(DLPC350_Write(ackRequired) < 0)
-                    return -1;
-            }
-            else
-            {
-                //middle packet
-                if(DLPC350_Write(0) < 0)
-                    return -1;
-            }
+    std::shared_future<int> result = g_Channel.Submit(packets, pMsg->head.seq, ackRequired);
 
-            dataBytesSent += USB_MAX_PACKET_SIZE;
-        }
+    // Pipelined commands are checked by DLPC350_EndCommandPipeline()
+    if(g_PipelineDepth == 0)
+    {
+        if(result.get() < 0)
+            return -1;
     }
 
     return dataBytesSent+sizeof(pMsg->head);
@@ -1016,10 +1042,11 @@ int DLPC350_UploadData(unsigned char *pByteArray, unsigned int dataLen)
     if(dataLen > sendSize)
         dataLen = sendSize;
 
-    CmdList[BL_DNLD_DATA].len = dataLen;
     memcpy(&msg.text.data[2], pByteArray, dataLen);
 
+    // The shared command table is NOT modified so other devices are unaffected
     DLPC350_PrepWriteCmd(&msg, BL_DNLD_DATA);
+    msg.head.length = dataLen + 2;
 
     retval = DLPC350_SendMsg(&msg,false);
     if(retval > 0)
@@ -2742,15 +2769,24 @@ int DLPC350_SendVarExpPatLut(void)
     }
 #endif
 
+    // Send the entries without waiting for each ACK
+    DLPC350_BeginCommandPipeline();
+
     if(DLPC350_OpenMailbox(3) < 0)
+    {
+        DLPC350_EndCommandPipeline();
         return -1;
+    }
 
     DLPC350_PrepWriteCmd(&msg, MBOX_EXP_DATA);
 
     for(i=0; i<g_ExpLutIndex; i+=3)
     {
         if(DLPC350_SetVarExpMboxAddr(i/3) < 0)
+        {
+            DLPC350_EndCommandPipeline();
             return -1;
+        }
 
         msg.text.data[2] = g_ExpLut[i];
         msg.text.data[3] = g_ExpLut[i]>>8;
@@ -2766,11 +2802,17 @@ int DLPC350_SendVarExpPatLut(void)
         msg.text.data[11] = g_ExpLut[i+2]>>8;
         msg.text.data[12] = g_ExpLut[i+2]>>16;
         msg.text.data[13] = g_ExpLut[i+2]>>24;
+
+        // Each entry is a new command
+        msg.head.seq = g_SeqNum++;
         DLPC350_SendMsg(&msg,true);
     }
 
     DLPC350_CloseMailbox();
 
+    if(DLPC350_EndCommandPipeline() < 0)
+        return -1;
+
     return 0;
 }
 
@@ -2805,6 +2847,9 @@ int DLPC350_SendVarExpImageLut(unsigned char *lutEntries, unsigned int numEntrie
     }
 #endif
 
+    // Send the commands without waiting for each ACK
+    DLPC350_BeginCommandPipeline();
+
     DLPC350_OpenMailbox(1);
     DLPC350_SetVarExpMboxAddr(0);
 
@@ -2822,11 +2867,14 @@ int DLPC350_SendVarExpImageLut(unsigned char *lutEntries, unsigned int numEntrie
         }
     }
 
-    CmdList[MBOX_DATA].len = numEntries;
     DLPC350_PrepWriteCmd(&msg, MBOX_DATA);
+    msg.head.length = numEntries + 2;
     bytes_sent = DLPC350_SendMsg(&msg,true);
     DLPC350_CloseMailbox();
 
+    if(DLPC350_EndCommandPipeline() < 0)
+        return -1;
+
     return bytes_sent;
 }
 
@@ -2855,12 +2903,18 @@ int DLPC350_SendPatLut(void)
     }
 #endif
 
+    // Send the commands without waiting for each ACK
+    DLPC350_BeginCommandPipeline();
+
     if(DLPC350_OpenMailbox(2) < 0)
+    {
+        DLPC350_EndCommandPipeline();
         return -1;
+    }
     DLPC350_MailboxSetAddr(0);
 
-    CmdList[MBOX_DATA].len = bytesToSend;
     DLPC350_PrepWriteCmd(&msg, MBOX_DATA);
+    msg.head.length = bytesToSend + 2;
 
     for(i=0; i<g_PatLutIndex; i++)
     {
@@ -2871,6 +2925,10 @@ int DLPC350_SendPatLut(void)
 
     DLPC350_SendMsg(&msg,true);
     DLPC350_CloseMailbox();
+
+    if(DLPC350_EndCommandPipeline() < 0)
+        return -1;
+
     return 0;
 }
 
@@ -2904,6 +2962,9 @@ int DLPC350_SendImageLut(unsigned char *lutEntries, unsigned int numEntries)
     if(numEntries < 1 || numEntries > MAX_IMAGE_LUT_ENTRIES)
         return -1;
 
+    // Send the commands without waiting for each ACK
+    DLPC350_BeginCommandPipeline();
+
     DLPC350_OpenMailbox(1);
     DLPC350_MailboxSetAddr(0);
 
@@ -2921,11 +2982,14 @@ int DLPC350_SendImageLut(unsigned char *lutEntries, unsigned int numEntries)
         }
     }
 
-    CmdList[MBOX_DATA].len = numEntries;
     DLPC350_PrepWriteCmd(&msg, MBOX_DATA);
+    msg.head.length = numEntries + 2;
     bytes_sent = DLPC350_SendMsg(&msg,true);
     DLPC350_CloseMailbox();
 
+    if(DLPC350_EndCommandPipeline() < 0)
+        return -1;
+
     return bytes_sent;
 }
 
@@ -0,0 +1,173 @@
+/** @file   dlpc350_channel.cpp
+ *  @brief  Contains methods for the pipelined DLPC350 USB HID command channel
+ *  @copyright 2016 Texas Instruments Incorporated - http://www.ti.com/ ALL RIGHTS RESERVED
+ */
+
+#include <dlp_platforms/lightcrafter_4500/common.hpp>
+#include <dlp_platforms/lightcrafter_4500/dlpc350_api.hpp>
+#include <dlp_platforms/lightcrafter_4500/dlpc350_usb.hpp>
+#include <dlp_platforms/lightcrafter_4500/dlpc350_channel.hpp>
+
+#include <chrono>
+
+/** @brief  Contains all DLP SDK classes, functions, etc. */
+namespace dlp{
+
+/** @brief Constructs an empty channel using \ref DLPC350_CommandChannel::WINDOW_DEFAULT */
+DLPC350_CommandChannel::DLPC350_CommandChannel(){
+    this->window_    = WINDOW_DEFAULT;
+    this->status_    = 0;
+    this->unmatched_ = 0;
+}
+
+/** @brief Fails any commands which have NOT been acknowledged */
+DLPC350_CommandChannel::~DLPC350_CommandChannel(){
+    this->FailOutstanding(-1);
+}
+
+/** @brief      Writes a command to the USB interface without waiting for its acknowledgement
+ *  @param[in]  packets         USB reports of the command. Each report is
+ *                              USB_MAX_PACKET_SIZE+1 bytes starting with the report number.
+ *  @param[in]  sequence        Sequence number in the command's message header
+ *  @param[in]  ack_required    If true, the DLPC350 was asked to acknowledge the command
+ *  @return     Future which resolves to the result of the command. Waiting on
+ *              the future reads acknowledgements until this command's arrives.
+ */
+std::shared_future<int> DLPC350_CommandChannel::Submit(const std::vector<unsigned char> &packets,
+                                                       const unsigned char &sequence,
+                                                       const bool &ack_required){
+    const unsigned int packet_size = USB_MAX_PACKET_SIZE + 1;
+
+    std::promise<int> immediate;
+
+    // Make room in the window so the DLPC350 input buffer does not overflow
+    while(this->outstanding_.size() >= this->window_){
+        if(!this->ReadAck()) this->FailOutstanding(-1);
+    }
+
+    // Write each report
+    int bytes_written = -1;
+    for(unsigned int iPacket = 0; (iPacket+1)*packet_size <= packets.size(); iPacket++){
+        bytes_written = DLPC350_USB_WritePacket(&packets[iPacket*packet_size]);
+        if(bytes_written < 0) break;
+    }
+
+    // If the write failed or no reply will come the result is known now
+    if((bytes_written < 0) || !ack_required){
+        if((bytes_written < 0) && (this->status_ >= 0)) this->status_ = bytes_written;
+        immediate.set_value(bytes_written);
+        return immediate.get_future().share();
+    }
+
+    Command command;
+    command.sequence      = sequence;
+    command.bytes_written = bytes_written;
+    std::shared_future<int> result = command.result.get_future().share();
+    this->outstanding_.push_back(std::move(command));
+
+    // Read acknowledgements only when the result is requested
+    return std::async(std::launch::deferred, [this, result]() -> int {
+        while(result.wait_for(std::chrono::seconds(0)) != std::future_status::ready){
+            if(!this->ReadAck()) this->FailOutstanding(-1);
+        }
+        return result.get();
+    }).share();
+}
+
+/** @brief  Reads acknowledgements until no commands are outstanding */
+void DLPC350_CommandChannel::Drain(){
+    while(!this->outstanding_.empty()){
+        if(!this->ReadAck()) this->FailOutstanding(-1);
+    }
+}
+
+/** @brief  Reads acknowledgements until no commands are outstanding
+ *  @return 0 if every command since the previous flush succeeded, otherwise
+ *          the result of the first failed command
+ */
+int DLPC350_CommandChannel::Flush(){
+    this->Drain();
+
+    int ret = this->status_;
+    this->status_ = 0;
+    return ret;
+}
+
+/** @brief  Fails all outstanding commands and clears the status, e.g. after the device was reconnected */
+void DLPC350_CommandChannel::Reset(){
+    this->FailOutstanding(-1);
+    this->status_ = 0;
+}
+
+/** @brief  Sets the maximum number of commands waiting for an acknowledgement
+ *  \note   Values are limited to 1 through \ref DLPC350_CommandChannel::WINDOW_MAXIMUM
+ */
+void DLPC350_CommandChannel::SetWindow(const unsigned int &window){
+    this->window_ = window;
+    if(this->window_ < 1)              this->window_ = 1;
+    if(this->window_ > WINDOW_MAXIMUM) this->window_ = WINDOW_MAXIMUM;
+}
+
+/** @brief  Returns the maximum number of commands waiting for an acknowledgement */
+unsigned int DLPC350_CommandChannel::GetWindow() const{
+    return this->window_;
+}
+
+/** @brief  Returns the number of commands waiting for an acknowledgement */
+unsigned int DLPC350_CommandChannel::GetOutstanding() const{
+    return this->outstanding_.size();
+}
+
+/** @brief  Returns the number of replies read which did NOT belong to an outstanding command,
+ *          e.g. late acknowledgements of commands failed by \ref DLPC350_CommandChannel::Reset()
+ */
+unsigned long long DLPC350_CommandChannel::GetUnmatched() const{
+    return this->unmatched_;
+}
+
+/** @brief  Reads one report and completes the command with the matching sequence number
+ *  \note   Reports which do NOT belong to an outstanding command are counted
+ *          and otherwise ignored, see \ref DLPC350_CommandChannel::GetUnmatched()
+ *  @return false if the read failed or timed out
+ */
+bool DLPC350_CommandChannel::ReadAck(){
+    unsigned char buffer[USB_MAX_PACKET_SIZE+1];
+
+    if(DLPC350_USB_ReadPacket(buffer) <= 0) return false;
+
+    const hidMessageStruct *pMsg = (const hidMessageStruct*)buffer;
+
+    for(unsigned int iCommand = 0; iCommand < this->outstanding_.size(); iCommand++){
+        if(this->outstanding_.at(iCommand).sequence == pMsg->head.seq){
+            if(pMsg->head.flags.nack == 1){
+                this->Complete(iCommand, -2);
+            }
+            else{
+                this->Complete(iCommand, this->outstanding_.at(iCommand).bytes_written);
+            }
+            return true;
+        }
+    }
+
+    // Reports which do not belong to an outstanding command are counted and ignored
+    this->unmatched_++;
+
+    return true;
+}
+
+/** @brief  Sets the result of an outstanding command and removes it */
+void DLPC350_CommandChannel::Complete(const unsigned int &index, const int &result){
+    if((result < 0) && (this->status_ >= 0)) this->status_ = result;
+
+    this->outstanding_.at(index).result.set_value(result);
+    this->outstanding_.erase(this->outstanding_.begin() + index);
+}
+
+/** @brief  Sets the result of all outstanding commands */
+void DLPC350_CommandChannel::FailOutstanding(const int &result){
+    while(!this->outstanding_.empty()){
+        this->Complete(0, result);
+    }
+}
+
+}
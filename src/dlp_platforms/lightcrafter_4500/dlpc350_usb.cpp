@@ -39,6 +39,7 @@
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <set>
 
 #include <hidapi.h>
 #include <dlp_platforms/lightcrafter_4500/dlpc350_usb.hpp>
@@ -47,89 +48,320 @@
 *                  GLOBAL VARIABLES
 ****************************************************/
 
-static hid_device *DeviceHandle;    //Handle to write
-//In/Out buffers equal to HID endpoint size + 1
-//First byte is for Windows internal use and it is always 0
-unsigned char g_OutputBuffer[USB_MAX_PACKET_SIZE+1];
-unsigned char g_InputBuffer[USB_MAX_PACKET_SIZE+1];
+static DLPC350_Context DefaultContext;                          //Used when no context is selected
+static thread_local DLPC350_Context *CurrentContext = NULL;     //Selected by DLPC350_ContextLock
 
+//hidapi is shared by all contexts
+static std::mutex            HidMutex;
+static int                   HidInitCount = 0;
+static std::set<std::string> HidOpenPaths;                      //Devices opened by any context
 
-static int USBConnected = 0;      //Boolean true when device is connected
+DLPC350_Context::DLPC350_Context()
+{
+    DeviceHandle   = NULL;
+    USBConnected   = 0;
+    HidInitialized = false;
+
+    //Optional replacement for the hidapi device, e.g. a loopback stub for benchmarking
+    TransportWrite = NULL;
+    TransportRead  = NULL;
+
+    memset(OutputBuffer, 0, sizeof(OutputBuffer));
+    memset(InputBuffer,  0, sizeof(InputBuffer));
+
+    SeqNum      = 0;
+    PatLutIndex = 0;
+    ExpLutIndex = 0;
+    memset(PatLut, 0, sizeof(PatLut));
+    memset(ExpLut, 0, sizeof(ExpLut));
+
+    PipelineDepth = 0;
+}
+
+DLPC350_Context::~DLPC350_Context()
+{
+    DLPC350_ContextLock lock(this);
+
+    if(USBConnected)
+        DLPC350_USB_Close();
+
+    if(HidInitialized)
+        DLPC350_USB_Exit();
+}
+
+DLPC350_ContextLock::DLPC350_ContextLock(DLPC350_Context *context) :
+    lock_(context->Mutex)
+{
+    previous_ = CurrentContext;
+    CurrentContext = context;
+}
+
+DLPC350_ContextLock::~DLPC350_ContextLock()
+{
+    CurrentContext = previous_;
+}
+
+DLPC350_Context *DLPC350_GetContext()
+{
+    if(CurrentContext != NULL)
+        return CurrentContext;
+
+    return &DefaultContext;
+}
 
 int DLPC350_USB_IsConnected()
 {
-    return USBConnected;
+    return DLPC350_GetContext()->USBConnected;
 }
 
 int DLPC350_USB_Init(void)
 {
-    return hid_init();
+    DLPC350_Context *pContext = DLPC350_GetContext();
+    std::lock_guard<std::mutex> lock(HidMutex);
+
+    if(pContext->HidInitialized)
+        return 0;
+
+    if(HidInitCount == 0)
+    {
+        int ret = hid_init();
+        if(ret < 0)
+            return ret;
+    }
+
+    HidInitCount++;
+    pContext->HidInitialized = true;
+
+    return 0;
 }
 
 int DLPC350_USB_Exit(void)
 {
-    return hid_exit();
+    DLPC350_Context *pContext = DLPC350_GetContext();
+    std::lock_guard<std::mutex> lock(HidMutex);
+
+    if(!pContext->HidInitialized)
+        return 0;
+
+    pContext->HidInitialized = false;
+    HidInitCount--;
+
+    //Only release hidapi once no other device needs it
+    if(HidInitCount == 0)
+        return hid_exit();
+
+    return 0;
+}
+
+int DLPC350_USB_Enumerate(std::vector<std::string> *serials, std::vector<std::string> *paths)
+/**
+ * Lists the serial numbers and paths of all attached DLPC350 devices.
+ *
+ * @return  number of devices found
+ *          -1 = NULL argument
+ */
+{
+    if((serials == NULL) || (paths == NULL))
+        return -1;
+
+    serials->clear();
+    paths->clear();
+
+    struct hid_device_info *pDevices = hid_enumerate(MY_VID, MY_PID);
+
+    for(struct hid_device_info *pDevice = pDevices; pDevice != NULL; pDevice = pDevice->next)
+    {
+        std::string serial;
+        if(pDevice->serial_number != NULL)
+        {
+            for(const wchar_t *pChar = pDevice->serial_number; *pChar != 0; pChar++)
+                serial.push_back((char)*pChar);
+        }
+
+        serials->push_back(serial);
+        paths->push_back(pDevice->path != NULL ? pDevice->path : "");
+    }
+
+    hid_free_enumeration(pDevices);
+
+    return serials->size();
 }
 
 int DLPC350_USB_Open()
 {
-    // Open the device using the VID, PID,
-    // and optionally the Serial number.
-    DeviceHandle = hid_open(MY_VID, MY_PID, NULL);
+    return DLPC350_USB_OpenDevice(NULL);
+}
+
+int DLPC350_USB_OpenDevice(const char *id)
+/**
+ * Opens the DLPC350 whose USB serial number or path equals id. If id is NULL, empty
+ * or does not match any device, the first device not opened by another context is used.
+ *
+ * @return  0 = PASS
+ *          -1 = no device could be opened
+ */
+{
+    DLPC350_Context *pContext = DLPC350_GetContext();
+
+    // A user supplied transport does not need a device
+    if(pContext->TransportWrite != NULL)
+    {
+        pContext->USBConnected = 1;
+        return 0;
+    }
+
+    std::vector<std::string> serials;
+    std::vector<std::string> paths;
+    std::string requested = (id != NULL) ? id : "";
+
+    std::lock_guard<std::mutex> lock(HidMutex);
+
+    DLPC350_USB_Enumerate(&serials, &paths);
+
+    // Look for the requested device first
+    std::string path;
+    for(unsigned int iDevice = 0; iDevice < paths.size() && !requested.empty(); iDevice++)
+    {
+        if((serials.at(iDevice) == requested) || (paths.at(iDevice) == requested))
+        {
+            path = paths.at(iDevice);
+            break;
+        }
+    }
+
+    // Otherwise use the first device nobody else has opened
+    for(unsigned int iDevice = 0; iDevice < paths.size() && path.empty(); iDevice++)
+    {
+        if(HidOpenPaths.count(paths.at(iDevice)) == 0)
+            path = paths.at(iDevice);
+    }
 
-    if(DeviceHandle == NULL)
+    if(path.empty() || (HidOpenPaths.count(path) != 0))
     {
-        USBConnected = 0;
+        pContext->USBConnected = 0;
         return -1;
     }
 
-    USBConnected = 1;
+    // Open the device by its path
+    pContext->DeviceHandle = hid_open_path(path.c_str());
+
+    if(pContext->DeviceHandle == NULL)
+    {
+        pContext->USBConnected = 0;
+        return -1;
+    }
+
+    HidOpenPaths.insert(path);
+    pContext->DevicePath   = path;
+    pContext->USBConnected = 1;
 
     return 0;
 }
 
 int DLPC350_USB_Write()
 {
+    return DLPC350_USB_WritePacket(DLPC350_GetContext()->OutputBuffer);
+}
+
+int DLPC350_USB_Read()
+{
+    return DLPC350_USB_ReadPacket(DLPC350_GetContext()->InputBuffer);
+}
+
+int DLPC350_USB_WritePacket(const unsigned char *pBuffer)
+/**
+ * Writes one report (report number followed by USB_MIN_PACKET_SIZE bytes) to the device.
+ *
+ * @return  number of bytes written
+ *          -1 = error writing
+ */
+{
+    DLPC350_Context *pContext = DLPC350_GetContext();
     int bytesWritten;
 
-    if(DeviceHandle == NULL)
+    if(pContext->TransportWrite != NULL)
+        return pContext->TransportWrite(pBuffer, USB_MIN_PACKET_SIZE+1);
+
+    if(pContext->DeviceHandle == NULL)
         return -1;
 
-    if((bytesWritten = hid_write(DeviceHandle, g_OutputBuffer, USB_MIN_PACKET_SIZE+1)) == -1)
+    if((bytesWritten = hid_write(pContext->DeviceHandle, pBuffer, USB_MIN_PACKET_SIZE+1)) == -1)
     {
-        hid_close(DeviceHandle);
-        USBConnected = 0;
+        DLPC350_USB_Close();
         return -1;
     }
 
     return bytesWritten;
 }
 
-int DLPC350_USB_Read()
+int DLPC350_USB_ReadPacket(unsigned char *pBuffer)
+/**
+ * Reads one report from the device into pBuffer, waiting at most USB_READ_TIMEOUT_MS.
+ *
+ * @return  number of bytes read
+ *          0 = timeout
+ *          -1 = error reading
+ */
 {
+    DLPC350_Context *pContext = DLPC350_GetContext();
     int bytesRead;
 
-    if(DeviceHandle == NULL)
-        return -1;
-
     //clear out the input buffer
-    memset((void*)&g_InputBuffer[0],0x00,USB_MIN_PACKET_SIZE+1);
+    memset((void*)&pBuffer[0],0x00,USB_MIN_PACKET_SIZE+1);
 
-    if((bytesRead = hid_read_timeout(DeviceHandle, g_InputBuffer, USB_MIN_PACKET_SIZE+1, 2000)) == -1)
+    if(pContext->TransportRead != NULL)
+        return pContext->TransportRead(pBuffer, USB_MIN_PACKET_SIZE+1, USB_READ_TIMEOUT_MS);
+
+    if(pContext->DeviceHandle == NULL)
+        return -1;
+
+    if((bytesRead = hid_read_timeout(pContext->DeviceHandle, pBuffer, USB_MIN_PACKET_SIZE+1, USB_READ_TIMEOUT_MS)) == -1)
     {
-        hid_close(DeviceHandle);
-        USBConnected = 0;
+        DLPC350_USB_Close();
         return -1;
     }
 
     return bytesRead;
 }
 
+void DLPC350_USB_SetTransport(DLPC350_USB_WriteFunction write, DLPC350_USB_ReadFunction read)
+/**
+ * Replaces the hidapi device of the current context with user supplied write and read functions.
+ * Passing NULL for either function restores the hidapi device.
+ */
+{
+    DLPC350_Context *pContext = DLPC350_GetContext();
+
+    if((write != NULL) && (read != NULL))
+    {
+        pContext->TransportWrite = write;
+        pContext->TransportRead  = read;
+        pContext->USBConnected   = 1;
+    }
+    else
+    {
+        pContext->TransportWrite = NULL;
+        pContext->TransportRead  = NULL;
+        pContext->USBConnected   = 0;
+    }
+}
+
 int DLPC350_USB_Close()
 {
-    hid_close(DeviceHandle);
-    USBConnected = 0;
+    DLPC350_Context *pContext = DLPC350_GetContext();
+
+    if(pContext->DeviceHandle != NULL)
+    {
+        std::lock_guard<std::mutex> lock(HidMutex);
+
+        hid_close(pContext->DeviceHandle);
+        HidOpenPaths.erase(pContext->DevicePath);
+
+        pContext->DeviceHandle = NULL;
+        pContext->DevicePath.clear();
+    }
+
+    pContext->USBConnected = 0;
 
     return 0;
 }
-
@@ -16,6 +16,8 @@
 #include <sstream>
 #include <string>
 #include <atomic>
+#include <chrono>
+#include <mutex>
 
 #include <ctime>
 
@@ -28,6 +30,9 @@
 #include <dlp_platforms/dlp_platform.hpp>
 #include <dlp_platforms/lightcrafter_4500/lcr4500.hpp>
 
+/** @brief  Serializes firmware creation between LCr4500 objects */
+static std::mutex firmware_build_mutex;
+
 /** @brief  Contains all DLP SDK classes, functions, etc. */
 namespace dlp{
 
@@ -80,26 +85,36 @@ LCr4500::LCr4500()
     this->previous_command_in_progress      = false;
     this->firmware_upload_restart_needed    = false;
     this->pattern_sequence_prepared_        = false;
+    this->pattern_sequence_source_          = Pattern::Source::FLASH_IMAGES;
 
     this->firmware_upload_percent_erased_   = 0;
     this->firmware_upload_percent_complete_ = 0;
 
 
-    this->previous_sequence_start_ = 0;
-    this->previous_sequence_patterns_ = 0;
-    this->previous_sequence_repeat_ = false;
+    this->sequence_lut_active_      = false;
+    this->sequence_lut_active_hash_ = 0;
+
+    this->dlpc350_context_ = std::make_shared<DLPC350_Context>();
+
+    // Poll the DLPC350 through its API
+    this->SetStatusReader(StatusReader());
+
+    this->sequence_switch_time_us_ = 0;
 
     this->debug_.Msg(1,"Object constructed");
 }
 
 /** @brief  Connects to a DLP LightCrafter 4500 EVM 
- *  @param[in]  device  assigned ID of individual projector
+ *  @param[in]  id  assigned ID of individual projector
  *
- *  Functionality of multiple projectors
- *  NOT yet implemented but will allow multiple
- *  projectors to be connected to the DLP SDK.
+ *  If id equals the USB serial number or path of an attached EVM that
+ *  device is opened. Otherwise the first EVM which is NOT already
+ *  connected to another LCr4500 object is opened. Each LCr4500 object
+ *  keeps its own USB connection so several projectors can be used from
+ *  different threads.
  */
 ReturnCode LCr4500::Connect(std::string id){
+    DLPC350_ContextLock dlpc350_lock(this->dlpc350_context_.get());
     ReturnCode ret;
 
     // If A firmware upload is in progress, do NOT send any commands until upload is complete! and does not
@@ -116,6 +131,9 @@ ReturnCode LCr4500::Connect(std::string id){
         DLPC350_USB_Exit();
     }
 
+    // The lookup table on the DLPC350 is unknown until a sequence is sent
+    this->sequence_lut_active_ = false;
+
     // Initialize the USB interface
     this->debug_.Msg("Initializing USB HID interface...");
     DLPC350_USB_Init();
@@ -125,11 +143,12 @@ ReturnCode LCr4500::Connect(std::string id){
 
     // Attempt to open the LCr4500 USB interface
     this->debug_.Msg("Opening USB HID interface...");
-    DLPC350_USB_Open();
+    DLPC350_USB_OpenDevice(id.c_str());
 
-    // Workaround for DLPC350 error
+    // Workaround for DLPC350 error, reopen the same device
+    std::string device_path = this->dlpc350_context_->DevicePath;
     DLPC350_USB_Close();
-    DLPC350_USB_Open();
+    DLPC350_USB_OpenDevice(device_path.c_str());
 
     // Check if the connection succeeded
     if(!DLPC350_USB_IsConnected()){
@@ -148,11 +167,59 @@ ReturnCode LCr4500::Connect(std::string id){
     return ret;
 }
 
+/** @brief      Lists the LightCrafter 4500 EVMs attached to the USB
+ *  @param[out] serials Pointer to return the USB serial number of each EVM
+ *  @param[out] paths   Pointer to return the USB path of each EVM
+ *  \note       Either value may be passed to \ref LCr4500::Connect()
+ *  @retval     LCR4500_NULL_POINTER_ARGUMENT   Return argument is NULL
+ */
+ReturnCode LCr4500::GetUSBDevices(std::vector<std::string> *serials, std::vector<std::string> *paths){
+    ReturnCode ret;
+
+    if(!serials || !paths)
+        return ret.AddError(LCR4500_NULL_POINTER_ARGUMENT);
+
+    DLPC350_USB_Enumerate(serials, paths);
+
+    return ret;
+}
+
+/** @brief      Replaces the USB device of this object with user supplied write and read functions
+ *  @param[in]  write   Writes one USB report, see DLPC350_USB_SetTransport()
+ *  @param[in]  read    Reads one USB report, see DLPC350_USB_SetTransport()
+ *  \note       Passing NULL for either function restores the USB device.
+ *              \ref LCr4500::Connect() must be called afterwards.
+ */
+void LCr4500::SetTransport(DLPC350_USB_WriteFunction write, DLPC350_USB_ReadFunction read){
+    DLPC350_ContextLock dlpc350_lock(this->dlpc350_context_.get());
+    DLPC350_USB_SetTransport(write, read);
+}
+
+/** @brief      Sets the functions used to poll the DLPC350 while waiting for commands to take effect
+ *  @param[in]  reader  Replacement functions, e.g. a simulated DLPC350. Empty
+ *                      members use the DLPC350 API of this object's connection.
+ */
+void LCr4500::SetStatusReader(const StatusReader &reader){
+    DLPC350_ContextLock dlpc350_lock(this->dlpc350_context_.get());
+
+    this->status_reader_ = reader;
+
+    if(!this->status_reader_.GetStatus)
+        this->status_reader_.GetStatus = DLPC350_GetStatus;
+
+    if(!this->status_reader_.GetMode)
+        this->status_reader_.GetMode = DLPC350_GetMode;
+
+    if(!this->status_reader_.CheckPatLutValidate)
+        this->status_reader_.CheckPatLutValidate = DLPC350_CheckPatLutValidate;
+}
+
 /** @brief  Disconnects from the DLP LightCrafter 4500 EVM
  * @retval  LCR4500_FIRMWARE_UPLOAD_IN_PROGRESS A firmware upload is in progress, do NOT send any commands until upload is complete!
  * @retval  LCR4500_NOT_CONNECTED               A LightCrafter 4500 EVM has NOT enumerated on the USB
  */
 ReturnCode LCr4500::Disconnect(){
+    DLPC350_ContextLock dlpc350_lock(this->dlpc350_context_.get());
     ReturnCode ret;
 
     // If A firmware upload is in progress and does not
@@ -169,6 +236,8 @@ ReturnCode LCr4500::Disconnect(){
         ret.AddError(LCR4500_NOT_CONNECTED);
     }
 
+    this->sequence_lut_active_ = false;
+
     // Close the USB interface
     this->debug_.Msg("Closing USB HID interface");
     DLPC350_USB_Close();
@@ -179,6 +248,7 @@ ReturnCode LCr4500::Disconnect(){
 
 /** @brief  Returns true if the projector object is connected via USB. */
 bool LCr4500::isConnected() const{
+    DLPC350_ContextLock dlpc350_lock(this->dlpc350_context_.get());
     bool ret = DLPC350_USB_IsConnected();
 
     if(ret){
@@ -222,6 +292,7 @@ bool LCr4500::isConnected() const{
  * @retval  LCR4500_SETUP_TRIGGER_OUTPUT_2_FAILED   The trigger 2 output could NOT be set
  */
 ReturnCode LCr4500::Setup(const dlp::Parameters &settings){
+    DLPC350_ContextLock dlpc350_lock(this->dlpc350_context_.get());
     ReturnCode ret;
 
     bool setup_default = false;
@@ -243,6 +314,11 @@ ReturnCode LCr4500::Setup(const dlp::Parameters &settings){
     if(DLPC350_PatternDisplay(Pattern::DisplayControl::STOP)<0)
         return ret.AddError(LCR4500_PATTERN_DISPLAY_FAILED);
 
+    // The new settings may change the operating mode and sequence timing
+    // so the stored lookup tables must be recreated
+    this->sequence_lut_active_ = false;
+    this->ClearSequenceBank();
+
 
     // Should default values be set?
     settings.Get(&this->use_default_);
@@ -251,6 +327,10 @@ ReturnCode LCr4500::Setup(const dlp::Parameters &settings){
         setup_default = this->use_default_.Get();
     }
 
+    // Get the maximum time to wait for the DLPC350 to respond to a command
+    if(settings.Contains(this->ready_timeout_))
+        settings.Get(&this->ready_timeout_);
+
     // Load DLPC350 related file locations
     if(settings.Contains(this->dlpc350_firmware_))
         settings.Get(&this->dlpc350_firmware_);
@@ -266,6 +346,9 @@ ReturnCode LCr4500::Setup(const dlp::Parameters &settings){
     if(settings.Contains(this->verify_image_load_))
         settings.Get(&this->verify_image_load_);
 
+    if(settings.Contains(this->video_frame_period_))
+        settings.Get(&this->video_frame_period_);
+
 
     // Check if parameters contains setup instructions
     if(setup_default || settings.Contains(this->power_standby_)){
@@ -498,20 +581,21 @@ ReturnCode LCr4500::Setup(const dlp::Parameters &settings){
         if(mode != OperatingMode::VIDEO){
             if(DLPC350_SetMode(OperatingMode::VIDEO) < 0)
                 return ret.AddError(LCR4500_SETUP_DISPLAY_MODE_FAILED);
+
+            ret = this->WaitForOperatingMode(OperatingMode::VIDEO);
+            if(ret.hasErrors()) return ret;
         }
 
-        dlp::Time::Sleep::Milliseconds(10);
         if(DLPC350_SetInputSource(Video::InputSource::INTERNAL_TEST_PATTERNS,
                                   Video::ParallelPortWidth::BITS_30) < 0)
             return ret.AddError(LCR4500_SETUP_INPUT_SOURCE_FAILED);
 
-        dlp::Time::Sleep::Milliseconds(10);
+        ret = this->WaitForStatus("set input source");
+        if(ret.hasErrors()) return ret;
 
         if(DLPC350_SetTPGColor(0,0,0,1023,1023,1023) < 0)
             return ret.AddError(LCR4500_SETUP_TEST_PATTERN_COLOR_FAILED);
 
-        dlp::Time::Sleep::Milliseconds(10);
-
         if(DLPC350_SetTPGSelect(test_pattern.Get()) < 0)
             return ret.AddError(LCR4500_SETUP_TEST_PATTERN_FAILED);
 
@@ -540,17 +624,21 @@ ReturnCode LCr4500::Setup(const dlp::Parameters &settings){
         if(mode != OperatingMode::VIDEO){
             if(DLPC350_SetMode(OperatingMode::VIDEO) < 0)
                 return ret.AddError(LCR4500_SETUP_DISPLAY_MODE_FAILED);
+
+            ret = this->WaitForOperatingMode(OperatingMode::VIDEO);
+            if(ret.hasErrors()) return ret;
         }
 
-        dlp::Time::Sleep::Milliseconds(10);
         DLPC350_GetInputSource(&source, &portWidth);
         if (source != Video::InputSource::FLASH_IMAGES){
             if(DLPC350_SetInputSource(Video::InputSource::FLASH_IMAGES,
                                       Video::ParallelPortWidth::BITS_30) < 0)
                 return ret.AddError(LCR4500_SETUP_INPUT_SOURCE_FAILED);
+
+            ret = this->WaitForStatus("set input source");
+            if(ret.hasErrors()) return ret;
         }
 
-        dlp::Time::Sleep::Milliseconds(10);
         if(DLPC350_LoadImageIndex(flash_image.Get()) < 0)
             return ret.AddError(LCR4500_SETUP_FLASH_IMAGE_FAILED);
 
@@ -699,6 +787,8 @@ ReturnCode LCr4500::GetSetup(dlp::Parameters* settings) const{
     settings->Set(this->trigger_out_1_falling_);
     settings->Set(this->trigger_out_2_rising_);
     settings->Set(this->verify_image_load_);
+    settings->Set(this->ready_timeout_);
+    settings->Set(this->video_frame_period_);
 
     return ret;
 }
@@ -710,6 +800,7 @@ ReturnCode LCr4500::GetSetup(dlp::Parameters* settings) const{
  * @retval  LCR4500_NOT_CONNECTED                   A LightCrafter 4500 EVM has NOT enumerated on the USB
  */
 ReturnCode LCr4500::ProjectSolidWhitePattern(){
+    DLPC350_ContextLock dlpc350_lock(this->dlpc350_context_.get());
     ReturnCode ret;
 
     // If A firmware upload is in progress return error
@@ -740,11 +831,6 @@ ReturnCode LCr4500::ProjectSolidWhitePattern(){
         sequence.Add(white_pattern);
         sequence.parameters.Set(Parameters::PatternSequenceRepeat(true));
 
-        // Pattern LUT will be updated so reset these values
-        this->previous_sequence_start_    = 0;
-        this->previous_sequence_patterns_ = 0;
-        this->previous_sequence_repeat_   = false;
-
         // Send the LUT and start the sequence
         ret = this->CreateSendStartSequenceLut(sequence);
     }
@@ -762,6 +848,7 @@ ReturnCode LCr4500::ProjectSolidWhitePattern(){
  * @retval  LCR4500_NOT_CONNECTED                   A LightCrafter 4500 EVM has NOT enumerated on the USB
  */
 ReturnCode LCr4500::ProjectSolidBlackPattern(){
+    DLPC350_ContextLock dlpc350_lock(this->dlpc350_context_.get());
     ReturnCode ret;
 
     // If A firmware upload is in progress return error
@@ -794,11 +881,6 @@ ReturnCode LCr4500::ProjectSolidBlackPattern(){
 
         sequence.parameters.Set(Parameters::PatternSequenceRepeat(true));
 
-        // Pattern LUT will be updated so reset these values
-        this->previous_sequence_start_    = 0;
-        this->previous_sequence_patterns_ = 0;
-        this->previous_sequence_repeat_   = false;
-
         // Send the LUT and start the sequence
         ret = this->CreateSendStartSequenceLut(sequence);
     }
@@ -972,13 +1054,39 @@ ReturnCode LCr4500::PatternSettingsValid(dlp::Pattern &arg_pattern){
  * @retval  LCR4500_PATTERN_SEQUENCE_BUFFERSWAP_TIME_ERROR  Buffer swap has occured prematurely
  */
 ReturnCode LCr4500::CreateSendStartSequenceLut(const dlp::Pattern::Sequence &arg_pattern_sequence){
+    ReturnCode  ret;
+    SequenceLut lut;
+
+    ret = this->CreateSequenceLut(arg_pattern_sequence, &lut);
+    if(ret.hasErrors()) return ret;
+
+    return this->SendStartSequenceLut(lut);
+}
+
+/** @brief  Creates the LightCrafter 4500 pattern and image lookup tables
+ *          for a sequence without sending them
+ * \note    No commands are sent to the DLPC350. The image load times are
+ *          checked by \ref LCr4500::SendStartSequenceLut() before uploading.
+ * @param[in]   arg_pattern_sequence    object of \ref dlp::Pattern::Sequence type containing sequence
+ * @param[out]  lut                     Pointer to return the lookup tables
+ *
+ * @retval  PATTERN_SEQUENCE_EMPTY                          The pattern sequence sent contains no patterns
+ * @retval  PATTERN_SEQUENCE_EXPOSURES_NOT_EQUAL            The exposure times are NOT equal for each pattern in the sequence
+ * @retval  PATTERN_SEQUENCE_PERIODS_NOT_EQUAL              The periods are NOT equal for each pattern in the sequence
+ * @retval  PATTERN_SEQUENCE_PATTERN_TYPES_NOT_EQUAL        The pattern types are NOT equal for each pattern in the sequence
+ * @retval  PATTERN_DATA_TYPE_INVALID                       The data type of the pattern is invalid
+ * @retval  PATTERN_SEQUENCE_TOO_LONG                       The pattern sequence excedes the supported number of patterns
+ * @retval  LCR4500_FLASH_IMAGE_INDEX_INVALID               A flash image with the specified index is NOT valid
+ * @retval  LCR4500_IMAGE_LIST_TOO_LONG                     Too many images have been created to fit in LightCrafter 4500 flash
+ * @retval  LCR4500_NULL_POINTER_ARGUMENT                   Return argument is NULL
+ */
+ReturnCode LCr4500::CreateSequenceLut(const dlp::Pattern::Sequence &arg_pattern_sequence, SequenceLut *lut){
     ReturnCode ret;
     unsigned int sequence_count = arg_pattern_sequence.GetCount();
 
     dlp::Pattern::DataType sequence_type = dlp::Pattern::DataType::INVALID;
     unsigned int    sequence_exposure       = 0;
     unsigned int    sequence_period         = 0;
-    unsigned int    sequence_validation     = 0;
 
 
     std::vector<LCR4500_LUT_Entry> sequence_LUT;
@@ -990,17 +1098,9 @@ ReturnCode LCr4500::CreateSendStartSequenceLut(const dlp::Pattern::Sequence &arg
     dlp::Pattern      temp_pattern;
 
 
-    // If A firmware upload is in progress return error
-    if(this->FirmwareUploadInProgress()){
-        this->debug_.Msg("Cannot connect because firmware is uploading");
-        return ret.AddError(LCR4500_FIRMWARE_UPLOAD_IN_PROGRESS);
-    }
-
-    // Check that LCr4500 is connected
-    if(!this->isConnected()){
-        // Device NOT connected
-        return ret.AddError(LCR4500_NOT_CONNECTED);
-    }
+    // Check that the return pointer is NOT NULL
+    if(!lut)
+        return ret.AddError(LCR4500_NULL_POINTER_ARGUMENT);
 
     // Check that the sequence has entries
     if(sequence_count == 0)
@@ -1027,14 +1127,6 @@ ReturnCode LCr4500::CreateSendStartSequenceLut(const dlp::Pattern::Sequence &arg
         break;
     }
 
-    // Stop the display
-    if(DLPC350_PatternDisplay(Pattern::DisplayControl::STOP) < 0)
-        return ret.AddError(LCR4500_PATTERN_DISPLAY_FAILED);
-
-    dlp::Time::Sleep::Milliseconds(10);
-    if(DLPC350_GetStatus(&this->status_hw_,&this->status_sys_,&this->status_main_)<0)
-        return ret.AddError("LCR4500_GET_STATUS_FAILED - Pattern display stop");
-
     // Get and set the exposure and trigger time
     sequence_exposure   = this->sequence_exposure_.Get();
     sequence_period     = this->sequence_period_.Get();
@@ -1338,18 +1430,108 @@ ReturnCode LCr4500::CreateSendStartSequenceLut(const dlp::Pattern::Sequence &arg
     if( sequence_image_LUT.size() > LCr4500::IMAGE_LUT_SIZE)
         return ret.AddError(LCR4500_IMAGE_LIST_TOO_LONG);
 
+    // Get the pattern sequence display mode (play once or repeat)
+    Parameters::PatternSequenceRepeat repeat_sequence;
+    sequence_to_project.parameters.Get(&repeat_sequence);
+
+    // Video port patterns are read from the next frame, so the first
+    // pattern must wait for VSYNC even if the range starts mid-frame
+    if(this->pattern_sequence_source_ == Pattern::Source::VIDEO_PORT){
+        sequence_LUT.front().trigger_type = LCr4500::Pattern::TriggerSource::EXTERNAL_POSITIVE;
+    }
+
+    // Store the lookup tables
+    lut->repeat = repeat_sequence.Get();
+    lut->source = this->pattern_sequence_source_;
+
+    // The green and blue patterns of an RGB pattern share their trigger with the red
+    if(temp_pattern.color != dlp::Pattern::Color::RGB){
+        lut->pattern_count = sequence_LUT.size();
+    }
+    else{
+        lut->pattern_count = sequence_LUT.size() / 3;
+    }
+
+    lut->pattern_lut = std::move(sequence_LUT);
+    lut->image_lut   = std::move(sequence_image_LUT);
+    lut->hash        = LCr4500::HashSequenceLut(*lut);
+
+    return ret;
+}
+
+/** @brief  Sends a lookup table to the LightCrafter 4500 and starts the sequence
+ *
+ *  If the DLPC350 already holds the validated lookup table, the upload and
+ *  validation are skipped and only the sequencer is restarted.
+ *
+ * @param[in]   lut     Lookup tables created by \ref LCr4500::CreateSequenceLut()
+ *
+ * @retval  LCR4500_FIRMWARE_UPLOAD_IN_PROGRESS             A firmware upload is in progress, do NOT send any commands until upload is complete!
+ * @retval  LCR4500_NOT_CONNECTED                           The LightCrafter 4500 EVM is NOT connected
+ * @retval  LCR4500_PATTERN_SEQUENCE_BUFFERSWAP_TIME_ERROR  Buffer swap has occured prematurely
+ * @retval  LCR4500_SEQUENCE_VALIDATION_FAILED              The DLPC350 rejected the lookup table
+ * @retval  LCR4500_PATTERN_SEQUENCE_START_FAILED           The sequence could NOT be started
+ */
+ReturnCode LCr4500::SendStartSequenceLut(const SequenceLut &lut){
+    DLPC350_ContextLock dlpc350_lock(this->dlpc350_context_.get());
+    ReturnCode ret;
+    unsigned int sequence_validation = 0;
+
+    // If A firmware upload is in progress return error
+    if(this->FirmwareUploadInProgress()){
+        this->debug_.Msg("Cannot connect because firmware is uploading");
+        return ret.AddError(LCR4500_FIRMWARE_UPLOAD_IN_PROGRESS);
+    }
+
+    // Check that LCr4500 is connected
+    if(!this->isConnected()){
+        // Device NOT connected
+        return ret.AddError(LCR4500_NOT_CONNECTED);
+    }
+
+    // Stop the sequence if something is already running
+    if(DLPC350_PatternDisplay(Pattern::DisplayControl::STOP) < 0)
+        return ret.AddError(LCR4500_PATTERN_DISPLAY_FAILED);
+
+    ret = this->WaitForSequencer(false, "pattern display stop");
+    if(ret.hasErrors()) return ret;
+
+    // If the DLPC350 already holds this validated lookup table only the
+    // sequencer needs to be restarted
+    if(this->sequence_lut_active_ && (this->sequence_lut_active_hash_ == lut.hash)){
+        bool mode_current;
+        if(DLPC350_GetMode(&mode_current)<0)
+            return ret.AddError(LCR4500_GET_OPERATING_MODE_FAILED);
+
+        if(mode_current == OperatingMode::PATTERN_SEQUENCE){
+            this->debug_.Msg("Lookup table already validated, start pattern sequence...");
+            if( DLPC350_PatternDisplay(Pattern::DisplayControl::START) < 0)
+                return ret.AddError(LCR4500_PATTERN_SEQUENCE_START_FAILED);
+
+            // A sequence which does NOT repeat may finish before the status is read
+            if(lut.repeat)
+                ret = this->WaitForSequencer(true, "pattern display start");
+            return ret;
+        }
+    }
+
+    // The lookup table on the DLPC350 is about to be replaced
+    this->sequence_lut_active_ = false;
+
     // Check the image load times if there are more than two images
     // If there are more images than the buffer can hold, only one image is preloaded
-    if( (sequence_image_LUT.size() > LCr4500::BUFFER_IMAGE_SIZE) &&
+    if( (lut.source == Pattern::Source::FLASH_IMAGES) &&
+        (lut.image_lut.size() > LCr4500::BUFFER_IMAGE_SIZE) &&
         (this->verify_image_load_.Get() > 0)){
 
         unsigned long long time_since_buffer_swap = 0;  // in microseconds
         unsigned int jImage = 0;
 
-        for(unsigned int iPat = 0; iPat < sequence_LUT.size(); iPat++){
+        // The display was stopped above so the image loads can be measured
+        for(unsigned int iPat = 0; iPat < lut.pattern_lut.size(); iPat++){
 
             // Check for bufferswap (do NOT check first pattern because that flash index is always preloaded)
-            if(sequence_LUT.at(iPat).buffer_swap && iPat > 0){
+            if(lut.pattern_lut.at(iPat).buffer_swap && iPat > 0){
                 double max_time;
 
                 // Get the average image load time
@@ -1368,18 +1550,24 @@ ReturnCode LCr4500::CreateSendStartSequenceLut(const dlp::Pattern::Sequence &arg
                 // Increment Image index counter
                 jImage++;
             }
-            time_since_buffer_swap = time_since_buffer_swap + sequence_LUT.at(iPat).period;
+            time_since_buffer_swap = time_since_buffer_swap + lut.pattern_lut.at(iPat).period;
         }
     }
 
-    // Stop the sequence if something is already running
-    if(DLPC350_PatternDisplay(Pattern::DisplayControl::STOP) < 0)
-        return ret.AddError(LCR4500_PATTERN_DISPLAY_FAILED);
-
     // Set power mode to normal
     if(DLPC350_SetPowerMode(PowerStandbyMode::NORMAL) < 0 )
         return ret.AddError(LCR4500_SET_POWER_MODE_FAILED);
 
+    // Video port patterns are received over the parallel interface
+    if(lut.source == Pattern::Source::VIDEO_PORT){
+        if(DLPC350_SetInputSource(Video::InputSource::PARALLEL_INTERFACE,
+                                  this->parallel_port_width_.Get()) < 0)
+            return ret.AddError(LCR4500_SETUP_INPUT_SOURCE_FAILED);
+
+        ret = this->WaitForStatus("set input source");
+        if(ret.hasErrors()) return ret;
+    }
+
     // Change device to pattern sequence mode
 
     // Check the current mode
@@ -1391,11 +1579,10 @@ ReturnCode LCr4500::CreateSendStartSequenceLut(const dlp::Pattern::Sequence &arg
     if(mode_previous != OperatingMode::PATTERN_SEQUENCE){
         if(DLPC350_SetMode(OperatingMode::PATTERN_SEQUENCE) < 0)
             return ret.AddError(LCR4500_SET_OPERATING_MODE_FAILED);
-    }
 
-    dlp::Time::Sleep::Milliseconds(10);
-    if(DLPC350_GetStatus(&this->status_hw_,&this->status_sys_,&this->status_main_)<0)
-        return ret.AddError("LCR4500_GET_STATUS_FAILED - get mode or set mode");
+        ret = this->WaitForOperatingMode(OperatingMode::PATTERN_SEQUENCE);
+        if(ret.hasErrors()) return ret;
+    }
 
     if(DLPC350_SetTrigOutConfig( LCR4500_TRIGGER_OUT_1,
                                  this->trigger_out_1_invert_.Get(),
@@ -1403,9 +1590,8 @@ ReturnCode LCr4500::CreateSendStartSequenceLut(const dlp::Pattern::Sequence &arg
                                  this->trigger_out_1_falling_.Get())< 0)
         return ret.AddError(LCR4500_SET_TRIGGER_OUTPUT_CONFIG_FAILED);
 
-    dlp::Time::Sleep::Milliseconds(10);
-    if(DLPC350_GetStatus(&this->status_hw_,&this->status_sys_,&this->status_main_)<0)
-        return ret.AddError("LCR4500_GET_STATUS_FAILED - set trigger out config 1");
+    ret = this->WaitForStatus("set trigger out config 1");
+    if(ret.hasErrors()) return ret;
 
 
     if(DLPC350_SetTrigOutConfig( LCR4500_TRIGGER_OUT_2,
@@ -1414,47 +1600,49 @@ ReturnCode LCr4500::CreateSendStartSequenceLut(const dlp::Pattern::Sequence &arg
                                  0)< 0)
         return ret.AddError(LCR4500_SET_TRIGGER_OUTPUT_CONFIG_FAILED);
 
-    dlp::Time::Sleep::Milliseconds(10);
-    if(DLPC350_GetStatus(&this->status_hw_,&this->status_sys_,&this->status_main_)<0)
-        return ret.AddError("LCR4500_GET_STATUS_FAILED - set trigger out config 2");
+    ret = this->WaitForStatus("set trigger out config 2");
+    if(ret.hasErrors()) return ret;
 
     // Clear the LUT
     DLPC350_ClearExpLut();  // Hardcoded return value
 
     // Send the add the LUT entries
-    for(unsigned int iEntry = 0; iEntry < sequence_LUT.size(); iEntry++ ){
-        if(DLPC350_AddToExpLut(sequence_LUT.at(iEntry).trigger_type,
-                               sequence_LUT.at(iEntry).pattern_number,
-                               sequence_LUT.at(iEntry).bit_depth,
-                               sequence_LUT.at(iEntry).LED_select,
-                               sequence_LUT.at(iEntry).invert_pattern,
-                               sequence_LUT.at(iEntry).insert_black,
-                               sequence_LUT.at(iEntry).buffer_swap,
-                               sequence_LUT.at(iEntry).trigger_out_share_prev,
-                               sequence_LUT.at(iEntry).exposure,
-                               sequence_LUT.at(iEntry).period)<0)
+    for(unsigned int iEntry = 0; iEntry < lut.pattern_lut.size(); iEntry++ ){
+        if(DLPC350_AddToExpLut(lut.pattern_lut.at(iEntry).trigger_type,
+                               lut.pattern_lut.at(iEntry).pattern_number,
+                               lut.pattern_lut.at(iEntry).bit_depth,
+                               lut.pattern_lut.at(iEntry).LED_select,
+                               lut.pattern_lut.at(iEntry).invert_pattern,
+                               lut.pattern_lut.at(iEntry).insert_black,
+                               lut.pattern_lut.at(iEntry).buffer_swap,
+                               lut.pattern_lut.at(iEntry).trigger_out_share_prev,
+                               lut.pattern_lut.at(iEntry).exposure,
+                               lut.pattern_lut.at(iEntry).period)<0)
             return ret.AddError(LCR4500_ADD_EXP_LUT_ENTRY_FAILED);
     }
 
-    // Currently only flash image source sequences are supported in this LCr4500 module
-    // Set device to use flash images
-    if(DLPC350_SetPatternDisplayMode(LCr4500::Pattern::Source::FLASH_IMAGES)<0)
+    // Set device to use flash images or the video port
+    if(DLPC350_SetPatternDisplayMode(lut.source == LCr4500::Pattern::Source::VIDEO_PORT)<0)
         return ret.AddError(LCR4500_SET_PATTERN_DISPLAY_MODE_FAILED);
 
-    // Get the pattern sequence display mode (play once or repeat)
-    Parameters::PatternSequenceRepeat repeat_sequence;
-    sequence_to_project.parameters.Get(&repeat_sequence);
-
     // Set the trigger mode
     this->debug_.Msg("Set pattern trigger mode...");
-    if(DLPC350_SetPatternTriggerMode(LCr4500::Pattern::TriggerMode::MODE_3_EXP_INT_OR_EXT)<0)
-        return ret.AddError(LCR4500_SET_PATTERN_TRIGGER_MODE_FAILED);
+    if(lut.source == LCr4500::Pattern::Source::VIDEO_PORT){
+        // Each frame starts on VSYNC
+        if(DLPC350_SetPatternTriggerMode(LCr4500::Pattern::TriggerMode::MODE_4_EXP_VSYNC)<0)
+            return ret.AddError(LCR4500_SET_PATTERN_TRIGGER_MODE_FAILED);
+    }
+    else{
+        if(DLPC350_SetPatternTriggerMode(LCr4500::Pattern::TriggerMode::MODE_3_EXP_INT_OR_EXT)<0)
+            return ret.AddError(LCR4500_SET_PATTERN_TRIGGER_MODE_FAILED);
 
-    // Send the image LUT
-    this->debug_.Msg("Sending image lookup table...");
-    if(DLPC350_SendVarExpImageLut( sequence_image_LUT.data(),
-                                sequence_image_LUT.size())<0)
-        return ret.AddError(LCR4500_SEND_EXP_IMAGE_LUT_FAILED);
+        // Send the image LUT, video port sequences do NOT use one
+        this->debug_.Msg("Sending image lookup table...");
+        std::vector<unsigned char> image_lut = lut.image_lut;
+        if(DLPC350_SendVarExpImageLut( image_lut.data(),
+                                       image_lut.size())<0)
+            return ret.AddError(LCR4500_SEND_EXP_IMAGE_LUT_FAILED);
+    }
 
     // Send the pattern LUT
     this->debug_.Msg("Sending extended pattern lookup table...");
@@ -1463,37 +1651,18 @@ ReturnCode LCr4500::CreateSendStartSequenceLut(const dlp::Pattern::Sequence &arg
 
     // Setup the pattern sequence
     this->debug_.Msg("Configure pattern sequence...");
-    if(temp_pattern.color != dlp::Pattern::Color::RGB){
-        if(DLPC350_SetVarExpPatternConfig(sequence_LUT.size(),
-                                          sequence_LUT.size(),
-                                          sequence_image_LUT.size(),
-										  repeat_sequence.Get())<0)
-            return ret.AddError(LCR4500_SET_VAR_EXP_PATTERN_CONFIG_FAILED);
-    }
-    else{
-        // Adjust the number of patterns to display because the green and blue
-        // patterns share their trigger with the red.
-        if(DLPC350_SetVarExpPatternConfig(sequence_LUT.size(),
-                                          sequence_LUT.size()/3,
-                                          sequence_image_LUT.size(),
-										  repeat_sequence.Get())<0)
-            return ret.AddError(LCR4500_SET_VAR_EXP_PATTERN_CONFIG_FAILED);
-    }
+    if(DLPC350_SetVarExpPatternConfig(lut.pattern_lut.size(),
+                                      lut.pattern_count,
+                                      lut.image_lut.size(),
+                                      lut.repeat)<0)
+        return ret.AddError(LCR4500_SET_VAR_EXP_PATTERN_CONFIG_FAILED);
 
     // Validate the sequence
     if(DLPC350_StartPatLutValidate() < 0)
         return ret.AddError(LCR4500_PATTERN_SEQUENCE_VALIDATION_FAILED);
 
-
-    dlp::Time::Sleep::Milliseconds(100);
-
-    bool dlpc350_ready = false;
-
-    while(!dlpc350_ready){
-        dlp::Time::Sleep::Milliseconds(10);
-        if(DLPC350_CheckPatLutValidate(&dlpc350_ready,&sequence_validation) < 0)
-            return ret.AddError(LCR4500_PATTERN_SEQUENCE_VALIDATION_FAILED);
-    }
+    ret = this->WaitForSequenceValidation(&sequence_validation);
+    if(ret.hasErrors()) return ret;
 
 
     // Display validation data if there was an error
@@ -1530,18 +1699,58 @@ ReturnCode LCr4500::CreateSendStartSequenceLut(const dlp::Pattern::Sequence &arg
     }
 
 
-    dlp::Time::Sleep::Milliseconds(10);
+    // Note which lookup table the DLPC350 has validated
+    this->sequence_lut_active_      = true;
+    this->sequence_lut_active_hash_ = lut.hash;
+
     this->debug_.Msg("Start pattern sequence...");
     if( DLPC350_PatternDisplay(Pattern::DisplayControl::START) < 0)
         return ret.AddError(LCR4500_PATTERN_SEQUENCE_START_FAILED);
 
-    dlp::Time::Sleep::Milliseconds(10);
-    if(DLPC350_GetStatus(&this->status_hw_,&this->status_sys_,&this->status_main_)<0)
-        return ret.AddError("LCR4500_GET_STATUS_FAILED - pattern display start");
+    // A sequence which does NOT repeat may finish before the status is read
+    if(lut.repeat)
+        ret = this->WaitForSequencer(true, "pattern display start");
 
     return ret;
 }
 
+/** @brief  Returns a 64-bit FNV-1a hash of the lookup table contents */
+unsigned long long LCr4500::HashSequenceLut(const SequenceLut &lut){
+    unsigned long long hash = 14695981039346656037ULL;
+
+    auto add = [&hash](const unsigned long long &value){
+        for(unsigned int iByte = 0; iByte < sizeof(value); iByte++){
+            hash ^= (value >> (8*iByte)) & 0xFF;
+            hash *= 1099511628211ULL;
+        }
+    };
+
+    add(lut.repeat);
+    add(lut.source);
+    add(lut.pattern_count);
+    add(lut.pattern_lut.size());
+    for(unsigned int iEntry = 0; iEntry < lut.pattern_lut.size(); iEntry++){
+        const LCR4500_LUT_Entry &entry = lut.pattern_lut.at(iEntry);
+        add(entry.trigger_type);
+        add(entry.pattern_number);
+        add(entry.bit_depth);
+        add(entry.LED_select);
+        add(entry.invert_pattern);
+        add(entry.insert_black);
+        add(entry.buffer_swap);
+        add(entry.trigger_out_share_prev);
+        add(entry.exposure);
+        add(entry.period);
+    }
+
+    add(lut.image_lut.size());
+    for(unsigned int iImage = 0; iImage < lut.image_lut.size(); iImage++){
+        add(lut.image_lut.at(iImage));
+    }
+
+    return hash;
+}
+
 /** @brief  Creates a sequence of patterns and firmware images for the LightCrafter 4500,
  *          then uploads the new firmware
  * @param[in]   arg_pattern_sequence    object of \ref dlp::Pattern::Sequence type containing sequence
@@ -1554,6 +1763,7 @@ ReturnCode LCr4500::CreateSendStartSequenceLut(const dlp::Pattern::Sequence &arg
  * @retval  PATTERN_SEQUENCE_PATTERN_TYPES_NOT_EQUAL    The pattern types are NOT equal for each pattern in the sequence
  */
 ReturnCode LCr4500::PreparePatternSequence(const dlp::Pattern::Sequence &pattern_sequence){
+    DLPC350_ContextLock dlpc350_lock(this->dlpc350_context_.get());
     ReturnCode   ret;
     unsigned int sequnce_count = pattern_sequence.GetCount();
 
@@ -1576,10 +1786,8 @@ ReturnCode LCr4500::PreparePatternSequence(const dlp::Pattern::Sequence &pattern
     if(sequnce_count == 0)
         return ret.AddError(PATTERN_SEQUENCE_EMPTY);
 
-    // Reset these values since pattern LUT will be updated
-    this->previous_sequence_start_    = 0;
-    this->previous_sequence_patterns_ = 0;
-    this->previous_sequence_repeat_   = false;
+    // Lookup tables in the bank refer to the previous sequence
+    this->ClearSequenceBank();
 
     // Check that all pattern types are equal
     if(!pattern_sequence.EqualDataTypes())
@@ -1632,9 +1840,8 @@ ReturnCode LCr4500::PreparePatternSequence(const dlp::Pattern::Sequence &pattern
         if(DLPC350_PatternDisplay(Pattern::DisplayControl::STOP) < 0)
             return ret.AddError(LCR4500_PATTERN_DISPLAY_FAILED);
 
-        dlp::Time::Sleep::Milliseconds(10);
-        if(DLPC350_GetStatus(&this->status_hw_,&this->status_sys_,&this->status_main_)<0)
-            return ret.AddError(LCR4500_GET_STATUS_FAILED);
+        ret = this->WaitForSequencer(false, "pattern display stop");
+        if(ret.hasErrors()) return ret;
 
         // Change device to pattern sequence mode
         if(DLPC350_SetPowerMode(PowerStandbyMode::NORMAL)<0)
@@ -1643,9 +1850,8 @@ ReturnCode LCr4500::PreparePatternSequence(const dlp::Pattern::Sequence &pattern
         if(DLPC350_SetMode(OperatingMode::PATTERN_SEQUENCE)<0)
             return ret.AddError(LCR4500_SET_OPERATING_MODE_FAILED);
 
-        dlp::Time::Sleep::Milliseconds(10);
-        if(DLPC350_GetStatus(&this->status_hw_,&this->status_sys_,&this->status_main_)<0)
-            return ret.AddError(LCR4500_GET_STATUS_FAILED);
+        ret = this->WaitForOperatingMode(OperatingMode::PATTERN_SEQUENCE);
+        if(ret.hasErrors()) return ret;
 
         break;
     }
@@ -1655,6 +1861,7 @@ ReturnCode LCr4500::PreparePatternSequence(const dlp::Pattern::Sequence &pattern
         break;
     }
 
+    this->pattern_sequence_source_   = Pattern::Source::FLASH_IMAGES;
     this->pattern_sequence_prepared_ = true;
 
     return ret;
@@ -1667,56 +1874,21 @@ ReturnCode LCr4500::PreparePatternSequence(const dlp::Pattern::Sequence &pattern
  *  @retval     LCR4500_IN_CALIBRATION_MODE             The LightCrafter 4500 is in calibration mode and the sequence cannot be started
  */
 ReturnCode LCr4500::StartPatternSequence(const unsigned int &start, const unsigned int &patterns, const bool &repeat){
+    DLPC350_ContextLock dlpc350_lock(this->dlpc350_context_.get());
     ReturnCode ret;
+    std::chrono::steady_clock::time_point switch_start = std::chrono::steady_clock::now();
 
-    // Check that sequence has been prepared and that it is NOT a calibration sequence
-    if(!this->pattern_sequence_prepared_ )      return ret.AddError(LCR4500_PATTERN_SEQUENCE_NOT_PREPARED);
-
-    // Check that sequence is NOT too long
-    if(patterns > LCr4500::PATTERN_LUT_SIZE)
-        return ret.AddError(PATTERN_SEQUENCE_TOO_LONG);
-
-    // Check  that the indices are NOT out of range
-    if((start + patterns) > this->pattern_sequence_.GetCount())
-        return ret.AddError(PATTERN_SEQUENCE_INDEX_OUT_OF_RANGE);
-
-
-    if((start    != this->previous_sequence_start_)    ||
-       (patterns != this->previous_sequence_patterns_) ||
-       (repeat   != this->previous_sequence_repeat_)){
-
-
-        // Create the sequence
-        dlp::Pattern::Sequence sequence;
-        for(unsigned int iPat = start; iPat < start+patterns; iPat++){
-            dlp::Pattern temp;
-
-            // Get the pattern
-            this->pattern_sequence_.Get(iPat,&temp);
-            
-            // Add it to new sequence
-            sequence.Add(temp);
-        }
-
-        // Add repeat requence command if needed
-        sequence.parameters.Set(Parameters::PatternSequenceRepeat(repeat));
-
-        // Load and start the sequence
-        ret = this->CreateSendStartSequenceLut(sequence);
+    // Create or find the lookup tables and start them
+    unsigned int sequence_id;
+    ret = this->StoreSequence(start, patterns, repeat, &sequence_id);
+    if(ret.hasErrors()) return ret;
 
-        this->previous_sequence_start_    = start;
-        this->previous_sequence_patterns_ = patterns;
-        this->previous_sequence_repeat_   = repeat;
-    }
-    else{
-        this->debug_.Msg("Start pattern sequence...");
-        if( DLPC350_PatternDisplay(Pattern::DisplayControl::START) < 0)
-            return ret.AddError(LCR4500_PATTERN_SEQUENCE_START_FAILED);
+    ret = this->RecallSequence(sequence_id);
+    if(ret.hasErrors()) return ret;
 
-        dlp::Time::Sleep::Milliseconds(10);
-        if(DLPC350_GetStatus(&this->status_hw_,&this->status_sys_,&this->status_main_)<0)
-            return ret.AddError("LCR4500_GET_STATUS_FAILED - pattern display start");
-    }
+    // Record how long it took for the new sequence to start
+    this->sequence_switch_time_us_ = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - switch_start).count();
+    this->debug_.Msg("Sequence switch took " + dlp::Number::ToString(this->sequence_switch_time_us_) + " us");
 
     return ret;
 }
@@ -1770,6 +1942,7 @@ ReturnCode LCr4500::DisplayPatternInSequence(const unsigned int &pattern_index,
  *  @retval  LCR4500_NOT_CONNECTED   The LightCrafter 4500 EVM is NOT connected
  */
 ReturnCode LCr4500::StopPatternSequence(){
+    DLPC350_ContextLock dlpc350_lock(this->dlpc350_context_.get());
     ReturnCode ret;
 
     // Check that LCr4500 is connected
@@ -1782,9 +1955,260 @@ ReturnCode LCr4500::StopPatternSequence(){
     if(DLPC350_PatternDisplay(Pattern::DisplayControl::STOP) < 0)
         return ret.AddError(LCR4500_PATTERN_DISPLAY_FAILED);
 
-    dlp::Time::Sleep::Milliseconds(10);
-    if(DLPC350_GetStatus(&this->status_hw_,&this->status_sys_,&this->status_main_)<0)
-        return ret.AddError(LCR4500_GET_STATUS_FAILED);
+    ret = this->WaitForSequencer(false, "pattern display stop");
+
+    return ret;
+}
+
+/** @brief      Creates the lookup tables for part of the prepared pattern
+ *              sequence and stores them in the sequence bank
+ *
+ *  Lookup tables are only created once for each start, pattern count, and
+ *  repeat combination. Ranges which result in identical tables share the
+ *  same identifier. No commands are sent to the DLPC350.
+ *
+ *  @param[in]  start       Index of the first prepared pattern
+ *  @param[in]  patterns    Number of patterns
+ *  @param[in]  repeat      If true, the sequence repeats after completing
+ *  @param[out] sequence_id Pointer to return the identifier used with \ref LCr4500::RecallSequence()
+ *  @warning    Must call \ref LCr4500::PreparePatternSequence() before using this method
+ *  @retval     LCR4500_NULL_POINTER_ARGUMENT           Return argument is NULL
+ *  @retval     LCR4500_PATTERN_SEQUENCE_NOT_PREPARED   The pattern sequence has NOT been prepared and sent to the LightCrafter 4500
+ *  @retval     PATTERN_SEQUENCE_TOO_LONG               The pattern sequence excedes the supported number of patterns
+ *  @retval     PATTERN_SEQUENCE_INDEX_OUT_OF_RANGE     The requested patterns are NOT in the prepared sequence
+ */
+ReturnCode LCr4500::StoreSequence(const unsigned int &start, const unsigned int &patterns, const bool &repeat, unsigned int *sequence_id){
+    DLPC350_ContextLock dlpc350_lock(this->dlpc350_context_.get());
+    ReturnCode ret;
+
+    // Check that the return pointer is NOT NULL
+    if(!sequence_id)
+        return ret.AddError(LCR4500_NULL_POINTER_ARGUMENT);
+
+    // Check that sequence has been prepared and that it is NOT a calibration sequence
+    if(!this->pattern_sequence_prepared_ )      return ret.AddError(LCR4500_PATTERN_SEQUENCE_NOT_PREPARED);
+
+    // Check that sequence is NOT too long
+    if(patterns > LCr4500::PATTERN_LUT_SIZE)
+        return ret.AddError(PATTERN_SEQUENCE_TOO_LONG);
+
+    // Check  that the indices are NOT out of range
+    if((start + patterns) > this->pattern_sequence_.GetCount())
+        return ret.AddError(PATTERN_SEQUENCE_INDEX_OUT_OF_RANGE);
+
+    // Check if these patterns have already been stored
+    for(unsigned int iKey = 0; iKey < this->sequence_lut_keys_.size(); iKey++){
+        const SequenceLutKey &stored = this->sequence_lut_keys_.at(iKey);
+        if((stored.start    == start)    &&
+           (stored.patterns == patterns) &&
+           (stored.repeat   == repeat)){
+            (*sequence_id) = stored.sequence_id;
+            return ret;
+        }
+    }
+
+    // Create the sequence
+    dlp::Pattern::Sequence sequence;
+    for(unsigned int iPat = start; iPat < start+patterns; iPat++){
+        dlp::Pattern temp;
+
+        // Get the pattern
+        this->pattern_sequence_.Get(iPat,&temp);
+
+        // Add it to new sequence
+        sequence.Add(temp);
+    }
+
+    // Add repeat requence command if needed
+    sequence.parameters.Set(Parameters::PatternSequenceRepeat(repeat));
+
+    // Create the lookup tables
+    SequenceLut lut;
+    ret = this->CreateSequenceLut(sequence, &lut);
+    if(ret.hasErrors()) return ret;
+
+    lut.start    = start;
+    lut.patterns = patterns;
+
+    SequenceLutKey key;
+    key.start    = start;
+    key.patterns = patterns;
+    key.repeat   = repeat;
+
+    // Reuse an identical lookup table if one has been stored
+    for(unsigned int iLut = 0; iLut < this->sequence_lut_bank_.size(); iLut++){
+        if(this->sequence_lut_bank_.at(iLut).hash == lut.hash){
+            key.sequence_id = iLut;
+            this->sequence_lut_keys_.push_back(key);
+
+            (*sequence_id) = iLut;
+            return ret;
+        }
+    }
+
+    this->sequence_lut_bank_.push_back(std::move(lut));
+    (*sequence_id) = this->sequence_lut_bank_.size() - 1;
+
+    key.sequence_id = (*sequence_id);
+    this->sequence_lut_keys_.push_back(key);
+
+    this->debug_.Msg("Stored sequence " + dlp::Number::ToString(*sequence_id));
+
+    return ret;
+}
+
+/** @brief      Starts a sequence previously stored with \ref LCr4500::StoreSequence()
+ *
+ *  If the sequence is the one most recently validated by the DLPC350, only
+ *  the start command is sent. Otherwise the lookup tables are uploaded and
+ *  validated before starting.
+ *
+ *  @param[in]  sequence_id     Identifier returned by \ref LCr4500::StoreSequence()
+ *  @retval     LCR4500_SEQUENCE_ID_INVALID     No sequence has been stored with this identifier
+ */
+ReturnCode LCr4500::RecallSequence(const unsigned int &sequence_id){
+    DLPC350_ContextLock dlpc350_lock(this->dlpc350_context_.get());
+    ReturnCode ret;
+
+    // Check that the sequence exists
+    if(sequence_id >= this->sequence_lut_bank_.size())
+        return ret.AddError(LCR4500_SEQUENCE_ID_INVALID);
+
+    ret = this->SendStartSequenceLut(this->sequence_lut_bank_.at(sequence_id));
+
+    return ret;
+}
+
+/** @brief  Removes all lookup tables stored with \ref LCr4500::StoreSequence()
+ *  \note   Previously returned sequence identifiers become invalid
+ */
+void LCr4500::ClearSequenceBank(){
+    this->sequence_lut_bank_.clear();
+    this->sequence_lut_keys_.clear();
+}
+
+/** @brief  Returns the time in microseconds the most recent call to
+ *          \ref LCr4500::StartPatternSequence() took to start the sequence
+ */
+unsigned long long LCr4500::GetSequenceSwitchTime() const{
+    return this->sequence_switch_time_us_;
+}
+
+/** @brief      Polls the DLPC350 status until it reports that initialization is complete
+ *  @param[in]  step    Name of the preceding command used in the error message
+ *  @retval     LCR4500_GET_STATUS_FAILED   The status could NOT be read
+ *  @retval     LCR4500_READY_TIMEOUT       The DLPC350 did NOT become ready within \ref LCr4500::Parameters::ReadyTimeout
+ */
+ReturnCode LCr4500::WaitForStatus(const std::string &step){
+    DLPC350_ContextLock dlpc350_lock(this->dlpc350_context_.get());
+    ReturnCode ret;
+
+    dlp::Time::PollResult result = dlp::Time::WaitUntil([&]() -> dlp::Time::PollResult{
+        if(this->status_reader_.GetStatus(&this->status_hw_,&this->status_sys_,&this->status_main_) < 0)
+            return dlp::Time::PollResult::FAILED;
+
+        // Hardware status BIT0 is set once the DLPC350 has initialized
+        if((this->status_hw_ & BIT0) != BIT0)
+            return dlp::Time::PollResult::NOT_READY;
+
+        return dlp::Time::PollResult::READY;
+    }, (unsigned long long) this->ready_timeout_.Get() * 1000);
+
+    if(result == dlp::Time::PollResult::FAILED)
+        return ret.AddError(std::string(LCR4500_GET_STATUS_FAILED) + " - " + step);
+
+    if(result == dlp::Time::PollResult::NOT_READY)
+        return ret.AddError(std::string(LCR4500_READY_TIMEOUT) + " - " + step);
+
+    return ret;
+}
+
+/** @brief      Polls the DLPC350 until it reports the requested operating mode
+ *  @param[in]  mode    \ref LCr4500::OperatingMode to wait for
+ *  @retval     LCR4500_GET_OPERATING_MODE_FAILED   The mode could NOT be read
+ *  @retval     LCR4500_READY_TIMEOUT               The mode did NOT change within \ref LCr4500::Parameters::ReadyTimeout
+ */
+ReturnCode LCr4500::WaitForOperatingMode(const bool &mode){
+    DLPC350_ContextLock dlpc350_lock(this->dlpc350_context_.get());
+    ReturnCode ret;
+
+    dlp::Time::PollResult result = dlp::Time::WaitUntil([&]() -> dlp::Time::PollResult{
+        bool mode_current;
+
+        if(this->status_reader_.GetMode(&mode_current) < 0)
+            return dlp::Time::PollResult::FAILED;
+
+        if(mode_current != mode)
+            return dlp::Time::PollResult::NOT_READY;
+
+        return dlp::Time::PollResult::READY;
+    }, (unsigned long long) this->ready_timeout_.Get() * 1000);
+
+    if(result == dlp::Time::PollResult::FAILED)
+        return ret.AddError(LCR4500_GET_OPERATING_MODE_FAILED);
+
+    if(result == dlp::Time::PollResult::NOT_READY)
+        return ret.AddError(std::string(LCR4500_READY_TIMEOUT) + " - set mode");
+
+    return ret;
+}
+
+/** @brief      Polls the DLPC350 status until the sequencer is running or stopped
+ *  @param[in]  running     If true wait for the sequencer to run, otherwise wait for it to stop
+ *  @param[in]  step        Name of the preceding command used in the error message
+ *  @retval     LCR4500_GET_STATUS_FAILED   The status could NOT be read
+ *  @retval     LCR4500_READY_TIMEOUT       The sequencer did NOT change state within \ref LCr4500::Parameters::ReadyTimeout
+ */
+ReturnCode LCr4500::WaitForSequencer(const bool &running, const std::string &step){
+    DLPC350_ContextLock dlpc350_lock(this->dlpc350_context_.get());
+    ReturnCode ret;
+
+    dlp::Time::PollResult result = dlp::Time::WaitUntil([&]() -> dlp::Time::PollResult{
+        if(this->status_reader_.GetStatus(&this->status_hw_,&this->status_sys_,&this->status_main_) < 0)
+            return dlp::Time::PollResult::FAILED;
+
+        // Main status BIT1 is the sequencer run flag
+        if(((this->status_main_ & BIT1) == BIT1) != running)
+            return dlp::Time::PollResult::NOT_READY;
+
+        return dlp::Time::PollResult::READY;
+    }, (unsigned long long) this->ready_timeout_.Get() * 1000);
+
+    if(result == dlp::Time::PollResult::FAILED)
+        return ret.AddError(std::string(LCR4500_GET_STATUS_FAILED) + " - " + step);
+
+    if(result == dlp::Time::PollResult::NOT_READY)
+        return ret.AddError(std::string(LCR4500_READY_TIMEOUT) + " - " + step);
+
+    return ret;
+}
+
+/** @brief      Polls the DLPC350 until the pattern lookup table validation has finished
+ *  @param[out] sequence_validation     Pointer to return the validation flags
+ *  @retval     LCR4500_PATTERN_SEQUENCE_VALIDATION_FAILED  The validation status could NOT be read
+ *  @retval     LCR4500_READY_TIMEOUT                       Validation did NOT finish within \ref LCr4500::Parameters::ReadyTimeout
+ */
+ReturnCode LCr4500::WaitForSequenceValidation(unsigned int *sequence_validation){
+    DLPC350_ContextLock dlpc350_lock(this->dlpc350_context_.get());
+    ReturnCode ret;
+
+    dlp::Time::PollResult result = dlp::Time::WaitUntil([&]() -> dlp::Time::PollResult{
+        bool dlpc350_ready = false;
+
+        if(this->status_reader_.CheckPatLutValidate(&dlpc350_ready, sequence_validation) < 0)
+            return dlp::Time::PollResult::FAILED;
+
+        if(!dlpc350_ready)
+            return dlp::Time::PollResult::NOT_READY;
+
+        return dlp::Time::PollResult::READY;
+    }, (unsigned long long) this->ready_timeout_.Get() * 1000);
+
+    if(result == dlp::Time::PollResult::FAILED)
+        return ret.AddError(LCR4500_PATTERN_SEQUENCE_VALIDATION_FAILED);
+
+    if(result == dlp::Time::PollResult::NOT_READY)
+        return ret.AddError(std::string(LCR4500_READY_TIMEOUT) + " - sequence validation");
 
     return ret;
 }
@@ -1863,6 +2287,7 @@ int LCr4500::DlpPatternBitdepthToLCr4500Bitdepth(const dlp::Pattern::Bitdepth &d
  * @retval  LCR4500_FIRMWARE_CHECKSUM_MISMATCH                  The uploaded firmware's checksum does NOT match the firmware on the LightCrafter 4500
  */
 ReturnCode LCr4500::UploadFirmware(std::string firmware_filename){
+    DLPC350_ContextLock dlpc350_lock(this->dlpc350_context_.get());
     ReturnCode ret;
 
     std::string flash_parameters_filename = this->dlpc350_flash_parameters_.Get();
@@ -1879,6 +2304,8 @@ ReturnCode LCr4500::UploadFirmware(std::string firmware_filename){
 
 
     this->pattern_sequence_prepared_     = false;
+    this->sequence_lut_active_           = false;
+    this->ClearSequenceBank();
 
     this->firmware_upload_restart_needed = false;
 
@@ -2283,6 +2710,8 @@ int LCr4500::GetSectorNum(unsigned int Addr)
  * @retval  LCR4500_IMAGE_FILE_FORMAT_INVALID           The file formats of the images in the input vector are invalid
  */
 ReturnCode LCr4500::CreateFirmware(const std::string &new_firmware_filename, const std::vector<std::string> &image_filenames){
+    // The firmware builder in dlpc350_firmware.cpp uses global buffers
+    std::lock_guard<std::mutex> firmware_lock(firmware_build_mutex);
     ReturnCode ret;
 
 
@@ -2500,6 +2929,7 @@ ReturnCode LCr4500::CreateFirmware(const std::string &new_firmware_filename, con
  * @retval  LCR4500_READ_FLASH_LOAD_TIMING_FAILED       The time for loading the image could NOT be read
  */
 ReturnCode LCr4500::GetImageLoadTime(const unsigned int &index, const unsigned int &load_count, double *max_microseconds){
+    DLPC350_ContextLock dlpc350_lock(this->dlpc350_context_.get());
     ReturnCode ret;
 
     // Check that LCr4500 is connected
@@ -0,0 +1,754 @@
+/** @file   lcr4500_video.cpp
+ *  @brief  Contains methods to stream pattern sequences to the DLP LightCrafter 4500
+ *          EVM over the video port
+ *  @copyright 2016 Texas Instruments Incorporated - http://www.ti.com/ ALL RIGHTS RESERVED
+ */
+
+#include <GLFW/glfw3.h>
+
+#include <common/returncode.hpp>
+#include <common/debug.hpp>
+#include <common/other.hpp>
+#include <common/image/image.hpp>
+#include <common/parameters.hpp>
+#include <common/pattern/pattern.hpp>
+
+#include <vector>
+#include <string>
+#include <atomic>
+#include <future>
+#include <mutex>
+#include <thread>
+
+#include <dlp_platforms/lightcrafter_4500/common.hpp>
+#include <dlp_platforms/lightcrafter_4500/dlpc350_usb.hpp>
+#include <dlp_platforms/dlp_platform.hpp>
+#include <dlp_platforms/lightcrafter_4500/lcr4500.hpp>
+
+/** @brief  Contains all DLP SDK classes, functions, etc. */
+namespace dlp{
+
+/** @brief      Finds the bitplanes for each color channel of a pattern in the current frame
+ *
+ *  All channels of an RGB pattern are placed in the same frame so that
+ *  the VSYNC which starts the pattern also delivers all of its data.
+ *
+ * @param[in]   start           First free bitplane in the frame
+ * @param[in]   bpp             Bits per pixel of each channel
+ * @param[in]   channels        Number of color channels (1 or 3)
+ * @param[out]  positions       First bitplane of each channel
+ * @param[out]  numbers         DLPC350 pattern number of each channel
+ * @return      false if the channels do NOT fit in the remaining bitplanes
+ */
+static bool FindVideoBitplanes(const unsigned char &start,
+                               const unsigned char &bpp,
+                               const unsigned int  &channels,
+                               unsigned char *positions,
+                               unsigned char *numbers){
+    unsigned char position = start;
+
+    for(unsigned int iChannel = 0; iChannel < channels; iChannel++){
+        while(!LCr4500::StartPatternImageStorage(position, bpp, numbers[iChannel])){
+            position++;
+            if(position > 23) return false;
+        }
+
+        if((position + bpp) > 24) return false;
+
+        positions[iChannel] = position;
+        position = position + bpp;
+    }
+
+    return true;
+}
+
+/** @brief      Returns the first bitplane used by a DLPC350 pattern number
+ * @return      false if the pattern number is NOT valid for the bit depth
+ */
+static bool GetVideoBitplane(const unsigned char &bpp,
+                             const unsigned int  &pattern_number,
+                             unsigned char *position){
+    unsigned char number = 0;
+
+    for(unsigned char iBit = 0; iBit < 24; iBit++){
+        if(LCr4500::StartPatternImageStorage(iBit, bpp, number) &&
+           (number == pattern_number) &&
+           ((iBit + bpp) <= 24)){
+            (*position) = iBit;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/** @brief  Converts the packed 24 bitplanes to a RGB frame
+ *
+ *  The DLPC350 reads bitplanes 0-7 from green, 8-15 from red, and 16-23
+ *  from blue. This is the same layout used for firmware images.
+ */
+static void CreateVideoFrame(const std::vector<unsigned int> &bitplanes,
+                             const unsigned int &columns,
+                             const unsigned int &rows,
+                             dlp::Image *frame){
+    cv::Mat frame_data;
+
+    frame->Create(columns, rows, dlp::Image::Format::RGB_UCHAR);
+    frame->Unsafe_GetOpenCVData(&frame_data);
+
+    dlp::Thread::ParallelFor(0, rows, [&](unsigned long long first, unsigned long long last){
+        for(unsigned long long yRow = first; yRow < last; yRow++){
+            const unsigned int *bits  = &bitplanes[yRow * columns];
+            unsigned char      *pixel = frame_data.ptr<unsigned char>(yRow);
+
+            for(unsigned int xCol = 0; xCol < columns; xCol++){
+                // OpenCV stores the channels as blue, green, red
+                pixel[3*xCol + 0] = (bits[xCol] >> 16) & 0xFF;
+                pixel[3*xCol + 1] = (bits[xCol] >>  0) & 0xFF;
+                pixel[3*xCol + 2] = (bits[xCol] >>  8) & 0xFF;
+            }
+        }
+    }, 16);
+}
+
+/** @brief      Packs a pattern sequence into 24-bit RGB frames for the video port
+ *
+ *  Patterns are placed into the frame bitplanes in order using the same
+ *  layout as \ref LCr4500::CreateFirmwareImages(), so up to 24 binary
+ *  patterns or three 8-bit patterns fit in a frame. Pixel values larger
+ *  than the pattern bit depth allows are clamped to the maximum value.
+ *
+ *  The returned sequence contains \ref dlp::Pattern::DataType::PARAMETERS
+ *  patterns with the frame index stored as the image index and a VSYNC
+ *  trigger on the first pattern of each frame.
+ *
+ * @param[in]   pattern_sequence    Image or image file patterns to pack
+ * @param[in]   columns             Frame width in pixels
+ * @param[in]   rows                Frame height in pixels
+ * @param[out]  frames              Pointer to return the packed RGB frames
+ * @param[out]  frame_sequence      Pointer to return the pattern parameters for each pattern
+ *
+ * @retval  LCR4500_NULL_POINTER_ARGUMENT               Return argument is NULL
+ * @retval  PATTERN_SEQUENCE_EMPTY                      The sequence contains no patterns
+ * @retval  PATTERN_SEQUENCE_PATTERN_TYPES_NOT_EQUAL    The types for the patterns in the sequence do NOT match
+ * @retval  PATTERN_DATA_TYPE_INVALID                   The patterns do NOT contain images or image files
+ * @retval  FILE_DOES_NOT_EXIST                         Image file pointed to by pattern does NOT exist
+ * @retval  PATTERN_BITDEPTH_INVALID                    A pattern bit depth is NOT valid
+ * @retval  LCR4500_IMAGE_RESOLUTION_INVALID            A pattern image is NOT columns x rows
+ * @retval  LCR4500_IMAGE_FORMAT_INVALID                A pattern image is NOT unsigned char data
+ */
+ReturnCode LCr4500::PackVideoFrames(const dlp::Pattern::Sequence &pattern_sequence,
+                                    const unsigned int           &columns,
+                                    const unsigned int           &rows,
+                                    std::vector<dlp::Image>      *frames,
+                                    dlp::Pattern::Sequence       *frame_sequence){
+    ReturnCode ret;
+
+    // Check that the return pointers are NOT NULL
+    if(!frames || !frame_sequence)
+        return ret.AddError(LCR4500_NULL_POINTER_ARGUMENT);
+
+    // Check that sequence is NOT empty
+    if(pattern_sequence.GetCount() == 0)
+        return ret.AddError(PATTERN_SEQUENCE_EMPTY);
+
+    // Check that sequence patterns all have same type
+    if(!pattern_sequence.EqualDataTypes())
+        return ret.AddError(PATTERN_SEQUENCE_PATTERN_TYPES_NOT_EQUAL);
+
+    frames->clear();
+    frame_sequence->Clear();
+
+    std::vector<unsigned int> frame_bitplanes(columns * rows, 0);
+    unsigned int  frame_index   = 0;
+    unsigned char bit_position  = 0;
+    bool          frame_started = false;
+
+    for(unsigned int iPat = 0; iPat < pattern_sequence.GetCount(); iPat++){
+        dlp::Pattern pattern;
+        dlp::Image   pattern_image;
+
+        pattern_sequence.Get(iPat, &pattern);
+
+        // Import the image data
+        if(pattern.data_type == dlp::Pattern::DataType::IMAGE_FILE){
+            if(!dlp::File::Exists(pattern.image_file))
+                return ret.AddError(FILE_DOES_NOT_EXIST);
+
+            ret = pattern_image.Load(pattern.image_file);
+            if(ret.hasErrors()) return ret;
+        }
+        else if(pattern.data_type == dlp::Pattern::DataType::IMAGE_DATA){
+            // Shallow copy of the image data
+            pattern_image = pattern.image_data;
+        }
+        else{
+            return ret.AddError(PATTERN_DATA_TYPE_INVALID);
+        }
+
+        // Check the image resolution
+        unsigned int image_columns = 0;
+        unsigned int image_rows    = 0;
+        pattern_image.GetColumns(&image_columns);
+        pattern_image.GetRows(&image_rows);
+        if((image_columns != columns) || (image_rows != rows))
+            return ret.AddError(LCR4500_IMAGE_RESOLUTION_INVALID);
+
+        // Determine the bitplanes per channel
+        int pattern_bpp = DlpPatternBitdepthToLCr4500Bitdepth(pattern.bitdepth);
+        if((pattern_bpp <= 0) || (pattern_bpp > 8))
+            return ret.AddError(PATTERN_BITDEPTH_INVALID);
+
+        // RGB patterns use three sequential channels
+        unsigned int channels = 1;
+        dlp::Image::Format required_format = dlp::Image::Format::MONO_UCHAR;
+        if(pattern.color == dlp::Pattern::Color::RGB){
+            channels        = 3;
+            required_format = dlp::Image::Format::RGB_UCHAR;
+        }
+        else{
+            pattern_image.ConvertToMonochrome();
+        }
+
+        dlp::Image::Format image_format;
+        pattern_image.GetDataFormat(&image_format);
+        if(image_format != required_format)
+            return ret.AddError(LCR4500_IMAGE_FORMAT_INVALID);
+
+        // Find the bitplanes, or start a new frame if the pattern does NOT fit
+        unsigned char positions[3];
+        unsigned char numbers[3];
+        if(!FindVideoBitplanes(bit_position, pattern_bpp, channels, positions, numbers)){
+            frames->push_back(dlp::Image());
+            CreateVideoFrame(frame_bitplanes, columns, rows, &frames->back());
+
+            std::fill(frame_bitplanes.begin(), frame_bitplanes.end(), 0);
+            frame_index++;
+            bit_position  = 0;
+            frame_started = false;
+
+            // The pattern must fit in an empty frame
+            if(!FindVideoBitplanes(bit_position, pattern_bpp, channels, positions, numbers))
+                return ret.AddError(PATTERN_BITDEPTH_INVALID);
+        }
+
+        // Add the pattern to the frame bitplanes
+        cv::Mat pattern_data;
+        pattern_image.Unsafe_GetOpenCVData(&pattern_data);
+
+        const unsigned int pixel_mask = (1 << pattern_bpp) - 1;
+
+        for(unsigned int iChannel = 0; iChannel < channels; iChannel++){
+            // OpenCV stores RGB images as blue, green, red
+            const unsigned int  channel_offset = (channels == 3) ? (2 - iChannel) : 0;
+            const unsigned char shift          = positions[iChannel];
+
+            dlp::Thread::ParallelFor(0, rows, [&](unsigned long long first, unsigned long long last){
+                for(unsigned long long yRow = first; yRow < last; yRow++){
+                    const unsigned char *pixel = pattern_data.ptr<unsigned char>(yRow);
+                    unsigned int        *bits  = &frame_bitplanes[yRow * columns];
+
+                    for(unsigned int xCol = 0; xCol < columns; xCol++){
+                        unsigned int value = pixel[channels*xCol + channel_offset];
+                        if(value > pixel_mask) value = pixel_mask;
+                        bits[xCol] |= value << shift;
+                    }
+                }
+            }, 16);
+        }
+
+        bit_position = positions[channels-1] + pattern_bpp;
+
+        // Create the parameters pattern
+        dlp::Pattern frame_pattern;
+        frame_pattern.id          = pattern.id;
+        frame_pattern.bitdepth    = pattern.bitdepth;
+        frame_pattern.color       = pattern.color;
+        frame_pattern.exposure    = pattern.exposure;
+        frame_pattern.period      = pattern.period;
+        frame_pattern.orientation = pattern.orientation;
+        frame_pattern.data_type   = dlp::Pattern::DataType::PARAMETERS;
+
+        if(channels == 1){
+            frame_pattern.parameters.Set(Parameters::PatternImageIndex(frame_index));
+            frame_pattern.parameters.Set(Parameters::PatternNumber(numbers[0]));
+        }
+        else{
+            frame_pattern.parameters.Set(Parameters::PatternImageIndexRed(frame_index));
+            frame_pattern.parameters.Set(Parameters::PatternImageIndexGreen(frame_index));
+            frame_pattern.parameters.Set(Parameters::PatternImageIndexBlue(frame_index));
+            frame_pattern.parameters.Set(Parameters::PatternNumberRed(numbers[0]));
+            frame_pattern.parameters.Set(Parameters::PatternNumberGreen(numbers[1]));
+            frame_pattern.parameters.Set(Parameters::PatternNumberBlue(numbers[2]));
+        }
+
+        // The first pattern of each frame waits for VSYNC
+        if(!frame_started){
+            frame_pattern.parameters.Set(Parameters::TriggerSource(Pattern::TriggerSource::EXTERNAL_POSITIVE));
+            frame_started = true;
+        }
+        else{
+            frame_pattern.parameters.Set(Parameters::TriggerSource(Pattern::TriggerSource::NONE));
+        }
+
+        frame_sequence->Add(frame_pattern);
+    }
+
+    // Add the last frame
+    frames->push_back(dlp::Image());
+    CreateVideoFrame(frame_bitplanes, columns, rows, &frames->back());
+
+    frame_sequence->parameters = pattern_sequence.parameters;
+
+    return ret;
+}
+
+/** @brief      Recovers the pattern images from frames created by \ref LCr4500::PackVideoFrames()
+ *
+ *  Monochrome patterns are returned as \ref dlp::Image::Format::MONO_UCHAR
+ *  and RGB patterns as \ref dlp::Image::Format::RGB_UCHAR images with pixel
+ *  values from zero to the maximum of the pattern bit depth.
+ *
+ * @param[in]   frames              Packed RGB frames
+ * @param[in]   frame_sequence      Pattern parameters returned with the frames
+ * @param[out]  pattern_sequence    Pointer to return the image data patterns
+ *
+ * @retval  LCR4500_NULL_POINTER_ARGUMENT           Return argument is NULL
+ * @retval  LCR4500_VIDEO_FRAMES_EMPTY              No frames were supplied
+ * @retval  PATTERN_BITDEPTH_INVALID                A pattern bit depth is NOT valid
+ * @retval  LCR4500_VIDEO_FRAME_SEQUENCE_INVALID    A pattern refers to a frame or bitplane which does NOT exist
+ */
+ReturnCode LCr4500::UnpackVideoFrames(const std::vector<dlp::Image> &frames,
+                                      const dlp::Pattern::Sequence  &frame_sequence,
+                                      dlp::Pattern::Sequence        *pattern_sequence){
+    ReturnCode ret;
+
+    // Check that the return pointer is NOT NULL
+    if(!pattern_sequence)
+        return ret.AddError(LCR4500_NULL_POINTER_ARGUMENT);
+
+    if(frames.empty())
+        return ret.AddError(LCR4500_VIDEO_FRAMES_EMPTY);
+
+    pattern_sequence->Clear();
+
+    for(unsigned int iPat = 0; iPat < frame_sequence.GetCount(); iPat++){
+        dlp::Pattern frame_pattern;
+        frame_sequence.Get(iPat, &frame_pattern);
+
+        int pattern_bpp = DlpPatternBitdepthToLCr4500Bitdepth(frame_pattern.bitdepth);
+        if((pattern_bpp <= 0) || (pattern_bpp > 8))
+            return ret.AddError(PATTERN_BITDEPTH_INVALID);
+
+        // Look up the frame and pattern number of each channel
+        unsigned int channels = 1;
+        unsigned int frame_indices[3];
+        unsigned int pattern_numbers[3];
+
+        if(frame_pattern.color == dlp::Pattern::Color::RGB){
+            Parameters::PatternImageIndexRed    index_red;
+            Parameters::PatternImageIndexGreen  index_green;
+            Parameters::PatternImageIndexBlue   index_blue;
+            Parameters::PatternNumberRed        number_red;
+            Parameters::PatternNumberGreen      number_green;
+            Parameters::PatternNumberBlue       number_blue;
+
+            frame_pattern.parameters.Get(&index_red);
+            frame_pattern.parameters.Get(&index_green);
+            frame_pattern.parameters.Get(&index_blue);
+            frame_pattern.parameters.Get(&number_red);
+            frame_pattern.parameters.Get(&number_green);
+            frame_pattern.parameters.Get(&number_blue);
+
+            channels = 3;
+            frame_indices[0]   = index_red.Get();
+            frame_indices[1]   = index_green.Get();
+            frame_indices[2]   = index_blue.Get();
+            pattern_numbers[0] = number_red.Get();
+            pattern_numbers[1] = number_green.Get();
+            pattern_numbers[2] = number_blue.Get();
+        }
+        else{
+            Parameters::PatternImageIndex index;
+            Parameters::PatternNumber     number;
+
+            frame_pattern.parameters.Get(&index);
+            frame_pattern.parameters.Get(&number);
+
+            frame_indices[0]   = index.Get();
+            pattern_numbers[0] = number.Get();
+        }
+
+        unsigned int columns = 0;
+        unsigned int rows    = 0;
+        frames.at(0).GetColumns(&columns);
+        frames.at(0).GetRows(&rows);
+
+        dlp::Image pattern_image(columns, rows, (channels == 3) ? dlp::Image::Format::RGB_UCHAR :
+                                                                  dlp::Image::Format::MONO_UCHAR);
+        cv::Mat pattern_data;
+        pattern_image.Unsafe_GetOpenCVData(&pattern_data);
+
+        const unsigned int pixel_mask = (1 << pattern_bpp) - 1;
+
+        for(unsigned int iChannel = 0; iChannel < channels; iChannel++){
+            unsigned char position = 0;
+
+            if((frame_indices[iChannel] >= frames.size()) ||
+               (!GetVideoBitplane(pattern_bpp, pattern_numbers[iChannel], &position)))
+                return ret.AddError(LCR4500_VIDEO_FRAME_SEQUENCE_INVALID);
+
+            // The frame is NOT modified, but its OpenCV data is only available shallow through a non-const object
+            dlp::Image frame = frames.at(frame_indices[iChannel]);
+            cv::Mat    frame_data;
+            frame.Unsafe_GetOpenCVData(&frame_data);
+
+            const unsigned int channel_offset = (channels == 3) ? (2 - iChannel) : 0;
+
+            dlp::Thread::ParallelFor(0, rows, [&](unsigned long long first, unsigned long long last){
+                for(unsigned long long yRow = first; yRow < last; yRow++){
+                    const unsigned char *frame_pixel   = frame_data.ptr<unsigned char>(yRow);
+                    unsigned char       *pattern_pixel = pattern_data.ptr<unsigned char>(yRow);
+
+                    for(unsigned int xCol = 0; xCol < columns; xCol++){
+                        unsigned int bits = (((unsigned int) frame_pixel[3*xCol + 0]) << 16) |
+                                            (((unsigned int) frame_pixel[3*xCol + 2]) <<  8) |
+                                            (((unsigned int) frame_pixel[3*xCol + 1]) <<  0);
+
+                        pattern_pixel[channels*xCol + channel_offset] = (bits >> position) & pixel_mask;
+                    }
+                }
+            }, 16);
+        }
+
+        dlp::Pattern pattern;
+        pattern.id          = frame_pattern.id;
+        pattern.bitdepth    = frame_pattern.bitdepth;
+        pattern.color       = frame_pattern.color;
+        pattern.exposure    = frame_pattern.exposure;
+        pattern.period      = frame_pattern.period;
+        pattern.orientation = frame_pattern.orientation;
+        pattern.data_type   = dlp::Pattern::DataType::IMAGE_DATA;
+        pattern.image_data  = pattern_image;
+
+        pattern_sequence->Add(pattern);
+    }
+
+    pattern_sequence->parameters = frame_sequence.parameters;
+
+    return ret;
+}
+
+/** @brief      Prepares a pattern sequence which is streamed over the video port
+ *
+ *  The patterns are packed into RGB frames in memory and no firmware is
+ *  created or uploaded, so changing the sequence only requires new
+ *  lookup tables. Start the sequence with \ref LCr4500::StartPatternSequence()
+ *  while the returned frames are shown with \ref LCr4500::VideoOutput.
+ *
+ * @param[in]   pattern_sequence    Image or image file patterns to display
+ * @param[out]  frames              Pointer to return the frames to stream to the video port
+ *
+ * @retval  LCR4500_NULL_POINTER_ARGUMENT           Return argument is NULL
+ * @retval  LCR4500_FIRMWARE_UPLOAD_IN_PROGRESS     A firmware upload is in progress, do NOT send any commands until upload is complete!
+ * @retval  LCR4500_NOT_CONNECTED                   The LightCrafter 4500 EVM is NOT connected
+ * @retval  DLP_PLATFORM_NOT_SETUP                  The LightCrafter 4500 object has NOT been properly set up
+ * @retval  LCR4500_VIDEO_FRAME_PERIOD_EXCEEDED     The patterns in a frame take longer than \ref LCr4500::Parameters::VideoFramePeriod
+ */
+ReturnCode LCr4500::PrepareVideoPatternSequence(const dlp::Pattern::Sequence &pattern_sequence, std::vector<dlp::Image> *frames){
+    DLPC350_ContextLock dlpc350_lock(this->dlpc350_context_.get());
+    ReturnCode ret;
+
+    // Check that the return pointer is NOT NULL
+    if(!frames)
+        return ret.AddError(LCR4500_NULL_POINTER_ARGUMENT);
+
+    // If A firmware upload is in progress, do NOT send any commands until upload is complete! return error
+    if(this->FirmwareUploadInProgress()){
+        this->debug_.Msg("Cannot prepare sequence because firmware is uploading");
+        return ret.AddError(LCR4500_FIRMWARE_UPLOAD_IN_PROGRESS);
+    }
+
+    // Check that LCr4500 is connected
+    if(!this->isConnected())
+        return ret.AddError(LCR4500_NOT_CONNECTED);
+
+    // Check that DLP_Platform is setup
+    if(!this->isPlatformSetup())
+        return ret.AddError(DLP_PLATFORM_NOT_SETUP);
+
+    // Lookup tables in the bank refer to the previous sequence
+    this->ClearSequenceBank();
+    this->pattern_sequence_prepared_ = false;
+
+    unsigned int dmd_columns = 0;
+    unsigned int dmd_rows    = 0;
+    this->GetColumns(&dmd_columns);
+    this->GetRows(&dmd_rows);
+
+    dlp::Pattern::Sequence frame_sequence;
+    ret = LCr4500::PackVideoFrames(pattern_sequence, dmd_columns, dmd_rows, frames, &frame_sequence);
+    if(ret.hasErrors()) return ret;
+
+    this->debug_.Msg("Packed " + dlp::Number::ToString(frame_sequence.GetCount()) +
+                     " patterns into " + dlp::Number::ToString(frames->size()) + " frames");
+
+    // Check that the patterns of each frame finish before the next VSYNC
+    std::vector<unsigned long long> frame_periods(frames->size(), 0);
+    for(unsigned int iPat = 0; iPat < frame_sequence.GetCount(); iPat++){
+        dlp::Pattern frame_pattern;
+        frame_sequence.Get(iPat, &frame_pattern);
+
+        // Patterns without timing use the period from LCr4500::Setup()
+        unsigned long long period = frame_pattern.period;
+        if((frame_pattern.exposure == 0) || (frame_pattern.period == 0))
+            period = this->sequence_period_.Get();
+
+        unsigned int frame_index = 0;
+        if(frame_pattern.color == dlp::Pattern::Color::RGB){
+            Parameters::PatternImageIndexRed index;
+            frame_pattern.parameters.Get(&index);
+            frame_index = index.Get();
+        }
+        else{
+            Parameters::PatternImageIndex index;
+            frame_pattern.parameters.Get(&index);
+            frame_index = index.Get();
+        }
+
+        frame_periods.at(frame_index) += period;
+        if(frame_periods.at(frame_index) > this->video_frame_period_.Get())
+            return ret.AddError(LCR4500_VIDEO_FRAME_PERIOD_EXCEEDED);
+    }
+
+    this->pattern_sequence_.Clear();
+    this->pattern_sequence_.Add(frame_sequence);
+    this->pattern_sequence_.parameters = frame_sequence.parameters;
+
+    this->pattern_sequence_source_   = Pattern::Source::VIDEO_PORT;
+    this->pattern_sequence_prepared_ = true;
+
+    return ret;
+}
+
+
+/** @brief  Constructs an output which is NOT open */
+LCr4500::VideoOutput::VideoOutput(){
+    this->is_open_      = false;
+    this->close_window_ = false;
+    this->frame_count_  = 0;
+    this->columns_      = 0;
+    this->rows_         = 0;
+    this->frame_index_  = 0;
+    this->repeat_       = false;
+}
+
+/** @brief  Closes the output window */
+LCr4500::VideoOutput::~VideoOutput(){
+    this->Close();
+}
+
+/** @brief      Opens a fullscreen window on a monitor connected to the video port
+ * @param[in]   monitor     Index of the monitor in the GLFW monitor list
+ * @param[in]   columns     Frame width in pixels
+ * @param[in]   rows        Frame height in pixels
+ * @retval      LCR4500_VIDEO_OUTPUT_FAILED     The GLFW window could NOT be created
+ */
+ReturnCode LCr4500::VideoOutput::Open(const unsigned int &monitor, const unsigned int &columns, const unsigned int &rows){
+    ReturnCode ret;
+
+    if(this->isOpen())
+        this->Close();
+
+    this->columns_      = columns;
+    this->rows_         = rows;
+    this->close_window_ = false;
+    this->frame_count_  = 0;
+
+    // Start the display loop and wait until the window has been created
+    std::promise<bool> opened;
+    std::future<bool>  opened_result = opened.get_future();
+
+    this->loop_ = std::thread(&LCr4500::VideoOutput::Loop, this, monitor, &opened);
+
+    if(!opened_result.get()){
+        this->loop_.join();
+        return ret.AddError(LCR4500_VIDEO_OUTPUT_FAILED);
+    }
+
+    this->is_open_ = true;
+
+    return ret;
+}
+
+/** @brief      Replaces the frames being streamed
+ *
+ *  The first frame is shown on the next VSYNC. If repeat is false the
+ *  output turns black after the last frame.
+ *
+ * @param[in]   frames  RGB frames returned by \ref LCr4500::PrepareVideoPatternSequence()
+ * @param[in]   repeat  If true, the frames repeat after the last one
+ * @retval      LCR4500_VIDEO_OUTPUT_NOT_OPEN       The output window has NOT been opened
+ * @retval      LCR4500_VIDEO_FRAMES_EMPTY          No frames were supplied
+ * @retval      LCR4500_IMAGE_RESOLUTION_INVALID    A frame does NOT match the window resolution
+ * @retval      LCR4500_IMAGE_FORMAT_INVALID        A frame is NOT a RGB image
+ */
+ReturnCode LCr4500::VideoOutput::Display(const std::vector<dlp::Image> &frames, const bool &repeat){
+    ReturnCode ret;
+
+    if(!this->isOpen())
+        return ret.AddError(LCR4500_VIDEO_OUTPUT_NOT_OPEN);
+
+    if(frames.empty())
+        return ret.AddError(LCR4500_VIDEO_FRAMES_EMPTY);
+
+    // Convert the frames to bottom-up RGB rows before taking the lock
+    std::vector<std::vector<unsigned char>> frame_rows(frames.size());
+
+    for(unsigned int iFrame = 0; iFrame < frames.size(); iFrame++){
+        unsigned int columns = 0;
+        unsigned int rows    = 0;
+        dlp::Image::Format format;
+
+        frames.at(iFrame).GetColumns(&columns);
+        frames.at(iFrame).GetRows(&rows);
+        frames.at(iFrame).GetDataFormat(&format);
+
+        if((columns != this->columns_) || (rows != this->rows_))
+            return ret.AddError(LCR4500_IMAGE_RESOLUTION_INVALID);
+
+        if(format != dlp::Image::Format::RGB_UCHAR)
+            return ret.AddError(LCR4500_IMAGE_FORMAT_INVALID);
+
+        dlp::Image frame = frames.at(iFrame);
+        cv::Mat    frame_data;
+        frame.Unsafe_GetOpenCVData(&frame_data);
+
+        std::vector<unsigned char> &rgb = frame_rows.at(iFrame);
+        rgb.resize(3 * columns * rows);
+
+        for(unsigned int yRow = 0; yRow < rows; yRow++){
+            const unsigned char *pixel = frame_data.ptr<unsigned char>(yRow);
+            unsigned char       *dest  = &rgb[3 * columns * (rows - 1 - yRow)];
+
+            for(unsigned int xCol = 0; xCol < columns; xCol++){
+                dest[3*xCol + 0] = pixel[3*xCol + 2];
+                dest[3*xCol + 1] = pixel[3*xCol + 1];
+                dest[3*xCol + 2] = pixel[3*xCol + 0];
+            }
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(this->frames_mutex_);
+    this->frames_.swap(frame_rows);
+    this->frame_index_ = 0;
+    this->repeat_      = repeat;
+
+    return ret;
+}
+
+/** @brief  Returns the number of VSYNC periods since the window opened */
+unsigned long long LCr4500::VideoOutput::GetFrameCount() const{
+    return this->frame_count_;
+}
+
+/** @brief  Returns true if the output window is open */
+bool LCr4500::VideoOutput::isOpen() const{
+    return this->is_open_;
+}
+
+/** @brief  Closes the output window and releases the frames */
+void LCr4500::VideoOutput::Close(){
+    this->close_window_ = true;
+
+    if(this->loop_.joinable())
+        this->loop_.join();
+
+    this->is_open_ = false;
+
+    std::lock_guard<std::mutex> lock(this->frames_mutex_);
+    this->frames_.clear();
+    this->frame_index_ = 0;
+}
+
+/** @brief  Creates the GLFW window and shows one frame per buffer swap until closed */
+void LCr4500::VideoOutput::Loop(unsigned int monitor, std::promise<bool> *opened){
+
+    if(!dlp::GLFW_Library::Init()){
+        opened->set_value(false);
+        return;
+    }
+
+    // Find the monitor connected to the video port
+    int           monitor_count = 0;
+    GLFWmonitor **monitors      = glfwGetMonitors(&monitor_count);
+
+    if((monitors == NULL) || (monitor >= (unsigned int) monitor_count)){
+        dlp::GLFW_Library::Terminate();
+        opened->set_value(false);
+        return;
+    }
+
+    GLFWwindow *glfw_window = glfwCreateWindow(this->columns_, this->rows_,
+                                               "DLP LightCrafter 4500 Video Output",
+                                               monitors[monitor], NULL);
+    if(!glfw_window){
+        dlp::GLFW_Library::Terminate();
+        opened->set_value(false);
+        return;
+    }
+
+    // Swap buffers on every VSYNC so each frame is shown exactly once
+    glfwMakeContextCurrent(glfw_window);
+    glfwSwapInterval(1);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glDisable(GL_DITHER);
+
+    opened->set_value(true);
+
+    int window_width  = 0;
+    int window_height = 0;
+
+    while(!this->close_window_){
+        glfwGetFramebufferSize(glfw_window, &window_width, &window_height);
+
+        glViewport(0, 0, window_width, window_height);
+        glMatrixMode(GL_PROJECTION);
+        glLoadIdentity();
+        glOrtho(0, window_width, 0, window_height, -1, 1);
+        glMatrixMode(GL_MODELVIEW);
+        glLoadIdentity();
+
+        glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT);
+
+        {
+            std::lock_guard<std::mutex> lock(this->frames_mutex_);
+
+            if(this->frame_index_ < this->frames_.size()){
+                // Draw the frame from the top left corner
+                int frame_bottom = window_height - (int) this->rows_;
+                if(frame_bottom < 0) frame_bottom = 0;
+
+                glRasterPos2i(0, frame_bottom);
+                glDrawPixels(this->columns_, this->rows_, GL_RGB, GL_UNSIGNED_BYTE,
+                             this->frames_.at(this->frame_index_).data());
+
+                this->frame_index_++;
+                if(this->repeat_ && (this->frame_index_ >= this->frames_.size()))
+                    this->frame_index_ = 0;
+            }
+        }
+
+        // Blocks until VSYNC
+        glfwSwapBuffers(glfw_window);
+        glfwPollEvents();
+
+        this->frame_count_++;
+    }
+
+    glfwDestroyWindow(glfw_window);
+    dlp::GLFW_Library::Terminate();
+}
+
+}
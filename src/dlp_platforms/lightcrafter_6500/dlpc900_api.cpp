@@ -10,8 +10,12 @@
 #include <dlp_platforms/lightcrafter_6500/dlpc900_api.hpp>
 #include <dlp_platforms/lightcrafter_6500/dlpc900_usb.hpp>
 
-extern unsigned char OutputBuffer[];
-extern unsigned char InputBuffer[];
+/* Device state is kept in the DLPC900_Context selected for the calling thread */
+#define OutputBuffer    (DLPC900_GetContext()->OutputBuffer)
+#define InputBuffer     (DLPC900_GetContext()->InputBuffer)
+#define seqNum          (DLPC900_GetContext()->SeqNum)
+#define PatLut          (DLPC900_GetContext()->PatLut)
+#define PatLutIndex     (DLPC900_GetContext()->PatLutIndex)
 
 CmdFormat CmdList[] =
 {
@@ -85,10 +89,6 @@ CmdFormat CmdList[] =
     {   0x00, 0x00, 0x00, false, 0x0, "END"},	// Keep this to identify end of command list.
 };
 
-static unsigned char seqNum=0;
-static unsigned char PatLut[12][512];
-static unsigned int PatLutIndex = 0;
-
 int DLPC900_Write(bool ackRequired)
 {
     if (!ackRequired)
@@ -839,10 +839,11 @@ int DLPC900_DownloadData(unsigned char *pByteArray, unsigned int dataLen)
     if(dataLen > sendSize)
         dataLen = sendSize;
 
-    CmdList[BL_DNLD_DATA].len = dataLen;
     memcpy(&msg.text.data[2], pByteArray, dataLen);
 
+    // The shared command table is NOT modified so other devices are unaffected
     DLPC900_PrepWriteCmd(&msg, BL_DNLD_DATA);
+    msg.head.length = dataLen + 2;
 
     retval = DLPC900_SendMsg(&msg);
     if(retval > 0)
@@ -2218,8 +2219,8 @@ int DLPC900_SendPatLut(void)
     {
         hidMessageStruct msg;
 
-        CmdList[MBOX_DATA].len = 12;
         DLPC900_PrepWriteCmd(&msg, MBOX_DATA);
+        msg.head.length = 12 + 2;
 
         for (int j = 0; j < 12; j++)
             msg.text.data[2 + j] = PatLut[j][i];
@@ -3292,15 +3293,16 @@ int DLPC900_pattenMemLoad(bool master, unsigned char *pByteArray, int size)
 
     if (master)
     {
-        CmdList[PATMEM_LOAD_DATA_MASTER].len = dataLen + 2;
         DLPC900_PrepWriteCmd(&msg, PATMEM_LOAD_DATA_MASTER);
     }
     else
     {
-        CmdList[PATMEM_LOAD_DATA_SLAVE].len = dataLen + 2;
         DLPC900_PrepWriteCmd(&msg, PATMEM_LOAD_DATA_SLAVE);
     }
 
+    // The shared command table is NOT modified so other devices are unaffected
+    msg.head.length = dataLen + 2 + 2;
+
     retval = DLPC900_SendMsg(&msg);
     if(retval > 0)
         return dataLen;
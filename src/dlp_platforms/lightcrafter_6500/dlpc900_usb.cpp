@@ -6,6 +6,8 @@
 
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
+#include <set>
 
 #include <hidapi.h>
 #include <dlp_platforms/lightcrafter_6500/dlpc900_usb.hpp>
@@ -13,67 +15,238 @@
 /***************************************************
 *                  GLOBAL VARIABLES
 ****************************************************/
-static hid_device *DeviceHandle;	//Handle to write
-//In/Out buffers equal to HID endpoint size + 1
-//First byte is for Windows internal use and it is always 0
-unsigned char OutputBuffer[USB_MAX_PACKET_SIZE+1];
-unsigned char InputBuffer[USB_MAX_PACKET_SIZE+1];
+static DLPC900_Context DefaultContext;                          //Used when no context is selected
+static thread_local DLPC900_Context *CurrentContext = NULL;     //Selected by DLPC900_ContextLock
 
+//hidapi is shared by all contexts
+static std::mutex            HidMutex;
+static int                   HidInitCount = 0;
+static std::set<std::string> HidOpenPaths;                      //Devices opened by any context
 
-static int USBConnected = 0;      //Boolean true when device is connected
+DLPC900_Context::DLPC900_Context()
+{
+    DeviceHandle   = NULL;
+    USBConnected   = 0;
+    HidInitialized = false;
+
+    memset(OutputBuffer, 0, sizeof(OutputBuffer));
+    memset(InputBuffer,  0, sizeof(InputBuffer));
+
+    SeqNum      = 0;
+    PatLutIndex = 0;
+    memset(PatLut, 0, sizeof(PatLut));
+}
+
+DLPC900_Context::~DLPC900_Context()
+{
+    DLPC900_ContextLock lock(this);
+
+    if(USBConnected)
+        DLPC900_USB_Close();
+
+    if(HidInitialized)
+        DLPC900_USB_Exit();
+}
+
+DLPC900_ContextLock::DLPC900_ContextLock(DLPC900_Context *context) :
+    lock_(context->Mutex)
+{
+    previous_ = CurrentContext;
+    CurrentContext = context;
+}
+
+DLPC900_ContextLock::~DLPC900_ContextLock()
+{
+    CurrentContext = previous_;
+}
+
+DLPC900_Context *DLPC900_GetContext()
+{
+    if(CurrentContext != NULL)
+        return CurrentContext;
+
+    return &DefaultContext;
+}
 
 int DLPC900_USB_IsConnected()
 {
-    return USBConnected;
+    return DLPC900_GetContext()->USBConnected;
 }
 
 int DLPC900_USB_Init(void)
 {
-    return hid_init();
+    DLPC900_Context *pContext = DLPC900_GetContext();
+    std::lock_guard<std::mutex> lock(HidMutex);
+
+    if(pContext->HidInitialized)
+        return 0;
+
+    if(HidInitCount == 0)
+    {
+        int ret = hid_init();
+        if(ret < 0)
+            return ret;
+    }
+
+    HidInitCount++;
+    pContext->HidInitialized = true;
+
+    return 0;
 }
 
 int DLPC900_USB_Exit(void)
 {
-    return hid_exit();
+    DLPC900_Context *pContext = DLPC900_GetContext();
+    std::lock_guard<std::mutex> lock(HidMutex);
+
+    if(!pContext->HidInitialized)
+        return 0;
+
+    pContext->HidInitialized = false;
+    HidInitCount--;
+
+    //Only release hidapi once no other device needs it
+    if(HidInitCount == 0)
+        return hid_exit();
+
+    return 0;
+}
+
+int DLPC900_USB_Enumerate(std::vector<std::string> *serials, std::vector<std::string> *paths)
+/**
+ * Lists the serial numbers and paths of all attached DLPC900 devices.
+ *
+ * @return  number of devices found
+ *          -1 = NULL argument
+ */
+{
+    if((serials == NULL) || (paths == NULL))
+        return -1;
+
+    serials->clear();
+    paths->clear();
+
+    struct hid_device_info *pDevices = hid_enumerate(MY_VID, MY_PID);
+
+    for(struct hid_device_info *pDevice = pDevices; pDevice != NULL; pDevice = pDevice->next)
+    {
+        std::string serial;
+        if(pDevice->serial_number != NULL)
+        {
+            for(const wchar_t *pChar = pDevice->serial_number; *pChar != 0; pChar++)
+                serial.push_back((char)*pChar);
+        }
+
+        serials->push_back(serial);
+        paths->push_back(pDevice->path != NULL ? pDevice->path : "");
+    }
+
+    hid_free_enumeration(pDevices);
+
+    return serials->size();
 }
 
 int DLPC900_USB_Open()
 {
-    // Open the device using the VID, PID,
-    // and optionally the Serial number.
-    DeviceHandle = hid_open(MY_VID, MY_PID, NULL);
+    return DLPC900_USB_OpenDevice(NULL);
+}
+
+int DLPC900_USB_OpenDevice(const char *id)
+/**
+ * Opens the DLPC900 whose USB serial number or path equals id. If id is NULL, empty
+ * or does not match any device, the first device not opened by another context is used.
+ *
+ * @return  0 = PASS
+ *          -1 = no device could be opened
+ */
+{
+    DLPC900_Context *pContext = DLPC900_GetContext();
+
+    std::vector<std::string> serials;
+    std::vector<std::string> paths;
+    std::string requested = (id != NULL) ? id : "";
+
+    std::lock_guard<std::mutex> lock(HidMutex);
+
+    DLPC900_USB_Enumerate(&serials, &paths);
+
+    // Look for the requested device first
+    std::string path;
+    for(unsigned int iDevice = 0; iDevice < paths.size() && !requested.empty(); iDevice++)
+    {
+        if((serials.at(iDevice) == requested) || (paths.at(iDevice) == requested))
+        {
+            path = paths.at(iDevice);
+            break;
+        }
+    }
+
+    // Otherwise use the first device nobody else has opened
+    for(unsigned int iDevice = 0; iDevice < paths.size() && path.empty(); iDevice++)
+    {
+        if(HidOpenPaths.count(paths.at(iDevice)) == 0)
+            path = paths.at(iDevice);
+    }
 
-    if(DeviceHandle == NULL)
+    if(path.empty() || (HidOpenPaths.count(path) != 0))
     {
-        USBConnected = 0;
+        pContext->USBConnected = 0;
         return -1;
     }
-    USBConnected = 1;
+
+    // Open the device by its path
+    pContext->DeviceHandle = hid_open_path(path.c_str());
+
+    if(pContext->DeviceHandle == NULL)
+    {
+        pContext->USBConnected = 0;
+        return -1;
+    }
+
+    HidOpenPaths.insert(path);
+    pContext->DevicePath   = path;
+    pContext->USBConnected = 1;
+
     return 0;
 }
 
 int DLPC900_USB_Write()
 {
-    if(DeviceHandle == NULL)
+    DLPC900_Context *pContext = DLPC900_GetContext();
+
+    if(pContext->DeviceHandle == NULL)
         return -1;
 
-    return hid_write(DeviceHandle, OutputBuffer, USB_MIN_PACKET_SIZE+1);
+    return hid_write(pContext->DeviceHandle, pContext->OutputBuffer, USB_MIN_PACKET_SIZE+1);
 
 }
 
 int DLPC900_USB_Read()
 {
-    if(DeviceHandle == NULL)
+    DLPC900_Context *pContext = DLPC900_GetContext();
+
+    if(pContext->DeviceHandle == NULL)
         return -1;
 
-    return hid_read_timeout(DeviceHandle, InputBuffer, USB_MIN_PACKET_SIZE+1, 2000);
+    return hid_read_timeout(pContext->DeviceHandle, pContext->InputBuffer, USB_MIN_PACKET_SIZE+1, 2000);
 }
 
 int DLPC900_USB_Close()
 {
-    hid_close(DeviceHandle);
-    USBConnected = 0;
+    DLPC900_Context *pContext = DLPC900_GetContext();
+
+    if(pContext->DeviceHandle != NULL)
+    {
+        std::lock_guard<std::mutex> lock(HidMutex);
+
+        hid_close(pContext->DeviceHandle);
+        HidOpenPaths.erase(pContext->DevicePath);
+
+        pContext->DeviceHandle = NULL;
+        pContext->DevicePath.clear();
+    }
+
+    pContext->USBConnected = 0;
 
     return 0;
 }
-
@@ -16,6 +16,7 @@
 #include <sstream>
 #include <string>
 #include <atomic>
+#include <algorithm>
 
 #include <ctime>
 
@@ -85,9 +86,6 @@ LCr6500::LCr6500()
 //    this->firmware_upload_percent_erased_   = 0;
 //    this->firmware_upload_percent_complete_ = 0;
 
-    this->image_previous_first_ = -1;
-    this->image_previous_last_ = -1;
-
 
     // Get DMD columns and rows
     unsigned int dmd_rows = 0;
@@ -101,8 +99,12 @@ LCr6500::LCr6500()
 
 
 
+    this->dlpc900_context_ = std::make_shared<DLPC900_Context>();
 
-
+    // No images are known to be in the DLPC900 image slots
+    this->image_slot_use_count_ = 0;
+    this->ClearImageCache();
+    this->ResetImageCacheStatistics();
 
     this->debug_.Msg(1,"Object constructed");
 }
@@ -113,9 +115,15 @@ LCr6500::LCr6500()
 LCr6500::~LCr6500()
 {
 
-    // Clear the compressed images vector so it can be refilled
+    // Release the compressed images, images with the same contents share one buffer
     for(unsigned int iImage = 0; iImage < this->compressed_images_.size(); iImage++){
-        free(this->compressed_images_.at(iImage).bitmapImage1);
+        bool shared = false;
+        for(unsigned int iPrevious = 0; iPrevious < iImage; iPrevious++){
+            if(this->compressed_images_.at(iPrevious).bitmapImage1 == this->compressed_images_.at(iImage).bitmapImage1)
+                shared = true;
+        }
+
+        if(!shared) free(this->compressed_images_.at(iImage).bitmapImage1);
         //free(this->compressed_images_.at(iImage).bitmapImage2); // Uncomment for DLP9000
     }
     this->compressed_images_.clear();
@@ -132,13 +140,16 @@ LCr6500::~LCr6500()
 
 
 /** @brief  Connects to a DLP LightCrafter 6500 EVM
- *  @param[in]  device  assigned ID of individual projector
+ *  @param[in]  id  assigned ID of individual projector
  *
- *  Functionality of multiple projectors
- *  NOT yet implemented but will allow multiple
- *  projectors to be connected to the DLP SDK.
+ *  If id equals the USB serial number or path of an attached EVM that
+ *  device is opened. Otherwise the first EVM which is NOT already
+ *  connected to another LCr6500 object is opened. Each LCr6500 object
+ *  keeps its own USB connection so several projectors can be used from
+ *  different threads.
  */
 ReturnCode LCr6500::Connect(std::string id){
+    DLPC900_ContextLock dlpc900_lock(this->dlpc900_context_.get());
     ReturnCode ret;
 
 
@@ -156,6 +167,9 @@ ReturnCode LCr6500::Connect(std::string id){
         DLPC900_USB_Exit();
     }
 
+    // The contents of the image slots on the device are unknown
+    this->ClearImageCache();
+
     // Initialize the USB interface
     this->debug_.Msg("Initializing USB HID interface...");
     DLPC900_USB_Init();
@@ -165,11 +179,12 @@ ReturnCode LCr6500::Connect(std::string id){
 
     // Attempt to open the LCr6500 USB interface
     this->debug_.Msg("Opening USB HID interface...");
-    DLPC900_USB_Open();
+    DLPC900_USB_OpenDevice(id.c_str());
 
-    // Workaround for DLPC350 error
+    // Workaround for DLPC350 error, reopen the same device
+    std::string device_path = this->dlpc900_context_->DevicePath;
     DLPC900_USB_Close();
-    DLPC900_USB_Open();
+    DLPC900_USB_OpenDevice(device_path.c_str());
 
     // Check if the connection succeeded
     if(!DLPC900_USB_IsConnected()){
@@ -248,6 +263,7 @@ ReturnCode LCr6500::Connect(std::string id){
  * @retval  LCR6500_NOT_CONNECTED               A LightCrafter 6500 EVM has NOT enumerated on the USB
  */
 ReturnCode LCr6500::Disconnect(){
+    DLPC900_ContextLock dlpc900_lock(this->dlpc900_context_.get());
     ReturnCode ret;
 
 //    // If A firmware upload is in progress and does not
@@ -269,11 +285,14 @@ ReturnCode LCr6500::Disconnect(){
     DLPC900_USB_Close();
     DLPC900_USB_Exit();
 
+    this->ClearImageCache();
+
     return ret;
 }
 
 /** @brief  Returns true if the projector object is connected via USB. */
 bool LCr6500::isConnected() const{
+    DLPC900_ContextLock dlpc900_lock(this->dlpc900_context_.get());
     bool ret = DLPC900_USB_IsConnected();
 
     if(ret){
@@ -317,6 +336,7 @@ bool LCr6500::isConnected() const{
  * @retval  LCR6500_SETUP_TRIGGER_OUTPUT_2_FAILED   The trigger 2 output could NOT be set
  */
 ReturnCode LCr6500::Setup(const dlp::Parameters &settings){
+    DLPC900_ContextLock dlpc900_lock(this->dlpc900_context_.get());
     ReturnCode ret;
 
     // Retreive pattern sequence timing settings
@@ -421,7 +441,9 @@ ReturnCode LCr6500::Setup(const dlp::Parameters &settings){
 
 
 
+    // Changing the operating mode may discard the images in the DLPC900 image slots
     DLPC900_SetMode(OperatingMode::PATTERN_MODE_ON_THE_FLY);
+    this->ClearImageCache();
 
     // Retrieve the trigger settings
     settings.Get(&this->trigger_in_1_delay_);
@@ -876,6 +898,7 @@ ReturnCode LCr6500::Setup(const dlp::Parameters &settings){
  * @retval  DLP_PLATFORM_NOT_SETUP                  The LightCrafter 6500 has NOT been set up
  */
 ReturnCode LCr6500::GetSetup(dlp::Parameters* settings) const{
+    DLPC900_ContextLock dlpc900_lock(this->dlpc900_context_.get());
     ReturnCode ret;
 
 //    // Check that pointer is NOT null
@@ -931,7 +954,144 @@ ReturnCode LCr6500::GetSetup(dlp::Parameters* settings) const{
 
 
 
-ReturnCode  LCr6500::UploadPrestoredCompressedImages(const unsigned char &start_index, const unsigned char &last_index){
+/** @brief      Assigns a DLPC900 image slot to each image used by a lookup table
+ *
+ *  Images which are already resident in a slot keep it. Missing images
+ *  are placed in free slots first and then in the least recently used
+ *  slots which are NOT needed by the lookup table.
+ *
+ * @param[in]   dlpc900_lut     Lookup table entries which reference \ref LCr6500::compressed_images_
+ * @param[out]  image_slots     Slot for each compressed image, -1 if the image is NOT used
+ * @param[out]  missing_images  Compressed images which must be uploaded to their slot
+ *
+ * @retval  LCR6500_FLASH_IMAGE_INDEX_INVALID   A lookup table entry uses an image which has NOT been prepared
+ * @retval  LCR6500_IMAGE_LIST_TOO_LONG         The lookup table uses more images than the DLPC900 can hold
+ */
+ReturnCode LCr6500::AssignImageSlots(const std::vector<LCR6500_LUT_Entry> &dlpc900_lut,
+                                     std::vector<int>          *image_slots,
+                                     std::vector<unsigned int> *missing_images){
+    ReturnCode ret;
+
+    image_slots->assign(this->compressed_images_.size(), -1);
+    missing_images->clear();
+
+    // Determine the images used by the sequence
+    std::vector<unsigned int> used_images;
+    for(unsigned int iEntry = 0; iEntry < dlpc900_lut.size(); iEntry++){
+        unsigned int image_index = dlpc900_lut.at(iEntry).pattern_image_index;
+
+        if(image_index >= this->compressed_images_.size())
+            return ret.AddError(LCR6500_FLASH_IMAGE_INDEX_INVALID);
+
+        if(std::find(used_images.begin(), used_images.end(), image_index) == used_images.end())
+            used_images.push_back(image_index);
+    }
+
+    // Check that the distinct images fit in the slots before evicting anything
+    std::vector<unsigned long long> used_hashes;
+    for(unsigned int iImage = 0; iImage < used_images.size(); iImage++){
+        unsigned long long image_hash = this->compressed_image_hashes_.at(used_images.at(iImage));
+        if(std::find(used_hashes.begin(), used_hashes.end(), image_hash) == used_hashes.end())
+            used_hashes.push_back(image_hash);
+    }
+
+    if(used_hashes.size() > this->image_slots_.size())
+        return ret.AddError(LCR6500_IMAGE_LIST_TOO_LONG);
+
+    // Mark the slots used by this sequence with a new use count
+    this->image_slot_use_count_++;
+    const unsigned long long use_count = this->image_slot_use_count_;
+
+    // Keep the images which are already resident
+    for(unsigned int iImage = 0; iImage < used_images.size(); iImage++){
+        unsigned int       image_index = used_images.at(iImage);
+        unsigned long long image_hash  = this->compressed_image_hashes_.at(image_index);
+
+        for(unsigned int iSlot = 0; iSlot < this->image_slots_.size(); iSlot++){
+            if(this->image_slots_.at(iSlot).resident &&
+              (this->image_slots_.at(iSlot).hash == image_hash)){
+                this->image_slots_.at(iSlot).last_use = use_count;
+                image_slots->at(image_index) = iSlot;
+
+                this->image_cache_statistics_.hits++;
+                this->image_cache_statistics_.bytes_saved += this->compressed_images_.at(image_index).sizeBitmap1;
+                break;
+            }
+        }
+    }
+
+    // Assign slots to the missing images
+    for(unsigned int iImage = 0; iImage < used_images.size(); iImage++){
+        unsigned int image_index = used_images.at(iImage);
+        if(image_slots->at(image_index) >= 0) continue;
+
+        // Check for images with the same contents assigned earlier in this loop
+        unsigned long long image_hash = this->compressed_image_hashes_.at(image_index);
+        int slot = -1;
+        for(unsigned int iSlot = 0; iSlot < this->image_slots_.size(); iSlot++){
+            if((this->image_slots_.at(iSlot).last_use == use_count) &&
+               (this->image_slots_.at(iSlot).hash     == image_hash)){
+                slot = iSlot;
+                break;
+            }
+        }
+
+        if(slot < 0){
+            // Use an empty slot, otherwise evict the least recently used image
+            // which is NOT needed by this sequence
+            for(unsigned int iSlot = 0; iSlot < this->image_slots_.size(); iSlot++){
+                const ImageSlot &image_slot = this->image_slots_.at(iSlot);
+                if(image_slot.last_use == use_count) continue;
+
+                if((slot < 0) ||
+                   (!image_slot.resident && this->image_slots_.at(slot).resident) ||
+                   ((image_slot.resident == this->image_slots_.at(slot).resident) &&
+                    (image_slot.last_use  <  this->image_slots_.at(slot).last_use))){
+                    slot = iSlot;
+                }
+            }
+
+            // Every slot is needed by this sequence
+            if(slot < 0)
+                return ret.AddError(LCR6500_IMAGE_LIST_TOO_LONG);
+
+            if(this->image_slots_.at(slot).resident)
+                this->image_cache_statistics_.evictions++;
+
+            this->image_slots_.at(slot).resident = false;
+            this->image_slots_.at(slot).hash     = image_hash;
+            this->image_slots_.at(slot).last_use = use_count;
+
+            missing_images->push_back(image_index);
+            this->image_cache_statistics_.misses++;
+        }
+        else{
+            // Identical image contents only need to be uploaded once
+            this->image_cache_statistics_.hits++;
+            this->image_cache_statistics_.bytes_saved += this->compressed_images_.at(image_index).sizeBitmap1;
+        }
+
+        image_slots->at(image_index) = slot;
+    }
+
+    return ret;
+}
+
+/** @brief      Uploads compressed images to their assigned DLPC900 image slots
+ *
+ *  The images are sent in order of decreasing slot so that slot 0 is
+ *  written last.
+ *
+ * @param[in]   image_indices   Compressed images to upload
+ * @param[in]   image_slots     Slot for each compressed image from \ref LCr6500::AssignImageSlots()
+ *
+ * @retval  LCR6500_FIRMWARE_UPLOAD_IN_PROGRESS     An image upload is already in progress
+ * @retval  LCR6500_SET_PATTERN_DISPLAY_MODE_FAILED The DLPC900 could NOT be set to pattern on-the-fly mode
+ * @retval  LCR6500_PATTERN_DISPLAY_FAILED          The pattern display could NOT be stopped
+ * @retval  LCR6500_IMAGE_LIST_TOO_LONG             More images were requested than the DLPC900 can hold
+ */
+ReturnCode  LCr6500::UploadPrestoredCompressedImages(const std::vector<unsigned int> &image_indices, const std::vector<int> &image_slots){
+    DLPC900_ContextLock dlpc900_lock(this->dlpc900_context_.get());
     ReturnCode ret;
 
 
@@ -940,44 +1100,71 @@ ReturnCode  LCr6500::UploadPrestoredCompressedImages(const unsigned char &start_
         this->debug_.Msg("Cannot upload firmware because upload already in progress");
         return ret.AddError(LCR6500_FIRMWARE_UPLOAD_IN_PROGRESS);                 /** @todo update error code image upload  */
     }
-    else{
-        // Set the firmware uploading flag since upload has NOT started yet
-        while(this->image_upload_in_progress.test_and_set()){};
+
+    // Check that requested number of images is below maximum
+    if(image_indices.size() > MAX_IMAGE_ENTRIES_ON_THE_FLY)
+        return ret.AddError(LCR6500_IMAGE_LIST_TOO_LONG);
+
+    // Nothing to send if all images are resident
+    if(image_indices.empty()){
+        this->image_upload_percent_complete_ = 100;
+        return ret;
     }
 
+    // Set the firmware uploading flag since upload has NOT started yet
+    while(this->image_upload_in_progress.test_and_set()){};
+
     // Set the mode to pattern sequence on-the-fly
-    if( DLPC900_SetMode(OperatingMode::PATTERN_MODE_ON_THE_FLY) < 0)
+    if( DLPC900_SetMode(OperatingMode::PATTERN_MODE_ON_THE_FLY) < 0){
+        this->image_upload_in_progress.clear();
         return ret.AddError(LCR6500_SET_PATTERN_DISPLAY_MODE_FAILED);
+    }
 
     // Stop the display
-    if( DLPC900_PatternDisplay(Pattern::PatternStartStop::STOP) < 0 )
+    if( DLPC900_PatternDisplay(Pattern::PatternStartStop::STOP) < 0 ){
+        this->image_upload_in_progress.clear();
         return ret.AddError(LCR6500_PATTERN_DISPLAY_FAILED);
+    }
 
     // Reset the upload percentage
     this->image_upload_percent_complete_ = 0;
 
-    // Check that requested number of images is below maximum
-    if((last_index - start_index) > MAX_IMAGE_ENTRIES_ON_THE_FLY)
-        return ret.AddError(LCR6500_IMAGE_LIST_TOO_LONG);
+    // Sort the images by decreasing slot
+    std::vector<unsigned int> upload_order = image_indices;
+    std::sort(upload_order.begin(), upload_order.end(), [&image_slots](const unsigned int &a, const unsigned int &b){
+        return image_slots.at(a) > image_slots.at(b);
+    });
 
     // Sum the total data to upload
     this->image_upload_total_data_size_      = 0;
     this->image_upload_total_data_size_sent_ = 0;
 
-    for(int iImageIndex = last_index; iImageIndex >= start_index; iImageIndex--){
-        this->image_upload_total_data_size_ += this->compressed_images_.at(iImageIndex).sizeBitmap1;
+    for(unsigned int iImage = 0; iImage < upload_order.size(); iImage++){
+        this->image_upload_total_data_size_ += this->compressed_images_.at(upload_order.at(iImage)).sizeBitmap1;
     }
 
     long long total_data_size = this->image_upload_total_data_size_;
     this->debug_.Msg("Total compressed image data bytes to upload = " + dlp::Number::ToString(total_data_size));
 
-    // Upload the images in reverse (upload last iamge first and first image last)
-    for(int iImageIndex = last_index; iImageIndex >= start_index; iImageIndex--){
+    for(unsigned int iImage = 0; iImage < upload_order.size(); iImage++){
+        unsigned int image_index = upload_order.at(iImage);
+        unsigned int slot        = image_slots.at(image_index);
+
+        this->debug_.Msg("Uploading prestored compressed image " + dlp::Number::ToString(image_index) +
+                         " to slot " + dlp::Number::ToString(slot));
+        ret = this->UploadCompressedImage(slot,
+                                          this->compressed_images_.at(image_index).bitmapImage1,
+                                          this->compressed_images_.at(image_index).sizeBitmap1);
+        if(ret.hasErrors()){
+            // The slot contents are unknown after a failed upload
+            this->image_slots_.at(slot).resident = false;
+            this->image_upload_in_progress.clear();
+            return ret;
+        }
 
-        this->debug_.Msg("Uploading prestored compressed image " + dlp::Number::ToString(iImageIndex));
-        this->UploadCompressedImage(iImageIndex - start_index,  // This adjusts for the offset so the last image sent is image index 0
-                                    this->compressed_images_.at(iImageIndex).bitmapImage1,
-                                    this->compressed_images_.at(iImageIndex).sizeBitmap1);
+        this->image_slots_.at(slot).resident = true;
+        this->image_cache_statistics_.bytes_uploaded += this->compressed_images_.at(image_index).sizeBitmap1;
+        this->image_upload_percent_complete_ = (100.0 * (iImage + 1)) / upload_order.size();
     }
 
     this->image_upload_in_progress.clear();
@@ -987,6 +1174,7 @@ ReturnCode  LCr6500::UploadPrestoredCompressedImages(const unsigned char &start_
 
 
 ReturnCode LCr6500::UploadCompressedImage(const unsigned char &fw_image_index, unsigned char *compressed_image_byte_array, const int &compressed_image_data_size){
+    DLPC900_ContextLock dlpc900_lock(this->dlpc900_context_.get());
     ReturnCode ret;
 
     // Retrieve new data pointer and size information
@@ -1048,6 +1236,69 @@ float LCr6500::UploadImages_PercentComplete(){
     return this->image_upload_percent_complete_;
 }
 
+/** @brief      Returns the counters of the DLPC900 image memory cache
+ * @param[out]  statistics  Pointer to return the counters
+ */
+void LCr6500::GetImageCacheStatistics(ImageCacheStatistics *statistics){
+    DLPC900_ContextLock dlpc900_lock(this->dlpc900_context_.get());
+    if(statistics) (*statistics) = this->image_cache_statistics_;
+}
+
+/** @brief  Sets the counters of the DLPC900 image memory cache to zero */
+void LCr6500::ResetImageCacheStatistics(){
+    DLPC900_ContextLock dlpc900_lock(this->dlpc900_context_.get());
+    this->image_cache_statistics_.hits                = 0;
+    this->image_cache_statistics_.misses              = 0;
+    this->image_cache_statistics_.evictions           = 0;
+    this->image_cache_statistics_.compressions        = 0;
+    this->image_cache_statistics_.compressions_reused = 0;
+    this->image_cache_statistics_.bytes_uploaded      = 0;
+    this->image_cache_statistics_.bytes_saved         = 0;
+}
+
+/** @brief  Marks all DLPC900 image slots as empty so the next sequence uploads every image
+ *
+ *  Use if the DLPC900 image memory was changed outside of this object.
+ */
+void LCr6500::ClearImageCache(){
+    DLPC900_ContextLock dlpc900_lock(this->dlpc900_context_.get());
+    ImageSlot empty_slot;
+    empty_slot.resident = false;
+    empty_slot.hash     = 0;
+    empty_slot.last_use = 0;
+    this->image_slots_.assign(MAX_IMAGE_ENTRIES_ON_THE_FLY, empty_slot);
+}
+
+/** @brief      Calculates a 64-bit FNV-1a hash of an image file
+ * @param[in]   image_file  Composite image file created by \ref LCr6500::CreateFirmwareImages()
+ * @param[out]  hash        Pointer to return the hash
+ * @retval      FILE_DOES_NOT_EXIST     The image file could NOT be read
+ */
+ReturnCode LCr6500::HashImageFile(const std::string &image_file, unsigned long long *hash){
+    ReturnCode ret;
+
+    std::ifstream image_file_stream(image_file, std::ifstream::binary);
+    if(!image_file_stream.is_open())
+        return ret.AddError(FILE_DOES_NOT_EXIST);
+
+    unsigned long long image_hash = 14695981039346656037ULL;
+    std::vector<char>  buffer(1 << 16);
+
+    while(image_file_stream){
+        image_file_stream.read(buffer.data(), buffer.size());
+        std::streamsize bytes_read = image_file_stream.gcount();
+
+        for(std::streamsize iByte = 0; iByte < bytes_read; iByte++){
+            image_hash ^= (unsigned char) buffer[iByte];
+            image_hash *= 1099511628211ULL;
+        }
+    }
+
+    (*hash) = image_hash;
+
+    return ret;
+}
+
 
 
 
@@ -1068,6 +1319,7 @@ float LCr6500::UploadImages_PercentComplete(){
  * @retval  LCR6500_NOT_CONNECTED                   A LightCrafter 6500 EVM has NOT enumerated on the USB
  */
 ReturnCode LCr6500::ProjectSolidWhitePattern(){
+    DLPC900_ContextLock dlpc900_lock(this->dlpc900_context_.get());
     ReturnCode ret;
 
 //    // If A firmware upload is in progress return error
@@ -1112,9 +1364,12 @@ ReturnCode LCr6500::ProjectSolidWhitePattern(){
     if(DLPC900_SetPatternConfig(1, 0) < 0)
         return ret.AddError(LCR6500_SET_PATTERN_DISPLAY_MODE_FAILED); ///////////////////////////////////////////
 
-    this->UploadCompressedImage(0,
-                                this->pattern_image_white_.bitmapImage1,
-                                this->pattern_image_white_.sizeBitmap1);
+    // The solid pattern replaces the image in slot 0
+    this->image_slots_.at(0).resident = false;
+    ret = this->UploadCompressedImage(0,
+                                      this->pattern_image_white_.bitmapImage1,
+                                      this->pattern_image_white_.sizeBitmap1);
+    if(ret.hasErrors()) return ret;
 
     // Start the sequence
     if(DLPC900_PatternDisplay(Pattern::PatternStartStop::START) < 0)
@@ -1129,6 +1384,7 @@ ReturnCode LCr6500::ProjectSolidWhitePattern(){
  * @retval  LCR6500_NOT_CONNECTED                   A LightCrafter 6500 EVM has NOT enumerated on the USB
  */
 ReturnCode LCr6500::ProjectSolidBlackPattern(){
+    DLPC900_ContextLock dlpc900_lock(this->dlpc900_context_.get());
     ReturnCode ret;
 
 //    // If A firmware upload is in progress return error
@@ -1169,9 +1425,12 @@ ReturnCode LCr6500::ProjectSolidBlackPattern(){
     if(DLPC900_SetPatternConfig(1, 0) < 0)
         return ret.AddError(LCR6500_SET_PATTERN_DISPLAY_MODE_FAILED); ///////////////////////////////////////////
 
-    this->UploadCompressedImage(0,
-                                this->pattern_image_black_.bitmapImage1,
-                                this->pattern_image_black_.sizeBitmap1);
+    // The solid pattern replaces the image in slot 0
+    this->image_slots_.at(0).resident = false;
+    ret = this->UploadCompressedImage(0,
+                                      this->pattern_image_black_.bitmapImage1,
+                                      this->pattern_image_black_.sizeBitmap1);
+    if(ret.hasErrors()) return ret;
 
     // Start the sequence
     if(DLPC900_PatternDisplay(Pattern::PatternStartStop::START) < 0)
@@ -1343,6 +1602,7 @@ ReturnCode LCr6500::PatternSettingsValid(dlp::Pattern &arg_pattern){
  * @retval  LCR6500_PATTERN_SEQUENCE_BUFFERSWAP_TIME_ERROR  Buffer swap has occured prematurely
  */
 ReturnCode LCr6500::ConvertSequenceToLut(const dlp::Pattern::Sequence &pattern_sequence, std::vector<LCR6500_LUT_Entry> &sequence_LUT){
+    DLPC900_ContextLock dlpc900_lock(this->dlpc900_context_.get());
     ReturnCode ret;
     unsigned int sequence_count = pattern_sequence.GetCount();
 
@@ -1595,25 +1855,80 @@ ReturnCode LCr6500::PreparePatternSequence(const dlp::Pattern::Sequence &pattern
         if(ret.hasErrors())
             return ret;
 
-        // Clear the compressed images vector so it can be refilled
+        // Keep the previous compressed images so unchanged composite images
+        // are NOT compressed again
+        std::vector<COMPRESSED_BITMAPIMAGES> previous_images;
+        std::vector<unsigned long long>      previous_hashes;
+
         for(unsigned int iImage = 0; iImage < this->compressed_images_.size(); iImage++){
-            free(this->compressed_images_.at(iImage).bitmapImage1);
-            //free(this->compressed_images_.at(iImage).bitmapImage2); // Uncomment for DLP9000
+            // Images with the same hash share one buffer
+            if(std::find(previous_hashes.begin(),
+                         previous_hashes.end(),
+                         this->compressed_image_hashes_.at(iImage)) == previous_hashes.end()){
+                previous_images.push_back(this->compressed_images_.at(iImage));
+                previous_hashes.push_back(this->compressed_image_hashes_.at(iImage));
+            }
         }
+
+        std::vector<bool> previous_reused(previous_images.size(), false);
+
         this->compressed_images_.clear();
+        this->compressed_image_hashes_.clear();
 
         // Compress the images
         for(unsigned int iImageIndex = 0; iImageIndex < dlpc900_image_list.size(); iImageIndex++){
 
-            this->debug_.Msg("Compressing image = " + dlp::Number::ToString(iImageIndex));
+            unsigned long long image_hash = 0;
+            ret = this->HashImageFile(dlpc900_image_list.at(iImageIndex), &image_hash);
+            if(ret.hasErrors()) break;
+
+            // Look for a previous compression of the same image
+            unsigned int iPrevious = 0;
+            while((iPrevious < previous_images.size()) &&
+                  (previous_hashes.at(iPrevious) != image_hash)) iPrevious++;
 
-            // Compress the image for the DLPC900 using the DLP6500 DMD
             COMPRESSED_BITMAPIMAGES compressed_dlpc900_images;
-            ret = this->CompressImageFile(dlpc900_image_list.at(iImageIndex), &compressed_dlpc900_images );
-            if(ret.hasErrors()) return ret;
+
+            if(iPrevious < previous_images.size()){
+                this->debug_.Msg("Reusing compressed image = " + dlp::Number::ToString(iImageIndex));
+
+                // The buffer is shared if the same image appears more than once
+                compressed_dlpc900_images  = previous_images.at(iPrevious);
+                previous_reused.at(iPrevious) = true;
+                this->image_cache_statistics_.compressions_reused++;
+            }
+            else{
+                this->debug_.Msg("Compressing image = " + dlp::Number::ToString(iImageIndex));
+
+                // Compress the image for the DLPC900 using the DLP6500 DMD
+                ret = this->CompressImageFile(dlpc900_image_list.at(iImageIndex), &compressed_dlpc900_images );
+                if(ret.hasErrors()) break;
+
+                this->image_cache_statistics_.compressions++;
+
+                // Later images with the same contents reuse this compression
+                previous_images.push_back(compressed_dlpc900_images);
+                previous_hashes.push_back(image_hash);
+                previous_reused.push_back(true);
+            }
 
             // Add the compressed image to the vector
             this->compressed_images_.push_back(compressed_dlpc900_images);
+            this->compressed_image_hashes_.push_back(image_hash);
+        }
+
+        // Release the compressed images which are no longer used
+        for(unsigned int iPrevious = 0; iPrevious < previous_images.size(); iPrevious++){
+            if(!previous_reused.at(iPrevious) || ret.hasErrors()){
+                free(previous_images.at(iPrevious).bitmapImage1);
+                //free(previous_images.at(iPrevious).bitmapImage2); // Uncomment for DLP9000
+            }
+        }
+
+        if(ret.hasErrors()){
+            this->compressed_images_.clear();
+            this->compressed_image_hashes_.clear();
+            return ret;
         }
 
         // Set flag that firmware has been uploaded
@@ -1696,6 +2011,7 @@ ReturnCode LCr6500::CompressImageFile(const std::string image_file, COMPRESSED_B
  *  @retval     LCR6500_IN_CALIBRATION_MODE             The LightCrafter 6500 is in calibration mode and the sequence cannot be started
  */
 ReturnCode LCr6500::StartPatternSequence(const unsigned int &start, const unsigned int &patterns, const bool &repeat){
+    DLPC900_ContextLock dlpc900_lock(this->dlpc900_context_.get());
     ReturnCode ret;
 
     // Check that LCr6500 is connected
@@ -1754,6 +2070,7 @@ ReturnCode LCr6500::StartPatternSequence(const unsigned int &start, const unsign
  * @retval  PATTERN_SEQUENCE_INDEX_OUT_OF_RANGE     The pattern index number is NOT valid
  */
 ReturnCode LCr6500::DisplayPatternInSequence(const unsigned int &pattern_index, const bool &repeat){
+    DLPC900_ContextLock dlpc900_lock(this->dlpc900_context_.get());
     ReturnCode ret;
 
     // Check that LCr6500 is connected
@@ -1813,6 +2130,7 @@ ReturnCode LCr6500::DisplayPatternInSequence(const unsigned int &pattern_index,
  *  @retval  LCR6500_NOT_CONNECTED   The LightCrafter 6500 EVM is NOT connected
  */
 ReturnCode LCr6500::StopPatternSequence(){
+    DLPC900_ContextLock dlpc900_lock(this->dlpc900_context_.get());
     ReturnCode ret;
 
     // Check that LCr6500 is connected
@@ -1829,6 +2147,7 @@ ReturnCode LCr6500::StopPatternSequence(){
 }
 
 ReturnCode LCr6500::SendLutWithImages(const std::vector<LCR6500_LUT_Entry> &dlpc900_lut, const bool &repeat ){
+    DLPC900_ContextLock dlpc900_lock(this->dlpc900_context_.get());
     ReturnCode ret;
 
     // Check that LCr6500 is connected
@@ -1844,14 +2163,18 @@ ReturnCode LCr6500::SendLutWithImages(const std::vector<LCR6500_LUT_Entry> &dlpc
 
 
     // Determing the first and last images used in the sequence
-    this->debug_.Msg("Determine first and last images used...");
+    this->debug_.Msg("Check that the sequence has patterns...");
     unsigned int  dlpc900_lut_count  = dlpc900_lut.size();
 
     if(dlpc900_lut_count == 0)
         return ret.AddError(LCR6500_PATTERN_SEQUENCE_NOT_PREPARED);
 
-    unsigned char image_index_first  = dlpc900_lut.at(0).pattern_image_index;
-    unsigned char image_index_last   = dlpc900_lut.at(dlpc900_lut_count-1).pattern_image_index;
+    // Find the image slots, images still in the DLPC900 from a previous sequence are NOT uploaded again
+    this->debug_.Msg("Assign DLPC900 image slots...");
+    std::vector<int>          image_slots;
+    std::vector<unsigned int> missing_images;
+    ret = this->AssignImageSlots(dlpc900_lut, &image_slots, &missing_images);
+    if(ret.hasErrors()) return ret;
 
 
     // Change device to pattern sequence mode
@@ -1891,7 +2214,7 @@ ReturnCode LCr6500::SendLutWithImages(const std::vector<LCR6500_LUT_Entry> &dlpc
                                dlpc900_lut.at(iEntry).wait_for_trigger,
                                dlpc900_lut.at(iEntry).dark_time_us,
                                dlpc900_lut.at(iEntry).enable_trigger_2,
-                               dlpc900_lut.at(iEntry).pattern_image_index - image_index_first, // Adjust the image index
+                               image_slots.at(dlpc900_lut.at(iEntry).pattern_image_index),     // Slot holding the image
                                dlpc900_lut.at(iEntry).pattern_bit_position)<0)
             return ret.AddError(LCR6500_ADD_EXP_LUT_ENTRY_FAILED);
     }
@@ -1911,17 +2234,12 @@ ReturnCode LCr6500::SendLutWithImages(const std::vector<LCR6500_LUT_Entry> &dlpc
             return ret.AddError(LCR6500_SET_PATTERN_DISPLAY_MODE_FAILED); ///////////////////////////////////////////
     }
 
-    // Check if the last set of images matches what was previously sent
-    if( (image_index_first != this->image_previous_first_ ) ||
-        (image_index_last  != this->image_previous_last_  )    ){
-
-        // Upload the images needed for this sequence from the precomprossed image vector
-        ret = this->UploadPrestoredCompressedImages(image_index_first,image_index_last);
-        if(ret.hasErrors()) return ret;
-
-        //this->image_previous_first_ = image_index_first;
-        //this->image_previous_last_  = image_index_last;
-    }
+    // Upload the images which are NOT resident from the precompressed image vector
+    this->debug_.Msg("Uploading " + dlp::Number::ToString(missing_images.size()) + " of " +
+                     dlp::Number::ToString(std::count_if(image_slots.begin(), image_slots.end(), [](const int &slot){ return slot >= 0; })) +
+                     " images...");
+    ret = this->UploadPrestoredCompressedImages(missing_images, image_slots);
+    if(ret.hasErrors()) return ret;
 
     return ret;
 }
@@ -1998,8 +2316,12 @@ int LCr6500::DlpPatternBitdepthToLCr6500Bitdepth(const dlp::Pattern::Bitdepth &d
  * @retval  LCR6500_FIRMWARE_CHECKSUM_MISMATCH                  The uploaded firmware's checksum does NOT match the firmware on the LightCrafter 6500
  */
 ReturnCode LCr6500::UploadFirmware(std::string firmware_filename){
+    DLPC900_ContextLock dlpc900_lock(this->dlpc900_context_.get());
     ReturnCode ret;
 
+    // The controller restarts after a firmware upload
+    this->ClearImageCache();
+
 //    std::string flash_parameters_filename = this->DLPC900_flash_parameters_.Get();
 
 //    // If A firmware upload is in progress, do NOT send any commands until upload is complete! already return error
@@ -0,0 +1,339 @@
+/** @file   virtual_projector.cpp
+ *  @brief  Contains methods for the \ref dlp::Virtual_Projector class
+ *  @copyright  2016 Texas Instruments Incorporated - http://www.ti.com/ ALL RIGHTS RESERVED
+ */
+
+#include <common/returncode.hpp>
+#include <common/debug.hpp>
+#include <common/other.hpp>
+#include <common/image/image.hpp>
+#include <common/pattern/pattern.hpp>
+#include <common/parameters.hpp>
+#include <dlp_platforms/dlp_platform.hpp>
+#include <dlp_platforms/virtual_projector/virtual_projector.hpp>
+
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/** @brief  Contains all DLP SDK classes, functions, etc. */
+namespace dlp{
+
+/** @brief  Constructs the virtual projector emulating a LightCrafter 4500 */
+Virtual_Projector::Virtual_Projector(){
+    this->debug_.SetName("VIRTUAL_PROJECTOR_DEBUG(" + dlp::Number::ToString(this)+ "): ");
+    this->debug_.Msg("Constructing...");
+
+    this->is_setup_     = false;
+    this->is_connected_ = false;
+
+    this->display_        = Display::BLACK;
+    this->display_start_  = 0;
+    this->display_count_  = 0;
+    this->display_repeat_ = false;
+
+    this->emulated_platform_.Set(DLP_Platform::Platform::LIGHTCRAFTER_4500);
+    this->SetPlatform(this->emulated_platform_.Get());
+
+    this->debug_.Msg("Constructed");
+}
+
+Virtual_Projector::~Virtual_Projector(){
+    this->debug_.Msg("Deconstructing...");
+    this->Disconnect();
+    this->debug_.Msg("Deconstructed");
+}
+
+/** @brief  Marks the virtual projector as connected and creates the solid patterns */
+ReturnCode Virtual_Projector::Connect(std::string id){
+    ReturnCode ret;
+
+    unsigned int rows    = 0;
+    unsigned int columns = 0;
+    this->GetRows(&rows);
+    this->GetColumns(&columns);
+
+    this->black_image_.Create(columns, rows, dlp::Image::Format::MONO_UCHAR);
+    this->black_image_.FillImage((unsigned char) 0);
+    this->white_image_.Create(columns, rows, dlp::Image::Format::MONO_UCHAR);
+    this->white_image_.FillImage((unsigned char) 255);
+
+    this->SetID(id);
+    this->is_connected_ = true;
+
+    std::lock_guard<std::mutex> lock(this->display_mutex_);
+    this->display_ = Display::BLACK;
+
+    this->debug_.Msg("Connected to virtual " + this->emulated_platform_.GetEntryValue() +
+                     " (" + dlp::Number::ToString(columns) + "x" + dlp::Number::ToString(rows) + ")");
+
+    return ret;
+}
+
+ReturnCode Virtual_Projector::Disconnect(){
+    ReturnCode ret;
+
+    std::lock_guard<std::mutex> lock(this->display_mutex_);
+    this->is_connected_ = false;
+    this->display_      = Display::BLACK;
+    this->pattern_images_.clear();
+    this->sequence_prepared_.Set(false);
+
+    return ret;
+}
+
+bool Virtual_Projector::isConnected() const{
+    return this->is_connected_;
+}
+
+/** @brief  Sets the emulated platform and the pattern period
+ *  @retval VIRTUAL_PROJECTOR_PLATFORM_INVALID          Emulated platform is NOT a known DLP Platform
+ *  @retval VIRTUAL_PROJECTOR_PATTERN_PERIOD_INVALID    Pattern period is zero
+ */
+ReturnCode Virtual_Projector::Setup(const dlp::Parameters &settings){
+    ReturnCode ret;
+
+    if(settings.Contains(this->emulated_platform_)){
+        DLP_Platform::Parameters::Platform platform;
+        settings.Get(&platform);
+
+        if(platform.Get() == DLP_Platform::Platform::INVALID)
+            return ret.AddError(VIRTUAL_PROJECTOR_PLATFORM_INVALID);
+
+        if(platform.Get() != this->emulated_platform_.Get()){
+            // The prepared images have the resolution of the previous platform
+            this->emulated_platform_.Set(platform.Get());
+            this->SetPlatform(platform.Get());
+            if(this->isConnected()){
+                std::string id;
+                this->GetID(&id);
+                this->Disconnect();
+                this->Connect(id);
+            }
+        }
+    }
+
+    if(settings.Contains(this->pattern_period_)){
+        settings.Get(&this->pattern_period_);
+        if(this->pattern_period_.Get() == 0)
+            return ret.AddError(VIRTUAL_PROJECTOR_PATTERN_PERIOD_INVALID);
+    }
+
+    this->sequence_period_.Set(this->pattern_period_.Get());
+    this->sequence_exposure_.Set(this->pattern_period_.Get());
+    this->is_setup_ = true;
+
+    return ret;
+}
+
+ReturnCode Virtual_Projector::GetSetup(dlp::Parameters *settings) const{
+    ReturnCode ret;
+
+    if(!settings)
+        return ret.AddError(DLP_PLATFORM_NULL_INPUT_ARGUMENT);
+
+    settings->Clear();
+    settings->Set(this->emulated_platform_);
+    settings->Set(this->pattern_period_);
+
+    return ret;
+}
+
+ReturnCode Virtual_Projector::ProjectSolidWhitePattern(){
+    ReturnCode ret;
+
+    if(!this->isConnected())
+        return ret.AddError(VIRTUAL_PROJECTOR_NOT_CONNECTED);
+
+    std::lock_guard<std::mutex> lock(this->display_mutex_);
+    this->display_ = Display::WHITE;
+    return ret;
+}
+
+ReturnCode Virtual_Projector::ProjectSolidBlackPattern(){
+    ReturnCode ret;
+
+    if(!this->isConnected())
+        return ret.AddError(VIRTUAL_PROJECTOR_NOT_CONNECTED);
+
+    std::lock_guard<std::mutex> lock(this->display_mutex_);
+    this->display_ = Display::BLACK;
+    return ret;
+}
+
+/** @brief  Stores the monochrome pattern images of the sequence
+ *  @retval PATTERN_SEQUENCE_EMPTY                  Sequence has no patterns
+ *  @retval VIRTUAL_PROJECTOR_PATTERN_TYPE_INVALID  A pattern is defined with parameters instead of an image
+ *  @retval DLP_PLATFORM_PATTERN_SEQUENCE_NOT_PREPARED  A pattern image has the wrong resolution
+ */
+ReturnCode Virtual_Projector::PreparePatternSequence(const dlp::Pattern::Sequence &pattern_sequence){
+    ReturnCode ret;
+
+    if(!this->isConnected())
+        return ret.AddError(VIRTUAL_PROJECTOR_NOT_CONNECTED);
+
+    if(pattern_sequence.GetCount() == 0)
+        return ret.AddError(PATTERN_SEQUENCE_EMPTY);
+
+    std::vector<dlp::Image> images(pattern_sequence.GetCount());
+
+    for(unsigned int iPattern = 0; iPattern < pattern_sequence.GetCount(); iPattern++){
+        dlp::Pattern pattern;
+        pattern_sequence.Get(iPattern, &pattern);
+
+        switch(pattern.data_type){
+        case dlp::Pattern::DataType::IMAGE_DATA:
+            images.at(iPattern).Create(pattern.image_data);
+            break;
+        case dlp::Pattern::DataType::IMAGE_FILE:
+            ret = images.at(iPattern).Load(pattern.image_file);
+            if(ret.hasErrors()) return ret;
+            break;
+        default:
+            return ret.AddError(VIRTUAL_PROJECTOR_PATTERN_TYPE_INVALID);
+        }
+
+        if(!this->ImageResolutionCorrect(images.at(iPattern)))
+            return ret.AddError(DLP_PLATFORM_PATTERN_SEQUENCE_NOT_PREPARED);
+
+        images.at(iPattern).ConvertToMonochrome();
+    }
+
+    std::lock_guard<std::mutex> lock(this->display_mutex_);
+    this->pattern_images_.swap(images);
+    this->display_ = Display::BLACK;
+    this->sequence_prepared_.Set(true);
+
+    return ret;
+}
+
+/** @brief  Starts displaying the prepared patterns, one per pattern period
+ *  @param[in]  start       Index of the first pattern to display
+ *  @param[in]  patterns    Number of patterns to display
+ *  @param[in]  repeat      If false the projector is black after the last pattern
+ *  @retval VIRTUAL_PROJECTOR_PATTERN_INDEX_INVALID     Range exceeds the prepared sequence
+ */
+ReturnCode Virtual_Projector::StartPatternSequence(const unsigned int &start, const unsigned int &patterns, const bool &repeat){
+    ReturnCode ret;
+
+    if(!this->isConnected())
+        return ret.AddError(VIRTUAL_PROJECTOR_NOT_CONNECTED);
+
+    std::lock_guard<std::mutex> lock(this->display_mutex_);
+
+    if(!this->sequence_prepared_.Get())
+        return ret.AddError(DLP_PLATFORM_PATTERN_SEQUENCE_NOT_PREPARED);
+
+    if((patterns == 0) || (start + patterns > this->pattern_images_.size()))
+        return ret.AddError(VIRTUAL_PROJECTOR_PATTERN_INDEX_INVALID);
+
+    this->display_        = Display::SEQUENCE;
+    this->display_start_  = start;
+    this->display_count_  = patterns;
+    this->display_repeat_ = repeat;
+    this->display_time_   = std::chrono::steady_clock::now();
+
+    return ret;
+}
+
+ReturnCode Virtual_Projector::DisplayPatternInSequence(const unsigned int &pattern_index, const bool &repeat){
+    ReturnCode ret;
+
+    if(!this->isConnected())
+        return ret.AddError(VIRTUAL_PROJECTOR_NOT_CONNECTED);
+
+    std::lock_guard<std::mutex> lock(this->display_mutex_);
+
+    if(!this->sequence_prepared_.Get())
+        return ret.AddError(DLP_PLATFORM_PATTERN_SEQUENCE_NOT_PREPARED);
+
+    if(pattern_index >= this->pattern_images_.size())
+        return ret.AddError(VIRTUAL_PROJECTOR_PATTERN_INDEX_INVALID);
+
+    this->display_        = Display::PATTERN;
+    this->display_start_  = pattern_index;
+    this->display_count_  = 1;
+    this->display_repeat_ = repeat;
+    this->display_time_   = std::chrono::steady_clock::now();
+
+    return ret;
+}
+
+ReturnCode Virtual_Projector::StopPatternSequence(){
+    return this->ProjectSolidBlackPattern();
+}
+
+/** @brief  Returns the image the projector displays at this moment */
+ReturnCode Virtual_Projector::GetDisplayedImage(dlp::Image *ret_image) const{
+    ReturnCode ret;
+
+    if(!ret_image)
+        return ret.AddError(DLP_PLATFORM_NULL_INPUT_ARGUMENT);
+
+    if(!this->isConnected())
+        return ret.AddError(VIRTUAL_PROJECTOR_NOT_CONNECTED);
+
+    std::lock_guard<std::mutex> lock(this->display_mutex_);
+
+    switch(this->display_){
+    case Display::WHITE:
+        *ret_image = this->white_image_;
+        break;
+    case Display::PATTERN:
+        *ret_image = this->pattern_images_.at(this->display_start_);
+        break;
+    case Display::SEQUENCE:
+    {
+        unsigned long long elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now() - this->display_time_).count();
+        unsigned long long offset  = elapsed / this->pattern_period_.Get();
+
+        if(this->display_repeat_) offset = offset % this->display_count_;
+
+        if(offset < this->display_count_) *ret_image = this->pattern_images_.at(this->display_start_ + offset);
+        else                              *ret_image = this->black_image_;
+        break;
+    }
+    default:
+        *ret_image = this->black_image_;
+        break;
+    }
+
+    return ret;
+}
+
+/** @brief  Returns a pattern of the started sequence and when its display ends
+ *
+ *  This emulates a camera triggered by the projector: the frame of pattern
+ *  offset is complete at ret_display_end.
+ *
+ *  @param[in]  offset              Pattern number counted from the sequence start
+ *  @param[out] ret_image           Pattern image
+ *  @param[out] ret_display_end     Time the pattern stops being displayed
+ *  @retval VIRTUAL_PROJECTOR_SEQUENCE_NOT_STARTED  No sequence is being displayed
+ *  @retval VIRTUAL_PROJECTOR_PATTERN_INDEX_INVALID Offset is past the end of a non-repeating sequence
+ */
+ReturnCode Virtual_Projector::GetSequenceImage(const unsigned int &offset,
+                                               dlp::Image *ret_image,
+                                               std::chrono::steady_clock::time_point *ret_display_end) const{
+    ReturnCode ret;
+
+    if(!ret_image || !ret_display_end)
+        return ret.AddError(DLP_PLATFORM_NULL_INPUT_ARGUMENT);
+
+    std::lock_guard<std::mutex> lock(this->display_mutex_);
+
+    if(this->display_ != Display::SEQUENCE)
+        return ret.AddError(VIRTUAL_PROJECTOR_SEQUENCE_NOT_STARTED);
+
+    if(!this->display_repeat_ && (offset >= this->display_count_))
+        return ret.AddError(VIRTUAL_PROJECTOR_PATTERN_INDEX_INVALID);
+
+    *ret_image       = this->pattern_images_.at(this->display_start_ + (offset % this->display_count_));
+    *ret_display_end = this->display_time_ + std::chrono::microseconds((unsigned long long)(offset + 1) * this->pattern_period_.Get());
+
+    return ret;
+}
+
+}
@@ -6,6 +6,7 @@
 
 #include <common/debug.hpp>
 #include <common/returncode.hpp>
+#include <common/other.hpp>
 #include <common/image/image.hpp>
 #include <common/capture/capture.hpp>
 #include <common/pattern/pattern.hpp>
@@ -19,6 +20,10 @@
 
 #include <vector>
 #include <string>
+#include <thread>
+#include <mutex>
+#include <limits>
+#include <unordered_map>
 #include <math.h>
 
 /** @brief  Contains all DLP SDK classes, functions, etc. */
@@ -742,6 +747,26 @@ ReturnCode Geometry::AddView(const dlp::Calibration::Data &viewport_calib,
 
 }
 
+/** @brief Restricts \ref GeneratePointCloud() to part of a view port's frame
+ *  @param[in] viewport_id  \ref dlp::Geometry::ViewPoint ID the region applies to
+ *  @param[in] region       Camera pixels to smooth and triangulate, an empty \ref dlp::RegionOfInterest uses the whole frame
+ *  @retval GEOMETRY_VIEWPORT_ID_OUT_OF_RANGE   Requested view port does NOT exist
+ *
+ *  Only the bounding box of the region is smoothed and scanned for valid
+ *  disparity values. Distance maps keep the full frame resolution.
+ */
+ReturnCode Geometry::SetRegionOfInterest(const unsigned int &viewport_id,
+                                         const dlp::RegionOfInterest &region){
+    ReturnCode ret;
+
+    if(viewport_id >= this->viewport_.size())
+        return ret.AddError(GEOMETRY_VIEWPORT_ID_OUT_OF_RANGE);
+
+    this->viewport_.at(viewport_id).region = region;
+
+    return ret;
+}
+
 /** @brief Finds 3D line intersections using a line from the origin point and a line from the view point
 *   @param[in] origin_x     Origin_x is the decoded value from the vertical structured light patterns
 *   @param[in] origin_y     Origin_y is the decoded value from the horizontal structured light patterns
@@ -895,24 +920,58 @@ void Geometry::Unsafe_Find3dPlaneLineIntersection(const unsigned int &origin_pla
                                                   const unsigned int &viewport_x, const unsigned int &viewport_y,
                                                   Point *ret_xyz){
     // Origin offset and vector
-    PlaneEquation plane_eq;
+    PlaneEquation plane_eq = this->GetOriginPlanes(orientation).at(origin_plane);
 
-    if( orientation == dlp::Pattern::Orientation::HORIZONTAL){
-        plane_eq = this->origin_.plane_rows.at(origin_plane);
-    }
-    else if( orientation == dlp::Pattern::Orientation::VERTICAL){
+    this->Unsafe_IntersectViewportRay(plane_eq, viewport_id, viewport_x, viewport_y, ret_xyz);
+}
 
-        plane_eq = this->origin_.plane_columns.at(origin_plane);
-    }
-    else if( orientation == dlp::Pattern::Orientation::DIAMOND_ANGLE_1){
+/** @brief Intersects a viewport ray with a plane between two origin planes
+ *  @param[in]  origin_plane    Fractional plane index, e.g. from a subpixel \ref dlp::DisparityMap
+ *  @param[in]  orientation     Orientation of the origin planes
+ *  @param[in]  viewport_id     Viewport which contains the ray
+ *  @param[in]  viewport_x      Column of the viewport ray
+ *  @param[in]  viewport_y      Row of the viewport ray
+ *  @param[out] ret_xyz         Return pointer for the intersection
+ *
+ *  The plane is interpolated linearly between its two neighboring origin
+ *  planes. Integer indices give the same result as the unsigned int method.
+ */
+void Geometry::Unsafe_Find3dPlaneLineIntersection(const double &origin_plane,
+                                                  dlp::Pattern::Orientation orientation,
+                                                  const unsigned int &viewport_id,
+                                                  const unsigned int &viewport_x, const unsigned int &viewport_y,
+                                                  Point *ret_xyz){
+    const std::vector<PlaneEquation> &planes = this->GetOriginPlanes(orientation);
+
+    unsigned int  lower    = (unsigned int) origin_plane;
+    double        fraction = origin_plane - lower;
+    PlaneEquation plane_eq = planes.at(lower);
 
-        plane_eq = this->origin_.plane_diamond_angle_1.at(origin_plane);
+    if((fraction > 0.0) && (lower + 1 < planes.size())){
+        const PlaneEquation &upper = planes.at(lower + 1);
+        plane_eq.w = plane_eq.w * (1.0 - fraction) + upper.w * fraction;
+        plane_eq.d = plane_eq.d * (1.0 - fraction) + upper.d * fraction;
     }
-    else if( orientation == dlp::Pattern::Orientation::DIAMOND_ANGLE_2){
 
-        plane_eq = this->origin_.plane_diamond_angle_2.at(origin_plane);
+    this->Unsafe_IntersectViewportRay(plane_eq, viewport_id, viewport_x, viewport_y, ret_xyz);
+}
+
+/** @brief Returns the origin planes of a pattern orientation */
+const std::vector<Geometry::PlaneEquation>& Geometry::GetOriginPlanes(const dlp::Pattern::Orientation &orientation) const{
+    switch(orientation){
+    case dlp::Pattern::Orientation::HORIZONTAL:      return this->origin_.plane_rows;
+    case dlp::Pattern::Orientation::DIAMOND_ANGLE_1: return this->origin_.plane_diamond_angle_1;
+    case dlp::Pattern::Orientation::DIAMOND_ANGLE_2: return this->origin_.plane_diamond_angle_2;
+    case dlp::Pattern::Orientation::VERTICAL:
+    default:                                         return this->origin_.plane_columns;
     }
+}
 
+/** @brief Intersects a viewport ray with a plane */
+void Geometry::Unsafe_IntersectViewportRay(const PlaneEquation &plane_eq,
+                                           const unsigned int &viewport_id,
+                                           const unsigned int &viewport_x, const unsigned int &viewport_y,
+                                           Point *ret_xyz){
     // Viewport offset and vector
     cv::Point3d q = this->viewport_.at(viewport_id).center;
     cv::Point3d v = this->viewport_.at(viewport_id).ray.at<cv::Point3d>(viewport_y,viewport_x);
@@ -980,6 +1039,29 @@ ReturnCode Geometry::GeneratePointCloud(const unsigned int &viewport_id,
                                         dlp::DisparityMap  &disparity_2,
                                         dlp::Point::Cloud  *ret_cloud,
                                         dlp::Image         *ret_distancemap){
+    return this->GeneratePointCloud(viewport_id, disparity_1, disparity_2,
+                                    ret_cloud, ret_distancemap, nullptr);
+}
+
+/** @brief Generates \ref dlp::Point::Cloud by finding the line intersections
+ *         between the requested view port rays and the origin rays and records
+ *         the camera pixel each point was generated from
+ *  @param[in]  viewport_id         \ref dlp::Geometry::ViewPoint ID to select correct optical rays
+ *  @param[in]  disparity_1         \ref dlp::DisparityMap generated from dlp::StructuredLight module set for \ref dlp::Pattern::Orientation::VERTICAL
+ *  @param[in]  disparity_2         \ref dlp::DisparityMap generated from dlp::StructuredLight module set for \ref dlp::Pattern::Orientation::HORIZONTAL
+ *  @param[out] ret_cloud           Pointer to return \ref dlp::Point::Cloud
+ *  @param[out] ret_distancemap     Pointer to return \ref dlp::Image depth map
+ *  @param[out] ret_sources         Pointer to return one \ref dlp::Geometry::PointSource per point, may be NULL.
+ *                                  When rays are filtered the first camera pixel contributing to a point is returned.
+ *  @retval GEOMETRY_VIEWPORT_ID_OUT_OF_RANGE   Requested view port does NOT exist
+ *  @retval GEOMETRY_NULL_POINTER               Return argument is NULL
+ */
+ReturnCode Geometry::GeneratePointCloud(const unsigned int &viewport_id,
+                                        dlp::DisparityMap  &disparity_1,
+                                        dlp::DisparityMap  &disparity_2,
+                                        dlp::Point::Cloud  *ret_cloud,
+                                        dlp::Image         *ret_distancemap,
+                                        std::vector<PointSource> *ret_sources){
     ReturnCode ret;
 
     // Check viewport id
@@ -1108,6 +1190,17 @@ ReturnCode Geometry::GeneratePointCloud(const unsigned int &viewport_id,
     if(!orientations_correct)
         return ret.AddError(GEOMETRY_DISPARITY_MAPS_MISMATCHED);
 
+    // Only the bounding box of the view port's region of interest is processed
+    cv::Rect region;
+    cv::Mat  region_mask;
+    ret = this->viewport_.at(viewport_id).region.GetBounds(disparity_image_columns, disparity_image_rows, &region);
+    if(ret.hasErrors())
+        return ret;
+    this->viewport_.at(viewport_id).region.GetMask(region, &region_mask);
+
+    const unsigned int region_column_end = region.x + region.width;
+    const unsigned int region_row_end    = region.y + region.height;
+
 
     // Get the disparity map oversampling
     dlp::DisparityMap disparity_1_copy(disparity_1);
@@ -1123,8 +1216,8 @@ ReturnCode Geometry::GeneratePointCloud(const unsigned int &viewport_id,
     if(orientation_1_sampling != disparity_1_sampling){
 
         // Resample the values to match the geometry module's settings
-        for(    unsigned int yRow = 0; yRow < disparity_image_rows;    yRow++){
-            for(unsigned int xCol = 0; xCol < disparity_image_columns; xCol++){
+        for(    unsigned int yRow = region.y; yRow < region_row_end;    yRow++){
+            for(unsigned int xCol = region.x; xCol < region_column_end; xCol++){
                 int disparity_value = DisparityMap::EMPTY_PIXEL;
 
                 // Get the disparity values
@@ -1144,8 +1237,8 @@ ReturnCode Geometry::GeneratePointCloud(const unsigned int &viewport_id,
     if(orientation_2_sampling != disparity_2_sampling){
 
         // Resample the values to match the geometry module's settings
-        for(    unsigned int yRow = 0; yRow < disparity_image_rows;    yRow++){
-            for(unsigned int xCol = 0; xCol < disparity_image_columns; xCol++){
+        for(    unsigned int yRow = region.y; yRow < region_row_end;    yRow++){
+            for(unsigned int xCol = region.x; xCol < region_column_end; xCol++){
                 int disparity_value = DisparityMap::EMPTY_PIXEL;
 
                 // Get the disparity values
@@ -1173,6 +1266,10 @@ ReturnCode Geometry::GeneratePointCloud(const unsigned int &viewport_id,
         disparity_1_copy.Unsafe_GetOpenCVData(&map_1);
         disparity_2_copy.Unsafe_GetOpenCVData(&map_2);
 
+        // Smooth the region of interest only
+        map_1 = map_1(region);
+        map_2 = map_2(region);
+
         // Clone the original data
         map_1_copy = map_1.clone();
         map_2_copy = map_2.clone();
@@ -1198,27 +1295,36 @@ ReturnCode Geometry::GeneratePointCloud(const unsigned int &viewport_id,
     // rows     // columns  // points
     std::vector<std::vector<std::vector<dlp::Point> > > point_cloud;
     std::vector<std::vector<std::vector<  double  > > > point_cloud_distance;
+    std::vector<std::vector<std::vector<PointSource> > > point_cloud_source;
 
     // Check if viewpoint rays should be filtered
     if(this->filter_rays_enable_.Get()){
         // Size the vectors to the origin dimensions
         point_cloud.resize(this->origin_.ray.rows);
         point_cloud_distance.resize(this->origin_.ray.rows);
+        if(ret_sources) point_cloud_source.resize(this->origin_.ray.rows);
         for( int yRow = 0; yRow < this->origin_.ray.rows; yRow++){
             point_cloud[yRow].resize(this->origin_.ray.cols);
             point_cloud_distance[yRow].resize(this->origin_.ray.cols);
+            if(ret_sources) point_cloud_source[yRow].resize(this->origin_.ray.cols);
         }
     }
 
     // Generate the point cloud
     ret_cloud->Clear();
+    if(ret_sources) ret_sources->clear();
     double max_origin_distance = this->max_distance_.Get();
     double min_origin_distance = this->min_distance_.Get();
     bool   check_distance      = (max_origin_distance != min_origin_distance);
     bool valid_disparity_value = false;
-    for(    unsigned int yRow = 0; yRow < disparity_image_rows;    yRow++){
-        for(unsigned int xCol = 0; xCol < disparity_image_columns; xCol++){
+    for(    unsigned int yRow = region.y; yRow < region_row_end;    yRow++){
+        for(unsigned int xCol = region.x; xCol < region_column_end; xCol++){
             valid_disparity_value = false;
+
+            // Skip pixels outside of the mask
+            if(!region_mask.empty() && (region_mask.at<unsigned char>(yRow - region.y, xCol - region.x) == 0))
+                continue;
+
             disparity_value_1 = DisparityMap::EMPTY_PIXEL;
             disparity_value_2 = DisparityMap::EMPTY_PIXEL;
 
@@ -1275,10 +1381,18 @@ ReturnCode Geometry::GeneratePointCloud(const unsigned int &viewport_id,
                             // Save the point and origin distance
                             point_cloud[(*ptr_disparity_value_row)][(*ptr_disparity_value_column)].push_back(point);
                             point_cloud_distance[(*ptr_disparity_value_row)][(*ptr_disparity_value_column)].push_back(point.distance);
+                            if(ret_sources){
+                                PointSource source = {viewport_id, xCol, yRow};
+                                point_cloud_source[(*ptr_disparity_value_row)][(*ptr_disparity_value_column)].push_back(source);
+                            }
                         }
                         else{
                             // Add the point
                             ret_cloud->Add(point);
+                            if(ret_sources){
+                                PointSource source = {viewport_id, xCol, yRow};
+                                ret_sources->push_back(source);
+                            }
                         }
                     }
 
@@ -1311,12 +1425,14 @@ ReturnCode Geometry::GeneratePointCloud(const unsigned int &viewport_id,
 
                     // Calculate the error for each point and keep points within threshold
                     std::vector<dlp::Point> valid_points;
+                    unsigned int first_valid_point = 0;
                     for(unsigned int iPoint = 0; iPoint < point_cloud[yRow][xCol].size(); iPoint++){
                         double percent_error = std::abs(average - point_cloud_distance[yRow][xCol][iPoint])
                                                / point_cloud_distance[yRow][xCol][iPoint];
 
                         // If the error is below threshold save point
                         if(percent_error <= max_error){
+                            if(valid_points.size() == 0) first_valid_point = iPoint;
                             valid_points.push_back(point_cloud[yRow][xCol][iPoint]);
                         }
                     }
@@ -1335,6 +1451,7 @@ ReturnCode Geometry::GeneratePointCloud(const unsigned int &viewport_id,
 
                         // Save the point
                         ret_cloud->Add(valid_point);
+                        if(ret_sources) ret_sources->push_back(point_cloud_source[yRow][xCol][first_valid_point]);
                     }
                 }
             }
@@ -1344,7 +1461,200 @@ ReturnCode Geometry::GeneratePointCloud(const unsigned int &viewport_id,
     return ret;
 }
 
+/** @brief Voxel coordinates of a point used to find overlapping view ports */
+struct MergeVoxel{
+    long long x;
+    long long y;
+    long long z;
+
+    bool operator==(const MergeVoxel &other) const{
+        return (this->x == other.x) && (this->y == other.y) && (this->z == other.z);
+    }
+};
+
+struct MergeVoxelHash{
+    size_t operator()(const MergeVoxel &voxel) const{
+        unsigned long long hash = (unsigned long long) voxel.x * 73856093ull;
+        hash ^= (unsigned long long) voxel.y * 19349663ull;
+        hash ^= (unsigned long long) voxel.z * 83492791ull;
+        return (size_t) hash;
+    }
+};
+
+/** @brief Selects the points to keep from the merged clouds of several view ports
+ *  @param[in]  cloud       Merged \ref dlp::Point::Cloud
+ *  @param[in]  sources     Source of each point
+ *  @param[in]  viewports   Number of view ports
+ *  @param[in]  voxel_size  Edge length of the de-duplication voxels
+ *  @param[out] kept        Indices of the kept points in ascending order
+ *
+ *  A voxel which only holds points of one view port keeps all of them. A voxel
+ *  which holds points of several view ports keeps the points of the view port
+ *  with the most points in it, or of the lowest view port ID on a tie.
+ */
+static void SelectMergedPoints(const dlp::Point::Cloud                   &cloud,
+                               const std::vector<Geometry::PointSource>  &sources,
+                               const unsigned int                        &viewports,
+                               const double                              &voxel_size,
+                               std::vector<unsigned long long>           *kept){
+    unsigned long long count = cloud.GetCount();
+
+    // Find the voxel of every point
+    std::unordered_map<MergeVoxel, unsigned long long, MergeVoxelHash> lookup;
+    std::vector<unsigned long long> point_voxel(count);
+    lookup.reserve(count / 4 + 1);
+
+    for(unsigned long long iPoint = 0; iPoint < count; iPoint++){
+        dlp::Point point;
+        cloud.Get(iPoint, &point);
+
+        MergeVoxel voxel;
+        voxel.x = (long long) floor(point.x / voxel_size);
+        voxel.y = (long long) floor(point.y / voxel_size);
+        voxel.z = (long long) floor(point.z / voxel_size);
+
+        auto inserted = lookup.insert(std::make_pair(voxel, (unsigned long long) lookup.size()));
+        point_voxel.at(iPoint) = inserted.first->second;
+    }
+
+    // Count the points of each view port in every voxel and select one view port
+    std::vector<unsigned int> view_points(lookup.size() * viewports, 0);
+    for(unsigned long long iPoint = 0; iPoint < count; iPoint++){
+        view_points.at((point_voxel.at(iPoint) * viewports) + sources.at(iPoint).viewport_id)++;
+    }
+
+    std::vector<unsigned int> voxel_view(lookup.size(), 0);
+    for(unsigned long long iVoxel = 0; iVoxel < lookup.size(); iVoxel++){
+        for(unsigned int iView = 1; iView < viewports; iView++){
+            if(view_points.at((iVoxel * viewports) + iView) > view_points.at((iVoxel * viewports) + voxel_view.at(iVoxel)))
+                voxel_view.at(iVoxel) = iView;
+        }
+    }
+
+    kept->clear();
+    for(unsigned long long iPoint = 0; iPoint < count; iPoint++){
+        if(sources.at(iPoint).viewport_id == voxel_view.at(point_voxel.at(iPoint)))
+            kept->push_back(iPoint);
+    }
+}
+
+/** @brief Generates a single \ref dlp::Point::Cloud from every view port
+ *
+ *  Each view port is triangulated on its own thread with its pair of disparity maps.
+ *  The clouds are then merged. Where the camera views overlap, a voxel holding
+ *  points of several view ports keeps only the points of one of them. Points in
+ *  voxels seen by a single view port are all kept, so the merge does NOT lower
+ *  the resolution outside of the overlap.
+ *
+ *  @param[in]  disparity_1         One \ref dlp::DisparityMap per view port, index matches the view port ID
+ *  @param[in]  disparity_2         One \ref dlp::DisparityMap per view port with the second orientation
+ *  @param[in]  merge_voxel_size    Edge length of the de-duplication voxels. Zero keeps every point.
+ *  @param[out] ret_cloud           Pointer to return merged \ref dlp::Point::Cloud
+ *  @param[out] ret_sources         Pointer to return the view port and camera pixel of each point, may be NULL
+ *  @param[out] ret_distancemaps    Pointer to return one depth map per view port, may be NULL
+ *  @retval GEOMETRY_NULL_POINTER                       Return argument is NULL
+ *  @retval GEOMETRY_VIEWPORT_DISPARITY_COUNT_INVALID   A disparity map pair is NOT supplied for every view port
+ */
+ReturnCode Geometry::GeneratePointCloud(std::vector<dlp::DisparityMap> &disparity_1,
+                                        std::vector<dlp::DisparityMap> &disparity_2,
+                                        const double                   &merge_voxel_size,
+                                        dlp::Point::Cloud              *ret_cloud,
+                                        std::vector<PointSource>       *ret_sources,
+                                        std::vector<dlp::Image>        *ret_distancemaps){
+    ReturnCode ret;
+
+    // Check pointers
+    if(!ret_cloud)
+        return ret.AddError(GEOMETRY_NULL_POINTER);
+
+    // Check that there is one disparity map pair per viewport
+    unsigned int viewports = this->viewport_.size();
+    if((viewports == 0) ||
+       (disparity_1.size() != viewports) ||
+       (disparity_2.size() != viewports))
+        return ret.AddError(GEOMETRY_VIEWPORT_DISPARITY_COUNT_INVALID);
+
+    // Triangulate each viewport on its own thread
+    std::vector<dlp::Point::Cloud>          clouds(viewports);
+    std::vector<dlp::Image>                 distancemaps(viewports);
+    std::vector<std::vector<PointSource> >  sources(viewports);
+    std::vector<ReturnCode>                 results(viewports);
+    std::vector<std::thread>                workers;
+
+    for(unsigned int iView = 0; iView < viewports; iView++){
+        workers.push_back(std::thread([&, iView](){
+            results.at(iView) = this->GeneratePointCloud(iView,
+                                                         disparity_1.at(iView),
+                                                         disparity_2.at(iView),
+                                                         &clouds.at(iView),
+                                                         &distancemaps.at(iView),
+                                                         &sources.at(iView));
+        }));
+    }
+
+    // Join every worker before returning so none is destroyed while joinable
+    for(unsigned int iView = 0; iView < viewports; iView++){
+        workers.at(iView).join();
+    }
 
+    for(unsigned int iView = 0; iView < viewports; iView++){
+        if(results.at(iView).hasErrors()) return results.at(iView);
+    }
+
+    // Merge the viewport clouds
+    dlp::Point::Cloud           merged;
+    std::vector<PointSource>    merged_sources;
+    for(unsigned int iView = 0; iView < viewports; iView++){
+        for(unsigned long long iPoint = 0; iPoint < clouds.at(iView).GetCount(); iPoint++){
+            dlp::Point point;
+            clouds.at(iView).Get(iPoint, &point);
+            merged.Add(point);
+        }
+        merged_sources.insert(merged_sources.end(), sources.at(iView).begin(), sources.at(iView).end());
+        clouds.at(iView).Clear();
+    }
+
+    // Remove duplicate points where the viewports overlap
+    if((merge_voxel_size > 0) && (merged.GetCount() > 0)){
+        std::vector<unsigned long long> kept;
+
+        SelectMergedPoints(merged, merged_sources, viewports, merge_voxel_size, &kept);
+
+        std::vector<PointSource> kept_sources(kept.size());
+        for(unsigned long long iPoint = 0; iPoint < kept.size(); iPoint++){
+            kept_sources.at(iPoint) = merged_sources.at(kept.at(iPoint));
+        }
+        merged_sources.swap(kept_sources);
+
+        ret = merged.Extract(kept, ret_cloud);
+        if(ret.hasErrors()) return ret;
+    }
+    else{
+        ret_cloud->Clear();
+        for(unsigned long long iPoint = 0; iPoint < merged.GetCount(); iPoint++){
+            dlp::Point point;
+            merged.Get(iPoint, &point);
+            ret_cloud->Add(point);
+        }
+    }
+
+    if(ret_sources)      ret_sources->swap(merged_sources);
+    if(ret_distancemaps) ret_distancemaps->swap(distancemaps);
+
+    return ret;
+}
+
+/** @brief Generates \ref dlp::Point::Cloud by intersecting each view port ray
+ *         with the origin plane selected by a single \ref dlp::DisparityMap
+ *  @param[in]  viewport_id         \ref dlp::Geometry::ViewPoint ID to select correct optical rays
+ *  @param[in]  disparity_map       \ref dlp::DisparityMap of any pattern orientation
+ *  @param[out] ret_cloud           Pointer to return \ref dlp::Point::Cloud
+ *  @param[out] ret_distancemap     Pointer to return \ref dlp::Image depth map
+ *  @retval GEOMETRY_VIEWPORT_ID_OUT_OF_RANGE           Requested view port does NOT exist
+ *  @retval GEOMETRY_NULL_POINTER                       Return argument is NULL
+ *  @retval GEOMETRY_DISPARITY_MAP_ORIENTATION_INVALID  Disparity map orientation is NOT supported
+ *  @retval GEOMETRY_DISPARITY_MAP_RESOLUTION_INVALID   Disparity map does NOT match the view port resolution
+ */
 ReturnCode Geometry::GeneratePointCloud(const unsigned int &viewport_id,
                                         dlp::DisparityMap &disparity_map,
                                         dlp::Point::Cloud *ret_cloud,
@@ -1363,39 +1673,18 @@ ReturnCode Geometry::GeneratePointCloud(const unsigned int &viewport_id,
     if(!ret_distancemap)
         return ret.AddError(GEOMETRY_NULL_POINTER);
 
-    // Check that disparity maps are the correct pattern orientation
+    // Check that disparity maps are the correct pattern orientation and
+    // get the number of planes and their sampling
     dlp::Pattern::Orientation disparity_orientation;
-    disparity_map_copy.GetOrientation(&disparity_orientation);
-    if((disparity_orientation != dlp::Pattern::Orientation::VERTICAL) &&
-       (disparity_orientation != dlp::Pattern::Orientation::HORIZONTAL) &&
-       (disparity_orientation != dlp::Pattern::Orientation::DIAMOND_ANGLE_2) &&
-       (disparity_orientation != dlp::Pattern::Orientation::DIAMOND_ANGLE_1))
-        return ret.AddError(GEOMETRY_DISPARITY_MAP_ORIENTATION_INVALID);
-
-    // Get the disparity map oversampling
     unsigned int disparity_sampling;
     unsigned int geometry_sampling;
-    disparity_map_copy.GetDisparitySampling(&disparity_sampling);
+    unsigned int disparity_max;
 
-    // Get the maximum disparity value
-    unsigned int disparity_max = this->origin_.plane_columns.size() - 1;
+    disparity_map_copy.GetOrientation(&disparity_orientation);
+    disparity_map_copy.GetDisparitySampling(&disparity_sampling);
 
-    if( disparity_orientation == dlp::Pattern::Orientation::HORIZONTAL){
-        disparity_max       = this->origin_.plane_rows.size();
-        geometry_sampling   = this->oversample_rows_.Get();
-    }
-    else if( disparity_orientation == dlp::Pattern::Orientation::VERTICAL){
-        disparity_max       = this->origin_.plane_columns.size();
-        geometry_sampling   = this->oversample_columns_.Get();
-    }
-    else if( disparity_orientation == dlp::Pattern::Orientation::DIAMOND_ANGLE_1){
-        disparity_max       = this->origin_.plane_diamond_angle_1.size();
-        geometry_sampling   = this->oversample_angled_positive_.Get();
-    }
-    else if( disparity_orientation == dlp::Pattern::Orientation::DIAMOND_ANGLE_2){
-        disparity_max       = this->origin_.plane_diamond_angle_2.size();
-        geometry_sampling   = this->oversample_angled_negative_.Get();
-    }
+    if(!this->GetPlaneSampling(disparity_orientation, &geometry_sampling, &disparity_max))
+        return ret.AddError(GEOMETRY_DISPARITY_MAP_ORIENTATION_INVALID);
 
 
     // Check  viewport resolution with column disparity
@@ -1409,39 +1698,28 @@ ReturnCode Geometry::GeneratePointCloud(const unsigned int &viewport_id,
        (disparity_image_rows    != (unsigned int) this->viewport_.at(viewport_id).ray.rows))
         return ret.AddError(GEOMETRY_DISPARITY_MAP_RESOLUTION_INVALID);
 
-    if(geometry_sampling != disparity_sampling){
-
-        // Resample the values to match the geometry module's settings
-        for(    unsigned int yRow = 0; yRow < disparity_image_rows;    yRow++){
-            for(unsigned int xCol = 0; xCol < disparity_image_columns; xCol++){
-                int disparity_value = DisparityMap::EMPTY_PIXEL;
-
-                // Get the disparity values
-                disparity_map_copy.Unsafe_GetPixel(xCol, yRow, &disparity_value);
-
-                // Generate new value
-                disparity_value = (disparity_value * geometry_sampling) / disparity_sampling;
-
-                // Save the new value
-                disparity_map_copy.Unsafe_SetPixel(xCol, yRow, disparity_value);
-            }
-        }
-    }
+    // Only the bounding box of the view port's region of interest is processed
+    cv::Rect region;
+    cv::Mat  region_mask;
+    ret = this->viewport_.at(viewport_id).region.GetBounds(disparity_image_columns, disparity_image_rows, &region);
+    if(ret.hasErrors())
+        return ret;
+    this->viewport_.at(viewport_id).region.GetMask(region, &region_mask);
+
+    // Convert the disparity values to plane indices. Maps sampled more
+    // finely than the planes, such as subpixel Gray code, keep their
+    // fraction and are interpolated between the neighboring planes.
+    cv::Mat map;
+    cv::Mat plane_index;
+    disparity_map_copy.Unsafe_GetOpenCVData(&map);
+
+    ConvertDisparityToPlaneIndex(map(region), region_mask,
+                                 (double) geometry_sampling / disparity_sampling,
+                                 &plane_index);
 
     // Check if image should be smoothed
-    if(this->smooth_disparity_.Get()){
-        cv::Mat original;
-        cv::Mat map;
-        cv::Mat smooth;
-        disparity_map_copy.Unsafe_GetOpenCVData(&map);
-
-        // Clone the original data
-        original = map.clone();
-        original.convertTo(original,CV_32F);
-        cv::bilateralFilter ( original, smooth, geometry_sampling*2, geometry_sampling*3*2, geometry_sampling*3/2);
-
-        smooth.convertTo(map,CV_32S);
-    }
+    if(this->smooth_disparity_.Get())
+        SmoothPlaneIndex(geometry_sampling, &plane_index);
 
 
     // Allocate memory for the distance map
@@ -1452,30 +1730,381 @@ ReturnCode Geometry::GeneratePointCloud(const unsigned int &viewport_id,
     ret_distancemap->FillImage((double)dlp::DisparityMap::EMPTY_PIXEL);
 
 
-    // Clear the point cloud
+    // Calculate the points and add them to the cleared point cloud
+    std::vector<dlp::Point> points;
+    this->Unsafe_TriangulatePlaneIndex(viewport_id, disparity_orientation, disparity_max,
+                                       region, plane_index, &points, ret_distancemap);
+
     ret_cloud->Clear();
+    for(unsigned long long iPoint = 0; iPoint < points.size(); iPoint++){
+        ret_cloud->Add(points[iPoint]);
+    }
+
+    return ret;
+}
+
+/** @brief Generates \ref dlp::Point::Cloud from a single \ref dlp::DisparityMap
+ *         keeping only the pixels whose \ref dlp::ConfidenceMap meets the limits
+ *  @param[in]  viewport_id         \ref dlp::Geometry::ViewPoint ID to select correct optical rays
+ *  @param[in]  disparity           \ref dlp::DisparityMap of any pattern orientation
+ *  @param[in]  confidence          \ref dlp::ConfidenceMap decoded with the disparity map
+ *  @param[in]  rejection           Limits each pixel must meet to be triangulated
+ *  @param[out] ret_cloud           Pointer to return \ref dlp::Point::Cloud
+ *  @param[out] ret_distancemap     Pointer to return \ref dlp::Image depth map
+ *  @retval CONFIDENCE_MAP_RESOLUTION_INVALID   Confidence map does NOT match the disparity map
+ *
+ *  The supplied disparity map is NOT modified, so the same scan can be
+ *  triangulated again with different limits.
+ */
+ReturnCode Geometry::GeneratePointCloud(const unsigned int                  &viewport_id,
+                                        dlp::DisparityMap                   &disparity,
+                                        const dlp::ConfidenceMap            &confidence,
+                                        const dlp::ConfidenceMap::Rejection &rejection,
+                                        dlp::Point::Cloud                   *ret_cloud,
+                                        dlp::Image                          *ret_distancemap){
+    ReturnCode ret;
+
+    dlp::DisparityMap filtered;
+    ret = filtered.Create(disparity);
+    if(ret.hasErrors())
+        return ret;
+
+    ret = confidence.Reject(rejection, &filtered);
+    if(ret.hasErrors())
+        return ret;
+
+    return this->GeneratePointCloud(viewport_id, filtered, ret_cloud, ret_distancemap);
+}
+
+/** @brief Generates \ref dlp::Point::Cloud from vertical and horizontal
+ *         \ref dlp::DisparityMap objects keeping only the pixels whose
+ *         \ref dlp::ConfidenceMap objects both meet the limits
+ *  @param[in]  viewport_id         \ref dlp::Geometry::ViewPoint ID to select correct optical rays
+ *  @param[in]  disparity_1         \ref dlp::DisparityMap set for \ref dlp::Pattern::Orientation::VERTICAL
+ *  @param[in]  confidence_1        \ref dlp::ConfidenceMap decoded with disparity_1
+ *  @param[in]  disparity_2         \ref dlp::DisparityMap set for \ref dlp::Pattern::Orientation::HORIZONTAL
+ *  @param[in]  confidence_2        \ref dlp::ConfidenceMap decoded with disparity_2
+ *  @param[in]  rejection           Limits each pixel must meet to be triangulated
+ *  @param[out] ret_cloud           Pointer to return \ref dlp::Point::Cloud
+ *  @param[out] ret_distancemap     Pointer to return \ref dlp::Image depth map
+ *  @retval CONFIDENCE_MAP_RESOLUTION_INVALID   A confidence map does NOT match its disparity map
+ */
+ReturnCode Geometry::GeneratePointCloud(const unsigned int                  &viewport_id,
+                                        dlp::DisparityMap                   &disparity_1,
+                                        const dlp::ConfidenceMap            &confidence_1,
+                                        dlp::DisparityMap                   &disparity_2,
+                                        const dlp::ConfidenceMap            &confidence_2,
+                                        const dlp::ConfidenceMap::Rejection &rejection,
+                                        dlp::Point::Cloud                   *ret_cloud,
+                                        dlp::Image                          *ret_distancemap){
+    ReturnCode ret;
+
+    dlp::DisparityMap filtered_1;
+    dlp::DisparityMap filtered_2;
+
+    ret = filtered_1.Create(disparity_1);
+    if(ret.hasErrors())
+        return ret;
+
+    ret = filtered_2.Create(disparity_2);
+    if(ret.hasErrors())
+        return ret;
+
+    ret = confidence_1.Reject(rejection, &filtered_1);
+    if(ret.hasErrors())
+        return ret;
+
+    ret = confidence_2.Reject(rejection, &filtered_2);
+    if(ret.hasErrors())
+        return ret;
+
+    return this->GeneratePointCloud(viewport_id, filtered_1, filtered_2, ret_cloud, ret_distancemap);
+}
+
+/** @brief Returns the resolution of a view port's rays
+ *  @param[in]  viewport_id     \ref dlp::Geometry::ViewPoint ID
+ *  @param[out] columns         Return pointer for the number of columns
+ *  @param[out] rows            Return pointer for the number of rows
+ *  @retval GEOMETRY_VIEWPORT_ID_OUT_OF_RANGE   Requested view port does NOT exist
+ *  @retval GEOMETRY_NULL_POINTER               Return argument is NULL
+ */
+ReturnCode Geometry::GetViewportResolution(const unsigned int &viewport_id,
+                                           unsigned int *columns,
+                                           unsigned int *rows) const{
+    ReturnCode ret;
+
+    if(viewport_id >= this->viewport_.size())
+        return ret.AddError(GEOMETRY_VIEWPORT_ID_OUT_OF_RANGE);
+
+    if(!columns || !rows)
+        return ret.AddError(GEOMETRY_NULL_POINTER);
+
+    (*columns) = this->viewport_.at(viewport_id).ray.cols;
+    (*rows)    = this->viewport_.at(viewport_id).ray.rows;
+
+    return ret;
+}
+
+/** @brief Triangulates one tile of a disparity map without smoothing
+ *  @param[in]  viewport_id         \ref dlp::Geometry::ViewPoint ID to select correct optical rays
+ *  @param[in]  orientation         Pattern orientation of the disparity values
+ *  @param[in]  disparity_sampling  Disparity values per origin plane before the geometry oversampling
+ *  @param[in]  tile                Location of the tile in the view port frame
+ *  @param[in]  disparity           CV_32SC1 disparity values of the tile
+ *  @param[out] ret_points          Points of the tile in row major order are appended
+ *  @param[out] ret_distancemap     Full frame \ref dlp::Image::Format::MONO_DOUBLE depth map, may be NULL
+ *
+ *  This is the triangulation step of \ref GeneratePointCloud() for a single
+ *  \ref dlp::DisparityMap. It lets the structured light modules triangulate
+ *  each tile while its disparity is still in the cache. Tiles which do NOT
+ *  overlap may be processed on separate threads.
+ *
+ *  \warning The view port ID, orientation, and tile location are NOT checked.
+ */
+void Geometry::Unsafe_GeneratePointCloudTile(const unsigned int &viewport_id,
+                                             const dlp::Pattern::Orientation &orientation,
+                                             const unsigned int &disparity_sampling,
+                                             const cv::Rect &tile,
+                                             const cv::Mat &disparity,
+                                             std::vector<dlp::Point> *ret_points,
+                                             dlp::Image *ret_distancemap){
+    unsigned int geometry_sampling;
+    unsigned int plane_count;
+    if(!this->GetPlaneSampling(orientation, &geometry_sampling, &plane_count)) return;
+
+    cv::Mat plane_index;
+    ConvertDisparityToPlaneIndex(disparity, cv::Mat(),
+                                 (double) geometry_sampling / disparity_sampling,
+                                 &plane_index);
+
+    this->Unsafe_TriangulatePlaneIndex(viewport_id, orientation, plane_count,
+                                       tile, plane_index, ret_points, ret_distancemap);
+}
+
+/** @brief Returns the rows of neighboring pixels used to smooth each disparity value
+ *  @param[in]  orientation     Pattern orientation of the disparity values
+ *
+ *  Zero is returned if \ref Parameters::SmoothDisparity is disabled or the
+ *  orientation is NOT supported.
+ */
+unsigned int Geometry::GetSmoothingRadius(const dlp::Pattern::Orientation &orientation) const{
+    unsigned int geometry_sampling;
+    unsigned int plane_count;
+
+    if(!this->smooth_disparity_.Get()) return 0;
+    if(!this->GetPlaneSampling(orientation, &geometry_sampling, &plane_count)) return 0;
+
+    // The bilateral filter diameter is twice the sampling
+    return geometry_sampling;
+}
+
+/** @brief Smooths and triangulates one horizontal band of a disparity map
+ *  @param[in]  viewport_id         \ref dlp::Geometry::ViewPoint ID to select correct optical rays
+ *  @param[in]  orientation         Pattern orientation of the disparity values
+ *  @param[in]  disparity_sampling  Disparity values per origin plane before the geometry oversampling
+ *  @param[in]  band                Location of the disparity values in the view port frame
+ *  @param[in]  core                Rows of the band to triangulate in the view port frame
+ *  @param[in]  disparity           CV_32SC1 disparity values of the band
+ *  @param[out] ret_points          Points of the core in row major order are appended
+ *  @param[out] ret_distancemap     Full frame \ref dlp::Image::Format::MONO_DOUBLE depth map, may be NULL
+ *
+ *  The whole band is smoothed if \ref Parameters::SmoothDisparity is enabled
+ *  but only its core is triangulated. If the band extends at least
+ *  \ref GetSmoothingRadius() rows past the core, or up to the edge of the
+ *  region being triangulated, the points match \ref GeneratePointCloud()
+ *  with a single \ref dlp::DisparityMap.
+ *
+ *  \warning The view port ID, orientation, and rectangles are NOT checked.
+ */
+void Geometry::Unsafe_GeneratePointCloudBand(const unsigned int &viewport_id,
+                                             const dlp::Pattern::Orientation &orientation,
+                                             const unsigned int &disparity_sampling,
+                                             const cv::Rect &band,
+                                             const cv::Rect &core,
+                                             const cv::Mat &disparity,
+                                             std::vector<dlp::Point> *ret_points,
+                                             dlp::Image *ret_distancemap){
+    unsigned int geometry_sampling;
+    unsigned int plane_count;
+    if(!this->GetPlaneSampling(orientation, &geometry_sampling, &plane_count)) return;
+
+    cv::Mat plane_index;
+    ConvertDisparityToPlaneIndex(disparity, cv::Mat(),
+                                 (double) geometry_sampling / disparity_sampling,
+                                 &plane_index);
+
+    if(this->smooth_disparity_.Get())
+        SmoothPlaneIndex(geometry_sampling, &plane_index);
+
+    cv::Mat core_index = plane_index(cv::Rect(core.x - band.x, core.y - band.y, core.width, core.height));
+
+    this->Unsafe_TriangulatePlaneIndex(viewport_id, orientation, plane_count,
+                                       core, core_index, ret_points, ret_distancemap);
+}
+
+/** @brief Smooths the valid fractional origin plane indices
+ *  @param[in]      geometry_sampling   Geometry oversampling of the planes
+ *  @param[in,out]  plane_index         CV_64FC1 indices, negative values are invalid and NOT changed
+ *
+ *  Bilateral filter with the window and sigmas of the previous
+ *  cv::bilateralFilter call, normalized over the valid neighbors only.
+ *  Invalid pixels are left out of the weighted sum so the -1 marker does
+ *  NOT pull the indices at the edges of holes and shadows.
+ */
+void Geometry::SmoothPlaneIndex(const unsigned int &geometry_sampling, cv::Mat *plane_index){
+    const int    radius       = geometry_sampling;
+    const double sigma_range  = geometry_sampling*3*2;
+    const double sigma_space  = geometry_sampling*3/2;
+    const double range_factor = -0.5 / (sigma_range * sigma_range);
+    const double space_factor = -0.5 / (sigma_space * sigma_space);
+
+    if((radius == 0) || (sigma_space <= 0.0))
+        return;
+
+    // Weights of the circular window
+    std::vector<int>    window_x;
+    std::vector<int>    window_y;
+    std::vector<double> window_weight;
+    for(    int yOffset = -radius; yOffset <= radius; yOffset++){
+        for(int xOffset = -radius; xOffset <= radius; xOffset++){
+            double distance = sqrt((double)(xOffset*xOffset + yOffset*yOffset));
+            if(distance > radius) continue;
+            window_x.push_back(xOffset);
+            window_y.push_back(yOffset);
+            window_weight.push_back(exp(distance * distance * space_factor));
+        }
+    }
+
+    const cv::Mat original = plane_index->clone();
+    const int     rows     = original.rows;
+    const int     columns  = original.cols;
+
+    dlp::Thread::ParallelFor(0, rows, [&](unsigned long long first, unsigned long long last){
+        for(unsigned long long yRow = first; yRow < last; yRow++){
+            const double *pixel_original = original.ptr<double>(yRow);
+            double       *pixel_plane    = plane_index->ptr<double>(yRow);
+
+            for(int xCol = 0; xCol < columns; xCol++){
+                const double center = pixel_original[xCol];
+                if(center < 0.0) continue;
+
+                double sum        = 0.0;
+                double weight_sum = 0.0;
+                for(unsigned int iWindow = 0; iWindow < window_weight.size(); iWindow++){
+                    int y = (int) yRow + window_y[iWindow];
+                    int x = xCol       + window_x[iWindow];
+                    if((y < 0) || (y >= rows) || (x < 0) || (x >= columns)) continue;
+
+                    const double neighbor = original.ptr<double>(y)[x];
+                    if(neighbor < 0.0) continue;
+
+                    const double difference = neighbor - center;
+                    const double weight     = window_weight[iWindow] * exp(difference * difference * range_factor);
+                    sum        += weight * neighbor;
+                    weight_sum += weight;
+                }
+
+                // The center pixel is always part of the sum
+                pixel_plane[xCol] = sum / weight_sum;
+            }
+        }
+    });
+}
+
+/** @brief Returns the geometry oversampling and the number of origin planes of an orientation
+ *  @retval false   Orientation is NOT supported
+ */
+bool Geometry::GetPlaneSampling(const dlp::Pattern::Orientation &orientation,
+                                unsigned int *sampling,
+                                unsigned int *plane_count) const{
+    switch(orientation){
+    case dlp::Pattern::Orientation::VERTICAL:
+        (*sampling) = this->oversample_columns_.Get();
+        break;
+    case dlp::Pattern::Orientation::HORIZONTAL:
+        (*sampling) = this->oversample_rows_.Get();
+        break;
+    case dlp::Pattern::Orientation::DIAMOND_ANGLE_1:
+        (*sampling) = this->oversample_angled_positive_.Get();
+        break;
+    case dlp::Pattern::Orientation::DIAMOND_ANGLE_2:
+        (*sampling) = this->oversample_angled_negative_.Get();
+        break;
+    case dlp::Pattern::Orientation::INVALID:
+    default:
+        return false;
+    }
+
+    (*plane_count) = this->GetOriginPlanes(orientation).size();
+    return true;
+}
+
+/** @brief Converts disparity values to fractional origin plane indices
+ *  @param[in]  disparity       CV_32SC1 disparity values
+ *  @param[in]  mask            CV_8UC1 mask of the pixels to convert, may be empty
+ *  @param[in]  plane_scale     Origin planes per disparity value
+ *  @param[out] plane_index     Return pointer for the CV_64FC1 indices, -1 marks invalid pixels
+ */
+void Geometry::ConvertDisparityToPlaneIndex(const cv::Mat &disparity, const cv::Mat &mask,
+                                            const double &plane_scale, cv::Mat *plane_index){
+    plane_index->create(disparity.rows, disparity.cols, CV_64FC1);
+
+    for(    int yRow = 0; yRow < disparity.rows; yRow++){
+        const int           *pixel_disparity = disparity.ptr<int>(yRow);
+        const unsigned char *pixel_mask      = mask.empty() ? NULL : mask.ptr<unsigned char>(yRow);
+        double              *pixel_plane     = plane_index->ptr<double>(yRow);
+
+        for(int xCol = 0; xCol < disparity.cols; xCol++){
+            int disparity_value = pixel_disparity[xCol];
+
+            if((disparity_value >= 0) && (disparity_value != DisparityMap::INVALID_PIXEL) &&
+               (!pixel_mask || (pixel_mask[xCol] != 0)))
+                pixel_plane[xCol] = disparity_value * plane_scale;
+            else
+                pixel_plane[xCol] = -1.0;
+        }
+    }
+}
+
+/** @brief Intersects the view port rays of a tile with their fractional origin planes
+ *  @param[in]  viewport_id     \ref dlp::Geometry::ViewPoint ID to select correct optical rays
+ *  @param[in]  orientation     Orientation of the origin planes
+ *  @param[in]  plane_count     Number of origin planes
+ *  @param[in]  tile            Location of the tile in the view port frame
+ *  @param[in]  plane_index     CV_64FC1 plane index of each tile pixel, negative if invalid
+ *  @param[out] ret_points      Points within the distance limits are appended
+ *  @param[out] ret_distancemap Full frame depth map, may be NULL
+ */
+void Geometry::Unsafe_TriangulatePlaneIndex(const unsigned int &viewport_id,
+                                            const dlp::Pattern::Orientation &orientation,
+                                            const unsigned int &plane_count,
+                                            const cv::Rect &tile,
+                                            const cv::Mat &plane_index,
+                                            std::vector<dlp::Point> *ret_points,
+                                            dlp::Image *ret_distancemap){
     double max_origin_distance = this->max_distance_.Get();
     double min_origin_distance = this->min_distance_.Get();
     bool   check_distance      = (max_origin_distance != min_origin_distance);
 
-    for(    unsigned int yRow = 0; yRow < disparity_image_rows;    yRow++){
-        for(unsigned int xCol = 0; xCol < disparity_image_columns; xCol++){
-            int disparity_value = DisparityMap::EMPTY_PIXEL;
+    for(    int yRow = 0; yRow < tile.height; yRow++){
+        const double *pixel_plane = plane_index.ptr<double>(yRow);
 
-            // Get the disparity values
-            disparity_map_copy.Unsafe_GetPixel(xCol, yRow, &disparity_value);
+        for(int xCol = 0; xCol < tile.width; xCol++){
+            double plane = pixel_plane[xCol];
 
-            // Check that neither pixels are invalid
-            if((disparity_value < (int) disparity_max) &&
-               (disparity_value >= 0)){
+            // Check that the pixel is valid
+            if((plane >= 0.0) &&
+               (plane <= ((double) plane_count - 1.0))){
 
                 // Calculate the point in space
-                dlp::Point point;
+                dlp::Point   point;
+                unsigned int viewport_x = tile.x + xCol;
+                unsigned int viewport_y = tile.y + yRow;
 
-                this->Unsafe_Find3dPlaneLineIntersection((unsigned int) disparity_value,
-                                                                        disparity_orientation,
-                                                    viewport_id, xCol, yRow,                        // Viewport ray
-                                                    &point);                             // Return point and distance from origin
+                this->Unsafe_Find3dPlaneLineIntersection(plane,
+                                                         orientation,
+                                                         viewport_id, viewport_x, viewport_y,   // Viewport ray
+                                                         &point);                               // Return point and distance from origin
 
 
                 // Check that z is greater than zero
@@ -1488,20 +2117,125 @@ ReturnCode Geometry::GeneratePointCloud(const unsigned int &viewport_id,
                         (point.distance >= min_origin_distance))){
 
                         // Save the distance
-                        ret_distancemap->Unsafe_SetPixel(xCol,yRow,point.distance);
+                        if(ret_distancemap) ret_distancemap->Unsafe_SetPixel(viewport_x,viewport_y,point.distance);
 
                         // Save the point
-                        ret_cloud->Add(point);
+                        ret_points->push_back(point);
                     }
                 }
             }
         }
     }
-
-    return ret;
 }
 
+/** @brief Converts a \ref dlp::Image::Format::MONO_DOUBLE distance map to a color
+ *         image with the \ref dlp::Geometry::ColorMap::RAINBOW scale stretched between
+ *         the closest and farthest points
+ *  @param[in]  distance_map    Distance map from \ref dlp::Geometry::GeneratePointCloud()
+ *  @param[out] color_depth     Pointer to return \ref dlp::Image::Format::RGB_UCHAR image
+ */
 ReturnCode Geometry::ConvertDistanceMapToColor(const dlp::Image &distance_map, dlp::Image *color_depth){
+    return Geometry::ConvertDistanceMapToColor(distance_map, ColorMap::RAINBOW, 0.0, 0.0, color_depth);
+}
+
+/** @brief Fills a 256 entry lookup table (in OpenCV BGR order) for the color map
+ *         where entry 0 is the farthest distance and entry 255 the closest
+ */
+static bool GetColorMapTable(const Geometry::ColorMap &color_map, cv::Vec3b *table){
+    for(unsigned int depth_temp = 0; depth_temp < 256; depth_temp++){
+        PixelRGB depth(0,0,0);
+
+        switch(color_map){
+        case Geometry::ColorMap::RAINBOW:
+            if(depth_temp < 43){
+                depth.r = depth_temp * 6;
+                depth.g = 0;
+                depth.b = depth_temp * 6;
+            }
+            else if(depth_temp < 85){
+                depth.r = 255 - (depth_temp - 43) * 6;
+                depth.g = 0;
+                depth.b = 255;
+            }
+            else if(depth_temp < 128){
+                depth.r = 0;
+                depth.g = (depth_temp - 85) * 6;
+                depth.b = 255;
+            }
+            else if(depth_temp < 169){
+                depth.r = 0;
+                depth.g = 255;
+                depth.b = 255 - (depth_temp - 128) * 6;
+            }
+            else if(depth_temp < 212){
+                depth.r = (depth_temp - 169) * 6;
+                depth.g = 255;
+                depth.b = 0;
+            }
+            else if(depth_temp < 254){
+                depth.r = 255;
+                depth.g = 255 - (depth_temp - 212) * 6;
+                depth.b = 0;
+            }
+            else{
+                depth.r = 255;
+                depth.g = 0;
+                depth.b = 0;
+            }
+            break;
+        case Geometry::ColorMap::JET:
+        {
+            // Piecewise linear blue, cyan, yellow, red
+            double value = depth_temp / 255.0;
+            double red   = std::min(std::max(1.5 - std::abs(4.0*value - 3.0), 0.0), 1.0);
+            double green = std::min(std::max(1.5 - std::abs(4.0*value - 2.0), 0.0), 1.0);
+            double blue  = std::min(std::max(1.5 - std::abs(4.0*value - 1.0), 0.0), 1.0);
+            depth.r = (unsigned char) (red   * 255);
+            depth.g = (unsigned char) (green * 255);
+            depth.b = (unsigned char) (blue  * 255);
+            break;
+        }
+        case Geometry::ColorMap::GRAYSCALE:
+            depth.r = depth_temp;
+            depth.g = depth_temp;
+            depth.b = depth_temp;
+            break;
+        case Geometry::ColorMap::INVALID:
+        default:
+            return false;
+        }
+
+        table[depth_temp][0] = depth.b;
+        table[depth_temp][1] = depth.g;
+        table[depth_temp][2] = depth.r;
+    }
+
+    return true;
+}
+
+/** @brief Converts a \ref dlp::Image::Format::MONO_DOUBLE distance map to a color image
+ *
+ *  The distance map is processed row by row on all available cores. The min and max
+ *  distances are found in a single pass and each pixel is colored through a 256 entry
+ *  lookup table. Empty pixels are black.
+ *
+ *  @param[in]  distance_map    Distance map from \ref dlp::Geometry::GeneratePointCloud()
+ *  @param[in]  color_map       \ref dlp::Geometry::ColorMap scale to use
+ *  @param[in]  range_min       Distance mapped to the near end of the scale
+ *  @param[in]  range_max       Distance mapped to the far end of the scale. If range_max
+ *                              is NOT greater than range_min the range is set to the
+ *                              closest and farthest points in the map.
+ *  @param[out] color_depth     Pointer to return \ref dlp::Image::Format::RGB_UCHAR image
+ *  @retval IMAGE_EMPTY                         Distance map has NO data
+ *  @retval IMAGE_STORED_IN_DIFFERENT_FORMAT    Distance map is NOT MONO_DOUBLE
+ *  @retval GEOMETRY_NULL_POINTER               Return argument is NULL
+ *  @retval GEOMETRY_COLOR_MAP_INVALID          Color map is NOT valid
+ */
+ReturnCode Geometry::ConvertDistanceMapToColor(const dlp::Image &distance_map,
+                                               const ColorMap   &color_map,
+                                               const double     &range_min,
+                                               const double     &range_max,
+                                               dlp::Image       *color_depth){
     ReturnCode ret;
 
     if(distance_map.isEmpty())
@@ -1517,106 +2251,81 @@ ReturnCode Geometry::ConvertDistanceMapToColor(const dlp::Image &distance_map, d
     if(!color_depth)
         return ret.AddError(GEOMETRY_NULL_POINTER);
 
-
-
-    // Allocate memory for the distance map
-    double min_distance = 0;
-    double max_distance = 0;
-
-
-    // Create the depth map based
-    unsigned int rows;
-    unsigned int columns;
-
-    distance_map.GetColumns(&columns);
-    distance_map.GetRows(&rows);
-
-    // Find the min and max distances
-    for(    unsigned int xCol = 0; xCol < columns; xCol++){
-        for(unsigned int yRow = 0; yRow < rows; yRow++){
-            double distance;
-
-            // Get the distamce value
-            distance_map.Unsafe_GetPixel( xCol, yRow, &distance);
-
-            if(distance != (double)dlp::DisparityMap::EMPTY_PIXEL){
-
-                // Check if the min and max distances have not been set before
-                if(max_distance == 0 && min_distance == 0){
-                    max_distance = distance;
-                    min_distance = distance;
+    // Build the color lookup table
+    cv::Vec3b table[256];
+    if(!GetColorMapTable(color_map, table))
+        return ret.AddError(GEOMETRY_COLOR_MAP_INVALID);
+
+    // Shallow copy so the const distance map can be read without cloning it
+    dlp::Image distance_shallow(distance_map);
+    cv::Mat    distance;
+    distance_shallow.Unsafe_GetOpenCVData(&distance);
+
+    unsigned int rows    = distance.rows;
+    unsigned int columns = distance.cols;
+    const double empty   = (double) dlp::DisparityMap::EMPTY_PIXEL;
+
+    // Find the min and max distances if a fixed range was not supplied
+    double min_distance = range_min;
+    double max_distance = range_max;
+
+    if(!(range_max > range_min)){
+        std::mutex range_lock;
+        min_distance =  std::numeric_limits<double>::max();
+        max_distance = -std::numeric_limits<double>::max();
+
+        dlp::Thread::ParallelFor(0, rows, [&](unsigned long long first, unsigned long long last){
+            double chunk_min =  std::numeric_limits<double>::max();
+            double chunk_max = -std::numeric_limits<double>::max();
+
+            for(unsigned long long yRow = first; yRow < last; yRow++){
+                const double *row = distance.ptr<double>(yRow);
+                for(unsigned int xCol = 0; xCol < columns; xCol++){
+                    if(row[xCol] == empty) continue;
+                    if(row[xCol] < chunk_min) chunk_min = row[xCol];
+                    if(row[xCol] > chunk_max) chunk_max = row[xCol];
                 }
-
-                // Check the point distance for the depth map
-                if(distance < min_distance) min_distance = distance;
-                if(distance > max_distance) max_distance = distance;
             }
-        }
+
+            std::lock_guard<std::mutex> guard(range_lock);
+            if(chunk_min < min_distance) min_distance = chunk_min;
+            if(chunk_max > max_distance) max_distance = chunk_max;
+        }, 16);
     }
 
     // Allocate memory for the color depth image
     color_depth->Clear();
     color_depth->Create(columns,rows,Image::Format::RGB_UCHAR);
-    color_depth->FillImage(PixelRGB(0,0,0));
+
+    cv::Mat color;
+    color_depth->Unsafe_GetOpenCVData(&color);
+
+    double range = 0.0;
+    if(max_distance > min_distance) range = max_distance - min_distance;
 
     // Convert distance to color
-    for(    unsigned int xCol = 0; xCol < columns; xCol++){
-        for(unsigned int yRow = 0; yRow < rows; yRow++){
-            double          distance;
-            PixelRGB        depth;
-            unsigned char   depth_temp;
-
-            // Get the distamce value
-            distance_map.Unsafe_GetPixel( xCol, yRow, &distance);
-
-            // Check that distance is greater than zero
-            if(distance != (double)dlp::DisparityMap::EMPTY_PIXEL){
-
-                // Scale the distance point so that it is a value between 0 and 255
-                depth_temp = (unsigned char) ((max_distance - distance) * 255 / (max_distance - min_distance));
-
-                // Determine the color
-                if(depth_temp < 43){
-                    depth.r = depth_temp * 6;
-                    depth.g = 0;
-                    depth.b = depth_temp * 6;
-                }
-                if(depth_temp > 42 && depth_temp < 85){
-                    depth.r = 255 - (depth_temp - 43) * 6;
-                    depth.g = 0;
-                    depth.b = 255;
-                }
-                if(depth_temp > 84 && depth_temp < 128){
-                    depth.r = 0;
-                    depth.g = (depth_temp - 85) * 6;
-                    depth.b = 255;
-                }
-                if(depth_temp > 127 && depth_temp < 169){
-                    depth.r = 0;
-                    depth.g = 255;
-                    depth.b = 255 - (depth_temp - 128) * 6;
-                }
-                if(depth_temp > 168 && depth_temp < 212){
-                    depth.r = (depth_temp - 169) * 6;
-                    depth.g = 255;
-                    depth.b = 0;
-                }
-                if(depth_temp > 211 && depth_temp < 254){
-                    depth.r = 255;
-                    depth.g = 255 - (depth_temp - 212) * 6;
-                    depth.b = 0;
-                }
-                if(depth_temp > 253){
-                    depth.r = 255;
-                    depth.g = 0;
-                    depth.b = 0;
+    dlp::Thread::ParallelFor(0, rows, [&](unsigned long long first, unsigned long long last){
+        for(unsigned long long yRow = first; yRow < last; yRow++){
+            const double *row     = distance.ptr<double>(yRow);
+            cv::Vec3b    *row_out = color.ptr<cv::Vec3b>(yRow);
+
+            for(unsigned int xCol = 0; xCol < columns; xCol++){
+                if(row[xCol] == empty){
+                    row_out[xCol] = cv::Vec3b(0,0,0);
+                    continue;
                 }
 
-                // Save the value
-                color_depth->Unsafe_SetPixel(xCol,yRow,depth);
+                // Scale the distance point so that it is a value between 0 and 255.
+                // Dividing per pixel keeps the table index of the original scale.
+                double depth_temp = 0.0;
+                if(range > 0) depth_temp = (max_distance - row[xCol]) * 255 / range;
+                if(depth_temp < 0)   depth_temp = 0;
+                if(depth_temp > 255) depth_temp = 255;
+
+                row_out[xCol] = table[(unsigned char) depth_temp];
             }
         }
-    }
+    }, 16);
 
     return ret;
 }
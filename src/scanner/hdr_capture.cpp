@@ -0,0 +1,529 @@
+/** @file   hdr_capture.cpp
+ *  @brief  Contains methods for the \ref dlp::HdrCapture class
+ *  @copyright  2016 Texas Instruments Incorporated - http://www.ti.com/ ALL RIGHTS RESERVED
+ */
+
+#include <common/returncode.hpp>
+#include <common/debug.hpp>
+#include <common/other.hpp>
+#include <common/image/image.hpp>
+#include <common/parameters.hpp>
+#include <common/capture/capture.hpp>
+#include <camera/camera.hpp>
+#include <dlp_platforms/dlp_platform.hpp>
+#include <scanner/hdr_capture.hpp>
+
+#include <opencv2/opencv.hpp>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+/** @brief  Contains all DLP SDK classes, functions, etc. */
+namespace dlp{
+
+HdrCapture::HdrCapture(){
+    this->debug_.SetName("HDR_CAPTURE_DEBUG(" + dlp::Number::ToString(this)+ "): ");
+    this->debug_.Msg("Constructing...");
+
+    this->is_setup_  = false;
+    this->camera_    = nullptr;
+    this->projector_ = nullptr;
+
+    this->debug_.Msg("Constructed");
+}
+
+HdrCapture::~HdrCapture(){
+    this->debug_.Msg("Deconstructing...");
+    this->exposures_.clear();
+    this->debug_.Msg("Deconstructed");
+}
+
+/** @brief  Sets the fusion method, the saturation and black levels, and the capture bit depth
+ *  @retval HDR_CAPTURE_FUSION_INVALID              Fusion method is invalid
+ *  @retval HDR_CAPTURE_CAPTURE_BIT_DEPTH_INVALID   Capture bit depth is NOT 0 or between 8 and 16
+ */
+ReturnCode HdrCapture::Setup(const dlp::Parameters &settings){
+    ReturnCode ret;
+
+    if(settings.Contains(this->fusion_method_)){
+        Parameters::FusionMethod fusion_method;
+        settings.Get(&fusion_method);
+        if(fusion_method.Get() == Fusion::INVALID)
+            return ret.AddError(HDR_CAPTURE_FUSION_INVALID);
+        this->fusion_method_.Set(fusion_method.Get());
+    }
+
+    if(settings.Contains(this->saturation_level_))
+        settings.Get(&this->saturation_level_);
+
+    if(settings.Contains(this->black_level_))
+        settings.Get(&this->black_level_);
+
+    if(settings.Contains(this->capture_bit_depth_)){
+        Parameters::CaptureBitDepth capture_bit_depth;
+        settings.Get(&capture_bit_depth);
+        if((capture_bit_depth.Get() != 0) &&
+           ((capture_bit_depth.Get() < 8) || (capture_bit_depth.Get() > 16)))
+            return ret.AddError(HDR_CAPTURE_CAPTURE_BIT_DEPTH_INVALID);
+        this->capture_bit_depth_.Set(capture_bit_depth.Get());
+    }
+
+    this->is_setup_ = true;
+    return ret;
+}
+
+ReturnCode HdrCapture::GetSetup(dlp::Parameters *settings) const{
+    ReturnCode ret;
+
+    if(!settings)
+        return ret.AddError(HDR_CAPTURE_NULL_POINTER_ARGUMENT);
+
+    settings->Set(this->fusion_method_);
+    settings->Set(this->saturation_level_);
+    settings->Set(this->black_level_);
+    settings->Set(this->capture_bit_depth_);
+
+    return ret;
+}
+
+/** @brief  Sets the camera whose shutter is changed for each exposure */
+ReturnCode HdrCapture::SetCamera(dlp::Camera *camera){
+    ReturnCode ret;
+
+    if(!camera)
+        return ret.AddError(HDR_CAPTURE_NULL_POINTER_ARGUMENT);
+
+    this->camera_ = camera;
+    return ret;
+}
+
+/** @brief  Sets the projector which displays the sequence for each exposure.
+ *          Its pattern sequence must already be prepared.
+ */
+ReturnCode HdrCapture::SetDlpPlatform(dlp::DLP_Platform *projector){
+    ReturnCode ret;
+
+    if(!projector)
+        return ret.AddError(HDR_CAPTURE_NULL_POINTER_ARGUMENT);
+
+    this->projector_ = projector;
+    return ret;
+}
+
+/** @brief  Sets the camera shutter time of each exposure
+ *  @param[in]  shutter_ms  Shutter times in milliseconds, in any order
+ *  @retval HDR_CAPTURE_EXPOSURES_MISSING   No exposures were given
+ *  @retval HDR_CAPTURE_EXPOSURE_INVALID    An exposure is NOT greater than zero
+ */
+ReturnCode HdrCapture::SetExposures(const std::vector<float> &shutter_ms){
+    ReturnCode ret;
+
+    if(shutter_ms.empty())
+        return ret.AddError(HDR_CAPTURE_EXPOSURES_MISSING);
+
+    for(unsigned int iExposure = 0; iExposure < shutter_ms.size(); iExposure++){
+        if(!(shutter_ms.at(iExposure) > 0))
+            return ret.AddError(HDR_CAPTURE_EXPOSURE_INVALID);
+    }
+
+    this->exposures_ = shutter_ms;
+    return ret;
+}
+
+void HdrCapture::GetExposures(std::vector<float> *shutter_ms) const{
+    if(shutter_ms) (*shutter_ms) = this->exposures_;
+}
+
+/** @brief  Projects and captures the patterns at every exposure and fuses them
+ *  @param[in]  pattern_start           Index of the first pattern in the prepared projector sequence
+ *  @param[in]  pattern_count           Number of patterns, which is the number of frames captured per exposure
+ *  @param[out] ret_capture_sequence    Return pointer for the fused captures
+ *  @retval HDR_CAPTURE_CAMERA_NOT_SET          \ref SetCamera() was NOT called
+ *  @retval HDR_CAPTURE_DLP_PLATFORM_NOT_SET    \ref SetDlpPlatform() was NOT called
+ *  @retval HDR_CAPTURE_EXPOSURES_MISSING       \ref SetExposures() was NOT called
+ *
+ *  The camera shutter is restored after the last exposure. Cameras which
+ *  apply a new shutter time a few frames late must be set up to do so
+ *  before their next capture sequence.
+ */
+ReturnCode HdrCapture::CaptureSequence(const unsigned int &pattern_start,
+                                       const unsigned int &pattern_count,
+                                       Capture::Sequence *ret_capture_sequence){
+    ReturnCode ret;
+
+    if(!ret_capture_sequence)
+        return ret.AddError(HDR_CAPTURE_NULL_POINTER_ARGUMENT);
+
+    if(!this->camera_)
+        return ret.AddError(HDR_CAPTURE_CAMERA_NOT_SET);
+
+    if(!this->projector_)
+        return ret.AddError(HDR_CAPTURE_DLP_PLATFORM_NOT_SET);
+
+    if(this->exposures_.empty())
+        return ret.AddError(HDR_CAPTURE_EXPOSURES_MISSING);
+
+    // Remember the shutter so it can be restored
+    dlp::Parameters original_settings;
+    dlp::Camera::Parameters::Shutter_MS original_shutter;
+    this->camera_->GetSetup(&original_settings);
+    bool restore_shutter = original_settings.Contains(original_shutter);
+    if(restore_shutter) original_settings.Get(&original_shutter);
+
+    std::vector<Capture::Sequence> exposure_sequences(this->exposures_.size());
+
+    for(unsigned int iExposure = 0; iExposure < this->exposures_.size(); iExposure++){
+        dlp::Parameters shutter_settings;
+        shutter_settings.Set(dlp::Camera::Parameters::Shutter_MS(this->exposures_.at(iExposure)));
+
+        ret = this->camera_->Setup(shutter_settings);
+        if(ret.hasErrors()) break;
+
+        ret = this->projector_->StartPatternSequence(pattern_start, pattern_count, false);
+        if(ret.hasErrors()) break;
+
+        ret = this->camera_->GetCaptureSequence(pattern_count, &exposure_sequences.at(iExposure));
+        if(ret.hasErrors()) break;
+
+        this->debug_.Msg("Captured exposure of " + dlp::Number::ToString(this->exposures_.at(iExposure)) + " ms");
+    }
+
+    if(restore_shutter){
+        dlp::Parameters shutter_settings;
+        shutter_settings.Set(original_shutter);
+        this->camera_->Setup(shutter_settings);
+    }
+
+    if(ret.hasErrors())
+        return ret;
+
+    return this->Fuse(exposure_sequences, ret_capture_sequence);
+}
+
+/** @brief  Selects the exposure of each pixel with the most unsaturated contrast
+ *  @param[in]  images      Captures of each exposure, ordered from the shortest exposure
+ *  @param[in]  saturation  Pixel value at which a capture is saturated
+ *  @param[out] fused       Fused captures, allocated with the capture type
+ */
+template <typename T>
+static void FuseBestContrast(const std::vector< std::vector<cv::Mat> > &images,
+                             const unsigned int &saturation,
+                             std::vector<cv::Mat> *fused){
+
+    const unsigned int exposure_count = images.size();
+    const unsigned int pattern_count  = images.front().size();
+    const int rows    = images.front().front().rows;
+    const int columns = images.front().front().cols;
+
+    dlp::Thread::ParallelFor(0, rows, [&](unsigned long long first, unsigned long long last){
+        std::vector<int>            row_min(columns);
+        std::vector<int>            row_max(columns);
+        std::vector<int>            best_contrast(columns);
+        std::vector<unsigned char>  best_exposure(columns);
+        std::vector<const T*>       exposure_pixels(exposure_count);
+
+        for(unsigned long long yRow = first; yRow < last; yRow++){
+
+            // The shortest exposure is used when every exposure saturates
+            std::fill(best_contrast.begin(), best_contrast.end(), -1);
+            std::fill(best_exposure.begin(), best_exposure.end(), 0);
+
+            for(unsigned int iExposure = 0; iExposure < exposure_count; iExposure++){
+                const T *pixel = images.at(iExposure).at(0).ptr<T>(yRow);
+                for(int xCol = 0; xCol < columns; xCol++){
+                    row_min[xCol] = pixel[xCol];
+                    row_max[xCol] = pixel[xCol];
+                }
+
+                // Find the range of the pixel over the sequence
+                for(unsigned int iPattern = 1; iPattern < pattern_count; iPattern++){
+                    pixel = images.at(iExposure).at(iPattern).ptr<T>(yRow);
+                    for(int xCol = 0; xCol < columns; xCol++){
+                        row_min[xCol] = std::min(row_min[xCol], (int) pixel[xCol]);
+                        row_max[xCol] = std::max(row_max[xCol], (int) pixel[xCol]);
+                    }
+                }
+
+                // Longer exposures replace shorter ones only with more contrast
+                for(int xCol = 0; xCol < columns; xCol++){
+                    int contrast = row_max[xCol] - row_min[xCol];
+                    if((row_max[xCol] < (int) saturation) && (contrast > best_contrast[xCol])){
+                        best_contrast[xCol] = contrast;
+                        best_exposure[xCol] = iExposure;
+                    }
+                }
+            }
+
+            // Copy every capture of the pixel from its exposure
+            for(unsigned int iPattern = 0; iPattern < pattern_count; iPattern++){
+                for(unsigned int iExposure = 0; iExposure < exposure_count; iExposure++)
+                    exposure_pixels[iExposure] = images.at(iExposure).at(iPattern).ptr<T>(yRow);
+
+                T *pixel_fused = fused->at(iPattern).ptr<T>(yRow);
+                for(int xCol = 0; xCol < columns; xCol++){
+                    pixel_fused[xCol] = exposure_pixels[best_exposure[xCol]][xCol];
+                }
+            }
+        }
+    }, 8);
+}
+
+/** @brief  Merges the unsaturated exposures of each capture into radiance
+ *  @param[in]  images      Captures of each exposure, ordered from the shortest exposure
+ *  @param[in]  exposures   Exposure times, ordered from the shortest
+ *  @param[in]  saturation  Pixel value at which a capture is saturated
+ *  @param[in]  black       Pixel value without any light
+ *  @param[out] fused       Fused CV_16UC1 captures in units of the longest exposure
+ *
+ *  For shot noise limited captures the best estimate of the radiance is the
+ *  sum of the unsaturated signals over the sum of their exposure times.
+ */
+template <typename T>
+static void FuseRadianceWeighted(const std::vector< std::vector<cv::Mat> > &images,
+                                 const std::vector<float> &exposures,
+                                 const unsigned int &saturation,
+                                 const unsigned int &black,
+                                 std::vector<cv::Mat> *fused){
+
+    const unsigned int exposure_count = images.size();
+    const unsigned int pattern_count  = images.front().size();
+    const int   rows     = images.front().front().rows;
+    const int   columns  = images.front().front().cols;
+    const float shortest = exposures.front();
+    const float longest  = exposures.back();
+
+    dlp::Thread::ParallelFor(0, rows, [&](unsigned long long first, unsigned long long last){
+        std::vector<float> signal(columns);
+        std::vector<float> time(columns);
+
+        for(unsigned long long yRow = first; yRow < last; yRow++){
+            for(unsigned int iPattern = 0; iPattern < pattern_count; iPattern++){
+                std::fill(signal.begin(), signal.end(), 0.0f);
+                std::fill(time.begin(),   time.end(),   0.0f);
+
+                for(unsigned int iExposure = 0; iExposure < exposure_count; iExposure++){
+                    const T     *pixel    = images.at(iExposure).at(iPattern).ptr<T>(yRow);
+                    const float exposure = exposures.at(iExposure);
+
+                    for(int xCol = 0; xCol < columns; xCol++){
+                        bool valid = (pixel[xCol] < saturation);
+                        signal[xCol] += valid ? ((float) pixel[xCol] - (float) black) : 0.0f;
+                        time[xCol]   += valid ? exposure : 0.0f;
+                    }
+                }
+
+                // Saturated in every exposure, the shortest is the lower bound
+                const T        *pixel_shortest = images.front().at(iPattern).ptr<T>(yRow);
+                unsigned short *pixel_fused    = fused->at(iPattern).ptr<unsigned short>(yRow);
+
+                for(int xCol = 0; xCol < columns; xCol++){
+                    float radiance = (time[xCol] > 0) ? (signal[xCol] / time[xCol]) :
+                                                        (((float) pixel_shortest[xCol] - (float) black) / shortest);
+                    pixel_fused[xCol] = cv::saturate_cast<unsigned short>((radiance * longest) + black);
+                }
+            }
+        }
+    }, 8);
+}
+
+/** @brief  Fuses the captures of the same sequence taken at each exposure
+ *  @param[in]  exposure_sequences      Captures of each exposure in the order given to \ref SetExposures()
+ *  @param[out] ret_capture_sequence    Return pointer for the fused captures
+ *  @retval HDR_CAPTURE_EXPOSURES_MISSING       \ref SetExposures() was NOT called
+ *  @retval HDR_CAPTURE_SEQUENCE_COUNT_INVALID  Number of sequences does NOT match the number of exposures
+ *  @retval HDR_CAPTURE_SEQUENCE_SIZE_INVALID   Sequences are empty or have different lengths
+ *  @retval HDR_CAPTURE_DATA_TYPE_INVALID       A capture does NOT contain image data or a file name
+ *  @retval HDR_CAPTURE_IMAGE_SIZE_INVALID      Captures do NOT share one resolution
+ *  @retval HDR_CAPTURE_IMAGE_FORMAT_INVALID    Captures are NOT all 8-bit or all 16-bit
+ *  @retval HDR_CAPTURE_SATURATION_LEVEL_MISSING    16-bit captures without a saturation level or capture bit depth
+ *
+ *  Captures are converted to monochrome. The fused sequence keeps the camera
+ *  and pattern IDs of the first exposure.
+ */
+ReturnCode HdrCapture::Fuse(const std::vector<Capture::Sequence> &exposure_sequences,
+                            Capture::Sequence *ret_capture_sequence) const{
+    ReturnCode ret;
+
+    if(!ret_capture_sequence)
+        return ret.AddError(HDR_CAPTURE_NULL_POINTER_ARGUMENT);
+
+    if(this->exposures_.empty())
+        return ret.AddError(HDR_CAPTURE_EXPOSURES_MISSING);
+
+    if(exposure_sequences.size() != this->exposures_.size())
+        return ret.AddError(HDR_CAPTURE_SEQUENCE_COUNT_INVALID);
+
+    const unsigned int pattern_count = exposure_sequences.front().GetCount();
+    if(pattern_count == 0)
+        return ret.AddError(HDR_CAPTURE_SEQUENCE_SIZE_INVALID);
+
+    // Sort the exposures from the shortest
+    std::vector<unsigned int> order(this->exposures_.size());
+    for(unsigned int iExposure = 0; iExposure < order.size(); iExposure++) order.at(iExposure) = iExposure;
+    std::stable_sort(order.begin(), order.end(), [this](const unsigned int &a, const unsigned int &b){
+        return this->exposures_.at(a) < this->exposures_.at(b);
+    });
+
+    std::vector<float>                      exposures;
+    std::vector< std::vector<dlp::Image> >  images(order.size());
+    std::vector< std::vector<cv::Mat> >     image_data(order.size());
+    std::vector<dlp::Capture>               first_captures;
+
+    unsigned int       columns = 0;
+    unsigned int       rows    = 0;
+    dlp::Image::Format format  = dlp::Image::Format::INVALID;
+
+    for(unsigned int iExposure = 0; iExposure < order.size(); iExposure++){
+        const Capture::Sequence &sequence = exposure_sequences.at(order.at(iExposure));
+        exposures.push_back(this->exposures_.at(order.at(iExposure)));
+
+        if(sequence.GetCount() != pattern_count)
+            return ret.AddError(HDR_CAPTURE_SEQUENCE_SIZE_INVALID);
+
+        for(unsigned int iPattern = 0; iPattern < pattern_count; iPattern++){
+            dlp::Capture capture;
+            dlp::Image   image;
+
+            ret = sequence.Get(iPattern, &capture);
+            if(ret.hasErrors())
+                return ret;
+
+            switch(capture.data_type){
+            case dlp::Capture::DataType::IMAGE_FILE:
+                ret = image.Load(capture.image_file);
+                if(ret.hasErrors())
+                    return ret;
+                break;
+            case dlp::Capture::DataType::IMAGE_DATA:
+                if(capture.image_data.isEmpty())
+                    return ret.AddError(IMAGE_EMPTY);
+                ret = image.Create(capture.image_data);
+                if(ret.hasErrors())
+                    return ret;
+                break;
+            case dlp::Capture::DataType::INVALID:
+            default:
+                return ret.AddError(HDR_CAPTURE_DATA_TYPE_INVALID);
+            }
+
+            image.ConvertToMonochrome();
+
+            unsigned int       image_columns;
+            unsigned int       image_rows;
+            dlp::Image::Format image_format;
+            image.GetColumns(&image_columns);
+            image.GetRows(&image_rows);
+            image.GetDataFormat(&image_format);
+
+            if((iExposure == 0) && (iPattern == 0)){
+                columns = image_columns;
+                rows    = image_rows;
+                format  = image_format;
+
+                if((format != dlp::Image::Format::MONO_UCHAR) &&
+                   (format != dlp::Image::Format::MONO_USHORT))
+                    return ret.AddError(HDR_CAPTURE_IMAGE_FORMAT_INVALID);
+            }
+
+            if((image_columns != columns) || (image_rows != rows))
+                return ret.AddError(HDR_CAPTURE_IMAGE_SIZE_INVALID);
+
+            if(image_format != format)
+                return ret.AddError(HDR_CAPTURE_IMAGE_FORMAT_INVALID);
+
+            cv::Mat data;
+            image.Unsafe_GetOpenCVData(&data);
+            images.at(iExposure).push_back(image);
+            image_data.at(iExposure).push_back(data);
+
+            if(order.at(iExposure) == 0) first_captures.push_back(capture);
+        }
+    }
+
+    // Allocate the fused captures
+    const bool radiance     = (this->fusion_method_.Get() == Fusion::RADIANCE_WEIGHTED);
+    const bool sixteen_bit  = (format == dlp::Image::Format::MONO_USHORT);
+    const int  fused_type   = (radiance || sixteen_bit) ? CV_16UC1 : CV_8UC1;
+
+    // A saturation level of 0 follows the depth of the captures. The depth
+    // of 16-bit captures must be given since Mono12 data never reaches a
+    // 16-bit level.
+    unsigned int saturation = this->saturation_level_.Get();
+    if((saturation == 0) && !sixteen_bit)
+        saturation = HDR_CAPTURE_SATURATION_LEVEL_8BIT;
+
+    if(saturation == 0){
+        if(this->capture_bit_depth_.Get() == 0)
+            return ret.AddError(HDR_CAPTURE_SATURATION_LEVEL_MISSING);
+        saturation = HDR_CAPTURE_SATURATION_LEVEL_8BIT << (this->capture_bit_depth_.Get() - 8);
+    }
+
+    std::vector<cv::Mat> fused(pattern_count);
+    for(unsigned int iPattern = 0; iPattern < pattern_count; iPattern++)
+        fused.at(iPattern).create(rows, columns, fused_type);
+
+    switch(this->fusion_method_.Get()){
+    case Fusion::BEST_CONTRAST:
+        if(sixteen_bit) FuseBestContrast<unsigned short>(image_data, saturation, &fused);
+        else            FuseBestContrast<unsigned char>( image_data, saturation, &fused);
+        break;
+    case Fusion::RADIANCE_WEIGHTED:
+        if(sixteen_bit) FuseRadianceWeighted<unsigned short>(image_data, exposures, saturation,
+                                                             this->black_level_.Get(), &fused);
+        else            FuseRadianceWeighted<unsigned char>( image_data, exposures, saturation,
+                                                             this->black_level_.Get(), &fused);
+        break;
+    case Fusion::INVALID:
+    default:
+        return ret.AddError(HDR_CAPTURE_FUSION_INVALID);
+    }
+
+    // Release the exposures before returning the fused captures
+    image_data.clear();
+    images.clear();
+
+    ret_capture_sequence->Clear();
+    for(unsigned int iPattern = 0; iPattern < pattern_count; iPattern++){
+        dlp::Capture capture;
+        capture.camera_id  = first_captures.at(iPattern).camera_id;
+        capture.pattern_id = first_captures.at(iPattern).pattern_id;
+        capture.data_type  = dlp::Capture::DataType::IMAGE_DATA;
+
+        ret = capture.image_data.Create(fused.at(iPattern));
+        if(ret.hasErrors())
+            return ret;
+
+        ret_capture_sequence->Add(capture);
+    }
+
+    return ret;
+}
+
+namespace Number{
+template <> std::string ToString<dlp::HdrCapture::Fusion>( dlp::HdrCapture::Fusion fusion ){
+    switch(fusion){
+    case dlp::HdrCapture::Fusion::BEST_CONTRAST:        return "BEST_CONTRAST";
+    case dlp::HdrCapture::Fusion::RADIANCE_WEIGHTED:    return "RADIANCE_WEIGHTED";
+    case dlp::HdrCapture::Fusion::INVALID:              return "INVALID";
+    }
+    return "INVALID";
+}
+}
+
+namespace String{
+template <> dlp::HdrCapture::Fusion ToNumber( const std::string &text, unsigned int base ){
+    // Ignore base variable
+    if (text.compare("BEST_CONTRAST") == 0){
+        return dlp::HdrCapture::Fusion::BEST_CONTRAST;
+    }
+    else if (text.compare("RADIANCE_WEIGHTED") == 0){
+        return dlp::HdrCapture::Fusion::RADIANCE_WEIGHTED;
+    }
+    else{
+        return dlp::HdrCapture::Fusion::INVALID;
+    }
+}
+}
+
+}
@@ -0,0 +1,513 @@
+/** @file   scan_scheduler.cpp
+ *  @brief  Contains methods for the \ref dlp::ScanScheduler class
+ *  @copyright  2016 Texas Instruments Incorporated - http://www.ti.com/ ALL RIGHTS RESERVED
+ */
+
+#include <common/returncode.hpp>
+#include <common/debug.hpp>
+#include <common/other.hpp>
+#include <common/parameters.hpp>
+#include <common/capture/capture.hpp>
+#include <common/disparity_map.hpp>
+#include <common/point_cloud/point_cloud.hpp>
+#include <camera/camera.hpp>
+#include <dlp_platforms/dlp_platform.hpp>
+#include <structured_light/structured_light.hpp>
+#include <geometry/geometry.hpp>
+#include <scanner/hdr_capture.hpp>
+#include <scanner/scan_scheduler.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/** @brief  Contains all DLP SDK classes, functions, etc. */
+namespace dlp{
+
+/** @brief  Returns the milliseconds elapsed since start */
+static double ElapsedMilliseconds(const std::chrono::steady_clock::time_point &start){
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+ScanScheduler::StageQueue::StageQueue(){
+    this->depth_  = 1;
+    this->closed_ = true;
+}
+
+/** @brief  Empties the queue and accepts up to depth waiting scans */
+void ScanScheduler::StageQueue::Open(const unsigned int &depth){
+    std::lock_guard<std::mutex> lock(this->mutex_);
+    this->scans_.clear();
+    this->depth_  = depth;
+    this->closed_ = false;
+}
+
+/** @brief  Rejects new scans. Scans already queued can still be popped */
+void ScanScheduler::StageQueue::Close(){
+    std::lock_guard<std::mutex> lock(this->mutex_);
+    this->closed_ = true;
+    this->not_full_.notify_all();
+    this->not_empty_.notify_all();
+}
+
+/** @brief  Rejects new scans and drops the queued ones */
+void ScanScheduler::StageQueue::Abort(){
+    std::lock_guard<std::mutex> lock(this->mutex_);
+    this->closed_ = true;
+    this->scans_.clear();
+    this->not_full_.notify_all();
+    this->not_empty_.notify_all();
+}
+
+/** @brief  Waits for room in the queue and adds the scan
+ *  @retval false   The queue was closed
+ */
+bool ScanScheduler::StageQueue::Push(std::shared_ptr<Scan> scan, double *ret_blocked_ms){
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::unique_lock<std::mutex> lock(this->mutex_);
+
+    this->not_full_.wait(lock, [this]{ return this->closed_ || (this->scans_.size() < this->depth_); });
+    *ret_blocked_ms = ElapsedMilliseconds(start);
+
+    if(this->closed_) return false;
+
+    this->scans_.push_back(scan);
+    this->not_empty_.notify_one();
+    return true;
+}
+
+/** @brief  Waits for a scan and removes it from the queue
+ *  @retval false   The queue was closed and is empty
+ */
+bool ScanScheduler::StageQueue::Pop(std::shared_ptr<Scan> *ret_scan, double *ret_starved_ms){
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::unique_lock<std::mutex> lock(this->mutex_);
+
+    this->not_empty_.wait(lock, [this]{ return this->closed_ || !this->scans_.empty(); });
+    *ret_starved_ms = ElapsedMilliseconds(start);
+
+    if(this->scans_.empty()) return false;
+
+    *ret_scan = this->scans_.front();
+    this->scans_.pop_front();
+    this->not_full_.notify_one();
+    return true;
+}
+
+ScanScheduler::ScanScheduler(){
+    this->debug_.SetName("SCAN_SCHEDULER_DEBUG(" + dlp::Number::ToString(this)+ "): ");
+    this->debug_.Msg("Constructing...");
+
+    this->is_setup_     = false;
+    this->camera_       = nullptr;
+    this->projector_    = nullptr;
+    this->geometry_     = nullptr;
+    this->hdr_capture_  = nullptr;
+    this->viewport_id_  = 0;
+    this->running_      = false;
+    this->stop_         = false;
+
+    this->statistics_       = Statistics();
+    this->latency_total_ms_ = 0;
+
+    this->debug_.Msg("Constructed");
+}
+
+ScanScheduler::~ScanScheduler(){
+    this->debug_.Msg("Deconstructing...");
+    this->Stop();
+    this->debug_.Msg("Deconstructed");
+}
+
+/** @brief  Sets the queue depth between the stages
+ *  @retval SCAN_SCHEDULER_ALREADY_RUNNING      Scans are in progress
+ *  @retval SCAN_SCHEDULER_QUEUE_DEPTH_INVALID  Queue depth is zero
+ */
+ReturnCode ScanScheduler::Setup(const dlp::Parameters &settings){
+    ReturnCode ret;
+
+    if(this->isRunning())
+        return ret.AddError(SCAN_SCHEDULER_ALREADY_RUNNING);
+
+    if(settings.Contains(this->queue_depth_)){
+        Parameters::QueueDepth queue_depth;
+        settings.Get(&queue_depth);
+        if(queue_depth.Get() == 0)
+            return ret.AddError(SCAN_SCHEDULER_QUEUE_DEPTH_INVALID);
+        this->queue_depth_.Set(queue_depth.Get());
+    }
+
+    if(settings.Contains(this->keep_captures_))
+        settings.Get(&this->keep_captures_);
+
+    this->is_setup_ = true;
+    return ret;
+}
+
+ReturnCode ScanScheduler::GetSetup(dlp::Parameters *settings) const{
+    ReturnCode ret;
+
+    if(!settings)
+        return ret.AddError(SCAN_SCHEDULER_NULL_POINTER_ARGUMENT);
+
+    settings->Set(this->queue_depth_);
+    settings->Set(this->keep_captures_);
+
+    return ret;
+}
+
+/** @brief  Sets the camera used by the capture stage */
+ReturnCode ScanScheduler::SetCamera(dlp::Camera *camera){
+    ReturnCode ret;
+
+    if(!camera)
+        return ret.AddError(SCAN_SCHEDULER_NULL_POINTER_ARGUMENT);
+
+    if(this->isRunning())
+        return ret.AddError(SCAN_SCHEDULER_ALREADY_RUNNING);
+
+    this->camera_ = camera;
+    return ret;
+}
+
+/** @brief  Sets the projector used by the capture stage. Its pattern sequence
+ *          must already be prepared.
+ */
+ReturnCode ScanScheduler::SetDlpPlatform(dlp::DLP_Platform *projector){
+    ReturnCode ret;
+
+    if(!projector)
+        return ret.AddError(SCAN_SCHEDULER_NULL_POINTER_ARGUMENT);
+
+    if(this->isRunning())
+        return ret.AddError(SCAN_SCHEDULER_ALREADY_RUNNING);
+
+    this->projector_ = projector;
+    return ret;
+}
+
+/** @brief  Adds a structured light module and the prepared patterns it decodes
+ *  @param[in]  module          Structured light module which is already setup
+ *  @param[in]  pattern_start   Index of the module's first pattern in the projector sequence
+ *  @param[in]  pattern_count   Number of patterns, which is the number of frames captured
+ *  @retval SCAN_SCHEDULER_TOO_MANY_MODULES         Two modules have already been added
+ *  @retval SCAN_SCHEDULER_PATTERN_COUNT_INVALID    Pattern count is zero
+ */
+ReturnCode ScanScheduler::AddStructuredLight(dlp::StructuredLight *module,
+                                             const unsigned int &pattern_start,
+                                             const unsigned int &pattern_count){
+    ReturnCode ret;
+
+    if(!module)
+        return ret.AddError(SCAN_SCHEDULER_NULL_POINTER_ARGUMENT);
+
+    if(this->isRunning())
+        return ret.AddError(SCAN_SCHEDULER_ALREADY_RUNNING);
+
+    if(this->modules_.size() >= 2)
+        return ret.AddError(SCAN_SCHEDULER_TOO_MANY_MODULES);
+
+    if(pattern_count == 0)
+        return ret.AddError(SCAN_SCHEDULER_PATTERN_COUNT_INVALID);
+
+    ModuleEntry entry;
+    entry.module        = module;
+    entry.pattern_start = pattern_start;
+    entry.pattern_count = pattern_count;
+    this->modules_.push_back(entry);
+
+    return ret;
+}
+
+/** @brief  Sets the geometry object and viewport used by the triangulation stage */
+ReturnCode ScanScheduler::SetGeometry(dlp::Geometry *geometry, const unsigned int &viewport_id){
+    ReturnCode ret;
+
+    if(!geometry)
+        return ret.AddError(SCAN_SCHEDULER_NULL_POINTER_ARGUMENT);
+
+    if(this->isRunning())
+        return ret.AddError(SCAN_SCHEDULER_ALREADY_RUNNING);
+
+    this->geometry_    = geometry;
+    this->viewport_id_ = viewport_id;
+    return ret;
+}
+
+/** @brief  Sets the multi-exposure capture used by the capture stage. Its
+ *          exposures must already be set. The scheduler's camera and projector
+ *          are assigned to it when the scans start.
+ */
+ReturnCode ScanScheduler::SetHdrCapture(dlp::HdrCapture *hdr_capture){
+    ReturnCode ret;
+
+    if(!hdr_capture)
+        return ret.AddError(SCAN_SCHEDULER_NULL_POINTER_ARGUMENT);
+
+    if(this->isRunning())
+        return ret.AddError(SCAN_SCHEDULER_ALREADY_RUNNING);
+
+    this->hdr_capture_ = hdr_capture;
+    return ret;
+}
+
+/** @brief  Removes the camera, projector, structured light, geometry, and HDR capture objects */
+void ScanScheduler::ClearModules(){
+    if(this->isRunning()) return;
+
+    this->camera_      = nullptr;
+    this->projector_   = nullptr;
+    this->geometry_    = nullptr;
+    this->hdr_capture_ = nullptr;
+    this->modules_.clear();
+}
+
+/** @brief  Starts the pipeline threads
+ *  @param[in]  scans   Number of scans to perform. Zero scans until \ref Stop() is called.
+ *  @retval SCAN_SCHEDULER_ALREADY_RUNNING          Scans are in progress
+ *  @retval SCAN_SCHEDULER_CAMERA_NOT_SET           \ref SetCamera() was NOT called
+ *  @retval SCAN_SCHEDULER_DLP_PLATFORM_NOT_SET     \ref SetDlpPlatform() was NOT called
+ *  @retval SCAN_SCHEDULER_STRUCTURED_LIGHT_NOT_SET \ref AddStructuredLight() was NOT called
+ */
+ReturnCode ScanScheduler::Start(const unsigned long long &scans){
+    ReturnCode ret;
+
+    if(this->isRunning())
+        return ret.AddError(SCAN_SCHEDULER_ALREADY_RUNNING);
+
+    if(!this->camera_)
+        return ret.AddError(SCAN_SCHEDULER_CAMERA_NOT_SET);
+
+    if(!this->projector_)
+        return ret.AddError(SCAN_SCHEDULER_DLP_PLATFORM_NOT_SET);
+
+    if(this->modules_.empty())
+        return ret.AddError(SCAN_SCHEDULER_STRUCTURED_LIGHT_NOT_SET);
+
+    // Release the threads of the previous run
+    this->Stop();
+
+    if(!this->camera_->isStarted()){
+        ret = this->camera_->Start();
+        if(ret.hasErrors()) return ret;
+    }
+
+    if(this->hdr_capture_){
+        this->hdr_capture_->SetCamera(this->camera_);
+        this->hdr_capture_->SetDlpPlatform(this->projector_);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(this->statistics_mutex_);
+        this->statistics_       = Statistics();
+        this->latency_total_ms_ = 0;
+        this->start_time_       = std::chrono::steady_clock::now();
+    }
+
+    this->decode_queue_.Open(this->queue_depth_.Get());
+    this->triangulate_queue_.Open(this->queue_depth_.Get());
+    this->result_queue_.Open(this->queue_depth_.Get());
+
+    this->stop_    = false;
+    this->running_ = true;
+
+    this->debug_.Msg("Starting " + (scans == 0 ? std::string("continuous") : dlp::Number::ToString(scans)) + " scans...");
+
+    this->capture_thread_     = std::thread(&ScanScheduler::CaptureLoop, this, scans);
+    this->decode_thread_      = std::thread(&ScanScheduler::DecodeLoop, this);
+    this->triangulate_thread_ = std::thread(&ScanScheduler::TriangulateLoop, this);
+
+    return ret;
+}
+
+/** @brief  Waits for the next completed scan
+ *
+ *  Scans are returned in order. A scan whose capture, decode, or
+ *  triangulation failed is still returned with the errors in Scan::ret.
+ *
+ *  @retval SCAN_SCHEDULER_NO_MORE_SCANS    All requested scans were returned or \ref Stop() was called
+ */
+ReturnCode ScanScheduler::GetScan(Scan *ret_scan){
+    ReturnCode ret;
+
+    if(!ret_scan)
+        return ret.AddError(SCAN_SCHEDULER_NULL_POINTER_ARGUMENT);
+
+    std::shared_ptr<Scan> scan;
+    double starved_ms = 0;
+
+    if(!this->result_queue_.Pop(&scan, &starved_ms))
+        return ret.AddError(SCAN_SCHEDULER_NO_MORE_SCANS);
+
+    *ret_scan = std::move(*scan);
+    return ret;
+}
+
+/** @brief  Stops capturing, drops the scans in progress, and joins the
+ *          pipeline threads. Returns once the current stage calls finish.
+ */
+ReturnCode ScanScheduler::Stop(){
+    ReturnCode ret;
+
+    this->stop_ = true;
+    this->decode_queue_.Abort();
+    this->triangulate_queue_.Abort();
+    this->result_queue_.Abort();
+
+    if(this->capture_thread_.joinable())     this->capture_thread_.join();
+    if(this->decode_thread_.joinable())      this->decode_thread_.join();
+    if(this->triangulate_thread_.joinable()) this->triangulate_thread_.join();
+
+    this->running_ = false;
+    return ret;
+}
+
+/** @brief  Returns true until the last scan has been triangulated or \ref Stop() was called */
+bool ScanScheduler::isRunning() const{
+    return this->running_;
+}
+
+/** @brief  Returns the per-stage and pipeline timing
+ *
+ *  A stage's throughput is count / busy_ms. The pipeline throughput
+ *  approaches the throughput of the slowest stage, whose starved and blocked
+ *  times stay near zero.
+ */
+ScanScheduler::Statistics ScanScheduler::GetStatistics() const{
+    std::lock_guard<std::mutex> lock(this->statistics_mutex_);
+    return this->statistics_;
+}
+
+void ScanScheduler::Record(StageStatistics *stage, const double &busy_ms, const double &starved_ms, const double &blocked_ms){
+    std::lock_guard<std::mutex> lock(this->statistics_mutex_);
+    stage->count++;
+    stage->busy_ms    += busy_ms;
+    stage->last_ms     = busy_ms;
+    stage->max_ms      = std::max(stage->max_ms, busy_ms);
+    stage->starved_ms += starved_ms;
+    stage->blocked_ms += blocked_ms;
+}
+
+/** @brief  Projects the patterns of every module and captures them */
+void ScanScheduler::CaptureLoop(unsigned long long scans){
+    for(unsigned long long iScan = 0; ((scans == 0) || (iScan < scans)) && !this->stop_; iScan++){
+        std::shared_ptr<Scan> scan = std::make_shared<Scan>();
+        scan->index      = iScan;
+        scan->latency_ms = 0;
+        scan->start      = std::chrono::steady_clock::now();
+        scan->captures.resize(this->modules_.size());
+        scan->disparity_maps.resize(this->modules_.size());
+
+        for(unsigned int iModule = 0; iModule < this->modules_.size(); iModule++){
+            const ModuleEntry &entry = this->modules_.at(iModule);
+
+            // Capture each exposure and fuse them
+            if(this->hdr_capture_){
+                scan->ret = this->hdr_capture_->CaptureSequence(entry.pattern_start, entry.pattern_count,
+                                                                &scan->captures.at(iModule));
+                if(scan->ret.hasErrors()) break;
+            }
+            else{
+                scan->ret = this->projector_->StartPatternSequence(entry.pattern_start, entry.pattern_count, false);
+                if(scan->ret.hasErrors()) break;
+
+                scan->ret = this->camera_->GetCaptureSequence(entry.pattern_count, &scan->captures.at(iModule));
+                if(scan->ret.hasErrors()) break;
+            }
+        }
+
+        double busy_ms    = ElapsedMilliseconds(scan->start);
+        double blocked_ms = 0;
+
+        if(scan->ret.hasErrors())
+            this->debug_.Msg("Scan " + dlp::Number::ToString(iScan) + " capture failed");
+
+        bool queued = this->decode_queue_.Push(scan, &blocked_ms);
+        this->Record(&this->statistics_.capture, busy_ms, 0, blocked_ms);
+        if(!queued) break;
+    }
+
+    this->decode_queue_.Close();
+}
+
+/** @brief  Decodes the captures of every module into disparity maps */
+void ScanScheduler::DecodeLoop(){
+    std::shared_ptr<Scan> scan;
+    double starved_ms = 0;
+
+    while(this->decode_queue_.Pop(&scan, &starved_ms)){
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+        if(!scan->ret.hasErrors()){
+            for(unsigned int iModule = 0; iModule < this->modules_.size(); iModule++){
+                scan->ret = this->modules_.at(iModule).module->DecodeCaptureSequence(&scan->captures.at(iModule),
+                                                                                     &scan->disparity_maps.at(iModule));
+                if(scan->ret.hasErrors()) break;
+            }
+        }
+
+        // Release the frames so the queued scans stay small
+        if(!this->keep_captures_.Get()) scan->captures.clear();
+
+        double busy_ms    = ElapsedMilliseconds(start);
+        double blocked_ms = 0;
+
+        bool queued = this->triangulate_queue_.Push(scan, &blocked_ms);
+        this->Record(&this->statistics_.decode, busy_ms, starved_ms, blocked_ms);
+        if(!queued) break;
+    }
+
+    this->triangulate_queue_.Close();
+}
+
+/** @brief  Generates the point cloud of each scan and hands it to \ref GetScan() */
+void ScanScheduler::TriangulateLoop(){
+    std::shared_ptr<Scan> scan;
+    double starved_ms = 0;
+
+    while(this->triangulate_queue_.Pop(&scan, &starved_ms)){
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+        if(!scan->ret.hasErrors() && this->geometry_){
+            if(scan->disparity_maps.size() == 1){
+                scan->ret = this->geometry_->GeneratePointCloud(this->viewport_id_,
+                                                                scan->disparity_maps.at(0),
+                                                                &scan->cloud,
+                                                                &scan->depth_map);
+            }
+            else{
+                scan->ret = this->geometry_->GeneratePointCloud(this->viewport_id_,
+                                                                scan->disparity_maps.at(0),
+                                                                scan->disparity_maps.at(1),
+                                                                &scan->cloud,
+                                                                &scan->depth_map);
+            }
+        }
+
+        double busy_ms    = ElapsedMilliseconds(start);
+        double blocked_ms = 0;
+        scan->latency_ms  = ElapsedMilliseconds(scan->start);
+
+        {
+            std::lock_guard<std::mutex> lock(this->statistics_mutex_);
+            this->latency_total_ms_ += scan->latency_ms;
+            this->statistics_.scans++;
+            this->statistics_.elapsed_ms         = ElapsedMilliseconds(this->start_time_);
+            this->statistics_.scans_per_second   = 1000.0 * this->statistics_.scans / this->statistics_.elapsed_ms;
+            this->statistics_.latency_last_ms    = scan->latency_ms;
+            this->statistics_.latency_average_ms = this->latency_total_ms_ / this->statistics_.scans;
+        }
+
+        bool queued = this->result_queue_.Push(scan, &blocked_ms);
+        this->Record(&this->statistics_.triangulate, busy_ms, starved_ms, blocked_ms);
+        if(!queued) break;
+    }
+
+    this->result_queue_.Close();
+    this->running_ = false;
+}
+
+}
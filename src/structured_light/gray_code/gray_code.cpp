@@ -15,6 +15,10 @@
 #include <structured_light/gray_code/gray_code.hpp>
 
 #include <math.h>
+#include <limits>
+#include <algorithm>
+#include <vector>
+#include <stdlib.h>
 
 /** @brief  Contains all DLP SDK classes, functions, etc. */
 namespace dlp{
@@ -49,6 +53,12 @@ GrayCode::~GrayCode(){
  * @retval STRUCTURED_LIGHT_SETTINGS_PATTERN_COLUMNS_MISSING            \ref dlp::Parameters list missing \ref dlp::StructuredLight::pattern_columns_
  * @retval STRUCTURED_LIGHT_SETTINGS_PATTERN_ORIENTATION_MISSING        \ref dlp::Parameters list missing \ref dlp::StructuredLight::pattern_orientation_
  * @retval GRAY_CODE_PIXEL_THRESHOLD_MISSING                            \ref dlp::Parameters list missing \ref dlp::GrayCode::pixel_threshold_
+ * @retval GRAY_CODE_CAPTURE_BIT_DEPTH_INVALID                          \ref dlp::GrayCode::capture_bit_depth_ is NOT 0 or between 8 and 16
+ *
+ * The pixel threshold is in 8-bit units. It is shifted up to the depth of
+ * \ref dlp::Image::Format::MONO_USHORT captures, which is 16 bits unless
+ * \ref dlp::GrayCode::Parameters::CaptureBitDepth is set, e.g. 12 for Mono12
+ * cameras or 8 for radiance fused 8-bit captures.
  */
 ReturnCode GrayCode::Setup(const dlp::Parameters &settings){
     ReturnCode ret;
@@ -96,6 +106,27 @@ ReturnCode GrayCode::Setup(const dlp::Parameters &settings){
     if(settings.Get(&this->pixel_threshold_).hasErrors())
         return ret.AddError(GRAY_CODE_PIXEL_THRESHOLD_MISSING);
 
+    // Subpixel decoding is optional. The refined values must stay below
+    // the invalid pixel marker of the disparity map.
+    if(settings.Contains(this->subpixel_sampling_))
+        settings.Get(&this->subpixel_sampling_);
+
+    // The capture bit depth is optional, 0 uses the depth of the captures
+    if(settings.Contains(this->capture_bit_depth_))
+        settings.Get(&this->capture_bit_depth_);
+
+    if((this->capture_bit_depth_.Get() != 0) &&
+       ((this->capture_bit_depth_.Get() < 8) || (this->capture_bit_depth_.Get() > 16)))
+        return ret.AddError(GRAY_CODE_CAPTURE_BIT_DEPTH_INVALID);
+
+    // Confidence rejection limits and band decoding are optional
+    this->SetupRejection(settings);
+    this->SetupBands(settings);
+
+    if((this->subpixel_sampling_.Get() == 0) ||
+       (((unsigned long long) this->resolution_ * this->subpixel_sampling_.Get()) >= (unsigned long long) dlp::DisparityMap::INVALID_PIXEL))
+        return ret.AddError(GRAY_CODE_SUBPIXEL_SAMPLING_INVALID);
+
     if(settings.Contains(this->measure_regions_)){
         // Module will measure regions rather than pixels
         settings.Get(&this->measure_regions_);
@@ -167,6 +198,12 @@ ReturnCode GrayCode::Setup(const dlp::Parameters &settings){
  *  @retval STRUCTURED_LIGHT_NULL_POINTER_ARGUMENT  Return argument is NULL
  *  @retval STRUCTURED_LIGHT_NOT_SETUP              Module has NOT been setup
  *  @retval STRUCTURED_LIGHT_CAPTURE_SEQUENCE_SIZE_INVALID  Requested number of patterns is NOT possible with the specified DMD resolution
+ *
+ *  Sequences are cached by the settings which change the patterns, so
+ *  decode-only settings such as the pixel threshold, confidence rejection,
+ *  and band decoding reuse the cached sequence. The returned pattern
+ *  images may be shared with the cache and should be copied before they
+ *  are modified in place.
  */
 ReturnCode GrayCode::GeneratePatternSequence(Pattern::Sequence *pattern_sequence){
     ReturnCode ret;
@@ -179,6 +216,20 @@ ReturnCode GrayCode::GeneratePatternSequence(Pattern::Sequence *pattern_sequence
     if(!pattern_sequence)
         return ret.AddError(STRUCTURED_LIGHT_NULL_POINTER_ARGUMENT);
 
+    // Reuse the sequence if it was already generated with the same pattern settings
+    dlp::Parameters settings;
+    settings.Set(this->sequence_count_);
+    settings.Set(this->include_inverted_);
+    settings.Set(this->pattern_rows_);
+    settings.Set(this->pattern_columns_);
+    settings.Set(this->pattern_color_);
+    settings.Set(this->pattern_orientation_);
+    settings.Set(this->measure_regions_);
+    const std::string cache_key = "GRAY_CODE\n" + settings.ToString();
+
+    if(GetCachedPatternSequence(cache_key, pattern_sequence))
+        return ret;
+
     // Generate the binary code values
     std::vector< unsigned int > line;
     std::vector< std::vector< unsigned int > > pattern_line;
@@ -257,116 +308,52 @@ ReturnCode GrayCode::GeneratePatternSequence(Pattern::Sequence *pattern_sequence
     // black image for the Albedo threshold
     if(!this->include_inverted_.Get()){
         dlp::Pattern pattern_white;
-        dlp::Image   image_white;
-
         dlp::Pattern pattern_black;
-        dlp::Image   image_black;
-
-
-        // Allocate memory for the albedo images
-        image_white.Create(columns,rows,dlp::Image::Format::MONO_UCHAR);
-        image_black.Create(columns,rows,dlp::Image::Format::MONO_UCHAR);
-
-        // Create the images
-        for(     unsigned int yRow = 0; yRow < rows;    yRow++){
-            for( unsigned int xCol = 0; xCol < columns; xCol++){
-                image_white.Unsafe_SetPixel(xCol,yRow,(unsigned char)255);
-                image_black.Unsafe_SetPixel(xCol,yRow,(unsigned char)0);
-            }
-        }
 
         // Create the white pattern
-        pattern_white.image_data.Create(image_white);
+        pattern_white.image_data.Create(columns,rows,dlp::Image::Format::MONO_UCHAR);
+        pattern_white.image_data.FillImage((unsigned char)255);
         pattern_white.color     = this->pattern_color_.Get();
         pattern_white.data_type = dlp::Pattern::DataType::IMAGE_DATA;
         pattern_white.bitdepth  = dlp::Pattern::Bitdepth::MONO_1BPP;
 
-        // Add the inverted pattern to the sequence
+        // Add the white pattern to the sequence
         pattern_sequence->Add(pattern_white);
 
-        // Create the white pattern
-        pattern_black.image_data.Create(image_black);
+        // Create the black pattern
+        pattern_black.image_data.Create(columns,rows,dlp::Image::Format::MONO_UCHAR);
+        pattern_black.image_data.FillImage((unsigned char)0);
         pattern_black.color     = this->pattern_color_.Get();
         pattern_black.data_type = dlp::Pattern::DataType::IMAGE_DATA;
         pattern_black.bitdepth  = dlp::Pattern::Bitdepth::MONO_1BPP;
 
-        // Add the inverted pattern to the sequence
+        // Add the black pattern to the sequence
         pattern_sequence->Add(pattern_black);
     }
 
 
     // Generate the pattern sequence
+    std::vector< unsigned char > profile(line_size);
+    std::vector< unsigned char > profile_inverted(line_size);
+
     for(unsigned int iPattern = 0; iPattern < this->sequence_count_.Get(); iPattern++){
         dlp::Pattern pattern;
-        dlp::Image   image;
-
         dlp::Pattern pattern_inverted;
-        dlp::Image   image_inverted;
 
-        // Create the new image
-        image.Create(columns,rows,dlp::Image::Format::MONO_UCHAR);
-
-        switch(this->pattern_orientation_.Get()){
-        case dlp::Pattern::Orientation::VERTICAL:
-            // Set the pixels
-            for(     unsigned int yRow = 0; yRow < rows;    yRow++){
-                for( unsigned int xCol = 0; xCol < columns; xCol++){
-                    unsigned int value = pattern_line_gray.at(iPattern).at(xCol + this->offset_);
-                    unsigned char bitplane_value = 255*value;
-
-                    // Save the pixel value
-                    image.Unsafe_SetPixel(xCol,yRow,bitplane_value);
-                }
-            }
-
-            break;
-        case dlp::Pattern::Orientation::HORIZONTAL:
-            // Set the pixels
-            for(     unsigned int yRow = 0; yRow < rows;    yRow++){
-                for( unsigned int xCol = 0; xCol < columns; xCol++){
-                    unsigned int value = pattern_line_gray.at(iPattern).at(yRow + this->offset_);
-                    unsigned char bitplane_value = 255*value;
-
-                    // Save the pixel value
-                    image.Unsafe_SetPixel(xCol,yRow,bitplane_value);
-                }
-            }
-            break;
-        case dlp::Pattern::Orientation::DIAMOND_ANGLE_2:
-            // Set the pixels
-            for(     unsigned int yRow = 0; yRow < rows;    yRow++){
-                for( unsigned int xCol = 0; xCol < columns; xCol++){
-                    unsigned int code = ((rows - yRow)/2) + xCol;
-                    unsigned int value = pattern_line_gray.at(iPattern).at(code + this->offset_);
-                    unsigned char bitplane_value = 255*value;
-
-                    // Save the pixel value
-                    image.Unsafe_SetPixel(xCol,yRow,bitplane_value);
-                }
-            }
-            break;
-        case dlp::Pattern::Orientation::DIAMOND_ANGLE_1:
-            // Set the pixels
-            for(     unsigned int yRow = 0; yRow < rows;    yRow++){
-                for( unsigned int xCol = 0; xCol < columns; xCol++){
-                    unsigned int code = (yRow/2) + xCol;
-                    unsigned int value = pattern_line_gray.at(iPattern).at(code + this->offset_);
-                    unsigned char bitplane_value = 255*value;
-
-                    // Save the pixel value
-                    image.Unsafe_SetPixel(xCol,yRow,bitplane_value);
-                }
-            }
-            break;
-        case dlp::Pattern::Orientation::INVALID:
-        default:
-            return ret.AddError(STRUCTURED_LIGHT_NOT_SETUP);
-            break;
+        // Convert the gray code line to pixel values
+        for(unsigned int iPoint = 0; iPoint < line_size; iPoint++){
+            profile.at(iPoint)          = 255 * pattern_line_gray.at(iPattern).at(iPoint);
+            profile_inverted.at(iPoint) = 255 - profile.at(iPoint);
         }
 
+        // Broadcast the line across the image
+        ret = this->GenerateStripeImage(profile, this->offset_, columns, rows,
+                                        this->pattern_orientation_.Get(), &pattern.image_data);
+        if(ret.hasErrors()){
+            pattern_sequence->Clear();
+            return ret;
+        }
 
-        // Add this image to the Pattern
-        pattern.image_data.Create(image);
         pattern.color     = this->pattern_color_.Get();
         pattern.data_type = dlp::Pattern::DataType::IMAGE_DATA;
         pattern.bitdepth  = dlp::Pattern::Bitdepth::MONO_1BPP;
@@ -376,27 +363,13 @@ ReturnCode GrayCode::GeneratePatternSequence(Pattern::Sequence *pattern_sequence
 
         // Create the inverted image if needed
         if(this->include_inverted_.Get()){
-            // Allocate memory for the inverted image
-            image_inverted.Create(columns,rows,dlp::Image::Format::MONO_UCHAR);
-
-            // Copy and invert the pixel values from the noninverted pattern
-            for(     unsigned int yRow = 0; yRow < rows;    yRow++){
-                for( unsigned int xCol = 0; xCol < columns; xCol++){
-                    unsigned char value;
-                    unsigned char value_inverted;
-                    // Get the normal pixel value
-                    image.Unsafe_GetPixel(xCol,yRow,&value);
-
-                    // Invert the value
-                    value_inverted = 255 - value;
-
-                    // Save the inverted value
-                    image_inverted.Unsafe_SetPixel(xCol,yRow, value_inverted);
-                }
+            ret = this->GenerateStripeImage(profile_inverted, this->offset_, columns, rows,
+                                            this->pattern_orientation_.Get(), &pattern_inverted.image_data);
+            if(ret.hasErrors()){
+                pattern_sequence->Clear();
+                return ret;
             }
 
-            // Create a pattern for the inverted image
-            pattern_inverted.image_data.Create(image_inverted);
             pattern_inverted.color     = this->pattern_color_.Get();
             pattern_inverted.data_type = dlp::Pattern::DataType::IMAGE_DATA;
             pattern_inverted.bitdepth  = dlp::Pattern::Bitdepth::MONO_1BPP;
@@ -404,31 +377,351 @@ ReturnCode GrayCode::GeneratePatternSequence(Pattern::Sequence *pattern_sequence
             // Add the inverted pattern to the sequence
             pattern_sequence->Add(pattern_inverted);
         }
-
-        // Clear the image
-        image.Clear();
-        image_inverted.Clear();
     }
 
+    // Keep the sequence for later setups with the same settings
+    CachePatternSequence(cache_key, *pattern_sequence);
+
     return ret;
 }
 
 
+/** @brief Finds the albedo threshold of each pixel from the all on and all off captures
+ *  @param[in]  image_max   All on capture
+ *  @param[in]  image_min   All off capture
+ *  @param[in]  threshold   Minimum difference in native pixel units
+ *  @param[out] albedo      Return pointer for the thresholds, same depth as the captures
+ *  @param[out] disparity   Disparity data, pixels without enough contrast are set invalid
+ */
+template <typename T>
+static void DecodeAlbedo(const cv::Mat &image_max, const cv::Mat &image_min, const unsigned int &threshold,
+                         cv::Mat *albedo, cv::Mat *disparity){
+
+    albedo->create(image_max.rows, image_max.cols, image_max.type());
+
+    for(int yRow = 0; yRow < image_max.rows; yRow++){
+        const T *pixel_max = image_max.ptr<T>(yRow);
+        const T *pixel_min = image_min.ptr<T>(yRow);
+        T       *pixel_albedo    = albedo->ptr<T>(yRow);
+        int     *pixel_disparity = disparity->ptr<int>(yRow);
+
+        for(int xCol = 0; xCol < image_max.cols; xCol++){
+            // Check that the difference is positive and large enough
+            if( pixel_max[xCol] >= (pixel_min[xCol] + threshold)){
+                //Save the albedo threshold
+                pixel_albedo[xCol] = (T) ((pixel_max[xCol] + pixel_min[xCol]) / 2);
+            }
+            else{
+                //Set the disparity map pixel to invalid
+                pixel_disparity[xCol] = dlp::DisparityMap::INVALID_PIXEL;
+                pixel_albedo[xCol]    = std::numeric_limits<T>::max();
+            }
+        }
+    }
+}
 
-/** @brief Decodes the \ref dlp::Capture::Sequence and returns the \ref dlp::DisparityMap
- *  @param[in] capture_sequence \ref dlp::Capture::Sequence to be decoded
- *  @param[in] disparity_map Return pointer for generated \ref dlp::DisparityMap
- *  @retval STRUCTURED_LIGHT_NULL_POINTER_ARGUMENT      Input arguments NULL
- *  @retval STRUCTURED_LIGHT_NOT_SETUP                  Module has NOT been setup
- *  @retval STRUCTURED_LIGHT_CAPTURE_SEQUENCE_EMPTY     Supplied sequence is empty
- *  @retval STRUCTURED_LIGHT_CAPTURE_SEQUENCE_SIZE_INVALID  Supplied sequence has a difference count than what was generated
- *  @retval STRUCTURED_LIGHT_DATA_TYPE_INVALID          Supplied sequence does NOT contain valid image data or a image file name
-*/
-ReturnCode GrayCode::DecodeCaptureSequence(Capture::Sequence *capture_sequence, dlp::DisparityMap *disparity_map){
+/** @brief Adds one bitplane to the disparity data
+ *  @param[in]  normal          Capture of the normal pattern
+ *  @param[in]  reference       Capture of the inverted pattern or the albedo thresholds
+ *  @param[in]  inverted        True if reference is the inverted pattern
+ *  @param[in]  threshold       Minimum difference in native pixel units
+ *  @param[in]  pattern_value   Value of the bitplane being decoded
+ *  @param[out] disparity       Disparity data being decoded
+ */
+template <typename T>
+static void DecodeBitplane(const cv::Mat &normal, const cv::Mat &reference, const bool &inverted,
+                           const unsigned int &threshold, const unsigned int &pattern_value, cv::Mat *disparity){
+
+    for(int yRow = 0; yRow < normal.rows; yRow++){
+        const T *pixel_normal    = normal.ptr<T>(yRow);
+        const T *pixel_reference = reference.ptr<T>(yRow);
+        int     *pixel_disparity = disparity->ptr<int>(yRow);
+
+        for(int xCol = 0; xCol < normal.cols; xCol++){
+            int disparity_value = pixel_disparity[xCol];
+
+            // Check that point is not invalid
+            if(disparity_value == dlp::DisparityMap::INVALID_PIXEL) continue;
+
+            // If the disparity pixel value is empty set it to zero
+            if(disparity_value == dlp::DisparityMap::EMPTY_PIXEL)
+                disparity_value = 0;
+
+            // Calculate the difference
+            int difference = (int)pixel_normal[xCol] - (int)pixel_reference[xCol];
+            int pixel_pattern_code;
+
+            if(difference > 0){
+                pixel_pattern_code = pattern_value;
+            }
+            else{
+                pixel_pattern_code = 0;
+                difference = -difference;
+            }
+
+            // The inverted pattern must meet the threshold, the albedo must exceed it
+            bool valid = inverted ? (difference >= (int) threshold) : (difference > (int) threshold);
+
+            if(valid){
+                // Calculate the new disparity value
+                disparity_value |= pixel_pattern_code ^ ((disparity_value >> 1) & pattern_value);
+            }
+            else{
+                // Set the disparity pixel as invalid
+                disparity_value = dlp::DisparityMap::INVALID_PIXEL;
+            }
+
+            // Save the adjusted disparity value
+            pixel_disparity[xCol] = disparity_value;
+        }
+    }
+}
+
+/** @brief Measures the contrast of the all on and all off captures
+ *  @param[in]  image_max   All on capture
+ *  @param[in]  image_min   All off capture
+ *  @param[out] modulation  CV_32FC1 direct light of the tile
+ *  @param[out] global      CV_32FC1 global light of the tile
+ *
+ *  Without inverted patterns the direct and global light can NOT be split,
+ *  so the modulation is the difference of the captures and the global
+ *  light is the all off capture, i.e. the ambient light only.
+ */
+template <typename T>
+static void MeasureAlbedo(const cv::Mat &image_max, const cv::Mat &image_min,
+                          cv::Mat *modulation, cv::Mat *global){
+
+    for(int yRow = 0; yRow < image_max.rows; yRow++){
+        const T *pixel_max        = image_max.ptr<T>(yRow);
+        const T *pixel_min        = image_min.ptr<T>(yRow);
+        float   *pixel_modulation = modulation->ptr<float>(yRow);
+        float   *pixel_global     = global->ptr<float>(yRow);
+
+        for(int xCol = 0; xCol < image_max.cols; xCol++){
+            pixel_modulation[xCol] = std::max((float)pixel_max[xCol] - (float)pixel_min[xCol], 0.0f);
+            pixel_global[xCol]     = (float)pixel_min[xCol];
+        }
+    }
+}
+
+/** @brief Adds one bitplane to the contrast measurements
+ *  @param[in]  normal      Capture of the normal pattern
+ *  @param[in]  reference   Capture of the inverted pattern or the albedo thresholds
+ *  @param[in]  inverted    True if reference is the inverted pattern
+ *  @param[out] modulation  CV_32FC1 direct light of the tile
+ *  @param[out] global      CV_32FC1 global light of the tile
+ *  @param[out] margin      CV_32FC1 smallest decision margin of the tile
+ *
+ *  The margin is the smallest difference of any bitplane. With inverted
+ *  patterns the bitplane with the largest difference splits the light, a
+ *  lit pixel receives the direct light and half of the global light while
+ *  an unlit pixel only receives half of the global light.
+ */
+template <typename T>
+static void MeasureBitplane(const cv::Mat &normal, const cv::Mat &reference, const bool &inverted,
+                            cv::Mat *modulation, cv::Mat *global, cv::Mat *margin){
+
+    for(int yRow = 0; yRow < normal.rows; yRow++){
+        const T *pixel_normal     = normal.ptr<T>(yRow);
+        const T *pixel_reference  = reference.ptr<T>(yRow);
+        float   *pixel_modulation = modulation->ptr<float>(yRow);
+        float   *pixel_global     = global->ptr<float>(yRow);
+        float   *pixel_margin     = margin->ptr<float>(yRow);
+
+        for(int xCol = 0; xCol < normal.cols; xCol++){
+            float difference = fabs((float)pixel_normal[xCol] - (float)pixel_reference[xCol]);
+
+            if(difference < pixel_margin[xCol])
+                pixel_margin[xCol] = difference;
+
+            if(inverted && (difference > pixel_modulation[xCol])){
+                pixel_modulation[xCol] = difference;
+                pixel_global[xCol]     = 2.0f * std::min(pixel_normal[xCol], pixel_reference[xCol]);
+            }
+        }
+    }
+}
+
+/** @brief Returns the Gray code of a binary value */
+static inline unsigned int ToGray(const unsigned int &value){
+    return value ^ (value >> 1);
+}
+
+/** @brief Interpolates the decoded codes between subpixel stripe edges
+ *  @param[in]  normal          Capture of each decoded bitplane, most significant first
+ *  @param[in]  reference       Inverted capture or albedo threshold of each bitplane
+ *  @param[in]  codes           Decoded disparity with the offset removed
+ *  @param[in]  along_rows      Search for edges along the camera rows, otherwise along the columns
+ *  @param[in]  offset          Offset between the Gray code and the disparity values
+ *  @param[in]  msb_value       Value of the first bitplane
+ *  @param[in]  samples         Disparity values per stripe in the result
+ *  @param[in]  resolution      Number of stripes on the DMD
+ *  @param[out] result          Return pointer for the disparity scaled by samples
+ *
+ *  Neighboring pixels whose codes differ by one stripe differ in exactly one
+ *  bitplane. The edge between them is where the difference of that bitplane
+ *  and its reference crosses zero. Pixels between two such edges are given
+ *  the position interpolated linearly between the stripe boundaries.
+ *  Pixels without an edge on both sides keep their integer code.
+ */
+template <typename T>
+static void RefineSubpixel(const std::vector<cv::Mat> &normal, const std::vector<cv::Mat> &reference,
+                           const cv::Mat &codes, const bool &along_rows,
+                           const unsigned int &offset, const unsigned int &msb_value,
+                           const unsigned int &samples, const unsigned int &resolution,
+                           cv::Mat *result){
+
+    const int lines     = along_rows ? codes.rows : codes.cols;
+    const int length    = along_rows ? codes.cols : codes.rows;
+    const int maximum   = (int)(resolution * samples) - 1;
+    const unsigned int planes    = normal.size();
+    const int          lsb_value = (int)(msb_value >> (planes - 1));
+
+    result->create(codes.rows, codes.cols, CV_32SC1);
+
+    std::vector<int>    line_codes(length);
+    std::vector<double> edge_position(length);
+    std::vector<double> edge_stripe(length);
+
+    for(int iLine = 0; iLine < lines; iLine++){
+
+        // Read the codes along the line
+        for(int iPoint = 0; iPoint < length; iPoint++){
+            line_codes.at(iPoint) = along_rows ? codes.at<int>(iLine, iPoint) : codes.at<int>(iPoint, iLine);
+        }
+
+        // Find the edge between each pair of neighboring pixels
+        for(int iPoint = 0; iPoint + 1 < length; iPoint++){
+            int code_0 = line_codes.at(iPoint);
+            int code_1 = line_codes.at(iPoint+1);
+
+            edge_position.at(iPoint) = -1.0;
+
+            if((code_0 < 0) || (code_0 == dlp::DisparityMap::INVALID_PIXEL) ||
+               (code_1 < 0) || (code_1 == dlp::DisparityMap::INVALID_PIXEL) ||
+               (abs(code_1 - code_0) != lsb_value))
+                continue;
+
+            // Find the bitplane which changes between the codes
+            unsigned int flipped = ToGray(code_0 + offset) ^ ToGray(code_1 + offset);
+            unsigned int plane   = 0;
+            unsigned int value   = msb_value;
+            while((value != flipped) && (plane < planes)){
+                value = value >> 1;
+                plane++;
+            }
+            if(plane >= planes) continue;
+
+            // Find the zero crossing of the bitplane difference
+            int difference_0;
+            int difference_1;
+            if(along_rows){
+                difference_0 = (int)normal.at(plane).at<T>(iLine, iPoint)   - (int)reference.at(plane).at<T>(iLine, iPoint);
+                difference_1 = (int)normal.at(plane).at<T>(iLine, iPoint+1) - (int)reference.at(plane).at<T>(iLine, iPoint+1);
+            }
+            else{
+                difference_0 = (int)normal.at(plane).at<T>(iPoint,   iLine) - (int)reference.at(plane).at<T>(iPoint,   iLine);
+                difference_1 = (int)normal.at(plane).at<T>(iPoint+1, iLine) - (int)reference.at(plane).at<T>(iPoint+1, iLine);
+            }
+
+            if(difference_0 == difference_1) continue;
+
+            double crossing = (double)difference_0 / (difference_0 - difference_1);
+            if((crossing < 0.0) || (crossing > 1.0)) continue;
+
+            // The boundary lies half a stripe before the larger code
+            edge_position.at(iPoint) = iPoint + crossing;
+            edge_stripe.at(iPoint)   = std::max(code_0, code_1) - 0.5;
+        }
+
+        // Interpolate each run of equal codes between its edges
+        int run_start = 0;
+        while(run_start < length){
+            int code    = line_codes.at(run_start);
+            int run_end = run_start;
+            while((run_end + 1 < length) && (line_codes.at(run_end + 1) == code))
+                run_end++;
+
+            bool valid = (code >= 0) && (code != dlp::DisparityMap::INVALID_PIXEL);
+            bool edges = valid && (run_start > 0) && (run_end + 1 < length) &&
+                         (edge_position.at(run_start - 1) >= 0.0) &&
+                         (edge_position.at(run_end)       >= 0.0) &&
+                         (edge_stripe.at(run_start - 1)   != edge_stripe.at(run_end));
+
+            for(int iPoint = run_start; iPoint <= run_end; iPoint++){
+                int value = code;
+
+                if(edges){
+                    double left     = edge_position.at(run_start - 1);
+                    double right    = edge_position.at(run_end);
+                    double fraction = (iPoint - left) / (right - left);
+                    double stripe   = edge_stripe.at(run_start - 1) +
+                                      fraction * (edge_stripe.at(run_end) - edge_stripe.at(run_start - 1));
+
+                    value = (int) lround(stripe * samples);
+                    value = std::min(std::max(value, 0), maximum);
+                }
+                else if(valid){
+                    value = code * samples;
+                }
+
+                if(along_rows) result->at<int>(iLine, iPoint) = value;
+                else           result->at<int>(iPoint, iLine) = value;
+            }
+
+            run_start = run_end + 1;
+        }
+    }
+}
+
+/** @brief Returns true if the stripe edges are located between camera pixels */
+bool GrayCode::isSubpixel() const{
+    return (this->subpixel_sampling_.Get() > 1) && (this->measure_regions_.Get() <= 0.0) &&
+           (this->sequence_count_.Get() > 0);
+}
+
+/** @brief Returns the number of disparity values per stripe of the decoded tiles */
+unsigned int GrayCode::GetDisparitySampling() const{
+    return this->isSubpixel() ? this->subpixel_sampling_.Get() : 1;
+}
+
+/** @brief Returns the pixel threshold in the units of the captures
+ *  @param[in]  sixteen_bit     True if the captures are CV_16UC1
+ *
+ *  The 8-bit threshold is shifted by the bits the captures have beyond 8,
+ *  so 8-, 12- and 16-bit captures of the same scene decode the same pixels.
+ */
+unsigned int GrayCode::GetPixelThreshold(const bool &sixteen_bit) const{
+    if(!sixteen_bit) return this->pixel_threshold_.Get();
+
+    unsigned int bit_depth = this->capture_bit_depth_.Get();
+    if(bit_depth == 0) bit_depth = 16;
+
+    return this->pixel_threshold_.Get() << (bit_depth - 8);
+}
+
+/** @brief Checks and loads the captures of the \ref dlp::Capture::Sequence
+ *  @param[in]  capture_sequence    \ref dlp::Capture::Sequence to be decoded
+ *  @param[out] images              Return pointer for the loaded region of interest
+ *  @param[out] captures            Return pointer for the OpenCV data of each image
+ *  @param[out] image_columns       Return pointer for the capture columns
+ *  @param[out] image_rows          Return pointer for the capture rows
+ *  @param[out] sixteen_bit         Return pointer set true for \ref dlp::Image::Format::MONO_USHORT captures
+ *  @param[out] region              Return pointer for the bounding box of the region of interest
+ *  @param[out] region_mask         Return pointer for the mask of the bounding box
+ */
+ReturnCode GrayCode::LoadCaptures(Capture::Sequence *capture_sequence,
+                                  std::vector<dlp::Image> *images,
+                                  std::vector<cv::Mat> *captures,
+                                  unsigned int *image_columns,
+                                  unsigned int *image_rows,
+                                  bool *sixteen_bit,
+                                  cv::Rect *region,
+                                  cv::Mat *region_mask){
     ReturnCode ret;
 
     // Check the pointers
-    if(!capture_sequence || !disparity_map)
+    if(!capture_sequence)
         return ret.AddError(STRUCTURED_LIGHT_NULL_POINTER_ARGUMENT);
 
     // Check that GrayCode object is setup
@@ -443,103 +736,77 @@ ReturnCode GrayCode::DecodeCaptureSequence(Capture::Sequence *capture_sequence,
     if(capture_sequence->GetCount() != this->sequence_count_total_)
         return ret.AddError(STRUCTURED_LIGHT_CAPTURE_SEQUENCE_SIZE_INVALID);
 
-    // Create a vector of the images to decode
-    std::vector<dlp::Image> images_coded;
-
-    // Store the image resolution
-    unsigned int image_rows    = 0;
-    unsigned int image_columns = 0;
-
-    for(unsigned int iCapture = 0; iCapture < this->sequence_count_total_; iCapture++){
-        dlp::Capture capture;
-        dlp::Image   image;
-        unsigned int capture_rows;
-        unsigned int capture_columns;
-
-        // Grab the capture from the sequence
-        ReturnCode ret_error = capture_sequence->Get(iCapture, &capture);
-
-        // Check that capture was grabbed
-        if(ret_error.hasErrors())
-            return ret_error;
-
-        // Check the capture type
-        switch(capture.data_type){
-        case dlp::Capture::DataType::IMAGE_FILE:
-        {
-            // Check that the file exists
-            if(!dlp::File::Exists(capture.image_file))
-                return ret.AddError(FILE_DOES_NOT_EXIST);
-
-            // Load the file and check the resolution
-            ret_error = image.Load(capture.image_file);
-            if(ret_error.hasErrors())
-                return ret_error;
-
-            break;
-        }
-        case dlp::Capture::DataType::IMAGE_DATA:
-        {
-            // Check that the image data is not empty
-            if(capture.image_data.isEmpty())
-                return ret.AddError(IMAGE_EMPTY);
-
-            // Load the file and check the resolution
-            cv::Mat temp_image_data;
-            capture.image_data.Unsafe_GetOpenCVData(&temp_image_data);
-            ret_error = image.Create(temp_image_data);
-            if(ret_error.hasErrors())
-                return ret_error;
-            temp_image_data.release();
-            break;
-        }
-        case dlp::Capture::DataType::INVALID:
-        default:
-            return ret.AddError(STRUCTURED_LIGHT_DATA_TYPE_INVALID);
-        }
-
-        // Get the image resolution
-        image.GetColumns(&capture_columns);
-        image.GetRows(&capture_rows);
-
-        // If on the first capture store the resolution
-        if(iCapture == 0){
-            image_columns = capture_columns;
-            image_rows    = capture_rows;
-        }
-
-        // Check that each image has the same resolution
-        if( (capture_rows    != image_rows) ||
-            (capture_columns != image_columns))
-            return ret.AddError(STRUCTURED_LIGHT_PATTERN_SIZE_INVALID);
-
-        // Convert the image to monochrome
-        image.ConvertToMonochrome();
-
-        // Add the image to the list
-        images_coded.push_back(image);
+    // Load the region of interest of each capture
+    dlp::Image::Format image_format;
+    ret = this->LoadCaptureImages(capture_sequence, this->sequence_count_total_, images,
+                                  image_columns, image_rows, &image_format,
+                                  region, region_mask);
+    if(ret.hasErrors())
+        return ret;
 
-        // Clear the image
-        image.Clear();
+    // Reference the image data without copying it
+    captures->clear();
+    for(unsigned int iCapture = 0; iCapture < images->size(); iCapture++){
+        cv::Mat capture_data;
+        images->at(iCapture).Unsafe_GetOpenCVData(&capture_data);
+        captures->push_back(capture_data);
     }
 
-    // All images from the CaptureSequence have been loaded
+    // Decode 16-bit captures natively. The threshold is scaled to their
+    // depth by GetPixelThreshold().
+    (*sixteen_bit) = (image_format == dlp::Image::Format::MONO_USHORT);
 
-    // Allocate memory for the disparity images
-    ret = this->disparity_map_.Create( image_columns, image_rows, this->pattern_orientation_.Get());
+    return ret;
+}
 
-    if(ret.hasErrors()){
-        std::cout << "Disparity map create failed..." << std::endl;
-        return ret;
+/** @brief Decodes one tile of the region of interest
+ *  @param[in]  captures        Region of interest of each capture
+ *  @param[in]  sixteen_bit     True if the captures are CV_16UC1
+ *  @param[in]  region_mask     Mask of the region of interest, may be empty
+ *  @param[in]  tile            Tile to decode relative to the region of interest
+ *  @param[out] disparity       Return pointer for the CV_32SC1 disparity of the tile
+ *  @param[out] confidence      Return pointer for the measurements of the tile, may be NULL
+ *
+ *  The disparity is multiplied by \ref GetDisparitySampling(). Subpixel edges
+ *  are searched within the tile only, so tiles must span complete rows, or
+ *  complete columns for horizontal patterns.
+ *
+ *  The contrast is only measured if it is returned or a rejection limit is
+ *  set. Rejected pixels are invalid before the subpixel edges are located.
+ */
+void GrayCode::DecodeTile(const std::vector<cv::Mat> &captures,
+                          const bool &sixteen_bit,
+                          const cv::Mat &region_mask,
+                          const cv::Rect &tile,
+                          cv::Mat *disparity,
+                          TileConfidence *confidence) const{
+
+    // Allocate the tile and mark the pixels outside of the mask invalid so
+    // the kernels skip them
+    disparity->create(tile.height, tile.width, CV_32SC1);
+    disparity->setTo(cv::Scalar(dlp::DisparityMap::EMPTY_PIXEL));
+
+    if(!region_mask.empty())
+        ApplyRegionMask(region_mask(tile), disparity);
+
+    // Measure the contrast if it is needed
+    TileConfidence  tile_confidence;
+    TileConfidence *measure = nullptr;
+    if(confidence || this->isRejectionEnabled()){
+        measure = confidence ? confidence : &tile_confidence;
+        measure->modulation = cv::Mat::zeros(tile.height, tile.width, CV_32FC1);
+        measure->global     = cv::Mat::zeros(tile.height, tile.width, CV_32FC1);
+        measure->margin.create(tile.height, tile.width, CV_32FC1);
+        measure->margin.setTo(cv::Scalar(std::numeric_limits<float>::max()));
     }
 
     // Check is the inverted patterns are included
     unsigned int image_increment;
     unsigned int image_start;
     unsigned int pattern_loop_count;
-    unsigned int threshold = this->pixel_threshold_.Get();
+    unsigned int threshold = this->GetPixelThreshold(sixteen_bit);
 
-    dlp::Image image_albedo;
+    cv::Mat image_albedo;
     if(this->include_inverted_.Get()){
         // Each "Pattern" has a normal and an inverted pattern (i.e. 2 images per pattern)
         image_increment = 2;
@@ -552,163 +819,67 @@ ReturnCode GrayCode::DecodeCaptureSequence(Capture::Sequence *capture_sequence,
         image_start     = 2;
         pattern_loop_count = this->sequence_count_total_;
 
-        // Grab the max value and min value patterns
-        dlp::Image image_max;
-        dlp::Image image_min;
-        cv::Mat    temp_image_data;
-
-        // Grab the max value image
-        images_coded.at(0).Unsafe_GetOpenCVData(&temp_image_data);
-        image_max.Create(temp_image_data);
-        temp_image_data.release();
-
-        // Grab the min value image
-        images_coded.at(1).Unsafe_GetOpenCVData(&temp_image_data);
-        image_min.Create(temp_image_data);
-        temp_image_data.release();
-
-        // Find the albedo thresholds for each pixel
-        image_albedo.Create(image_columns, image_rows,dlp::Image::Format::MONO_UCHAR);
-
-        unsigned char pixel_max;
-        unsigned char pixel_min;
-        for(     unsigned int yRow = 0; yRow < image_rows;    yRow++){
-            for( unsigned int xCol = 0; xCol < image_columns; xCol++){
-
-                // Get the pixel from the normal and inverted image
-                image_max.Unsafe_GetPixel(xCol, yRow, &pixel_max);
-                image_min.Unsafe_GetPixel(xCol, yRow, &pixel_min);
-
-                // Check that the difference is positive and large enough
-                if( pixel_max >= (pixel_min + threshold)){
-                //if( pixel_max > pixel_min){
-                    //Save the albedo threshold
-                    image_albedo.Unsafe_SetPixel(xCol,yRow, (unsigned char) ((pixel_max + pixel_min) / 2) );
-                }
-                else{
-                    //Set the disparity map pixel to invalid
-                    this->disparity_map_.Unsafe_SetPixel(xCol,yRow,dlp::DisparityMap::INVALID_PIXEL);
-                    image_albedo.Unsafe_SetPixel(xCol,yRow, (unsigned char) 255);
-                }
-            }
+        // Find the albedo thresholds for each pixel from the max and min value patterns
+        if(sixteen_bit)
+            DecodeAlbedo<unsigned short>(captures.at(0)(tile), captures.at(1)(tile), threshold, &image_albedo, disparity);
+        else
+            DecodeAlbedo<unsigned char>( captures.at(0)(tile), captures.at(1)(tile), threshold, &image_albedo, disparity);
+
+        if(measure){
+            if(sixteen_bit)
+                MeasureAlbedo<unsigned short>(captures.at(0)(tile), captures.at(1)(tile),
+                                              &measure->modulation, &measure->global);
+            else
+                MeasureAlbedo<unsigned char>( captures.at(0)(tile), captures.at(1)(tile),
+                                              &measure->modulation, &measure->global);
         }
     }
 
     // Calculate the value the MSB pattern
     unsigned int pattern_value  = this->msb_pattern_value_;
     unsigned int kImage         = image_start;
-    int             disparity_value;
-    unsigned char   normal_value;
-    unsigned char   inverted_value;
-    unsigned char   albedo_value;
 
-    cv::Mat      temp_image_data;
+    // Subpixel refinement needs every bitplane after the codes are decoded
+    const bool subpixel = this->isSubpixel();
+    std::vector<cv::Mat> normal_planes;
+    std::vector<cv::Mat> reference_planes;
 
     for(unsigned int iPattern = image_start; iPattern < pattern_loop_count; iPattern++){
-        dlp::Image image_normal;
-        dlp::Image image_inverted;
+        cv::Mat image_normal = captures.at(kImage)(tile);
+        cv::Mat image_reference;
 
-        // Copy the image
-        images_coded.at(kImage).Unsafe_GetOpenCVData(&temp_image_data);
-        image_normal.Create(temp_image_data);
-        temp_image_data.release();
-        images_coded.at(kImage).Clear();
-
-        // If inverted is included load the next image, if not, set to zero
-        if(this->include_inverted_.Get()){
-            // Add the inverted image and convert it to monochrome
-            images_coded.at(kImage+1).Unsafe_GetOpenCVData(&temp_image_data);
-            image_inverted.Create(temp_image_data);
-            temp_image_data.release();
-            images_coded.at(kImage+1).Clear();
-        }
+        // Compare against the inverted image if included or the albedo if not
+        if(this->include_inverted_.Get())
+            image_reference = captures.at(kImage+1)(tile);
+        else
+            image_reference = image_albedo;
 
         // Decode each pixel
-        for(     unsigned int yRow = 0; yRow < image_rows;    yRow++){
-            for( unsigned int xCol = 0; xCol < image_columns; xCol++){
-
-                // Get the current disparity pixel's value
-                this->disparity_map_.Unsafe_GetPixel(xCol,yRow,&disparity_value);
-
-                // Check that point is not invalid
-                if(disparity_value != dlp::DisparityMap::INVALID_PIXEL){
-                    int pixel_pattern_code;
-
-                    // If the disparity pixel value is empty set it to zero
-                    if(disparity_value == dlp::DisparityMap::EMPTY_PIXEL)
-                        disparity_value = 0;
-
-                    // Get the pixel from the normal
-                    image_normal.Unsafe_GetPixel(   xCol, yRow, &normal_value);
-
-                    if(this->include_inverted_.Get()){
-                        int difference;
-
-                        // Grab the inverted image pixel
-                        image_inverted.Unsafe_GetPixel( xCol, yRow, &inverted_value);
-
-                        // Calculate the difference
-                        difference = (int)normal_value - (int)inverted_value;
-
-                        // Check that the difference is positive and meets the threshold requirement
-                        if(difference > 0){
-                            pixel_pattern_code = pattern_value;
-                        }
-                        else{
-                            pixel_pattern_code = 0;
-                            difference = -difference;
-                        }
-
-                        if( difference >= (int) threshold){
-                            // Calculate the new disparity value
-                            disparity_value |= pixel_pattern_code ^ ((disparity_value >> 1) & pattern_value);
-                        }
-                        else{
-                            // Set the disparity pixel as invalid
-                            disparity_value = dlp::DisparityMap::INVALID_PIXEL;
-                        }
-                    }
-                    else{
-                        int difference;
-
-                        // Use the albedo image instead of an inverted pattern
-                        image_albedo.Unsafe_GetPixel(xCol,yRow, &albedo_value);
-
-                        // Calculate the difference
-                        difference = (int)normal_value - (int)albedo_value;
-
-                        // Check that the difference is positive and meets the threshold requirement
-                        if(difference > 0){
-                            pixel_pattern_code = pattern_value;
-                        }
-                        else{
-                            pixel_pattern_code = 0;
-                            difference = -difference;
-                        }
-
-                        if( difference > (int) threshold){
-                            // Calculate the new disparity value
-                            disparity_value |= pixel_pattern_code ^ ((disparity_value >> 1) & pattern_value);
-                        }
-                        else{
-                            // Set the disparity pixel as invalid
-                            disparity_value = dlp::DisparityMap::INVALID_PIXEL;
-                        }
-
-                    }
-
-                    // Save the adjusted disparity value
-                    this->disparity_map_.Unsafe_SetPixel(xCol,yRow,disparity_value);
-                }
-            }
+        if(sixteen_bit)
+            DecodeBitplane<unsigned short>(image_normal, image_reference, this->include_inverted_.Get(),
+                                           threshold, pattern_value, disparity);
+        else
+            DecodeBitplane<unsigned char>( image_normal, image_reference, this->include_inverted_.Get(),
+                                           threshold, pattern_value, disparity);
+
+        // Measure the contrast of the bitplane
+        if(measure){
+            if(sixteen_bit)
+                MeasureBitplane<unsigned short>(image_normal, image_reference, this->include_inverted_.Get(),
+                                                &measure->modulation, &measure->global, &measure->margin);
+            else
+                MeasureBitplane<unsigned char>( image_normal, image_reference, this->include_inverted_.Get(),
+                                                &measure->modulation, &measure->global, &measure->margin);
         }
 
         // Shift the pattern value
         pattern_value = pattern_value >> 1;
 
-        // Clear the images
-        image_normal.Clear();
-        image_inverted.Clear();
+        // Keep the bitplanes for subpixel refinement
+        if(subpixel){
+            normal_planes.push_back(image_normal);
+            reference_planes.push_back(image_reference);
+        }
 
         // Increment kImage
         kImage = kImage + image_increment;
@@ -716,11 +887,11 @@ ReturnCode GrayCode::DecodeCaptureSequence(Capture::Sequence *capture_sequence,
 
     // If there is an offset remove it
     if(this->offset_ > 0){
-        for(     unsigned int yRow = 0; yRow < image_rows;    yRow++){
-            for( unsigned int xCol = 0; xCol < image_columns; xCol++){
+        for(    int yRow = 0; yRow < disparity->rows; yRow++){
+            int *pixel_disparity = disparity->ptr<int>(yRow);
 
-                // Get the current disparity pixel's value
-                this->disparity_map_.Unsafe_GetPixel(xCol,yRow,&disparity_value);
+            for(int xCol = 0; xCol < disparity->cols; xCol++){
+                int disparity_value = pixel_disparity[xCol];
 
                 // Check that the pixel is still valid
                 if(disparity_value != dlp::DisparityMap::INVALID_PIXEL){
@@ -734,20 +905,200 @@ ReturnCode GrayCode::DecodeCaptureSequence(Capture::Sequence *capture_sequence,
                 }
 
                 // Save the adjusted disparity value
-                this->disparity_map_.Unsafe_SetPixel(xCol,yRow,disparity_value);
+                pixel_disparity[xCol] = disparity_value;
             }
         }
     }
 
+    // Reject the pixels which do not meet the limits
+    if(measure){
+        // Pixels without any bitplane have no margin
+        if(kImage == image_start)
+            measure->margin.setTo(cv::Scalar(0));
+
+        dlp::ConfidenceMap::Rejection rejection;
+        this->GetRejection(&rejection);
+        dlp::ConfidenceMap::Unsafe_Reject(rejection, measure->modulation, measure->global,
+                                          measure->margin, disparity);
+    }
+
+    // Locate the stripe edges between neighboring codes to subpixel accuracy
+    if(subpixel){
+        cv::Mat subpixel_data;
+        const bool along_rows = (this->pattern_orientation_.Get() != dlp::Pattern::Orientation::HORIZONTAL);
+
+        if(sixteen_bit)
+            RefineSubpixel<unsigned short>(normal_planes, reference_planes, *disparity, along_rows,
+                                           this->offset_, this->msb_pattern_value_, this->subpixel_sampling_.Get(),
+                                           this->resolution_, &subpixel_data);
+        else
+            RefineSubpixel<unsigned char>( normal_planes, reference_planes, *disparity, along_rows,
+                                           this->offset_, this->msb_pattern_value_, this->subpixel_sampling_.Get(),
+                                           this->resolution_, &subpixel_data);
+
+        (*disparity) = subpixel_data;
+    }
+}
+
+/** @brief Decodes the \ref dlp::Capture::Sequence and returns the \ref dlp::DisparityMap
+ *  @param[in] capture_sequence \ref dlp::Capture::Sequence to be decoded
+ *  @param[in] disparity_map Return pointer for generated \ref dlp::DisparityMap
+ *  @retval STRUCTURED_LIGHT_NULL_POINTER_ARGUMENT      Input arguments NULL
+ *  @retval STRUCTURED_LIGHT_NOT_SETUP                  Module has NOT been setup
+ *  @retval STRUCTURED_LIGHT_CAPTURE_SEQUENCE_EMPTY     Supplied sequence is empty
+ *  @retval STRUCTURED_LIGHT_CAPTURE_SEQUENCE_SIZE_INVALID  Supplied sequence has a difference count than what was generated
+ *  @retval STRUCTURED_LIGHT_DATA_TYPE_INVALID          Supplied sequence does NOT contain valid image data or a image file name
+ *  @retval STRUCTURED_LIGHT_CAPTURE_FORMAT_INVALID     Supplied sequence mixes 8-bit and 16-bit captures
+ *
+ *  \ref dlp::Image::Format::MONO_USHORT captures are decoded at their full depth.
+ *
+ *  If \ref dlp::GrayCode::Parameters::SubpixelSampling is greater than one the
+ *  stripe edges are located between camera pixels and the returned map
+ *  stores the disparity multiplied by that sampling, which
+ *  \ref dlp::Geometry::GeneratePointCloud() interpolates between planes.
+ *
+ *  Only the pixels selected with \ref SetRegionOfInterest() are decoded.
+ *  Region errors such as a mask with the wrong resolution are returned as is.
+ *
+ *  The contrast of every decoded pixel is returned by \ref GetConfidenceMap().
+ *  Pixels which fail the limits of \ref GetRejection() are invalid.
+*/
+ReturnCode GrayCode::DecodeCaptureSequence(Capture::Sequence *capture_sequence, dlp::DisparityMap *disparity_map){
+    ReturnCode ret;
+
+    // Check the pointers
+    if(!capture_sequence || !disparity_map)
+        return ret.AddError(STRUCTURED_LIGHT_NULL_POINTER_ARGUMENT);
+
+    // Load the captures
+    std::vector<dlp::Image> images_coded;
+    std::vector<cv::Mat>    captures;
+    unsigned int image_columns;
+    unsigned int image_rows;
+    bool         sixteen_bit;
+    cv::Rect     region;
+    cv::Mat      region_mask;
+
+    ret = this->LoadCaptures(capture_sequence, &images_coded, &captures,
+                             &image_columns, &image_rows, &sixteen_bit,
+                             &region, &region_mask);
+    if(ret.hasErrors())
+        return ret;
+
+    // Decode the bounding box of the region of interest as a single tile
+    cv::Mat        region_disparity;
+    TileConfidence region_confidence;
+    this->DecodeTile(captures, sixteen_bit, region_mask,
+                     cv::Rect(0, 0, region.width, region.height),
+                     &region_disparity, &region_confidence);
+
+    captures.clear();
+    images_coded.clear();
+
+    // Allocate memory for the disparity map
+    ret = this->disparity_map_.Create(region.width, region.height,
+                                      this->pattern_orientation_.Get(),
+                                      this->GetDisparitySampling());
+    if(ret.hasErrors()){
+        std::cout << "Disparity map create failed..." << std::endl;
+        return ret;
+    }
+
+    cv::Mat disparity_data;
+    this->disparity_map_.Unsafe_GetOpenCVData(&disparity_data);
+    region_disparity.copyTo(disparity_data);
+
+    // Return the region of interest in full frame coordinates
+    region_disparity.release();
+    disparity_data.release();
+
+    ret = ExpandRegion(region, image_columns, image_rows, &this->disparity_map_);
+    if(ret.hasErrors())
+        return ret;
+
+    // Keep the measurements for GetConfidenceMap()
+    ret = this->StoreConfidence(region, image_columns, image_rows, region_confidence);
+    if(ret.hasErrors())
+        return ret;
 
     // Copy the disparity map to the pointer
     ret = disparity_map->Create(this->disparity_map_);
 
-    temp_image_data.release();
-
     return ret;
 }
 
+/** @brief Decodes the \ref dlp::Capture::Sequence in tiles straight into a \ref dlp::Point::Cloud
+ *  @param[in]  capture_sequence    \ref dlp::Capture::Sequence to be decoded
+ *  @param[in]  geometry            \ref dlp::Geometry with the origin and view port set
+ *  @param[in]  viewport_id         View port of the camera which captured the sequence
+ *  @param[out] ret_cloud           Pointer to return \ref dlp::Point::Cloud
+ *  @param[out] ret_distancemap     Pointer to return \ref dlp::Image depth map
+ *
+ *  Each tile is decoded and triangulated while it is still in the cache, so
+ *  the full frame disparity map is never created. The result matches
+ *  \ref DecodeCaptureSequence() followed by \ref dlp::Geometry::GeneratePointCloud()
+ *  with disparity smoothing disabled.
+ *
+ *  If \ref dlp::StructuredLight::Parameters::BandRows is set the captures
+ *  are streamed in horizontal bands with \ref DecodeBandsToPointCloud()
+ *  and the disparity is smoothed like the staged steps.
+ */
+ReturnCode GrayCode::DecodeToPointCloud(Capture::Sequence  *capture_sequence,
+                                        dlp::Geometry      *geometry,
+                                        const unsigned int &viewport_id,
+                                        dlp::Point::Cloud  *ret_cloud,
+                                        dlp::Image         *ret_distancemap){
+    ReturnCode ret;
+
+    if(this->isBanded()){
+        // Check the sequence before reading it
+        if(!capture_sequence)
+            return ret.AddError(STRUCTURED_LIGHT_NULL_POINTER_ARGUMENT);
+
+        if(!this->isSetup())
+            return ret.AddError(STRUCTURED_LIGHT_NOT_SETUP);
+
+        if(capture_sequence->GetCount() != this->sequence_count_total_)
+            return ret.AddError(STRUCTURED_LIGHT_CAPTURE_SEQUENCE_SIZE_INVALID);
+
+        // Horizontal subpixel edges are searched along the columns, across the bands
+        unsigned int stripe_rows = 0;
+        if(this->isSubpixel() && (this->pattern_orientation_.Get() == dlp::Pattern::Orientation::HORIZONTAL))
+            stripe_rows = this->msb_pattern_value_ >> (this->sequence_count_.Get() - 1);
+
+        return this->DecodeBandsToPointCloud(capture_sequence,
+                                             [&](const std::vector<cv::Mat> &captures, const bool &sixteen_bit,
+                                                 const cv::Mat &band_mask, cv::Mat *disparity){
+                                                 cv::Rect band(0, 0, captures.front().cols, captures.front().rows);
+                                                 this->DecodeTile(captures, sixteen_bit, band_mask, band, disparity, nullptr);
+                                             },
+                                             this->GetDisparitySampling(), stripe_rows,
+                                             geometry, viewport_id, ret_cloud, ret_distancemap);
+    }
+
+    // Load the captures
+    std::vector<dlp::Image> images_coded;
+    std::vector<cv::Mat>    captures;
+    unsigned int image_columns;
+    unsigned int image_rows;
+    bool         sixteen_bit;
+    cv::Rect     region;
+    cv::Mat      region_mask;
+
+    ret = this->LoadCaptures(capture_sequence, &images_coded, &captures,
+                             &image_columns, &image_rows, &sixteen_bit,
+                             &region, &region_mask);
+    if(ret.hasErrors())
+        return ret;
+
+    return this->DecodeTilesToPointCloud([&](const cv::Rect &tile, cv::Mat *disparity){
+                                             this->DecodeTile(captures, sixteen_bit, region_mask, tile, disparity, nullptr);
+                                         },
+                                         region, image_columns, image_rows,
+                                         this->GetDisparitySampling(),
+                                         geometry, viewport_id, ret_cloud, ret_distancemap);
+}
+
 /** @brief      Retrieves module settings
  *  @param[in]  settings Pointer to return settings
  *  @retval     STRUCTURED_LIGHT_NULL_POINTER_ARGUMENT  Input argument is NULL
@@ -765,6 +1116,10 @@ ReturnCode GrayCode::GetSetup( dlp::Parameters *settings)const{
     settings->Set(this->pattern_color_);
     settings->Set(this->pattern_orientation_);
     settings->Set(this->pixel_threshold_);
+    settings->Set(this->subpixel_sampling_);
+    settings->Set(this->capture_bit_depth_);
+    this->GetRejectionSetup(settings);
+    this->GetBandSetup(settings);
 
     return ret;
 }
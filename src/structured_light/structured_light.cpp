@@ -12,6 +12,14 @@
 #include <common/pattern/pattern.hpp>
 #include <common/returncode.hpp>
 #include <structured_light/structured_light.hpp>
+#include <geometry/geometry.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
 
 /** @brief  Contains all DLP SDK classes, functions, etc. */
 namespace dlp{
@@ -40,6 +48,13 @@ StructuredLight::StructuredLight(){
     this->pattern_rows_.Set(0);
     this->pattern_columns_.Set(0);
     this->pattern_orientation_.Set(dlp::Pattern::Orientation::VERTICAL);
+
+    this->minimum_modulation_.Set(0.0);
+    this->minimum_decision_margin_.Set(0.0);
+    this->maximum_global_ratio_.Set(0.0);
+
+    this->band_rows_.Set(0);
+    this->band_overlap_.Set(16);
 }
 
 StructuredLight::~StructuredLight(){
@@ -79,5 +94,818 @@ ReturnCode StructuredLight::SetDlpPlatform( const dlp::DLP_Platform &platform ){
     return ret;
 }
 
+/** @brief  Restricts \ref DecodeCaptureSequence() to part of the camera frame
+ *  @param[in]  region  Camera pixels to decode, an empty \ref dlp::RegionOfInterest decodes the whole frame
+ *
+ *  Only the bounding box of the region is copied from the captures and
+ *  decoded. The returned \ref dlp::DisparityMap keeps the capture resolution
+ *  and every pixel outside the region is invalid.
+ */
+void StructuredLight::SetRegionOfInterest(const dlp::RegionOfInterest &region){
+    this->region_of_interest_ = region;
+}
+
+/** @brief  Retrieves the region set with \ref SetRegionOfInterest() */
+void StructuredLight::GetRegionOfInterest(dlp::RegionOfInterest *region) const{
+    if(region) *region = this->region_of_interest_;
+}
+
+/** @brief  Retrieves the measurements of the last \ref DecodeCaptureSequence()
+ *  @param[out] confidence_map  Return pointer for a copy of the \ref dlp::ConfidenceMap
+ *  @retval STRUCTURED_LIGHT_NULL_POINTER_ARGUMENT  Return argument is NULL
+ *  @retval STRUCTURED_LIGHT_CONFIDENCE_MAP_EMPTY   No sequence has been decoded
+ *
+ *  The map has the same resolution as the returned \ref dlp::DisparityMap.
+ *  Pixels outside of the bounding box of the region of interest have zero in
+ *  every measurement.
+ *  Measurements are kept for the pixels rejected by the limits of
+ *  \ref GetRejection() so they can be inspected.
+ */
+ReturnCode StructuredLight::GetConfidenceMap(dlp::ConfidenceMap *confidence_map) const{
+    ReturnCode ret;
+
+    if(!confidence_map)
+        return ret.AddError(STRUCTURED_LIGHT_NULL_POINTER_ARGUMENT);
+
+    if(this->confidence_map_.isEmpty())
+        return ret.AddError(STRUCTURED_LIGHT_CONFIDENCE_MAP_EMPTY);
+
+    return confidence_map->Create(this->confidence_map_);
+}
+
+/** @brief  Retrieves the limits which decoded pixels must meet
+ *  @param[out] rejection   Return pointer for the limits
+ *
+ *  The limits are set with \ref Parameters::MinimumModulation,
+ *  \ref Parameters::MinimumDecisionMargin and \ref Parameters::MaximumGlobalRatio.
+ *  Pixels which fail them are invalid in the \ref dlp::DisparityMap and are
+ *  NOT triangulated by \ref DecodeToPointCloud().
+ */
+void StructuredLight::GetRejection(dlp::ConfidenceMap::Rejection *rejection) const{
+    if(!rejection) return;
+
+    rejection->minimum_modulation   = this->minimum_modulation_.Get();
+    rejection->minimum_margin       = this->minimum_decision_margin_.Get();
+    rejection->maximum_global_ratio = this->maximum_global_ratio_.Get();
+}
+
+/** @brief  Retrieves the optional rejection limits from the settings
+ *  @param[in]  settings    \ref dlp::Parameters object to retrieve settings from
+ *
+ *  Limits missing from the settings keep their previous values.
+ */
+void StructuredLight::SetupRejection(const dlp::Parameters &settings){
+    if(settings.Contains(this->minimum_modulation_))
+        settings.Get(&this->minimum_modulation_);
+
+    if(settings.Contains(this->minimum_decision_margin_))
+        settings.Get(&this->minimum_decision_margin_);
+
+    if(settings.Contains(this->maximum_global_ratio_))
+        settings.Get(&this->maximum_global_ratio_);
+}
+
+/** @brief  Adds the rejection limits to the settings */
+void StructuredLight::GetRejectionSetup(dlp::Parameters *settings) const{
+    if(!settings) return;
+
+    settings->Set(this->minimum_modulation_);
+    settings->Set(this->minimum_decision_margin_);
+    settings->Set(this->maximum_global_ratio_);
+}
+
+/** @brief  Returns true if any rejection limit is set */
+bool StructuredLight::isRejectionEnabled() const{
+    dlp::ConfidenceMap::Rejection rejection;
+    this->GetRejection(&rejection);
+    return rejection.isEnabled();
+}
+
+/** @brief  Decodes a \ref dlp::Capture::Sequence straight into a \ref dlp::Point::Cloud
+ *  @param[in]  capture_sequence    \ref dlp::Capture::Sequence to be decoded
+ *  @param[in]  geometry            \ref dlp::Geometry with the origin and view port set
+ *  @param[in]  viewport_id         View port of the camera which captured the sequence
+ *  @param[out] ret_cloud           Pointer to return \ref dlp::Point::Cloud
+ *  @param[out] ret_distancemap     Pointer to return \ref dlp::Image depth map
+ *
+ *  This implementation runs \ref DecodeCaptureSequence() and then
+ *  \ref dlp::Geometry::GeneratePointCloud() with a single disparity map.
+ *  \ref dlp::GrayCode and \ref dlp::ThreePhase override it to decode the
+ *  frame in tiles and triangulate each tile while its disparity is still in
+ *  the cache. Their fused result matches the staged steps with
+ *  \ref dlp::Geometry::Parameters::SmoothDisparity disabled, since disparity
+ *  smoothing needs the whole map. The staged steps remain available for
+ *  inspecting the disparity map.
+ *
+ *  If \ref Parameters::BandRows is set those modules stream horizontal
+ *  bands of every capture instead, see \ref DecodeBandsToPointCloud(). The
+ *  depth map may then be NULL to keep memory use bounded by the band size.
+ */
+ReturnCode StructuredLight::DecodeToPointCloud(Capture::Sequence  *capture_sequence,
+                                               dlp::Geometry      *geometry,
+                                               const unsigned int &viewport_id,
+                                               dlp::Point::Cloud  *ret_cloud,
+                                               dlp::Image         *ret_distancemap){
+    ReturnCode ret;
+
+    if(!geometry)
+        return ret.AddError(STRUCTURED_LIGHT_NULL_POINTER_ARGUMENT);
+
+    dlp::DisparityMap disparity_map;
+    ret = this->DecodeCaptureSequence(capture_sequence, &disparity_map);
+    if(ret.hasErrors())
+        return ret;
+
+    return geometry->GeneratePointCloud(viewport_id, disparity_map, ret_cloud, ret_distancemap);
+}
+
+/** @brief  Loads captures as monochrome images cropped to the region of interest
+ *  @param[in]  capture_sequence    \ref dlp::Capture::Sequence to load
+ *  @param[in]  count               Number of captures to load from the start of the sequence
+ *  @param[out] images              Return pointer for the cropped images
+ *  @param[out] image_columns       Return pointer for the capture columns
+ *  @param[out] image_rows          Return pointer for the capture rows
+ *  @param[out] image_format        Return pointer for the format shared by every image
+ *  @param[out] region              Return pointer for the bounding box of the region of interest
+ *  @param[out] region_mask         Return pointer for the mask of the bounding box, empty if there is none
+ *  @retval STRUCTURED_LIGHT_DATA_TYPE_INVALID          Supplied sequence does NOT contain valid image data or a image file name
+ *  @retval STRUCTURED_LIGHT_PATTERN_SIZE_INVALID       Captures do NOT have the same resolution
+ *  @retval STRUCTURED_LIGHT_CAPTURE_FORMAT_INVALID     Supplied sequence mixes 8-bit and 16-bit captures
+ *
+ *  Only the region of interest is copied from image data captures.
+ */
+ReturnCode StructuredLight::LoadCaptureImages(Capture::Sequence       *capture_sequence,
+                                              const unsigned int      &count,
+                                              std::vector<dlp::Image> *images,
+                                              unsigned int            *image_columns,
+                                              unsigned int            *image_rows,
+                                              dlp::Image::Format      *image_format,
+                                              cv::Rect                *region,
+                                              cv::Mat                 *region_mask){
+    ReturnCode ret;
+
+    if(!capture_sequence || !images || !image_columns || !image_rows ||
+       !image_format || !region || !region_mask)
+        return ret.AddError(STRUCTURED_LIGHT_NULL_POINTER_ARGUMENT);
+
+    images->clear();
+    (*image_columns) = 0;
+    (*image_rows)    = 0;
+    (*image_format)  = dlp::Image::Format::INVALID;
+
+    for(unsigned int iCapture = 0; iCapture < count; iCapture++){
+        dlp::Capture capture;
+        dlp::Image   image;
+        cv::Mat      capture_data;
+
+        // Grab the capture from the sequence
+        ReturnCode ret_error = capture_sequence->Get(iCapture, &capture);
+
+        // Check that capture was grabbed
+        if(ret_error.hasErrors())
+            return ret_error;
+
+        // Check the capture type
+        switch(capture.data_type){
+        case dlp::Capture::DataType::IMAGE_FILE:
+        {
+            // Check that the file exists
+            if(!dlp::File::Exists(capture.image_file))
+                return ret.AddError(FILE_DOES_NOT_EXIST);
+
+            // Load the file and check the resolution
+            ret_error = image.Load(capture.image_file);
+            if(ret_error.hasErrors())
+                return ret_error;
+
+            image.Unsafe_GetOpenCVData(&capture_data);
+            break;
+        }
+        case dlp::Capture::DataType::IMAGE_DATA:
+        {
+            // Check that the image data is not empty
+            if(capture.image_data.isEmpty())
+                return ret.AddError(IMAGE_EMPTY);
+
+            // Reference the data, only the region of interest is copied
+            capture.image_data.Unsafe_GetOpenCVData(&capture_data);
+            break;
+        }
+        case dlp::Capture::DataType::INVALID:
+        default:
+            return ret.AddError(STRUCTURED_LIGHT_DATA_TYPE_INVALID);
+        }
+
+        // If on the first capture store the resolution and find the region
+        if(iCapture == 0){
+            (*image_columns) = capture_data.cols;
+            (*image_rows)    = capture_data.rows;
+
+            ret_error = this->region_of_interest_.GetBounds(*image_columns, *image_rows, region);
+            if(ret_error.hasErrors())
+                return ret_error;
+
+            this->region_of_interest_.GetMask(*region, region_mask);
+        }
+
+        // Check that each image has the same resolution
+        if( ((unsigned int) capture_data.rows != (*image_rows)) ||
+            ((unsigned int) capture_data.cols != (*image_columns)))
+            return ret.AddError(STRUCTURED_LIGHT_PATTERN_SIZE_INVALID);
+
+        // Copy the region of interest
+        ret_error = image.Create(capture_data(*region));
+        if(ret_error.hasErrors())
+            return ret_error;
+        capture_data.release();
+
+        // Convert the image to monochrome
+        image.ConvertToMonochrome();
+
+        // Every image must share the depth of the first capture
+        dlp::Image::Format capture_format;
+        image.GetDataFormat(&capture_format);
+        if(iCapture == 0)
+            (*image_format) = capture_format;
+
+        if(capture_format != (*image_format))
+            return ret.AddError(STRUCTURED_LIGHT_CAPTURE_FORMAT_INVALID);
+
+        // Add the image to the list
+        images->push_back(image);
+    }
+
+    return ret;
+}
+
+/** @brief  Decodes the region of interest in tiles and triangulates each tile as it is decoded
+ *  @param[in]  decode_tile         Decodes a tile given relative to the region
+ *  @param[in]  region              Bounding box of the region of interest
+ *  @param[in]  image_columns       Capture columns
+ *  @param[in]  image_rows          Capture rows
+ *  @param[in]  disparity_sampling  Disparity values per stripe returned by decode_tile
+ *  @param[in]  geometry            \ref dlp::Geometry with the origin and view port set
+ *  @param[in]  viewport_id         View port of the camera which captured the sequence
+ *  @param[out] ret_cloud           Pointer to return \ref dlp::Point::Cloud
+ *  @param[out] ret_distancemap     Pointer to return \ref dlp::Image depth map
+ *  @retval STRUCTURED_LIGHT_GEOMETRY_RESOLUTION_INVALID    View port resolution does NOT match the captures
+ *
+ *  Tiles are bands of \ref STRUCTURED_LIGHT_FUSED_TILE_LINES rows, or columns
+ *  for horizontal patterns, so Gray code edges are found along complete
+ *  lines. Tiles are processed in parallel and their points are added to the
+ *  cloud in row major order, the same order as the staged steps.
+ */
+ReturnCode StructuredLight::DecodeTilesToPointCloud(const TileDecoder    &decode_tile,
+                                                    const cv::Rect       &region,
+                                                    const unsigned int   &image_columns,
+                                                    const unsigned int   &image_rows,
+                                                    const unsigned int   &disparity_sampling,
+                                                    dlp::Geometry        *geometry,
+                                                    const unsigned int   &viewport_id,
+                                                    dlp::Point::Cloud    *ret_cloud,
+                                                    dlp::Image           *ret_distancemap){
+    ReturnCode ret;
+
+    if(!geometry || !ret_cloud || !ret_distancemap)
+        return ret.AddError(STRUCTURED_LIGHT_NULL_POINTER_ARGUMENT);
+
+    // Check that the view port matches the captures
+    unsigned int viewport_columns;
+    unsigned int viewport_rows;
+    ret = geometry->GetViewportResolution(viewport_id, &viewport_columns, &viewport_rows);
+    if(ret.hasErrors())
+        return ret;
+
+    if((viewport_columns != image_columns) || (viewport_rows != image_rows))
+        return ret.AddError(STRUCTURED_LIGHT_GEOMETRY_RESOLUTION_INVALID);
+
+    // Allocate memory for the distance map
+    ret_distancemap->Clear();
+    ret = ret_distancemap->Create(image_columns, image_rows, dlp::Image::Format::MONO_DOUBLE);
+    if(ret.hasErrors())
+        return ret;
+    ret_distancemap->FillImage((double)dlp::DisparityMap::EMPTY_PIXEL);
+
+    // Split the region into bands
+    const dlp::Pattern::Orientation orientation = this->pattern_orientation_.Get();
+    const bool         tile_columns = (orientation == dlp::Pattern::Orientation::HORIZONTAL);
+    const unsigned int lines        = tile_columns ? region.width : region.height;
+    const unsigned int tile_count   = (lines + STRUCTURED_LIGHT_FUSED_TILE_LINES - 1) / STRUCTURED_LIGHT_FUSED_TILE_LINES;
+
+    std::vector< std::vector<dlp::Point> > tile_points(tile_count);
+
+    dlp::Thread::ParallelFor(0, tile_count, [&](unsigned long long first, unsigned long long last){
+        cv::Mat disparity;
+
+        for(unsigned long long iTile = first; iTile < last; iTile++){
+            int start  = iTile * STRUCTURED_LIGHT_FUSED_TILE_LINES;
+            int length = std::min((int) STRUCTURED_LIGHT_FUSED_TILE_LINES, (int) lines - start);
+
+            cv::Rect tile = tile_columns ? cv::Rect(start, 0, length, region.height) :
+                                           cv::Rect(0, start, region.width, length);
+
+            decode_tile(tile, &disparity);
+
+            // Triangulate the tile in full frame coordinates
+            cv::Rect frame_tile(tile.x + region.x, tile.y + region.y, tile.width, tile.height);
+            geometry->Unsafe_GeneratePointCloudTile(viewport_id, orientation, disparity_sampling,
+                                                    frame_tile, disparity,
+                                                    &tile_points.at(iTile), ret_distancemap);
+        }
+    });
+
+    // Column bands produce their points column by column, so they are
+    // sorted back into row major order
+    ret_cloud->Clear();
+    if(!tile_columns){
+        for(unsigned int iTile = 0; iTile < tile_count; iTile++){
+            for(unsigned long long iPoint = 0; iPoint < tile_points.at(iTile).size(); iPoint++){
+                ret_cloud->Add(tile_points.at(iTile).at(iPoint));
+            }
+        }
+    }
+    else{
+        // Every band holds its points row by row, so merge the rows of all bands
+        std::vector<unsigned long long> next(tile_count, 0);
+        cv::Mat depth;
+        ret_distancemap->Unsafe_GetOpenCVData(&depth);
+
+        for(    int yRow = region.y; yRow < region.y + region.height; yRow++){
+            for(unsigned int iTile = 0; iTile < tile_count; iTile++){
+                int column_start = region.x + iTile * STRUCTURED_LIGHT_FUSED_TILE_LINES;
+                int column_end   = std::min(column_start + STRUCTURED_LIGHT_FUSED_TILE_LINES, region.x + region.width);
+
+                for(int xCol = column_start; xCol < column_end; xCol++){
+                    if(depth.at<double>(yRow, xCol) == (double) dlp::DisparityMap::EMPTY_PIXEL) continue;
+                    ret_cloud->Add(tile_points.at(iTile).at(next.at(iTile)++));
+                }
+            }
+        }
+    }
+
+    return ret;
+}
+
+/** @brief  Returns true if \ref DecodeToPointCloud() streams bands of the captures */
+bool StructuredLight::isBanded() const{
+    return (this->band_rows_.Get() > 0);
+}
+
+/** @brief  Retrieves the optional band settings
+ *  @param[in]  settings    \ref dlp::Parameters object to retrieve settings from
+ *
+ *  Settings missing from the parameters keep their previous values.
+ */
+void StructuredLight::SetupBands(const dlp::Parameters &settings){
+    if(settings.Contains(this->band_rows_))
+        settings.Get(&this->band_rows_);
+
+    if(settings.Contains(this->band_overlap_))
+        settings.Get(&this->band_overlap_);
+}
+
+/** @brief  Adds the band settings to the settings */
+void StructuredLight::GetBandSetup(dlp::Parameters *settings) const{
+    if(!settings) return;
+
+    settings->Set(this->band_rows_);
+    settings->Set(this->band_overlap_);
+}
+
+/** @brief  Decodes and triangulates the region of interest one horizontal band at a time
+ *  @param[in]  capture_sequence    \ref dlp::Capture::Sequence to be decoded
+ *  @param[in]  decode_band         Decodes the same band of every capture
+ *  @param[in]  disparity_sampling  Disparity values per stripe returned by decode_band
+ *  @param[in]  stripe_rows         Pattern rows of a stripe whose edges decode_band searches
+ *                                  along the columns, 0 if it does NOT search across rows
+ *  @param[in]  geometry            \ref dlp::Geometry with the origin and view port set
+ *  @param[in]  viewport_id         View port of the camera which captured the sequence
+ *  @param[out] ret_cloud           Pointer to return \ref dlp::Point::Cloud
+ *  @param[out] ret_distancemap     Pointer to return \ref dlp::Image depth map, may be NULL
+ *  @retval STRUCTURED_LIGHT_NULL_POINTER_ARGUMENT          Argument is NULL
+ *  @retval STRUCTURED_LIGHT_GEOMETRY_RESOLUTION_INVALID    View port resolution does NOT match the captures
+ *
+ *  The captures are read with a \ref dlp::CaptureBandReader, so image data
+ *  captures are NOT copied and image file captures are loaded once and
+ *  spilled to a temporary file. Each band of \ref Parameters::BandRows rows
+ *  is decoded together with \ref Parameters::BandOverlap rows above and
+ *  below it, or \ref dlp::Geometry::GetSmoothingRadius() rows if that is
+ *  larger. The overlap is smoothed but only the band is triangulated, so
+ *  the points match \ref DecodeCaptureSequence() followed by
+ *  \ref dlp::Geometry::GeneratePointCloud() with disparity smoothing.
+ *  Horizontal subpixel Gray code edges are searched along the columns, so
+ *  for those the overlap is raised to twice the stripe_rows scaled from the
+ *  pattern rows to the capture rows. Cameras which magnify the stripes
+ *  more than that need a larger \ref Parameters::BandOverlap.
+ *
+ *  Without a depth map the memory used is bounded by the band rows times the
+ *  capture columns and count, independent of the capture rows.
+ */
+ReturnCode StructuredLight::DecodeBandsToPointCloud(Capture::Sequence    *capture_sequence,
+                                                    const BandDecoder    &decode_band,
+                                                    const unsigned int   &disparity_sampling,
+                                                    const unsigned int   &stripe_rows,
+                                                    dlp::Geometry        *geometry,
+                                                    const unsigned int   &viewport_id,
+                                                    dlp::Point::Cloud    *ret_cloud,
+                                                    dlp::Image           *ret_distancemap){
+    ReturnCode ret;
+
+    if(!capture_sequence || !geometry || !ret_cloud)
+        return ret.AddError(STRUCTURED_LIGHT_NULL_POINTER_ARGUMENT);
+
+    // Prepare the captures to be read in bands
+    dlp::CaptureBandReader reader;
+    ret = reader.Open(*capture_sequence, 0, this->sequence_count_total_);
+    if(ret.hasErrors())
+        return ret;
+
+    const unsigned int image_columns = reader.GetColumns();
+    const unsigned int image_rows    = reader.GetRows();
+
+    // Check that the view port matches the captures
+    unsigned int viewport_columns;
+    unsigned int viewport_rows;
+    ret = geometry->GetViewportResolution(viewport_id, &viewport_columns, &viewport_rows);
+    if(ret.hasErrors())
+        return ret;
+
+    if((viewport_columns != image_columns) || (viewport_rows != image_rows))
+        return ret.AddError(STRUCTURED_LIGHT_GEOMETRY_RESOLUTION_INVALID);
+
+    cv::Rect region;
+    ret = this->region_of_interest_.GetBounds(image_columns, image_rows, &region);
+    if(ret.hasErrors())
+        return ret;
+
+    // Allocate memory for the distance map
+    if(ret_distancemap){
+        ret_distancemap->Clear();
+        ret = ret_distancemap->Create(image_columns, image_rows, dlp::Image::Format::MONO_DOUBLE);
+        if(ret.hasErrors())
+            return ret;
+        ret_distancemap->FillImage((double)dlp::DisparityMap::EMPTY_PIXEL);
+    }
+
+    const dlp::Pattern::Orientation orientation = this->pattern_orientation_.Get();
+    const int band_rows    = this->band_rows_.Get();
+    const int region_end   = region.y + region.height;
+    int       overlap      = std::max(this->band_overlap_.Get(), geometry->GetSmoothingRadius(orientation));
+
+    // Every pixel of the core must see both edges of its stripe
+    if((stripe_rows > 0) && (this->pattern_rows_.Get() > 0)){
+        unsigned long long scaled = 2ull * stripe_rows * image_rows;
+        int stripe_overlap = (int) ((scaled + this->pattern_rows_.Get() - 1) / this->pattern_rows_.Get()) + 1;
+        overlap = std::max(overlap, stripe_overlap);
+    }
+
+    std::vector<cv::Mat>    captures;
+    std::vector<dlp::Point> points;
+    cv::Mat                 band_mask;
+    cv::Mat                 disparity;
+
+    ret_cloud->Clear();
+
+    for(int core_start = region.y; core_start < region_end; core_start += band_rows){
+        int core_end   = std::min(core_start + band_rows, region_end);
+        int band_start = std::max(core_start - overlap, region.y);
+        int band_end   = std::min(core_end   + overlap, region_end);
+
+        cv::Rect core(region.x, core_start, region.width, core_end - core_start);
+        cv::Rect band(region.x, band_start, region.width, band_end - band_start);
+
+        // Decode the band with its overlap
+        ret = reader.Read(band, &captures);
+        if(ret.hasErrors())
+            return ret;
+
+        this->region_of_interest_.GetMask(band, &band_mask);
+        decode_band(captures, reader.isSixteenBit(), band_mask, &disparity);
+
+        // Smooth the whole band and keep the points of its core
+        points.clear();
+        geometry->Unsafe_GeneratePointCloudBand(viewport_id, orientation, disparity_sampling,
+                                                band, core, disparity, &points, ret_distancemap);
+
+        for(unsigned long long iPoint = 0; iPoint < points.size(); iPoint++){
+            ret_cloud->Add(points[iPoint]);
+        }
+    }
+
+    return ret;
+}
+
+/** @brief  Marks the decoded pixels outside of a mask invalid
+ *  @param[in]  mask        CV_8UC1 mask of the decoded bounding box, may be empty
+ *  @param[out] disparity   CV_32SC1 disparity data of the bounding box
+ */
+void StructuredLight::ApplyRegionMask(const cv::Mat &mask, cv::Mat *disparity){
+    if(mask.empty() || !disparity) return;
+
+    for(int yRow = 0; yRow < disparity->rows; yRow++){
+        const unsigned char *pixel_mask      = mask.ptr<unsigned char>(yRow);
+        int                 *pixel_disparity = disparity->ptr<int>(yRow);
+
+        for(int xCol = 0; xCol < disparity->cols; xCol++){
+            if(pixel_mask[xCol] == 0) pixel_disparity[xCol] = dlp::DisparityMap::INVALID_PIXEL;
+        }
+    }
+}
+
+/** @brief  Places a disparity map decoded from a bounding box into a full frame map
+ *  @param[in]      bounds          Bounding box the map was decoded from
+ *  @param[in]      image_columns   Capture columns
+ *  @param[in]      image_rows      Capture rows
+ *  @param[in,out]  disparity_map   Bounding box map which is replaced with the full frame map
+ *  @retval STRUCTURED_LIGHT_NULL_POINTER_ARGUMENT  Argument is NULL
+ *
+ *  Nothing is copied if the bounding box is the whole frame.
+ */
+ReturnCode StructuredLight::ExpandRegion(const cv::Rect &bounds,
+                                         const unsigned int &image_columns,
+                                         const unsigned int &image_rows,
+                                         dlp::DisparityMap *disparity_map){
+    ReturnCode ret;
+
+    if(!disparity_map)
+        return ret.AddError(STRUCTURED_LIGHT_NULL_POINTER_ARGUMENT);
+
+    if((bounds.x == 0) && (bounds.y == 0) &&
+       ((unsigned int) bounds.width  == image_columns) &&
+       ((unsigned int) bounds.height == image_rows))
+        return ret;
+
+    dlp::Pattern::Orientation orientation;
+    unsigned int              over_sample;
+    disparity_map->GetOrientation(&orientation);
+    disparity_map->GetDisparitySampling(&over_sample);
+
+    dlp::DisparityMap full_frame;
+    ret = full_frame.Create(image_columns, image_rows, orientation, over_sample);
+    if(ret.hasErrors())
+        return ret;
+
+    cv::Mat region_data;
+    cv::Mat full_frame_data;
+    disparity_map->Unsafe_GetOpenCVData(&region_data);
+    full_frame.Unsafe_GetOpenCVData(&full_frame_data);
+
+    full_frame_data.setTo(dlp::DisparityMap::INVALID_PIXEL);
+    cv::Mat full_frame_region = full_frame_data(bounds);
+    region_data.copyTo(full_frame_region);
+
+    // Hand over the full frame memory rather than copying it again
+    *disparity_map = full_frame;
+
+    return ret;
+}
+
+/** @brief  Stores the measurements of a decoded bounding box as the full frame \ref dlp::ConfidenceMap
+ *  @param[in]  bounds          Bounding box the measurements were decoded from
+ *  @param[in]  image_columns   Capture columns
+ *  @param[in]  image_rows      Capture rows
+ *  @param[in]  confidence      Measurements of the bounding box
+ */
+ReturnCode StructuredLight::StoreConfidence(const cv::Rect &bounds,
+                                            const unsigned int &image_columns,
+                                            const unsigned int &image_rows,
+                                            const TileConfidence &confidence){
+    ReturnCode ret;
+
+    ret = this->confidence_map_.Create(image_columns, image_rows);
+    if(ret.hasErrors())
+        return ret;
+
+    cv::Mat modulation;
+    cv::Mat global;
+    cv::Mat margin;
+    this->confidence_map_.Unsafe_GetOpenCVData(&modulation, &global, &margin);
+
+    cv::Mat modulation_region = modulation(bounds);
+    cv::Mat global_region     = global(bounds);
+    cv::Mat margin_region     = margin(bounds);
+
+    confidence.modulation.copyTo(modulation_region);
+    confidence.global.copyTo(global_region);
+    confidence.margin.copyTo(margin_region);
+
+    return ret;
+}
+
+/** @brief  Generated sequences shared by every structured light module */
+struct PatternCache{
+    struct Entry{
+        std::string        key;
+        Pattern::Sequence  sequence;
+        unsigned long long last_use;
+    };
+
+    std::mutex          lock;
+    std::vector<Entry>  entries;
+    unsigned int        maximum_entries = 4;
+    unsigned long long  use_count       = 0;
+    StructuredLight::PatternCacheStatistics statistics = {0, 0, 0};
+};
+
+static PatternCache& GetPatternCache(){
+    static PatternCache cache;
+    return cache;
+}
+
+/** @brief Sets the number of generated sequences kept for reuse
+ *  @param[in] sequences    Maximum number of cached sequences, zero disables the cache
+ *
+ *  The least recently used sequences are removed when the cache is full.
+ */
+void StructuredLight::SetPatternCacheSize(const unsigned int &sequences){
+    PatternCache &cache = GetPatternCache();
+    std::lock_guard<std::mutex> guard(cache.lock);
+
+    cache.maximum_entries = sequences;
+    while(cache.entries.size() > cache.maximum_entries){
+        unsigned int oldest = 0;
+        for(unsigned int iEntry = 1; iEntry < cache.entries.size(); iEntry++){
+            if(cache.entries.at(iEntry).last_use < cache.entries.at(oldest).last_use)
+                oldest = iEntry;
+        }
+        cache.entries.erase(cache.entries.begin() + oldest);
+        cache.statistics.evictions++;
+    }
+}
+
+/** @brief Removes every cached sequence */
+void StructuredLight::ClearPatternCache(){
+    PatternCache &cache = GetPatternCache();
+    std::lock_guard<std::mutex> guard(cache.lock);
+    cache.entries.clear();
+}
+
+/** @brief Retrieves the pattern cache counters
+ *  @param[out] statistics  Return pointer for the counters
+ */
+void StructuredLight::GetPatternCacheStatistics(PatternCacheStatistics *statistics){
+    if(!statistics) return;
+
+    PatternCache &cache = GetPatternCache();
+    std::lock_guard<std::mutex> guard(cache.lock);
+    (*statistics) = cache.statistics;
+}
+
+/** @brief Sets the pattern cache counters to zero */
+void StructuredLight::ResetPatternCacheStatistics(){
+    PatternCache &cache = GetPatternCache();
+    std::lock_guard<std::mutex> guard(cache.lock);
+    cache.statistics.hits      = 0;
+    cache.statistics.misses    = 0;
+    cache.statistics.evictions = 0;
+}
+
+/** @brief Looks up a previously generated sequence
+ *  @param[in]  key         Complete description of the settings used to generate the sequence
+ *  @param[out] sequence    Return pointer for the cached sequence
+ *  @retval     true        The sequence was found
+ *
+ *  The returned patterns share their image data with the cache.
+ */
+bool StructuredLight::GetCachedPatternSequence(const std::string &key, Pattern::Sequence *sequence){
+    PatternCache &cache = GetPatternCache();
+    std::lock_guard<std::mutex> guard(cache.lock);
+
+    for(unsigned int iEntry = 0; iEntry < cache.entries.size(); iEntry++){
+        if(cache.entries.at(iEntry).key == key){
+            cache.entries.at(iEntry).last_use = ++cache.use_count;
+            (*sequence) = cache.entries.at(iEntry).sequence;
+            cache.statistics.hits++;
+            return true;
+        }
+    }
+
+    cache.statistics.misses++;
+    return false;
+}
+
+/** @brief Stores a generated sequence for reuse
+ *  @param[in] key          Complete description of the settings used to generate the sequence
+ *  @param[in] sequence     Generated sequence
+ */
+void StructuredLight::CachePatternSequence(const std::string &key, const Pattern::Sequence &sequence){
+    PatternCache &cache = GetPatternCache();
+    std::lock_guard<std::mutex> guard(cache.lock);
+
+    if(cache.maximum_entries == 0) return;
+
+    // Replace an existing entry with the same key
+    for(unsigned int iEntry = 0; iEntry < cache.entries.size(); iEntry++){
+        if(cache.entries.at(iEntry).key == key){
+            cache.entries.at(iEntry).sequence = sequence;
+            cache.entries.at(iEntry).last_use = ++cache.use_count;
+            return;
+        }
+    }
+
+    // Remove the least recently used entry if the cache is full
+    if(cache.entries.size() >= cache.maximum_entries){
+        unsigned int oldest = 0;
+        for(unsigned int iEntry = 1; iEntry < cache.entries.size(); iEntry++){
+            if(cache.entries.at(iEntry).last_use < cache.entries.at(oldest).last_use)
+                oldest = iEntry;
+        }
+        cache.entries.erase(cache.entries.begin() + oldest);
+        cache.statistics.evictions++;
+    }
+
+    PatternCache::Entry entry;
+    entry.key      = key;
+    entry.sequence = sequence;
+    entry.last_use = ++cache.use_count;
+    cache.entries.push_back(entry);
+}
+
+/** @brief Creates a monochrome pattern image from a one dimensional stripe profile
+ *  @param[in]  profile     Pixel value of each stripe position
+ *  @param[in]  offset      Position in the profile of the first stripe on the DMD
+ *  @param[in]  columns     Image columns
+ *  @param[in]  rows        Image rows
+ *  @param[in]  orientation Direction of the stripes
+ *  @param[out] image       Return pointer for the \ref dlp::Image::Format::MONO_UCHAR image
+ *  @retval     STRUCTURED_LIGHT_NULL_POINTER_ARGUMENT  Return argument is NULL
+ *  @retval     STRUCTURED_LIGHT_PATTERN_SIZE_INVALID   Profile is too short for the image
+ *  @retval     STRUCTURED_LIGHT_NOT_SETUP              Orientation is invalid
+ *
+ *  Every image row is a contiguous slice of the profile, so each row is
+ *  copied rather than set pixel by pixel. Vertical stripes copy the first
+ *  row down the image and horizontal stripes fill each row with one value.
+ *  Diamond rows start half a stripe further along every two rows.
+ */
+ReturnCode StructuredLight::GenerateStripeImage(const std::vector<unsigned char> &profile,
+                                                const unsigned int &offset,
+                                                const unsigned int &columns,
+                                                const unsigned int &rows,
+                                                const dlp::Pattern::Orientation &orientation,
+                                                dlp::Image *image){
+    ReturnCode ret;
+
+    if(!image)
+        return ret.AddError(STRUCTURED_LIGHT_NULL_POINTER_ARGUMENT);
+
+    // Check that every row slice lies inside the profile
+    unsigned long long last_position;
+    switch(orientation){
+    case dlp::Pattern::Orientation::VERTICAL:
+        last_position = (unsigned long long) offset + columns;
+        break;
+    case dlp::Pattern::Orientation::HORIZONTAL:
+        last_position = (unsigned long long) offset + rows;
+        break;
+    case dlp::Pattern::Orientation::DIAMOND_ANGLE_1:
+        last_position = (unsigned long long) offset + (rows > 0 ? (rows - 1)/2 : 0) + columns;
+        break;
+    case dlp::Pattern::Orientation::DIAMOND_ANGLE_2:
+        last_position = (unsigned long long) offset + (rows/2) + columns;
+        break;
+    case dlp::Pattern::Orientation::INVALID:
+    default:
+        return ret.AddError(STRUCTURED_LIGHT_NOT_SETUP);
+    }
+
+    if(last_position > profile.size())
+        return ret.AddError(STRUCTURED_LIGHT_PATTERN_SIZE_INVALID);
+
+    ret = image->Create(columns, rows, dlp::Image::Format::MONO_UCHAR);
+    if(ret.hasErrors())
+        return ret;
+
+    // Write through a header which shares the image memory
+    cv::Mat data;
+    image->Unsafe_GetOpenCVData(&data);
+
+    for(unsigned int yRow = 0; yRow < rows; yRow++){
+        unsigned char *row = data.ptr<unsigned char>(yRow);
+
+        switch(orientation){
+        case dlp::Pattern::Orientation::VERTICAL:
+            // Every row is identical to the first
+            if(yRow == 0) std::memcpy(row, &profile[offset], columns);
+            else          std::memcpy(row, data.ptr<unsigned char>(0), columns);
+            break;
+        case dlp::Pattern::Orientation::HORIZONTAL:
+            std::memset(row, profile[offset + yRow], columns);
+            break;
+        case dlp::Pattern::Orientation::DIAMOND_ANGLE_1:
+            std::memcpy(row, &profile[offset + (yRow/2)], columns);
+            break;
+        case dlp::Pattern::Orientation::DIAMOND_ANGLE_2:
+            std::memcpy(row, &profile[offset + ((rows - yRow)/2)], columns);
+            break;
+        default:
+            break;
+        }
+    }
+
+    data.release();
+
+    return ret;
+}
+
 
 }
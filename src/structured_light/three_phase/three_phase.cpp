@@ -133,6 +133,10 @@ ReturnCode ThreePhase::Setup(const dlp::Parameters &settings){
     if(settings.Contains(this->repeat_phases_))
         settings.Get(&this->repeat_phases_);
 
+    // Confidence rejection limits and band decoding are optional
+    this->SetupRejection(settings);
+    this->SetupBands(settings);
+
     if(!this->use_hybrid_.Get()){
         //this->sequence_count_total_ = 3;
         return ret.AddError(THREE_PHASE_ONLY_HYBRID_UNWRAP_SUPPORTED);
@@ -154,6 +158,7 @@ ReturnCode ThreePhase::Setup(const dlp::Parameters &settings){
         // Check for additional GrayCode module parameters in settings
         settings.Get(&this->hybrid_include_inverted_);
         settings.Get(&this->hybrid_pixel_threshold_);
+        settings.Get(&this->hybrid_capture_bit_depth_);
 
         // Setup the GrayCode module for hybrid unwrapping
         dlp::Parameters hybrid_settings;
@@ -164,6 +169,7 @@ ReturnCode ThreePhase::Setup(const dlp::Parameters &settings){
         hybrid_settings.Set(this->hybrid_region_count_);
         hybrid_settings.Set(this->hybrid_include_inverted_);
         hybrid_settings.Set(this->hybrid_pixel_threshold_);
+        hybrid_settings.Set(this->hybrid_capture_bit_depth_);
 
         ret = this->hybrid_unwrap_module_.Setup(hybrid_settings);
         if(ret.hasErrors())
@@ -186,6 +192,12 @@ ReturnCode ThreePhase::Setup(const dlp::Parameters &settings){
  *  @retval STRUCTURED_LIGHT_NULL_POINTER_ARGUMENT  Return argument is NULL
  *  @retval STRUCTURED_LIGHT_NOT_SETUP              Module has NOT been setup
  *  @retval STRUCTURED_LIGHT_CAPTURE_SEQUENCE_SIZE_INVALID  Requested number of patterns is NOT possible with the specified DMD resolution
+ *
+ *  Sequences are cached by the settings which change the patterns, so
+ *  decode-only settings such as the hybrid pixel threshold, confidence
+ *  rejection, and band decoding reuse the cached sequence. The returned pattern
+ *  images may be shared with the cache and should be copied before they
+ *  are modified in place.
  */
 ReturnCode ThreePhase::GeneratePatternSequence(Pattern::Sequence *pattern_sequence){
     ReturnCode ret;
@@ -198,6 +210,26 @@ ReturnCode ThreePhase::GeneratePatternSequence(Pattern::Sequence *pattern_sequen
     if(!pattern_sequence)
         return ret.AddError(STRUCTURED_LIGHT_NULL_POINTER_ARGUMENT);
 
+    // Reuse the sequence if it was already generated with the same pattern settings
+    dlp::Parameters settings;
+    settings.Set(this->pattern_rows_);
+    settings.Set(this->pattern_columns_);
+    settings.Set(this->pattern_color_);
+    settings.Set(this->pattern_orientation_);
+    settings.Set(this->frequency_);
+    settings.Set(this->bitdepth_);
+    settings.Set(this->use_hybrid_);
+    settings.Set(this->pixels_per_period_);
+    settings.Set(this->repeat_phases_);
+    if(this->use_hybrid_.Get()){
+        settings.Set(this->hybrid_region_count_);
+        settings.Set(this->hybrid_include_inverted_);
+    }
+    const std::string cache_key = "THREE_PHASE\n" + settings.ToString();
+
+    if(GetCachedPatternSequence(cache_key, pattern_sequence))
+        return ret;
+
     // Generate the three phase code values
     std::vector< unsigned char > sine_phase_value_0;
     std::vector< unsigned char > sine_phase_value_p120;
@@ -225,67 +257,18 @@ ReturnCode ThreePhase::GeneratePatternSequence(Pattern::Sequence *pattern_sequen
     unsigned int rows     = this->pattern_rows_.Get();
     unsigned int columns  = this->pattern_columns_.Get();
 
-    // Create the three phase images
+    // Broadcast each profile across its image
     dlp::Image sine_phase_image_0;
     dlp::Image sine_phase_image_p120;
     dlp::Image sine_phase_image_n120;
 
-    sine_phase_image_0.Create(    columns, rows, dlp::Image::Format::MONO_UCHAR );
-    sine_phase_image_p120.Create( columns, rows, dlp::Image::Format::MONO_UCHAR );
-    sine_phase_image_n120.Create( columns, rows, dlp::Image::Format::MONO_UCHAR );
-
-
-    switch(this->pattern_orientation_.Get()){
-    case dlp::Pattern::Orientation::VERTICAL:
-        for(     unsigned int yRow = 0; yRow < rows;    yRow++){
-            for( unsigned int xCol = 0; xCol < columns; xCol++){
-                sine_phase_image_0.Unsafe_SetPixel(    xCol, yRow, sine_phase_value_0.at(xCol) );
-                sine_phase_image_p120.Unsafe_SetPixel( xCol, yRow, sine_phase_value_p120.at(xCol) );
-                sine_phase_image_n120.Unsafe_SetPixel( xCol, yRow, sine_phase_value_n120.at(xCol) );
-            }
-        }
-
-        break;
-    case dlp::Pattern::Orientation::HORIZONTAL:
-        for(     unsigned int yRow = 0; yRow < rows;    yRow++){
-            for( unsigned int xCol = 0; xCol < columns; xCol++){
-                sine_phase_image_0.Unsafe_SetPixel(    xCol, yRow, sine_phase_value_0.at(yRow) );
-                sine_phase_image_p120.Unsafe_SetPixel( xCol, yRow, sine_phase_value_p120.at(yRow) );
-                sine_phase_image_n120.Unsafe_SetPixel( xCol, yRow, sine_phase_value_n120.at(yRow) );
-            }
-        }
-        break;
-    case dlp::Pattern::Orientation::DIAMOND_ANGLE_2:
-        // Set the pixels
-        for(     unsigned int yRow = 0; yRow < rows;    yRow++){
-            for( unsigned int xCol = 0; xCol < columns; xCol++){
-                unsigned int code = ((rows - yRow)/2) + xCol;
-
-                // Save the pixel value
-                sine_phase_image_0.Unsafe_SetPixel(    xCol, yRow, sine_phase_value_0.at(code) );
-                sine_phase_image_p120.Unsafe_SetPixel( xCol, yRow, sine_phase_value_p120.at(code) );
-                sine_phase_image_n120.Unsafe_SetPixel( xCol, yRow, sine_phase_value_n120.at(code) );
-            }
-        }
-        break;
-    case dlp::Pattern::Orientation::DIAMOND_ANGLE_1:
-        // Set the pixels
-        for(     unsigned int yRow = 0; yRow < rows;    yRow++){
-            for( unsigned int xCol = 0; xCol < columns; xCol++){
-                unsigned int code = (yRow/2) + xCol;
-
-                // Save the pixel value
-                sine_phase_image_0.Unsafe_SetPixel(    xCol, yRow, sine_phase_value_0.at(code) );
-                sine_phase_image_p120.Unsafe_SetPixel( xCol, yRow, sine_phase_value_p120.at(code) );
-                sine_phase_image_n120.Unsafe_SetPixel( xCol, yRow, sine_phase_value_n120.at(code) );
-            }
-        }
-        break;
-    case dlp::Pattern::Orientation::INVALID:
-    default:
-        return ret.AddError(STRUCTURED_LIGHT_NOT_SETUP);
-        break;
-    }
+    ret = this->GenerateStripeImage(sine_phase_value_0, 0, columns, rows, this->pattern_orientation_.Get(), &sine_phase_image_0);
+    if(!ret.hasErrors())
+        ret = this->GenerateStripeImage(sine_phase_value_p120, 0, columns, rows, this->pattern_orientation_.Get(), &sine_phase_image_p120);
+    if(!ret.hasErrors())
+        ret = this->GenerateStripeImage(sine_phase_value_n120, 0, columns, rows, this->pattern_orientation_.Get(), &sine_phase_image_n120);
+    if(ret.hasErrors())
+        return ret;
 
     // Create the patterns
     dlp::Pattern sine_phase_pattern_0;
@@ -295,17 +278,17 @@ ReturnCode ThreePhase::GeneratePatternSequence(Pattern::Sequence *pattern_sequen
     sine_phase_pattern_0.bitdepth  = this->bitdepth_.Get();
     sine_phase_pattern_0.color     = this->pattern_color_.Get();
     sine_phase_pattern_0.data_type = dlp::Pattern::DataType::IMAGE_DATA;
-    sine_phase_pattern_0.image_data.Create(sine_phase_image_0);
+    sine_phase_pattern_0.image_data = sine_phase_image_0;
 
     sine_phase_pattern_p120.bitdepth  = this->bitdepth_.Get();
     sine_phase_pattern_p120.color     = this->pattern_color_.Get();
     sine_phase_pattern_p120.data_type = dlp::Pattern::DataType::IMAGE_DATA;
-    sine_phase_pattern_p120.image_data.Create(sine_phase_image_p120);
+    sine_phase_pattern_p120.image_data = sine_phase_image_p120;
 
     sine_phase_pattern_n120.bitdepth  = this->bitdepth_.Get();
     sine_phase_pattern_n120.color     = this->pattern_color_.Get();
     sine_phase_pattern_n120.data_type = dlp::Pattern::DataType::IMAGE_DATA;
-    sine_phase_pattern_n120.image_data.Create(sine_phase_image_n120);
+    sine_phase_pattern_n120.image_data = sine_phase_image_n120;
 
     // Add the patterns to the return sequence
     for(unsigned int iCount = 0; iCount < this->repeat_phases_.Get();iCount++){
@@ -331,25 +314,26 @@ ReturnCode ThreePhase::GeneratePatternSequence(Pattern::Sequence *pattern_sequen
     // Add the GrayCode patterns to the return sequence
     pattern_sequence->Add(hybrid_sequence);
 
+    // Keep the sequence for later setups with the same settings
+    CachePatternSequence(cache_key, *pattern_sequence);
+
     return ret;
 }
 
 
 
-/** @brief Decodes the \ref dlp::Capture::Sequence and returns the \ref dlp::DisparityMap
- *  @param[in] capture_sequence \ref dlp::Capture::Sequence to be decoded
- *  @param[in] disparity_map Return pointer for generated \ref dlp::DisparityMap
- *  @retval STRUCTURED_LIGHT_NULL_POINTER_ARGUMENT      Input arguments NULL
- *  @retval STRUCTURED_LIGHT_NOT_SETUP                  Module has NOT been setup
- *  @retval STRUCTURED_LIGHT_CAPTURE_SEQUENCE_EMPTY     Supplied sequence is empty
- *  @retval STRUCTURED_LIGHT_CAPTURE_SEQUENCE_SIZE_INVALID  Supplied sequence has a difference count than what was generated
- *  @retval STRUCTURED_LIGHT_DATA_TYPE_INVALID          Supplied sequence does NOT contain valid image data or a image file name
-*/
-ReturnCode ThreePhase::DecodeCaptureSequence(Capture::Sequence *capture_sequence, dlp::DisparityMap *disparity_map){
+/** @brief Checks and loads the captures of the \ref dlp::Capture::Sequence
+ *  @param[in]  capture_sequence    \ref dlp::Capture::Sequence to be decoded
+ *  @param[out] data                Return pointer for the region of interest of the captures
+ *
+ *  The hybrid unwrapping \ref dlp::GrayCode captures are loaded by that
+ *  module over the same region of interest.
+ */
+ReturnCode ThreePhase::LoadCaptures(Capture::Sequence *capture_sequence, CaptureData *data){
     ReturnCode ret;
 
     // Check the pointers
-    if(!capture_sequence || !disparity_map)
+    if(!capture_sequence || !data)
         return ret.AddError(STRUCTURED_LIGHT_NULL_POINTER_ARGUMENT);
 
     // Check that ThreePhase object is setup
@@ -364,134 +348,121 @@ ReturnCode ThreePhase::DecodeCaptureSequence(Capture::Sequence *capture_sequence
     if(capture_sequence->GetCount() != this->sequence_count_total_)
         return ret.AddError(STRUCTURED_LIGHT_CAPTURE_SEQUENCE_SIZE_INVALID);
 
-    // Create a vector of the images to decode
-    std::vector<dlp::Image> images_coded;
+    // The first captures are the sinusoidal patterns
+    const unsigned int phase_count = 3*this->repeat_phases_.Get();
+
+    dlp::Image::Format image_format;
+    ret = this->LoadCaptureImages(capture_sequence, phase_count, &data->phase_images,
+                                  &data->image_columns, &data->image_rows, &image_format,
+                                  &data->region, &data->region_mask);
+    if(ret.hasErrors())
+        return ret;
+
+    data->phase.clear();
+    for(unsigned int iImage = 0; iImage < data->phase_images.size(); iImage++){
+        cv::Mat phase_data;
+        data->phase_images.at(iImage).Unsafe_GetOpenCVData(&phase_data);
+        data->phase.push_back(phase_data);
+    }
 
-    // Store the image resolution
-    unsigned int image_rows    = 0;
-    unsigned int image_columns = 0;
+    // The phase is a ratio of intensities so 16-bit captures are read at
+    // their full depth without any scaling
+    data->phase_sixteen_bit = (image_format == dlp::Image::Format::MONO_USHORT);
 
     // Seperate the GrayCode captures
     dlp::Capture::Sequence gray_code_sequence;
-
-    // Check and copy the image data for the three phase patterns
-    for(unsigned int iCapture = 0; iCapture < this->sequence_count_total_; iCapture++){
+    for(unsigned int iCapture = phase_count; iCapture < this->sequence_count_total_; iCapture++){
         dlp::Capture capture;
-        dlp::Image   image;
-        unsigned int capture_rows;
-        unsigned int capture_columns;
 
         // Grab the capture from the sequence
-        ReturnCode ret_error = capture_sequence->Get(iCapture, &capture);
-
-        // Check that capture was grabbed
-        if(ret_error.hasErrors())
-            return ret_error;
-
-        // The first three captures are the sinusoidal patterns
-        if(iCapture < (3*this->repeat_phases_.Get())){
-
-            // Check the capture type
-            switch(capture.data_type){
-            case dlp::Capture::DataType::IMAGE_FILE:
-            {
-                // Check that the file exists
-                if(!dlp::File::Exists(capture.image_file))
-                    return ret.AddError(FILE_DOES_NOT_EXIST);
-
-                // Load the file and check the resolution
-                ret_error = image.Load(capture.image_file);
-                if(ret_error.hasErrors())
-                    return ret_error;
-
-                break;
-            }
-            case dlp::Capture::DataType::IMAGE_DATA:
-            {
-                // Check that the image data is not empty
-                if(capture.image_data.isEmpty())
-                    return ret.AddError(IMAGE_EMPTY);
-
-                // Load the file and check the resolution
-                cv::Mat temp_image_data;
-                capture.image_data.Unsafe_GetOpenCVData(&temp_image_data);
-                ret_error = image.Create(temp_image_data);
-                if(ret_error.hasErrors())
-                    return ret_error;
-                temp_image_data.release();
-                break;
-            }
-            case dlp::Capture::DataType::INVALID:
-            default:
-                return ret.AddError(STRUCTURED_LIGHT_DATA_TYPE_INVALID);
-            }
-
-            // Get the image resolution
-            image.GetColumns(&capture_columns);
-            image.GetRows(&capture_rows);
-
-            // If on the first capture store the resolution
-            if(iCapture == 0){
-                image_columns = capture_columns;
-                image_rows    = capture_rows;
-            }
-
-            // Check that each image has the same resolution
-            if( (capture_rows    != image_rows) ||
-                (capture_columns != image_columns))
-                return ret.AddError(STRUCTURED_LIGHT_PATTERN_SIZE_INVALID);
-
-            // Convert the image to monochrome
-            image.ConvertToMonochrome();
-
-            // Add the image to the list
-            images_coded.push_back(image);
+        ret = capture_sequence->Get(iCapture, &capture);
+        if(ret.hasErrors())
+            return ret;
 
-            // Clear the image
-            image.Clear();
-        }
-        else{
-            // Add all GrayCode captures to sequence for seperate decoding
-            gray_code_sequence.Add(capture);
-        }
+        // Add all GrayCode captures to sequence for seperate decoding
+        gray_code_sequence.Add(capture);
     }
 
-    // Decode the GrayCode sequence
-    dlp::DisparityMap gray_code_disparity;
-    ret = this->hybrid_unwrap_module_.DecodeCaptureSequence(&gray_code_sequence,&gray_code_disparity);
-
+    // Load the GrayCode captures over the same region
+    unsigned int gray_code_columns;
+    unsigned int gray_code_rows;
+    cv::Rect     gray_code_region;
+    cv::Mat      gray_code_mask;
+
+    this->hybrid_unwrap_module_.SetRegionOfInterest(this->region_of_interest_);
+    ret = this->hybrid_unwrap_module_.LoadCaptures(&gray_code_sequence,
+                                                   &data->gray_code_images, &data->gray_code,
+                                                   &gray_code_columns, &gray_code_rows,
+                                                   &data->gray_code_sixteen_bit,
+                                                   &gray_code_region, &gray_code_mask);
     if(ret.hasErrors())
         return ret;
 
-    // Check the resolution of the GrayCode disparity map
-    unsigned int gray_code_disparity_rows;
-    unsigned int gray_code_disparity_columns;
-    gray_code_disparity.GetColumns(&gray_code_disparity_columns);
-    gray_code_disparity.GetRows(&gray_code_disparity_rows);
-
-    if((gray_code_disparity_columns != image_columns) ||
-       (gray_code_disparity_rows    != image_rows))
+    // Check the resolution of the GrayCode captures
+    if((gray_code_columns != data->image_columns) ||
+       (gray_code_rows    != data->image_rows))
         return ret.AddError(STRUCTURED_LIGHT_PATTERN_SIZE_INVALID);
 
-    // Allocate memory for the disparity map
-    ret = this->disparity_map_.Create( image_columns, image_rows, this->pattern_orientation_.Get(),this->over_sample_.Get());
+    return ret;
+}
 
-    if(ret.hasErrors())
-        return ret;
+/** @brief Returns a monochrome capture pixel at its native depth */
+static inline float GetIntensity(const cv::Mat &image, const bool &sixteen_bit, const unsigned int &x_col, const unsigned int &y_row){
+    if(sixteen_bit) return image.at<unsigned short>(y_row, x_col);
+    return image.at<unsigned char>(y_row, x_col);
+}
+
+/** @brief Decodes one tile of the region of interest
+ *  @param[in]  data        Region of interest of the loaded captures
+ *  @param[in]  tile        Tile to decode relative to the region of interest
+ *  @param[out] disparity   Return pointer for the CV_32SC1 disparity of the tile
+ *  @param[out] confidence  Return pointer for the measurements of the tile, may be NULL
+ *
+ *  The hybrid unwrapping Gray code of the same tile is decoded first.
+ *
+ *  The sinusoid of a pixel has the offset A and amplitude B. It is lit by
+ *  A + B at its peak and A - B at its trough, so the modulation is 2B and
+ *  the global light is 2(A - B). The decision margin is the margin of the
+ *  hybrid Gray code. The contrast is only measured if it is returned or a
+ *  rejection limit is set.
+ */
+void ThreePhase::DecodeTile(const CaptureData &data, const cv::Rect &tile,
+                            cv::Mat *disparity, TileConfidence *confidence) const{
+
+    // Measure the contrast if it is needed
+    TileConfidence  tile_confidence;
+    TileConfidence *measure = nullptr;
+    if(confidence || this->isRejectionEnabled())
+        measure = confidence ? confidence : &tile_confidence;
+
+    // Decode the GrayCode of the tile, its decision margins are kept
+    cv::Mat gray_code_disparity;
+    this->hybrid_unwrap_module_.DecodeTile(data.gray_code, data.gray_code_sixteen_bit,
+                                           data.region_mask, tile, &gray_code_disparity, measure);
 
+    // Reference the sinusoidal captures of the tile
+    std::vector<cv::Mat> phase_data(data.phase.size());
+    for(unsigned int iImage = 0; iImage < data.phase.size(); iImage++)
+        phase_data.at(iImage) = data.phase.at(iImage)(tile);
+
+    disparity->create(tile.height, tile.width, CV_32SC1);
 
     // Decode each pixel
     int   disparity_value;
     int   gray_code_disparity_value;
     float phase_value;
-    unsigned char intensity_0;
-    unsigned char intensity_p120;
-    unsigned char intensity_n120;
 
     float over_sample = float(this->over_sample_.Get());
 
-    for(     unsigned int yRow = 0; yRow < image_rows;    yRow++){
-        for( unsigned int xCol = 0; xCol < image_columns; xCol++){
+    for(     unsigned int yRow = 0; yRow < (unsigned int) tile.height; yRow++){
+        for( unsigned int xCol = 0; xCol < (unsigned int) tile.width;  xCol++){
+
+            // Skip pixels outside of the mask
+            if(!data.region_mask.empty() &&
+               (data.region_mask.at<unsigned char>(yRow + tile.y, xCol + tile.x) == 0)){
+                disparity->at<int>(yRow, xCol) = dlp::DisparityMap::INVALID_PIXEL;
+                continue;
+            }
 
             // Get the sinusoidal intensity values
             float intensity_phase_0    = 0;
@@ -499,21 +470,13 @@ ReturnCode ThreePhase::DecodeCaptureSequence(Capture::Sequence *capture_sequence
             float intensity_phase_n120 = 0;
 
             for(unsigned int iCount = 0; iCount < this->repeat_phases_.Get();iCount++){
-                unsigned char temp_0    = 0;
-                unsigned char temp_p120 = 0;
-                unsigned char temp_n120 = 0;
-
                 unsigned char image_0    = (this->repeat_phases_.Get()*0) + iCount;
                 unsigned char image_p120 = (this->repeat_phases_.Get()*1) + iCount;
                 unsigned char image_n120 = (this->repeat_phases_.Get()*2) + iCount;
 
-                images_coded.at(image_0   ).Unsafe_GetPixel(xCol,yRow,&temp_0);
-                images_coded.at(image_p120).Unsafe_GetPixel(xCol,yRow,&temp_p120);
-                images_coded.at(image_n120).Unsafe_GetPixel(xCol,yRow,&temp_n120);
-
-                intensity_phase_0 += temp_0;
-                intensity_phase_p120 += temp_p120;
-                intensity_phase_n120 += temp_n120;
+                intensity_phase_0    += GetIntensity(phase_data.at(image_0   ), data.phase_sixteen_bit, xCol, yRow);
+                intensity_phase_p120 += GetIntensity(phase_data.at(image_p120), data.phase_sixteen_bit, xCol, yRow);
+                intensity_phase_n120 += GetIntensity(phase_data.at(image_n120), data.phase_sixteen_bit, xCol, yRow);
 
             }
 
@@ -521,10 +484,16 @@ ReturnCode ThreePhase::DecodeCaptureSequence(Capture::Sequence *capture_sequence
             intensity_phase_p120 = intensity_phase_p120 / this->repeat_phases_.Get();
             intensity_phase_n120 = intensity_phase_n120 / this->repeat_phases_.Get();
 
+            // Split the direct and global light
+            if(measure){
+                float offset    = (intensity_phase_0 + intensity_phase_p120 + intensity_phase_n120) / 3.0;
+                float amplitude = sqrt( 3.0 * (intensity_phase_n120 - intensity_phase_p120) * (intensity_phase_n120 - intensity_phase_p120) +
+                                       (2.0*intensity_phase_0 - intensity_phase_n120 - intensity_phase_p120) *
+                                       (2.0*intensity_phase_0 - intensity_phase_n120 - intensity_phase_p120) ) / 3.0;
 
-//            images_coded.at(0).Unsafe_GetPixel(xCol,yRow,&intensity_0);
-//            images_coded.at(1).Unsafe_GetPixel(xCol,yRow,&intensity_p120);
-//            images_coded.at(2).Unsafe_GetPixel(xCol,yRow,&intensity_n120);
+                measure->modulation.at<float>(yRow, xCol) = 2.0 * amplitude;
+                measure->global.at<float>(yRow, xCol)     = std::max(2.0f * (offset - amplitude), 0.0f);
+            }
 
             // Calculate the wrapped phase
             phase_value = atan( sqrt(3.0) * (intensity_phase_n120 - intensity_phase_p120) /
@@ -541,9 +510,7 @@ ReturnCode ThreePhase::DecodeCaptureSequence(Capture::Sequence *capture_sequence
 
                 if(this->use_hybrid_.Get()){
                     // Get the gray code disparity pixel value
-                    gray_code_disparity.Unsafe_GetPixel(xCol,yRow,&gray_code_disparity_value);
-
-                    //disparity_vals[(unsigned int)gray_code_disparity_value]++;
+                    gray_code_disparity_value = gray_code_disparity.at<int>(yRow, xCol);
 
                     if((gray_code_disparity_value != dlp::DisparityMap::INVALID_PIXEL) &&
                        (gray_code_disparity_value != dlp::DisparityMap::EMPTY_PIXEL)){
@@ -580,16 +547,74 @@ ReturnCode ThreePhase::DecodeCaptureSequence(Capture::Sequence *capture_sequence
             }
 
             // Save the calculated pixel value
-            this->disparity_map_.Unsafe_SetPixel(xCol,yRow,disparity_value);
+            disparity->at<int>(yRow, xCol) = disparity_value;
         }
     }
 
-//    std::ofstream myfile;
-//      myfile.open ("disparity.txt");
-//      for(unsigned int i=0;i<10000;i++){
-//          myfile << i << ", " <<  disparity_vals[i];
-//      }
-//      myfile.close();
+    // Reject the pixels which do not meet the limits
+    if(measure){
+        dlp::ConfidenceMap::Rejection rejection;
+        this->GetRejection(&rejection);
+        dlp::ConfidenceMap::Unsafe_Reject(rejection, measure->modulation, measure->global,
+                                          measure->margin, disparity);
+    }
+}
+
+/** @brief Decodes the \ref dlp::Capture::Sequence and returns the \ref dlp::DisparityMap
+ *  @param[in] capture_sequence \ref dlp::Capture::Sequence to be decoded
+ *  @param[in] disparity_map Return pointer for generated \ref dlp::DisparityMap
+ *  @retval STRUCTURED_LIGHT_NULL_POINTER_ARGUMENT      Input arguments NULL
+ *  @retval STRUCTURED_LIGHT_NOT_SETUP                  Module has NOT been setup
+ *  @retval STRUCTURED_LIGHT_CAPTURE_SEQUENCE_EMPTY     Supplied sequence is empty
+ *  @retval STRUCTURED_LIGHT_CAPTURE_SEQUENCE_SIZE_INVALID  Supplied sequence has a difference count than what was generated
+ *  @retval STRUCTURED_LIGHT_DATA_TYPE_INVALID          Supplied sequence does NOT contain valid image data or a image file name
+ *  @retval STRUCTURED_LIGHT_CAPTURE_FORMAT_INVALID     Supplied sequence mixes 8-bit and 16-bit captures
+ *
+ *  Only the pixels selected with \ref SetRegionOfInterest() are decoded,
+ *  including by the hybrid unwrapping \ref dlp::GrayCode module.
+ *
+ *  The contrast of every decoded pixel is returned by \ref GetConfidenceMap().
+ *  Pixels which fail the limits of \ref GetRejection() are invalid.
+*/
+ReturnCode ThreePhase::DecodeCaptureSequence(Capture::Sequence *capture_sequence, dlp::DisparityMap *disparity_map){
+    ReturnCode ret;
+
+    // Check the pointers
+    if(!capture_sequence || !disparity_map)
+        return ret.AddError(STRUCTURED_LIGHT_NULL_POINTER_ARGUMENT);
+
+    // Load the captures
+    CaptureData data;
+    ret = this->LoadCaptures(capture_sequence, &data);
+    if(ret.hasErrors())
+        return ret;
+
+    // Allocate memory for the disparity map of the region
+    ret = this->disparity_map_.Create( data.region.width, data.region.height, this->pattern_orientation_.Get(),this->over_sample_.Get());
+
+    if(ret.hasErrors())
+        return ret;
+
+    // Decode the bounding box of the region of interest as a single tile
+    cv::Mat        region_disparity;
+    cv::Mat        disparity_data;
+    TileConfidence region_confidence;
+    this->DecodeTile(data, cv::Rect(0, 0, data.region.width, data.region.height),
+                     &region_disparity, &region_confidence);
+
+    this->disparity_map_.Unsafe_GetOpenCVData(&disparity_data);
+    region_disparity.copyTo(disparity_data);
+    disparity_data.release();
+
+    // Return the region of interest in full frame coordinates
+    ret = ExpandRegion(data.region, data.image_columns, data.image_rows, &this->disparity_map_);
+    if(ret.hasErrors())
+        return ret;
+
+    // Keep the measurements for GetConfidenceMap()
+    ret = this->StoreConfidence(data.region, data.image_columns, data.image_rows, region_confidence);
+    if(ret.hasErrors())
+        return ret;
 
     // Copy the disparity map to the pointer
     ret = disparity_map->Create(this->disparity_map_);
@@ -597,6 +622,75 @@ ReturnCode ThreePhase::DecodeCaptureSequence(Capture::Sequence *capture_sequence
     return ret;
 }
 
+/** @brief Decodes the \ref dlp::Capture::Sequence in tiles straight into a \ref dlp::Point::Cloud
+ *  @param[in]  capture_sequence    \ref dlp::Capture::Sequence to be decoded
+ *  @param[in]  geometry            \ref dlp::Geometry with the origin and view port set
+ *  @param[in]  viewport_id         View port of the camera which captured the sequence
+ *  @param[out] ret_cloud           Pointer to return \ref dlp::Point::Cloud
+ *  @param[out] ret_distancemap     Pointer to return \ref dlp::Image depth map
+ *
+ *  The phase and hybrid Gray code of each tile are decoded and triangulated
+ *  together. The result matches \ref DecodeCaptureSequence() followed by
+ *  \ref dlp::Geometry::GeneratePointCloud() with disparity smoothing disabled.
+ *
+ *  If \ref dlp::StructuredLight::Parameters::BandRows is set the captures
+ *  are streamed in horizontal bands with \ref DecodeBandsToPointCloud()
+ *  and the disparity is smoothed like the staged steps.
+ */
+ReturnCode ThreePhase::DecodeToPointCloud(Capture::Sequence  *capture_sequence,
+                                          dlp::Geometry      *geometry,
+                                          const unsigned int &viewport_id,
+                                          dlp::Point::Cloud  *ret_cloud,
+                                          dlp::Image         *ret_distancemap){
+    ReturnCode ret;
+
+    if(this->isBanded()){
+        // Check the sequence before reading it
+        if(!capture_sequence)
+            return ret.AddError(STRUCTURED_LIGHT_NULL_POINTER_ARGUMENT);
+
+        if(!this->isSetup() || !this->hybrid_unwrap_module_.isSetup())
+            return ret.AddError(STRUCTURED_LIGHT_NOT_SETUP);
+
+        if(capture_sequence->GetCount() != this->sequence_count_total_)
+            return ret.AddError(STRUCTURED_LIGHT_CAPTURE_SEQUENCE_SIZE_INVALID);
+
+        const unsigned int phase_count = 3 * this->repeat_phases_.Get();
+
+        return this->DecodeBandsToPointCloud(capture_sequence,
+                                             [&](const std::vector<cv::Mat> &captures, const bool &sixteen_bit,
+                                                 const cv::Mat &band_mask, cv::Mat *disparity){
+                                                 // The sinusoidal captures come before the hybrid Gray code
+                                                 CaptureData data;
+                                                 data.phase.assign(captures.begin(), captures.begin() + phase_count);
+                                                 data.gray_code.assign(captures.begin() + phase_count, captures.end());
+                                                 data.phase_sixteen_bit     = sixteen_bit;
+                                                 data.gray_code_sixteen_bit = sixteen_bit;
+                                                 data.image_columns = captures.front().cols;
+                                                 data.image_rows    = captures.front().rows;
+                                                 data.region        = cv::Rect(0, 0, data.image_columns, data.image_rows);
+                                                 data.region_mask   = band_mask;
+
+                                                 this->DecodeTile(data, data.region, disparity, nullptr);
+                                             },
+                                             this->over_sample_.Get(), 0,
+                                             geometry, viewport_id, ret_cloud, ret_distancemap);
+    }
+
+    // Load the captures
+    CaptureData data;
+    ret = this->LoadCaptures(capture_sequence, &data);
+    if(ret.hasErrors())
+        return ret;
+
+    return this->DecodeTilesToPointCloud([&](const cv::Rect &tile, cv::Mat *disparity){
+                                             this->DecodeTile(data, tile, disparity, nullptr);
+                                         },
+                                         data.region, data.image_columns, data.image_rows,
+                                         this->over_sample_.Get(),
+                                         geometry, viewport_id, ret_cloud, ret_distancemap);
+}
+
 /** @brief      Retrieves module settings
  *  @param[in]  settings Pointer to return settings
  *  @retval     STRUCTURED_LIGHT_NULL_POINTER_ARGUMENT  Input argument is NULL
@@ -619,8 +713,12 @@ ReturnCode ThreePhase::GetSetup( dlp::Parameters *settings)const{
         settings->Set(this->hybrid_region_count_);
         settings->Set(this->hybrid_include_inverted_);
         settings->Set(this->hybrid_pixel_threshold_);
+        settings->Set(this->hybrid_capture_bit_depth_);
     }
 
+    this->GetRejectionSetup(settings);
+    this->GetBandSetup(settings);
+
     return ret;
 }
 